@@ -49,6 +49,12 @@ android {
         compose = true
         buildConfig = true
     }
+
+    // Stored uncompressed so the native code maps the key blob in place
+    // from the APK (core/security NativeKeyProvider)
+    androidResources {
+        noCompress += "blob"
+    }
 }
 
 dependencies {
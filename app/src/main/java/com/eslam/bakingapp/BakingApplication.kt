@@ -3,23 +3,51 @@ package com.eslam.bakingapp
 import android.app.Application
 import androidx.hilt.work.HiltWorkerFactory
 import androidx.work.Configuration
+import coil.ImageLoader
+import coil.ImageLoaderFactory
+import com.eslam.bakingapp.core.security.image.NativeThumbnailPipeline
+import com.eslam.bakingapp.core.security.memory.MemoryAccounting
+import com.eslam.bakingapp.image.ThumbnailFetcher
 import dagger.hilt.android.HiltAndroidApp
+import okhttp3.OkHttpClient
 import javax.inject.Inject
 
 /**
  * Application class for BakingApp.
- * Initializes Hilt dependency injection.
+ * Initializes Hilt dependency injection, passes memory pressure on to
+ * the native caches and gives Coil the native thumbnail fetcher for list
+ * images.
  */
 @HiltAndroidApp
-class BakingApplication : Application(), Configuration.Provider {
+class BakingApplication : Application(), Configuration.Provider, ImageLoaderFactory {
     
     @Inject
     lateinit var workerFactory: HiltWorkerFactory
+
+    @Inject
+    lateinit var memoryAccounting: MemoryAccounting
+
+    @Inject
+    lateinit var thumbnailPipeline: NativeThumbnailPipeline
     
     override val workManagerConfiguration: Configuration
         get() = Configuration.Builder()
             .setWorkerFactory(workerFactory)
             .build()
+
+    override fun newImageLoader(): ImageLoader {
+        // Image hosts get neither the API client's auth headers nor its signatures
+        val imageClient = OkHttpClient()
+        return ImageLoader.Builder(this)
+            .okHttpClient(imageClient)
+            .components { add(ThumbnailFetcher.Factory(thumbnailPipeline, imageClient)) }
+            .build()
+    }
+
+    override fun onTrimMemory(level: Int) {
+        super.onTrimMemory(level)
+        memoryAccounting.onTrimMemory(level)
+    }
 }
 
 
@@ -0,0 +1,78 @@
+package com.eslam.bakingapp.image
+
+import android.graphics.drawable.BitmapDrawable
+import android.net.Uri
+import coil.ImageLoader
+import coil.decode.DataSource
+import coil.fetch.DrawableResult
+import coil.fetch.FetchResult
+import coil.fetch.Fetcher
+import coil.request.Options
+import coil.size.Scale
+import coil.size.pxOrElse
+import com.eslam.bakingapp.core.security.image.NativeThumbnailPipeline
+import com.eslam.bakingapp.core.ui.image.LIST_THUMBNAIL_PARAMETER
+import okhttp3.Call
+import okhttp3.Request
+
+/**
+ * Coil [Fetcher] serving list cell thumbnails from [NativeThumbnailPipeline].
+ *
+ * A cached thumbnail is copied straight into a cell-sized bitmap; a miss is
+ * downloaded, decoded subsampled and resized natively, so scrolling never
+ * decodes a full-size bitmap. Requests not marked as list thumbnails, ones
+ * without a fixed size, and everything while the pipeline is unavailable
+ * fall through to Coil's own fetchers.
+ */
+class ThumbnailFetcher(
+    private val url: String,
+    private val width: Int,
+    private val height: Int,
+    private val centerCrop: Boolean,
+    private val options: Options,
+    private val pipeline: NativeThumbnailPipeline,
+    private val callFactory: Call.Factory
+) : Fetcher {
+
+    override suspend fun fetch(): FetchResult? {
+        var downloaded = false
+        val bitmap = pipeline.getThumbnail(url, width, height, centerCrop) {
+            downloaded = true
+            download()
+        } ?: return null
+        return DrawableResult(
+            drawable = BitmapDrawable(options.context.resources, bitmap),
+            isSampled = true,
+            dataSource = if (downloaded) DataSource.NETWORK else DataSource.DISK
+        )
+    }
+
+    private fun download(): ByteArray? {
+        val request = Request.Builder().url(url).build()
+        return callFactory.newCall(request).execute().use { response ->
+            if (response.isSuccessful) response.body?.bytes() else null
+        }
+    }
+
+    class Factory(
+        private val pipeline: NativeThumbnailPipeline,
+        private val callFactory: Call.Factory
+    ) : Fetcher.Factory<Uri> {
+
+        override fun create(data: Uri, options: Options, imageLoader: ImageLoader): Fetcher? {
+            if (options.parameters.value<Boolean>(LIST_THUMBNAIL_PARAMETER) != true) return null
+            if (data.scheme != "http" && data.scheme != "https") return null
+            val width = options.size.width.pxOrElse { return null }
+            val height = options.size.height.pxOrElse { return null }
+            return ThumbnailFetcher(
+                url = data.toString(),
+                width = width,
+                height = height,
+                centerCrop = options.scale == Scale.FILL,
+                options = options,
+                pipeline = pipeline,
+                callFactory = callFactory
+            )
+        }
+    }
+}
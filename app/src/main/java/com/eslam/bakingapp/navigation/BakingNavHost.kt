@@ -120,6 +120,9 @@ fun BakingNavHost(
                     // Launch the cooking timer activity
                     // The timer will be created with the recipe name and cooking time
                     launchCookingTimer(context)
+                },
+                onRecipeClick = { recipeId ->
+                    navController.navigate(Routes.recipeDetail(recipeId))
                 }
             )
         }
@@ -0,0 +1,120 @@
+package com.eslam.bakingapp.core.database.bulk
+
+/**
+ * Column-major rows for [RecipeBulkLoader].
+ *
+ * Rows are appended field by field into flat arrays, one set per table,
+ * instead of as one entity object per row. Values are kept in the order
+ * the loader binds them, so writing a row into a statement is a straight
+ * walk over the arrays.
+ */
+class RecipeBatch(expectedRecipes: Int = 16) {
+
+    /**
+     * One table's rows: its text columns in [strings], its integer and
+     * boolean columns in [longs], its real columns in [doubles]
+     */
+    internal class Columns(
+        val stringsPerRow: Int,
+        val longsPerRow: Int,
+        val doublesPerRow: Int,
+        expectedRows: Int
+    ) {
+        var rows = 0
+            private set
+        var strings = arrayOfNulls<String>(stringsPerRow * expectedRows)
+            private set
+        var longs = LongArray(longsPerRow * expectedRows)
+            private set
+        var doubles = DoubleArray(doublesPerRow * expectedRows)
+            private set
+
+        /**
+         * Reserves one more row and returns its index
+         */
+        fun addRow(): Int {
+            val capacity = if (stringsPerRow > 0) strings.size / stringsPerRow else longs.size / longsPerRow
+            if (rows == capacity) {
+                val grown = maxOf(16, capacity * 2)
+                strings = strings.copyOf(stringsPerRow * grown)
+                longs = longs.copyOf(longsPerRow * grown)
+                doubles = doubles.copyOf(doublesPerRow * grown)
+            }
+            return rows++
+        }
+    }
+
+    internal val recipes = Columns(6, 6, 0, expectedRecipes)
+    internal val ingredients = Columns(4, 0, 1, expectedRecipes * 8)
+    internal val steps = Columns(5, 1, 0, expectedRecipes * 8)
+
+    val recipeCount: Int get() = recipes.rows
+    val rowCount: Int get() = recipes.rows + ingredients.rows + steps.rows
+
+    fun addRecipe(
+        id: String,
+        name: String,
+        description: String,
+        imageUrl: String?,
+        servings: Int,
+        prepTimeMinutes: Int,
+        cookTimeMinutes: Int,
+        difficulty: String,
+        category: String,
+        isFavorite: Boolean = false,
+        createdAt: Long = System.currentTimeMillis(),
+        updatedAt: Long = createdAt
+    ) {
+        val row = recipes.addRow()
+        recipes.strings.let { s ->
+            val base = row * 6
+            s[base] = id
+            s[base + 1] = name
+            s[base + 2] = description
+            s[base + 3] = imageUrl
+            s[base + 4] = difficulty
+            s[base + 5] = category
+        }
+        recipes.longs.let { l ->
+            val base = row * 6
+            l[base] = servings.toLong()
+            l[base + 1] = prepTimeMinutes.toLong()
+            l[base + 2] = cookTimeMinutes.toLong()
+            l[base + 3] = if (isFavorite) 1L else 0L
+            l[base + 4] = createdAt
+            l[base + 5] = updatedAt
+        }
+    }
+
+    fun addIngredient(recipeId: String, id: String, name: String, quantity: Double, unit: String) {
+        val row = ingredients.addRow()
+        ingredients.strings.let { s ->
+            val base = row * 4
+            s[base] = id
+            s[base + 1] = recipeId
+            s[base + 2] = name
+            s[base + 3] = unit
+        }
+        ingredients.doubles[row] = quantity
+    }
+
+    fun addStep(
+        recipeId: String,
+        id: String,
+        order: Int,
+        description: String,
+        videoUrl: String?,
+        thumbnailUrl: String?
+    ) {
+        val row = steps.addRow()
+        steps.strings.let { s ->
+            val base = row * 5
+            s[base] = id
+            s[base + 1] = recipeId
+            s[base + 2] = description
+            s[base + 3] = videoUrl
+            s[base + 4] = thumbnailUrl
+        }
+        steps.longs[row] = order.toLong()
+    }
+}
@@ -0,0 +1,172 @@
+package com.eslam.bakingapp.core.database.bulk
+
+import androidx.room.withTransaction
+import androidx.sqlite.db.SupportSQLiteDatabase
+import androidx.sqlite.db.SupportSQLiteStatement
+import com.eslam.bakingapp.core.database.BakingDatabase
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Bulk ingest path for large recipe syncs.
+ *
+ * Same result as [com.eslam.bakingapp.core.database.dao.RecipeDao.insertRecipeWithDetails]
+ * per recipe (INSERT OR REPLACE into recipes, ingredients and steps), but
+ * for a whole [RecipeBatch] in one transaction: columns are bound straight
+ * from the batch's arrays into multi-row INSERTs of up to 999 variables,
+ * and the full-size statement of each table is compiled once and reused
+ * across chunks and calls. Room's observers are notified as usual when the
+ * transaction ends.
+ *
+ * For delta syncs, recipes that were removed or changed upstream can be
+ * deleted with their ingredients and steps in the same transaction, so a
+ * changed recipe does not keep rows its new version dropped.
+ */
+@Singleton
+class RecipeBulkLoader @Inject constructor(
+    private val database: BakingDatabase
+) {
+
+    companion object {
+        // SQLITE_MAX_VARIABLE_NUMBER of the framework SQLite on every supported API level
+        private const val MAX_BIND_VARIABLES = 999
+
+        private const val STRING = 0
+        private const val LONG = 1
+        private const val DOUBLE = 2
+
+        private fun column(kind: Int, index: Int) = (kind shl 8) or index
+
+        // Children first, as RecipeDao.deleteRecipeWithDetails does
+        private val DELETE_KEYS = listOf(
+            "ingredients" to "recipe_id",
+            "steps" to "recipe_id",
+            "recipes" to "id"
+        )
+
+        private val RECIPES = Table(
+            "recipes",
+            listOf(
+                "id", "name", "description", "image_url", "servings", "prep_time_minutes",
+                "cook_time_minutes", "difficulty", "category", "is_favorite", "created_at", "updated_at"
+            ),
+            intArrayOf(
+                column(STRING, 0), column(STRING, 1), column(STRING, 2), column(STRING, 3),
+                column(LONG, 0), column(LONG, 1), column(LONG, 2), column(STRING, 4),
+                column(STRING, 5), column(LONG, 3), column(LONG, 4), column(LONG, 5)
+            )
+        )
+
+        private val INGREDIENTS = Table(
+            "ingredients",
+            listOf("id", "recipe_id", "name", "quantity", "unit"),
+            intArrayOf(
+                column(STRING, 0), column(STRING, 1), column(STRING, 2), column(DOUBLE, 0),
+                column(STRING, 3)
+            )
+        )
+
+        private val STEPS = Table(
+            "steps",
+            listOf("id", "recipe_id", "order", "description", "video_url", "thumbnail_url"),
+            intArrayOf(
+                column(STRING, 0), column(STRING, 1), column(LONG, 0), column(STRING, 2),
+                column(STRING, 3), column(STRING, 4)
+            )
+        )
+    }
+
+    /**
+     * A table's insert, with where each SQL column comes from in a
+     * [RecipeBatch.Columns] row
+     */
+    private class Table(val name: String, val columns: List<String>, val bindings: IntArray) {
+        val rowsPerStatement = MAX_BIND_VARIABLES / bindings.size
+
+        fun sql(rows: Int): String {
+            val row = columns.joinToString(",", "(", ")") { "?" }
+            return buildString(64 + rows * (row.length + 1)) {
+                append("INSERT OR REPLACE INTO `").append(name).append("` (")
+                columns.joinTo(this, ",") { "`$it`" }
+                append(") VALUES ")
+                repeat(rows) { if (it > 0) append(','); append(row) }
+            }
+        }
+    }
+
+    // Full-size statements, compiled on first use; guarded by itself
+    private val statements = HashMap<Table, SupportSQLiteStatement>()
+
+    /**
+     * Deletes the recipes in [removedRecipeIds], with their ingredients and
+     * steps, then inserts every row of [batch], in a single transaction
+     */
+    suspend fun load(batch: RecipeBatch, removedRecipeIds: Collection<String> = emptyList()) {
+        if (batch.rowCount == 0 && removedRecipeIds.isEmpty()) return
+        database.withTransaction {
+            val db = database.openHelper.writableDatabase
+            if (removedRecipeIds.isNotEmpty()) delete(db, removedRecipeIds.toList())
+            synchronized(statements) {
+                insert(db, RECIPES, batch.recipes)
+                insert(db, INGREDIENTS, batch.ingredients)
+                insert(db, STEPS, batch.steps)
+            }
+        }
+    }
+
+    private fun delete(db: SupportSQLiteDatabase, recipeIds: List<String>) {
+        for (chunk in recipeIds.chunked(MAX_BIND_VARIABLES)) {
+            val placeholders = chunk.joinToString(",") { "?" }
+            for ((table, column) in DELETE_KEYS) {
+                db.compileStatement("DELETE FROM `$table` WHERE `$column` IN ($placeholders)").use { statement ->
+                    chunk.forEachIndexed { index, id -> statement.bindString(index + 1, id) }
+                    statement.executeUpdateDelete()
+                }
+            }
+        }
+    }
+
+    private fun insert(db: SupportSQLiteDatabase, table: Table, rows: RecipeBatch.Columns) {
+        var start = 0
+        while (start < rows.rows) {
+            val count = minOf(table.rowsPerStatement, rows.rows - start)
+            val full = count == table.rowsPerStatement
+            val statement = if (full) {
+                statements.getOrPut(table) { db.compileStatement(table.sql(count)) }
+            } else {
+                db.compileStatement(table.sql(count))
+            }
+            try {
+                bind(statement, table, rows, start, count)
+                statement.execute()
+            } finally {
+                if (!full) statement.close()
+            }
+            start += count
+        }
+    }
+
+    private fun bind(
+        statement: SupportSQLiteStatement,
+        table: Table,
+        rows: RecipeBatch.Columns,
+        start: Int,
+        count: Int
+    ) {
+        var index = 1
+        for (row in start until start + count) {
+            for (binding in table.bindings) {
+                val column = binding and 0xFF
+                when (binding shr 8) {
+                    STRING -> {
+                        val value = rows.strings[row * rows.stringsPerRow + column]
+                        if (value == null) statement.bindNull(index) else statement.bindString(index, value)
+                    }
+                    LONG -> statement.bindLong(index, rows.longs[row * rows.longsPerRow + column])
+                    else -> statement.bindDouble(index, rows.doubles[row * rows.doublesPerRow + column])
+                }
+                index++
+            }
+        }
+    }
+}
@@ -74,6 +74,12 @@ interface RecipeDao {
     @Query("SELECT * FROM recipes WHERE name LIKE '%' || :query || '%' OR description LIKE '%' || :query || '%' ORDER BY created_at DESC")
     fun searchRecipes(query: String): Flow<List<RecipeEntity>>
     
+    /**
+     * Rows for ranked search hits; the caller restores the ranking order
+     */
+    @Query("SELECT * FROM recipes WHERE id IN (:recipeIds)")
+    fun getRecipesByIds(recipeIds: List<String>): Flow<List<RecipeEntity>>
+    
     @Query("SELECT COUNT(*) FROM recipes")
     suspend fun getRecipeCount(): Int
     
@@ -2,8 +2,13 @@ package com.eslam.bakingapp.core.network.di
 
 import com.eslam.bakingapp.core.network.BuildConfig
 import com.eslam.bakingapp.core.network.adapter.NetworkResponseAdapterFactory
+import com.eslam.bakingapp.core.network.emulation.EmulatedCallFactory
+import com.eslam.bakingapp.core.network.emulation.LinkEmulator
 import com.eslam.bakingapp.core.network.interceptor.AuthInterceptor
-import com.eslam.bakingapp.core.network.interceptor.NetworkDelayInterceptor
+import com.eslam.bakingapp.core.network.interceptor.OfflineCacheInterceptor
+import com.eslam.bakingapp.core.network.interceptor.RequestSigningInterceptor
+import com.eslam.bakingapp.core.network.interning.InternedStringAdapter
+import com.eslam.bakingapp.core.network.interning.StringInterner
 import com.squareup.moshi.Moshi
 import com.squareup.moshi.kotlin.reflect.KotlinJsonAdapterFactory
 import dagger.Module
@@ -26,8 +31,10 @@ object NetworkModule {
     
     @Provides
     @Singleton
-    fun provideMoshi(): Moshi {
+    fun provideMoshi(stringInterner: StringInterner): Moshi {
         return Moshi.Builder()
+            // One shared instance per distinct value of @Interned fields
+            .add(InternedStringAdapter(stringInterner))
             .add(KotlinJsonAdapterFactory())
             .build()
     }
@@ -49,14 +56,18 @@ object NetworkModule {
     fun provideOkHttpClient(
         loggingInterceptor: HttpLoggingInterceptor,
         authInterceptor: AuthInterceptor,
-        networkDelayInterceptor: NetworkDelayInterceptor
+        requestSigningInterceptor: RequestSigningInterceptor,
+        offlineCacheInterceptor: OfflineCacheInterceptor
     ): OkHttpClient {
         return OkHttpClient.Builder()
             .connectTimeout(BuildConfig.CONNECT_TIMEOUT, TimeUnit.SECONDS)
             .readTimeout(BuildConfig.READ_TIMEOUT, TimeUnit.SECONDS)
             .writeTimeout(BuildConfig.WRITE_TIMEOUT, TimeUnit.SECONDS)
+            // Outermost, so it sees failures from every interceptor below
+            .addInterceptor(offlineCacheInterceptor)
+            // Before auth, which strips the No-Auth marker it checks
+            .addInterceptor(requestSigningInterceptor)
             .addInterceptor(authInterceptor)
-            .addInterceptor(networkDelayInterceptor)
             .addInterceptor(loggingInterceptor)
             // Certificate pinning can be added here for production
             // .certificatePinner(certificatePinner)
@@ -68,11 +79,18 @@ object NetworkModule {
     @Singleton
     fun provideRetrofit(
         okHttpClient: OkHttpClient,
+        linkEmulator: LinkEmulator,
         moshi: Moshi
     ): Retrofit {
+        // Debug builds can slow calls down without holding dispatcher threads
+        val callFactory = if (BuildConfig.DEBUG) {
+            EmulatedCallFactory(okHttpClient, linkEmulator)
+        } else {
+            okHttpClient
+        }
         return Retrofit.Builder()
             .baseUrl(BuildConfig.BASE_URL)
-            .client(okHttpClient)
+            .callFactory(callFactory)
             .addConverterFactory(MoshiConverterFactory.create(moshi))
             .addCallAdapterFactory(NetworkResponseAdapterFactory())
             .build()
@@ -0,0 +1,164 @@
+package com.eslam.bakingapp.core.network.emulation
+
+import okhttp3.Call
+import okhttp3.Callback
+import okhttp3.OkHttpClient
+import okhttp3.Request
+import okhttp3.Response
+import okhttp3.ResponseBody.Companion.toResponseBody
+import okio.Timeout
+import java.io.IOException
+import java.io.InterruptedIOException
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicBoolean
+
+/**
+ * [Call.Factory] that sends every call across a [LinkEmulator]: the request
+ * crosses the link upstream before it reaches [client], the response
+ * downstream before the caller sees it.
+ *
+ * Delayed calls wait inside the emulator rather than on a thread, so the
+ * number of calls in flight is not bounded by OkHttp's dispatcher. Only the
+ * real exchange and the callbacks run on dispatcher threads. With the
+ * emulator disabled, calls go straight to [client].
+ *
+ * IMPORTANT: Only install in debug builds!
+ */
+class EmulatedCallFactory(
+    private val client: OkHttpClient,
+    private val emulator: LinkEmulator
+) : Call.Factory {
+
+    override fun newCall(request: Request): Call {
+        return if (emulator.isEnabled) EmulatedCall(client, emulator, request) else client.newCall(request)
+    }
+}
+
+private class EmulatedCall(
+    private val client: OkHttpClient,
+    private val emulator: LinkEmulator,
+    private val request: Request
+) : Call {
+
+    private val executed = AtomicBoolean()
+
+    @Volatile
+    private var canceled = false
+
+    @Volatile
+    private var ticket = 0L
+
+    @Volatile
+    private var exchange: Call? = null
+
+    @Volatile
+    private var callback: Callback? = null
+
+    override fun request(): Request = request
+
+    override fun isExecuted(): Boolean = executed.get()
+
+    override fun isCanceled(): Boolean = canceled
+
+    override fun timeout(): Timeout =
+        Timeout().timeout(client.callTimeoutMillis.toLong(), TimeUnit.MILLISECONDS)
+
+    override fun clone(): Call = EmulatedCall(client, emulator, request)
+
+    override fun cancel() {
+        canceled = true
+        exchange?.cancel()
+        // A transfer dropped before its release would never call back
+        if (emulator.cancel(ticket)) callback?.let { fail(it, IOException("Canceled")) }
+    }
+
+    override fun enqueue(responseCallback: Callback) {
+        check(executed.compareAndSet(false, true)) { "Already Executed" }
+        callback = responseCallback
+        ticket = emulator.transfer(upstream = true, bytes = requestBytes()) { delivered ->
+            when {
+                canceled -> fail(responseCallback, IOException("Canceled"))
+                !delivered -> fail(responseCallback, IOException("Request lost on the emulated link"))
+                else -> proceed(responseCallback)
+            }
+        }
+    }
+
+    override fun execute(): Response {
+        val done = CountDownLatch(1)
+        var result: Response? = null
+        var error: IOException? = null
+        enqueue(object : Callback {
+            override fun onResponse(call: Call, response: Response) {
+                result = response
+                done.countDown()
+            }
+
+            override fun onFailure(call: Call, e: IOException) {
+                error = e
+                done.countDown()
+            }
+        })
+        try {
+            done.await()
+        } catch (e: InterruptedException) {
+            cancel()
+            throw InterruptedIOException("Interrupted while on the emulated link")
+        }
+        error?.let { throw it }
+        return result!!
+    }
+
+    /**
+     * Runs the real exchange, then sends the buffered response downstream
+     */
+    private fun proceed(responseCallback: Callback) {
+        val real = client.newCall(request)
+        exchange = real
+        if (canceled) real.cancel()
+        real.enqueue(object : Callback {
+            override fun onFailure(call: Call, e: IOException) {
+                responseCallback.onFailure(this@EmulatedCall, e)
+            }
+
+            override fun onResponse(call: Call, response: Response) {
+                // Read on this dispatcher thread: the size decides the
+                // transfer time, and the timer thread must never do I/O
+                val buffered = try {
+                    response.body?.let { body -> body.bytes().toResponseBody(body.contentType()) }
+                } catch (e: IOException) {
+                    response.close()
+                    responseCallback.onFailure(this@EmulatedCall, e)
+                    return
+                }
+                val copy = response.newBuilder().body(buffered).build()
+                val bytes = response.headers.byteCount() + (buffered?.contentLength() ?: 0L)
+                ticket = emulator.transfer(upstream = false, bytes = bytes) { delivered ->
+                    when {
+                        canceled -> fail(responseCallback, IOException("Canceled"))
+                        !delivered -> fail(responseCallback, IOException("Response lost on the emulated link"))
+                        else -> dispatch { responseCallback.onResponse(this@EmulatedCall, copy) }
+                    }
+                }
+            }
+        })
+    }
+
+    private fun fail(responseCallback: Callback, e: IOException) {
+        dispatch { responseCallback.onFailure(this, e) }
+    }
+
+    /**
+     * Moves a callback off the emulator's timer thread
+     */
+    private fun dispatch(block: () -> Unit) {
+        client.dispatcher.executorService.execute(block)
+    }
+
+    private fun requestBytes(): Long {
+        val requestLine = request.method.length + request.url.toString().length + 11L
+        val body = request.body?.contentLength()?.coerceAtLeast(0L) ?: 0L
+        return requestLine + request.headers.byteCount() + body
+    }
+}
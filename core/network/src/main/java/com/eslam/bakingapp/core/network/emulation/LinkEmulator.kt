@@ -0,0 +1,87 @@
+package com.eslam.bakingapp.core.network.emulation
+
+/**
+ * Emulated network link for debug builds: latency, jitter, bandwidth and
+ * packet loss between the app and a (typically local) server.
+ *
+ * Transfers never block the caller; [transfer] returns at once and the
+ * emulator calls back when the bytes would have arrived. Implementation
+ * should be provided by the security module.
+ */
+interface LinkEmulator {
+
+    /**
+     * Whether [EmulatedCallFactory] routes calls through the link at all
+     */
+    var isEnabled: Boolean
+
+    /**
+     * Link conditions for transfers started from now on
+     */
+    var profile: LinkProfile
+
+    /**
+     * Sends [bytes] over the link and calls [onRelease] once they have
+     * arrived ([delivered] = true) or were given up on after repeated loss.
+     * [onRelease] runs on the emulator's timer thread and must not block.
+     *
+     * @return A ticket for [cancel]
+     */
+    fun transfer(upstream: Boolean, bytes: Long, onRelease: (delivered: Boolean) -> Unit): Long
+
+    /**
+     * Drops a transfer that has not been released yet; its callback then
+     * never runs
+     *
+     * @return false if it was already released
+     */
+    fun cancel(ticket: Long): Boolean
+}
+
+/**
+ * Conditions of an emulated link
+ *
+ * @param latencyMs One-way delay; a request pays it up and down
+ * @param jitterMs Extra random delay per transfer, up to this much
+ * @param bytesPerSecond Link rate per direction, 0 for unlimited
+ * @param burstBytes Token bucket depth: how much goes out at once after idling
+ * @param lossRate Probability that a packet is lost; each loss costs a
+ *   retransmission timeout, and too many in a row fail the call
+ * @param packetBytes Packet size the loss applies to
+ */
+data class LinkProfile(
+    val latencyMs: Int = 750,
+    val jitterMs: Int = 0,
+    val bytesPerSecond: Long = 0,
+    val burstBytes: Int = 64 * 1024,
+    val lossRate: Double = 0.0,
+    val packetBytes: Int = 1500
+) {
+    companion object {
+        /**
+         * 1.5 s per request, as the old fixed delay
+         */
+        val DEFAULT = LinkProfile()
+
+        /**
+         * A weak mobile connection: slow, jittery and slightly lossy
+         */
+        val SLOW_3G = LinkProfile(
+            latencyMs = 200,
+            jitterMs = 100,
+            bytesPerSecond = 50_000,
+            burstBytes = 16 * 1024,
+            lossRate = 0.01
+        )
+
+        /**
+         * A busy public Wi-Fi: fast but bursty and lossy
+         */
+        val LOSSY_WIFI = LinkProfile(
+            latencyMs = 20,
+            jitterMs = 80,
+            bytesPerSecond = 2_000_000,
+            lossRate = 0.05
+        )
+    }
+}
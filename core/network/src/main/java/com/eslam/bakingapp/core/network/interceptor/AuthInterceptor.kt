@@ -1,5 +1,7 @@
 package com.eslam.bakingapp.core.network.interceptor
 
+import com.eslam.bakingapp.core.network.telemetry.TelemetryEvent
+import com.eslam.bakingapp.core.network.telemetry.TelemetryRecorder
 import okhttp3.Interceptor
 import okhttp3.Response
 import javax.inject.Inject
@@ -8,10 +10,12 @@ import javax.inject.Singleton
 /**
  * OkHttp Interceptor for adding authentication headers to requests.
  * This interceptor retrieves the auth token and adds it to the request header.
+ * Each injection is recorded as a [TelemetryEvent.AUTH_HEADER] event.
  */
 @Singleton
 class AuthInterceptor @Inject constructor(
-    private val tokenProvider: TokenProvider
+    private val tokenProvider: TokenProvider,
+    private val telemetry: TelemetryRecorder
 ) : Interceptor {
     
     companion object {
@@ -31,6 +35,7 @@ class AuthInterceptor @Inject constructor(
         }
         
         val token = tokenProvider.getAccessToken()
+        telemetry.record(TelemetryEvent.AUTH_HEADER, if (token.isNullOrEmpty()) 0 else 1)
         
         return if (token.isNullOrEmpty()) {
             chain.proceed(originalRequest)
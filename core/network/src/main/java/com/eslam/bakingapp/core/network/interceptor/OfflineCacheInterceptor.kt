@@ -0,0 +1,140 @@
+package com.eslam.bakingapp.core.network.interceptor
+
+import okhttp3.Interceptor
+import okhttp3.MediaType
+import okhttp3.MediaType.Companion.toMediaType
+import okhttp3.Protocol
+import okhttp3.Request
+import okhttp3.Response
+import okhttp3.ResponseBody
+import okio.Buffer
+import okio.BufferedSource
+import okio.Source
+import okio.Timeout
+import okio.buffer
+import java.io.IOException
+import java.nio.ByteBuffer
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * OkHttp Interceptor that keeps successful GET responses in an
+ * [OfflineResponseStore] and replays them when the network fails.
+ *
+ * Replayed responses carry an `X-Offline-Cache: hit` header. Requests can
+ * opt out with a `No-Offline-Cache` header, and responses marked
+ * `Cache-Control: no-store` or `private` are never kept. The store holds
+ * the signed-in user's responses, so it is cleared when the session ends.
+ */
+@Singleton
+class OfflineCacheInterceptor @Inject constructor(
+    private val store: OfflineResponseStore
+) : Interceptor {
+
+    companion object {
+        const val CACHE_STATUS_HEADER = "X-Offline-Cache"
+        private const val OPT_OUT_HEADER = "No-Offline-Cache"
+        private const val MAX_CACHEABLE_BYTES = 4L * 1024 * 1024
+        private val JSON = "application/json; charset=utf-8".toMediaType()
+    }
+
+    override fun intercept(chain: Interceptor.Chain): Response {
+        val originalRequest = chain.request()
+
+        if (originalRequest.header(OPT_OUT_HEADER) != null) {
+            val newRequest = originalRequest.newBuilder()
+                .removeHeader(OPT_OUT_HEADER)
+                .build()
+            return chain.proceed(newRequest)
+        }
+        if (originalRequest.method != "GET") {
+            return chain.proceed(originalRequest)
+        }
+
+        val url = originalRequest.url.toString()
+        val response = try {
+            chain.proceed(originalRequest)
+        } catch (e: IOException) {
+            return replay(originalRequest, url) ?: throw e
+        }
+
+        if (response.isSuccessful && isStorable(originalRequest, response)) {
+            // peekBody leaves the original stream untouched for the converter
+            val peeked = response.peekBody(MAX_CACHEABLE_BYTES + 1)
+            if (peeked.contentLength() in 1..MAX_CACHEABLE_BYTES) {
+                store.put(url, peeked.bytes())
+            }
+        }
+        return response
+    }
+
+    private fun isStorable(request: Request, response: Response): Boolean {
+        val cacheControl = response.cacheControl
+        return !request.cacheControl.noStore && !cacheControl.noStore && !cacheControl.isPrivate
+    }
+
+    private fun replay(request: Request, url: String): Response? {
+        val body = store.get(url) ?: return null
+        return Response.Builder()
+            .request(request)
+            .protocol(Protocol.HTTP_1_1)
+            .code(200)
+            .message("OK")
+            .header(CACHE_STATUS_HEADER, "hit")
+            .body(ByteBufferResponseBody(body, JSON))
+            .build()
+    }
+}
+
+/**
+ * Response body backed by a (typically direct) [ByteBuffer], streamed to
+ * the converter segment by segment instead of as one byte array.
+ */
+private class ByteBufferResponseBody(
+    private val buffer: ByteBuffer,
+    private val contentType: MediaType
+) : ResponseBody() {
+
+    private val length = buffer.remaining().toLong()
+
+    override fun contentType(): MediaType = contentType
+
+    override fun contentLength(): Long = length
+
+    override fun source(): BufferedSource = object : Source {
+        override fun read(sink: Buffer, byteCount: Long): Long {
+            if (!buffer.hasRemaining()) return -1L
+            val count = minOf(byteCount, buffer.remaining().toLong()).toInt()
+            val limit = buffer.limit()
+            buffer.limit(buffer.position() + count)
+            sink.write(buffer)
+            buffer.limit(limit)
+            return count.toLong()
+        }
+
+        override fun timeout(): Timeout = Timeout.NONE
+
+        override fun close() = Unit
+    }.buffer()
+}
+
+/**
+ * Interface for storing response bodies for offline use.
+ * Implementation should be provided by the security module.
+ */
+interface OfflineResponseStore {
+    /**
+     * Stores [body] as the latest response for [url]
+     */
+    fun put(url: String, body: ByteArray)
+
+    /**
+     * Returns the stored body for [url], positioned at 0, or null on a miss
+     */
+    fun get(url: String): ByteBuffer?
+
+    /**
+     * Drops every stored body, e.g. when the user signs out
+     */
+    fun clear()
+}
@@ -0,0 +1,91 @@
+package com.eslam.bakingapp.core.network.interceptor
+
+import okhttp3.Interceptor
+import okhttp3.Request
+import okhttp3.Response
+import okio.Buffer
+import okio.ByteString.Companion.toByteString
+import java.security.SecureRandom
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * OkHttp Interceptor that signs every authenticated request with the
+ * current session's request key.
+ *
+ * The signature covers the method, path and query, a timestamp, a random
+ * nonce and the body, so a captured request can be neither altered nor
+ * replayed. Requests marked `No-Auth`, requests made while signed out and
+ * one-shot bodies go out unsigned. Must run before [AuthInterceptor], which
+ * strips the `No-Auth` marker.
+ */
+@Singleton
+class RequestSigningInterceptor @Inject constructor(
+    private val signer: RequestSigner,
+    private val secureRandom: SecureRandom
+) : Interceptor {
+
+    companion object {
+        const val SESSION_HEADER = "X-Session-Id"
+        const val TIMESTAMP_HEADER = "X-Signature-Timestamp"
+        const val NONCE_HEADER = "X-Signature-Nonce"
+        const val SIGNATURE_HEADER = "X-Signature"
+        private const val NO_AUTH_HEADER = "No-Auth"
+        private const val NONCE_BYTES = 16
+    }
+
+    override fun intercept(chain: Interceptor.Chain): Response {
+        val originalRequest = chain.request()
+        if (originalRequest.header(NO_AUTH_HEADER) != null || originalRequest.body?.isOneShot() == true) {
+            return chain.proceed(originalRequest)
+        }
+        val session = signer.sessionId() ?: return chain.proceed(originalRequest)
+
+        val timestamp = System.currentTimeMillis().toString()
+        val nonce = ByteArray(NONCE_BYTES).also { secureRandom.nextBytes(it) }.toByteString().hex()
+        val signature = signer.sign(session, canonicalMessage(originalRequest, timestamp, nonce))
+            ?: return chain.proceed(originalRequest)
+
+        val signedRequest = originalRequest.newBuilder()
+            .header(SESSION_HEADER, session)
+            .header(TIMESTAMP_HEADER, timestamp)
+            .header(NONCE_HEADER, nonce)
+            .header(SIGNATURE_HEADER, signature.toByteString().base64())
+            .build()
+        return chain.proceed(signedRequest)
+    }
+
+    /**
+     * METHOD \n path?query \n timestamp \n nonce \n body
+     */
+    private fun canonicalMessage(request: Request, timestamp: String, nonce: String): ByteArray {
+        val url = request.url
+        val buffer = Buffer()
+            .writeUtf8(request.method).writeByte('\n'.code)
+            .writeUtf8(url.encodedPath)
+        url.encodedQuery?.let { buffer.writeByte('?'.code).writeUtf8(it) }
+        buffer.writeByte('\n'.code)
+            .writeUtf8(timestamp).writeByte('\n'.code)
+            .writeUtf8(nonce).writeByte('\n'.code)
+        request.body?.writeTo(buffer)
+        return buffer.readByteArray()
+    }
+}
+
+/**
+ * Interface for signing requests as the signed-in session.
+ * Implementation should be provided by the security module.
+ */
+interface RequestSigner {
+
+    /**
+     * The current session's ID, or null while signed out
+     */
+    fun sessionId(): String?
+
+    /**
+     * MAC of [message] under [sessionId]'s request key, or null if it
+     * cannot be signed
+     */
+    fun sign(sessionId: String, message: ByteArray): ByteArray?
+}
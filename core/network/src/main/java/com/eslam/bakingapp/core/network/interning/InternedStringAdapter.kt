@@ -0,0 +1,61 @@
+package com.eslam.bakingapp.core.network.interning
+
+import com.squareup.moshi.FromJson
+import com.squareup.moshi.JsonQualifier
+import com.squareup.moshi.JsonReader
+import com.squareup.moshi.ToJson
+import okio.Buffer
+
+/**
+ * Marks a String property whose values repeat across a payload, so it is
+ * decoded through [StringInterner] instead of into a new String each time
+ */
+@Retention(AnnotationRetention.RUNTIME)
+@JsonQualifier
+annotation class Interned
+
+/**
+ * Moshi adapter for [Interned] strings.
+ *
+ * The raw token bytes go to the interner, which decodes them natively and
+ * returns the shared instance. Tokens it cannot take, and every token when
+ * the native library is missing, are decoded by Moshi as usual.
+ */
+class InternedStringAdapter(private val interner: StringInterner) {
+
+    companion object {
+        /** Longest token handed to the interner: 1024 value bytes plus quotes */
+        const val MAX_TOKEN_BYTES = 1026
+
+        private val tokenBuffer = object : ThreadLocal<ByteArray>() {
+            override fun initialValue() = ByteArray(MAX_TOKEN_BYTES)
+        }
+    }
+
+    @FromJson
+    @Interned
+    fun fromJson(reader: JsonReader): String {
+        if (reader.peek() != JsonReader.Token.STRING || !interner.isAvailable()) {
+            return reader.nextString()
+        }
+        val buffer = tokenBuffer.get()!!
+        reader.nextSource().use { source ->
+            var length = 0
+            while (length < buffer.size) {
+                val read = source.read(buffer, length, buffer.size - length)
+                if (read == -1) break
+                length += read
+            }
+            if (source.exhausted()) {
+                interner.internJsonString(buffer, length)?.let { return it }
+            }
+            // Too long or rejected natively: let Moshi decode the whole token
+            val token = Buffer().write(buffer, 0, length)
+            token.writeAll(source)
+            return JsonReader.of(token).nextString()
+        }
+    }
+
+    @ToJson
+    fun toJson(@Interned value: String): String = value
+}
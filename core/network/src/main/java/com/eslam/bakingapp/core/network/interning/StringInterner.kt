@@ -0,0 +1,25 @@
+package com.eslam.bakingapp.core.network.interning
+
+/**
+ * Shares one String instance per distinct value of fields that repeat
+ * across a payload (recipe categories, difficulties, ingredient units).
+ *
+ * Used by [InternedStringAdapter] for properties marked [Interned].
+ * Implementation should be provided by the security module.
+ */
+interface StringInterner {
+
+    /**
+     * Whether [internJsonString] can be called at all
+     */
+    fun isAvailable(): Boolean
+
+    /**
+     * Decodes the JSON string token in token[0, length), quotes included,
+     * and returns the shared instance of its value
+     *
+     * @return null if the token is malformed or too long to intern; decode
+     *   it the usual way then
+     */
+    fun internJsonString(token: ByteArray, length: Int): String?
+}
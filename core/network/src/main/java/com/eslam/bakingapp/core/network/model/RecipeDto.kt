@@ -1,5 +1,6 @@
 package com.eslam.bakingapp.core.network.model
 
+import com.eslam.bakingapp.core.network.interning.Interned
 import com.squareup.moshi.Json
 import com.squareup.moshi.JsonClass
 
@@ -30,9 +31,11 @@ data class RecipeDto(
     val cookTimeMinutes: Int,
     
     @Json(name = "difficulty")
+    @Interned
     val difficulty: String,
     
     @Json(name = "category")
+    @Interned
     val category: String,
     
     @Json(name = "ingredients")
@@ -60,6 +63,7 @@ data class IngredientDto(
     val quantity: Double,
     
     @Json(name = "unit")
+    @Interned
     val unit: String
 )
 
@@ -0,0 +1,35 @@
+package com.eslam.bakingapp.core.network.telemetry
+
+/**
+ * Records hot-path events (auth header injections, key fetches, ...)
+ * into low-overhead binary telemetry instead of logcat.
+ *
+ * [record] must be cheap enough for every request and never block.
+ * Implementation should be provided by the security module.
+ */
+interface TelemetryRecorder {
+
+    /**
+     * @param value Event-specific detail, see [TelemetryEvent]
+     * @param extra Second event-specific detail
+     */
+    fun record(event: TelemetryEvent, value: Int = 0, extra: Long = 0L)
+}
+
+/**
+ * Telemetry event ids, shared with the native side
+ * (telemetry/telemetry-format.h); ids are never reused.
+ */
+enum class TelemetryEvent(val id: Int) {
+    /** The native library was loaded */
+    LIBRARY_LOAD(1),
+
+    /** A key was read from the native registry; value: its slot, or -1 for an unknown id */
+    KEY_FETCH(2),
+
+    /** A request passed the auth interceptor; value: 1 if a token was attached */
+    AUTH_HEADER(3),
+
+    /** A cooking timer tick; value: timers reported, extra: live timers */
+    TIMER_TICK(4)
+}
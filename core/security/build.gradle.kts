@@ -30,11 +30,15 @@ android {
                 // C++ flags for all build types
                 cppFlags += listOf(
                     "-std=c++17",
-                    "-fvisibility=hidden"
+                    "-fvisibility=hidden",
+                    "-fno-exceptions",
+                    "-fno-rtti"
                 )
                 // Additional arguments
+                // c++_static only supplies libc++ headers: CMake links with
+                // -nostdlib++, so no libc++_shared.so ships or gets loaded
                 arguments += listOf(
-                    "-DANDROID_STL=c++_shared",
+                    "-DANDROID_STL=c++_static",
                     "-DANDROID_TOOLCHAIN=clang"
                 )
             }
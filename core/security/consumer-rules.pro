@@ -15,6 +15,25 @@
     static <clinit>;
 }
 
+# ============================================================================
+# Native Bridges
+# ============================================================================
+# Every JNI bridge in this module (thumbnail pipeline, ...) is looked up by
+# its exact class and method name from native code
+-keepclasseswithmembernames class com.eslam.bakingapp.core.security.** {
+    native <methods>;
+}
+
+# Native job completion: jobs/jobs-jni.cpp looks the upcall up by name
+-keepclassmembers class com.eslam.bakingapp.core.security.jobs.NativeJobs {
+    static void onJobComplete(long, int, java.lang.Object);
+}
+
+# Link emulator releases: network/link-emulator-jni.cpp looks the upcall up by name
+-keepclassmembers class com.eslam.bakingapp.core.security.network.NativeLinkEmulator {
+    static void onRelease(long, boolean);
+}
+
 # ============================================================================
 # Public API
 # ============================================================================
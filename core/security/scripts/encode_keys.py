@@ -9,6 +9,8 @@ the compiled binary.
 Usage:
     python encode_keys.py "your_api_key" 0x5A
     python encode_keys.py --decode "0x38, 0x31, 0x1a" 0x5A
+    python encode_keys.py --definitions keys.properties > key-definitions.h
+    python encode_keys.py --blob keys.properties --blob-key HEX --output keys.blob
 
 Examples:
     # Encode an API key with XOR key 0x5A
@@ -20,6 +22,16 @@ Examples:
     # Decode existing encoded bytes
     python encode_keys.py --decode "0x38, 0x31, 0x1a, 0x3c" 0x5A
 
+    # Generate src/main/cpp/keys/key-definitions.h for the compile-time
+    # key registry from a properties file of `lookup.name=value` lines
+    python encode_keys.py --definitions keys.properties
+
+    # Seal the same properties into the encrypted key blob asset
+    # (src/main/assets/keys.blob) under the key in BAKINGAPP_BLOB_KEY; a
+    # new blob rotates keys without rebuilding the native library
+    python encode_keys.py --blob keys.properties --blob-key HEX \
+        --output src/main/assets/keys.blob
+
 Output can be directly pasted into native-keys.cpp
 
 SECURITY WARNING:
@@ -30,6 +42,8 @@ SECURITY WARNING:
 
 import sys
 import argparse
+import secrets
+import struct
 
 
 def encode_key(key: str, xor_key: int) -> list[str]:
@@ -93,6 +107,182 @@ def format_cpp_array(encoded: list[str], line_width: int = 8) -> str:
     return ",\n".join(lines)
 
 
+def parse_definitions(path: str) -> list[tuple[str, str, str]]:
+    """
+    Parse `lookup.name=value` lines into (identifier, name, value) triples.
+
+    The identifier is the upper-cased name with non-alphanumerics replaced
+    by underscores, e.g. "partner.grocer.api" -> PARTNER_GROCER_API.
+    Blank lines and lines starting with '#' are ignored.
+    """
+    definitions = []
+    with open(path, encoding="utf-8") as f:
+        for line_number, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            if "=" not in line:
+                raise ValueError(f"{path}:{line_number}: expected name=value")
+            name, value = (part.strip() for part in line.split("=", 1))
+            identifier = "".join(c if c.isalnum() else "_" for c in name).upper()
+            definitions.append((identifier, name, value))
+    return definitions
+
+
+def cpp_string(value: str) -> str:
+    """Quote a value as a C++ string literal."""
+    escaped = value.replace("\\", "\\\\").replace('"', '\\"')
+    return f'"{escaped}"'
+
+
+def format_definitions_header(definitions: list[tuple[str, str, str]], blob_key: str) -> str:
+    """
+    Format key-definitions.h for the native key registry.
+    """
+    entries = [
+        f"    KEY({identifier}, {cpp_string(name)}, {cpp_string(value)})"
+        for identifier, name, value in definitions
+    ]
+    width = max(len(entry) for entry in entries) + 1
+    lines = [
+        "/**",
+        " * Key definitions for the native key registry",
+        " *",
+        " * Generated by scripts/encode_keys.py --definitions. Do not commit.",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        "#define BAKINGAPP_KEY_DEFINITIONS(KEY)".ljust(width) + "\\",
+    ]
+    for i, entry in enumerate(entries):
+        lines.append(entry if i == len(entries) - 1 else entry.ljust(width) + "\\")
+    lines += [
+        "",
+        "/* ChaCha20 key of the encrypted key blob asset, as 64 hex digits */",
+        f"#define BAKINGAPP_BLOB_KEY {cpp_string(blob_key)}",
+    ]
+    return "\n".join(lines) + "\n"
+
+
+# ==================== Key blob (src/main/cpp/keys/key-blob.h) ====================
+
+BLOB_MAGIC = 0x424B4B42  # "BKKB"
+BLOB_VERSION = 1
+MAX_BLOB_VALUE_LENGTH = 255
+MASK64 = (1 << 64) - 1
+
+
+def fingerprint(name: str) -> int:
+    """FNV-1a with a splitmix64 finalizer, as fingerprint() in key-registry.h."""
+    h = 0xCBF29CE484222325
+    for byte in name.encode("utf-8"):
+        h ^= byte
+        h = (h * 0x100000001B3) & MASK64
+    h ^= h >> 30
+    h = (h * 0xBF58476D1CE4E5B9) & MASK64
+    h ^= h >> 27
+    h = (h * 0x94D049BB133111EB) & MASK64
+    h ^= h >> 31
+    return h
+
+
+def _rotl32(value: int, shift: int) -> int:
+    return ((value << shift) | (value >> (32 - shift))) & 0xFFFFFFFF
+
+
+def chacha20_block(key: bytes, counter: int, nonce: bytes) -> bytes:
+    """One ChaCha20 block (RFC 8439, section 2.3)."""
+    state = [0x61707865, 0x3320646E, 0x79622D32, 0x6B206574]
+    state += list(struct.unpack("<8I", key)) + [counter] + list(struct.unpack("<3I", nonce))
+    working = state[:]
+
+    def quarter(a, b, c, d):
+        working[a] = (working[a] + working[b]) & 0xFFFFFFFF
+        working[d] = _rotl32(working[d] ^ working[a], 16)
+        working[c] = (working[c] + working[d]) & 0xFFFFFFFF
+        working[b] = _rotl32(working[b] ^ working[c], 12)
+        working[a] = (working[a] + working[b]) & 0xFFFFFFFF
+        working[d] = _rotl32(working[d] ^ working[a], 8)
+        working[c] = (working[c] + working[d]) & 0xFFFFFFFF
+        working[b] = _rotl32(working[b] ^ working[c], 7)
+
+    for _ in range(10):
+        quarter(0, 4, 8, 12)
+        quarter(1, 5, 9, 13)
+        quarter(2, 6, 10, 14)
+        quarter(3, 7, 11, 15)
+        quarter(0, 5, 10, 15)
+        quarter(1, 6, 11, 12)
+        quarter(2, 7, 8, 13)
+        quarter(3, 4, 9, 14)
+    return struct.pack("<16I", *((w + s) & 0xFFFFFFFF for w, s in zip(working, state)))
+
+
+def chacha20_xor(key: bytes, counter: int, nonce: bytes, data: bytes) -> bytes:
+    out = bytearray()
+    for block in range(0, len(data), 64):
+        stream = chacha20_block(key, counter + block // 64, nonce)
+        out += bytes(a ^ b for a, b in zip(data[block:block + 64], stream))
+    return bytes(out)
+
+
+def poly1305(key: bytes, message: bytes) -> bytes:
+    """Poly1305 one-time MAC (RFC 8439, section 2.5)."""
+    r = int.from_bytes(key[:16], "little") & 0x0FFFFFFC0FFFFFFC0FFFFFFC0FFFFFFF
+    s = int.from_bytes(key[16:], "little")
+    p = (1 << 130) - 5
+    accumulator = 0
+    for i in range(0, len(message), 16):
+        chunk = message[i:i + 16] + b"\x01"
+        accumulator = (accumulator + int.from_bytes(chunk, "little")) * r % p
+    return ((accumulator + s) & ((1 << 128) - 1)).to_bytes(16, "little")
+
+
+def aead_seal(key: bytes, nonce: bytes, aad: bytes, plaintext: bytes) -> bytes:
+    """ChaCha20-Poly1305 (RFC 8439, section 2.8): ciphertext followed by the tag."""
+    mac_key = chacha20_block(key, 0, nonce)[:32]
+    ciphertext = chacha20_xor(key, 1, nonce, plaintext)
+
+    def pad16(data: bytes) -> bytes:
+        return b"\x00" * (-len(data) % 16)
+
+    mac_data = (aad + pad16(aad) + ciphertext + pad16(ciphertext) +
+                struct.pack("<QQ", len(aad), len(ciphertext)))
+    return ciphertext + poly1305(mac_key, mac_data)
+
+
+def build_blob(definitions: list[tuple[str, str, str]], key: bytes) -> bytes:
+    """
+    Seal definitions into the key blob format read by KeyBlob: a header,
+    an index sorted by name fingerprint and one sealed value per entry.
+    """
+    entries = sorted(((fingerprint(name), value.encode("utf-8"))
+                      for _, name, value in definitions), key=lambda e: e[0])
+    for (previous, _), (current, _) in zip(entries, entries[1:]):
+        if previous == current:
+            raise ValueError("two key names share a fingerprint")
+    header = struct.pack("<4I", BLOB_MAGIC, BLOB_VERSION, len(entries), 0)
+    index = bytearray()
+    values = bytearray()
+    offset = len(header) + 32 * len(entries)
+    for fp, value in entries:
+        if len(value) > MAX_BLOB_VALUE_LENGTH:
+            raise ValueError(f"values are limited to {MAX_BLOB_VALUE_LENGTH} bytes")
+        nonce = secrets.token_bytes(12)
+        entry = struct.pack("<QII12sI", fp, offset + len(values), len(value), nonce, 0)
+        index += entry
+        values += aead_seal(key, nonce, entry, value)
+    return header + bytes(index) + bytes(values)
+
+
+def parse_blob_key(blob_key: str) -> bytes:
+    key = bytes.fromhex(blob_key)
+    if len(key) != 32:
+        raise ValueError("the blob key is 64 hex digits")
+    return key
+
+
 def main():
     parser = argparse.ArgumentParser(
         description="XOR encode/decode API keys for native library",
@@ -102,13 +292,39 @@ def main():
     
     parser.add_argument(
         "key",
+        nargs="?",
         help="The key to encode, or hex bytes to decode (with --decode)"
     )
     
     parser.add_argument(
         "xor_key",
+        nargs="?",
         help="XOR key in hex (e.g., 0x5A) or decimal (e.g., 90)"
     )
+
+    parser.add_argument(
+        "--definitions",
+        metavar="PROPERTIES",
+        help="Generate key-definitions.h from a properties file"
+    )
+
+    parser.add_argument(
+        "--blob",
+        metavar="PROPERTIES",
+        help="Seal a properties file into the encrypted key blob asset"
+    )
+
+    parser.add_argument(
+        "--blob-key",
+        metavar="HEX",
+        help="Blob key, 64 hex digits (--definitions creates one if omitted)"
+    )
+
+    parser.add_argument(
+        "--output", "-o",
+        metavar="FILE",
+        help="Where --blob writes the blob"
+    )
     
     parser.add_argument(
         "--decode", "-d",
@@ -123,6 +339,34 @@ def main():
     )
     
     args = parser.parse_args()
+
+    if args.definitions:
+        definitions = parse_definitions(args.definitions)
+        if not definitions:
+            print("Error: no key definitions found", file=sys.stderr)
+            sys.exit(1)
+        blob_key = args.blob_key
+        if blob_key is None:
+            blob_key = secrets.token_hex(32)
+            print("Note: generated a new blob key; pass it to --blob-key "
+                  "when sealing the key blob", file=sys.stderr)
+        parse_blob_key(blob_key)
+        print(format_definitions_header(definitions, blob_key), end="")
+        return
+
+    if args.blob:
+        if args.blob_key is None or args.output is None:
+            parser.error("--blob needs --blob-key and --output")
+        definitions = parse_definitions(args.blob)
+        blob = build_blob(definitions, parse_blob_key(args.blob_key))
+        with open(args.output, "wb") as f:
+            f.write(blob)
+        print(f"Sealed {len(definitions)} keys into {args.output} ({len(blob)} bytes)",
+              file=sys.stderr)
+        return
+
+    if args.key is None or args.xor_key is None:
+        parser.error("key and xor_key are required unless --definitions or --blob is used")
     
     # Parse XOR key
     xor_key_str = args.xor_key
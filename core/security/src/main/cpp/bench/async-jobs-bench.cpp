@@ -0,0 +1,166 @@
+/**
+ * Asynchronous job benchmark
+ *
+ * Usage: async-jobs-bench [jobs]
+ *
+ * Puts 10k jobs (each XXH64 over 64 KiB) in flight at once on the shared
+ * pool from a single submitting thread, the way NativeJobs callers do:
+ * - submit:  cost per submission on the calling thread
+ * - latency: submission to finish(), p50 / p99 / max
+ * - cancel:  the same load with every other job cancelled right after
+ *   submission; reports how many cancelled jobs still did their work
+ * - blocking: the same work as blocking calls spread over 64 threads (the
+ *   size of Dispatchers.IO), each held for the whole call
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+
+#include "bench/bench-util.h"
+#include "common/async-jobs.h"
+#include "common/hash.h"
+#include "common/thread-pool.h"
+
+using namespace bakingapp;
+using namespace bakingapp::bench;
+
+namespace {
+    constexpr uint32_t DEFAULT_JOBS = 10000;
+    constexpr size_t WORK_BYTES = 64u << 10;
+    constexpr uint32_t BLOCKING_THREADS = 64;
+
+    uint8_t* workData = nullptr;
+
+    struct BenchJob : Job {
+        uint64_t submittedAt;
+        uint64_t finishedAt;
+        uint64_t hash;
+        bool worked;
+        std::atomic<uint32_t>* finished;
+    };
+
+    JobStatus hashWork(Job* job) {
+        auto* bench = static_cast<BenchJob*>(job);
+        bench->hash = hash64(workData, WORK_BYTES);
+        bench->worked = true;
+        return JobStatus::DONE;
+    }
+
+    void recordFinish(Job* job, JobStatus /* status */) {
+        auto* bench = static_cast<BenchJob*>(job);
+        bench->finishedAt = nowNanos();
+        bench->finished->fetch_add(1, std::memory_order_release);
+    }
+
+    int compareU64(const void* a, const void* b) {
+        const uint64_t x = *static_cast<const uint64_t*>(a);
+        const uint64_t y = *static_cast<const uint64_t*>(b);
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+
+    /**
+     * Submits count jobs, optionally cancelling every other one, and waits
+     * for all of them to finish
+     */
+    void runJobs(uint32_t count, bool cancelHalf, uint64_t idBase) {
+        auto* jobs = static_cast<BenchJob*>(calloc(count, sizeof(BenchJob)));
+        auto* latencies = static_cast<uint64_t*>(malloc(count * sizeof(uint64_t)));
+        std::atomic<uint32_t> finished {0};
+        AsyncJobs& registry = AsyncJobs::shared();
+
+        uint32_t peak = 0;
+        const uint64_t start = nowNanos();
+        for (uint32_t i = 0; i < count; i++) {
+            BenchJob* job = new (&jobs[i]) BenchJob();
+            job->id = idBase + i;
+            job->work = hashWork;
+            job->finish = recordFinish;
+            job->finished = &finished;
+            job->submittedAt = nowNanos();
+            if (!registry.submit(job)) {
+                fprintf(stderr, "submit failed\n");
+                exit(1);
+            }
+            if (cancelHalf && i % 2 == 1) registry.cancel(job->id);
+            if (registry.inFlight() > peak) peak = registry.inFlight();
+        }
+        const uint64_t submitted = nowNanos();
+        while (finished.load(std::memory_order_acquire) != count) sched_yield();
+        const uint64_t done = nowNanos();
+
+        uint32_t worked = 0;
+        uint32_t cancelledButWorked = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            latencies[i] = jobs[i].finishedAt - jobs[i].submittedAt;
+            worked += jobs[i].worked;
+            if (cancelHalf && i % 2 == 1 && jobs[i].worked) cancelledButWorked++;
+            doNotOptimize(jobs[i].hash);
+        }
+        qsort(latencies, count, sizeof(uint64_t), compareU64);
+
+        printf("%-10s %10.0f %10.2f %10.2f %10.2f %10.1f %8u %8u",
+               cancelHalf ? "cancel" : "async", (submitted - start) / static_cast<double>(count),
+               latencies[count / 2] / 1e6, latencies[count * 99 / 100] / 1e6,
+               latencies[count - 1] / 1e6, (done - start) / 1e6, peak, worked);
+        if (cancelHalf) printf("  (%u cancelled jobs ran anyway)", cancelledButWorked);
+        printf("\n");
+        free(latencies);
+        free(jobs);
+    }
+
+    struct BlockingSlice {
+        uint32_t count;
+        uint64_t hash;
+    };
+
+    void* blockingThread(void* argument) {
+        auto* slice = static_cast<BlockingSlice*>(argument);
+        for (uint32_t i = 0; i < slice->count; i++) slice->hash ^= hash64(workData, WORK_BYTES);
+        return nullptr;
+    }
+
+    void runBlocking(uint32_t count) {
+        pthread_t threads[BLOCKING_THREADS];
+        BlockingSlice slices[BLOCKING_THREADS] = {};
+        const uint64_t start = nowNanos();
+        for (uint32_t t = 0; t < BLOCKING_THREADS; t++) {
+            slices[t].count = count / BLOCKING_THREADS + (t < count % BLOCKING_THREADS ? 1 : 0);
+            pthread_create(&threads[t], nullptr, blockingThread, &slices[t]);
+        }
+        for (uint32_t t = 0; t < BLOCKING_THREADS; t++) {
+            pthread_join(threads[t], nullptr);
+            doNotOptimize(slices[t].hash);
+        }
+        printf("%-10s %10s %10s %10s %10s %10.1f %8u %8u  (%u threads blocked)\n", "blocking", "-",
+               "-", "-", "-", (nowNanos() - start) / 1e6, count, count, BLOCKING_THREADS);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t count = DEFAULT_JOBS;
+    if (argc > 1) count = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    if (count < 2) count = 2;
+
+    workData = static_cast<uint8_t*>(malloc(WORK_BYTES));
+    Random random;
+    for (size_t i = 0; i < WORK_BYTES; i++) workData[i] = static_cast<uint8_t>(random.next());
+
+    printHeader("async native jobs");
+    printf("%u jobs of XXH64 over %zu KiB, %u pool workers, %zu bytes per in-flight job\n",
+           count, WORK_BYTES >> 10, ThreadPool::shared().workerCount(), sizeof(BenchJob));
+    printf("%-10s %10s %10s %10s %10s %10s %8s %8s\n", "mode", "submit ns", "p50 ms",
+           "p99 ms", "max ms", "total ms", "peak", "worked");
+
+    runJobs(count, false, 1);
+    runJobs(count, true, uint64_t {1} << 32);
+    runBlocking(count);
+
+    free(workData);
+    return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * Shared helpers for the host-side native benchmarks
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+
+namespace bakingapp::bench {
+
+inline uint64_t nowNanos() {
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * Deterministic xorshift generator so runs are comparable
+ */
+struct Random {
+    uint64_t state;
+
+    explicit Random(uint64_t seed = 0x9E3779B97F4A7C15ULL) : state(seed) {}
+
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(next() % bound);
+    }
+};
+
+/**
+ * Prevents the optimizer from discarding a computed value
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void printHeader(const char* title) {
+    printf("\n== %s ==\n", title);
+}
+
+} // namespace bakingapp::bench
@@ -0,0 +1,311 @@
+/**
+ * Recipe bulk insert benchmark
+ *
+ * Usage: bulk-insert-bench [recipes] [directory]
+ *
+ * Inserts recipes with 20 ingredients and 10 steps each (100k recipes,
+ * 3.1M rows by default) into the Room schema of BakingDatabase, all in one
+ * transaction, against the host's system SQLite:
+ * - room:      what Room's generated insert adapters do, one compiled
+ *              single-row statement per table, bound and run once per row
+ * - reprepare: single-row statements compiled for every row
+ * - multi-row: RecipeBulkLoader, multi-row INSERTs filling SQLite's 999
+ *              bind variables, compiled once and reused across chunks
+ *
+ * The JVM-side cost Room adds on top (entity objects, lists and adapter
+ * calls per row) is not measured here, so the gap on a device is larger.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sqlite3.h>
+#include <unistd.h>
+
+#include "bench/bench-util.h"
+
+using namespace bakingapp;
+
+namespace {
+    constexpr int INGREDIENTS_PER_RECIPE = 20;
+    constexpr int STEPS_PER_RECIPE = 10;
+    constexpr int MAX_BIND_VARIABLES = 999;
+
+    // Matches the schema Room generates for the entities in core/database
+    const char* const SCHEMA =
+        "CREATE TABLE IF NOT EXISTS `recipes` (`id` TEXT NOT NULL, `name` TEXT NOT NULL, "
+        "`description` TEXT NOT NULL, `image_url` TEXT, `servings` INTEGER NOT NULL, "
+        "`prep_time_minutes` INTEGER NOT NULL, `cook_time_minutes` INTEGER NOT NULL, "
+        "`difficulty` TEXT NOT NULL, `category` TEXT NOT NULL, `is_favorite` INTEGER NOT NULL, "
+        "`created_at` INTEGER NOT NULL, `updated_at` INTEGER NOT NULL, PRIMARY KEY(`id`));"
+        "CREATE TABLE IF NOT EXISTS `ingredients` (`id` TEXT NOT NULL, `recipe_id` TEXT NOT NULL, "
+        "`name` TEXT NOT NULL, `quantity` REAL NOT NULL, `unit` TEXT NOT NULL, "
+        "PRIMARY KEY(`id`, `recipe_id`));"
+        "CREATE TABLE IF NOT EXISTS `steps` (`id` TEXT NOT NULL, `recipe_id` TEXT NOT NULL, "
+        "`order` INTEGER NOT NULL, `description` TEXT NOT NULL, `video_url` TEXT, "
+        "`thumbnail_url` TEXT, PRIMARY KEY(`id`, `recipe_id`));";
+
+    struct Table {
+        const char* prefix;
+        const char* row;
+        int columns;
+    };
+
+    const Table RECIPES {
+        "INSERT OR REPLACE INTO `recipes` (`id`,`name`,`description`,`image_url`,`servings`,"
+        "`prep_time_minutes`,`cook_time_minutes`,`difficulty`,`category`,`is_favorite`,"
+        "`created_at`,`updated_at`) VALUES ",
+        "(?,?,?,?,?,?,?,?,?,?,?,?)", 12};
+    const Table INGREDIENTS {
+        "INSERT OR REPLACE INTO `ingredients` (`id`,`recipe_id`,`name`,`quantity`,`unit`) VALUES ",
+        "(?,?,?,?,?)", 5};
+    const Table STEPS {
+        "INSERT OR REPLACE INTO `steps` (`id`,`recipe_id`,`order`,`description`,`video_url`,"
+        "`thumbnail_url`) VALUES ",
+        "(?,?,?,?,?,?)", 6};
+
+    const char* const UNITS[] = {"g", "kg", "ml", "cup", "tbsp", "tsp", "oz", "pinch"};
+
+    enum class Strategy { Room, Reprepare, MultiRow };
+
+    /**
+     * Compiles an insert of rows rows; reprepare mode pays this for every row
+     */
+    sqlite3_stmt* prepare(sqlite3* db, const Table& table, int rows) {
+        static char sql[64 * 1024];
+        size_t length = strlen(table.prefix);
+        memcpy(sql, table.prefix, length);
+        const size_t rowLength = strlen(table.row);
+        for (int r = 0; r < rows; r++) {
+            if (r > 0) sql[length++] = ',';
+            memcpy(sql + length, table.row, rowLength);
+            length += rowLength;
+        }
+        sql[length] = '\0';
+        sqlite3_stmt* statement = nullptr;
+        if (sqlite3_prepare_v2(db, sql, static_cast<int>(length), &statement, nullptr) != SQLITE_OK) {
+            fprintf(stderr, "prepare: %s\n", sqlite3_errmsg(db));
+            exit(EXIT_FAILURE);
+        }
+        return statement;
+    }
+
+    void bindText(sqlite3_stmt* statement, int index, const char* text) {
+        sqlite3_bind_text(statement, index, text, -1, SQLITE_STATIC);
+    }
+
+    /**
+     * Binds one row starting at parameter index first (1-based)
+     */
+    void bindRecipe(sqlite3_stmt* s, int first, int recipe, const char* id) {
+        bindText(s, first, id);
+        bindText(s, first + 1, "Chocolate Chip Cookies");
+        bindText(s, first + 2, "Classic cookies with a crisp edge and a chewy middle");
+        if (recipe % 4 == 0) {
+            sqlite3_bind_null(s, first + 3);
+        } else {
+            bindText(s, first + 3, "https://example.com/images/cookies.jpg");
+        }
+        sqlite3_bind_int(s, first + 4, 4 + recipe % 8);
+        sqlite3_bind_int(s, first + 5, 15);
+        sqlite3_bind_int(s, first + 6, 12);
+        bindText(s, first + 7, "Easy");
+        bindText(s, first + 8, "Cookies");
+        sqlite3_bind_int(s, first + 9, 0);
+        sqlite3_bind_int64(s, first + 10, 1700000000000 + recipe);
+        sqlite3_bind_int64(s, first + 11, 1700000000000 + recipe);
+    }
+
+    void bindIngredient(sqlite3_stmt* s, int first, const char* recipeId, int index, char* id) {
+        snprintf(id, 24, "ing-%d", index);
+        bindText(s, first, id);
+        bindText(s, first + 1, recipeId);
+        bindText(s, first + 2, "all-purpose flour");
+        sqlite3_bind_double(s, first + 3, 0.25 * (index + 1));
+        bindText(s, first + 4, UNITS[index % 8]);
+    }
+
+    void bindStep(sqlite3_stmt* s, int first, const char* recipeId, int index, char* id) {
+        snprintf(id, 24, "step-%d", index);
+        bindText(s, first, id);
+        bindText(s, first + 1, recipeId);
+        sqlite3_bind_int(s, first + 2, index + 1);
+        bindText(s, first + 3, "Whisk the butter and sugar until pale, then fold in the flour.");
+        sqlite3_bind_null(s, first + 4);
+        sqlite3_bind_null(s, first + 5);
+    }
+
+    void run(sqlite3* db, sqlite3_stmt* statement) {
+        if (sqlite3_step(statement) != SQLITE_DONE) {
+            fprintf(stderr, "step: %s\n", sqlite3_errmsg(db));
+            exit(EXIT_FAILURE);
+        }
+        sqlite3_reset(statement);
+    }
+
+    /**
+     * Row-at-a-time insert (Room adapters, or reprepare)
+     */
+    void insertRowByRow(sqlite3* db, int recipes, bool reuse) {
+        sqlite3_stmt* recipe = reuse ? prepare(db, RECIPES, 1) : nullptr;
+        sqlite3_stmt* ingredient = reuse ? prepare(db, INGREDIENTS, 1) : nullptr;
+        sqlite3_stmt* step = reuse ? prepare(db, STEPS, 1) : nullptr;
+        char ids[2][24];
+
+        for (int r = 0; r < recipes; r++) {
+            if (!reuse) recipe = prepare(db, RECIPES, 1);
+            snprintf(ids[0], sizeof(ids[0]), "recipe-%d", r);
+            bindRecipe(recipe, 1, r, ids[0]);
+            run(db, recipe);
+            if (!reuse) sqlite3_finalize(recipe);
+
+            // Room's insertRecipeWithDetails: ingredients, then steps
+            for (int i = 0; i < INGREDIENTS_PER_RECIPE; i++) {
+                if (!reuse) ingredient = prepare(db, INGREDIENTS, 1);
+                bindIngredient(ingredient, 1, ids[0], i, ids[1]);
+                run(db, ingredient);
+                if (!reuse) sqlite3_finalize(ingredient);
+            }
+            for (int i = 0; i < STEPS_PER_RECIPE; i++) {
+                if (!reuse) step = prepare(db, STEPS, 1);
+                bindStep(step, 1, ids[0], i, ids[1]);
+                run(db, step);
+                if (!reuse) sqlite3_finalize(step);
+            }
+        }
+        if (reuse) {
+            sqlite3_finalize(recipe);
+            sqlite3_finalize(ingredient);
+            sqlite3_finalize(step);
+        }
+    }
+
+    /**
+     * Table-at-a-time multi-row insert. The recipe ids must outlive the
+     * statements (SQLITE_STATIC), so they are formatted up front, as the
+     * batch holds them.
+     */
+    void insertMultiRow(sqlite3* db, int recipes) {
+        auto* recipeIds = static_cast<char(*)[24]>(malloc(sizeof(char[24]) * recipes));
+        auto* childIds = static_cast<char(*)[24]>(malloc(sizeof(char[24]) * MAX_BIND_VARIABLES));
+        for (int r = 0; r < recipes; r++) snprintf(recipeIds[r], 24, "recipe-%d", r);
+
+        // Recipes
+        {
+            const int perStatement = MAX_BIND_VARIABLES / RECIPES.columns;
+            sqlite3_stmt* full = prepare(db, RECIPES, perStatement);
+            for (int start = 0; start < recipes; start += perStatement) {
+                const int rows = recipes - start < perStatement ? recipes - start : perStatement;
+                sqlite3_stmt* s = rows == perStatement ? full : prepare(db, RECIPES, rows);
+                for (int r = 0; r < rows; r++) {
+                    bindRecipe(s, 1 + r * RECIPES.columns, start + r, recipeIds[start + r]);
+                }
+                run(db, s);
+                if (s != full) sqlite3_finalize(s);
+            }
+            sqlite3_finalize(full);
+        }
+
+        // Ingredients and steps: rows flattened across recipes
+        const Table* tables[] = {&INGREDIENTS, &STEPS};
+        const int perRecipe[] = {INGREDIENTS_PER_RECIPE, STEPS_PER_RECIPE};
+        for (int t = 0; t < 2; t++) {
+            const Table& table = *tables[t];
+            const int perStatement = MAX_BIND_VARIABLES / table.columns;
+            const int64_t total = static_cast<int64_t>(recipes) * perRecipe[t];
+            sqlite3_stmt* full = prepare(db, table, perStatement);
+            for (int64_t start = 0; start < total; start += perStatement) {
+                const int rows = total - start < perStatement ? static_cast<int>(total - start) : perStatement;
+                sqlite3_stmt* s = rows == perStatement ? full : prepare(db, table, rows);
+                for (int r = 0; r < rows; r++) {
+                    const int64_t row = start + r;
+                    const char* recipeId = recipeIds[row / perRecipe[t]];
+                    const int index = static_cast<int>(row % perRecipe[t]);
+                    if (t == 0) {
+                        bindIngredient(s, 1 + r * table.columns, recipeId, index, childIds[r]);
+                    } else {
+                        bindStep(s, 1 + r * table.columns, recipeId, index, childIds[r]);
+                    }
+                }
+                run(db, s);
+                if (s != full) sqlite3_finalize(s);
+            }
+            sqlite3_finalize(full);
+        }
+        free(recipeIds);
+        free(childIds);
+    }
+
+    double measure(const char* directory, int recipes, Strategy strategy) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/bulk-insert-bench.%d.db", directory, static_cast<int>(getpid()));
+        unlink(path);
+
+        sqlite3* db = nullptr;
+        if (sqlite3_open(path, &db) != SQLITE_OK) {
+            fprintf(stderr, "cannot open %s\n", path);
+            exit(EXIT_FAILURE);
+        }
+        // What Room configures on Android: WAL with synchronous=FULL
+        sqlite3_exec(db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=FULL;", nullptr, nullptr, nullptr);
+        sqlite3_exec(db, SCHEMA, nullptr, nullptr, nullptr);
+
+        const uint64_t start = bench::nowNanos();
+        sqlite3_exec(db, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr);
+        switch (strategy) {
+            case Strategy::Room: insertRowByRow(db, recipes, true); break;
+            case Strategy::Reprepare: insertRowByRow(db, recipes, false); break;
+            case Strategy::MultiRow: insertMultiRow(db, recipes); break;
+        }
+        sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
+        const double seconds = static_cast<double>(bench::nowNanos() - start) / 1e9;
+
+        sqlite3_stmt* count = nullptr;
+        sqlite3_prepare_v2(db, "SELECT (SELECT COUNT(*) FROM recipes) + (SELECT COUNT(*) FROM "
+                           "ingredients) + (SELECT COUNT(*) FROM steps)", -1, &count, nullptr);
+        sqlite3_step(count);
+        const int64_t rows = sqlite3_column_int64(count, 0);
+        sqlite3_finalize(count);
+        sqlite3_close(db);
+
+        char sidecar[600];
+        unlink(path);
+        snprintf(sidecar, sizeof(sidecar), "%s-wal", path);
+        unlink(sidecar);
+        snprintf(sidecar, sizeof(sidecar), "%s-shm", path);
+        unlink(sidecar);
+
+        const int64_t expected =
+            static_cast<int64_t>(recipes) * (1 + INGREDIENTS_PER_RECIPE + STEPS_PER_RECIPE);
+        if (rows != expected) {
+            fprintf(stderr, "inserted %lld rows, expected %lld\n", static_cast<long long>(rows),
+                    static_cast<long long>(expected));
+            exit(EXIT_FAILURE);
+        }
+        return static_cast<double>(rows) / seconds;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int recipes = argc > 1 ? atoi(argv[1]) : 100000;
+    const char* directory = argc > 2 ? argv[2] : "/tmp";
+    if (recipes <= 0) {
+        fprintf(stderr, "usage: bulk-insert-bench [recipes] [directory]\n");
+        return EXIT_FAILURE;
+    }
+
+    bench::printHeader("Recipe bulk insert (rows/s, one transaction)");
+    printf("recipes: %d, rows: %lld, SQLite %s\n", recipes,
+           static_cast<long long>(recipes) * (1 + INGREDIENTS_PER_RECIPE + STEPS_PER_RECIPE),
+           sqlite3_libversion());
+    printf("%12s %14s %10s\n", "strategy", "rows/s", "speedup");
+
+    const double room = measure(directory, recipes, Strategy::Room);
+    const double reprepare = measure(directory, recipes, Strategy::Reprepare);
+    const double multiRow = measure(directory, recipes, Strategy::MultiRow);
+    printf("%12s %14.0f %9.2fx\n", "room", room, 1.0);
+    printf("%12s %14.0f %9.2fx\n", "reprepare", reprepare, reprepare / room);
+    printf("%12s %14.0f %9.2fx\n", "multi-row", multiRow, multiRow / room);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,238 @@
+/**
+ * Content-hash delta sync benchmark
+ *
+ * Usage: delta-sync-bench [directory]
+ *
+ * A 100k-recipe list response (bench/recipe-corpus.h), then the same list
+ * with 1% churn: 0.5% of the recipes edited, 0.25% deleted and 0.25% new.
+ * - split / hash: throughput of the record splitter and of XXH64 over the
+ *   record ranges on their own
+ * - diff:   split + hash + table lookups for the whole body, best of 5
+ * - commit: folding the accepted diff into the mapped table
+ * - rows:   recipe, ingredient and step rows a full rewrite writes versus
+ *   the rows of the records the delta reports
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "bench/bench-util.h"
+#include "bench/recipe-corpus.h"
+#include "common/hash.h"
+#include "sync/delta-table.h"
+#include "sync/json-records.h"
+
+using namespace bakingapp;
+using namespace bakingapp::sync;
+
+namespace {
+    constexpr uint32_t RECIPES = 100000;
+    constexpr uint32_t EDIT_EVERY = 200;        // 0.5%
+    constexpr uint32_t DELETE_EVERY = 400;      // 0.25%
+    constexpr uint32_t ADDED = RECIPES / 400;   // 0.25%
+    constexpr size_t BYTES_PER_RECIPE = 4096;
+    constexpr int RUNS = 5;
+
+    struct Body {
+        uint8_t* data;
+        size_t length;
+    };
+
+    size_t countOf(const uint8_t* data, size_t length, const char* needle) {
+        const size_t needleLength = strlen(needle);
+        size_t count = 0;
+        const uint8_t* p = data;
+        const uint8_t* end = data + length;
+        while (p < end) {
+            const void* found = memmem(p, static_cast<size_t>(end - p), needle, needleLength);
+            if (found == nullptr) break;
+            count++;
+            p = static_cast<const uint8_t*>(found) + needleLength;
+        }
+        return count;
+    }
+
+    // One recipe row plus one per ingredient and step
+    size_t rowsOf(const uint8_t* record, size_t length) {
+        return 1 + countOf(record, length, "\"quantity\":") + countOf(record, length, "\"order\":");
+    }
+
+    /**
+     * Rows of the records in body whose ids have the given kinds in list
+     */
+    size_t rowsOfDelta(const Body& body, const DeltaList& list, bool deleted) {
+        constexpr uint32_t BUCKETS = 1 << 14;
+        auto* ids = static_cast<uint64_t*>(calloc(BUCKETS, sizeof(uint64_t)));
+        for (size_t p = 0; p < list.length; p += 2 + list.data[p + 1]) {
+            if ((list.data[p] == static_cast<uint8_t>(DeltaKind::DELETED)) != deleted) continue;
+            const uint64_t key = hash64(list.data + p + 2, list.data[p + 1]) | 1;
+            uint32_t i = static_cast<uint32_t>(key) & (BUCKETS - 1);
+            while (ids[i] != 0) i = (i + 1) & (BUCKETS - 1);
+            ids[i] = key;
+        }
+
+        size_t rows = 0;
+        JsonRecordScanner scanner;
+        JsonRecord record;
+        scanner.open(body.data, body.length, "recipes");
+        while (scanner.next(&record)) {
+            const uint64_t key = hash64(body.data + record.idOffset, record.idLength) | 1;
+            for (uint32_t i = static_cast<uint32_t>(key) & (BUCKETS - 1); ids[i] != 0;
+                 i = (i + 1) & (BUCKETS - 1)) {
+                if (ids[i] == key) {
+                    rows += rowsOf(body.data + record.offset, record.length);
+                    break;
+                }
+            }
+        }
+        free(ids);
+        return rows;
+    }
+
+    /**
+     * The base list with every EDIT_EVERY-th recipe's name touched, every
+     * DELETE_EVERY-th dropped and ADDED new ones appended
+     */
+    Body churn(const Body& base) {
+        const size_t capacity = base.length + ADDED * BYTES_PER_RECIPE;
+        auto* out = static_cast<uint8_t*>(malloc(capacity));
+        size_t n = 0;
+        auto put = [&](const void* data, size_t length) {
+            memcpy(out + n, data, length);
+            n += length;
+        };
+        put("{\"recipes\":[", 12);
+
+        JsonRecordScanner scanner;
+        JsonRecord record;
+        scanner.open(base.data, base.length, "recipes");
+        bool first = true;
+        for (uint32_t i = 0; scanner.next(&record); i++) {
+            if (i % DELETE_EVERY == DELETE_EVERY - 1) continue;
+            if (!first) put(",", 1);
+            first = false;
+            const size_t start = n;
+            put(base.data + record.offset, record.length);
+            if (i % EDIT_EVERY == 0) {
+                auto* name = static_cast<uint8_t*>(memmem(out + start, record.length, "\"name\":\"", 8));
+                if (name != nullptr) name[8] ^= 0x20;   // flip the case of the first letter
+            }
+        }
+
+        bench::Random random(7);
+        auto* added = static_cast<char*>(malloc(ADDED * BYTES_PER_RECIPE));
+        const size_t addedLength = bench::makeRecipeListJson(random, RECIPES / ADDED, ADDED, added,
+                                                             ADDED * BYTES_PER_RECIPE);
+        const auto* addedBody = reinterpret_cast<const uint8_t*>(added);
+        scanner.open(addedBody, addedLength, "recipes");
+        while (scanner.next(&record)) {
+            put(",", 1);
+            put(addedBody + record.offset, record.length);
+        }
+        free(added);
+        put("]}", 2);
+        return {out, n};
+    }
+
+    double gbPerSecond(size_t bytes, uint64_t nanos) {
+        return static_cast<double>(bytes) / static_cast<double>(nanos);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* directory = argc > 1 ? argv[1] : "/tmp";
+    char path[512];
+    snprintf(path, sizeof(path), "%s/delta-sync-bench.%d", directory, static_cast<int>(getpid()));
+    unlink(path);
+
+    bench::Random random(42);
+    auto* text = static_cast<char*>(malloc(RECIPES * BYTES_PER_RECIPE));
+    const size_t length = bench::makeRecipeListJson(random, 0, RECIPES, text,
+                                                    RECIPES * BYTES_PER_RECIPE);
+    const Body base {reinterpret_cast<uint8_t*>(text), length};
+    const Body next = churn(base);
+
+    bench::printHeader("Delta sync");
+    printf("%u recipes, %.1f MB body, churned body %.1f MB\n\n", RECIPES, length / 1e6,
+           next.length / 1e6);
+
+    // Splitter and hash on their own
+    auto* records = static_cast<JsonRecord*>(malloc((RECIPES + ADDED) * sizeof(JsonRecord)));
+    size_t count = 0;
+    size_t hashedBytes = 0;
+    uint64_t split = UINT64_MAX;
+    uint64_t hashed = UINT64_MAX;
+    for (int r = 0; r < RUNS; r++) {
+        JsonRecordScanner scanner;
+        uint64_t start = bench::nowNanos();
+        scanner.open(next.data, next.length, "recipes");
+        count = 0;
+        while (count < RECIPES + ADDED && scanner.next(&records[count])) count++;
+        uint64_t elapsed = bench::nowNanos() - start;
+        if (elapsed < split) split = elapsed;
+
+        uint64_t total = 0;
+        hashedBytes = 0;
+        start = bench::nowNanos();
+        for (size_t i = 0; i < count; i++) {
+            total ^= hash64(next.data + records[i].offset, records[i].length);
+            hashedBytes += records[i].length;
+        }
+        bench::doNotOptimize(total);
+        elapsed = bench::nowNanos() - start;
+        if (elapsed < hashed) hashed = elapsed;
+    }
+    free(records);
+    printf("%-28s %10.2f GB/s  (%zu records)\n", "split", gbPerSecond(next.length, split), count);
+    printf("%-28s %10.2f GB/s\n\n", "hash (XXH64)", gbPerSecond(hashedBytes, hashed));
+
+    DeltaTable table;
+    if (!table.open(path)) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return EXIT_FAILURE;
+    }
+    DeltaList list;
+
+    uint64_t start = bench::nowNanos();
+    table.diff(base.data, base.length, "recipes", &list);
+    const uint64_t firstDiff = bench::nowNanos() - start;
+    start = bench::nowNanos();
+    table.commit();
+    const uint64_t firstCommit = bench::nowNanos() - start;
+    printf("%-28s %10.1f ms  (%u inserted)\n", "first sync diff", firstDiff / 1e6, list.inserted);
+    printf("%-28s %10.1f ms\n", "first sync commit", firstCommit / 1e6);
+
+    uint64_t churnDiff = UINT64_MAX;
+    for (int r = 0; r < RUNS; r++) {
+        start = bench::nowNanos();
+        table.diff(next.data, next.length, "recipes", &list);
+        const uint64_t elapsed = bench::nowNanos() - start;
+        if (elapsed < churnDiff) churnDiff = elapsed;
+    }
+    printf("%-28s %10.1f ms  (%.2f GB/s)\n", "1% churn diff", churnDiff / 1e6,
+           gbPerSecond(next.length, churnDiff));
+    printf("%-28s %10u / %u / %u / %u\n", "inserted/changed/deleted/same", list.inserted,
+           list.changed, list.deleted, list.unchanged);
+
+    // Deleted recipes cost one row each on top of what they cascade to
+    const size_t deltaRows = rowsOfDelta(next, list, false) + rowsOfDelta(base, list, true);
+
+    start = bench::nowNanos();
+    table.commit();
+    const uint64_t churnCommit = bench::nowNanos() - start;
+    printf("%-28s %10.1f ms\n", "1% churn commit", churnCommit / 1e6);
+
+    const size_t fullRows = rowsOf(next.data, next.length);
+    const DeltaTableStats stats = table.stats();
+    printf("%-28s %10zu full, %zu delta (%.2f%%)\n", "rows written", fullRows, deltaRows,
+           100.0 * static_cast<double>(deltaRows) / static_cast<double>(fullRows));
+    printf("%-28s %10.1f MB for %u ids\n", "table size", stats.slotBytes / 1e6, stats.records);
+
+    free(base.data);
+    free(next.data);
+    unlink(path);
+    return EXIT_SUCCESS;
+}
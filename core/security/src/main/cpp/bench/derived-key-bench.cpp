@@ -0,0 +1,172 @@
+/**
+ * Derived-key cache benchmark
+ *
+ * Usage: derived-key-bench [sessions]
+ *
+ * Per-request cost of signing a 256-byte request body:
+ * - uncached: no cache, HKDF from the master secret on every call and
+ *   then HMAC with the fresh subkey
+ * - miss:     the cache deriving from its keyed PRK (capacity 1, two
+ *   sessions alternating)
+ * - hit:      copying the cached keyed HMAC and finishing it
+ * - seal:     ChaCha20-Poly1305 of the same body under a cached subkey
+ *
+ * Then hit and miss ratios for a Zipf(1.0) mix of sessions, each using one
+ * of four purposes, across cache capacities.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "crypto/derived-key-cache.h"
+
+using namespace bakingapp::bench;
+using namespace bakingapp::crypto;
+
+namespace {
+    constexpr uint32_t ITERATIONS = 20000;
+    constexpr uint32_t MIX_REQUESTS = 200000;
+    constexpr uint32_t DEFAULT_SESSIONS = 500;
+    constexpr size_t BODY_BYTES = 256;
+
+    const char MASTER[] = "sk_bench_master_secret_0123456789";
+    const uint8_t SALT[] = {'b', 'k', '-', 'b', 'e', 'n', 'c', 'h'};
+    const char* const PURPOSES[] = {"request", "storage", "upload", "webhook"};
+
+    size_t readMaster(uint8_t* out, size_t capacity, void* /* context */) {
+        const size_t length = sizeof(MASTER) - 1;
+        if (length > capacity) return 0;
+        memcpy(out, MASTER, length);
+        return length;
+    }
+
+    size_t sessionId(uint32_t session, char* out, size_t capacity) {
+        return static_cast<size_t>(snprintf(out, capacity, "session-%08u", session));
+    }
+
+    double uncachedNanos(const uint8_t* body) {
+        uint8_t mac[SHA256_BYTES];
+        const uint64_t start = nowNanos();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            uint8_t master[MAX_MASTER_SECRET_LENGTH];
+            const size_t length = readMaster(master, sizeof(master), nullptr);
+            uint8_t prk[SHA256_BYTES];
+            hkdfExtract(SALT, sizeof(SALT), master, length, prk);
+            const char info[] = "request\0session-00000001";
+            uint8_t subkey[SUBKEY_BYTES];
+            hkdfExpand(prk, info, sizeof(info) - 1, subkey, sizeof(subkey));
+            hmacSha256(subkey, sizeof(subkey), body, BODY_BYTES, mac);
+            doNotOptimize(mac[0]);
+        }
+        return static_cast<double>(nowNanos() - start) / ITERATIONS;
+    }
+
+    double signNanos(DerivedKeyCache& cache, const uint8_t* body, uint32_t sessions) {
+        char ids[2][32];
+        size_t lengths[2];
+        for (uint32_t i = 0; i < 2; i++) lengths[i] = sessionId(i, ids[i], sizeof(ids[i]));
+        uint8_t mac[SHA256_BYTES];
+        const uint64_t start = nowNanos();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            const uint32_t s = i % sessions;
+            cache.sign("request", 7, ids[s], lengths[s], body, BODY_BYTES, mac);
+            doNotOptimize(mac[0]);
+        }
+        return static_cast<double>(nowNanos() - start) / ITERATIONS;
+    }
+
+    double sealNanos(DerivedKeyCache& cache, uint8_t* body) {
+        const uint8_t nonce[CHACHA20_NONCE_BYTES] = {};
+        uint8_t tag[POLY1305_TAG_BYTES];
+        const uint64_t start = nowNanos();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            cache.seal("storage", 7, "session-00000000", 16, nonce, nullptr, 0, body, BODY_BYTES,
+                       tag);
+            doNotOptimize(tag[0]);
+        }
+        return static_cast<double>(nowNanos() - start) / ITERATIONS;
+    }
+
+    /**
+     * Cumulative Zipf(1.0) weights over sessions, hottest first
+     */
+    double* zipfTable(uint32_t sessions) {
+        auto* cdf = static_cast<double*>(malloc(sizeof(double) * sessions));
+        double total = 0;
+        for (uint32_t i = 0; i < sessions; i++) {
+            total += 1.0 / (i + 1);
+            cdf[i] = total;
+        }
+        for (uint32_t i = 0; i < sessions; i++) cdf[i] /= total;
+        return cdf;
+    }
+
+    uint32_t sample(const double* cdf, uint32_t sessions, Random& random) {
+        const double u = static_cast<double>(random.next() >> 11) / 9007199254740992.0;
+        uint32_t low = 0, high = sessions - 1;
+        while (low < high) {
+            const uint32_t middle = (low + high) / 2;
+            if (cdf[middle] < u) low = middle + 1; else high = middle;
+        }
+        return low;
+    }
+
+    void runMix(uint32_t capacity, const double* cdf, uint32_t sessions, const uint8_t* body) {
+        DerivedKeyCache cache(readMaster, nullptr, SALT, sizeof(SALT), capacity);
+        Random random(42);
+        uint8_t mac[SHA256_BYTES];
+        char id[32];
+        const uint64_t start = nowNanos();
+        for (uint32_t i = 0; i < MIX_REQUESTS; i++) {
+            const uint32_t session = sample(cdf, sessions, random);
+            // Each session sticks to a main purpose, now and then another
+            const uint32_t purpose = random.below(8) == 0 ? random.below(4) : session % 4;
+            const size_t length = sessionId(session, id, sizeof(id));
+            cache.sign(PURPOSES[purpose], strlen(PURPOSES[purpose]), id, length, body,
+                       BODY_BYTES, mac);
+            doNotOptimize(mac[0]);
+        }
+        const double nanos = static_cast<double>(nowNanos() - start) / MIX_REQUESTS;
+        const DerivedKeyStats stats = cache.stats();
+        const double requests = static_cast<double>(stats.hits + stats.misses);
+        printf("%-10u %8.1f%% %8.1f%% %10llu %10.0f\n", capacity, 100.0 * stats.hits / requests,
+               100.0 * stats.misses / requests, static_cast<unsigned long long>(stats.evictions),
+               nanos);
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t sessions = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : DEFAULT_SESSIONS;
+    if (sessions < 2) {
+        fprintf(stderr, "need at least 2 sessions\n");
+        return EXIT_FAILURE;
+    }
+
+    uint8_t body[BODY_BYTES];
+    Random random(7);
+    for (uint8_t& byte : body) byte = static_cast<uint8_t>(random.next());
+
+    printHeader("per request (256-byte body)");
+    printf("%-10s %10s\n", "mode", "ns/op");
+    const double uncached = uncachedNanos(body);
+    printf("%-10s %10.0f\n", "uncached", uncached);
+    DerivedKeyCache thrashing(readMaster, nullptr, SALT, sizeof(SALT), 1);
+    printf("%-10s %10.0f\n", "miss", signNanos(thrashing, body, 2));
+    DerivedKeyCache cache(readMaster, nullptr, SALT, sizeof(SALT));
+    const double hit = signNanos(cache, body, 1);
+    printf("%-10s %10.0f  (%.1fx faster than uncached)\n", "hit", hit, uncached / hit);
+    printf("%-10s %10.0f\n", "seal", sealNanos(cache, body));
+
+    char title[64];
+    snprintf(title, sizeof(title), "Zipf mix, %u sessions x 4 purposes", sessions);
+    printHeader(title);
+    printf("%-10s %9s %9s %10s %10s\n", "capacity", "hits", "misses", "evictions", "ns/sign");
+    double* cdf = zipfTable(sessions);
+    const uint32_t capacities[] = {16, 64, 256, 1024};
+    for (const uint32_t capacity : capacities) runMix(capacity, cdf, sessions, body);
+    free(cdf);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+/**
+ * Thumbnail pipeline benchmark
+ *
+ * Usage: image-bench [folder-of-ppm-images]
+ *
+ * Resizes every binary PPM (P6) image in the folder to the list and detail
+ * cell sizes, stores the results in a scratch thumbnail cache and reports
+ * source megapixels per second plus the bytes saved versus holding the
+ * full-size RGBA bitmaps. Without a folder, synthetic 12 MP photos are used.
+ *
+ * Convert sample photos with e.g. `convert photo.jpg photo.ppm`.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+
+#include "bench/bench-util.h"
+#include "image/image-resize.h"
+#include "image/thumbnail-cache.h"
+#include "test/test-util.h"
+
+using namespace bakingapp;
+using namespace bakingapp::image;
+
+namespace {
+    struct Image {
+        uint8_t* rgba = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        char name[256] = {};
+    };
+
+    bool loadPpm(const char* path, Image* out) {
+        FILE* f = fopen(path, "rb");
+        if (f == nullptr) return false;
+        unsigned width = 0, height = 0, maxValue = 0;
+        bool ok = fscanf(f, "P6 %u %u %u", &width, &height, &maxValue) == 3 &&
+                  maxValue == 255 && width > 0 && height > 0;
+        if (ok) fgetc(f);  // single whitespace before the raster
+
+        const size_t pixels = static_cast<size_t>(width) * height;
+        auto* rgb = ok ? static_cast<uint8_t*>(malloc(pixels * 3)) : nullptr;
+        ok = rgb != nullptr && fread(rgb, 3, pixels, f) == pixels;
+        fclose(f);
+        if (!ok) {
+            free(rgb);
+            return false;
+        }
+
+        out->rgba = static_cast<uint8_t*>(malloc(pixels * 4));
+        for (size_t i = 0; i < pixels; i++) {
+            out->rgba[i * 4] = rgb[i * 3];
+            out->rgba[i * 4 + 1] = rgb[i * 3 + 1];
+            out->rgba[i * 4 + 2] = rgb[i * 3 + 2];
+            out->rgba[i * 4 + 3] = 255;
+        }
+        free(rgb);
+        out->width = width;
+        out->height = height;
+        return true;
+    }
+
+    void synthesize(Image* out, uint32_t width, uint32_t height, uint64_t seed) {
+        bench::Random random(seed);
+        out->rgba = static_cast<uint8_t*>(malloc(static_cast<size_t>(width) * height * 4));
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                uint8_t* p = out->rgba + (static_cast<size_t>(y) * width + x) * 4;
+                const uint32_t noise = random.below(32);
+                p[0] = static_cast<uint8_t>((x * 255 / width + noise) & 0xFF);
+                p[1] = static_cast<uint8_t>((y * 255 / height + noise) & 0xFF);
+                p[2] = static_cast<uint8_t>(((x ^ y) & 0x7F) + noise);
+                p[3] = 255;
+            }
+        }
+        out->width = width;
+        out->height = height;
+        snprintf(out->name, sizeof(out->name), "synthetic-%llu",
+                 static_cast<unsigned long long>(seed));
+    }
+
+    int loadFolder(const char* folder, Image* images, int maxImages) {
+        DIR* dir = opendir(folder);
+        if (dir == nullptr) return 0;
+        int count = 0;
+        while (dirent* entry = readdir(dir)) {
+            const size_t length = strlen(entry->d_name);
+            if (length < 5 || strcmp(entry->d_name + length - 4, ".ppm") != 0) continue;
+            if (count == maxImages) break;
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/%s", folder, entry->d_name);
+            if (loadPpm(path, &images[count])) {
+                snprintf(images[count].name, sizeof(images[count].name), "%s", entry->d_name);
+                count++;
+            }
+        }
+        closedir(dir);
+        return count;
+    }
+}
+
+int main(int argc, char** argv) {
+    constexpr int MAX_IMAGES = 64;
+    static Image images[MAX_IMAGES];
+
+    int count = argc > 1 ? loadFolder(argv[1], images, MAX_IMAGES) : 0;
+    if (count == 0) {
+        if (argc > 1) printf("No P6 .ppm images in %s, using synthetic photos\n", argv[1]);
+        count = 8;
+        for (int i = 0; i < count; i++) synthesize(&images[i], 4000, 3000, i + 1);
+    }
+
+    // Recipe card (360dp x 180dp at xxhdpi) and step thumbnail cells
+    const uint32_t cells[][2] = {{1080, 540}, {360, 240}, {144, 144}};
+
+    char cacheDir[256];
+    test::makeTempDir(cacheDir, sizeof(cacheDir), "image-bench");
+    ThumbnailCache cache;
+    if (!cache.open(cacheDir, 1024)) {
+        fprintf(stderr, "Failed to open cache in %s\n", cacheDir);
+        return EXIT_FAILURE;
+    }
+
+    bench::printHeader("Area-average resize + cache store");
+    printf("%-24s %10s %12s %10s\n", "cell", "images", "MP/s", "ms/image");
+
+    uint64_t sourceBytes = 0;
+    uint64_t thumbnailBytes = 0;
+    for (const auto& cell : cells) {
+        const uint32_t w = cell[0], h = cell[1];
+        auto* out = static_cast<uint8_t*>(malloc(static_cast<size_t>(w) * h * 4));
+        MutableImageView dst{out, w, h, w * 4u};
+
+        double megapixels = 0;
+        uint64_t elapsed = 0;
+        for (int i = 0; i < count; i++) {
+            const Image& img = images[i];
+            ImageView src{img.rgba, img.width, img.height, img.width * 4u};
+            Rect region = centerCropRect(img.width, img.height, w, h);
+
+            const uint64_t start = bench::nowNanos();
+            resizeAreaAverage(src, region, dst);
+            cache.store(ThumbnailCache::keyFor(img.name, strlen(img.name), w, h, true),
+                        ImageView{out, w, h, w * 4u});
+            elapsed += bench::nowNanos() - start;
+
+            megapixels += static_cast<double>(region.width) * region.height / 1e6;
+            sourceBytes += static_cast<uint64_t>(img.width) * img.height * 4;
+            thumbnailBytes += static_cast<uint64_t>(w) * h * 4;
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "%ux%u", w, h);
+        printf("%-24s %10d %12.1f %10.2f\n", label, count, megapixels / (elapsed / 1e9),
+               elapsed / 1e6 / count);
+        free(out);
+    }
+
+    bench::printHeader("Cache hits");
+    {
+        const uint32_t w = cells[1][0], h = cells[1][1];
+        auto* out = static_cast<uint8_t*>(malloc(static_cast<size_t>(w) * h * 4));
+        MutableImageView dst{out, w, h, w * 4u};
+        const uint64_t start = bench::nowNanos();
+        int hits = 0;
+        for (int round = 0; round < 20; round++) {
+            for (int i = 0; i < count; i++) {
+                hits += cache.read(ThumbnailCache::keyFor(images[i].name, strlen(images[i].name),
+                                                          w, h, true), dst) ? 1 : 0;
+            }
+        }
+        const uint64_t elapsed = bench::nowNanos() - start;
+        printf("%d hits, %.1f us/hit\n", hits, elapsed / 1e3 / (hits > 0 ? hits : 1));
+        free(out);
+    }
+
+    bench::printHeader("Memory");
+    printf("full-size RGBA bitmaps: %8.1f MB\n", sourceBytes / 1048576.0);
+    printf("cell-size thumbnails:   %8.1f MB\n", thumbnailBytes / 1048576.0);
+    printf("bytes saved:            %8.1f MB (%.1f%%)\n",
+           (sourceBytes - thumbnailBytes) / 1048576.0,
+           100.0 * (sourceBytes - thumbnailBytes) / sourceBytes);
+
+    for (int i = 0; i < count; i++) free(images[i].rgba);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/**
+ * Ingredient index benchmark
+ *
+ * Usage: ingredient-index-bench [recipes]
+ *
+ * Indexes synthetic recipes (1M by default) of 6 to 14 ingredients drawn
+ * from a 2000-name vocabulary with a Zipf-like skew: the corpus's baking
+ * staples are in most recipes, the long tail in a few. Reports build,
+ * snapshot save/load and size, then latency percentiles of "cook with"
+ * queries of 2, 3 and 5 ingredients, with and without an excluded one,
+ * for both the recipe list and the count. A scan over every recipe's
+ * ingredient list, as a join over the ingredients table does, is timed
+ * for comparison.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "bench/bench-util.h"
+#include "bench/recipe-corpus.h"
+#include "search/ingredient-index.h"
+
+using namespace bakingapp;
+using namespace bakingapp::bench::corpus;
+using bakingapp::search::IngredientIndex;
+
+namespace {
+    constexpr uint32_t VOCABULARY = 2000;
+    constexpr uint32_t MAX_PER_RECIPE = 14;
+    constexpr size_t QUERIES = 1000;
+    constexpr size_t SCAN_QUERIES = 20;
+    constexpr size_t LIMIT = 50;
+
+    struct Recipe {
+        uint16_t ingredients[MAX_PER_RECIPE];
+        uint8_t count;
+    };
+
+    void ingredientName(uint32_t rank, char* out, size_t size) {
+        if (rank < count(INGREDIENTS)) {
+            snprintf(out, size, "%s", INGREDIENTS[rank]);
+        } else {
+            snprintf(out, size, "pantry item %u", rank);
+        }
+    }
+
+    /**
+     * Log-uniform rank: rank r comes up about 1/r as often as rank 1
+     */
+    uint32_t skewedRank(bench::Random& random) {
+        const double u = static_cast<double>(random.next() >> 11) / 9007199254740992.0;
+        const auto rank = static_cast<uint32_t>(exp(u * log(VOCABULARY + 1.0))) - 1;
+        return rank < VOCABULARY ? rank : VOCABULARY - 1;
+    }
+
+    bool uses(const Recipe& recipe, uint32_t rank) {
+        for (uint32_t i = 0; i < recipe.count; i++) {
+            if (recipe.ingredients[i] == rank) return true;
+        }
+        return false;
+    }
+
+    size_t scan(const Recipe* recipes, uint32_t count, const uint32_t* include,
+                uint32_t includeCount, int32_t exclude) {
+        size_t matches = 0;
+        for (uint32_t r = 0; r < count; r++) {
+            bool match = exclude < 0 || !uses(recipes[r], static_cast<uint32_t>(exclude));
+            for (uint32_t i = 0; match && i < includeCount; i++) {
+                match = uses(recipes[r], include[i]);
+            }
+            matches += match;
+        }
+        return matches;
+    }
+
+    int compareU64(const void* a, const void* b) {
+        const uint64_t x = *static_cast<const uint64_t*>(a);
+        const uint64_t y = *static_cast<const uint64_t*>(b);
+        return x < y ? -1 : x > y;
+    }
+
+    void printLatency(const char* label, uint64_t* nanos, size_t n, double matches) {
+        qsort(nanos, n, sizeof(uint64_t), compareU64);
+        printf("%-26s %9.1f %9.1f %9.1f %10.0f\n", label, nanos[n / 2] / 1e3,
+               nanos[n * 99 / 100] / 1e3, nanos[n - 1] / 1e3, matches);
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t recipeCount = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 1000000;
+    bench::printHeader("Ingredient index (roaring bitmaps)");
+
+    auto* recipes = static_cast<Recipe*>(malloc(sizeof(Recipe) * recipeCount));
+    auto* nanos = static_cast<uint64_t*>(malloc(sizeof(uint64_t) * QUERIES));
+    auto* results = static_cast<uint32_t*>(malloc(sizeof(uint32_t) * LIMIT));
+    if (recipes == nullptr || nanos == nullptr || results == nullptr) return EXIT_FAILURE;
+    bench::Random random(42);
+
+    IngredientIndex index;
+    char id[32];
+    char text[1024];
+    char name[64];
+    uint64_t buildNanos = 0;
+    for (uint32_t r = 0; r < recipeCount; r++) {
+        Recipe& recipe = recipes[r];
+        recipe.count = 0;
+        const uint32_t wanted = 6 + random.below(MAX_PER_RECIPE - 5);
+        Writer ingredients {text, sizeof(text)};
+        while (recipe.count < wanted) {
+            const uint32_t rank = skewedRank(random);
+            if (uses(recipe, rank)) continue;
+            recipe.ingredients[recipe.count++] = static_cast<uint16_t>(rank);
+            ingredientName(rank, name, sizeof(name));
+            ingredients.append("%s\n", name);
+        }
+        snprintf(id, sizeof(id), "recipe-%07u", r + 1);
+        const uint64_t start = bench::nowNanos();
+        index.setRecipe(id, strlen(id), text, ingredients.length);
+        buildNanos += bench::nowNanos() - start;
+    }
+    const auto stats = index.stats();
+    printf("recipes:      %u\n", stats.recipes);
+    printf("ingredients:  %u\n", stats.ingredients);
+    printf("build:        %.1f ms (%.2f µs per recipe)\n", buildNanos / 1e6,
+           buildNanos / 1e3 / recipeCount);
+    printf("bitmaps:      %.1f MB (%.2f bytes per recipe-ingredient pair)\n",
+           stats.bitmapBytes / 1e6,
+           static_cast<double>(stats.bitmapBytes) / (recipeCount * (6 + MAX_PER_RECIPE) / 2.0));
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/ingredient-index-bench-%d.index",
+             static_cast<int>(getpid()));
+    uint64_t start = bench::nowNanos();
+    const bool saved = index.save(path);
+    const double saveMs = (bench::nowNanos() - start) / 1e6;
+    IngredientIndex loaded;
+    start = bench::nowNanos();
+    const bool restored = saved && loaded.load(path);
+    const double loadMs = (bench::nowNanos() - start) / 1e6;
+    FILE* file = fopen(path, "rb");
+    long fileBytes = 0;
+    if (file != nullptr) {
+        fseek(file, 0, SEEK_END);
+        fileBytes = ftell(file);
+        fclose(file);
+    }
+    unlink(path);
+    printf("snapshot:     %.1f MB, save %.1f ms, load %.1f ms%s\n\n", fileBytes / 1e6, saveMs,
+           loadMs, restored ? "" : " (FAILED)");
+
+    printf("%-26s %9s %9s %9s %10s\n", "query (µs)", "p50", "p99", "max", "avg found");
+    const uint32_t sizes[] = {2, 3, 5};
+    char include[512];
+    char exclude[64];
+    for (uint32_t size : sizes) {
+        for (int variant = 0; variant < 3; variant++) {
+            double found = 0;
+            for (size_t q = 0; q < QUERIES; q++) {
+                Writer w {include, sizeof(include)};
+                for (uint32_t i = 0; i < size; i++) {
+                    ingredientName(skewedRank(random), name, sizeof(name));
+                    w.append("%s\n", name);
+                }
+                size_t excludeLength = 0;
+                if (variant == 1) {
+                    ingredientName(skewedRank(random), exclude, sizeof(exclude));
+                    excludeLength = strlen(exclude);
+                }
+                start = bench::nowNanos();
+                if (variant < 2) {
+                    const size_t n = index.query(include, w.length, exclude, excludeLength,
+                                                 results, LIMIT);
+                    nanos[q] = bench::nowNanos() - start;
+                    bench::doNotOptimize(n);
+                    found += n;
+                } else {
+                    const uint64_t n = index.count(include, w.length, nullptr, 0);
+                    nanos[q] = bench::nowNanos() - start;
+                    found += static_cast<double>(n);
+                }
+            }
+            char label[48];
+            snprintf(label, sizeof(label), "%u ingredients%s", size,
+                     variant == 0 ? "" : variant == 1 ? ", 1 excluded" : ", count");
+            printLatency(label, nanos, QUERIES, found / QUERIES);
+        }
+    }
+
+    double scanned = 0;
+    for (size_t q = 0; q < SCAN_QUERIES; q++) {
+        uint32_t ranks[3];
+        for (uint32_t& rank : ranks) rank = skewedRank(random);
+        start = bench::nowNanos();
+        const size_t n = scan(recipes, recipeCount, ranks, 3, -1);
+        nanos[q] = bench::nowNanos() - start;
+        scanned += static_cast<double>(n);
+    }
+    printLatency("scan, 3 ingredients", nanos, SCAN_QUERIES, scanned / SCAN_QUERIES);
+
+    free(recipes);
+    free(nanos);
+    free(results);
+    return EXIT_SUCCESS;
+}
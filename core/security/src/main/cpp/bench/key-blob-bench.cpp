@@ -0,0 +1,115 @@
+/**
+ * Key blob benchmark: startup and lookup cost against the number of keys
+ *
+ * Usage: key-blob-bench [directory]
+ *
+ * For blobs of 16 to 65536 keys: the time to open the blob, to fetch the
+ * first key (binary search plus one decryption), to fetch it again from
+ * the cache, and, as the baseline, to decrypt every entry up front as a
+ * loader that unpacks all its keys at startup would.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "bench/bench-util.h"
+#include "keys/key-blob.h"
+
+using namespace bakingapp;
+using namespace bakingapp::keys;
+
+namespace {
+    constexpr size_t MAX_KEYS = 65536;
+    constexpr int ROUNDS = 20;
+
+    struct Names {
+        char names[MAX_KEYS][24];
+        char values[MAX_KEYS][40];
+        KeyDefinition definitions[MAX_KEYS];
+    };
+
+    void fill(Names& names) {
+        for (size_t i = 0; i < MAX_KEYS; i++) {
+            const int nameLength = snprintf(names.names[i], sizeof(names.names[i]),
+                                            "partner.%zu.api", i);
+            const int valueLength = snprintf(names.values[i], sizeof(names.values[i]),
+                                             "bk_partner_key_%zu_demo", i);
+            names.definitions[i] = {
+                std::string_view(names.names[i], static_cast<size_t>(nameLength)),
+                std::string_view(names.values[i], static_cast<size_t>(valueLength))};
+        }
+    }
+
+    bool writeFile(const char* path, const uint8_t* data, size_t size) {
+        FILE* file = fopen(path, "wb");
+        if (file == nullptr) return false;
+        const bool written = fwrite(data, 1, size, file) == size;
+        return fclose(file) == 0 && written;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* directory = argc > 1 ? argv[1] : "/tmp";
+    char path[512];
+    snprintf(path, sizeof(path), "%s/key-blob-bench.%d", directory, static_cast<int>(getpid()));
+
+    static Names names;
+    fill(names);
+    uint8_t key[BLOB_KEY_BYTES];
+    for (size_t i = 0; i < sizeof(key); i++) key[i] = static_cast<uint8_t>(i * 7 + 1);
+    const size_t capacity = keyBlobSize(names.definitions, MAX_KEYS);
+    auto* blob = static_cast<uint8_t*>(malloc(capacity));
+
+    bench::printHeader("Key blob: startup and lookup");
+    printf("%8s %10s %10s %12s %12s %14s\n", "keys", "bytes", "open us", "first us", "cached ns",
+           "decrypt all us");
+
+    for (size_t count = 16; count <= MAX_KEYS; count *= 4) {
+        const size_t size = encodeKeyBlob(names.definitions, count, key, blob, capacity);
+        if (size == 0 || !writeFile(path, blob, size)) {
+            fprintf(stderr, "failed to write %s\n", path);
+            return EXIT_FAILURE;
+        }
+        const std::string_view wanted = names.definitions[count / 2].name;
+        char value[MAX_BLOB_VALUE_LENGTH + 1];
+        size_t length = 0;
+        uint64_t openNanos = 0;
+        uint64_t firstNanos = 0;
+        uint64_t cachedNanos = 0;
+        uint64_t allNanos = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            KeyBlob keys;
+            uint64_t start = bench::nowNanos();
+            keys.open(path, key);
+            openNanos += bench::nowNanos() - start;
+
+            start = bench::nowNanos();
+            keys.get(wanted, value, sizeof(value), &length);
+            firstNanos += bench::nowNanos() - start;
+
+            start = bench::nowNanos();
+            for (int i = 0; i < 1000; i++) keys.get(wanted, value, sizeof(value), &length);
+            cachedNanos += bench::nowNanos() - start;
+            keys.close();
+
+            // A one-slot cache: every get decrypts its entry
+            KeyBlob eager(1);
+            start = bench::nowNanos();
+            eager.open(path, key);
+            for (size_t i = 0; i < count; i++) {
+                eager.get(names.definitions[i].name, value, sizeof(value), &length);
+            }
+            allNanos += bench::nowNanos() - start;
+        }
+        bench::doNotOptimize(length);
+        printf("%8zu %10zu %10.1f %12.1f %12.1f %14.1f\n", count, size,
+               openNanos / 1000.0 / ROUNDS, firstNanos / 1000.0 / ROUNDS,
+               cachedNanos / 1000.0 / ROUNDS, allNanos / 1000.0 / ROUNDS);
+    }
+
+    free(blob);
+    unlink(path);
+    return EXIT_SUCCESS;
+}
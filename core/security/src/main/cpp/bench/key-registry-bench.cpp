@@ -0,0 +1,102 @@
+/**
+ * Key registry benchmark: compile-time perfect hash vs std::unordered_map
+ *
+ * Looks up every key name in a shuffled stream, both for the slot only and
+ * for lookup plus decode into a stack buffer. The baseline stores the
+ * plaintext values in an std::unordered_map<std::string, std::string>.
+ */
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+#include "bench/bench-util.h"
+#include "keys/app-keys.h"
+
+using namespace bakingapp;
+using namespace bakingapp::keys;
+
+int main() {
+    const std::string_view names[] = {
+#define NAME_ENTRY(id, name, value) name,
+        BAKINGAPP_KEY_DEFINITIONS(NAME_ENTRY)
+#undef NAME_ENTRY
+    };
+
+    std::unordered_map<std::string, std::string> baseline;
+    char value[maxKeyLength() + 1];
+    for (size_t id = 0; id < APP_KEY_COUNT; id++) {
+        APP_KEYS.decode(APP_KEYS.find(id), value, sizeof(value));
+        baseline.emplace(std::string(names[id]), std::string(value));
+    }
+
+    constexpr size_t STREAM = 1 << 16;
+    constexpr int ROUNDS = 64;
+    static std::string_view stream[STREAM];
+    static std::string streamStrings[STREAM];
+    bench::Random random;
+    for (size_t i = 0; i < STREAM; i++) {
+        stream[i] = names[random.below(APP_KEY_COUNT)];
+        streamStrings[i] = std::string(stream[i]);
+    }
+    const double lookups = static_cast<double>(STREAM) * ROUNDS;
+
+    bench::printHeader("Key lookup");
+    printf("%zu keys, %zu encoded bytes, %zu buckets\n", APP_KEY_COUNT, APP_KEY_BYTES,
+           decltype(APP_KEYS)::BUCKETS);
+    printf("%-36s %10s\n", "variant", "ns/lookup");
+
+    uint64_t start = bench::nowNanos();
+    int64_t sink = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = 0; i < STREAM; i++) sink += findKey(stream[i]);
+    }
+    bench::doNotOptimize(sink);
+    printf("%-36s %10.2f\n", "perfect hash (name -> slot)", (bench::nowNanos() - start) / lookups);
+
+    start = bench::nowNanos();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = 0; i < STREAM; i++) {
+            auto it = baseline.find(streamStrings[i]);
+            sink += static_cast<int64_t>(it->second.size());
+        }
+    }
+    bench::doNotOptimize(sink);
+    printf("%-36s %10.2f\n", "unordered_map (name -> value)", (bench::nowNanos() - start) / lookups);
+
+    start = bench::nowNanos();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = 0; i < STREAM; i++) {
+            sink += static_cast<int64_t>(APP_KEYS.decode(findKey(stream[i]), value, sizeof(value)));
+        }
+    }
+    bench::doNotOptimize(sink);
+    printf("%-36s %10.2f\n", "perfect hash + decode", (bench::nowNanos() - start) / lookups);
+
+    start = bench::nowNanos();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = 0; i < STREAM; i++) {
+            auto it = baseline.find(streamStrings[i]);
+            it->second.copy(value, it->second.size());
+            sink += static_cast<int64_t>(it->second.size());
+        }
+    }
+    bench::doNotOptimize(sink);
+    printf("%-36s %10.2f\n", "unordered_map + copy", (bench::nowNanos() - start) / lookups);
+
+    start = bench::nowNanos();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = 0; i < STREAM; i++) {
+            sink += static_cast<int64_t>(APP_KEYS.decode(
+                findKey(static_cast<KeyId>(i % APP_KEY_COUNT)), value, sizeof(value)));
+        }
+    }
+    bench::doNotOptimize(sink);
+    printf("%-36s %10.2f\n", "numeric id + decode", (bench::nowNanos() - start) / lookups);
+
+    printf("\nruntime tables: perfect hash %zu bytes (static), unordered_map ~%zu bytes (heap)\n",
+           sizeof(APP_KEYS),
+           baseline.bucket_count() * sizeof(void*) +
+               baseline.size() * (sizeof(std::string) * 2 + 2 * sizeof(void*)));
+    return 0;
+}
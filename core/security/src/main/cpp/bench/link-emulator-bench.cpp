@@ -0,0 +1,163 @@
+/**
+ * Network link emulator benchmark
+ *
+ * Usage: link-emulator-bench [requests]
+ *
+ * 10k requests delayed by 100 ms each, all in flight at once:
+ * - emulator: one timer thread; reports transfer() cost, release lateness
+ *   against the planned deadline and the process CPU time while waiting
+ * - sleep:    the old Thread.sleep model on a 64-thread dispatcher, where
+ *   at most 64 requests can be delayed at a time (run on fewer requests
+ *   and reported as throughput)
+ * - shaping:  100 x 100 KB downloads through a 10 MB/s token bucket, which
+ *   should take about a second in total
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "bench/bench-util.h"
+#include "network/link-emulator.h"
+
+using namespace bakingapp;
+using namespace bakingapp::bench;
+using namespace bakingapp::network;
+
+namespace {
+    constexpr uint32_t DEFAULT_REQUESTS = 10000;
+    constexpr uint32_t LATENCY_MILLIS = 100;
+    constexpr int64_t NANOS_PER_MILLI = 1000 * 1000;
+    constexpr uint32_t DISPATCHER_THREADS = 64;
+    constexpr uint32_t SLEEP_ROUNDS = 5;
+
+    struct Releases {
+        int64_t* releasedAt;
+        uint64_t firstTicket;
+        std::atomic<uint32_t> count {0};
+    };
+
+    void recordRelease(uint64_t ticket, bool /* delivered */, void* context) {
+        auto* releases = static_cast<Releases*>(context);
+        releases->releasedAt[ticket - releases->firstTicket] = monotonicNanos();
+        releases->count.fetch_add(1, std::memory_order_release);
+    }
+
+    int64_t processCpuNanos() {
+        timespec ts {};
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    int compareI64(const void* a, const void* b) {
+        const int64_t x = *static_cast<const int64_t*>(a);
+        const int64_t y = *static_cast<const int64_t*>(b);
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+
+    void waitFor(const std::atomic<uint32_t>& count, uint32_t target) {
+        while (count.load(std::memory_order_acquire) < target) usleep(1000);
+    }
+
+    void benchEmulator(uint32_t requests) {
+        auto* submittedAt = static_cast<int64_t*>(malloc(requests * sizeof(int64_t)));
+        Releases releases;
+        releases.releasedAt = static_cast<int64_t*>(malloc(requests * sizeof(int64_t)));
+        releases.firstTicket = 1;
+
+        LinkEmulator emulator;
+        emulator.start(recordRelease, &releases);
+        LinkProfile profile;
+        profile.latencyMicros = LATENCY_MILLIS * 1000;
+        emulator.configure(profile);
+
+        const int64_t start = monotonicNanos();
+        for (uint32_t i = 0; i < requests; i++) {
+            submittedAt[i] = monotonicNanos();
+            emulator.transfer(LinkDirection::UP, 512);
+        }
+        const int64_t submitted = monotonicNanos();
+        const uint32_t peak = emulator.pending();
+        const int64_t cpuBefore = processCpuNanos();
+        waitFor(releases.count, requests);
+        const int64_t cpu = processCpuNanos() - cpuBefore;
+        const int64_t done = monotonicNanos();
+
+        for (uint32_t i = 0; i < requests; i++) {
+            submittedAt[i] = releases.releasedAt[i] - submittedAt[i] - LATENCY_MILLIS * NANOS_PER_MILLI;
+        }
+        qsort(submittedAt, requests, sizeof(int64_t), compareI64);
+        printf("%-10s %10.0f %10.3f %10.3f %10.3f %10.1f %10.0f %10u %8u\n", "emulator",
+               (submitted - start) / static_cast<double>(requests),
+               submittedAt[requests / 2] / 1e6, submittedAt[requests * 99 / 100] / 1e6,
+               submittedAt[requests - 1] / 1e6, cpu / 1e6,
+               requests / ((done - start) / 1e9), peak, 1u);
+        emulator.stop();
+        free(releases.releasedAt);
+        free(submittedAt);
+    }
+
+    void* sleepingDispatcher(void* /* argument */) {
+        for (uint32_t i = 0; i < SLEEP_ROUNDS; i++) {
+            timespec delay {0, LATENCY_MILLIS * NANOS_PER_MILLI};
+            nanosleep(&delay, nullptr);
+        }
+        return nullptr;
+    }
+
+    void benchSleep() {
+        pthread_t threads[DISPATCHER_THREADS];
+        const int64_t start = monotonicNanos();
+        for (pthread_t& thread : threads) pthread_create(&thread, nullptr, sleepingDispatcher, nullptr);
+        for (pthread_t& thread : threads) pthread_join(thread, nullptr);
+        const int64_t elapsed = monotonicNanos() - start;
+        printf("%-10s %10s %10s %10s %10s %10s %10.0f %10u %8u\n", "sleep", "-", "-", "-", "-",
+               "-", DISPATCHER_THREADS * SLEEP_ROUNDS / (elapsed / 1e9), DISPATCHER_THREADS,
+               DISPATCHER_THREADS);
+    }
+
+    void benchShaping() {
+        constexpr uint32_t DOWNLOADS = 100;
+        constexpr uint64_t BYTES = 100 * 1000;
+        int64_t releasedAt[DOWNLOADS];
+        Releases releases;
+        releases.releasedAt = releasedAt;
+        releases.firstTicket = 1;
+
+        LinkEmulator emulator;
+        emulator.start(recordRelease, &releases);
+        LinkProfile profile;
+        profile.bytesPerSecond = 10 * 1000 * 1000;
+        profile.burstBytes = 0;
+        emulator.configure(profile);
+
+        const int64_t start = monotonicNanos();
+        for (uint32_t i = 0; i < DOWNLOADS; i++) emulator.transfer(LinkDirection::DOWN, BYTES);
+        waitFor(releases.count, DOWNLOADS);
+        const double seconds = (releasedAt[DOWNLOADS - 1] - start) / 1e9;
+        printf("shaping: %u x %llu KB at 10 MB/s took %.3f s (%.2f MB/s)\n", DOWNLOADS,
+               static_cast<unsigned long long>(BYTES / 1000), seconds,
+               DOWNLOADS * BYTES / seconds / 1e6);
+        emulator.stop();
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t requests = DEFAULT_REQUESTS;
+    if (argc > 1) requests = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    if (requests == 0) requests = 1;
+
+    printHeader("network link emulator");
+    printf("%u requests, %u ms latency each\n", requests, LATENCY_MILLIS);
+    printf("%-10s %10s %10s %10s %10s %10s %10s %10s %8s\n", "mode", "submit ns", "late p50",
+           "late p99", "late max", "cpu ms", "req/s", "in flight", "threads");
+    benchEmulator(requests);
+    benchSleep();
+    benchShaping();
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * Library load benchmark
+ *
+ * Usage: load-bench [library.so ...]
+ *
+ * Host stand-in for System.loadLibrary: every trial forks a fresh process
+ * and dlopen()s the library with RTLD_NOW, recording the load time and the
+ * resident-memory growth. Defaults to the host build of the native core,
+ * which links without the C++ runtime; pass an older build to compare.
+ *
+ * The bench itself is linked --as-needed and uses no C++ runtime symbols,
+ * so a library that needs one pays for mapping it here, as on Android.
+ */
+
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+
+#ifndef NATIVE_CORE_LIBRARY
+#define NATIVE_CORE_LIBRARY "libnative-core-shared.so"
+#endif
+
+using namespace bakingapp::bench;
+
+namespace {
+    constexpr int TRIALS = 25;
+
+    struct Sample {
+        uint64_t nanos;
+        int64_t rssKb;
+        int32_t mappedObjects;
+        int32_t ok;
+    };
+
+    int64_t residentKb() {
+        FILE* status = fopen("/proc/self/status", "r");
+        if (status == nullptr) return -1;
+        char line[256];
+        int64_t kb = -1;
+        while (fgets(line, sizeof(line), status) != nullptr) {
+            if (strncmp(line, "VmRSS:", 6) == 0) {
+                kb = strtoll(line + 6, nullptr, 10);
+                break;
+            }
+        }
+        fclose(status);
+        return kb;
+    }
+
+    /**
+     * Counts distinct shared objects mapped into this process
+     */
+    int32_t mappedObjects() {
+        FILE* maps = fopen("/proc/self/maps", "r");
+        if (maps == nullptr) return -1;
+        char line[512];
+        char last[512] = "";
+        int32_t count = 0;
+        while (fgets(line, sizeof(line), maps) != nullptr) {
+            const char* path = strchr(line, '/');
+            if (path == nullptr || strstr(path, ".so") == nullptr) continue;
+            if (strcmp(path, last) != 0) {
+                count++;
+                snprintf(last, sizeof(last), "%s", path);
+            }
+        }
+        fclose(maps);
+        return count;
+    }
+
+    Sample loadOnce(const char* path) {
+        int fds[2];
+        Sample sample {};
+        if (pipe(fds) != 0) return sample;
+
+        const pid_t child = fork();
+        if (child == 0) {
+            close(fds[0]);
+            Sample result {};
+            const int64_t rssBefore = residentKb();
+            const int32_t objectsBefore = mappedObjects();
+            const uint64_t start = nowNanos();
+            void* handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+            result.nanos = nowNanos() - start;
+            result.rssKb = residentKb() - rssBefore;
+            result.mappedObjects = mappedObjects() - objectsBefore;
+            result.ok = handle != nullptr;
+            if (write(fds[1], &result, sizeof(result)) != sizeof(result)) _exit(1);
+            _exit(0);
+        }
+
+        close(fds[1]);
+        if (child > 0) {
+            if (read(fds[0], &sample, sizeof(sample)) != sizeof(sample)) sample.ok = 0;
+            waitpid(child, nullptr, 0);
+        }
+        close(fds[0]);
+        return sample;
+    }
+
+    int compareSamples(const void* a, const void* b) {
+        const uint64_t x = static_cast<const Sample*>(a)->nanos;
+        const uint64_t y = static_cast<const Sample*>(b)->nanos;
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+
+    void measure(const char* path) {
+        struct stat info {};
+        if (stat(path, &info) != 0) {
+            printf("%-40s missing\n", path);
+            return;
+        }
+
+        // Warm the page cache so the first trial is not an outlier
+        loadOnce(path);
+
+        Sample samples[TRIALS];
+        for (int i = 0; i < TRIALS; i++) {
+            samples[i] = loadOnce(path);
+            if (!samples[i].ok) {
+                void* handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+                printf("%-40s dlopen failed: %s\n", path, handle == nullptr ? dlerror() : "?");
+                return;
+            }
+        }
+        qsort(samples, TRIALS, sizeof(Sample), compareSamples);
+        const Sample& median = samples[TRIALS / 2];
+
+        const char* name = strrchr(path, '/');
+        printf("%-40s %10.1f %10.1f %10lld %8d\n", name != nullptr ? name + 1 : path,
+               static_cast<double>(info.st_size) / 1024.0, median.nanos / 1000.0,
+               static_cast<long long>(median.rssKb), median.mappedObjects);
+    }
+}
+
+int main(int argc, char** argv) {
+    printHeader("dlopen (median of 25 fresh processes)");
+    printf("%-40s %10s %10s %10s %8s\n", "library", "size KB", "load us", "RSS +KB", "+objects");
+    if (argc < 2) {
+        measure(NATIVE_CORE_LIBRARY);
+    } else {
+        for (int i = 1; i < argc; i++) measure(argv[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * Packed-key sort benchmark
+ *
+ * Usage: radix-sort-bench [max-count]
+ *
+ * Values are packed as NativeKeySorter packs them: a created-at time
+ * (milliseconds over one year) above the ordinal of its object. For 1k to
+ * 10M values (or max-count), ns per value, best of 3:
+ * - random, mostly sorted (1% of the values changed), sorted and reversed
+ *   input through sortValues() against std::sort and std::stable_sort.
+ *   The host has no JVM: std::stable_sort, a merge sort, stands in for
+ *   Collections.sort's TimSort, which also takes a run of sorted input in
+ *   one pass but compares boxed objects through a Comparator
+ * - the 100 smallest through the heap against std::partial_sort
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "sort/radix-sort.h"
+
+using namespace bakingapp;
+using namespace bakingapp::sort;
+
+namespace {
+    constexpr size_t DEFAULT_MAX_COUNT = 10000000;
+    constexpr int64_t YEAR_MILLIS = 365LL * 24 * 3600 * 1000;
+    constexpr size_t TOP_K = 100;
+    constexpr int RUNS = 3;
+
+    enum class Input { RANDOM, MOSTLY_SORTED, SORTED, REVERSED };
+    const char* const INPUT_NAMES[] = {"random", "mostly sorted", "sorted", "reversed"};
+
+    int ordinalBits(size_t count) {
+        int bits = 1;
+        while ((size_t{1} << bits) < count) bits++;
+        return bits;
+    }
+
+    void fill(int64_t* values, size_t count, Input input, bench::Random& random) {
+        const int bits = ordinalBits(count);
+        for (size_t i = 0; i < count; i++) {
+            int64_t key = static_cast<int64_t>(random.next() % YEAR_MILLIS);
+            if (input != Input::RANDOM) key = static_cast<int64_t>(i * (YEAR_MILLIS / count));
+            if (input == Input::REVERSED) key = YEAR_MILLIS - key;
+            values[i] = (key << bits) | static_cast<int64_t>(i);
+        }
+        if (input == Input::MOSTLY_SORTED) {
+            for (size_t changed = 0; changed < count / 100; changed++) {
+                const size_t i = random.below(static_cast<uint32_t>(count));
+                values[i] = (static_cast<int64_t>(random.next() % YEAR_MILLIS) << bits) |
+                            static_cast<int64_t>(i);
+            }
+        }
+    }
+
+    /**
+     * Best of RUNS, in ns per value, each run on a fresh copy of input
+     */
+    template <typename Sort>
+    double time(const int64_t* input, int64_t* values, size_t count, Sort sort) {
+        uint64_t best = UINT64_MAX;
+        for (int r = 0; r < RUNS; r++) {
+            memcpy(values, input, count * sizeof(int64_t));
+            const uint64_t start = bench::nowNanos();
+            sort(values);
+            const uint64_t elapsed = bench::nowNanos() - start;
+            if (elapsed < best) best = elapsed;
+        }
+        return static_cast<double>(best) / static_cast<double>(count);
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t maxCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : DEFAULT_MAX_COUNT;
+    auto* input = static_cast<int64_t*>(malloc(maxCount * sizeof(int64_t)));
+    auto* values = static_cast<int64_t*>(malloc(maxCount * sizeof(int64_t)));
+    auto* scratch = static_cast<int64_t*>(malloc(maxCount * sizeof(int64_t)));
+    int64_t top[TOP_K];
+    bench::Random random(42);
+
+    bench::printHeader("Packed-key sort (ns per value)");
+    printf("%-10s %-14s %10s %12s %10s %8s\n", "values", "input", "std::sort", "stable_sort",
+           "native", "speedup");
+    for (size_t count = 1000; count <= maxCount; count *= 10) {
+        for (int kind = 0; kind < 4; kind++) {
+            fill(input, count, static_cast<Input>(kind), random);
+            const double stdSort = time(input, values, count, [&](int64_t* v) {
+                std::sort(v, v + count);
+            });
+            const double stableSort = time(input, values, count, [&](int64_t* v) {
+                std::stable_sort(v, v + count);
+            });
+            SortPath path = SortPath::SORTED;
+            const double native = time(input, values, count, [&](int64_t* v) {
+                path = sortValues(v, count, scratch);
+            });
+            bench::doNotOptimize(values[count / 2]);
+            printf("%-10zu %-14s %10.2f %12.2f %10.2f %7.1fx  (path %d)\n", count,
+                   INPUT_NAMES[kind], stdSort, stableSort, native, stableSort / native,
+                   static_cast<int>(path));
+        }
+    }
+
+    bench::printHeader("Top 100 of random values (ns per value)");
+    printf("%-10s %14s %10s %8s\n", "values", "partial_sort", "heap", "speedup");
+    for (size_t count = 1000; count <= maxCount; count *= 10) {
+        fill(input, count, Input::RANDOM, random);
+        const double partial = time(input, values, count, [&](int64_t* v) {
+            std::partial_sort(v, v + TOP_K, v + count);
+        });
+        const double heap = time(input, values, count, [&](int64_t* v) {
+            smallestValues(v, count, TOP_K, top);
+        });
+        bench::doNotOptimize(top[0]);
+        printf("%-10zu %14.2f %10.2f %7.1fx\n", count, partial, heap, partial / heap);
+    }
+
+    free(scratch);
+    free(values);
+    free(input);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+/**
+ * Synthetic RecipeListResponse JSON for the cache benchmark and tests.
+ *
+ * Pages follow the shape of the API's recipe list (snake_case fields,
+ * nested ingredients and steps) with words drawn from small vocabularies,
+ * so the structure repeats across pages the way real payloads do while
+ * the values differ.
+ */
+
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+
+#include "bench/bench-util.h"
+
+namespace bakingapp::bench {
+
+namespace corpus {
+    constexpr const char* DISHES[] = {
+        "Lemon Drizzle Cake", "Sourdough Loaf", "Chocolate Chip Cookies", "Banana Bread",
+        "Apple Pie", "Cinnamon Rolls", "Carrot Cake", "Blueberry Muffins", "Focaccia",
+        "Brownies", "Croissants", "Cheesecake", "Pumpkin Bread", "Scones", "Baguette",
+    };
+    constexpr const char* INGREDIENTS[] = {
+        "all-purpose flour", "granulated sugar", "unsalted butter", "large eggs", "whole milk",
+        "baking powder", "baking soda", "vanilla extract", "sea salt", "brown sugar",
+        "heavy cream", "active dry yeast", "lemon zest", "ground cinnamon", "cocoa powder",
+    };
+    constexpr const char* UNITS[] = {"g", "ml", "cup", "tbsp", "tsp", "piece", "pinch"};
+    constexpr const char* CATEGORIES[] = {"cakes", "breads", "cookies", "pastries", "pies"};
+    constexpr const char* DIFFICULTIES[] = {"easy", "medium", "hard"};
+    constexpr const char* VERBS[] = {
+        "Preheat the oven and line the tin", "Whisk the dry ingredients together",
+        "Cream the butter and sugar until pale", "Fold in the flour gently",
+        "Knead the dough until smooth", "Leave to rise in a warm place",
+        "Bake until golden and a skewer comes out clean", "Cool on a wire rack",
+    };
+
+    template <typename T, size_t N>
+    constexpr size_t count(const T (&)[N]) { return N; }
+
+    struct Writer {
+        char* out;
+        size_t capacity;
+        size_t length = 0;
+
+        void append(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+            if (length >= capacity) return;
+            va_list args;
+            va_start(args, format);
+            const int n = vsnprintf(out + length, capacity - length, format, args);
+            va_end(args);
+            if (n > 0) length += static_cast<size_t>(n);
+        }
+    };
+}
+
+/**
+ * Writes one page of a recipe list into out.
+ *
+ * @return the JSON length, or capacity if the page did not fit
+ */
+inline size_t makeRecipeListJson(Random& random, uint32_t page, uint32_t pageSize,
+                                 char* out, size_t capacity) {
+    using namespace corpus;
+    Writer w {out, capacity};
+    w.append("{\"recipes\":[");
+    for (uint32_t r = 0; r < pageSize; r++) {
+        const uint32_t id = page * pageSize + r + 1;
+        w.append("%s{\"id\":\"recipe-%05u\",\"name\":\"%s\",", r == 0 ? "" : ",", id,
+                 DISHES[random.below(count(DISHES))]);
+        w.append("\"description\":\"A classic %s recipe with %s and %s.\",",
+                 CATEGORIES[random.below(count(CATEGORIES))],
+                 INGREDIENTS[random.below(count(INGREDIENTS))],
+                 INGREDIENTS[random.below(count(INGREDIENTS))]);
+        w.append("\"image_url\":\"https://cdn.bakingapp.example/images/recipe-%05u-%08x.jpg\",",
+                 id, static_cast<unsigned>(random.next()));
+        w.append("\"servings\":%u,\"prep_time_minutes\":%u,\"cook_time_minutes\":%u,",
+                 2 + random.below(10), 5 + random.below(40), 10 + random.below(80));
+        w.append("\"difficulty\":\"%s\",\"category\":\"%s\",\"ingredients\":[",
+                 DIFFICULTIES[random.below(count(DIFFICULTIES))],
+                 CATEGORIES[random.below(count(CATEGORIES))]);
+
+        const uint32_t ingredients = 4 + random.below(8);
+        for (uint32_t i = 0; i < ingredients; i++) {
+            w.append("%s{\"id\":\"ing-%05u-%02u\",\"name\":\"%s\",\"quantity\":%u.%u,"
+                     "\"unit\":\"%s\"}",
+                     i == 0 ? "" : ",", id, i, INGREDIENTS[random.below(count(INGREDIENTS))],
+                     1 + random.below(500), random.below(4) * 25,
+                     UNITS[random.below(count(UNITS))]);
+        }
+        w.append("],\"steps\":[");
+        const uint32_t steps = 3 + random.below(6);
+        for (uint32_t s = 0; s < steps; s++) {
+            w.append("%s{\"id\":\"step-%05u-%02u\",\"order\":%u,\"description\":\"%s.\","
+                     "\"video_url\":%s,\"thumbnail_url\":null}",
+                     s == 0 ? "" : ",", id, s, s + 1, VERBS[random.below(count(VERBS))],
+                     random.below(4) == 0 ? "\"https://cdn.bakingapp.example/video/step.mp4\""
+                                          : "null");
+        }
+        w.append("],\"created_at\":\"2024-%02u-%02uT%02u:%02u:00Z\",\"updated_at\":null}",
+                 1 + random.below(12), 1 + random.below(28), random.below(24),
+                 random.below(60));
+    }
+    w.append("],\"total_count\":%u,\"page\":%u,\"total_pages\":%u}", pageSize * 50, page + 1,
+             50u);
+    return w.length >= capacity ? capacity : w.length;
+}
+
+} // namespace bakingapp::bench
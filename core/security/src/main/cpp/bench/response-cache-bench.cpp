@@ -0,0 +1,136 @@
+/**
+ * Offline response cache benchmark
+ *
+ * Usage: response-cache-bench [pages]
+ *
+ * Generates synthetic RecipeListResponse pages (20 recipes each) and single
+ * recipe payloads, then reports the compression ratio without a dictionary,
+ * with the dictionary the cache trains from its first responses, and the
+ * decode throughput of ResponseCache::read().
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+#include "bench/bench-util.h"
+#include "bench/recipe-corpus.h"
+#include "cache/response-cache.h"
+#include "test/test-util.h"
+
+using namespace bakingapp;
+using namespace bakingapp::cache;
+
+namespace {
+    constexpr size_t MAX_PAGE_BYTES = 256 * 1024;
+
+    struct Corpus {
+        char** bodies = nullptr;
+        size_t* sizes = nullptr;
+        uint32_t count = 0;
+        uint64_t totalBytes = 0;
+
+        ~Corpus() {
+            for (uint32_t i = 0; i < count; i++) free(bodies[i]);
+            free(bodies);
+            free(sizes);
+        }
+    };
+
+    void generate(Corpus* corpus, uint32_t count, uint32_t pageSize, uint64_t seed) {
+        bench::Random random(seed);
+        corpus->bodies = static_cast<char**>(calloc(count, sizeof(char*)));
+        corpus->sizes = static_cast<size_t*>(calloc(count, sizeof(size_t)));
+        corpus->count = count;
+        for (uint32_t i = 0; i < count; i++) {
+            corpus->bodies[i] = static_cast<char*>(malloc(MAX_PAGE_BYTES));
+            corpus->sizes[i] = bench::makeRecipeListJson(random, i, pageSize, corpus->bodies[i],
+                                                         MAX_PAGE_BYTES);
+            corpus->totalBytes += corpus->sizes[i];
+        }
+    }
+
+    uint64_t plainDeflateBytes(const Corpus& corpus) {
+        uint64_t total = 0;
+        auto* out = static_cast<Bytef*>(malloc(compressBound(MAX_PAGE_BYTES)));
+        for (uint32_t i = 0; i < corpus.count; i++) {
+            uLongf length = compressBound(MAX_PAGE_BYTES);
+            compress2(out, &length, reinterpret_cast<const Bytef*>(corpus.bodies[i]),
+                      corpus.sizes[i], Z_BEST_COMPRESSION);
+            total += length;
+        }
+        free(out);
+        return total;
+    }
+
+    void run(const char* title, const Corpus& corpus) {
+        bench::printHeader(title);
+        printf("%u responses, %.1f KB average\n", corpus.count,
+               corpus.totalBytes / 1024.0 / corpus.count);
+        printf("deflate, no dictionary   ratio %.2fx\n",
+               static_cast<double>(corpus.totalBytes) / plainDeflateBytes(corpus));
+
+        char dir[256];
+        test::makeTempDir(dir, sizeof(dir), "response-bench");
+        ResponseCache cache;
+        if (!cache.open(dir)) {
+            fprintf(stderr, "cannot open cache in %s\n", dir);
+            return;
+        }
+
+        // First pass trains the dictionary; the timed pass starts clean and
+        // compresses everything with it.
+        for (uint32_t i = 0; i < corpus.count; i++) {
+            cache.put(ResponseCache::keyFor("warmup", 6) + i, corpus.bodies[i], corpus.sizes[i]);
+        }
+        cache.clear();
+
+        uint64_t start = bench::nowNanos();
+        for (uint32_t i = 0; i < corpus.count; i++) {
+            cache.put(i + 1, corpus.bodies[i], corpus.sizes[i]);
+        }
+        const double putSeconds = (bench::nowNanos() - start) / 1e9;
+        ResponseCacheStats stats = cache.stats();
+        printf("deflate + dictionary     ratio %.2fx (dictionary %s, %llu KB on disk)\n",
+               static_cast<double>(stats.rawBytes) / stats.compressedBytes,
+               stats.dictionaryId != 0 ? "trained" : "missing",
+               static_cast<unsigned long long>(stats.fileBytes / 1024));
+        printf("store                    %.1f MB/s\n", corpus.totalBytes / putSeconds / 1e6);
+
+        auto* buffer = static_cast<uint8_t*>(malloc(MAX_PAGE_BYTES));
+        const uint32_t rounds = 20;
+        start = bench::nowNanos();
+        for (uint32_t round = 0; round < rounds; round++) {
+            for (uint32_t i = 0; i < corpus.count; i++) {
+                if (!cache.read(i + 1, buffer, MAX_PAGE_BYTES)) {
+                    fprintf(stderr, "read %u failed\n", i);
+                    break;
+                }
+                bench::doNotOptimize(buffer[0]);
+            }
+        }
+        const double readSeconds = (bench::nowNanos() - start) / 1e9;
+        printf("decode                   %.1f MB/s, %.1f us per response\n",
+               corpus.totalBytes * rounds / readSeconds / 1e6,
+               readSeconds * 1e6 / (corpus.count * rounds));
+        free(buffer);
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t pages = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 64;
+    if (pages == 0) {
+        fprintf(stderr, "usage: %s [pages]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Corpus lists;
+    generate(&lists, pages, 20, 1);
+    run("Recipe list pages", lists);
+
+    Corpus details;
+    generate(&details, pages * 4, 1, 2);
+    run("Single recipe responses", details);
+    return EXIT_SUCCESS;
+}
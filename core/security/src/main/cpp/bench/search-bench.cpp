@@ -0,0 +1,156 @@
+/**
+ * Recipe search benchmark
+ *
+ * Usage: search-bench [recipes]
+ *
+ * Builds the BM25 index over synthetic recipes (name, description,
+ * ingredient names and step text; 100k by default) and reports build
+ * time, index size and query latency percentiles for one-word, multi-word
+ * and search-as-you-type queries. The LIKE scan over names and
+ * descriptions that RecipeDao.searchRecipes runs is timed for comparison.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "bench/recipe-corpus.h"
+#include "search/search-index.h"
+
+using namespace bakingapp;
+using namespace bakingapp::bench::corpus;
+using bakingapp::search::SearchHit;
+using bakingapp::search::SearchIndex;
+
+namespace {
+    constexpr size_t QUERIES = 2000;
+    constexpr size_t LIMIT = 50;
+    constexpr size_t FIELD_BYTES = 1024;
+
+    struct Recipe {
+        char id[32];
+        char text[search::SEARCH_FIELD_COUNT][FIELD_BYTES];
+        size_t lengths[search::SEARCH_FIELD_COUNT];
+    };
+
+    void makeRecipe(bench::Random& random, uint32_t number, Recipe* recipe) {
+        snprintf(recipe->id, sizeof(recipe->id), "recipe-%06u", number);
+        Writer fields[search::SEARCH_FIELD_COUNT] = {
+            {recipe->text[0], FIELD_BYTES}, {recipe->text[1], FIELD_BYTES},
+            {recipe->text[2], FIELD_BYTES}, {recipe->text[3], FIELD_BYTES},
+        };
+        fields[0].append("%s", DISHES[random.below(count(DISHES))]);
+        fields[1].append("A classic %s recipe with %s and %s.",
+                         CATEGORIES[random.below(count(CATEGORIES))],
+                         INGREDIENTS[random.below(count(INGREDIENTS))],
+                         INGREDIENTS[random.below(count(INGREDIENTS))]);
+        const uint32_t ingredients = 4 + random.below(8);
+        for (uint32_t i = 0; i < ingredients; i++) {
+            fields[2].append("%s\n", INGREDIENTS[random.below(count(INGREDIENTS))]);
+        }
+        const uint32_t steps = 3 + random.below(6);
+        for (uint32_t s = 0; s < steps; s++) {
+            fields[3].append("%s.\n", VERBS[random.below(count(VERBS))]);
+        }
+        for (size_t f = 0; f < search::SEARCH_FIELD_COUNT; f++) {
+            recipe->lengths[f] = fields[f].length;
+        }
+    }
+
+    int compareU64(const void* a, const void* b) {
+        const uint64_t x = *static_cast<const uint64_t*>(a);
+        const uint64_t y = *static_cast<const uint64_t*>(b);
+        return x < y ? -1 : x > y;
+    }
+
+    void printLatency(const char* label, uint64_t* nanos, size_t n) {
+        qsort(nanos, n, sizeof(uint64_t), compareU64);
+        printf("%-24s %10.1f %10.1f %10.1f\n", label, nanos[n / 2] / 1e3,
+               nanos[n * 99 / 100] / 1e3, nanos[n - 1] / 1e3);
+    }
+
+    /**
+     * LIKE '%query%' on name and description, case-insensitive for ASCII
+     * as SQLite's LIKE is
+     */
+    size_t likeScan(const Recipe* recipes, size_t count, const char* query) {
+        size_t matches = 0;
+        for (size_t r = 0; r < count; r++) {
+            for (size_t f = 0; f < 2; f++) {
+                if (strcasestr(recipes[r].text[f], query) != nullptr) {
+                    matches++;
+                    break;
+                }
+            }
+        }
+        return matches;
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t recipeCount = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 100000;
+    bench::printHeader("Recipe search (BM25 index)");
+
+    auto* recipes = static_cast<Recipe*>(malloc(sizeof(Recipe) * recipeCount));
+    auto* nanos = static_cast<uint64_t*>(malloc(sizeof(uint64_t) * QUERIES));
+    if (recipes == nullptr || nanos == nullptr) return EXIT_FAILURE;
+    bench::Random random(41);
+    for (uint32_t r = 0; r < recipeCount; r++) makeRecipe(random, r + 1, &recipes[r]);
+
+    SearchIndex index;
+    uint64_t start = bench::nowNanos();
+    for (uint32_t r = 0; r < recipeCount; r++) {
+        const char* fields[search::SEARCH_FIELD_COUNT];
+        for (size_t f = 0; f < search::SEARCH_FIELD_COUNT; f++) fields[f] = recipes[r].text[f];
+        index.add(recipes[r].id, strlen(recipes[r].id), fields, recipes[r].lengths);
+    }
+    const double buildMs = (bench::nowNanos() - start) / 1e6;
+    const auto stats = index.stats();
+    printf("recipes:     %u\n", stats.documents);
+    printf("build:       %.1f ms (%.2f µs per recipe)\n", buildMs, buildMs * 1e3 / recipeCount);
+    printf("index:       %u terms, %.1f MB postings\n\n", stats.terms, stats.postingBytes / 1e6);
+
+    printf("%-24s %10s %10s %10s\n", "query (µs)", "p50", "p99", "max");
+    SearchHit hits[LIMIT];
+    char query[128];
+    const char* kinds[] = {"one word", "two words", "as you type"};
+    for (size_t kind = 0; kind < 3; kind++) {
+        for (size_t q = 0; q < QUERIES; q++) {
+            const char* a = INGREDIENTS[random.below(count(INGREDIENTS))];
+            const char* b = DISHES[random.below(count(DISHES))];
+            size_t length = 0;
+            if (kind == 0) {
+                // The dish's first word only
+                snprintf(query, sizeof(query), "%s", b);
+                length = strcspn(query, " ");
+            } else if (kind == 1) {
+                length = static_cast<size_t>(snprintf(query, sizeof(query), "%s %s", b, a));
+            } else {
+                // A prefix of a word, 3 to 6 characters long
+                snprintf(query, sizeof(query), "%s", a);
+                const size_t word = strcspn(query, " ");
+                length = word < 3 ? word : 3 + random.below(word - 2 < 4 ? word - 2 : 4);
+            }
+            start = bench::nowNanos();
+            const size_t found = index.search(query, length, kind == 2, hits, LIMIT);
+            nanos[q] = bench::nowNanos() - start;
+            bench::doNotOptimize(found);
+        }
+        printLatency(kinds[kind], nanos, QUERIES);
+    }
+
+    const size_t likeQueries = QUERIES / 20;
+    for (size_t q = 0; q < likeQueries; q++) {
+        const char* dish = DISHES[random.below(count(DISHES))];
+        snprintf(query, sizeof(query), "%.*s", static_cast<int>(strcspn(dish, " ")), dish);
+        start = bench::nowNanos();
+        bench::doNotOptimize(likeScan(recipes, recipeCount, query));
+        nanos[q] = bench::nowNanos() - start;
+    }
+    printLatency("LIKE scan, one word", nanos, likeQueries);
+
+    free(recipes);
+    free(nanos);
+    return EXIT_SUCCESS;
+}
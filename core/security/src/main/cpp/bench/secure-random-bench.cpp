@@ -0,0 +1,160 @@
+/**
+ * Secure random benchmark
+ *
+ * Usage: secure-random-bench [threads]
+ *
+ * First the key stream itself: one scalar chacha20Block() at a time
+ * against chacha20Blocks(), four at a time in SIMD lanes.
+ *
+ * Then throughput per request size, 1 thread and N (4 by default) at
+ * once, from three sources:
+ * - getrandom: the kernel on every call, what the seal path used to do
+ * - locked:    the native generator behind one process-wide lock, as a
+ *   shared JVM SecureRandom is
+ * - per-thread: randomBytes(), each thread with its own generator
+ *
+ * With fewer cores than threads the N-thread rows include preemption.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+
+#include "bench/bench-util.h"
+#include "common/mutex.h"
+#include "crypto/chacha20-poly1305.h"
+#include "crypto/secure-random.h"
+
+using namespace bakingapp;
+using namespace bakingapp::bench;
+using namespace bakingapp::crypto;
+
+namespace {
+    constexpr size_t SIZES[] = {12, 16, 32, 256, 4096, 1 << 20};
+    constexpr size_t BYTES_PER_RUN = 8 << 20;     // per thread and row
+
+    Mutex sharedLock;
+
+    bool lockedRandom(uint8_t* out, size_t length) {
+        LockGuard lock(sharedLock);
+        return randomBytes(out, length);
+    }
+
+    struct Source {
+        const char* name;
+        bool (*fill)(uint8_t*, size_t);
+    };
+
+    const Source SOURCES[] = {
+        {"getrandom", systemRandom},
+        {"locked", lockedRandom},
+        {"per-thread", randomBytes},
+    };
+
+    struct Worker {
+        pthread_barrier_t* start;
+        const Source* source;
+        size_t size;
+        size_t calls;
+        uint64_t nanos;
+        bool failed;
+    };
+
+    void* runWorker(void* argument) {
+        auto* worker = static_cast<Worker*>(argument);
+        auto* out = static_cast<uint8_t*>(malloc(worker->size));
+        pthread_barrier_wait(worker->start);
+        const uint64_t begin = nowNanos();
+        for (size_t i = 0; i < worker->calls; i++) {
+            worker->failed |= !worker->source->fill(out, worker->size);
+            doNotOptimize(out[0]);
+        }
+        worker->nanos = nowNanos() - begin;
+        free(out);
+        return nullptr;
+    }
+
+    /**
+     * @return aggregate MB/s of threads filling size-byte requests
+     */
+    double throughput(const Source& source, size_t size, uint32_t threads, double* nanosPerCall) {
+        pthread_barrier_t start;
+        pthread_barrier_init(&start, nullptr, threads);
+        auto* handles = static_cast<pthread_t*>(malloc(sizeof(pthread_t) * threads));
+        auto* workers = static_cast<Worker*>(malloc(sizeof(Worker) * threads));
+        // The kernel is slow enough that small requests get fewer calls
+        const size_t budget = source.fill == systemRandom ? BYTES_PER_RUN / 8 : BYTES_PER_RUN;
+        const size_t calls = budget / size > 0 ? budget / size : 1;
+        for (uint32_t t = 0; t < threads; t++) {
+            workers[t] = {&start, &source, size, calls, 0, false};
+            pthread_create(&handles[t], nullptr, runWorker, &workers[t]);
+        }
+        uint64_t slowest = 0;
+        uint64_t total = 0;
+        for (uint32_t t = 0; t < threads; t++) {
+            pthread_join(handles[t], nullptr);
+            if (workers[t].failed) fprintf(stderr, "%s failed\n", source.name);
+            slowest = workers[t].nanos > slowest ? workers[t].nanos : slowest;
+            total += workers[t].nanos;
+        }
+        pthread_barrier_destroy(&start);
+        free(handles);
+        free(workers);
+        *nanosPerCall = static_cast<double>(total) / (static_cast<double>(calls) * threads);
+        return static_cast<double>(calls * size * threads) / (slowest / 1e9) / 1e6;
+    }
+
+    void keyStream() {
+        constexpr size_t BLOCKS = 1 << 16;      // 4 MiB
+        const uint8_t key[CHACHA20_KEY_BYTES] = {1};
+        const uint8_t nonce[CHACHA20_NONCE_BYTES] = {};
+        auto* out = static_cast<uint8_t*>(malloc(BLOCKS * CHACHA20_BLOCK_BYTES));
+
+        uint64_t start = nowNanos();
+        for (uint32_t b = 0; b < BLOCKS; b++) {
+            chacha20Block(key, b, nonce, out + b * CHACHA20_BLOCK_BYTES);
+        }
+        const uint64_t scalar = nowNanos() - start;
+        doNotOptimize(out[0]);
+
+        start = nowNanos();
+        chacha20Blocks(key, 0, nonce, out, BLOCKS);
+        const uint64_t lanes = nowNanos() - start;
+        doNotOptimize(out[0]);
+
+        const double bytes = static_cast<double>(BLOCKS * CHACHA20_BLOCK_BYTES);
+        printf("key stream, one block:    %8.1f MB/s\n", bytes / (scalar / 1e9) / 1e6);
+        printf("key stream, four lanes:   %8.1f MB/s (%.2fx)\n\n", bytes / (lanes / 1e9) / 1e6,
+               static_cast<double>(scalar) / lanes);
+        free(out);
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t threads = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 4;
+    printHeader("Secure random (per-thread ChaCha20)");
+    if (!randomSelfTest()) {
+        fprintf(stderr, "self-test failed\n");
+        return EXIT_FAILURE;
+    }
+    keyStream();
+
+    printf("%-12s %9s %12s %12s %12s %12s\n", "source", "bytes", "1 thr MB/s", "ns/call",
+           "N thr MB/s", "ns/call");
+    for (size_t size : SIZES) {
+        for (const Source& source : SOURCES) {
+            double single = 0;
+            double parallel = 0;
+            const double one = throughput(source, size, 1, &single);
+            const double many = throughput(source, size, threads, &parallel);
+            printf("%-12s %9zu %12.1f %12.1f %12.1f %12.1f\n", source.name, size, one, single,
+                   many, parallel);
+        }
+    }
+
+    const RandomStats stats = randomStats();
+    printf("\nN = %u; generated %.1f MB with %llu reseeds\n", threads,
+           stats.generatedBytes / 1e6, static_cast<unsigned long long>(stats.reseeds));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/**
+ * Secure store benchmark: writes per login
+ *
+ * Usage: secure-store-bench [directory] [logins]
+ *
+ * A login stores six values (access and refresh token, expiry, user ID,
+ * email and name). Per login, for each way of writing them: the writes
+ * that reach storage (each a write plus fsync/fdatasync), the bytes
+ * written and the time taken:
+ * - preferences: what six EncryptedSharedPreferences apply() calls cost.
+ *   Each one encrypts its value and rewrites the whole file through a
+ *   synced temporary file and rename, as SharedPreferences does
+ * - one transaction per put, the same six calls on the store
+ * - saveTokens and saveUserInfo, one transaction each
+ * - a single login transaction
+ * - 8 threads logging in at once, their transactions group-committed
+ *
+ * The directory should be on the storage to measure: on tmpfs, fsync is
+ * free and only the write counts mean anything.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "bench/bench-util.h"
+#include "common/mapped-file.h"
+#include "crypto/chacha20-poly1305.h"
+#include "crypto/secure-random.h"
+#include "store/secure-store.h"
+
+using namespace bakingapp;
+using namespace bakingapp::store;
+
+namespace {
+    constexpr int DEFAULT_LOGINS = 200;
+    constexpr int THREADS = 8;
+    constexpr size_t VALUES = 6;
+
+    // JWTs of a typical size, then the expiry and user fields
+    const char* const NAMES[VALUES] = {"access_token", "refresh_token", "token_expiry",
+                                       "user_id", "user_email", "user_name"};
+    constexpr size_t LENGTHS[VALUES] = {900, 700, 13, 8, 24, 16};
+
+    struct Login {
+        char values[VALUES][1024];
+    };
+
+    void fillLogin(Login& login, int round) {
+        for (size_t i = 0; i < VALUES; i++) {
+            memset(login.values[i], 'a' + static_cast<char>((round + i) % 26), LENGTHS[i]);
+        }
+    }
+
+    struct Result {
+        double writes;
+        double bytes;
+        double micros;
+    };
+
+    void print(const char* name, const Result& result, double baselineWrites) {
+        printf("%-32s %10.2f %12.0f %12.1f %9.1fx\n", name, result.writes, result.bytes,
+               result.micros, baselineWrites / result.writes);
+    }
+
+    /**
+     * Six apply() calls: each seals its value and rewrites the whole file
+     * holding all six
+     */
+    Result preferences(const char* path, int logins) {
+        uint8_t key[crypto::CHACHA20_KEY_BYTES] = {};
+        uint8_t file[VALUES * (1024 + 64)];
+        size_t sizes[VALUES] = {};
+        uint64_t bytes = 0;
+        Login login {};
+        const uint64_t start = bench::nowNanos();
+        for (int round = 0; round < logins; round++) {
+            fillLogin(login, round);
+            for (size_t i = 0; i < VALUES; i++) {
+                sizes[i] = crypto::CHACHA20_NONCE_BYTES + LENGTHS[i] + crypto::POLY1305_TAG_BYTES;
+                size_t offset = 0;
+                for (size_t j = 0; j < i; j++) offset += sizes[j];
+                uint8_t* sealed = file + offset;
+                crypto::randomBytes(sealed, crypto::CHACHA20_NONCE_BYTES);
+                memcpy(sealed + crypto::CHACHA20_NONCE_BYTES, login.values[i], LENGTHS[i]);
+                crypto::aeadSeal(key, sealed, nullptr, 0, sealed + crypto::CHACHA20_NONCE_BYTES,
+                                 LENGTHS[i], sealed + crypto::CHACHA20_NONCE_BYTES + LENGTHS[i]);
+                size_t total = 0;
+                for (size_t j = 0; j < VALUES; j++) total += sizes[j];
+                writeFileAtomically(path, file, total);
+                bytes += total;
+            }
+        }
+        const uint64_t elapsed = bench::nowNanos() - start;
+        return {static_cast<double>(VALUES), static_cast<double>(bytes) / logins,
+                static_cast<double>(elapsed) / 1000.0 / logins};
+    }
+
+    /**
+     * One login through the store, its values split into transactions of
+     * perTransaction puts
+     */
+    bool storeLogin(SecureStore& store, const Login& login, size_t perTransaction) {
+        StoreTransaction transaction;
+        for (size_t i = 0; i < VALUES; i++) {
+            transaction.put(NAMES[i], strlen(NAMES[i]), login.values[i], LENGTHS[i]);
+            if ((i + 1) % perTransaction == 0 || i + 1 == VALUES) {
+                if (!store.commit(transaction)) return false;
+                transaction.begin();
+            }
+        }
+        return true;
+    }
+
+    Result timeStore(const char* path, const uint8_t* key, int logins, size_t perTransaction) {
+        unlink(path);
+        SecureStore store;
+        store.open(path, key);
+        Login login {};
+        uint64_t written = 0;
+        uint64_t previousEnd = store.stats().usedBytes;
+        const uint64_t start = bench::nowNanos();
+        for (int round = 0; round < logins; round++) {
+            fillLogin(login, round);
+            storeLogin(store, login, perTransaction);
+            // Compaction shrinks the log: count only what each login appended
+            const uint64_t end = store.stats().usedBytes;
+            if (end > previousEnd) written += end - previousEnd;
+            previousEnd = end;
+        }
+        const uint64_t elapsed = bench::nowNanos() - start;
+        const StoreStats stats = store.stats();
+        return {static_cast<double>(stats.flushes) / logins,
+                static_cast<double>(written) / logins,
+                static_cast<double>(elapsed) / 1000.0 / logins};
+    }
+
+    struct Worker {
+        SecureStore* store;
+        int logins;
+        int seed;
+    };
+
+    void* loginMany(void* argument) {
+        auto* worker = static_cast<Worker*>(argument);
+        Login login {};
+        for (int round = 0; round < worker->logins; round++) {
+            fillLogin(login, worker->seed + round);
+            storeLogin(*worker->store, login, VALUES);
+        }
+        return nullptr;
+    }
+
+    Result timeConcurrent(const char* path, const uint8_t* key, int logins) {
+        unlink(path);
+        SecureStore store;
+        store.open(path, key);
+        pthread_t threads[THREADS];
+        Worker workers[THREADS];
+        const uint64_t start = bench::nowNanos();
+        for (int t = 0; t < THREADS; t++) {
+            workers[t] = {&store, logins / THREADS, t * 1000};
+            pthread_create(&threads[t], nullptr, loginMany, &workers[t]);
+        }
+        for (int t = 0; t < THREADS; t++) pthread_join(threads[t], nullptr);
+        const uint64_t elapsed = bench::nowNanos() - start;
+        const StoreStats stats = store.stats();
+        const double total = static_cast<double>(stats.transactions);
+        // Bytes as for one transaction a login: grouping does not change them
+        return {static_cast<double>(stats.flushes) / total, 0.0,
+                static_cast<double>(elapsed) / 1000.0 / total};
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* directory = argc > 1 ? argv[1] : "/tmp";
+    const int logins = argc > 2 ? atoi(argv[2]) : DEFAULT_LOGINS;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/secure-store-bench.%d", directory, static_cast<int>(getpid()));
+    uint8_t key[STORE_KEY_BYTES];
+    crypto::randomBytes(key, sizeof(key));
+
+    bench::printHeader("Secure store: writes per login");
+    printf("%d logins in %s\n", logins, directory);
+    printf("%-32s %10s %12s %12s %10s\n", "", "writes", "bytes", "us", "fewer");
+
+    const Result baseline = preferences(path, logins);
+    print("preferences (6 x apply)", baseline, baseline.writes);
+    unlink(path);
+    print("store, 6 transactions", timeStore(path, key, logins, 1), baseline.writes);
+    print("store, tokens + user info", timeStore(path, key, logins, 3), baseline.writes);
+    const Result single = timeStore(path, key, logins, VALUES);
+    print("store, 1 transaction", single, baseline.writes);
+    Result concurrent = timeConcurrent(path, key, logins);
+    concurrent.bytes = single.bytes;
+    print("store, 8 threads grouped", concurrent, baseline.writes);
+
+    unlink(path);
+    return EXIT_SUCCESS;
+}
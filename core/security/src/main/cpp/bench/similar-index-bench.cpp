@@ -0,0 +1,226 @@
+/**
+ * Similar-recipe index benchmark
+ *
+ * Usage: similar-index-bench [recipes]
+ *
+ * Indexes synthetic recipes (100k by default) derived from shared bases:
+ * each base draws 8 to 14 ingredients from a 2000-name vocabulary with a
+ * Zipf-like skew, and each recipe swaps, drops or adds up to four of its
+ * base's, so recipes have close relatives as well as the staples every
+ * recipe shares. Reports build cost and size, then latency percentiles
+ * of top-10 lookups and their recall against exact Jaccard similarity:
+ * of the true neighbours at or above a threshold (as many as fit in the
+ * top 10), the share found. The exact scan over every recipe is timed
+ * for comparison.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "bench/recipe-corpus.h"
+#include "search/similar-index.h"
+
+using namespace bakingapp;
+using namespace bakingapp::bench::corpus;
+using namespace bakingapp::search;
+
+namespace {
+    constexpr uint32_t VOCABULARY = 2000;
+    constexpr uint32_t MAX_PER_RECIPE = 18;
+    constexpr uint32_t RECIPES_PER_BASE = 8;
+    constexpr size_t QUERIES = 1000;
+    constexpr size_t RECALL_QUERIES = 200;
+    constexpr size_t TOP = 10;
+    constexpr double THRESHOLDS[] = {0.5, 0.7, 0.8};
+
+    struct Recipe {
+        uint16_t ingredients[MAX_PER_RECIPE];   // ascending
+        uint8_t count;
+    };
+
+    void ingredientName(uint32_t rank, char* out, size_t size) {
+        if (rank < count(INGREDIENTS)) {
+            snprintf(out, size, "%s", INGREDIENTS[rank]);
+        } else {
+            snprintf(out, size, "pantry item %u", rank);
+        }
+    }
+
+    /**
+     * Log-uniform rank: rank r comes up about 1/r as often as rank 1
+     */
+    uint32_t skewedRank(bench::Random& random) {
+        const double u = static_cast<double>(random.next() >> 11) / 9007199254740992.0;
+        const auto rank = static_cast<uint32_t>(exp(u * log(VOCABULARY + 1.0))) - 1;
+        return rank < VOCABULARY ? rank : VOCABULARY - 1;
+    }
+
+    bool add(Recipe& recipe, uint32_t rank) {
+        if (recipe.count == MAX_PER_RECIPE) return false;
+        for (uint32_t i = 0; i < recipe.count; i++) {
+            if (recipe.ingredients[i] == rank) return false;
+        }
+        recipe.ingredients[recipe.count++] = static_cast<uint16_t>(rank);
+        return true;
+    }
+
+    double jaccard(const Recipe& a, const Recipe& b) {
+        uint32_t i = 0;
+        uint32_t j = 0;
+        uint32_t shared = 0;
+        while (i < a.count && j < b.count) {
+            if (a.ingredients[i] == b.ingredients[j]) {
+                shared++;
+                i++;
+                j++;
+            } else if (a.ingredients[i] < b.ingredients[j]) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+        return static_cast<double>(shared) / (a.count + b.count - shared);
+    }
+
+    int compareU64(const void* a, const void* b) {
+        const uint64_t x = *static_cast<const uint64_t*>(a);
+        const uint64_t y = *static_cast<const uint64_t*>(b);
+        return x < y ? -1 : x > y;
+    }
+
+    void printLatency(const char* label, uint64_t* nanos, size_t n, double found) {
+        qsort(nanos, n, sizeof(uint64_t), compareU64);
+        printf("%-26s %9.1f %9.1f %9.1f %10.1f\n", label, nanos[n / 2] / 1e3,
+               nanos[n * 99 / 100] / 1e3, nanos[n - 1] / 1e3, found);
+    }
+
+    uint32_t recipeIndex(const SimilarIndex& index, uint32_t recipe) {
+        size_t length = 0;
+        const char* id = index.recipeId(recipe, &length);
+        return static_cast<uint32_t>(atoi(id + 7)) - 1;      // "recipe-%07u"
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t recipeCount = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 100000;
+    bench::printHeader("Similar recipes (MinHash/LSH)");
+
+    auto* recipes = static_cast<Recipe*>(calloc(recipeCount, sizeof(Recipe)));
+    auto* nanos = static_cast<uint64_t*>(malloc(sizeof(uint64_t) * QUERIES));
+    auto* similarity = static_cast<double*>(malloc(sizeof(double) * recipeCount));
+    if (recipes == nullptr || nanos == nullptr || similarity == nullptr) return EXIT_FAILURE;
+    bench::Random random(42);
+
+    SimilarIndex index;
+    char text[MAX_PER_RECIPE * 32];
+    char id[32];
+    uint64_t buildNanos = 0;
+    Recipe base {};
+    for (uint32_t r = 0; r < recipeCount; r++) {
+        if (r % RECIPES_PER_BASE == 0) {
+            base.count = 0;
+            const uint32_t size = 8 + random.below(7);
+            while (base.count < size) add(base, skewedRank(random));
+        }
+        Recipe& recipe = recipes[r];
+        recipe = base;
+        for (uint32_t m = random.below(5); m > 0; m--) {
+            const uint32_t at = random.below(recipe.count);
+            switch (random.below(3)) {
+                case 0:     // swap
+                    recipe.ingredients[at] = recipe.ingredients[--recipe.count];
+                    add(recipe, skewedRank(random));
+                    break;
+                case 1:     // drop
+                    if (recipe.count > 4) {
+                        recipe.ingredients[at] = recipe.ingredients[--recipe.count];
+                    }
+                    break;
+                default:
+                    add(recipe, skewedRank(random));
+                    break;
+            }
+        }
+        std::sort(recipe.ingredients, recipe.ingredients + recipe.count);
+
+        size_t length = 0;
+        for (uint32_t i = 0; i < recipe.count; i++) {
+            ingredientName(recipe.ingredients[i], text + length, sizeof(text) - length);
+            length += strlen(text + length);
+            text[length++] = '\n';
+        }
+        snprintf(id, sizeof(id), "recipe-%07u", r + 1);
+        const uint64_t start = bench::nowNanos();
+        index.setRecipe(id, strlen(id), text, length);
+        buildNanos += bench::nowNanos() - start;
+    }
+    const SimilarStats stats = index.stats();
+    printf("recipes:      %u\n", stats.recipes);
+    printf("build:        %.1f ms (%.2f µs per recipe, normalizing included)\n",
+           buildNanos / 1e6, buildNanos / 1e3 / recipeCount);
+    printf("buckets:      %u over %u bands (%u entries)\n", stats.buckets, BANDS, stats.entries);
+    printf("memory:       %.1f MB\n\n", stats.bytes / 1e6);
+
+    // Latency of top-10 lookups
+    SimilarRecipe results[TOP];
+    printf("%-26s %9s %9s %9s %10s\n", "lookup (µs)", "p50", "p99", "max", "avg found");
+    double found = 0;
+    for (size_t q = 0; q < QUERIES; q++) {
+        snprintf(id, sizeof(id), "recipe-%07u", random.below(recipeCount) + 1);
+        const uint64_t start = bench::nowNanos();
+        const size_t n = index.similar(id, strlen(id), 0.0f, results, TOP);
+        nanos[q] = bench::nowNanos() - start;
+        found += static_cast<double>(n);
+    }
+    printLatency("top 10", nanos, QUERIES, found / QUERIES);
+
+    // Recall against exact Jaccard, with the exact scan timed
+    uint32_t relevant[sizeof(THRESHOLDS) / sizeof(double)] = {};
+    uint32_t retrieved[sizeof(THRESHOLDS) / sizeof(double)] = {};
+    double error = 0;
+    uint32_t estimates = 0;
+    for (size_t q = 0; q < RECALL_QUERIES; q++) {
+        const uint32_t target = random.below(recipeCount);
+        const uint64_t start = bench::nowNanos();
+        for (uint32_t r = 0; r < recipeCount; r++) {
+            similarity[r] = r == target ? -1.0 : jaccard(recipes[target], recipes[r]);
+        }
+        nanos[q] = bench::nowNanos() - start;
+
+        snprintf(id, sizeof(id), "recipe-%07u", target + 1);
+        const size_t n = index.similar(id, strlen(id), 0.0f, results, TOP);
+        for (size_t i = 0; i < n; i++) {
+            const double exact = similarity[recipeIndex(index, results[i].recipe)];
+            error += fabs(results[i].similarity - exact);
+            estimates++;
+        }
+        for (size_t t = 0; t < sizeof(THRESHOLDS) / sizeof(double); t++) {
+            uint32_t above = 0;
+            for (uint32_t r = 0; r < recipeCount; r++) above += similarity[r] >= THRESHOLDS[t];
+            uint32_t hits = 0;
+            for (size_t i = 0; i < n; i++) {
+                hits += similarity[recipeIndex(index, results[i].recipe)] >= THRESHOLDS[t];
+            }
+            relevant[t] += std::min<uint32_t>(above, TOP);
+            retrieved[t] += hits;
+        }
+    }
+    printLatency("exact Jaccard scan", nanos, RECALL_QUERIES, 0);
+
+    printf("\n");
+    for (size_t t = 0; t < sizeof(THRESHOLDS) / sizeof(double); t++) {
+        printf("recall@%zu, Jaccard >= %.1f: %5.1f%% (%u of %u)\n", TOP, THRESHOLDS[t],
+               relevant[t] == 0 ? 100.0 : 100.0 * retrieved[t] / relevant[t], retrieved[t],
+               relevant[t]);
+    }
+    printf("mean estimate error:       %.3f\n", estimates == 0 ? 0.0 : error / estimates);
+
+    free(recipes);
+    free(nanos);
+    free(similarity);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+/**
+ * String interning benchmark
+ *
+ * Usage: string-pool-bench
+ *
+ * Parses the difficulty, category and unit fields out of a 100k-recipe
+ * payload and interns them. Reports how many Strings the JVM would hold
+ * with one instance per occurrence, as plain Moshi decoding produces,
+ * against one per distinct value plus the native pool, and the cost of
+ * decoding and interning a token.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "bench/recipe-corpus.h"
+#include "strings/string-pool.h"
+#include "sync/json-records.h"
+
+using namespace bakingapp;
+using bakingapp::strings::StringPool;
+
+namespace {
+    constexpr uint32_t PAGES = 1000;
+    constexpr uint32_t PAGE_SIZE = 100;
+    constexpr size_t PAGE_CAPACITY = 256 * 1024;
+
+    constexpr const char* FIELDS[] = {"\"difficulty\":", "\"category\":", "\"unit\":"};
+    constexpr size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+    struct Token {
+        uint32_t offset;                // opening quote in the payload
+        uint32_t length;                // quotes included
+    };
+
+    /**
+     * Shallow heap size of a compressed (Latin-1) java.lang.String on ART:
+     * 8-byte object header, count and hash, then the characters
+     */
+    uint64_t artStringBytes(size_t length) {
+        return (16 + length + 7) & ~uint64_t{7};
+    }
+
+    size_t findTokens(const char* json, size_t length, uint32_t base, Token* tokens,
+                      size_t capacity) {
+        size_t count = 0;
+        for (const char* field : FIELDS) {
+            const size_t fieldLength = strlen(field);
+            const char* p = json;
+            const char* const end = json + length;
+            while (count < capacity) {
+                const auto* hit = static_cast<const char*>(memmem(p, end - p, field, fieldLength));
+                if (hit == nullptr) break;
+                const char* open = hit + fieldLength;
+                const auto* close = static_cast<const char*>(memchr(open + 1, '"', end - open - 1));
+                if (*open != '"' || close == nullptr) break;
+                tokens[count++] = {base + static_cast<uint32_t>(open - json),
+                                   static_cast<uint32_t>(close - open + 1)};
+                p = close + 1;
+            }
+        }
+        return count;
+    }
+}
+
+int main() {
+    bench::printHeader("String interning (100k recipes)");
+
+    char* payload = static_cast<char*>(malloc(static_cast<size_t>(PAGES) * PAGE_CAPACITY));
+    const size_t tokenCapacity = static_cast<size_t>(PAGES) * PAGE_SIZE * 16;
+    auto* tokens = static_cast<Token*>(malloc(tokenCapacity * sizeof(Token)));
+    if (payload == nullptr || tokens == nullptr) return EXIT_FAILURE;
+
+    bench::Random random(40);
+    size_t payloadBytes = 0;
+    size_t tokenCount = 0;
+    for (uint32_t page = 0; page < PAGES; page++) {
+        char* json = payload + payloadBytes;
+        const size_t length = bench::makeRecipeListJson(random, page, PAGE_SIZE, json,
+                                                        PAGE_CAPACITY);
+        tokenCount += findTokens(json, length, static_cast<uint32_t>(payloadBytes),
+                                 tokens + tokenCount, tokenCapacity - tokenCount);
+        payloadBytes += length;
+    }
+
+    // Every occurrence as its own String, the way Moshi decodes them today
+    uint64_t perOccurrenceBytes = 0;
+    for (size_t i = 0; i < tokenCount; i++) perOccurrenceBytes += artStringBytes(tokens[i].length - 2);
+
+    StringPool pool;
+    char text[StringPool::MAX_LENGTH];
+    uint64_t best = UINT64_MAX;
+    for (int round = 0; round < 5; round++) {
+        pool.clear();
+        const uint64_t start = bench::nowNanos();
+        for (size_t i = 0; i < tokenCount; i++) {
+            const auto* token = reinterpret_cast<const uint8_t*>(payload + tokens[i].offset);
+            const size_t n = sync::decodeJsonString(token, tokens[i].length, text, sizeof(text));
+            bench::doNotOptimize(pool.intern(text, n));
+        }
+        const uint64_t elapsed = bench::nowNanos() - start;
+        if (elapsed < best) best = elapsed;
+    }
+
+    uint64_t sharedBytes = 0;
+    for (uint32_t id = 1; id <= pool.size(); id++) {
+        size_t length = 0;
+        pool.text(id, &length);
+        sharedBytes += artStringBytes(length);
+    }
+    const auto stats = pool.stats();
+    const uint64_t nativeBytes = stats.arenaBytes + stats.indexBytes + 8ull * pool.size();
+
+    printf("payload:            %8.1f MB\n", payloadBytes / 1e6);
+    printf("field values:       %8zu (%u distinct)\n", tokenCount, pool.size());
+    printf("String per value:   %8.2f MB Java heap\n", perOccurrenceBytes / 1e6);
+    printf("interned:           %8.2f KB Java heap + %.1f KB native\n", sharedBytes / 1e3,
+           nativeBytes / 1e3);
+    printf("decode + intern:    %8.1f ns per value\n", static_cast<double>(best) / tokenCount);
+
+    free(payload);
+    free(tokens);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/**
+ * Telemetry benchmark
+ *
+ * Usage: telemetry-bench [threads]
+ *
+ * Producer cost of record() in bursts that fit a ring, each producer
+ * flushing between its bursts outside the timed part:
+ * - clock:     clock_gettime(CLOCK_MONOTONIC) alone, the floor of record()
+ * - record:    one producer
+ * - record xN: N producers at once, each into its own ring (with fewer
+ *   cores than producers, preemption inside a burst is counted too)
+ * - log line:  the old way, a formatted line written with one syscall, as
+ *   liblog does for Log.d (to /dev/null, so this is the cheapest case)
+ *
+ * "over clock" is what the ring itself adds to the clock read.
+ *
+ * Then the file: bytes per event and flush throughput.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "bench/bench-util.h"
+#include "telemetry/telemetry.h"
+
+using namespace bakingapp::bench;
+using namespace bakingapp::telemetry;
+
+namespace {
+    constexpr uint32_t BURST = 1000;
+    constexpr uint32_t BURSTS = 500;
+    constexpr uint32_t LOG_LINES = 200000;
+    constexpr uint32_t DEFAULT_THREADS = 4;
+
+    struct Producer {
+        Telemetry* telemetry;
+        pthread_barrier_t* start;
+        uint64_t nanos;
+    };
+
+    // Bursts stay below the ring capacity, so nothing is dropped
+    void* produce(void* argument) {
+        auto* producer = static_cast<Producer*>(argument);
+        pthread_barrier_wait(producer->start);
+        uint64_t total = 0;
+        for (uint32_t burst = 0; burst < BURSTS; burst++) {
+            const uint64_t start = nowNanos();
+            for (uint32_t i = 0; i < BURST; i++) {
+                producer->telemetry->record(EventType::KEY_FETCH, i, burst);
+            }
+            total += nowNanos() - start;
+            producer->telemetry->flush();
+        }
+        producer->nanos = total;
+        return nullptr;
+    }
+
+    double recordNanos(Telemetry& telemetry, uint32_t threads) {
+        pthread_barrier_t start;
+        pthread_barrier_init(&start, nullptr, threads);
+        pthread_t* handles = static_cast<pthread_t*>(malloc(sizeof(pthread_t) * threads));
+        Producer* producers = static_cast<Producer*>(malloc(sizeof(Producer) * threads));
+        for (uint32_t t = 0; t < threads; t++) {
+            producers[t] = Producer {&telemetry, &start, 0};
+            pthread_create(&handles[t], nullptr, produce, &producers[t]);
+        }
+        uint64_t total = 0;
+        for (uint32_t t = 0; t < threads; t++) {
+            pthread_join(handles[t], nullptr);
+            total += producers[t].nanos;
+        }
+        pthread_barrier_destroy(&start);
+        free(handles);
+        free(producers);
+        return static_cast<double>(total) / (static_cast<double>(threads) * BURSTS * BURST);
+    }
+
+    double clockNanos() {
+        const uint32_t count = BURSTS * BURST;
+        int64_t sum = 0;
+        const uint64_t start = nowNanos();
+        for (uint32_t i = 0; i < count; i++) sum += telemetryNanos();
+        doNotOptimize(sum);
+        return static_cast<double>(nowNanos() - start) / count;
+    }
+
+    double logLineNanos() {
+        const int fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        if (fd < 0) return 0;
+        char line[128];
+        const uint64_t start = nowNanos();
+        for (uint32_t i = 0; i < LOG_LINES; i++) {
+            const int length = snprintf(line, sizeof(line), "D/NativeKeys: key fetch %u at %lld\n",
+                                        i, static_cast<long long>(telemetryNanos()));
+            if (write(fd, line, static_cast<size_t>(length)) < 0) break;
+        }
+        const uint64_t elapsed = nowNanos() - start;
+        close(fd);
+        return static_cast<double>(elapsed) / LOG_LINES;
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t threads = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : DEFAULT_THREADS;
+
+    char path[] = "/tmp/telemetry-bench-XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return EXIT_FAILURE;
+    }
+    close(fd);
+
+    printHeader("producer cost");
+    printf("%-12s %10s %10s\n", "mode", "ns/event", "over clock");
+    const double clock = clockNanos();
+    printf("%-12s %10.1f %10s\n", "clock", clock, "-");
+
+    Telemetry telemetry;
+    // Flushed by hand; no size limit, so the file holds every event
+    if (!telemetry.start(path, 60000, 0)) {
+        fprintf(stderr, "cannot start telemetry on %s\n", path);
+        return EXIT_FAILURE;
+    }
+    const double single = recordNanos(telemetry, 1);
+    printf("%-12s %10.1f %10.1f\n", "record", single, single - clock);
+    char label[16];
+    snprintf(label, sizeof(label), "record x%u", threads);
+    const double parallel = recordNanos(telemetry, threads);
+    printf("%-12s %10.1f %10.1f\n", label, parallel, parallel - clock);
+    const double logLine = logLineNanos();
+    printf("%-12s %10.1f %10.1f\n", "log line", logLine, logLine - clock);
+
+    // Flush throughput: full rings drained in one go
+    for (uint32_t i = 0; i < EventRing::CAPACITY; i++) telemetry.record(EventType::TIMER_TICK, i);
+    const uint64_t flushStart = nowNanos();
+    telemetry.flush();
+    const uint64_t flushNanos = nowNanos() - flushStart;
+    telemetry.stop();
+
+    const TelemetryStats stats = telemetry.stats();
+    printHeader("file");
+    printf("%llu events flushed, %llu dropped, %llu bytes (%.2f bytes/event, raw %zu)\n",
+           static_cast<unsigned long long>(stats.flushedEvents),
+           static_cast<unsigned long long>(stats.droppedEvents),
+           static_cast<unsigned long long>(stats.fileBytes),
+           stats.flushedEvents > 0 ? static_cast<double>(stats.fileBytes) / stats.flushedEvents : 0,
+           sizeof(TelemetryEvent));
+    printf("flush of %u events: %.1f us (%.1f M events/s)\n", EventRing::CAPACITY,
+           static_cast<double>(flushNanos) / 1000,
+           flushNanos > 0 ? EventRing::CAPACITY * 1000.0 / static_cast<double>(flushNanos) : 0);
+
+    unlink(path);
+    return EXIT_SUCCESS;
+}
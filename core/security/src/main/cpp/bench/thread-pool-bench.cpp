@@ -0,0 +1,148 @@
+/**
+ * Thread pool scaling benchmark
+ *
+ * Usage: thread-pool-bench [max-threads]
+ *
+ * Runs the same work on pools of 0 to N-1 workers (1 to N threads counting
+ * the caller), N defaulting to performanceCoreCount():
+ * - hash:  XXH64 over 64 KiB blocks of a 256 MiB buffer, one parallelFor
+ * - fork:  recursive fork-join sum down to 4k-element leaves
+ * - latency: round trip of an 8-chunk parallelFor with an empty body
+ * Speedup is against the 1-thread run; efficiency is speedup / threads.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "common/hash.h"
+#include "common/thread-pool.h"
+
+using namespace bakingapp;
+using namespace bakingapp::bench;
+
+namespace {
+    constexpr size_t BUFFER_BYTES = 256u << 20;
+    constexpr size_t BLOCK_BYTES = 64u << 10;
+    constexpr uint64_t FORK_ITEMS = uint64_t {1} << 28;
+    constexpr uint64_t FORK_LEAF = 4096;
+    constexpr int LATENCY_ROUNDS = 20000;
+    constexpr int RUNS = 5;
+
+    struct SumTask : Task {
+        ThreadPool* pool;
+        uint64_t from;
+        uint64_t to;
+        uint64_t result;
+    };
+
+    void sumRange(Task* task) {
+        auto* sum = static_cast<SumTask*>(task);
+        if (sum->to - sum->from <= FORK_LEAF) {
+            uint64_t total = 0;
+            for (uint64_t i = sum->from; i < sum->to; i++) total += i * i;
+            sum->result = total;
+            return;
+        }
+        const uint64_t middle = sum->from + (sum->to - sum->from) / 2;
+        SumTask left;
+        left.run = sumRange;
+        left.pool = sum->pool;
+        left.from = sum->from;
+        left.to = middle;
+        SumTask right = left;
+        right.from = middle;
+        right.to = sum->to;
+
+        TaskGroup group(*sum->pool);
+        group.spawn(&right);
+        sumRange(&left);
+        group.wait();
+        sum->result = left.result + right.result;
+    }
+
+    uint64_t hashBlocks(ThreadPool& pool, const uint8_t* buffer, uint64_t* hashes) {
+        const uint64_t start = nowNanos();
+        pool.parallelFor(0, BUFFER_BYTES / BLOCK_BYTES, 1, [&](size_t from, size_t to) {
+            for (size_t i = from; i < to; i++) hashes[i] = hash64(buffer + i * BLOCK_BYTES, BLOCK_BYTES);
+        });
+        return nowNanos() - start;
+    }
+
+    uint64_t forkJoin(ThreadPool& pool) {
+        SumTask root;
+        root.run = sumRange;
+        root.pool = &pool;
+        root.from = 0;
+        root.to = FORK_ITEMS;
+        const uint64_t start = nowNanos();
+        sumRange(&root);
+        const uint64_t elapsed = nowNanos() - start;
+        doNotOptimize(root.result);
+        return elapsed;
+    }
+
+    uint64_t latency(ThreadPool& pool) {
+        const uint64_t start = nowNanos();
+        for (int round = 0; round < LATENCY_ROUNDS; round++) {
+            pool.parallelFor(0, 8, 1, [](size_t from, size_t to) { doNotOptimize(from + to); });
+        }
+        return (nowNanos() - start) / LATENCY_ROUNDS;
+    }
+
+    template <typename F>
+    uint64_t best(F&& run) {
+        uint64_t fastest = UINT64_MAX;
+        for (int i = 0; i < RUNS; i++) {
+            const uint64_t elapsed = run();
+            if (elapsed < fastest) fastest = elapsed;
+        }
+        return fastest;
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t maxThreads = performanceCoreCount();
+    if (argc > 1) maxThreads = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    if (maxThreads == 0) maxThreads = 1;
+
+    auto* buffer = static_cast<uint8_t*>(malloc(BUFFER_BYTES));
+    auto* hashes = static_cast<uint64_t*>(malloc(BUFFER_BYTES / BLOCK_BYTES * sizeof(uint64_t)));
+    Random random;
+    for (size_t i = 0; i < BUFFER_BYTES; i += 8) {
+        const uint64_t value = random.next();
+        memcpy(buffer + i, &value, 8);
+    }
+
+    printHeader("thread pool scaling");
+    printf("performance cores: %u, best of %d\n", performanceCoreCount(), RUNS);
+    printf("%8s %10s %8s %6s %10s %8s %6s %12s\n", "threads", "hash ms", "speedup", "eff",
+           "fork ms", "speedup", "eff", "latency ns");
+
+    double hashBase = 0;
+    double forkBase = 0;
+    for (uint32_t threads = 1; threads <= maxThreads; threads++) {
+        ThreadPool pool;
+        if (!pool.start(threads - 1)) {
+            fprintf(stderr, "could not start %u workers\n", threads - 1);
+            return 1;
+        }
+        const double hashMs = best([&] { return hashBlocks(pool, buffer, hashes); }) / 1e6;
+        const double forkMs = best([&] { return forkJoin(pool); }) / 1e6;
+        const uint64_t roundTrip = latency(pool);
+        if (threads == 1) {
+            hashBase = hashMs;
+            forkBase = forkMs;
+        }
+        printf("%8u %10.2f %7.2fx %5.0f%% %10.2f %7.2fx %5.0f%% %12llu\n", threads, hashMs,
+               hashBase / hashMs, 100.0 * hashBase / hashMs / threads, forkMs, forkBase / forkMs,
+               100.0 * forkBase / forkMs / threads, static_cast<unsigned long long>(roundTrip));
+    }
+    doNotOptimize(hashes[0]);
+
+    free(hashes);
+    free(buffer);
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * Timer tick benchmark
+ *
+ * Usage: timer-bench
+ *
+ * Cost of one tick over 1k to 100k running timers:
+ * - copy:      the old repository path, copying the whole timer map once per
+ *              running timer (O(N^2); a memcpy, so far cheaper than copying
+ *              a Kotlin LinkedHashMap, and skipped at 100k)
+ * - decrement: one in-place decrement per timer per second
+ * - 1 Hz:      TimerTable::tick once a second (every timer changes)
+ * - 60 Hz:     TimerTable::tick once per frame (about 1/60 of them change)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "timers/timer-table.h"
+
+using namespace bakingapp;
+using namespace bakingapp::timers;
+
+namespace {
+    constexpr int64_t SECOND = NANOS_PER_SECOND;
+    constexpr int64_t FRAME = SECOND / 60;
+    constexpr size_t COPY_LIMIT = 10000;
+
+    /**
+     * Roughly the fields of a CookingTimer the map copy moves around
+     */
+    struct TimerRecord {
+        uint64_t id;
+        int64_t durationSeconds;
+        int64_t remainingSeconds;
+        int64_t createdAt;
+        uint32_t status;
+        uint32_t padding;
+    };
+
+    double copyPerTick(TimerRecord* records, TimerRecord* scratch, size_t count) {
+        const int rounds = count <= 1000 ? 20 : 2;
+        const uint64_t start = bench::nowNanos();
+        for (int r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < count; i++) {
+                memcpy(scratch, records, count * sizeof(TimerRecord));
+                scratch[i].remainingSeconds--;
+                memcpy(records, scratch, count * sizeof(TimerRecord));
+            }
+            bench::doNotOptimize(records[count - 1].remainingSeconds);
+        }
+        return static_cast<double>(bench::nowNanos() - start) / rounds / 1000.0;
+    }
+
+    double decrementPerTick(TimerRecord* records, size_t count) {
+        const int rounds = 200;
+        const uint64_t start = bench::nowNanos();
+        for (int r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < count; i++) {
+                if (records[i].remainingSeconds > 0) records[i].remainingSeconds--;
+            }
+            bench::doNotOptimize(records[count - 1].remainingSeconds);
+        }
+        return static_cast<double>(bench::nowNanos() - start) / rounds / 1000.0;
+    }
+
+    /**
+     * Average microseconds per tick over simulated ticks of the given period
+     */
+    double tablePerTick(size_t count, int64_t period, int ticks, size_t* eventsPerTick) {
+        TimerTable table;
+        bench::Random random(count);
+        // Timers started at different instants so second boundaries spread out
+        for (size_t i = 0; i < count; i++) {
+            table.add(600 + random.below(3000), true, random.below(SECOND));
+        }
+
+        auto* events = static_cast<TimerEvent*>(malloc(count * sizeof(TimerEvent)));
+        int64_t now = SECOND;
+        size_t total = 0;
+        uint64_t elapsed = 0;
+        for (int t = 0; t < ticks; t++) {
+            now += period;
+            const uint64_t start = bench::nowNanos();
+            total += table.tick(now, events, count);
+            elapsed += bench::nowNanos() - start;
+        }
+        free(events);
+        *eventsPerTick = total / static_cast<size_t>(ticks);
+        return static_cast<double>(elapsed) / ticks / 1000.0;
+    }
+}
+
+int main() {
+    bench::printHeader("Timer tick (us per tick, all timers running)");
+    printf("%8s %12s %12s %12s %10s %12s %10s\n", "timers", "copy", "decrement", "1 Hz",
+           "events", "60 Hz", "events");
+
+    const size_t sizes[] = {1000, 10000, 100000};
+    for (size_t count : sizes) {
+        auto* records = static_cast<TimerRecord*>(calloc(count, sizeof(TimerRecord)));
+        auto* scratch = static_cast<TimerRecord*>(calloc(count, sizeof(TimerRecord)));
+        for (size_t i = 0; i < count; i++) {
+            records[i] = {i, 3600, 3600, static_cast<int64_t>(i), 1, 0};
+        }
+
+        char copy[16] = "-";
+        if (count <= COPY_LIMIT) snprintf(copy, sizeof(copy), "%.0f", copyPerTick(records, scratch, count));
+        const double decrement = decrementPerTick(records, count);
+
+        size_t secondEvents = 0;
+        size_t frameEvents = 0;
+        const double second = tablePerTick(count, SECOND, 60, &secondEvents);
+        const double frame = tablePerTick(count, FRAME, 600, &frameEvents);
+
+        printf("%8zu %12s %12.1f %12.1f %10zu %12.1f %10zu\n", count, copy, decrement, second,
+               secondEvents, frame, frameEvents);
+        free(records);
+        free(scratch);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+/**
+ * Timer journal benchmark
+ *
+ * Usage: timer-journal-bench [directory]
+ *
+ * For 10 to 10k timers, each put once and then started and paused four
+ * times:
+ * - append:   average cost of one transition record
+ * - recover:  open + replay + snapshot, what a restarted process pays
+ * - compact:  rewriting the live timers into a fresh file
+ * - sizes of the journal before and after compaction
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "bench/bench-util.h"
+#include "timers/timer-journal.h"
+
+using namespace bakingapp;
+using namespace bakingapp::timers;
+
+namespace {
+    constexpr int64_t NANOS_PER_SECOND = 1000000000LL;
+    constexpr int TRANSITIONS_PER_TIMER = 8;
+
+    // Roughly what the app stores per timer: name, description, duration,
+    // recipe id, step number and creation time
+    constexpr size_t METADATA_LENGTH = 96;
+
+    JournalState stateAt(int round, int64_t now) {
+        const bool running = round % 2 == 0;
+        return {static_cast<uint8_t>(running ? 1 : 2), running, 3600 - round, now, now / 1000000};
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* directory = argc > 1 ? argv[1] : "/tmp";
+    char path[512];
+    snprintf(path, sizeof(path), "%s/timer-journal-bench.%d", directory, static_cast<int>(getpid()));
+
+    bench::printHeader("Timer journal");
+    printf("%8s %12s %12s %12s %12s %12s\n", "timers", "append (ns)", "recover (us)",
+           "compact (us)", "before (KB)", "after (KB)");
+
+    char metadata[METADATA_LENGTH];
+    memset(metadata, 'm', sizeof(metadata));
+    char* buffer = nullptr;
+
+    const int sizes[] = {10, 100, 1000, 10000};
+    for (int count : sizes) {
+        unlink(path);
+        TimerJournal journal;
+        if (!journal.open(path)) {
+            fprintf(stderr, "cannot open %s\n", path);
+            return EXIT_FAILURE;
+        }
+
+        char id[32];
+        for (int i = 0; i < count; i++) {
+            const int length = snprintf(id, sizeof(id), "%08x-timer", i * 2654435761u);
+            journal.put(id, length, metadata, sizeof(metadata), stateAt(1, 0));
+        }
+        const uint64_t appendStart = bench::nowNanos();
+        for (int round = 0; round < TRANSITIONS_PER_TIMER; round++) {
+            for (int i = 0; i < count; i++) {
+                const int length = snprintf(id, sizeof(id), "%08x-timer", i * 2654435761u);
+                journal.transition(id, length, stateAt(round, round * NANOS_PER_SECOND));
+            }
+        }
+        const double append = static_cast<double>(bench::nowNanos() - appendStart) /
+            (count * TRANSITIONS_PER_TIMER);
+        const uint64_t before = journal.stats().usedBytes;
+        journal.close();
+
+        // Recovery, best of 5 (the file stays in the page cache, as it would
+        // for a process restarted by the system)
+        uint64_t recover = UINT64_MAX;
+        for (int r = 0; r < 5; r++) {
+            const uint64_t start = bench::nowNanos();
+            journal.open(path);
+            const size_t required = journal.snapshot(NANOS_PER_SECOND, 1000, nullptr, 0);
+            buffer = static_cast<char*>(realloc(buffer, required));
+            journal.snapshot(NANOS_PER_SECOND, 1000, reinterpret_cast<uint8_t*>(buffer), required);
+            bench::doNotOptimize(buffer[0]);
+            const uint64_t elapsed = bench::nowNanos() - start;
+            if (elapsed < recover) recover = elapsed;
+            if (r < 4) journal.close();
+        }
+
+        const uint64_t compactStart = bench::nowNanos();
+        journal.compact();
+        const double compact = static_cast<double>(bench::nowNanos() - compactStart) / 1000.0;
+        const uint64_t after = journal.stats().usedBytes;
+
+        printf("%8d %12.0f %12.1f %12.1f %12.1f %12.1f\n", count, append, recover / 1000.0,
+               compact, before / 1024.0, after / 1024.0);
+    }
+    free(buffer);
+    unlink(path);
+    return EXIT_SUCCESS;
+}
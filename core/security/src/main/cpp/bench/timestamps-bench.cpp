@@ -0,0 +1,154 @@
+/**
+ * ISO-8601 timestamp parsing benchmark
+ *
+ * Usage: timestamps-bench
+ *
+ * 1M timestamps in the forms servers send: 'Z', numeric offsets and 0, 3
+ * or 6 fraction digits, '\n'-joined as NativeTimestampParser passes them.
+ * - native lines: parseTimestampLines over the whole batch, best of 5
+ * - strptime + timegm: libc, one string at a time, the way a per-string
+ *   formatter (java.time's, on the JVM) walks the pattern
+ * - records: created_at/updated_at straight from a 100k-recipe list body
+ *   (bench/recipe-corpus.h), scan included
+ *
+ * Build with -U__SSE2__ (or for a NEON-less ARM target) to time the
+ * scalar prefix check.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "bench/bench-util.h"
+#include "bench/recipe-corpus.h"
+#include "sync/timestamps.h"
+
+using namespace bakingapp;
+using namespace bakingapp::sync;
+
+namespace {
+    constexpr size_t TIMESTAMPS = 1000000;
+    constexpr uint32_t RECIPES = 100000;
+    constexpr size_t BYTES_PER_RECIPE = 4096;
+    constexpr int RUNS = 5;
+
+    const char* const OFFSETS[] = {"Z", "Z", "+00:00", "+02:00", "-05:00", "+05:30"};
+
+    /**
+     * Writes TIMESTAMPS timestamps, '\n'-separated
+     */
+    size_t makeLines(bench::Random& random, char* out, size_t capacity) {
+        size_t n = 0;
+        for (size_t i = 0; i < TIMESTAMPS; i++) {
+            char fraction[8] = "";
+            switch (random.below(3)) {
+                case 1: snprintf(fraction, sizeof(fraction), ".%03u", random.below(1000)); break;
+                case 2: snprintf(fraction, sizeof(fraction), ".%06u", random.below(1000000)); break;
+                default: break;
+            }
+            n += static_cast<size_t>(snprintf(
+                out + n, capacity - n, "%s20%02u-%02u-%02uT%02u:%02u:%02u%s%s", i == 0 ? "" : "\n",
+                10 + random.below(20), 1 + random.below(12), 1 + random.below(28),
+                random.below(24), random.below(60), random.below(60), fraction,
+                OFFSETS[random.below(sizeof(OFFSETS) / sizeof(OFFSETS[0]))]));
+        }
+        return n;
+    }
+
+    /**
+     * libc baseline: strptime for the fields, then the tail by hand
+     */
+    int64_t parseWithLibc(const char* line) {
+        tm parts {};
+        const char* rest = strptime(line, "%Y-%m-%dT%H:%M:%S", &parts);
+        if (rest == nullptr) return NO_TIMESTAMP;
+        int64_t millis = static_cast<int64_t>(timegm(&parts)) * 1000;
+        if (*rest == '.') {
+            char* end = nullptr;
+            const double fraction = strtod(rest, &end);
+            millis += static_cast<int64_t>(fraction * 1000);
+            rest = end;
+        }
+        int hours = 0;
+        int minutes = 0;
+        if ((*rest == '+' || *rest == '-') && sscanf(rest + 1, "%d:%d", &hours, &minutes) == 2) {
+            const int64_t offset = (hours * 3600 + minutes * 60) * 1000;
+            millis += *rest == '-' ? offset : -offset;
+        }
+        return millis;
+    }
+
+    double millionsPerSecond(size_t count, uint64_t nanos) {
+        return static_cast<double>(count) * 1e3 / static_cast<double>(nanos);
+    }
+}
+
+int main() {
+    bench::Random random(42);
+    const size_t capacity = TIMESTAMPS * 40;
+    auto* text = static_cast<char*>(malloc(capacity));
+    const size_t length = makeLines(random, text, capacity);
+    auto* out = static_cast<int64_t*>(malloc(TIMESTAMPS * sizeof(int64_t)));
+
+    bench::printHeader("ISO-8601 timestamps");
+    printf("%zu timestamps, %.1f MB\n\n", TIMESTAMPS, length / 1e6);
+
+    uint64_t native = UINT64_MAX;
+    for (int r = 0; r < RUNS; r++) {
+        const uint64_t start = bench::nowNanos();
+        const size_t count = parseTimestampLines(text, length, out, TIMESTAMPS);
+        bench::doNotOptimize(count);
+        const uint64_t elapsed = bench::nowNanos() - start;
+        if (elapsed < native) native = elapsed;
+    }
+
+    // Same batch, split by hand so libc sees NUL-terminated lines
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\n') text[i] = '\0';
+    }
+    uint64_t libc = UINT64_MAX;
+    size_t mismatches = 0;
+    for (int r = 0; r < RUNS; r++) {
+        mismatches = 0;
+        const char* line = text;
+        const uint64_t start = bench::nowNanos();
+        for (size_t i = 0; i < TIMESTAMPS; i++) {
+            const int64_t millis = parseWithLibc(line);
+            mismatches += millis != out[i];
+            line += strlen(line) + 1;
+        }
+        const uint64_t elapsed = bench::nowNanos() - start;
+        if (elapsed < libc) libc = elapsed;
+    }
+    printf("%-28s %8.1f M/s  %6.1f ns each\n", "native lines",
+           millionsPerSecond(TIMESTAMPS, native), static_cast<double>(native) / TIMESTAMPS);
+    printf("%-28s %8.1f M/s  %6.1f ns each\n", "strptime + timegm",
+           millionsPerSecond(TIMESTAMPS, libc), static_cast<double>(libc) / TIMESTAMPS);
+    printf("%-28s %8.1fx  (%zu mismatches)\n\n", "speedup",
+           static_cast<double>(libc) / static_cast<double>(native), mismatches);
+
+    auto* body = static_cast<char*>(malloc(RECIPES * BYTES_PER_RECIPE));
+    const size_t bodyLength = bench::makeRecipeListJson(random, 0, RECIPES, body,
+                                                        RECIPES * BYTES_PER_RECIPE);
+    const char* const fields[] = {"created_at", "updated_at"};
+    auto* values = static_cast<int64_t*>(malloc(2 * RECIPES * sizeof(int64_t)));
+    uint64_t records = UINT64_MAX;
+    size_t count = 0;
+    for (int r = 0; r < RUNS; r++) {
+        const uint64_t start = bench::nowNanos();
+        count = parseRecordTimestamps(reinterpret_cast<const uint8_t*>(body), bodyLength,
+                                      "recipes", fields, 2, values, 2 * RECIPES);
+        const uint64_t elapsed = bench::nowNanos() - start;
+        if (elapsed < records) records = elapsed;
+    }
+    printf("%-28s %8.1f M records/s  (%zu records, %.1f MB body)\n", "records (scan + parse)",
+           millionsPerSecond(count, records), count, bodyLength / 1e6);
+
+    free(values);
+    free(body);
+    free(out);
+    free(text);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+/**
+ * Ingredient scaling benchmark
+ *
+ * Usage: units-bench
+ *
+ * Compares the batch kernel against a per-ingredient path that resolves
+ * the unit string and converts one object at a time, as the Kotlin code did,
+ * for recipes of 10 to 10,000 ingredients.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "units/ingredient-scaler.h"
+#include "units/unit-interner.h"
+
+using namespace bakingapp;
+using namespace bakingapp::units;
+
+namespace {
+    constexpr const char* UNIT_TEXT[] = {
+        "cups", "Tbsp", "tsp", "g", "grams", "oz", "lb", "ml", "pinch", "pieces", "handful",
+        "kg", "fl oz", "cloves", "l",
+    };
+    constexpr size_t UNIT_TEXT_COUNT = sizeof(UNIT_TEXT) / sizeof(UNIT_TEXT[0]);
+
+    struct Ingredient {
+        double quantity;
+        const char* unit;
+    };
+
+    /**
+     * One ingredient at a time: normalize and look up the unit string, then
+     * convert with the scalar path
+     */
+    double perObject(const Ingredient* ingredients, size_t count, double factor,
+                     UnitSystem system) {
+        double checksum = 0;
+        for (size_t i = 0; i < count; i++) {
+            char normalized[MAX_UNIT_LENGTH + 1];
+            const size_t n = normalizeUnit(ingredients[i].unit, strlen(ingredients[i].unit),
+                                           normalized);
+            uint8_t code = findBuiltinUnit(normalized, n);
+            if (code == UNKNOWN_UNIT) code = NONE;
+            double out = 0;
+            uint8_t outUnit = 0;
+            scaleQuantitiesScalar(&ingredients[i].quantity, &code, 1, factor, system, &out,
+                                  &outUnit);
+            checksum += out + outUnit;
+        }
+        return checksum;
+    }
+}
+
+int main() {
+    bench::printHeader("Ingredient scaling (ns per ingredient)");
+    printf("%8s %12s %12s %12s %12s\n", "count", "per-object", "intern", "scalar", "simd");
+
+    UnitInterner interner;
+    const size_t sizes[] = {10, 100, 1000, 10000};
+    for (size_t count : sizes) {
+        auto* ingredients = static_cast<Ingredient*>(malloc(count * sizeof(Ingredient)));
+        auto* quantities = static_cast<double*>(malloc(count * sizeof(double)));
+        auto* units = static_cast<uint8_t*>(malloc(count));
+        auto* out = static_cast<double*>(malloc(count * sizeof(double)));
+        auto* outUnits = static_cast<uint8_t*>(malloc(count));
+        bench::Random random(count);
+        for (size_t i = 0; i < count; i++) {
+            ingredients[i] = {random.below(100000) / 100.0,
+                              UNIT_TEXT[random.below(UNIT_TEXT_COUNT)]};
+            quantities[i] = ingredients[i].quantity;
+        }
+
+        const size_t rounds = 2000000 / count + 10;
+        const UnitSystem systems[] = {UnitSystem::METRIC, UnitSystem::IMPERIAL};
+
+        uint64_t start = bench::nowNanos();
+        for (size_t r = 0; r < rounds; r++) {
+            bench::doNotOptimize(perObject(ingredients, count, 1.5, systems[r & 1]));
+        }
+        const double perObjectNs = static_cast<double>(bench::nowNanos() - start) / (rounds * count);
+
+        start = bench::nowNanos();
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < count; i++) {
+                units[i] = interner.intern(ingredients[i].unit, strlen(ingredients[i].unit));
+            }
+            bench::doNotOptimize(units[count - 1]);
+        }
+        const double internNs = static_cast<double>(bench::nowNanos() - start) / (rounds * count);
+
+        start = bench::nowNanos();
+        for (size_t r = 0; r < rounds; r++) {
+            scaleQuantitiesScalar(quantities, units, count, 1.5, systems[r & 1], out, outUnits);
+            bench::doNotOptimize(out[count - 1]);
+        }
+        const double scalarNs = static_cast<double>(bench::nowNanos() - start) / (rounds * count);
+
+        start = bench::nowNanos();
+        for (size_t r = 0; r < rounds; r++) {
+            scaleQuantities(quantities, units, count, 1.5, systems[r & 1], out, outUnits);
+            bench::doNotOptimize(out[count - 1]);
+        }
+        const double simdNs = static_cast<double>(bench::nowNanos() - start) / (rounds * count);
+
+        printf("%8zu %12.2f %12.2f %12.2f %12.2f\n", count, perObjectNs, internNs, scalarNs,
+               simdNs);
+        free(ingredients);
+        free(quantities);
+        free(units);
+        free(out);
+        free(outUnits);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+#include "cache/dictionary-trainer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/hash.h"
+#include "common/native-memory.h"
+
+namespace bakingapp::cache {
+
+namespace {
+    constexpr uint32_t TABLE_BITS = 20;
+    constexpr uint32_t TABLE_SIZE = 1u << TABLE_BITS;
+
+    inline uint32_t dmerBucket(const uint8_t* p, uint32_t d) {
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        memcpy(&lo, p, std::min<uint32_t>(d, 8));
+        if (d > 8) memcpy(&hi, p + 8, d - 8);
+        return static_cast<uint32_t>(mix64(lo ^ mix64(hi)) >> (64 - TABLE_BITS));
+    }
+
+    struct Segment {
+        size_t start;
+        uint64_t score;
+    };
+
+    struct Workspace {
+        uint8_t* corpus = nullptr;
+        uint32_t* buckets = nullptr;     // dmer bucket per corpus position
+        uint32_t* frequency = nullptr;   // samples containing each bucket
+        uint32_t* lastSample = nullptr;  // dedups counting within a sample
+        uint16_t* active = nullptr;      // occurrences inside the window
+        Segment* segments = nullptr;
+
+        ~Workspace() {
+            taggedFree(segments);
+            taggedFree(corpus);
+            taggedFree(buckets);
+            taggedFree(frequency);
+            taggedFree(lastSample);
+            taggedFree(active);
+        }
+    };
+}
+
+size_t trainDictionary(const uint8_t* const* samples, const size_t* sizes, size_t count,
+                       uint8_t* dictionary, size_t capacity, const DictionaryParams& params) {
+    const uint32_t d = std::min<uint32_t>(std::max<uint32_t>(params.dmerSize, 4), 16);
+    const uint32_t k = std::max<uint32_t>(params.segmentSize, d + 1);
+    if (count == 0 || capacity < k) return 0;
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) total += sizes[i];
+    if (total < static_cast<size_t>(k) * 2 || total > UINT32_MAX) return 0;
+
+    Workspace ws;
+    ws.corpus = static_cast<uint8_t*>(taggedMalloc(MemoryTag::CACHES, total + 16));
+    ws.buckets = static_cast<uint32_t*>(taggedMalloc(MemoryTag::CACHES, total * sizeof(uint32_t)));
+    ws.frequency = static_cast<uint32_t*>(
+        taggedCalloc(MemoryTag::CACHES, TABLE_SIZE, sizeof(uint32_t)));
+    ws.lastSample = static_cast<uint32_t*>(
+        taggedCalloc(MemoryTag::CACHES, TABLE_SIZE, sizeof(uint32_t)));
+    ws.active = static_cast<uint16_t*>(
+        taggedCalloc(MemoryTag::CACHES, TABLE_SIZE, sizeof(uint16_t)));
+    if (ws.corpus == nullptr || ws.buckets == nullptr || ws.frequency == nullptr ||
+        ws.lastSample == nullptr || ws.active == nullptr) {
+        return 0;
+    }
+
+    // Concatenate samples and score every dmer by how many samples contain
+    // it. Dmers straddling a sample boundary get no bucket.
+    const uint32_t NO_BUCKET = UINT32_MAX;
+    size_t offset = 0;
+    for (size_t s = 0; s < count; s++) {
+        memcpy(ws.corpus + offset, samples[s], sizes[s]);
+        for (size_t i = 0; i < sizes[s]; i++) {
+            if (i + d > sizes[s]) {
+                ws.buckets[offset + i] = NO_BUCKET;
+                continue;
+            }
+            const uint32_t bucket = dmerBucket(ws.corpus + offset + i, d);
+            ws.buckets[offset + i] = bucket;
+            if (ws.lastSample[bucket] != s + 1) {
+                ws.lastSample[bucket] = static_cast<uint32_t>(s + 1);
+                ws.frequency[bucket]++;
+            }
+        }
+        offset += sizes[s];
+    }
+    memset(ws.corpus + total, 0, 16);
+
+    // Pick the best segment of each epoch
+    const size_t epochs = std::max<size_t>(1, std::min(capacity / k, total / (k * 2)));
+    const size_t epochSize = total / epochs;
+    ws.segments = static_cast<Segment*>(taggedMalloc(MemoryTag::CACHES, epochs * sizeof(Segment)));
+    if (ws.segments == nullptr) return 0;
+    size_t chosen = 0;
+
+    for (size_t e = 0; e < epochs; e++) {
+        const size_t begin = e * epochSize;
+        const size_t end = std::min(total, begin + epochSize);
+        if (end - begin < k) break;
+
+        // Sliding window over dmer starts; a dmer scores once per window
+        uint64_t score = 0;
+        uint64_t bestScore = 0;
+        size_t bestStart = begin;
+        const size_t windowDmers = k - d + 1;
+        for (size_t i = begin; i < end; i++) {
+            const uint32_t in = ws.buckets[i];
+            if (in != NO_BUCKET && ws.active[in]++ == 0) score += ws.frequency[in];
+            if (i >= begin + windowDmers) {
+                const uint32_t out = ws.buckets[i - windowDmers];
+                if (out != NO_BUCKET && --ws.active[out] == 0) score -= ws.frequency[out];
+            }
+            if (i + 1 >= begin + windowDmers && score > bestScore) {
+                bestScore = score;
+                bestStart = i + 1 - windowDmers;
+            }
+        }
+        // Drain the window so the next epoch starts from zero
+        for (size_t i = (end - begin > windowDmers ? end - windowDmers : begin); i < end; i++) {
+            if (ws.buckets[i] != NO_BUCKET) ws.active[ws.buckets[i]] = 0;
+        }
+        if (bestScore == 0) continue;
+
+        // Chosen dmers stop counting for later epochs
+        for (size_t i = bestStart; i < bestStart + windowDmers; i++) {
+            if (ws.buckets[i] != NO_BUCKET) ws.frequency[ws.buckets[i]] = 0;
+        }
+        ws.segments[chosen++] = {bestStart, bestScore};
+    }
+
+    // Highest scores go last, nearest to the payload
+    std::sort(ws.segments, ws.segments + chosen, [](const Segment& a, const Segment& b) {
+        return a.score != b.score ? a.score > b.score : a.start < b.start;
+    });
+    size_t tail = capacity;
+    for (size_t i = 0; i < chosen && tail > 0; i++) {
+        const size_t length = std::min<size_t>(k, tail);
+        tail -= length;
+        memcpy(dictionary + tail, ws.corpus + ws.segments[i].start, length);
+    }
+
+    const size_t size = capacity - tail;
+    if (tail != 0) memmove(dictionary, dictionary + tail, size);
+    return size;
+}
+
+} // namespace bakingapp::cache
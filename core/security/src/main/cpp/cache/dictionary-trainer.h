@@ -0,0 +1,35 @@
+/**
+ * Preset-dictionary trainer for small, repetitive JSON payloads.
+ *
+ * Follows the COVER approach: every d-byte substring (dmer) is scored by the
+ * number of samples containing it, the corpus is split into epochs and the
+ * best-scoring k-byte segment of each epoch is kept. Dmers already covered
+ * by a chosen segment stop scoring, so later picks add new content.
+ *
+ * Deflate encodes short distances in fewer bits, so the best segments are
+ * placed at the end of the dictionary, closest to the data.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::cache {
+
+struct DictionaryParams {
+    uint32_t segmentSize = 256;   // k
+    uint32_t dmerSize = 8;        // d, 4..16
+};
+
+/**
+ * Trains a dictionary of at most capacity bytes from count samples.
+ *
+ * @return the number of bytes written to dictionary, 0 if the samples are
+ *         too small to train on
+ */
+size_t trainDictionary(const uint8_t* const* samples, const size_t* sizes, size_t count,
+                       uint8_t* dictionary, size_t capacity,
+                       const DictionaryParams& params = DictionaryParams());
+
+} // namespace bakingapp::cache
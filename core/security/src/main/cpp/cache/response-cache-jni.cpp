@@ -0,0 +1,174 @@
+/**
+ * JNI bridge for the compressed offline response cache
+ *
+ * Reads decompress straight into a direct ByteBuffer allocated by the
+ * caller, which the network layer wraps as a response body for the
+ * Retrofit converter without another Java-heap copy.
+ */
+
+#include <jni.h>
+
+#include "cache/response-cache.h"
+#include "common/native-memory.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::cache::ResponseCache;
+using bakingapp::cache::ResponseCacheStats;
+
+namespace {
+    ResponseCache* fromHandle(jlong handle) {
+        return reinterpret_cast<ResponseCache*>(handle);
+    }
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativeOpen(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring directory,
+        jint capacity
+) {
+    if (directory == nullptr || capacity <= 0) return 0;
+
+    const char* path = env->GetStringUTFChars(directory, nullptr);
+    if (path == nullptr) return 0;
+    auto* cache = bakingapp::createTagged<ResponseCache>(MemoryTag::CACHES);
+    bool opened = cache != nullptr && cache->open(path, static_cast<uint32_t>(capacity));
+    env->ReleaseStringUTFChars(directory, path);
+
+    if (!opened) {
+        bakingapp::destroyTagged(cache);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(cache);
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativeClose(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    bakingapp::destroyTagged(fromHandle(handle));
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativeKeyFor(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring url
+) {
+    if (url == nullptr) return 0;
+    const char* chars = env->GetStringUTFChars(url, nullptr);
+    if (chars == nullptr) return 0;
+    jsize length = env->GetStringUTFLength(url);
+    uint64_t key = ResponseCache::keyFor(chars, static_cast<size_t>(length));
+    env->ReleaseStringUTFChars(url, chars);
+    return static_cast<jlong>(key);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativePut(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jlong key,
+        jbyteArray body
+) {
+    ResponseCache* cache = fromHandle(handle);
+    if (cache == nullptr || body == nullptr) return JNI_FALSE;
+
+    // Not a critical section: compressing a large body would stall the GC
+    jsize length = env->GetArrayLength(body);
+    jbyte* bytes = env->GetByteArrayElements(body, nullptr);
+    if (bytes == nullptr) return JNI_FALSE;
+    bool stored = cache->put(static_cast<uint64_t>(key), bytes, static_cast<size_t>(length));
+    env->ReleaseByteArrayElements(body, bytes, JNI_ABORT);
+    return stored ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return the uncompressed size of the cached body, or -1 on a miss
+ */
+JNIEXPORT jint JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativeLookup(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle,
+        jlong key
+) {
+    ResponseCache* cache = fromHandle(handle);
+    uint32_t rawSize = 0;
+    if (cache == nullptr || !cache->lookup(static_cast<uint64_t>(key), &rawSize)) return -1;
+    return static_cast<jint>(rawSize);
+}
+
+/**
+ * Decompresses a cached body into a direct buffer of at least the size
+ * reported by nativeLookup
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativeRead(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jlong key,
+        jobject buffer
+) {
+    ResponseCache* cache = fromHandle(handle);
+    if (cache == nullptr || buffer == nullptr) return JNI_FALSE;
+
+    void* address = env->GetDirectBufferAddress(buffer);
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (address == nullptr || capacity < 0) return JNI_FALSE;
+    return cache->read(static_cast<uint64_t>(key), address, static_cast<size_t>(capacity))
+        ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativeRemove(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle,
+        jlong key
+) {
+    ResponseCache* cache = fromHandle(handle);
+    return cache != nullptr && cache->remove(static_cast<uint64_t>(key)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativeClear(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    ResponseCache* cache = fromHandle(handle);
+    if (cache != nullptr) cache->clear();
+}
+
+/**
+ * @return [entries, rawBytes, compressedBytes, fileBytes, dictionaryId]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_cache_NativeResponseCache_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    ResponseCache* cache = fromHandle(handle);
+    ResponseCacheStats stats = cache != nullptr ? cache->stats() : ResponseCacheStats{};
+    const jlong values[] = {
+        static_cast<jlong>(stats.entries),
+        static_cast<jlong>(stats.rawBytes),
+        static_cast<jlong>(stats.compressedBytes),
+        static_cast<jlong>(stats.fileBytes),
+        static_cast<jlong>(stats.dictionaryId),
+    };
+    jlongArray result = env->NewLongArray(5);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+} // extern "C"
@@ -0,0 +1,621 @@
+#include "cache/response-cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache/dictionary-trainer.h"
+#include "common/hash.h"
+#include "common/native-memory.h"
+
+namespace bakingapp::cache {
+
+namespace {
+    constexpr uint32_t DATA_MAGIC = 0x424B5244;     // "BKRD"
+    constexpr uint32_t RECORD_MAGIC = 0x424B5252;   // "BKRR"
+    constexpr uint32_t DATA_VERSION = 1;
+
+    // Raw deflate: the record header carries sizes and a content hash, so
+    // the zlib wrapper and its checksum would only add bytes.
+    constexpr int WINDOW_BITS = -15;
+    constexpr int MEMORY_LEVEL = 9;
+    constexpr size_t CHUNK_SIZE = 16 * 1024;
+    constexpr uint64_t COMPACTION_MIN_BYTES = 1 << 20;
+    constexpr uint32_t MAX_TRAINING_SAMPLES = 64;
+
+    struct DataHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t generation;
+    };
+
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t dictionaryId;
+        uint32_t rawSize;
+        uint32_t compressedSize;
+        uint64_t content;
+    };
+
+    struct Location {
+        uint64_t offset;
+        uint64_t length;
+        uint64_t target;
+    };
+
+    inline uint64_t contentHash(const void* data, size_t length) {
+        uint64_t hash = hash64(data, length);
+        return hash == 0 ? 1 : hash;
+    }
+
+    inline uint32_t dictionaryIdFor(const void* data, size_t length) {
+        uint32_t id = static_cast<uint32_t>(hash64(data, length, DATA_MAGIC));
+        return id == 0 ? 1 : id;
+    }
+
+    inline uint64_t recordLength(uint32_t compressedSize) {
+        return sizeof(RecordHeader) + compressedSize;
+    }
+
+    // zlib state (about 400 KB for the deflater at MEMORY_LEVEL 9) is
+    // counted with the cache
+    voidpf allocateStream(voidpf /* opaque */, uInt items, uInt size) {
+        return taggedMalloc(MemoryTag::CACHES, static_cast<size_t>(items) * size);
+    }
+
+    void freeStream(voidpf /* opaque */, voidpf block) {
+        taggedFree(block);
+    }
+}
+
+ResponseCache::ResponseCache() {
+    trimHandler_ = addTrimHandler(
+        [](void* context, int level) {
+            auto* cache = static_cast<ResponseCache*>(context);
+            if (level < TRIM_MEMORY_UI_HIDDEN) return;
+            LockGuard lock(cache->mutex_);
+            cache->releaseStreams();
+        },
+        this);
+}
+
+ResponseCache::~ResponseCache() {
+    removeTrimHandler(trimHandler_);
+    close();
+    releaseStreams();
+}
+
+bool ResponseCache::open(const char* directory, uint32_t capacity) {
+    LockGuard lock(mutex_);
+    closeLocked();
+
+    size_t dirLength = strlen(directory);
+    if (dirLength + 32 >= sizeof(directory_)) return false;
+    memcpy(directory_, directory, dirLength + 1);
+    if (!ensureDirectory(directory_) || !ensureStreams()) return false;
+
+    char path[sizeof(directory_) + 32];
+    pathFor("index.bin", path, sizeof(path));
+    if (!index_.open(path, capacity) || !openDataFile()) {
+        closeLocked();
+        return false;
+    }
+    loadDictionary();
+    dropForeignRecords();
+    return true;
+}
+
+void ResponseCache::close() {
+    LockGuard lock(mutex_);
+    closeLocked();
+}
+
+void ResponseCache::closeLocked() {
+    index_.close();
+    if (dataFd_ >= 0) {
+        ::close(dataFd_);
+        dataFd_ = -1;
+    }
+    taggedFree(dictionary_);
+    dictionary_ = nullptr;
+    dictionarySize_ = 0;
+    dictionaryId_ = 0;
+}
+
+bool ResponseCache::ensureStreams() {
+    if (streamsReady_) return true;
+    if (chunk_ == nullptr) {
+        chunk_ = static_cast<uint8_t*>(taggedMalloc(MemoryTag::CACHES, CHUNK_SIZE));
+        if (chunk_ == nullptr) return false;
+    }
+    deflater_ = {};
+    deflater_.zalloc = allocateStream;
+    deflater_.zfree = freeStream;
+    inflater_ = {};
+    inflater_.zalloc = allocateStream;
+    inflater_.zfree = freeStream;
+    if (deflateInit2(&deflater_, Z_BEST_COMPRESSION, Z_DEFLATED, WINDOW_BITS, MEMORY_LEVEL,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    if (inflateInit2(&inflater_, WINDOW_BITS) != Z_OK) {
+        deflateEnd(&deflater_);
+        return false;
+    }
+    streamsReady_ = true;
+    return true;
+}
+
+void ResponseCache::releaseStreams() {
+    if (streamsReady_) {
+        deflateEnd(&deflater_);
+        inflateEnd(&inflater_);
+        streamsReady_ = false;
+    }
+    taggedFree(chunk_);
+    chunk_ = nullptr;
+}
+
+void ResponseCache::pathFor(const char* name, char* out, size_t outSize) const {
+    snprintf(out, outSize, "%s/%s", directory_, name);
+}
+
+bool ResponseCache::openDataFile() {
+    char path[sizeof(directory_) + 32];
+    pathFor("responses.dat", path, sizeof(path));
+    dataFd_ = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (dataFd_ < 0) return false;
+
+    // The index and data file must come from the same compaction
+    // generation; anything else means a crash between the two and the
+    // whole cache is dropped.
+    struct stat st {};
+    DataHeader header {};
+    const Counters& counters = index_.extra();
+    if (fstat(dataFd_, &st) == 0 && static_cast<uint64_t>(st.st_size) >= counters.dataEnd &&
+        counters.dataEnd >= sizeof(DataHeader) &&
+        readFully(dataFd_, &header, sizeof(header), 0) && header.magic == DATA_MAGIC &&
+        header.version == DATA_VERSION && header.generation == counters.generation) {
+        return true;
+    }
+    resetLocked();
+    return index_.extra().dataEnd != 0;
+}
+
+void ResponseCache::resetLocked() {
+    index_.clear();
+    Counters& counters = index_.extra();
+    counters.generation++;
+    counters.dataEnd = 0;
+    counters.compactCheck = 0;
+
+    const DataHeader header {DATA_MAGIC, DATA_VERSION, counters.generation};
+    if (ftruncate(dataFd_, 0) == 0 && writeFully(dataFd_, &header, sizeof(header), 0)) {
+        counters.dataEnd = sizeof(header);
+    }
+}
+
+void ResponseCache::loadDictionary() {
+    char path[sizeof(directory_) + 32];
+    pathFor("dictionary.bin", path, sizeof(path));
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0 &&
+        static_cast<size_t>(st.st_size) <= DICTIONARY_CAPACITY) {
+        const size_t size = static_cast<size_t>(st.st_size);
+        auto* data = static_cast<uint8_t*>(taggedMalloc(MemoryTag::CACHES, size));
+        if (data != nullptr && readFully(fd, data, size, 0)) {
+            dictionary_ = data;
+            dictionarySize_ = size;
+            dictionaryId_ = dictionaryIdFor(data, size);
+        } else {
+            taggedFree(data);
+        }
+    }
+    ::close(fd);
+}
+
+bool ResponseCache::installDictionary(const uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0 || length > DICTIONARY_CAPACITY) return false;
+
+    auto* copy = static_cast<uint8_t*>(taggedMalloc(MemoryTag::CACHES, length));
+    if (copy == nullptr) return false;
+    memcpy(copy, data, length);
+
+    char path[sizeof(directory_) + 32];
+    pathFor("dictionary.bin", path, sizeof(path));
+    if (!writeFileAtomically(path, copy, length)) {
+        taggedFree(copy);
+        return false;
+    }
+    taggedFree(dictionary_);
+    dictionary_ = copy;
+    dictionarySize_ = length;
+    dictionaryId_ = dictionaryIdFor(copy, length);
+    dropForeignRecords();
+    return true;
+}
+
+void ResponseCache::dropForeignRecords() {
+    // Records written with a dictionary we no longer have cannot be decoded
+    const uint32_t used = index_.count();
+    if (used == 0) return;
+    auto* keys = static_cast<uint64_t*>(taggedMalloc(MemoryTag::CACHES, used * sizeof(uint64_t)));
+    if (keys == nullptr) return;
+    uint32_t n = 0;
+    index_.forEach([&](const Slot& slot) {
+        if (slot.dictionaryId != 0 && slot.dictionaryId != dictionaryId_) keys[n++] = slot.key;
+    });
+    for (uint32_t i = 0; i < n; i++) index_.erase(keys[i]);
+    taggedFree(keys);
+}
+
+uint64_t ResponseCache::keyFor(const char* url, size_t length) {
+    uint64_t key = hash64(url, length);
+    return key == 0 ? 1 : key;
+}
+
+void ResponseCache::evictOldest() {
+    const uint32_t used = index_.count();
+    if (used == 0) return;
+
+    auto* ages = static_cast<uint64_t*>(taggedMalloc(MemoryTag::CACHES, used * sizeof(uint64_t)));
+    if (ages == nullptr) return;
+    uint32_t n = 0;
+    index_.forEach([&](const Slot& slot) { ages[n++] = slot.lastUse; });
+    const uint32_t evictCount = std::max<uint32_t>(1, index_.capacity() / 4);
+    const uint32_t cut = std::min(evictCount, n) - 1;
+    std::nth_element(ages, ages + cut, ages + n);
+    const uint64_t threshold = ages[cut];
+
+    // Records stay in the data file until the next compaction
+    n = 0;
+    index_.forEach([&](const Slot& slot) {
+        if (slot.lastUse <= threshold) ages[n++] = slot.key;
+    });
+    for (uint32_t v = 0; v < n; v++) index_.erase(ages[v]);
+    taggedFree(ages);
+}
+
+bool ResponseCache::put(uint64_t key, const void* body, size_t length) {
+    if (key == 0 || body == nullptr || length == 0 || length > MAX_RESPONSE_BYTES) return false;
+    const uint64_t content = contentHash(body, length);
+
+    LockGuard lock(mutex_);
+    if (dataFd_ < 0) return false;
+    Counters& counters = index_.extra();
+
+    Slot* existing = index_.find(key);
+    if (existing != nullptr && existing->content == content) {
+        existing->lastUse = ++counters.clock;
+        return true;
+    }
+
+    // Identical bodies share one record
+    Slot record {};
+    index_.forEach([&](const Slot& slot) {
+        if (record.content == 0 && slot.content == content) record = slot;
+    });
+
+    if (record.content == 0) {
+        if (!ensureStreams()) return false;
+        deflateReset(&deflater_);
+        if (dictionaryId_ != 0 &&
+            deflateSetDictionary(&deflater_, dictionary_, static_cast<uInt>(dictionarySize_)) != Z_OK) {
+            return false;
+        }
+        const size_t bound = deflateBound(&deflater_, static_cast<uLong>(length));
+        auto* buffer = static_cast<uint8_t*>(
+            taggedMalloc(MemoryTag::CACHES, sizeof(RecordHeader) + bound));
+        if (buffer == nullptr) return false;
+
+        deflater_.next_in = static_cast<Bytef*>(const_cast<void*>(body));
+        deflater_.avail_in = static_cast<uInt>(length);
+        deflater_.next_out = buffer + sizeof(RecordHeader);
+        deflater_.avail_out = static_cast<uInt>(bound);
+        if (deflate(&deflater_, Z_FINISH) != Z_STREAM_END) {
+            taggedFree(buffer);
+            return false;
+        }
+        const auto compressed = static_cast<uint32_t>(bound - deflater_.avail_out);
+        const RecordHeader header {RECORD_MAGIC, dictionaryId_, static_cast<uint32_t>(length),
+                                   compressed, content};
+        memcpy(buffer, &header, sizeof(header));
+
+        const uint64_t offset = counters.dataEnd;
+        const bool written = writeFully(dataFd_, buffer, recordLength(compressed), offset);
+        taggedFree(buffer);
+        if (!written) return false;
+        counters.dataEnd += recordLength(compressed);
+
+        record.content = content;
+        record.offset = offset;
+        record.compressedSize = compressed;
+        record.rawSize = static_cast<uint32_t>(length);
+        record.dictionaryId = dictionaryId_;
+    }
+
+    if (existing == nullptr && (index_.count() + 1) * 4 > index_.capacity() * 3) evictOldest();
+    Slot* slot = index_.insert(key);
+    if (slot == nullptr) return false;
+    slot->content = record.content;
+    slot->offset = record.offset;
+    slot->compressedSize = record.compressedSize;
+    slot->rawSize = record.rawSize;
+    slot->dictionaryId = record.dictionaryId;
+    slot->lastUse = ++counters.clock;
+
+    maybeTrain();
+    maybeCompact();
+    return true;
+}
+
+bool ResponseCache::lookup(uint64_t key, uint32_t* rawSize) {
+    LockGuard lock(mutex_);
+    if (dataFd_ < 0) return false;
+    Slot* slot = index_.find(key);
+    if (slot == nullptr) return false;
+    if (rawSize != nullptr) *rawSize = slot->rawSize;
+    return true;
+}
+
+bool ResponseCache::readLocked(Slot* slot, uint8_t* out) {
+    if (slot->dictionaryId != 0 && slot->dictionaryId != dictionaryId_) return false;
+
+    RecordHeader header {};
+    if (!readFully(dataFd_, &header, sizeof(header), slot->offset) ||
+        header.magic != RECORD_MAGIC || header.content != slot->content ||
+        header.rawSize != slot->rawSize || header.compressedSize != slot->compressedSize ||
+        header.dictionaryId != slot->dictionaryId) {
+        return false;
+    }
+
+    inflateReset(&inflater_);
+    if (header.dictionaryId != 0 &&
+        inflateSetDictionary(&inflater_, dictionary_, static_cast<uInt>(dictionarySize_)) != Z_OK) {
+        return false;
+    }
+
+    // Stream the record through a fixed chunk straight into the caller's
+    // buffer; the compressed bytes are never held in full.
+    inflater_.next_out = out;
+    inflater_.avail_out = header.rawSize;
+    inflater_.avail_in = 0;
+    uint64_t position = slot->offset + sizeof(header);
+    uint32_t remaining = header.compressedSize;
+    int status = Z_OK;
+    while (status != Z_STREAM_END) {
+        if (inflater_.avail_in == 0) {
+            if (remaining == 0) return false;
+            const auto n = static_cast<uint32_t>(std::min<size_t>(CHUNK_SIZE, remaining));
+            if (!readFully(dataFd_, chunk_, n, position)) return false;
+            position += n;
+            remaining -= n;
+            inflater_.next_in = chunk_;
+            inflater_.avail_in = n;
+        }
+        status = inflate(&inflater_, Z_NO_FLUSH);
+        if (status != Z_OK && status != Z_STREAM_END) return false;
+    }
+    return inflater_.total_out == header.rawSize &&
+           contentHash(out, header.rawSize) == header.content;
+}
+
+bool ResponseCache::read(uint64_t key, void* out, size_t capacity) {
+    LockGuard lock(mutex_);
+    if (dataFd_ < 0 || out == nullptr) return false;
+    Slot* slot = index_.find(key);
+    if (slot == nullptr || capacity < slot->rawSize || !ensureStreams()) return false;
+    if (!readLocked(slot, static_cast<uint8_t*>(out))) {
+        index_.erase(slot);
+        return false;
+    }
+    slot->lastUse = ++index_.extra().clock;
+    return true;
+}
+
+bool ResponseCache::remove(uint64_t key) {
+    LockGuard lock(mutex_);
+    if (dataFd_ < 0) return false;
+    return index_.erase(key);
+}
+
+void ResponseCache::clear() {
+    LockGuard lock(mutex_);
+    if (dataFd_ >= 0) resetLocked();
+}
+
+bool ResponseCache::setDictionary(const void* data, size_t length) {
+    LockGuard lock(mutex_);
+    if (dataFd_ < 0) return false;
+    return installDictionary(static_cast<const uint8_t*>(data), length);
+}
+
+bool ResponseCache::trainDictionary() {
+    LockGuard lock(mutex_);
+    if (dataFd_ < 0) return false;
+    return trainLocked();
+}
+
+void ResponseCache::maybeTrain() {
+    if (dictionaryId_ == 0 && index_.count() >= TRAINING_SAMPLES) trainLocked();
+}
+
+bool ResponseCache::trainLocked() {
+    if (!ensureStreams()) return false;
+    // Most recently used bodies first, one sample per distinct content
+    Slot candidates[MAX_TRAINING_SAMPLES];
+    uint32_t n = 0;
+    index_.forEach([&](const Slot& slot) {
+        for (uint32_t i = 0; i < n; i++) {
+            if (candidates[i].content == slot.content) return;
+        }
+        if (n < MAX_TRAINING_SAMPLES) {
+            candidates[n++] = slot;
+            return;
+        }
+        auto* oldest = std::min_element(candidates, candidates + n, [](const Slot& a, const Slot& b) {
+            return a.lastUse < b.lastUse;
+        });
+        if (oldest->lastUse < slot.lastUse) *oldest = slot;
+    });
+    if (n == 0) return false;
+
+    uint8_t* samples[MAX_TRAINING_SAMPLES] = {};
+    size_t sizes[MAX_TRAINING_SAMPLES] = {};
+    uint32_t loaded = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        auto* body = static_cast<uint8_t*>(taggedMalloc(MemoryTag::CACHES, candidates[i].rawSize));
+        if (body == nullptr) continue;
+        if (readLocked(&candidates[i], body)) {
+            samples[loaded] = body;
+            sizes[loaded++] = candidates[i].rawSize;
+        } else {
+            taggedFree(body);
+        }
+    }
+
+    bool installed = false;
+    auto* dictionary = static_cast<uint8_t*>(taggedMalloc(MemoryTag::CACHES, DICTIONARY_CAPACITY));
+    if (dictionary != nullptr) {
+        const size_t size = cache::trainDictionary(samples, sizes, loaded, dictionary,
+                                                   DICTIONARY_CAPACITY);
+        installed = size > 0 && installDictionary(dictionary, size);
+    }
+    taggedFree(dictionary);
+    for (uint32_t i = 0; i < loaded; i++) taggedFree(samples[i]);
+    return installed;
+}
+
+uint64_t ResponseCache::liveBytes() {
+    const uint32_t used = index_.count();
+    if (used == 0) return sizeof(DataHeader);
+    auto* offsets = static_cast<Location*>(
+        taggedMalloc(MemoryTag::CACHES, used * sizeof(Location)));
+    if (offsets == nullptr) return index_.extra().dataEnd;
+
+    uint32_t n = 0;
+    index_.forEach([&](const Slot& slot) {
+        offsets[n++] = {slot.offset, recordLength(slot.compressedSize), 0};
+    });
+    std::sort(offsets, offsets + n,
+              [](const Location& a, const Location& b) { return a.offset < b.offset; });
+    uint64_t live = sizeof(DataHeader);
+    for (uint32_t i = 0; i < n; i++) {
+        if (i == 0 || offsets[i].offset != offsets[i - 1].offset) live += offsets[i].length;
+    }
+    taggedFree(offsets);
+    return live;
+}
+
+void ResponseCache::maybeCompact() {
+    // Re-measure live data only when the file has doubled since the last
+    // check, keeping put() amortized O(1) in index scans.
+    Counters& counters = index_.extra();
+    if (counters.dataEnd < std::max<uint64_t>(COMPACTION_MIN_BYTES, counters.compactCheck * 2)) {
+        return;
+    }
+    if (liveBytes() * 2 < counters.dataEnd) {
+        compactLocked();
+    } else {
+        counters.compactCheck = counters.dataEnd;
+    }
+}
+
+bool ResponseCache::compact() {
+    LockGuard lock(mutex_);
+    if (dataFd_ < 0) return false;
+    return compactLocked();
+}
+
+bool ResponseCache::compactLocked() {
+    if (!ensureStreams()) return false;
+    const uint32_t used = index_.count();
+    auto* records = static_cast<Location*>(
+        taggedMalloc(MemoryTag::CACHES, (used + 1) * sizeof(Location)));
+    if (records == nullptr) return false;
+
+    uint32_t n = 0;
+    index_.forEach([&](const Slot& slot) {
+        records[n++] = {slot.offset, recordLength(slot.compressedSize), 0};
+    });
+    std::sort(records, records + n,
+              [](const Location& a, const Location& b) { return a.offset < b.offset; });
+    n = static_cast<uint32_t>(
+        std::unique(records, records + n,
+                    [](const Location& a, const Location& b) { return a.offset == b.offset; }) -
+        records);
+
+    char path[sizeof(directory_) + 32];
+    char tmpPath[sizeof(directory_) + 32];
+    pathFor("responses.dat", path, sizeof(path));
+    pathFor("responses.dat.tmp", tmpPath, sizeof(tmpPath));
+    int fd = ::open(tmpPath, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        taggedFree(records);
+        return false;
+    }
+
+    Counters& counters = index_.extra();
+    const DataHeader header {DATA_MAGIC, DATA_VERSION, counters.generation + 1};
+    bool ok = writeFully(fd, &header, sizeof(header), 0);
+    uint64_t position = sizeof(header);
+    for (uint32_t i = 0; ok && i < n; i++) {
+        records[i].target = position;
+        for (uint64_t copied = 0; ok && copied < records[i].length;) {
+            const size_t chunk = std::min<uint64_t>(CHUNK_SIZE, records[i].length - copied);
+            ok = readFully(dataFd_, chunk_, chunk, records[i].offset + copied) &&
+                 writeFully(fd, chunk_, chunk, position);
+            copied += chunk;
+            position += chunk;
+        }
+    }
+    ok = ok && fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || rename(tmpPath, path) != 0) {
+        unlink(tmpPath);
+        taggedFree(records);
+        return false;
+    }
+
+    // The index now lags the data file by one generation; a crash before
+    // the next lines finish makes open() discard both.
+    ::close(dataFd_);
+    dataFd_ = ::open(path, O_RDWR | O_CLOEXEC);
+    index_.forEach([&](Slot& slot) {
+        const Location* match = std::lower_bound(
+            records, records + n, slot.offset,
+            [](const Location& a, uint64_t offset) { return a.offset < offset; });
+        slot.offset = match->target;
+    });
+    counters.generation = header.generation;
+    counters.dataEnd = position;
+    counters.compactCheck = position;
+    taggedFree(records);
+
+    if (dataFd_ < 0) {
+        index_.clear();
+        return false;
+    }
+    return true;
+}
+
+ResponseCacheStats ResponseCache::stats() {
+    LockGuard lock(mutex_);
+    ResponseCacheStats result {};
+    if (dataFd_ < 0) return result;
+    result.entries = index_.count();
+    result.dictionaryId = dictionaryId_;
+    index_.forEach([&](const Slot& slot) { result.rawBytes += slot.rawSize; });
+    result.compressedBytes = liveBytes();
+    result.fileBytes = index_.extra().dataEnd;
+    return result;
+}
+
+} // namespace bakingapp::cache
@@ -0,0 +1,159 @@
+/**
+ * Compressed, content-addressed on-disk cache for API response bodies.
+ *
+ * Layout inside the cache directory:
+ *   index.bin        mmap'd open-addressing table: URL hash -> record
+ *   responses.dat    append-only log of deflate-compressed records
+ *   dictionary.bin   preset dictionary trained on cached payloads
+ *
+ * Records are addressed by the hash of their uncompressed content, so
+ * identical bodies behind different URLs are stored once. Overwritten
+ * records become garbage that compact() reclaims; put() compacts on its own
+ * once garbage outweighs live data.
+ *
+ * Until TRAINING_SAMPLES responses are cached, bodies are compressed without
+ * a dictionary. The dictionary is then trained from those bodies and used
+ * for every later record; records keep the id of the dictionary they were
+ * written with.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <zlib.h>
+
+#include "common/mapped-hash-table.h"
+#include "common/mutex.h"
+
+namespace bakingapp::cache {
+
+struct ResponseCacheStats {
+    uint32_t entries;
+    uint32_t dictionaryId;       // 0 until a dictionary is trained
+    uint64_t rawBytes;           // uncompressed size of all entries
+    uint64_t compressedBytes;    // live records, shared records counted once
+    uint64_t fileBytes;          // data file including garbage
+};
+
+class ResponseCache {
+public:
+    static constexpr uint32_t DEFAULT_CAPACITY = 1024;
+    static constexpr size_t DICTIONARY_CAPACITY = 16 * 1024;
+    static constexpr uint32_t TRAINING_SAMPLES = 8;
+    static constexpr size_t MAX_RESPONSE_BYTES = 8 << 20;
+
+    /**
+     * Registers a trim handler that frees the zlib streams once the UI is
+     * hidden; the next put() or read() sets them up again
+     */
+    ResponseCache();
+    ~ResponseCache();
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    /**
+     * Opens or creates the cache in directory. capacity is rounded up to a
+     * power of two; an index that does not match the data file is reset.
+     */
+    bool open(const char* directory, uint32_t capacity = DEFAULT_CAPACITY);
+
+    void close();
+
+    static uint64_t keyFor(const char* url, size_t length);
+
+    /**
+     * Stores a response body under key, evicting the least recently used
+     * quarter of the table when it is more than three quarters full
+     */
+    bool put(uint64_t key, const void* body, size_t length);
+
+    /**
+     * Reports the uncompressed size of a cached body
+     */
+    bool lookup(uint64_t key, uint32_t* rawSize);
+
+    /**
+     * Streams a cached body into out, which must hold at least its
+     * uncompressed size. Corrupt or unreadable records are dropped.
+     */
+    bool read(uint64_t key, void* out, size_t capacity);
+
+    bool remove(uint64_t key);
+
+    void clear();
+
+    /**
+     * Replaces the dictionary used for new records. Records written with
+     * an earlier dictionary are dropped.
+     */
+    bool setDictionary(const void* data, size_t length);
+
+    /**
+     * Trains a dictionary from the cached bodies and installs it
+     */
+    bool trainDictionary();
+
+    /**
+     * Rewrites the data file with only the live records
+     */
+    bool compact();
+
+    ResponseCacheStats stats();
+
+private:
+    struct Slot {
+        uint64_t key;
+        uint64_t content;
+        uint64_t offset;
+        uint32_t compressedSize;
+        uint32_t rawSize;
+        uint32_t dictionaryId;
+        uint32_t reserved;
+        uint64_t lastUse;
+    };
+
+    struct Counters {
+        uint64_t clock;
+        uint64_t dataEnd;
+        uint64_t generation;
+        uint64_t compactCheck;
+    };
+
+    using Index = MappedHashTable<Slot, 0x424B5249 /* "BKRI" */, 1, Counters>;
+
+    void closeLocked();
+    bool ensureStreams();
+    void releaseStreams();
+    bool openDataFile();
+    void loadDictionary();
+    bool installDictionary(const uint8_t* data, size_t length);
+    void dropForeignRecords();
+    bool readLocked(Slot* slot, uint8_t* out);
+    void evictOldest();
+    uint64_t liveBytes();
+    void maybeCompact();
+    void maybeTrain();
+    bool compactLocked();
+    bool trainLocked();
+    void resetLocked();
+    void pathFor(const char* name, char* out, size_t outSize) const;
+
+    Mutex mutex_;
+    Index index_;
+    int dataFd_ = -1;
+    char directory_[384] = {};
+
+    uint8_t* dictionary_ = nullptr;
+    size_t dictionarySize_ = 0;
+    uint32_t dictionaryId_ = 0;
+
+    z_stream deflater_ {};
+    z_stream inflater_ {};
+    bool streamsReady_ = false;
+    uint8_t* chunk_ = nullptr;
+    uint32_t trimHandler_ = 0;
+};
+
+} // namespace bakingapp::cache
@@ -0,0 +1,38 @@
+/**
+ * Object allocation without the C++ runtime
+ *
+ * The library links with -nostdlib++, so global operator new/delete are not
+ * available. Long-lived native objects (JNI handles) are created through
+ * these helpers instead: malloc plus placement new, and an explicit
+ * destructor call plus free.
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace bakingapp {
+
+/**
+ * Allocates and constructs a T, or returns nullptr when out of memory
+ */
+template <typename T, typename... Args>
+T* create(Args&&... args) {
+    void* memory = malloc(sizeof(T));
+    if (memory == nullptr) return nullptr;
+    return new (memory) T(std::forward<Args>(args)...);
+}
+
+/**
+ * Destroys and frees an object from create(); nullptr is ignored
+ */
+template <typename T>
+void destroy(T* object) {
+    if (object == nullptr) return;
+    object->~T();
+    free(object);
+}
+
+} // namespace bakingapp
@@ -0,0 +1,74 @@
+#include "common/async-jobs.h"
+
+#include <new>
+
+namespace bakingapp {
+
+namespace {
+    alignas(AsyncJobs) unsigned char sharedStorage[sizeof(AsyncJobs)];
+    pthread_once_t sharedOnce = PTHREAD_ONCE_INIT;
+    AsyncJobs* sharedJobs = nullptr;
+
+    void createShared() {
+        sharedJobs = new (sharedStorage) AsyncJobs(ThreadPool::shared());
+    }
+}
+
+AsyncJobs& AsyncJobs::shared() {
+    pthread_once(&sharedOnce, createShared);
+    return *sharedJobs;
+}
+
+bool AsyncJobs::submit(Job* job) {
+    job->run = runJob;
+    job->owner = this;
+    job->cancelled.store(false, std::memory_order_relaxed);
+    {
+        LockGuard lock(mutex_);
+        Job** bucket = bucketOf(job->id);
+        for (Job* other = *bucket; other != nullptr; other = other->nextInBucket) {
+            if (other->id == job->id) return false;
+        }
+        job->nextInBucket = *bucket;
+        *bucket = job;
+        inFlight_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!pool_.post(job)) {
+        remove(job);
+        return false;
+    }
+    return true;
+}
+
+bool AsyncJobs::cancel(uint64_t id) {
+    LockGuard lock(mutex_);
+    for (Job* job = *bucketOf(id); job != nullptr; job = job->nextInBucket) {
+        if (job->id == id) {
+            job->cancelled.store(true, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AsyncJobs::remove(Job* job) {
+    LockGuard lock(mutex_);
+    for (Job** link = bucketOf(job->id); *link != nullptr; link = &(*link)->nextInBucket) {
+        if (*link == job) {
+            *link = job->nextInBucket;
+            inFlight_.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void AsyncJobs::runJob(Task* task) {
+    auto* job = static_cast<Job*>(task);
+    const JobStatus status = job->isCancelled() ? JobStatus::CANCELLED : job->work(job);
+    // Out of the registry before finish() frees it, so cancel() never sees
+    // a dead job
+    job->owner->remove(job);
+    job->finish(job, status);
+}
+
+} // namespace bakingapp
@@ -0,0 +1,97 @@
+/**
+ * Asynchronous native jobs
+ *
+ * A Job is native work that runs on a pool worker (ThreadPool::post) while
+ * the thread that submitted it returns at once. Each job carries a caller-
+ * chosen id, unique among the jobs in flight, through which cancel() finds
+ * it: a job cancelled before it starts never runs, a running one sees
+ * isCancelled() at its own checkpoints. Whatever happens, finish() is
+ * called exactly once, on the worker, and owns the job from then on.
+ *
+ * The JNI side (jobs/jobs-jni.cpp) turns finish() into one upcall that
+ * completes a Kotlin CompletableDeferred, so no Java thread blocks on the
+ * work.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/mutex.h"
+#include "common/thread-pool.h"
+
+namespace bakingapp {
+
+class AsyncJobs;
+
+enum class JobStatus : int32_t {
+    DONE = 0,
+    FAILED = 1,
+    CANCELLED = 2,
+};
+
+struct Job : Task {
+    uint64_t id = 0;
+
+    /**
+     * The work itself; checks isCancelled() where stopping early is cheap
+     */
+    JobStatus (*work)(Job* job) = nullptr;
+
+    /**
+     * Delivers the outcome and frees the job
+     */
+    void (*finish)(Job* job, JobStatus status) = nullptr;
+
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    std::atomic<bool> cancelled {false};
+    AsyncJobs* owner = nullptr;
+    Job* nextInBucket = nullptr;
+};
+
+class AsyncJobs {
+public:
+    explicit AsyncJobs(ThreadPool& pool) : pool_(pool) {}
+
+    AsyncJobs(const AsyncJobs&) = delete;
+    AsyncJobs& operator=(const AsyncJobs&) = delete;
+
+    /**
+     * Queues job on the pool
+     *
+     * @return false if job->id is already in flight or the pool has no
+     *   workers; finish() is not called then and the caller keeps the job
+     */
+    bool submit(Job* job);
+
+    /**
+     * Flags the job with this id as cancelled
+     *
+     * @return false if no such job is in flight (it may just have finished)
+     */
+    bool cancel(uint64_t id);
+
+    uint32_t inFlight() const { return inFlight_.load(std::memory_order_relaxed); }
+
+    /**
+     * The registry for the shared pool
+     */
+    static AsyncJobs& shared();
+
+private:
+    static constexpr uint32_t BUCKETS = 4096;
+
+    static void runJob(Task* task);
+    Job** bucketOf(uint64_t id) { return &buckets_[hash(id) & (BUCKETS - 1)]; }
+    static uint64_t hash(uint64_t id) { return (id * 0x9E3779B97F4A7C15ULL) >> 32; }
+    void remove(Job* job);
+
+    ThreadPool& pool_;
+    Mutex mutex_;
+    Job* buckets_[BUCKETS] = {};
+    std::atomic<uint32_t> inFlight_ {0};
+};
+
+} // namespace bakingapp
@@ -0,0 +1,43 @@
+/**
+ * Borrowed view of a Java String's bytes, shared by the JNI bridges that
+ * take ids, paths and query text as Strings.
+ */
+
+#pragma once
+
+#include <jni.h>
+
+#include <cstddef>
+
+namespace bakingapp {
+
+/**
+ * Borrows a String's modified UTF-8 bytes for the duration of a call;
+ * a null String reads as empty
+ */
+class JniText {
+public:
+    JniText(JNIEnv* env, jstring text) : env_(env), text_(text) {
+        if (text == nullptr) return;
+        chars_ = env->GetStringUTFChars(text, nullptr);
+        if (chars_ != nullptr) length_ = static_cast<size_t>(env->GetStringUTFLength(text));
+    }
+
+    ~JniText() {
+        if (chars_ != nullptr) env_->ReleaseStringUTFChars(text_, chars_);
+    }
+
+    JniText(const JniText&) = delete;
+    JniText& operator=(const JniText&) = delete;
+
+    const char* chars() const { return chars_; }
+    size_t length() const { return length_; }
+
+private:
+    JNIEnv* env_;
+    jstring text_;
+    const char* chars_ = nullptr;
+    size_t length_ = 0;
+};
+
+} // namespace bakingapp
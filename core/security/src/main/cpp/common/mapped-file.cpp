@@ -0,0 +1,174 @@
+#include "common/mapped-file.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bakingapp {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const char* path, size_t minSize) {
+    close();
+    fd_ = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0) return false;
+
+    struct stat st {};
+    if (fstat(fd_, &st) != 0) {
+        close();
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size < minSize) {
+        if (ftruncate(fd_, static_cast<off_t>(minSize)) != 0) {
+            close();
+            return false;
+        }
+        size = minSize;
+    }
+    if (size == 0) {
+        close();
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(mapping);
+    size_ = size;
+    writable_ = true;
+    return true;
+}
+
+bool MappedFile::openReadOnly(const char* path) {
+    close();
+    fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) return false;
+
+    struct stat st {};
+    if (fstat(fd_, &st) != 0 || st.st_size <= 0) {
+        close();
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(mapping);
+    size_ = size;
+    writable_ = false;
+    return true;
+}
+
+bool MappedFile::resize(size_t newSize) {
+    if (fd_ < 0 || !writable_) return false;
+    if (newSize == size_) return true;
+
+    if (ftruncate(fd_, static_cast<off_t>(newSize)) != 0) return false;
+    munmap(data_, size_);
+    data_ = nullptr;
+
+    void* mapping = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        size_ = 0;
+        return false;
+    }
+    data_ = static_cast<uint8_t*>(mapping);
+    size_ = newSize;
+    return true;
+}
+
+bool MappedFile::sync() {
+    if (data_ == nullptr || !writable_) return false;
+    return msync(data_, size_, MS_SYNC) == 0;
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+    writable_ = false;
+}
+
+bool writeFileAtomically(const char* path, const void* data, size_t length) {
+    char tmpPath[512];
+    int n = snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    if (n <= 0 || static_cast<size_t>(n) >= sizeof(tmpPath)) return false;
+
+    int fd = ::open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return false;
+
+    const auto* p = static_cast<const uint8_t*>(data);
+    size_t remaining = length;
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, p, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            unlink(tmpPath);
+            return false;
+        }
+        p += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    // The data must be on storage before the rename can replace the old file
+    const bool synced = fsync(fd) == 0;
+    ::close(fd);
+    if (!synced) {
+        unlink(tmpPath);
+        return false;
+    }
+    return rename(tmpPath, path) == 0;
+}
+
+bool readFully(int fd, void* out, size_t length, uint64_t offset) {
+    auto* p = static_cast<uint8_t*>(out);
+    while (length > 0) {
+        ssize_t n = pread(fd, p, length, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        offset += static_cast<uint64_t>(n);
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeFully(int fd, const void* data, size_t length, uint64_t offset) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        ssize_t n = pwrite(fd, p, length, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        offset += static_cast<uint64_t>(n);
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool ensureDirectory(const char* path) {
+    if (mkdir(path, 0700) == 0) return true;
+    if (errno != EEXIST) return false;
+    struct stat st {};
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+} // namespace bakingapp
@@ -0,0 +1,79 @@
+/**
+ * Memory-mapped file helper used by the on-disk indexes and caches.
+ *
+ * The mapping is MAP_SHARED, so writes land in the page cache immediately
+ * and survive process death; sync() only adds durability across power loss.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Opens (creating if needed) a read-write mapping of at least minSize bytes.
+     * A smaller existing file is extended with zeros.
+     *
+     * @return false if the file could not be opened, sized or mapped
+     */
+    bool open(const char* path, size_t minSize);
+
+    /**
+     * Opens an existing file read-only. Empty files fail to map.
+     */
+    bool openReadOnly(const char* path);
+
+    /**
+     * Grows the file and remaps it. Existing pointers into the mapping
+     * are invalidated.
+     */
+    bool resize(size_t newSize);
+
+    /**
+     * Flushes dirty pages to storage (msync MS_SYNC)
+     */
+    bool sync();
+
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    int fd_ = -1;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool writable_ = false;
+};
+
+/**
+ * Writes a whole buffer to path via a synced temporary file and rename, so
+ * readers never observe a partially written file, even after power loss.
+ */
+bool writeFileAtomically(const char* path, const void* data, size_t length);
+
+/**
+ * pread()/pwrite() until length bytes are transferred, retrying on EINTR.
+ * A short read at end of file fails.
+ */
+bool readFully(int fd, void* out, size_t length, uint64_t offset);
+bool writeFully(int fd, const void* data, size_t length, uint64_t offset);
+
+/**
+ * Creates a directory if it does not exist yet (single level)
+ */
+bool ensureDirectory(const char* path);
+
+} // namespace bakingapp
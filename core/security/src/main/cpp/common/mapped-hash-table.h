@@ -0,0 +1,211 @@
+/**
+ * Open-addressing hash table stored in a memory-mapped file.
+ *
+ * Slot must be trivially copyable with a `uint64_t key` member; key 0 marks
+ * an empty slot. Linear probing with backward-shift deletion keeps lookups
+ * tombstone-free. The file starts with a small header (magic, version,
+ * capacity, count) followed by a caller-defined Extra struct for
+ * table-wide counters, then the slots.
+ *
+ * Not thread-safe; owners serialize access.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <type_traits>
+#include <unistd.h>
+
+#include "common/mapped-file.h"
+
+namespace bakingapp {
+
+struct NoExtraHeader {};
+
+template <typename Slot, uint32_t MAGIC, uint32_t VERSION, typename Extra = NoExtraHeader>
+class MappedHashTable {
+    static_assert(std::is_trivially_copyable<Slot>::value, "slots are stored in a file");
+    static_assert(std::is_trivially_copyable<Extra>::value, "header is stored in a file");
+
+public:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t count;
+        Extra extra;
+    };
+
+    /**
+     * Opens or creates the table. capacity is rounded up to a power of two;
+     * a file with another magic, version or capacity is reset.
+     */
+    bool open(const char* path, uint32_t capacity) {
+        capacity = roundUpPowerOfTwo(capacity);
+        const size_t size = slotsOffset() + static_cast<size_t>(capacity) * sizeof(Slot);
+        if (!file_.open(path, size)) return false;
+
+        const Header* h = header();
+        if (file_.size() != size || h->magic != MAGIC || h->version != VERSION ||
+            h->capacity != capacity) {
+            if (file_.size() != size && !file_.resize(size)) return false;
+            memset(file_.data(), 0, size);
+            header()->magic = MAGIC;
+            header()->version = VERSION;
+            header()->capacity = capacity;
+        }
+        mask_ = capacity - 1;
+        return true;
+    }
+
+    /**
+     * Opens the table at the capacity its file was created with, if that is
+     * at least minCapacity; otherwise as open(path, minCapacity)
+     */
+    bool openExisting(const char* path, uint32_t minCapacity) {
+        uint32_t capacity = minCapacity;
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            Header stored;
+            if (readFully(fd, &stored, sizeof(stored), 0) && stored.magic == MAGIC &&
+                stored.version == VERSION && stored.capacity > minCapacity) {
+                capacity = stored.capacity;
+            }
+            ::close(fd);
+        }
+        return open(path, capacity);
+    }
+
+    void close() {
+        file_.close();
+        mask_ = 0;
+    }
+
+    bool isOpen() const { return file_.isOpen(); }
+
+    /**
+     * Drops every entry, keeping the file
+     */
+    void clear() {
+        memset(slots(), 0, static_cast<size_t>(capacity()) * sizeof(Slot));
+        header()->count = 0;
+    }
+
+    bool sync() { return file_.sync(); }
+
+    uint32_t capacity() const { return mask_ + 1; }
+    uint32_t count() const { return header()->count; }
+    Extra& extra() { return header()->extra; }
+
+    Slot* find(uint64_t key) {
+        Slot* table = slots();
+        for (uint32_t i = static_cast<uint32_t>(key) & mask_;; i = (i + 1) & mask_) {
+            if (table[i].key == key) return &table[i];
+            if (table[i].key == 0) return nullptr;
+        }
+    }
+
+    /**
+     * Returns the slot for key, claiming an empty one if needed.
+     * New slots are zeroed apart from the key.
+     *
+     * @return nullptr if key is 0 or the table is full
+     */
+    Slot* insert(uint64_t key, bool* inserted = nullptr) {
+        if (key == 0) return nullptr;
+        Slot* table = slots();
+        for (uint32_t i = static_cast<uint32_t>(key) & mask_, probes = 0; probes <= mask_;
+             i = (i + 1) & mask_, probes++) {
+            if (table[i].key == key) {
+                if (inserted != nullptr) *inserted = false;
+                return &table[i];
+            }
+            if (table[i].key == 0) {
+                table[i] = Slot{};
+                table[i].key = key;
+                header()->count++;
+                if (inserted != nullptr) *inserted = true;
+                return &table[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Removes a slot obtained from find()/insert(). Pointers to other slots
+     * may move.
+     */
+    void erase(Slot* slot) {
+        Slot* table = slots();
+        uint32_t hole = static_cast<uint32_t>(slot - table);
+        table[hole] = Slot{};
+        for (uint32_t j = (hole + 1) & mask_; table[j].key != 0; j = (j + 1) & mask_) {
+            const uint32_t home = static_cast<uint32_t>(table[j].key) & mask_;
+            if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+                table[hole] = table[j];
+                table[j] = Slot{};
+                hole = j;
+            }
+        }
+        header()->count--;
+    }
+
+    bool erase(uint64_t key) {
+        Slot* slot = find(key);
+        if (slot == nullptr) return false;
+        erase(slot);
+        return true;
+    }
+
+    /**
+     * Calls f(slot) for every occupied slot. f must not insert or erase.
+     */
+    template <typename F>
+    void forEach(F&& f) {
+        Slot* table = slots();
+        for (uint32_t i = 0; i <= mask_; i++) {
+            if (table[i].key != 0) f(table[i]);
+        }
+    }
+
+    /**
+     * Calls f(slot) for every occupied slot and erases those it returns
+     * true for. f may modify the slots it keeps. An erase can shift a slot
+     * that wrapped around to the start back to the end of the table, so f
+     * may see that slot twice and must give the same answer.
+     */
+    template <typename F>
+    void eraseIf(F&& f) {
+        Slot* table = slots();
+        for (uint32_t i = 0; i <= mask_;) {
+            if (table[i].key != 0 && f(table[i])) {
+                erase(&table[i]);   // a later slot may have moved into i
+            } else {
+                i++;
+            }
+        }
+    }
+
+private:
+    static constexpr size_t slotsOffset() {
+        return (sizeof(Header) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    }
+
+    static uint32_t roundUpPowerOfTwo(uint32_t value) {
+        uint32_t result = 16;
+        while (result < value && result < (1u << 28)) result <<= 1;
+        return result;
+    }
+
+    Header* header() { return reinterpret_cast<Header*>(file_.data()); }
+    const Header* header() const { return reinterpret_cast<const Header*>(file_.data()); }
+    Slot* slots() { return reinterpret_cast<Slot*>(file_.data() + slotsOffset()); }
+
+    MappedFile file_;
+    uint32_t mask_ = 0;
+};
+
+} // namespace bakingapp
@@ -0,0 +1,43 @@
+/**
+ * Minimal pthread-backed mutex and scoped lock.
+ *
+ * Used instead of std::mutex so the native library does not depend on the
+ * libc++ runtime for locking.
+ */
+
+#pragma once
+
+#include <pthread.h>
+
+namespace bakingapp {
+
+class Mutex {
+public:
+    Mutex() { pthread_mutex_init(&mutex_, nullptr); }
+    ~Mutex() { pthread_mutex_destroy(&mutex_); }
+
+    Mutex(const Mutex&) = delete;
+    Mutex& operator=(const Mutex&) = delete;
+
+    void lock() { pthread_mutex_lock(&mutex_); }
+    void unlock() { pthread_mutex_unlock(&mutex_); }
+
+    pthread_mutex_t* native() { return &mutex_; }
+
+private:
+    pthread_mutex_t mutex_;
+};
+
+class LockGuard {
+public:
+    explicit LockGuard(Mutex& mutex) : mutex_(mutex) { mutex_.lock(); }
+    ~LockGuard() { mutex_.unlock(); }
+
+    LockGuard(const LockGuard&) = delete;
+    LockGuard& operator=(const LockGuard&) = delete;
+
+private:
+    Mutex& mutex_;
+};
+
+} // namespace bakingapp
@@ -0,0 +1,53 @@
+/**
+ * JNI bridge for NativeMemoryAccounting
+ *
+ * Reads the per-subsystem counters of common/native-memory.h and forwards
+ * Android's onTrimMemory() level to the registered trim handlers.
+ */
+
+#include <jni.h>
+
+#include "common/native-memory.h"
+
+using bakingapp::MEMORY_TAG_COUNT;
+using bakingapp::MemoryTag;
+using bakingapp::MemoryUsage;
+
+extern "C" {
+
+/**
+ * @return [currentBytes, peakBytes, allocations] per subsystem, in
+ *   MemoryTag order
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_memory_NativeMemoryAccounting_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */
+) {
+    constexpr size_t FIELDS = 3;
+    jlong values[MEMORY_TAG_COUNT * FIELDS];
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+        const MemoryUsage usage = bakingapp::memoryUsage(static_cast<MemoryTag>(i));
+        values[i * FIELDS] = static_cast<jlong>(usage.currentBytes);
+        values[i * FIELDS + 1] = static_cast<jlong>(usage.peakBytes);
+        values[i * FIELDS + 2] = static_cast<jlong>(usage.allocations);
+    }
+    const auto length = static_cast<jsize>(MEMORY_TAG_COUNT * FIELDS);
+    jlongArray result = env->NewLongArray(length);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, length, values);
+    return result;
+}
+
+/**
+ * @return the bytes the handlers released
+ */
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_memory_NativeMemoryAccounting_nativeTrimMemory(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jint level
+) {
+    return static_cast<jlong>(bakingapp::trimMemory(level));
+}
+
+} // extern "C"
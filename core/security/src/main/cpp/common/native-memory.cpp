@@ -0,0 +1,154 @@
+#include "common/native-memory.h"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+namespace bakingapp {
+
+namespace {
+    /**
+     * In front of every tagged block; sized so the block keeps malloc()'s
+     * alignment
+     */
+    struct alignas(alignof(std::max_align_t)) BlockHeader {
+        size_t size;
+        MemoryTag tag;
+    };
+
+    // One cache line per tag: subsystems on different threads do not
+    // contend on each other's counters
+    struct alignas(64) Counters {
+        std::atomic<int64_t> current{0};
+        std::atomic<int64_t> peak{0};
+        std::atomic<uint64_t> allocations{0};
+    };
+
+    Counters counters[MEMORY_TAG_COUNT];
+
+    struct TrimEntry {
+        TrimHandler handler;
+        void* context;
+    };
+
+    pthread_mutex_t trimMutex = PTHREAD_MUTEX_INITIALIZER;
+    TrimEntry trimHandlers[MAX_TRIM_HANDLERS];
+
+    Counters& countersFor(MemoryTag tag) {
+        const auto index = static_cast<size_t>(tag);
+        return counters[index < MEMORY_TAG_COUNT ? index : MEMORY_TAG_COUNT - 1];
+    }
+
+    void grow(MemoryTag tag, int64_t bytes) {
+        Counters& c = countersFor(tag);
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        const int64_t current = c.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        int64_t peak = c.peak.load(std::memory_order_relaxed);
+        while (current > peak &&
+               !c.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+        }
+    }
+
+    void shrink(MemoryTag tag, int64_t bytes) {
+        countersFor(tag).current.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    BlockHeader* headerOf(void* block) {
+        return static_cast<BlockHeader*>(block) - 1;
+    }
+
+    int64_t totalCurrentBytes() {
+        int64_t total = 0;
+        for (const Counters& c : counters) total += c.current.load(std::memory_order_relaxed);
+        return total;
+    }
+}
+
+void* taggedMalloc(MemoryTag tag, size_t size) {
+    if (size > SIZE_MAX - sizeof(BlockHeader)) return nullptr;
+    auto* header = static_cast<BlockHeader*>(malloc(sizeof(BlockHeader) + size));
+    if (header == nullptr) return nullptr;
+    header->size = size;
+    header->tag = tag;
+    grow(tag, static_cast<int64_t>(size));
+    return header + 1;
+}
+
+void* taggedCalloc(MemoryTag tag, size_t count, size_t size) {
+    if (size != 0 && count > (SIZE_MAX - sizeof(BlockHeader)) / size) return nullptr;
+    void* block = taggedMalloc(tag, count * size);
+    if (block != nullptr) memset(block, 0, count * size);
+    return block;
+}
+
+void* taggedRealloc(MemoryTag tag, void* block, size_t size) {
+    if (block == nullptr) return taggedMalloc(tag, size);
+    if (size > SIZE_MAX - sizeof(BlockHeader)) return nullptr;
+    BlockHeader* header = headerOf(block);
+    const size_t previous = header->size;
+    const MemoryTag owner = header->tag;
+    auto* moved = static_cast<BlockHeader*>(realloc(header, sizeof(BlockHeader) + size));
+    if (moved == nullptr) return nullptr;
+    moved->size = size;
+    shrink(owner, static_cast<int64_t>(previous));
+    grow(owner, static_cast<int64_t>(size));
+    return moved + 1;
+}
+
+void taggedFree(void* block) {
+    if (block == nullptr) return;
+    BlockHeader* header = headerOf(block);
+    shrink(header->tag, static_cast<int64_t>(header->size));
+    free(header);
+}
+
+void recordAllocation(MemoryTag tag, size_t bytes) {
+    grow(tag, static_cast<int64_t>(bytes));
+}
+
+void recordRelease(MemoryTag tag, size_t bytes) {
+    shrink(tag, static_cast<int64_t>(bytes));
+}
+
+MemoryUsage memoryUsage(MemoryTag tag) {
+    const Counters& c = countersFor(tag);
+    return {c.current.load(std::memory_order_relaxed), c.peak.load(std::memory_order_relaxed),
+            c.allocations.load(std::memory_order_relaxed)};
+}
+
+uint32_t addTrimHandler(TrimHandler handler, void* context) {
+    uint32_t id = 0;
+    pthread_mutex_lock(&trimMutex);
+    for (uint32_t i = 0; i < MAX_TRIM_HANDLERS; i++) {
+        if (trimHandlers[i].handler == nullptr) {
+            trimHandlers[i] = {handler, context};
+            id = i + 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&trimMutex);
+    return id;
+}
+
+void removeTrimHandler(uint32_t id) {
+    if (id == 0 || id > MAX_TRIM_HANDLERS) return;
+    pthread_mutex_lock(&trimMutex);
+    trimHandlers[id - 1] = {nullptr, nullptr};
+    pthread_mutex_unlock(&trimMutex);
+}
+
+int64_t trimMemory(int level) {
+    pthread_mutex_lock(&trimMutex);
+    const int64_t before = totalCurrentBytes();
+    for (const TrimEntry& entry : trimHandlers) {
+        if (entry.handler != nullptr) entry.handler(entry.context, level);
+    }
+    const int64_t released = before - totalCurrentBytes();
+    pthread_mutex_unlock(&trimMutex);
+    return released;
+}
+
+} // namespace bakingapp
@@ -0,0 +1,138 @@
+/**
+ * Native memory accounting per subsystem, and the memory trim hook
+ *
+ * Subsystems allocate through taggedMalloc() and friends instead of
+ * malloc(), naming the subsystem the memory belongs to. A 16-byte header in
+ * front of each block keeps its size and tag, so taggedFree() needs neither.
+ * Memory that does not come from malloc() (anonymous mappings, over-aligned
+ * blocks) is counted with recordAllocation() and recordRelease().
+ *
+ * Each tag keeps its current bytes, high watermark and allocation count in
+ * relaxed atomics: an allocation costs three uncontended atomic adds, and
+ * a snapshot is only approximately consistent across tags.
+ *
+ * Objects holding caches they can rebuild register a trim handler;
+ * trimMemory(), called from Android's onTrimMemory(), runs them all.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace bakingapp {
+
+/**
+ * Subsystems, in the order of getNativeMemoryStats()
+ */
+enum class MemoryTag : uint8_t {
+    KEYS,           // key blob and derived-key caches
+    PARSERS,        // sync: JSON records, delta table, timestamps
+    INDEXES,        // search, ingredient, facet and similar-recipe indexes
+    CACHES,         // response cache and its dictionary, thumbnail cache
+    IMAGES,         // resize scratch
+    STORE,          // secure store
+    STRINGS,        // string pool
+    TIMERS,         // timer table and journal
+    TELEMETRY,      // event rings and flush buffers
+    RUNTIME,        // thread pool, link emulator, sort scratch
+    COUNT
+};
+
+constexpr size_t MEMORY_TAG_COUNT = static_cast<size_t>(MemoryTag::COUNT);
+
+struct MemoryUsage {
+    int64_t currentBytes;
+    int64_t peakBytes;
+    uint64_t allocations;   // ever made, including reallocations
+};
+
+/**
+ * malloc()/calloc()/realloc()/free() counted against tag. Blocks from these
+ * must only be passed to taggedRealloc() and taggedFree().
+ */
+void* taggedMalloc(MemoryTag tag, size_t size);
+void* taggedCalloc(MemoryTag tag, size_t count, size_t size);
+
+/**
+ * Keeps the tag the block was allocated with; nullptr allocates
+ */
+void* taggedRealloc(MemoryTag tag, void* block, size_t size);
+
+/**
+ * nullptr is ignored
+ */
+void taggedFree(void* block);
+
+/**
+ * For memory the caller sizes itself, e.g. mmap() regions
+ */
+void recordAllocation(MemoryTag tag, size_t bytes);
+void recordRelease(MemoryTag tag, size_t bytes);
+
+MemoryUsage memoryUsage(MemoryTag tag);
+
+/**
+ * create()/destroy() (common/allocation.h) through the tagged allocator
+ */
+template <typename T, typename... Args>
+T* createTagged(MemoryTag tag, Args&&... args) {
+    void* memory = taggedMalloc(tag, sizeof(T));
+    if (memory == nullptr) return nullptr;
+    return new (memory) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void destroyTagged(T* object) {
+    if (object == nullptr) return;
+    object->~T();
+    taggedFree(object);
+}
+
+// ==================== Trimming ====================
+
+/**
+ * Android's ComponentCallbacks2 levels, passed through unchanged
+ */
+constexpr int TRIM_MEMORY_RUNNING_MODERATE = 5;
+constexpr int TRIM_MEMORY_RUNNING_LOW = 10;
+constexpr int TRIM_MEMORY_RUNNING_CRITICAL = 15;
+constexpr int TRIM_MEMORY_UI_HIDDEN = 20;
+constexpr int TRIM_MEMORY_BACKGROUND = 40;
+constexpr int TRIM_MEMORY_MODERATE = 60;
+constexpr int TRIM_MEMORY_COMPLETE = 80;
+
+constexpr uint32_t MAX_TRIM_HANDLERS = 64;
+
+/**
+ * Drops what context can rebuild on demand. Runs on the thread calling
+ * trimMemory(), so it must take context's own lock.
+ */
+using TrimHandler = void (*)(void* context, int level);
+
+/**
+ * Registers a handler until removeTrimHandler(). Register and remove
+ * outside the lock the handler takes: trimMemory() holds the registry
+ * lock while handlers run, which is what makes removal wait for a
+ * running handler.
+ *
+ * @return an ID for removeTrimHandler(), or 0 if MAX_TRIM_HANDLERS are
+ *   registered (the object is then never trimmed)
+ */
+uint32_t addTrimHandler(TrimHandler handler, void* context);
+
+/**
+ * 0 is ignored
+ */
+void removeTrimHandler(uint32_t id);
+
+/**
+ * Runs every handler with level
+ *
+ * @return the bytes released, by the counters
+ */
+int64_t trimMemory(int level);
+
+} // namespace bakingapp
@@ -0,0 +1,411 @@
+#include "common/thread-pool.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <new>
+#include <sched.h>
+#include <unistd.h>
+
+#include "common/native-memory.h"
+
+namespace bakingapp {
+
+namespace {
+    constexpr uint32_t SPINS_BEFORE_SLEEP = 64;
+    constexpr uint32_t SPINS_BEFORE_YIELD = 16;
+    constexpr size_t MAX_CHUNKS = 64;
+    constexpr size_t CHUNKS_PER_THREAD = 4;
+
+    // The Worker of the pool running on this thread, if any
+    thread_local void* currentWorker = nullptr;
+    thread_local uint64_t externalRandom = 0;
+
+    alignas(ThreadPool) unsigned char sharedStorage[sizeof(ThreadPool)];
+    pthread_once_t sharedOnce = PTHREAD_ONCE_INIT;
+    ThreadPool* sharedPool = nullptr;
+    WorkerHooks sharedHooks {};
+    bool sharedHasHooks = false;
+
+    inline uint64_t nextRandom(uint64_t& state) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    /**
+     * cpuinfo_max_freq of cpu in kHz, 0 if unknown
+     */
+    uint64_t maxFrequency(int cpu) {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+        const int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return 0;
+        char text[32];
+        const ssize_t n = read(fd, text, sizeof(text) - 1);
+        close(fd);
+        if (n <= 0) return 0;
+        text[n] = '\0';
+        return strtoull(text, nullptr, 10);
+    }
+
+    struct RangeTask : Task {
+        void (*body)(void* context, size_t from, size_t to);
+        void* context;
+        size_t from;
+        size_t to;
+    };
+
+    void runRange(Task* task) {
+        auto* range = static_cast<RangeTask*>(task);
+        range->body(range->context, range->from, range->to);
+    }
+
+    void startShared() {
+        const uint32_t cores = performanceCoreCount();
+        auto* pool = new (sharedStorage) ThreadPool();
+        pool->start(cores > 1 ? cores - 1 : 1, sharedHasHooks ? &sharedHooks : nullptr);
+        sharedPool = pool;
+    }
+}
+
+uint32_t performanceCoreCount() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        return online > 0 ? static_cast<uint32_t>(online) : 1;
+    }
+
+    uint32_t count = 0;
+    uint64_t slowest = UINT64_MAX;
+    uint64_t fastest = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed)) continue;
+        count++;
+        const uint64_t frequency = maxFrequency(cpu);
+        if (frequency < slowest) slowest = frequency;
+        if (frequency > fastest) fastest = frequency;
+    }
+    if (count == 0) return 1;
+    if (slowest == 0 || slowest == fastest) return count;
+
+    uint32_t faster = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed) && maxFrequency(cpu) > slowest) faster++;
+    }
+    return faster > 0 ? faster : count;
+}
+
+// ==================== WorkDeque ====================
+
+WorkDeque::WorkDeque() : top_(0), bottom_(0) {
+    for (auto& slot : slots_) slot.store(nullptr, std::memory_order_relaxed);
+}
+
+bool WorkDeque::push(Task* task) {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= CAPACITY) return false;
+    slots_[b & (CAPACITY - 1)].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Task* WorkDeque::pop() {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Task* task = slots_[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+        // Last task: race the thieves for it
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+Task* WorkDeque::steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+
+    Task* task = slots_[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+// ==================== ThreadPool ====================
+
+ThreadPool::~ThreadPool() {
+    stop();
+    pthread_cond_destroy(&wake_);
+}
+
+bool ThreadPool::start(uint32_t workerCount, const WorkerHooks* hooks) {
+    if (workers_ != nullptr) return false;
+    stopping_.store(false, std::memory_order_relaxed);
+    hasHooks_ = hooks != nullptr;
+    if (hooks != nullptr) hooks_ = *hooks;
+    if (workerCount == 0) return true;
+
+    // The deques are cache-line aligned, beyond what malloc guarantees
+    void* memory = nullptr;
+    if (posix_memalign(&memory, alignof(Worker), sizeof(Worker) * workerCount) != 0) {
+        return false;
+    }
+    recordAllocation(MemoryTag::RUNTIME, sizeof(Worker) * workerCount);
+    workers_ = static_cast<Worker*>(memory);
+    workersAllocated_ = workerCount;
+    for (uint32_t i = 0; i < workerCount; i++) {
+        Worker* worker = new (&workers_[i]) Worker();
+        worker->pool = this;
+        worker->index = i;
+        worker->random = 0x9E3779B97F4A7C15ULL * (i + 1);
+    }
+
+    // Workers read workerCount_ to pick victims, so publish it first
+    workerCount_ = workerCount;
+    for (uint32_t i = 0; i < workerCount; i++) {
+        if (pthread_create(&workers_[i].thread, nullptr, workerMain, &workers_[i]) != 0) {
+            workerCount_ = i;
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ThreadPool::stop() {
+    if (workers_ == nullptr) return;
+    stopping_.store(true, std::memory_order_seq_cst);
+    {
+        LockGuard lock(sleepMutex_);
+        pthread_cond_broadcast(&wake_);
+    }
+    for (uint32_t i = 0; i < workerCount_; i++) pthread_join(workers_[i].thread, nullptr);
+    for (uint32_t i = 0; i < workerCount_; i++) workers_[i].~Worker();
+    free(workers_);
+    recordRelease(MemoryTag::RUNTIME, sizeof(Worker) * workersAllocated_);
+    workers_ = nullptr;
+    workerCount_ = 0;
+    workersAllocated_ = 0;
+}
+
+ThreadPool& ThreadPool::shared() {
+    pthread_once(&sharedOnce, startShared);
+    return *sharedPool;
+}
+
+void ThreadPool::setSharedHooks(const WorkerHooks& hooks) {
+    sharedHooks = hooks;
+    sharedHasHooks = true;
+}
+
+void ThreadPool::parallelForRange(size_t begin, size_t end, size_t grain, RangeBody body,
+                                  void* context) {
+    if (end <= begin) return;
+    const size_t count = end - begin;
+    if (grain == 0) grain = 1;
+
+    size_t chunks = count / grain;
+    if (chunks > concurrency() * CHUNKS_PER_THREAD) chunks = concurrency() * CHUNKS_PER_THREAD;
+    if (chunks > MAX_CHUNKS) chunks = MAX_CHUNKS;
+    if (chunks <= 1) {
+        body(context, begin, end);
+        return;
+    }
+
+    // Chunk 0 runs here; the rest are offered to the workers
+    RangeTask tasks[MAX_CHUNKS];
+    TaskGroup group(*this);
+    for (size_t i = 1; i < chunks; i++) {
+        tasks[i].run = runRange;
+        tasks[i].body = body;
+        tasks[i].context = context;
+        tasks[i].from = begin + count * i / chunks;
+        tasks[i].to = begin + count * (i + 1) / chunks;
+        group.spawn(&tasks[i]);
+    }
+    body(context, begin, begin + count / chunks);
+    group.wait();
+}
+
+void ThreadPool::submit(Task* task) {
+    auto* self = static_cast<Worker*>(currentWorker);
+    if (self != nullptr && self->pool == this) {
+        if (!self->deque.push(task)) {
+            execute(task);
+            return;
+        }
+    } else {
+        LockGuard lock(queueMutex_);
+        append(injected_, task);
+    }
+    notify();
+}
+
+bool ThreadPool::post(Task* task) {
+    if (workerCount_ == 0) return false;
+    task->group = nullptr;
+    {
+        LockGuard lock(queueMutex_);
+        append(posted_, task);
+    }
+    notify();
+    return true;
+}
+
+void ThreadPool::append(TaskList& list, Task* task) {
+    task->next = nullptr;
+    if (list.tail == nullptr) list.head = task; else list.tail->next = task;
+    list.tail = task;
+    list.size.store(list.size.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+Task* ThreadPool::takeFirst(TaskList& list) {
+    Task* task = list.head;
+    if (task == nullptr) return nullptr;
+    list.head = task->next;
+    if (list.head == nullptr) list.tail = nullptr;
+    list.size.store(list.size.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+    return task;
+}
+
+Task* ThreadPool::take(TaskList& list) {
+    if (list.size.load(std::memory_order_acquire) == 0) return nullptr;
+    LockGuard lock(queueMutex_);
+    return takeFirst(list);
+}
+
+Task* ThreadPool::findWork(Worker* self, bool takePosted) {
+    if (self != nullptr) {
+        if (Task* task = self->deque.pop()) return task;
+    }
+    if (Task* task = take(injected_)) return task;
+    if (workerCount_ == 0) return nullptr;
+
+    if (self == nullptr && externalRandom == 0) {
+        externalRandom = reinterpret_cast<uintptr_t>(&externalRandom) | 1;
+    }
+    const uint64_t random = nextRandom(self != nullptr ? self->random : externalRandom);
+    const uint32_t first = static_cast<uint32_t>(random % workerCount_);
+    for (uint32_t i = 0; i < workerCount_; i++) {
+        Worker& victim = workers_[(first + i) % workerCount_];
+        if (&victim == self) continue;
+        if (Task* task = victim.deque.steal()) return task;
+    }
+    // Background work last, and only on idle workers
+    return takePosted && self != nullptr ? take(posted_) : nullptr;
+}
+
+/**
+ * Wakes one sleeping worker, if any. The epoch bump pairs with the check
+ * in workerLoop() so a worker going to sleep cannot miss new work.
+ */
+void ThreadPool::notify() {
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) == 0) return;
+    LockGuard lock(sleepMutex_);
+    pthread_cond_signal(&wake_);
+}
+
+void ThreadPool::execute(Task* task) {
+    TaskGroup* group = task->group;
+    task->run(task);
+    // The group (and task) may be gone as soon as pending reaches zero; a
+    // posted task may already have freed itself
+    if (group != nullptr) group->pending_.fetch_sub(1, std::memory_order_release);
+}
+
+void* ThreadPool::workerMain(void* argument) {
+    auto* self = static_cast<Worker*>(argument);
+    char name[16];
+    snprintf(name, sizeof(name), "bk-pool-%u", self->index);
+    pthread_setname_np(pthread_self(), name);
+
+    ThreadPool* pool = self->pool;
+    currentWorker = self;
+    if (pool->hasHooks_ && pool->hooks_.onStart != nullptr) {
+        pool->hooks_.onStart(self->index, pool->hooks_.context);
+    }
+    pool->workerLoop(self);
+    if (pool->hasHooks_ && pool->hooks_.onStop != nullptr) {
+        pool->hooks_.onStop(self->index, pool->hooks_.context);
+    }
+    currentWorker = nullptr;
+    return nullptr;
+}
+
+void ThreadPool::workerLoop(Worker* self) {
+    uint32_t idle = 0;
+    while (!stopping_.load(std::memory_order_acquire)) {
+        const uint64_t seen = epoch_.load(std::memory_order_seq_cst);
+        if (Task* task = findWork(self, true)) {
+            execute(task);
+            idle = 0;
+            continue;
+        }
+        if (++idle < SPINS_BEFORE_SLEEP) {
+            if (idle < SPINS_BEFORE_YIELD) cpuRelax(); else sched_yield();
+            continue;
+        }
+
+        LockGuard lock(sleepMutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        if (epoch_.load(std::memory_order_seq_cst) == seen &&
+            !stopping_.load(std::memory_order_seq_cst)) {
+            pthread_cond_wait(&wake_, sleepMutex_.native());
+        }
+        sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+        idle = 0;
+    }
+}
+
+// ==================== TaskGroup ====================
+
+void TaskGroup::spawn(Task* task) {
+    task->group = this;
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    pool_.submit(task);
+}
+
+void TaskGroup::wait() {
+    auto* self = static_cast<ThreadPool::Worker*>(currentWorker);
+    if (self != nullptr && self->pool != &pool_) self = nullptr;
+
+    uint32_t idle = 0;
+    while (pending_.load(std::memory_order_acquire) != 0) {
+        if (Task* task = pool_.findWork(self, false)) {
+            ThreadPool::execute(task);
+            idle = 0;
+            continue;
+        }
+        if (++idle < SPINS_BEFORE_YIELD) cpuRelax(); else sched_yield();
+    }
+}
+
+} // namespace bakingapp
@@ -0,0 +1,224 @@
+/**
+ * Work-stealing thread pool for the native kernels
+ *
+ * Each worker owns a Chase-Lev deque (Le et al., "Correct and Efficient
+ * Work-Stealing for Weak Memory Models", 2013): it pushes and pops tasks
+ * at the bottom, idle workers steal from the top. Threads outside the pool
+ * (JNI callers) submit through a shared injection queue and help run tasks
+ * while they wait, so a pool with no workers still completes everything on
+ * the calling thread.
+ *
+ * Tasks are caller-owned and never allocated by the pool: TaskGroup is the
+ * fork-join primitive, parallelFor() the usual way in, post() the way to
+ * run something in the background without waiting for it. Built on pthreads
+ * and std::atomic only, so it stays within the runtime-free library.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+#include <type_traits>
+
+#include "common/mutex.h"
+
+namespace bakingapp {
+
+class TaskGroup;
+class ThreadPool;
+
+struct Task {
+    void (*run)(Task* task) = nullptr;
+    TaskGroup* group = nullptr;     // nullptr for posted tasks
+    Task* next = nullptr;           // queue link, owned by the pool
+};
+
+/**
+ * Called on each worker thread as it starts and right before it exits,
+ * e.g. to attach it to the JVM
+ */
+struct WorkerHooks {
+    void (*onStart)(uint32_t index, void* context);
+    void (*onStop)(uint32_t index, void* context);
+    void* context;
+};
+
+/**
+ * CPUs this process may run on, leaving out the slowest cluster of a
+ * big.LITTLE part (cpufreq reports different maximum frequencies); on a
+ * uniform or unreadable topology, all of them
+ */
+uint32_t performanceCoreCount();
+
+/**
+ * Chase-Lev deque of fixed capacity. push() and pop() are for the owning
+ * thread only; steal() may be called from any thread.
+ */
+class WorkDeque {
+public:
+    static constexpr int64_t CAPACITY = 1024;
+
+    WorkDeque();
+
+    /**
+     * @return false when full; the caller runs the task itself
+     */
+    bool push(Task* task);
+    Task* pop();
+    Task* steal();
+
+private:
+    alignas(64) std::atomic<int64_t> top_;
+    alignas(64) std::atomic<int64_t> bottom_;
+    alignas(64) std::atomic<Task*> slots_[CAPACITY];
+};
+
+class ThreadPool {
+public:
+    ThreadPool() = default;
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Starts workerCount threads (0 is valid: everything then runs on the
+     * waiting thread)
+     */
+    bool start(uint32_t workerCount, const WorkerHooks* hooks = nullptr);
+
+    /**
+     * Joins the workers. Groups must have finished waiting.
+     */
+    void stop();
+
+    uint32_t workerCount() const { return workerCount_; }
+
+    /**
+     * Threads that run tasks of a group while its owner waits: the workers
+     * plus the waiting thread
+     */
+    uint32_t concurrency() const { return workerCount_ + 1; }
+
+    /**
+     * Runs task on a worker without a group to wait on; the task must stay
+     * alive until it has run and frees itself if needed. Posted tasks are
+     * only picked up by workers, never by a thread waiting on a group, so a
+     * long one cannot stall an unrelated parallelFor caller.
+     *
+     * @return false if the pool has no workers
+     */
+    bool post(Task* task);
+
+    /**
+     * The process-wide pool, started on first use with one worker fewer
+     * than performanceCoreCount(), the caller being the last, but at least
+     * one so posted tasks always run
+     */
+    static ThreadPool& shared();
+
+    /**
+     * Hooks for the shared pool's workers; only effective before its
+     * first use
+     */
+    static void setSharedHooks(const WorkerHooks& hooks);
+
+    /**
+     * Calls body(from, to) over [begin, end) in chunks of at least grain
+     * items, in parallel, and returns when all chunks are done
+     */
+    template <typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F&& body) {
+        using Body = typename std::remove_reference<F>::type;
+        auto invoke = [](void* context, size_t from, size_t to) {
+            (*static_cast<Body*>(context))(from, to);
+        };
+        parallelForRange(begin, end, grain, invoke,
+                         const_cast<void*>(static_cast<const void*>(&body)));
+    }
+
+private:
+    friend class TaskGroup;
+
+    struct Worker {
+        ThreadPool* pool;
+        uint32_t index;
+        uint64_t random;
+        pthread_t thread;
+        WorkDeque deque;
+    };
+
+    using RangeBody = void (*)(void* context, size_t from, size_t to);
+
+    void parallelForRange(size_t begin, size_t end, size_t grain, RangeBody body,
+                          void* context);
+    void submit(Task* task);
+    /**
+     * takePosted is for the worker loop only: a worker waiting on a group
+     * from inside a task must not pick up a long posted job
+     */
+    Task* findWork(Worker* self, bool takePosted);
+    void notify();
+    void workerLoop(Worker* self);
+    static void* workerMain(void* argument);
+
+    static void execute(Task* task);
+
+    Worker* workers_ = nullptr;
+    uint32_t workerCount_ = 0;
+    uint32_t workersAllocated_ = 0;     // workerCount_ drops if a thread fails to start
+    WorkerHooks hooks_ {};
+    bool hasHooks_ = false;
+
+    struct TaskList {
+        Task* head = nullptr;
+        Task* tail = nullptr;
+        std::atomic<uint32_t> size {0};
+    };
+
+    static void append(TaskList& list, Task* task);
+    static Task* takeFirst(TaskList& list);
+    Task* take(TaskList& list);
+
+    // Tasks from threads outside the pool, and posted tasks; unbounded
+    Mutex queueMutex_;
+    TaskList injected_;
+    TaskList posted_;
+
+    // Sleeping workers wait for the epoch to move
+    Mutex sleepMutex_;
+    pthread_cond_t wake_ = PTHREAD_COND_INITIALIZER;
+    std::atomic<uint64_t> epoch_ {0};
+    std::atomic<uint32_t> sleepers_ {0};
+    std::atomic<bool> stopping_ {false};
+};
+
+/**
+ * Fork-join scope: spawn() tasks, then wait() for all of them. The waiting
+ * thread runs queued tasks instead of blocking. Spawned tasks may spawn
+ * into groups of their own.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool_(pool) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * Queues task; it must stay alive until wait() returns
+     */
+    void spawn(Task* task);
+    void wait();
+
+private:
+    friend class ThreadPool;
+
+    ThreadPool& pool_;
+    std::atomic<uint32_t> pending_ {0};
+};
+
+} // namespace bakingapp
@@ -0,0 +1,401 @@
+#include "crypto/chacha20-poly1305.h"
+
+#include <cstring>
+
+#include "crypto/sha256.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bakingapp::crypto {
+
+namespace {
+    inline uint32_t rotl(uint32_t x, int n) {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    inline uint32_t readLittleEndian32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+               static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    inline void writeLittleEndian32(uint8_t* p, uint32_t v) {
+        p[0] = static_cast<uint8_t>(v);
+        p[1] = static_cast<uint8_t>(v >> 8);
+        p[2] = static_cast<uint8_t>(v >> 16);
+        p[3] = static_cast<uint8_t>(v >> 24);
+    }
+
+    inline void quarterRound(uint32_t* x, int a, int b, int c, int d) {
+        x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 16);
+        x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 12);
+        x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 8);
+        x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 7);
+    }
+
+    void initialState(const uint8_t key[CHACHA20_KEY_BYTES], uint32_t counter,
+                      const uint8_t nonce[CHACHA20_NONCE_BYTES], uint32_t state[16]) {
+        state[0] = 0x61707865;      // "expand 32-byte k"
+        state[1] = 0x3320646E;
+        state[2] = 0x79622D32;
+        state[3] = 0x6B206574;
+        for (int i = 0; i < 8; i++) state[4 + i] = readLittleEndian32(key + i * 4);
+        state[12] = counter;
+        for (int i = 0; i < 3; i++) state[13 + i] = readLittleEndian32(nonce + i * 4);
+    }
+
+#if defined(__ARM_NEON) || defined(__SSE2__)
+#if defined(__ARM_NEON)
+    using Lanes = uint32x4_t;
+
+    inline Lanes splat(uint32_t v) { return vdupq_n_u32(v); }
+    inline Lanes add(Lanes a, Lanes b) { return vaddq_u32(a, b); }
+    inline Lanes exclusiveOr(Lanes a, Lanes b) { return veorq_u32(a, b); }
+
+    template <int N>
+    inline Lanes rotl(Lanes x) {
+        return vsliq_n_u32(vshrq_n_u32(x, 32 - N), x, N);
+    }
+
+    inline Lanes counters(uint32_t counter) {
+        static const uint32_t steps[4] = {0, 1, 2, 3};
+        return vaddq_u32(vdupq_n_u32(counter), vld1q_u32(steps));
+    }
+
+    /**
+     * Stores words [i, i + 4) of the four blocks: lane b of x[i + k] is
+     * word i + k of block b, so the 4x4 is transposed first
+     */
+    inline void storeWords(const Lanes* x, uint8_t* out, int i) {
+        const uint32x4x2_t ab = vtrnq_u32(x[i], x[i + 1]);
+        const uint32x4x2_t cd = vtrnq_u32(x[i + 2], x[i + 3]);
+        const Lanes rows[4] = {
+            vcombine_u32(vget_low_u32(ab.val[0]), vget_low_u32(cd.val[0])),
+            vcombine_u32(vget_low_u32(ab.val[1]), vget_low_u32(cd.val[1])),
+            vcombine_u32(vget_high_u32(ab.val[0]), vget_high_u32(cd.val[0])),
+            vcombine_u32(vget_high_u32(ab.val[1]), vget_high_u32(cd.val[1])),
+        };
+        for (int b = 0; b < 4; b++) {
+            vst1q_u8(out + b * CHACHA20_BLOCK_BYTES + i * 4, vreinterpretq_u8_u32(rows[b]));
+        }
+    }
+#else
+    using Lanes = __m128i;
+
+    inline Lanes splat(uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+    inline Lanes add(Lanes a, Lanes b) { return _mm_add_epi32(a, b); }
+    inline Lanes exclusiveOr(Lanes a, Lanes b) { return _mm_xor_si128(a, b); }
+
+    template <int N>
+    inline Lanes rotl(Lanes x) {
+        return _mm_or_si128(_mm_slli_epi32(x, N), _mm_srli_epi32(x, 32 - N));
+    }
+
+    inline Lanes counters(uint32_t counter) {
+        return _mm_add_epi32(splat(counter), _mm_set_epi32(3, 2, 1, 0));
+    }
+
+    inline void storeWords(const Lanes* x, uint8_t* out, int i) {
+        const __m128i ab0 = _mm_unpacklo_epi32(x[i], x[i + 1]);
+        const __m128i ab1 = _mm_unpackhi_epi32(x[i], x[i + 1]);
+        const __m128i cd0 = _mm_unpacklo_epi32(x[i + 2], x[i + 3]);
+        const __m128i cd1 = _mm_unpackhi_epi32(x[i + 2], x[i + 3]);
+        const __m128i rows[4] = {
+            _mm_unpacklo_epi64(ab0, cd0),
+            _mm_unpackhi_epi64(ab0, cd0),
+            _mm_unpacklo_epi64(ab1, cd1),
+            _mm_unpackhi_epi64(ab1, cd1),
+        };
+        for (int b = 0; b < 4; b++) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + b * CHACHA20_BLOCK_BYTES + i * 4),
+                             rows[b]);
+        }
+    }
+#endif
+
+    inline void quarterRound(Lanes* x, int a, int b, int c, int d) {
+        x[a] = add(x[a], x[b]); x[d] = rotl<16>(exclusiveOr(x[d], x[a]));
+        x[c] = add(x[c], x[d]); x[b] = rotl<12>(exclusiveOr(x[b], x[c]));
+        x[a] = add(x[a], x[b]); x[d] = rotl<8>(exclusiveOr(x[d], x[a]));
+        x[c] = add(x[c], x[d]); x[b] = rotl<7>(exclusiveOr(x[b], x[c]));
+    }
+
+    /**
+     * Four blocks from counter, one per lane; the stores assume a
+     * little-endian target, as every Android ABI is
+     */
+    void fourBlocks(const uint32_t state[16], uint32_t counter, uint8_t* out) {
+        Lanes initial[16];
+        for (int i = 0; i < 16; i++) initial[i] = splat(state[i]);
+        initial[12] = counters(counter);
+
+        Lanes x[16];
+        for (int i = 0; i < 16; i++) x[i] = initial[i];
+        for (int round = 0; round < 10; round++) {
+            quarterRound(x, 0, 4, 8, 12);
+            quarterRound(x, 1, 5, 9, 13);
+            quarterRound(x, 2, 6, 10, 14);
+            quarterRound(x, 3, 7, 11, 15);
+            quarterRound(x, 0, 5, 10, 15);
+            quarterRound(x, 1, 6, 11, 12);
+            quarterRound(x, 2, 7, 8, 13);
+            quarterRound(x, 3, 4, 9, 14);
+        }
+        for (int i = 0; i < 16; i++) x[i] = add(x[i], initial[i]);
+        for (int i = 0; i < 16; i += 4) storeWords(x, out, i);
+        secureZero(initial, sizeof(initial));
+        secureZero(x, sizeof(x));
+    }
+#endif
+
+    /**
+     * Poly1305 in radix 2^26 (five 26-bit limbs), so every product fits a
+     * 64-bit multiply on 32-bit ABIs too
+     */
+    class Poly1305 {
+    public:
+        explicit Poly1305(const uint8_t key[32]) {
+            // r is clamped as the RFC requires
+            r_[0] = readLittleEndian32(key + 0) & 0x3FFFFFF;
+            r_[1] = (readLittleEndian32(key + 3) >> 2) & 0x3FFFF03;
+            r_[2] = (readLittleEndian32(key + 6) >> 4) & 0x3FFC0FF;
+            r_[3] = (readLittleEndian32(key + 9) >> 6) & 0x3F03FFF;
+            r_[4] = (readLittleEndian32(key + 12) >> 8) & 0x00FFFFF;
+            for (int i = 0; i < 4; i++) pad_[i] = readLittleEndian32(key + 16 + i * 4);
+        }
+
+        ~Poly1305() { secureZero(this, sizeof(*this)); }
+
+        void update(const uint8_t* data, size_t length) {
+            if (buffered_ > 0) {
+                const size_t take = length < 16 - buffered_ ? length : 16 - buffered_;
+                memcpy(buffer_ + buffered_, data, take);
+                buffered_ += take;
+                data += take;
+                length -= take;
+                if (buffered_ < 16) return;
+                block(buffer_, 1u << 24);
+                buffered_ = 0;
+            }
+            while (length >= 16) {
+                block(data, 1u << 24);
+                data += 16;
+                length -= 16;
+            }
+            if (length > 0) {
+                memcpy(buffer_, data, length);
+                buffered_ = length;
+            }
+        }
+
+        /**
+         * Zero-pads to a 16-byte boundary, as the AEAD construction wants
+         */
+        void padToBlock() {
+            if (buffered_ == 0) return;
+            memset(buffer_ + buffered_, 0, 16 - buffered_);
+            block(buffer_, 1u << 24);
+            buffered_ = 0;
+        }
+
+        void finish(uint8_t tag[16]) {
+            if (buffered_ > 0) {
+                // A short final block gets its 1 bit right after the data
+                buffer_[buffered_] = 1;
+                memset(buffer_ + buffered_ + 1, 0, 16 - buffered_ - 1);
+                block(buffer_, 0);
+                buffered_ = 0;
+            }
+
+            // Fully carry h
+            uint32_t h0 = h_[0], h1 = h_[1], h2 = h_[2], h3 = h_[3], h4 = h_[4];
+            uint32_t c = h1 >> 26; h1 &= 0x3FFFFFF;
+            h2 += c; c = h2 >> 26; h2 &= 0x3FFFFFF;
+            h3 += c; c = h3 >> 26; h3 &= 0x3FFFFFF;
+            h4 += c; c = h4 >> 26; h4 &= 0x3FFFFFF;
+            h0 += c * 5; c = h0 >> 26; h0 &= 0x3FFFFFF;
+            h1 += c;
+
+            // h - p, selected without branching when h >= p
+            uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3FFFFFF;
+            uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3FFFFFF;
+            uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3FFFFFF;
+            uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3FFFFFF;
+            uint32_t g4 = h4 + c - (1u << 26);
+            uint32_t mask = (g4 >> 31) - 1;     // all ones when h >= p
+            g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+            mask = ~mask;
+            h0 = (h0 & mask) | g0;
+            h1 = (h1 & mask) | g1;
+            h2 = (h2 & mask) | g2;
+            h3 = (h3 & mask) | g3;
+            h4 = (h4 & mask) | g4;
+
+            // Back to 32-bit words, plus the pad, mod 2^128
+            h0 = h0 | (h1 << 26);
+            h1 = (h1 >> 6) | (h2 << 20);
+            h2 = (h2 >> 12) | (h3 << 14);
+            h3 = (h3 >> 18) | (h4 << 8);
+            uint64_t f = static_cast<uint64_t>(h0) + pad_[0];
+            writeLittleEndian32(tag + 0, static_cast<uint32_t>(f));
+            f = static_cast<uint64_t>(h1) + pad_[1] + (f >> 32);
+            writeLittleEndian32(tag + 4, static_cast<uint32_t>(f));
+            f = static_cast<uint64_t>(h2) + pad_[2] + (f >> 32);
+            writeLittleEndian32(tag + 8, static_cast<uint32_t>(f));
+            f = static_cast<uint64_t>(h3) + pad_[3] + (f >> 32);
+            writeLittleEndian32(tag + 12, static_cast<uint32_t>(f));
+        }
+
+    private:
+        void block(const uint8_t* m, uint32_t highBit) {
+            const uint32_t r0 = r_[0], r1 = r_[1], r2 = r_[2], r3 = r_[3], r4 = r_[4];
+            const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+
+            uint32_t h0 = h_[0] + (readLittleEndian32(m + 0) & 0x3FFFFFF);
+            uint32_t h1 = h_[1] + ((readLittleEndian32(m + 3) >> 2) & 0x3FFFFFF);
+            uint32_t h2 = h_[2] + ((readLittleEndian32(m + 6) >> 4) & 0x3FFFFFF);
+            uint32_t h3 = h_[3] + ((readLittleEndian32(m + 9) >> 6) & 0x3FFFFFF);
+            uint32_t h4 = h_[4] + ((readLittleEndian32(m + 12) >> 8) | highBit);
+
+            const uint64_t d0 = static_cast<uint64_t>(h0) * r0 + static_cast<uint64_t>(h1) * s4 +
+                                static_cast<uint64_t>(h2) * s3 + static_cast<uint64_t>(h3) * s2 +
+                                static_cast<uint64_t>(h4) * s1;
+            uint64_t d1 = static_cast<uint64_t>(h0) * r1 + static_cast<uint64_t>(h1) * r0 +
+                          static_cast<uint64_t>(h2) * s4 + static_cast<uint64_t>(h3) * s3 +
+                          static_cast<uint64_t>(h4) * s2;
+            uint64_t d2 = static_cast<uint64_t>(h0) * r2 + static_cast<uint64_t>(h1) * r1 +
+                          static_cast<uint64_t>(h2) * r0 + static_cast<uint64_t>(h3) * s4 +
+                          static_cast<uint64_t>(h4) * s3;
+            uint64_t d3 = static_cast<uint64_t>(h0) * r3 + static_cast<uint64_t>(h1) * r2 +
+                          static_cast<uint64_t>(h2) * r1 + static_cast<uint64_t>(h3) * r0 +
+                          static_cast<uint64_t>(h4) * s4;
+            uint64_t d4 = static_cast<uint64_t>(h0) * r4 + static_cast<uint64_t>(h1) * r3 +
+                          static_cast<uint64_t>(h2) * r2 + static_cast<uint64_t>(h3) * r1 +
+                          static_cast<uint64_t>(h4) * r0;
+
+            uint32_t c = static_cast<uint32_t>(d0 >> 26); h0 = static_cast<uint32_t>(d0) & 0x3FFFFFF;
+            d1 += c; c = static_cast<uint32_t>(d1 >> 26); h1 = static_cast<uint32_t>(d1) & 0x3FFFFFF;
+            d2 += c; c = static_cast<uint32_t>(d2 >> 26); h2 = static_cast<uint32_t>(d2) & 0x3FFFFFF;
+            d3 += c; c = static_cast<uint32_t>(d3 >> 26); h3 = static_cast<uint32_t>(d3) & 0x3FFFFFF;
+            d4 += c; c = static_cast<uint32_t>(d4 >> 26); h4 = static_cast<uint32_t>(d4) & 0x3FFFFFF;
+            h0 += c * 5; c = h0 >> 26; h0 &= 0x3FFFFFF;
+            h1 += c;
+
+            h_[0] = h0; h_[1] = h1; h_[2] = h2; h_[3] = h3; h_[4] = h4;
+        }
+
+        uint32_t r_[5];
+        uint32_t h_[5] = {};
+        uint32_t pad_[4];
+        uint8_t buffer_[16];
+        size_t buffered_ = 0;
+    };
+
+    void lengthsBlock(uint64_t aadLength, uint64_t length, uint8_t out[16]) {
+        for (int i = 0; i < 8; i++) {
+            out[i] = static_cast<uint8_t>(aadLength >> (i * 8));
+            out[8 + i] = static_cast<uint8_t>(length >> (i * 8));
+        }
+    }
+
+    void computeTag(const uint8_t key[CHACHA20_KEY_BYTES],
+                    const uint8_t nonce[CHACHA20_NONCE_BYTES], const uint8_t* aad,
+                    size_t aadLength, const uint8_t* ciphertext, size_t length,
+                    uint8_t tag[POLY1305_TAG_BYTES]) {
+        // The one-time Poly1305 key is the first half of block 0
+        uint8_t block0[CHACHA20_BLOCK_BYTES];
+        chacha20Block(key, 0, nonce, block0);
+        Poly1305 mac(block0);
+        secureZero(block0, sizeof(block0));
+
+        if (aadLength > 0) mac.update(aad, aadLength);
+        mac.padToBlock();
+        if (length > 0) mac.update(ciphertext, length);
+        mac.padToBlock();
+        uint8_t lengths[16];
+        lengthsBlock(aadLength, length, lengths);
+        mac.update(lengths, sizeof(lengths));
+        mac.finish(tag);
+    }
+}
+
+void chacha20Block(const uint8_t key[CHACHA20_KEY_BYTES], uint32_t counter,
+                   const uint8_t nonce[CHACHA20_NONCE_BYTES], uint8_t out[CHACHA20_BLOCK_BYTES]) {
+    uint32_t state[16];
+    initialState(key, counter, nonce, state);
+
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+    for (int round = 0; round < 10; round++) {
+        quarterRound(x, 0, 4, 8, 12);
+        quarterRound(x, 1, 5, 9, 13);
+        quarterRound(x, 2, 6, 10, 14);
+        quarterRound(x, 3, 7, 11, 15);
+        quarterRound(x, 0, 5, 10, 15);
+        quarterRound(x, 1, 6, 11, 12);
+        quarterRound(x, 2, 7, 8, 13);
+        quarterRound(x, 3, 4, 9, 14);
+    }
+    for (int i = 0; i < 16; i++) writeLittleEndian32(out + i * 4, x[i] + state[i]);
+    secureZero(state, sizeof(state));
+    secureZero(x, sizeof(x));
+}
+
+void chacha20Blocks(const uint8_t key[CHACHA20_KEY_BYTES], uint32_t counter,
+                    const uint8_t nonce[CHACHA20_NONCE_BYTES], uint8_t* out, size_t count) {
+#if defined(__ARM_NEON) || defined(__SSE2__)
+    if (count >= 4) {
+        uint32_t state[16];
+        initialState(key, counter, nonce, state);
+        for (; count >= 4; count -= 4) {
+            fourBlocks(state, counter, out);
+            counter += 4;
+            out += 4 * CHACHA20_BLOCK_BYTES;
+        }
+        secureZero(state, sizeof(state));
+    }
+#endif
+    for (; count > 0; count--) {
+        chacha20Block(key, counter++, nonce, out);
+        out += CHACHA20_BLOCK_BYTES;
+    }
+}
+
+void chacha20Xor(const uint8_t key[CHACHA20_KEY_BYTES], uint32_t counter,
+                 const uint8_t nonce[CHACHA20_NONCE_BYTES], uint8_t* data, size_t length) {
+    // Four blocks per step, so long messages take the SIMD path
+    uint8_t stream[4 * CHACHA20_BLOCK_BYTES];
+    while (length > 0) {
+        const size_t blocks = length < sizeof(stream) ?
+            (length + CHACHA20_BLOCK_BYTES - 1) / CHACHA20_BLOCK_BYTES : 4;
+        chacha20Blocks(key, counter, nonce, stream, blocks);
+        counter += static_cast<uint32_t>(blocks);
+        const size_t take = length < sizeof(stream) ? length : sizeof(stream);
+        for (size_t i = 0; i < take; i++) data[i] ^= stream[i];
+        data += take;
+        length -= take;
+    }
+    secureZero(stream, sizeof(stream));
+}
+
+void aeadSeal(const uint8_t key[CHACHA20_KEY_BYTES], const uint8_t nonce[CHACHA20_NONCE_BYTES],
+              const uint8_t* aad, size_t aadLength, uint8_t* data, size_t length,
+              uint8_t tag[POLY1305_TAG_BYTES]) {
+    chacha20Xor(key, 1, nonce, data, length);
+    computeTag(key, nonce, aad, aadLength, data, length, tag);
+}
+
+bool aeadOpen(const uint8_t key[CHACHA20_KEY_BYTES], const uint8_t nonce[CHACHA20_NONCE_BYTES],
+              const uint8_t* aad, size_t aadLength, uint8_t* data, size_t length,
+              const uint8_t tag[POLY1305_TAG_BYTES]) {
+    uint8_t expected[POLY1305_TAG_BYTES];
+    computeTag(key, nonce, aad, aadLength, data, length, expected);
+    if (!constantTimeEquals(expected, tag, POLY1305_TAG_BYTES)) return false;
+    chacha20Xor(key, 1, nonce, data, length);
+    return true;
+}
+
+} // namespace bakingapp::crypto
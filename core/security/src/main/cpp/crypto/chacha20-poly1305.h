@@ -0,0 +1,58 @@
+/**
+ * ChaCha20-Poly1305 AEAD (RFC 8439)
+ *
+ * Chosen over AES-GCM because it is constant-time in portable code: the
+ * ARMv7 devices this library still supports have no AES instructions, and
+ * a table-based AES leaks its key through cache timing.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::crypto {
+
+constexpr size_t CHACHA20_KEY_BYTES = 32;
+constexpr size_t CHACHA20_NONCE_BYTES = 12;
+constexpr size_t CHACHA20_BLOCK_BYTES = 64;
+constexpr size_t POLY1305_TAG_BYTES = 16;
+
+/**
+ * One ChaCha20 block: the key stream for (key, counter, nonce)
+ */
+void chacha20Block(const uint8_t key[CHACHA20_KEY_BYTES], uint32_t counter,
+                   const uint8_t nonce[CHACHA20_NONCE_BYTES], uint8_t out[CHACHA20_BLOCK_BYTES]);
+
+/**
+ * count consecutive key stream blocks from counter, four at a time with
+ * NEON or SSE2 (one block per vector lane); the counter wraps as in
+ * chacha20Block()
+ */
+void chacha20Blocks(const uint8_t key[CHACHA20_KEY_BYTES], uint32_t counter,
+                    const uint8_t nonce[CHACHA20_NONCE_BYTES], uint8_t* out, size_t count);
+
+/**
+ * XORs the key stream starting at block counter into data, in place
+ */
+void chacha20Xor(const uint8_t key[CHACHA20_KEY_BYTES], uint32_t counter,
+                 const uint8_t nonce[CHACHA20_NONCE_BYTES], uint8_t* data, size_t length);
+
+/**
+ * Encrypts data in place and writes the tag over (aad, ciphertext). A
+ * nonce must never repeat under the same key.
+ */
+void aeadSeal(const uint8_t key[CHACHA20_KEY_BYTES], const uint8_t nonce[CHACHA20_NONCE_BYTES],
+              const uint8_t* aad, size_t aadLength, uint8_t* data, size_t length,
+              uint8_t tag[POLY1305_TAG_BYTES]);
+
+/**
+ * Checks the tag, then decrypts data in place
+ *
+ * @return false (data untouched) if the tag does not match
+ */
+bool aeadOpen(const uint8_t key[CHACHA20_KEY_BYTES], const uint8_t nonce[CHACHA20_NONCE_BYTES],
+              const uint8_t* aad, size_t aadLength, uint8_t* data, size_t length,
+              const uint8_t tag[POLY1305_TAG_BYTES]);
+
+} // namespace bakingapp::crypto
@@ -0,0 +1,330 @@
+/**
+ * JNI bridge for NativeSessionKeys
+ *
+ * The cache reads the master secret (KeyId::SECRET) straight from the key
+ * registry, so neither it nor any derived subkey is ever a Java object:
+ * Kotlin passes purpose and session IDs in and gets MACs and ciphertext
+ * back.
+ */
+
+#include <jni.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+#include "crypto/derived-key-cache.h"
+#include "crypto/secure-random.h"
+#include "keys/app-keys.h"
+#include "keys/package-verification.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::crypto::CHACHA20_NONCE_BYTES;
+using bakingapp::crypto::DerivedKeyCache;
+using bakingapp::crypto::DerivedKeyStats;
+using bakingapp::crypto::MAX_PURPOSE_LENGTH;
+using bakingapp::crypto::MAX_SESSION_LENGTH;
+using bakingapp::crypto::POLY1305_TAG_BYTES;
+using bakingapp::crypto::SHA256_BYTES;
+using bakingapp::crypto::randomBytes;
+using bakingapp::crypto::secureZero;
+using bakingapp::keys::APP_KEYS;
+using bakingapp::keys::KeyId;
+using bakingapp::taggedFree;
+using bakingapp::taggedMalloc;
+
+namespace {
+    /**
+     * HKDF salt shared with the backend; public, it only separates this
+     * use of the master secret from any other
+     */
+    constexpr uint8_t SUBKEY_SALT[] = {'b', 'a', 'k', 'i', 'n', 'g', 'a', 'p', 'p', '/',
+                                       's', 'e', 's', 's', 'i', 'o', 'n', '/', 'v', '1'};
+
+    constexpr size_t SEAL_OVERHEAD = CHACHA20_NONCE_BYTES + POLY1305_TAG_BYTES;
+
+    DerivedKeyCache* fromHandle(jlong handle) {
+        return reinterpret_cast<DerivedKeyCache*>(handle);
+    }
+
+    size_t readMasterSecret(uint8_t* out, size_t capacity, void* /* context */) {
+        const int32_t slot = bakingapp::keys::findKey(KeyId::SECRET);
+        if (slot < 0) return 0;
+        char decoded[bakingapp::keys::maxKeyLength() + 1];
+        size_t length = APP_KEYS.decode(slot, decoded, sizeof(decoded));
+        if (length > capacity) length = 0;
+        memcpy(out, decoded, length);
+        secureZero(decoded, sizeof(decoded));
+        return length;
+    }
+
+    /**
+     * A purpose or session ID copied out of a Java string (modified UTF-8)
+     */
+    struct Id {
+        char chars[MAX_SESSION_LENGTH + 1];    // GetStringUTFRegion adds a NUL
+        size_t length = 0;
+
+        Id(JNIEnv* env, jstring string, size_t maxLength) {
+            if (string == nullptr) return;
+            const jsize utfLength = env->GetStringUTFLength(string);
+            if (utfLength <= 0 || static_cast<size_t>(utfLength) > maxLength) return;
+            env->GetStringUTFRegion(string, 0, env->GetStringLength(string), chars);
+            length = static_cast<size_t>(utfLength);
+        }
+    };
+
+    /**
+     * A byte array copied to the native heap (null reads as empty), wiped
+     * when released
+     */
+    class NativeBytes {
+    public:
+        NativeBytes(JNIEnv* env, jbyteArray array) {
+            const size_t length =
+                array != nullptr ? static_cast<size_t>(env->GetArrayLength(array)) : 0;
+            data_ = static_cast<uint8_t*>(taggedMalloc(MemoryTag::KEYS, length > 0 ? length : 1));
+            if (data_ == nullptr) return;
+            if (length > 0) {
+                env->GetByteArrayRegion(array, 0, static_cast<jsize>(length),
+                                        reinterpret_cast<jbyte*>(data_));
+            }
+            length_ = length;
+        }
+
+        ~NativeBytes() {
+            if (data_ == nullptr) return;
+            secureZero(data_, length_);
+            taggedFree(data_);
+        }
+
+        NativeBytes(const NativeBytes&) = delete;
+        NativeBytes& operator=(const NativeBytes&) = delete;
+
+        bool isValid() const { return data_ != nullptr; }
+        uint8_t* data() const { return data_; }
+        size_t length() const { return length_; }
+
+    private:
+        uint8_t* data_ = nullptr;
+        size_t length_ = 0;
+    };
+
+    jbyteArray toByteArray(JNIEnv* env, const uint8_t* data, size_t length) {
+        jbyteArray result = env->NewByteArray(static_cast<jsize>(length));
+        if (result != nullptr) {
+            env->SetByteArrayRegion(result, 0, static_cast<jsize>(length),
+                                    reinterpret_cast<const jbyte*>(data));
+        }
+        return result;
+    }
+}
+
+extern "C" {
+
+/**
+ * @return a handle, or 0 if the package check fails or the key slots could
+ *   not be mapped
+ */
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSessionKeys_nativeCreate(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jobject context,
+        jint capacity
+) {
+    if (!bakingapp::keys::verifyPackageName(env, context)) return 0;
+    auto* cache = bakingapp::createTagged<DerivedKeyCache>(MemoryTag::KEYS, 
+        readMasterSecret, nullptr, SUBKEY_SALT, sizeof(SUBKEY_SALT),
+        static_cast<uint32_t>(capacity > 0 ? capacity : DerivedKeyCache::DEFAULT_CAPACITY));
+    if (cache != nullptr && !cache->isValid()) {
+        bakingapp::destroyTagged(cache);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(cache);
+}
+
+/**
+ * @return the HMAC-SHA256 of message, or null for an invalid ID
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSessionKeys_nativeSign(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring purpose,
+        jstring session,
+        jbyteArray message
+) {
+    DerivedKeyCache* cache = fromHandle(handle);
+    if (cache == nullptr || message == nullptr) return nullptr;
+    const Id purposeId(env, purpose, MAX_PURPOSE_LENGTH);
+    const Id sessionId(env, session, MAX_SESSION_LENGTH);
+
+    // Not a critical section: a large body would stall the GC
+    const jsize length = env->GetArrayLength(message);
+    jbyte* bytes = env->GetByteArrayElements(message, nullptr);
+    if (bytes == nullptr) return nullptr;
+    uint8_t mac[SHA256_BYTES];
+    const bool computed = cache->sign(purposeId.chars, purposeId.length, sessionId.chars,
+                                      sessionId.length, bytes, static_cast<size_t>(length), mac);
+    env->ReleaseByteArrayElements(message, bytes, JNI_ABORT);
+    return computed ? toByteArray(env, mac, sizeof(mac)) : nullptr;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSessionKeys_nativeVerify(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring purpose,
+        jstring session,
+        jbyteArray message,
+        jbyteArray mac
+) {
+    DerivedKeyCache* cache = fromHandle(handle);
+    if (cache == nullptr || message == nullptr || mac == nullptr ||
+        env->GetArrayLength(mac) != static_cast<jsize>(SHA256_BYTES)) {
+        return JNI_FALSE;
+    }
+    const Id purposeId(env, purpose, MAX_PURPOSE_LENGTH);
+    const Id sessionId(env, session, MAX_SESSION_LENGTH);
+    uint8_t expected[SHA256_BYTES];
+    env->GetByteArrayRegion(mac, 0, static_cast<jsize>(SHA256_BYTES),
+                            reinterpret_cast<jbyte*>(expected));
+
+    const jsize length = env->GetArrayLength(message);
+    jbyte* bytes = env->GetByteArrayElements(message, nullptr);
+    if (bytes == nullptr) return JNI_FALSE;
+    const bool verified = cache->verify(purposeId.chars, purposeId.length, sessionId.chars,
+                                        sessionId.length, bytes, static_cast<size_t>(length),
+                                        expected);
+    env->ReleaseByteArrayElements(message, bytes, JNI_ABORT);
+    return verified ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return nonce || ciphertext || tag, with a fresh random nonce, or null
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSessionKeys_nativeSeal(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring purpose,
+        jstring session,
+        jbyteArray plaintext,
+        jbyteArray aad
+) {
+    DerivedKeyCache* cache = fromHandle(handle);
+    if (cache == nullptr || plaintext == nullptr) return nullptr;
+    const Id purposeId(env, purpose, MAX_PURPOSE_LENGTH);
+    const Id sessionId(env, session, MAX_SESSION_LENGTH);
+
+    // Laid out as the result: the plaintext is copied in after the nonce
+    // and sealed in place
+    const size_t length = static_cast<size_t>(env->GetArrayLength(plaintext));
+    uint8_t* sealed = static_cast<uint8_t*>(taggedMalloc(MemoryTag::KEYS, length + SEAL_OVERHEAD));
+    if (sealed == nullptr) return nullptr;
+    uint8_t* nonce = sealed;
+    uint8_t* data = sealed + CHACHA20_NONCE_BYTES;
+    env->GetByteArrayRegion(plaintext, 0, static_cast<jsize>(length),
+                            reinterpret_cast<jbyte*>(data));
+    const NativeBytes associated(env, aad);
+
+    jbyteArray result = nullptr;
+    if (associated.isValid() && randomBytes(nonce, CHACHA20_NONCE_BYTES) &&
+        cache->seal(purposeId.chars, purposeId.length, sessionId.chars, sessionId.length, nonce,
+                    associated.data(), associated.length(), data, length, data + length)) {
+        result = toByteArray(env, sealed, length + SEAL_OVERHEAD);
+    }
+    secureZero(sealed, length + SEAL_OVERHEAD);
+    taggedFree(sealed);
+    return result;
+}
+
+/**
+ * @return the plaintext, or null if the input is malformed or forged
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSessionKeys_nativeOpen(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring purpose,
+        jstring session,
+        jbyteArray sealed,
+        jbyteArray aad
+) {
+    DerivedKeyCache* cache = fromHandle(handle);
+    if (cache == nullptr || sealed == nullptr ||
+        static_cast<size_t>(env->GetArrayLength(sealed)) < SEAL_OVERHEAD) {
+        return nullptr;
+    }
+    const Id purposeId(env, purpose, MAX_PURPOSE_LENGTH);
+    const Id sessionId(env, session, MAX_SESSION_LENGTH);
+    const NativeBytes input(env, sealed);
+    const NativeBytes associated(env, aad);
+    if (!input.isValid() || !associated.isValid()) return nullptr;
+
+    const size_t length = input.length() - SEAL_OVERHEAD;
+    uint8_t* data = input.data() + CHACHA20_NONCE_BYTES;
+    if (!cache->open(purposeId.chars, purposeId.length, sessionId.chars, sessionId.length,
+                     input.data(), associated.data(), associated.length(), data, length,
+                     data + length)) {
+        return nullptr;
+    }
+    return toByteArray(env, data, length);
+}
+
+/**
+ * @return the number of subkeys wiped
+ */
+JNIEXPORT jint JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSessionKeys_nativeInvalidate(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring session
+) {
+    DerivedKeyCache* cache = fromHandle(handle);
+    if (cache == nullptr) return 0;
+    const Id sessionId(env, session, MAX_SESSION_LENGTH);
+    return static_cast<jint>(cache->invalidate(sessionId.chars, sessionId.length));
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSessionKeys_nativeClear(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    DerivedKeyCache* cache = fromHandle(handle);
+    if (cache != nullptr) cache->clear();
+}
+
+/**
+ * @return [hits, misses, evictions, size, capacity]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSessionKeys_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    DerivedKeyCache* cache = fromHandle(handle);
+    if (cache == nullptr) return nullptr;
+    const DerivedKeyStats stats = cache->stats();
+    const jlong values[] = {
+        static_cast<jlong>(stats.hits),
+        static_cast<jlong>(stats.misses),
+        static_cast<jlong>(stats.evictions),
+        static_cast<jlong>(stats.size),
+        static_cast<jlong>(stats.capacity),
+    };
+    jlongArray result = env->NewLongArray(5);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+} // extern "C"
@@ -0,0 +1,325 @@
+#include "crypto/derived-key-cache.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <new>
+
+#include "common/hash.h"
+#include "common/native-memory.h"
+
+namespace bakingapp::crypto {
+
+namespace {
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    bool isValidId(const char* purpose, size_t purposeLength, const char* session,
+                   size_t sessionLength) {
+        // The 0x00 separator in the info string keeps (purpose, session)
+        // pairs distinct only if the purpose cannot contain one itself
+        return purpose != nullptr && session != nullptr &&
+               purposeLength > 0 && purposeLength <= MAX_PURPOSE_LENGTH &&
+               sessionLength > 0 && sessionLength <= MAX_SESSION_LENGTH &&
+               memchr(purpose, 0, purposeLength) == nullptr;
+    }
+}
+
+DerivedKeyCache::DerivedKeyCache(MasterSecretSource source, void* context, const uint8_t* salt,
+                                 size_t saltLength, uint32_t capacity)
+    : source_(source), context_(context), salt_(salt), saltLength_(saltLength) {
+    if (capacity == 0) capacity = 1;
+    uint32_t buckets = 1;
+    while (buckets < capacity * 2) buckets <<= 1;
+
+    const size_t entriesOffset = alignUp(sizeof(HmacSha256), alignof(Entry));
+    const size_t bucketsOffset = alignUp(entriesOffset + sizeof(Entry) * capacity,
+                                         alignof(uint32_t));
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t bytes = alignUp(bucketsOffset + sizeof(uint32_t) * buckets, page);
+
+    void* region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1, 0);
+    if (region == MAP_FAILED) return;
+    // Both best effort: RLIMIT_MEMLOCK may be too small, and the keys are
+    // still wiped on every path either way
+    mlock(region, bytes);
+#ifdef MADV_DONTDUMP
+    madvise(region, bytes, MADV_DONTDUMP);
+#endif
+
+    recordAllocation(MemoryTag::KEYS, bytes);
+    region_ = region;
+    regionBytes_ = bytes;
+    auto* base = static_cast<uint8_t*>(region);
+    prk_ = new (base) HmacSha256();
+    entries_ = reinterpret_cast<Entry*>(base + entriesOffset);
+    for (uint32_t i = 0; i < capacity; i++) {
+        new (&entries_[i]) Entry();
+        entries_[i].previous = NONE;
+        entries_[i].nextInBucket = NONE;
+        entries_[i].next = i + 1 < capacity ? i + 1 : NONE;
+    }
+    buckets_ = reinterpret_cast<uint32_t*>(base + bucketsOffset);
+    memset(buckets_, 0xFF, sizeof(uint32_t) * buckets);
+    capacity_ = capacity;
+    bucketMask_ = buckets - 1;
+    free_ = 0;
+
+    // Subkeys and the pseudorandom key go once the app is in the
+    // background; the next use derives them again
+    trimHandler_ = addTrimHandler(
+        [](void* context, int level) {
+            if (level >= TRIM_MEMORY_BACKGROUND) static_cast<DerivedKeyCache*>(context)->clear();
+        },
+        this);
+}
+
+DerivedKeyCache::~DerivedKeyCache() {
+    removeTrimHandler(trimHandler_);
+    if (region_ == nullptr) return;
+    for (uint32_t i = 0; i < capacity_; i++) entries_[i].~Entry();
+    prk_->~HmacSha256();
+    secureZero(region_, regionBytes_);
+    munlock(region_, regionBytes_);
+    munmap(region_, regionBytes_);
+    recordRelease(MemoryTag::KEYS, regionBytes_);
+}
+
+// ==================== Keyed operations ====================
+
+bool DerivedKeyCache::sign(const char* purpose, size_t purposeLength, const char* session,
+                           size_t sessionLength, const void* message, size_t messageLength,
+                           uint8_t mac[SHA256_BYTES]) {
+    HmacSha256 keyed;
+    if (!acquire(purpose, purposeLength, session, sessionLength, Use::MAC, nullptr, &keyed)) {
+        return false;
+    }
+    keyed.update(message, messageLength);
+    keyed.finish(mac);
+    return true;
+}
+
+bool DerivedKeyCache::verify(const char* purpose, size_t purposeLength, const char* session,
+                             size_t sessionLength, const void* message, size_t messageLength,
+                             const uint8_t mac[SHA256_BYTES]) {
+    uint8_t expected[SHA256_BYTES];
+    if (!sign(purpose, purposeLength, session, sessionLength, message, messageLength, expected)) {
+        return false;
+    }
+    const bool matches = constantTimeEquals(expected, mac, SHA256_BYTES);
+    secureZero(expected, sizeof(expected));
+    return matches;
+}
+
+bool DerivedKeyCache::seal(const char* purpose, size_t purposeLength, const char* session,
+                           size_t sessionLength, const uint8_t nonce[CHACHA20_NONCE_BYTES],
+                           const uint8_t* aad, size_t aadLength, uint8_t* data, size_t length,
+                           uint8_t tag[POLY1305_TAG_BYTES]) {
+    uint8_t key[SUBKEY_BYTES];
+    if (!acquire(purpose, purposeLength, session, sessionLength, Use::KEY, key, nullptr)) {
+        return false;
+    }
+    aeadSeal(key, nonce, aad, aadLength, data, length, tag);
+    secureZero(key, sizeof(key));
+    return true;
+}
+
+bool DerivedKeyCache::open(const char* purpose, size_t purposeLength, const char* session,
+                           size_t sessionLength, const uint8_t nonce[CHACHA20_NONCE_BYTES],
+                           const uint8_t* aad, size_t aadLength, uint8_t* data, size_t length,
+                           const uint8_t tag[POLY1305_TAG_BYTES]) {
+    uint8_t key[SUBKEY_BYTES];
+    if (!acquire(purpose, purposeLength, session, sessionLength, Use::KEY, key, nullptr)) {
+        return false;
+    }
+    const bool opened = aeadOpen(key, nonce, aad, aadLength, data, length, tag);
+    secureZero(key, sizeof(key));
+    return opened;
+}
+
+// ==================== Maintenance ====================
+
+uint32_t DerivedKeyCache::invalidate(const char* session, size_t sessionLength) {
+    if (session == nullptr || sessionLength == 0 || sessionLength > MAX_SESSION_LENGTH) return 0;
+    LockGuard lock(mutex_);
+    uint32_t dropped = 0;
+    uint32_t index = head_;
+    while (index != NONE) {
+        Entry& entry = entries_[index];
+        const uint32_t next = entry.next;
+        if (entry.sessionLength == sessionLength &&
+            memcmp(entry.id + entry.purposeLength, session, sessionLength) == 0) {
+            removeFromBucket(index);
+            unlink(index);
+            wipe(index);
+            entry.next = free_;
+            free_ = index;
+            size_--;
+            dropped++;
+        }
+        index = next;
+    }
+    return dropped;
+}
+
+void DerivedKeyCache::clear() {
+    LockGuard lock(mutex_);
+    while (head_ != NONE) {
+        const uint32_t index = head_;
+        removeFromBucket(index);
+        unlink(index);
+        wipe(index);
+        entries_[index].next = free_;
+        free_ = index;
+    }
+    size_ = 0;
+    if (prk_ != nullptr) *prk_ = HmacSha256();
+    hasPrk_ = false;
+}
+
+DerivedKeyStats DerivedKeyCache::stats() {
+    LockGuard lock(mutex_);
+    return {hits_, misses_, evictions_, size_, capacity_};
+}
+
+// ==================== Internals ====================
+
+bool DerivedKeyCache::acquire(const char* purpose, size_t purposeLength, const char* session,
+                              size_t sessionLength, Use use, uint8_t key[SUBKEY_BYTES],
+                              HmacSha256* mac) {
+    if (!isValidId(purpose, purposeLength, session, sessionLength)) return false;
+    // Only the copy is made under the lock; the caller's HMAC or AEAD runs
+    // outside it, on its own stack
+    LockGuard lock(mutex_);
+    const Entry* entry = findOrDerive(purpose, purposeLength, session, sessionLength);
+    if (entry == nullptr) return false;
+    if (use == Use::KEY) {
+        memcpy(key, entry->key, SUBKEY_BYTES);
+    } else {
+        *mac = entry->mac;
+    }
+    return true;
+}
+
+DerivedKeyCache::Entry* DerivedKeyCache::findOrDerive(const char* purpose, size_t purposeLength,
+                                                      const char* session, size_t sessionLength) {
+    if (entries_ == nullptr) return nullptr;
+
+    char id[MAX_PURPOSE_LENGTH + MAX_SESSION_LENGTH];
+    memcpy(id, purpose, purposeLength);
+    memcpy(id + purposeLength, session, sessionLength);
+    const size_t idLength = purposeLength + sessionLength;
+    // Seeded with the split point, so ("ab", "c") and ("a", "bc") differ
+    const uint64_t hash = hash64(id, idLength, purposeLength);
+
+    for (uint32_t index = buckets_[hash & bucketMask_]; index != NONE;
+         index = entries_[index].nextInBucket) {
+        Entry& entry = entries_[index];
+        if (entry.hash == hash && entry.purposeLength == purposeLength &&
+            entry.sessionLength == sessionLength && memcmp(entry.id, id, idLength) == 0) {
+            hits_++;
+            if (index != head_) {
+                unlink(index);
+                pushFront(index);
+            }
+            return &entry;
+        }
+    }
+
+    misses_++;
+    if (!hasPrk_ && !loadPseudorandomKey()) return nullptr;
+
+    uint32_t index = free_;
+    if (index != NONE) {
+        free_ = entries_[index].next;
+        size_++;
+    } else {
+        index = tail_;
+        removeFromBucket(index);
+        unlink(index);
+        wipe(index);
+        evictions_++;
+    }
+
+    Entry& entry = entries_[index];
+    uint8_t info[MAX_PURPOSE_LENGTH + 1 + MAX_SESSION_LENGTH];
+    memcpy(info, purpose, purposeLength);
+    info[purposeLength] = 0;
+    memcpy(info + purposeLength + 1, session, sessionLength);
+    hkdfExpand(*prk_, info, purposeLength + 1 + sessionLength, entry.key, SUBKEY_BYTES);
+    entry.mac = HmacSha256(entry.key, SUBKEY_BYTES);
+    entry.hash = hash;
+    entry.purposeLength = static_cast<uint8_t>(purposeLength);
+    entry.sessionLength = static_cast<uint8_t>(sessionLength);
+    memcpy(entry.id, id, idLength);
+
+    uint32_t& bucket = buckets_[hash & bucketMask_];
+    entry.nextInBucket = bucket;
+    bucket = index;
+    pushFront(index);
+    return &entry;
+}
+
+bool DerivedKeyCache::loadPseudorandomKey() {
+    if (source_ == nullptr) return false;
+    uint8_t master[MAX_MASTER_SECRET_LENGTH];
+    const size_t length = source_(master, sizeof(master), context_);
+    if (length == 0 || length > sizeof(master)) {
+        secureZero(master, sizeof(master));
+        return false;
+    }
+    uint8_t prk[SHA256_BYTES];
+    hkdfExtract(salt_, saltLength_, master, length, prk);
+    *prk_ = HmacSha256(prk, sizeof(prk));
+    secureZero(master, sizeof(master));
+    secureZero(prk, sizeof(prk));
+    hasPrk_ = true;
+    return true;
+}
+
+void DerivedKeyCache::unlink(uint32_t index) {
+    Entry& entry = entries_[index];
+    if (entry.previous != NONE) {
+        entries_[entry.previous].next = entry.next;
+    } else {
+        head_ = entry.next;
+    }
+    if (entry.next != NONE) {
+        entries_[entry.next].previous = entry.previous;
+    } else {
+        tail_ = entry.previous;
+    }
+    entry.previous = NONE;
+    entry.next = NONE;
+}
+
+void DerivedKeyCache::pushFront(uint32_t index) {
+    Entry& entry = entries_[index];
+    entry.previous = NONE;
+    entry.next = head_;
+    if (head_ != NONE) entries_[head_].previous = index;
+    head_ = index;
+    if (tail_ == NONE) tail_ = index;
+}
+
+void DerivedKeyCache::removeFromBucket(uint32_t index) {
+    uint32_t* link = &buckets_[entries_[index].hash & bucketMask_];
+    while (*link != index) link = &entries_[*link].nextInBucket;
+    *link = entries_[index].nextInBucket;
+}
+
+void DerivedKeyCache::wipe(uint32_t index) {
+    Entry& entry = entries_[index];
+    secureZero(entry.key, sizeof(entry.key));
+    entry.mac = HmacSha256();
+    secureZero(entry.id, sizeof(entry.id));
+    entry.hash = 0;
+    entry.purposeLength = 0;
+    entry.sessionLength = 0;
+    entry.nextInBucket = NONE;
+}
+
+} // namespace bakingapp::crypto
@@ -0,0 +1,171 @@
+/**
+ * Per-session, per-purpose subkeys derived from the master secret
+ *
+ * subkey = HKDF-SHA256(salt, master, info = purpose || 0x00 || sessionId)
+ *
+ * The master secret is read through a callback only on the first
+ * derivation and wiped at once; what stays is the HKDF pseudorandom key,
+ * already keyed into an HMAC state, so a derivation is one HMAC over the
+ * short info string. Each subkey is kept likewise pre-keyed for signing.
+ * Derived subkeys sit in a bounded LRU cache
+ * and are only ever used here, by sign()/verify() (HMAC-SHA256) and
+ * seal()/open() (ChaCha20-Poly1305): no key leaves the native heap.
+ *
+ * Key material lives in one mapping that is mlock()ed (best effort, so it
+ * is never swapped to zram) and excluded from core dumps, and every slot is
+ * zeroed when evicted, invalidated or destroyed. The whole cache is cleared
+ * when the app moves to the background (trimMemory()).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/mutex.h"
+#include "crypto/chacha20-poly1305.h"
+#include "crypto/sha256.h"
+
+namespace bakingapp::crypto {
+
+constexpr size_t SUBKEY_BYTES = 32;
+constexpr size_t MAX_PURPOSE_LENGTH = 32;
+constexpr size_t MAX_SESSION_LENGTH = 96;
+constexpr size_t MAX_MASTER_SECRET_LENGTH = 256;
+
+/**
+ * Writes the master secret into out (capacity bytes)
+ *
+ * @return its length, or 0 if it is not available
+ */
+using MasterSecretSource = size_t (*)(uint8_t* out, size_t capacity, void* context);
+
+struct DerivedKeyStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint32_t size;
+    uint32_t capacity;
+};
+
+class DerivedKeyCache {
+public:
+    static constexpr uint32_t DEFAULT_CAPACITY = 64;
+
+    /**
+     * salt is kept by pointer and must outlive the cache (normally a
+     * constant shared with the backend)
+     */
+    DerivedKeyCache(MasterSecretSource source, void* context, const uint8_t* salt,
+                    size_t saltLength, uint32_t capacity = DEFAULT_CAPACITY);
+    ~DerivedKeyCache();
+
+    DerivedKeyCache(const DerivedKeyCache&) = delete;
+    DerivedKeyCache& operator=(const DerivedKeyCache&) = delete;
+
+    /**
+     * False when the slots could not be mapped
+     */
+    bool isValid() const { return entries_ != nullptr; }
+
+    /**
+     * HMAC-SHA256 of message under the (purpose, session) subkey
+     *
+     * @return false for an invalid purpose or session, or no master secret
+     */
+    bool sign(const char* purpose, size_t purposeLength, const char* session,
+              size_t sessionLength, const void* message, size_t messageLength,
+              uint8_t mac[SHA256_BYTES]);
+
+    bool verify(const char* purpose, size_t purposeLength, const char* session,
+                size_t sessionLength, const void* message, size_t messageLength,
+                const uint8_t mac[SHA256_BYTES]);
+
+    /**
+     * Encrypts data in place under the (purpose, session) subkey
+     */
+    bool seal(const char* purpose, size_t purposeLength, const char* session,
+              size_t sessionLength, const uint8_t nonce[CHACHA20_NONCE_BYTES],
+              const uint8_t* aad, size_t aadLength, uint8_t* data, size_t length,
+              uint8_t tag[POLY1305_TAG_BYTES]);
+
+    /**
+     * @return false if the subkey is unavailable or the tag does not match
+     */
+    bool open(const char* purpose, size_t purposeLength, const char* session,
+              size_t sessionLength, const uint8_t nonce[CHACHA20_NONCE_BYTES],
+              const uint8_t* aad, size_t aadLength, uint8_t* data, size_t length,
+              const uint8_t tag[POLY1305_TAG_BYTES]);
+
+    /**
+     * Wipes every subkey of a session, e.g. on logout
+     *
+     * @return the number of subkeys dropped
+     */
+    uint32_t invalidate(const char* session, size_t sessionLength);
+
+    /**
+     * Wipes all subkeys and the pseudorandom key; the next use reads the
+     * master secret again
+     */
+    void clear();
+
+    DerivedKeyStats stats();
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+    struct Entry {
+        uint8_t key[SUBKEY_BYTES];
+        HmacSha256 mac;                 // keyed with key, ready to copy
+        uint64_t hash;
+        uint32_t previous;              // LRU list, most recent first
+        uint32_t next;
+        uint32_t nextInBucket;
+        uint8_t purposeLength;
+        uint8_t sessionLength;
+        char id[MAX_PURPOSE_LENGTH + MAX_SESSION_LENGTH];
+    };
+
+    /**
+     * What a caller needs copied out of the slot under the lock
+     */
+    enum class Use { KEY, MAC };
+
+    bool acquire(const char* purpose, size_t purposeLength, const char* session,
+                 size_t sessionLength, Use use, uint8_t key[SUBKEY_BYTES], HmacSha256* mac);
+    Entry* findOrDerive(const char* purpose, size_t purposeLength, const char* session,
+                        size_t sessionLength);
+    bool loadPseudorandomKey();
+    void unlink(uint32_t index);
+    void pushFront(uint32_t index);
+    void removeFromBucket(uint32_t index);
+    void wipe(uint32_t index);
+
+    MasterSecretSource source_;
+    void* context_;
+    const uint8_t* salt_;
+    size_t saltLength_;
+
+    Mutex mutex_;
+    // Mapped, locked and excluded from dumps: the keyed PRK state, then the
+    // entries, then the bucket heads
+    void* region_ = nullptr;
+    size_t regionBytes_ = 0;
+    HmacSha256* prk_ = nullptr;
+    bool hasPrk_ = false;
+    Entry* entries_ = nullptr;
+    uint32_t* buckets_ = nullptr;
+    uint32_t capacity_ = 0;
+    uint32_t bucketMask_ = 0;
+    uint32_t size_ = 0;
+    uint32_t free_ = NONE;              // unused slots, chained through next
+    uint32_t head_ = NONE;
+    uint32_t tail_ = NONE;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+    uint32_t trimHandler_ = 0;
+};
+
+} // namespace bakingapp::crypto
@@ -0,0 +1,105 @@
+/**
+ * JNI bridge for NativeSecureRandom
+ *
+ * Stateless on the Kotlin side: each Java thread calling in gets its own
+ * native generator (crypto/secure-random.h), so there is no handle and no
+ * lock. Output is copied into the caller's array through a stack buffer
+ * that is wiped afterwards.
+ */
+
+#include <jni.h>
+
+#include <cstdint>
+
+#include "crypto/secure-random.h"
+#include "crypto/sha256.h"
+
+using bakingapp::crypto::RandomStats;
+using bakingapp::crypto::randomBytes;
+using bakingapp::crypto::randomSelfTest;
+using bakingapp::crypto::randomStats;
+using bakingapp::crypto::secureZero;
+using bakingapp::crypto::systemRandom;
+
+namespace {
+    // Bytes generated per copy into the Java array
+    constexpr size_t CHUNK_BYTES = 4096;
+
+    /**
+     * Fills bytes from source in CHUNK_BYTES pieces
+     */
+    bool fill(JNIEnv* env, jbyteArray bytes, bool (*source)(uint8_t*, size_t)) {
+        if (bytes == nullptr) return false;
+        const size_t length = static_cast<size_t>(env->GetArrayLength(bytes));
+        uint8_t chunk[CHUNK_BYTES];
+        bool filled = true;
+        for (size_t offset = 0; offset < length && filled; offset += CHUNK_BYTES) {
+            const size_t n = length - offset < CHUNK_BYTES ? length - offset : CHUNK_BYTES;
+            filled = source(chunk, n);
+            if (filled) {
+                env->SetByteArrayRegion(bytes, static_cast<jsize>(offset), static_cast<jsize>(n),
+                                        reinterpret_cast<const jbyte*>(chunk));
+            }
+        }
+        secureZero(chunk, sizeof(chunk));
+        return filled;
+    }
+}
+
+extern "C" {
+
+/**
+ * Fills bytes from the calling thread's ChaCha20 generator
+ *
+ * @return false if the generator could not be seeded
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSecureRandom_nativeNextBytes(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jbyteArray bytes
+) {
+    return fill(env, bytes, randomBytes) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Fills bytes straight from the kernel, for seeding other generators
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSecureRandom_nativeGenerateSeed(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jbyteArray bytes
+) {
+    return fill(env, bytes, systemRandom) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Runs the SIMD known-answer check and the FIPS 140-2 statistical tests
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSecureRandom_nativeSelfTest(
+        JNIEnv* /* env */,
+        jobject /* thiz */
+) {
+    return randomSelfTest() ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return [generatedBytes, reseeds, forkReseeds], process-wide
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_crypto_NativeSecureRandom_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */
+) {
+    const RandomStats stats = randomStats();
+    const jlong values[3] = {static_cast<jlong>(stats.generatedBytes),
+                             static_cast<jlong>(stats.reseeds),
+                             static_cast<jlong>(stats.forkReseeds)};
+    jlongArray result = env->NewLongArray(3);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 3, values);
+    return result;
+}
+
+} // extern "C"
@@ -0,0 +1,272 @@
+#include "crypto/secure-random.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include "crypto/chacha20-poly1305.h"
+#include "crypto/sha256.h"
+
+namespace bakingapp::crypto {
+
+namespace {
+    // Key stream per refill; the first CHACHA20_KEY_BYTES are the next key
+    constexpr size_t BUFFER_BLOCKS = 8;
+    constexpr size_t BUFFER_BYTES = BUFFER_BLOCKS * CHACHA20_BLOCK_BYTES;
+
+    // Requests this large skip the buffer and get a key stream of their own
+    constexpr size_t BULK_BYTES = 256;
+
+    // Every key is used once, from counter 0, so the nonce can be fixed
+    const uint8_t ZERO_NONCE[CHACHA20_NONCE_BYTES] = {};
+
+    /**
+     * Trivially destructible, so thread_local needs no exit hook from the
+     * C++ runtime; a dead thread's leftovers only predict output that
+     * will never be produced
+     */
+    struct Generator {
+        uint8_t key[CHACHA20_KEY_BYTES];
+        uint8_t buffer[BUFFER_BYTES];
+        size_t available;           // unread bytes at the end of buffer
+        uint64_t sinceReseed;
+        uint64_t forkGeneration;    // forks seen when last seeded
+        bool seeded;
+    };
+
+    thread_local Generator generator;
+
+    std::atomic<uint64_t> forkGeneration {0};
+    std::atomic<uint64_t> generatedBytes {0};
+    std::atomic<uint64_t> reseedCount {0};
+    std::atomic<uint64_t> forkReseedCount {0};
+    pthread_once_t forkHandlerOnce = PTHREAD_ONCE_INIT;
+
+    void onForkChild() {
+        forkGeneration.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void registerForkHandler() {
+        pthread_atfork(nullptr, nullptr, onForkChild);
+    }
+
+    /**
+     * Mixes fresh kernel entropy into the key and drops buffered output.
+     * XORed rather than replaced: the key is never weaker than either.
+     */
+    bool reseed(Generator& g) {
+        uint8_t fresh[CHACHA20_KEY_BYTES];
+        if (!systemRandom(fresh, sizeof(fresh))) return false;
+        for (size_t i = 0; i < CHACHA20_KEY_BYTES; i++) g.key[i] ^= fresh[i];
+        secureZero(fresh, sizeof(fresh));
+        secureZero(g.buffer, sizeof(g.buffer));
+        g.available = 0;
+        g.sinceReseed = 0;
+        return true;
+    }
+
+    /**
+     * Seeds on first use, after fork() and once the byte budget is spent
+     */
+    bool ready(Generator& g) {
+        // Registered before any output exists, so no child can miss it
+        if (!g.seeded) pthread_once(&forkHandlerOnce, registerForkHandler);
+        const uint64_t generation = forkGeneration.load(std::memory_order_relaxed);
+        const bool forked = g.seeded && g.forkGeneration != generation;
+        if (g.seeded && !forked && g.sinceReseed < RESEED_BYTES) return true;
+
+        if (!reseed(g)) return false;
+        g.forkGeneration = generation;
+        g.seeded = true;
+        reseedCount.fetch_add(1, std::memory_order_relaxed);
+        if (forked) forkReseedCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void refill(Generator& g) {
+        chacha20Blocks(g.key, 0, ZERO_NONCE, g.buffer, BUFFER_BLOCKS);
+        memcpy(g.key, g.buffer, CHACHA20_KEY_BYTES);
+        secureZero(g.buffer, CHACHA20_KEY_BYTES);
+        g.available = BUFFER_BYTES - CHACHA20_KEY_BYTES;
+        generatedBytes.fetch_add(BUFFER_BYTES, std::memory_order_relaxed);
+    }
+
+    /**
+     * Hands out buffered bytes, wiping each as it goes
+     */
+    void take(Generator& g, uint8_t* out, size_t length) {
+        while (length > 0) {
+            if (g.available == 0) refill(g);
+            const size_t n = length < g.available ? length : g.available;
+            uint8_t* from = g.buffer + BUFFER_BYTES - g.available;
+            memcpy(out, from, n);
+            secureZero(from, n);
+            g.available -= n;
+            out += n;
+            length -= n;
+        }
+    }
+
+    /**
+     * FIPS 140-2 runs test bounds for runs of 1 to 5 and 6 or more
+     */
+    constexpr uint32_t RUNS_MIN[6] = {2343, 1135, 542, 251, 111, 111};
+    constexpr uint32_t RUNS_MAX[6] = {2657, 1365, 708, 373, 201, 201};
+    constexpr uint32_t LONG_RUN = 26;
+}
+
+bool systemRandom(uint8_t* out, size_t length) {
+    // minSdk 24 predates the getrandom() libc wrapper, hence the raw
+    // syscall; kernels older than 3.17 fall back to /dev/urandom
+#ifdef __NR_getrandom
+    size_t filled = 0;
+    while (filled < length) {
+        const long n = syscall(__NR_getrandom, out + filled, length - filled, 0);
+        if (n > 0) {
+            filled += static_cast<size_t>(n);
+        } else if (errno != EINTR) {
+            break;
+        }
+    }
+    if (filled == length) return true;
+#endif
+    const int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    size_t total = 0;
+    while (total < length) {
+        const ssize_t n = read(fd, out + total, length - total);
+        if (n > 0) {
+            total += static_cast<size_t>(n);
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    close(fd);
+    return total == length;
+}
+
+bool randomBytes(uint8_t* out, size_t length) {
+    Generator& g = generator;
+    if (!ready(g)) return false;
+    if (length < BULK_BYTES) {
+        g.sinceReseed += length;
+        take(g, out, length);
+        return true;
+    }
+
+    // Bulk output in budget-sized chunks, each under a one-off key drawn
+    // from the buffer and written straight to out
+    uint8_t key[CHACHA20_KEY_BYTES];
+    while (length >= BULK_BYTES) {
+        if (!ready(g)) {
+            secureZero(key, sizeof(key));
+            return false;
+        }
+        const size_t chunk = length < RESEED_BYTES ? length : RESEED_BYTES;
+        const size_t blocks = chunk / CHACHA20_BLOCK_BYTES;
+        take(g, key, sizeof(key));
+        chacha20Blocks(key, 0, ZERO_NONCE, out, blocks);
+        generatedBytes.fetch_add(blocks * CHACHA20_BLOCK_BYTES, std::memory_order_relaxed);
+        g.sinceReseed += blocks * CHACHA20_BLOCK_BYTES;
+        out += blocks * CHACHA20_BLOCK_BYTES;
+        length -= blocks * CHACHA20_BLOCK_BYTES;
+    }
+    secureZero(key, sizeof(key));
+    g.sinceReseed += length;
+    take(g, out, length);
+    return true;
+}
+
+RandomStats randomStats() {
+    return {
+        generatedBytes.load(std::memory_order_relaxed),
+        reseedCount.load(std::memory_order_relaxed),
+        forkReseedCount.load(std::memory_order_relaxed),
+    };
+}
+
+bool passesFipsTests(const uint8_t* sample) {
+    // Monobit: the ones in 20000 bits
+    uint32_t ones = 0;
+    for (size_t i = 0; i < FIPS_SAMPLE_BYTES; i++) {
+        ones += static_cast<uint32_t>(__builtin_popcount(sample[i]));
+    }
+    if (ones <= 9725 || ones >= 10275) return false;
+
+    // Poker: the spread of the 5000 4-bit nibbles
+    uint32_t nibbles[16] = {};
+    for (size_t i = 0; i < FIPS_SAMPLE_BYTES; i++) {
+        nibbles[sample[i] >> 4]++;
+        nibbles[sample[i] & 0xF]++;
+    }
+    double squares = 0;
+    for (uint32_t count : nibbles) squares += static_cast<double>(count) * count;
+    const double poker = 16.0 / 5000 * squares - 5000;
+    if (poker <= 2.16 || poker >= 46.17) return false;
+
+    // Runs of each bit value by length, and no run of LONG_RUN or more
+    uint32_t runs[2][6] = {};
+    int previous = sample[0] >> 7;
+    uint32_t length = 0;
+    for (size_t i = 0; i < FIPS_SAMPLE_BYTES * 8; i++) {
+        const int bit = sample[i / 8] >> (7 - i % 8) & 1;
+        if (bit == previous) {
+            length++;
+            continue;
+        }
+        if (length >= LONG_RUN) return false;
+        runs[previous][length < 6 ? length - 1 : 5]++;
+        previous = bit;
+        length = 1;
+    }
+    if (length >= LONG_RUN) return false;
+    runs[previous][length < 6 ? length - 1 : 5]++;
+    for (const auto& byBit : runs) {
+        for (int i = 0; i < 6; i++) {
+            if (byBit[i] < RUNS_MIN[i] || byBit[i] > RUNS_MAX[i]) return false;
+        }
+    }
+    return true;
+}
+
+bool randomSelfTest() {
+    // The SIMD blocks must match the scalar ones, across a counter wrap
+    uint8_t key[CHACHA20_KEY_BYTES];
+    uint8_t nonce[CHACHA20_NONCE_BYTES];
+    for (size_t i = 0; i < sizeof(key); i++) key[i] = static_cast<uint8_t>(i * 7 + 1);
+    for (size_t i = 0; i < sizeof(nonce); i++) nonce[i] = static_cast<uint8_t>(i * 13 + 5);
+    uint8_t blocks[6 * CHACHA20_BLOCK_BYTES];
+    uint8_t single[CHACHA20_BLOCK_BYTES];
+    constexpr uint32_t counter = 0xFFFFFFFE;
+    chacha20Blocks(key, counter, nonce, blocks, 6);
+    for (uint32_t b = 0; b < 6; b++) {
+        chacha20Block(key, counter + b, nonce, single);
+        if (memcmp(single, blocks + b * CHACHA20_BLOCK_BYTES, sizeof(single)) != 0) return false;
+    }
+
+    // Good output fails a FIPS test about once in ten thousand samples;
+    // a second failure in a row is not chance
+    uint8_t sample[FIPS_SAMPLE_BYTES];
+    bool passed = false;
+    for (int attempt = 0; attempt < 2 && !passed; attempt++) {
+        if (!randomBytes(sample, sizeof(sample))) return false;
+        passed = passesFipsTests(sample);
+    }
+
+    // Consecutive outputs never repeat
+    uint8_t first[16];
+    uint8_t second[16];
+    passed = passed && randomBytes(first, sizeof(first)) && randomBytes(second, sizeof(second)) &&
+             memcmp(first, second, sizeof(first)) != 0;
+    secureZero(sample, sizeof(sample));
+    secureZero(first, sizeof(first));
+    secureZero(second, sizeof(second));
+    return passed;
+}
+
+} // namespace bakingapp::crypto
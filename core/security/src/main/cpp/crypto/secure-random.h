@@ -0,0 +1,69 @@
+/**
+ * Per-thread ChaCha20 CSPRNG for nonces, IVs and other secrets
+ *
+ * Each thread keeps its own 32-byte key and a buffer of ChaCha20 key
+ * stream, so a nonce costs a memcpy rather than a syscall or a lock.
+ * Refills erase the key as they go ("fast key erasure"): the first 32
+ * bytes of every refill become the next key, and bytes are wiped as they
+ * are handed out, so a thread's state never reveals output it already
+ * produced. Large requests are generated straight into the caller's buffer,
+ * four blocks at a time with NEON or SSE2 (chacha20Blocks()).
+ *
+ * Keys are seeded from getrandom() (systemRandom()) and reseeded after
+ * RESEED_BYTES of output, and in the child after fork(), which would
+ * otherwise replay the parent's stream.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::crypto {
+
+// Output a thread generates before it mixes in fresh kernel entropy
+constexpr size_t RESEED_BYTES = 1 << 20;
+
+// Sample size of the FIPS 140-2 statistical tests: 20000 bits
+constexpr size_t FIPS_SAMPLE_BYTES = 2500;
+
+/**
+ * Reads the kernel's random pool: getrandom(), or /dev/urandom on kernels
+ * that predate it
+ *
+ * @return false if neither could fill out
+ */
+bool systemRandom(uint8_t* out, size_t length);
+
+/**
+ * Fills out from the calling thread's generator
+ *
+ * @return false (out untouched) if seeding failed
+ */
+bool randomBytes(uint8_t* out, size_t length);
+
+/**
+ * Process-wide counters, updated once per refill or reseed rather than
+ * per call
+ */
+struct RandomStats {
+    uint64_t generatedBytes;    // key stream produced, keys included
+    uint64_t reseeds;           // first seeds included
+    uint64_t forkReseeds;       // of which forced by fork()
+};
+
+RandomStats randomStats();
+
+/**
+ * The FIPS 140-2 monobit, poker, runs and long-run tests over a
+ * FIPS_SAMPLE_BYTES sample
+ */
+bool passesFipsTests(const uint8_t* sample);
+
+/**
+ * Power-on self-test: the SIMD key stream against the scalar one, then
+ * passesFipsTests() on fresh output and a repeated-output check
+ */
+bool randomSelfTest();
+
+} // namespace bakingapp::crypto
@@ -0,0 +1,221 @@
+#include "crypto/sha256.h"
+
+#include <cstring>
+
+namespace bakingapp::crypto {
+
+namespace {
+    constexpr uint32_t ROUND_CONSTANTS[64] = {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4,
+        0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE,
+        0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F,
+        0x4A7484AA, 0x5CB0A9DC, 0x76F988DA, 0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+        0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967, 0x27B70A85, 0x2E1B2138, 0x4D2C6DFC,
+        0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B,
+        0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070, 0x19A4C116,
+        0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7,
+        0xC67178F2,
+    };
+
+    constexpr uint8_t INNER_PAD = 0x36;
+    constexpr uint8_t OUTER_PAD = 0x5C;
+
+    inline uint32_t rotr(uint32_t x, int n) {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    inline uint32_t readBigEndian32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+               static_cast<uint32_t>(p[2]) << 8 | p[3];
+    }
+
+    inline void writeBigEndian32(uint8_t* p, uint32_t v) {
+        p[0] = static_cast<uint8_t>(v >> 24);
+        p[1] = static_cast<uint8_t>(v >> 16);
+        p[2] = static_cast<uint8_t>(v >> 8);
+        p[3] = static_cast<uint8_t>(v);
+    }
+}
+
+void secureZero(void* data, size_t length) {
+    memset(data, 0, length);
+    // The compiler must assume the asm reads the zeroed memory
+    asm volatile("" : : "r"(data) : "memory");
+}
+
+bool constantTimeEquals(const uint8_t* a, const uint8_t* b, size_t length) {
+    uint8_t difference = 0;
+    for (size_t i = 0; i < length; i++) difference |= a[i] ^ b[i];
+    return difference == 0;
+}
+
+// ==================== Sha256 ====================
+
+void Sha256::reset() {
+    static constexpr uint32_t INITIAL[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+        0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+    };
+    memcpy(state_, INITIAL, sizeof(state_));
+    length_ = 0;
+    buffered_ = 0;
+}
+
+void Sha256::compress(const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) w[i] = readBigEndian32(block + i * 4);
+    for (int i = 16; i < 64; i++) {
+        const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+    for (int i = 0; i < 64; i++) {
+        const uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        const uint32_t choose = (e & f) ^ (~e & g);
+        const uint32_t t1 = h + s1 + choose + ROUND_CONSTANTS[i] + w[i];
+        const uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        const uint32_t t2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+    state_[5] += f;
+    state_[6] += g;
+    state_[7] += h;
+    // The schedule is derived from the (possibly secret) message
+    secureZero(w, sizeof(w));
+}
+
+void Sha256::update(const void* data, size_t length) {
+    if (length == 0) return;
+    const auto* p = static_cast<const uint8_t*>(data);
+    length_ += length;
+    if (buffered_ > 0) {
+        const size_t take = length < SHA256_BLOCK_BYTES - buffered_
+                                ? length : SHA256_BLOCK_BYTES - buffered_;
+        memcpy(buffer_ + buffered_, p, take);
+        buffered_ += take;
+        p += take;
+        length -= take;
+        if (buffered_ < SHA256_BLOCK_BYTES) return;
+        compress(buffer_);
+        buffered_ = 0;
+    }
+    while (length >= SHA256_BLOCK_BYTES) {
+        compress(p);
+        p += SHA256_BLOCK_BYTES;
+        length -= SHA256_BLOCK_BYTES;
+    }
+    memcpy(buffer_, p, length);
+    buffered_ = length;
+}
+
+void Sha256::finish(uint8_t out[SHA256_BYTES]) {
+    const uint64_t bits = length_ * 8;
+    buffer_[buffered_++] = 0x80;
+    if (buffered_ > SHA256_BLOCK_BYTES - 8) {
+        memset(buffer_ + buffered_, 0, SHA256_BLOCK_BYTES - buffered_);
+        compress(buffer_);
+        buffered_ = 0;
+    }
+    memset(buffer_ + buffered_, 0, SHA256_BLOCK_BYTES - 8 - buffered_);
+    writeBigEndian32(buffer_ + 56, static_cast<uint32_t>(bits >> 32));
+    writeBigEndian32(buffer_ + 60, static_cast<uint32_t>(bits));
+    compress(buffer_);
+    for (int i = 0; i < 8; i++) writeBigEndian32(out + i * 4, state_[i]);
+    reset();
+}
+
+void sha256(const void* data, size_t length, uint8_t out[SHA256_BYTES]) {
+    Sha256 hash;
+    hash.update(data, length);
+    hash.finish(out);
+}
+
+// ==================== HmacSha256 ====================
+
+HmacSha256::HmacSha256(const uint8_t* key, size_t keyLength) {
+    uint8_t block[SHA256_BLOCK_BYTES] = {};
+    if (keyLength > SHA256_BLOCK_BYTES) {
+        sha256(key, keyLength, block);
+    } else if (keyLength > 0) {
+        memcpy(block, key, keyLength);
+    }
+
+    uint8_t pad[SHA256_BLOCK_BYTES];
+    for (size_t i = 0; i < SHA256_BLOCK_BYTES; i++) pad[i] = block[i] ^ INNER_PAD;
+    inner_.update(pad, sizeof(pad));
+    for (size_t i = 0; i < SHA256_BLOCK_BYTES; i++) pad[i] = block[i] ^ OUTER_PAD;
+    outer_.update(pad, sizeof(pad));
+    secureZero(block, sizeof(block));
+    secureZero(pad, sizeof(pad));
+}
+
+void HmacSha256::finish(uint8_t out[SHA256_BYTES]) {
+    uint8_t innerHash[SHA256_BYTES];
+    inner_.finish(innerHash);
+    outer_.update(innerHash, sizeof(innerHash));
+    outer_.finish(out);
+    secureZero(innerHash, sizeof(innerHash));
+}
+
+void hmacSha256(const uint8_t* key, size_t keyLength, const void* data, size_t length,
+                uint8_t out[SHA256_BYTES]) {
+    HmacSha256 mac(key, keyLength);
+    mac.update(data, length);
+    mac.finish(out);
+}
+
+// ==================== HKDF ====================
+
+void hkdfExtract(const uint8_t* salt, size_t saltLength, const uint8_t* ikm, size_t ikmLength,
+                 uint8_t prk[SHA256_BYTES]) {
+    static constexpr uint8_t ZERO_SALT[SHA256_BYTES] = {};
+    if (salt == nullptr || saltLength == 0) {
+        salt = ZERO_SALT;
+        saltLength = sizeof(ZERO_SALT);
+    }
+    hmacSha256(salt, saltLength, ikm, ikmLength, prk);
+}
+
+bool hkdfExpand(const uint8_t prk[SHA256_BYTES], const void* info, size_t infoLength,
+                uint8_t* out, size_t length) {
+    const HmacSha256 keyed(prk, SHA256_BYTES);
+    return hkdfExpand(keyed, info, infoLength, out, length);
+}
+
+bool hkdfExpand(const HmacSha256& prk, const void* info, size_t infoLength, uint8_t* out,
+                size_t length) {
+    if (length > 255 * SHA256_BYTES) return false;
+    uint8_t block[SHA256_BYTES];
+    size_t written = 0;
+    for (uint8_t counter = 1; written < length; counter++) {
+        HmacSha256 mac = prk;
+        if (counter > 1) mac.update(block, sizeof(block));
+        mac.update(info, infoLength);
+        mac.update(&counter, 1);
+        mac.finish(block);
+        const size_t take = length - written < SHA256_BYTES ? length - written : SHA256_BYTES;
+        memcpy(out + written, block, take);
+        written += take;
+    }
+    secureZero(block, sizeof(block));
+    return true;
+}
+
+} // namespace bakingapp::crypto
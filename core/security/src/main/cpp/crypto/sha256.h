@@ -0,0 +1,90 @@
+/**
+ * SHA-256 (FIPS 180-4), HMAC-SHA256 (RFC 2104) and HKDF-SHA256 (RFC 5869)
+ *
+ * Portable C++ with no tables beyond the round constants. Every context
+ * holding key material wipes itself on destruction; callers wipe their own
+ * outputs with secureZero() once done.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::crypto {
+
+constexpr size_t SHA256_BYTES = 32;
+constexpr size_t SHA256_BLOCK_BYTES = 64;
+
+/**
+ * Zeroes memory in a way the optimizer cannot drop as a dead store
+ */
+void secureZero(void* data, size_t length);
+
+/**
+ * Constant-time comparison, for MACs
+ */
+bool constantTimeEquals(const uint8_t* a, const uint8_t* b, size_t length);
+
+class Sha256 {
+public:
+    Sha256() { reset(); }
+    ~Sha256() { secureZero(this, sizeof(*this)); }
+
+    void reset();
+    void update(const void* data, size_t length);
+    void finish(uint8_t out[SHA256_BYTES]);
+
+private:
+    void compress(const uint8_t* block);
+
+    uint32_t state_[8];
+    uint64_t length_;
+    uint8_t buffer_[SHA256_BLOCK_BYTES];
+    size_t buffered_;
+};
+
+void sha256(const void* data, size_t length, uint8_t out[SHA256_BYTES]);
+
+class HmacSha256 {
+public:
+    /**
+     * Unkeyed; only good as the target of an assignment
+     */
+    HmacSha256() = default;
+    HmacSha256(const uint8_t* key, size_t keyLength);
+
+    void update(const void* data, size_t length) { inner_.update(data, length); }
+    void finish(uint8_t out[SHA256_BYTES]);
+
+private:
+    // Both pads already absorbed, so a copy of a keyed instance MACs a
+    // message without touching the key again
+    Sha256 inner_;
+    Sha256 outer_;
+};
+
+void hmacSha256(const uint8_t* key, size_t keyLength, const void* data, size_t length,
+                uint8_t out[SHA256_BYTES]);
+
+/**
+ * HKDF-Extract: prk = HMAC(salt, ikm); an empty salt means 32 zero bytes
+ */
+void hkdfExtract(const uint8_t* salt, size_t saltLength, const uint8_t* ikm, size_t ikmLength,
+                 uint8_t prk[SHA256_BYTES]);
+
+/**
+ * HKDF-Expand of prk into length bytes (at most 255 * 32)
+ *
+ * @return false if length is too large
+ */
+bool hkdfExpand(const uint8_t prk[SHA256_BYTES], const void* info, size_t infoLength,
+                uint8_t* out, size_t length);
+
+/**
+ * HKDF-Expand from an HMAC already keyed with the prk
+ */
+bool hkdfExpand(const HmacSha256& prk, const void* info, size_t infoLength, uint8_t* out,
+                size_t length);
+
+} // namespace bakingapp::crypto
@@ -0,0 +1,172 @@
+/**
+ * JNI bridge for the native thumbnail pipeline
+ *
+ * Bitmaps are locked in place with AndroidBitmap_lockPixels, so pixels move
+ * between the cache, the resizer and the framework without a Java-heap copy.
+ * Only RGBA_8888 bitmaps are accepted.
+ */
+
+#include <jni.h>
+#include <android/bitmap.h>
+
+#include "common/native-memory.h"
+#include "image/image-resize.h"
+#include "image/thumbnail-cache.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::image::ImageView;
+using bakingapp::image::MutableImageView;
+using bakingapp::image::ThumbnailCache;
+
+namespace {
+    /**
+     * Locks a bitmap for the lifetime of the object
+     */
+    class LockedBitmap {
+    public:
+        LockedBitmap(JNIEnv* env, jobject bitmap) : env_(env), bitmap_(bitmap) {
+            if (bitmap == nullptr) return;
+            if (AndroidBitmap_getInfo(env, bitmap, &info_) != ANDROID_BITMAP_RESULT_SUCCESS) return;
+            if (info_.format != ANDROID_BITMAP_FORMAT_RGBA_8888) return;
+            if (AndroidBitmap_lockPixels(env, bitmap, &pixels_) != ANDROID_BITMAP_RESULT_SUCCESS) {
+                pixels_ = nullptr;
+            }
+        }
+
+        ~LockedBitmap() {
+            if (pixels_ != nullptr) AndroidBitmap_unlockPixels(env_, bitmap_);
+        }
+
+        bool isValid() const { return pixels_ != nullptr; }
+
+        ImageView view() const {
+            return ImageView{static_cast<const uint8_t*>(pixels_), info_.width, info_.height,
+                             info_.stride};
+        }
+
+        MutableImageView mutableView() const {
+            return MutableImageView{static_cast<uint8_t*>(pixels_), info_.width, info_.height,
+                                    info_.stride};
+        }
+
+    private:
+        JNIEnv* env_;
+        jobject bitmap_;
+        AndroidBitmapInfo info_ {};
+        void* pixels_ = nullptr;
+    };
+
+    ThumbnailCache* fromHandle(jlong handle) {
+        return reinterpret_cast<ThumbnailCache*>(handle);
+    }
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_image_NativeThumbnailPipeline_nativeOpen(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring directory,
+        jint capacity
+) {
+    if (directory == nullptr || capacity <= 0) return 0;
+
+    const char* path = env->GetStringUTFChars(directory, nullptr);
+    if (path == nullptr) return 0;
+    auto* cache = bakingapp::createTagged<ThumbnailCache>(MemoryTag::CACHES);
+    bool opened = cache != nullptr && cache->open(path, static_cast<uint32_t>(capacity));
+    env->ReleaseStringUTFChars(directory, path);
+
+    if (!opened) {
+        bakingapp::destroyTagged(cache);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(cache);
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_image_NativeThumbnailPipeline_nativeClose(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    bakingapp::destroyTagged(fromHandle(handle));
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_image_NativeThumbnailPipeline_nativeKeyFor(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring url,
+        jint width,
+        jint height,
+        jboolean centerCrop
+) {
+    if (url == nullptr) return 0;
+    const char* chars = env->GetStringUTFChars(url, nullptr);
+    if (chars == nullptr) return 0;
+    jsize length = env->GetStringUTFLength(url);
+    uint64_t key = ThumbnailCache::keyFor(chars, static_cast<size_t>(length),
+                                          static_cast<uint32_t>(width),
+                                          static_cast<uint32_t>(height),
+                                          centerCrop == JNI_TRUE);
+    env->ReleaseStringUTFChars(url, chars);
+    return static_cast<jlong>(key);
+}
+
+/**
+ * Fills target from the cache. target must already have the cell size.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_image_NativeThumbnailPipeline_nativeLoad(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jlong key,
+        jobject target
+) {
+    ThumbnailCache* cache = fromHandle(handle);
+    if (cache == nullptr) return JNI_FALSE;
+
+    LockedBitmap dst(env, target);
+    if (!dst.isValid()) return JNI_FALSE;
+    return cache->read(static_cast<uint64_t>(key), dst.mutableView()) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Resizes source into target (center crop or stretch) and stores the
+ * result under key. A zero handle only resizes.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_image_NativeThumbnailPipeline_nativeResizeAndStore(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jlong key,
+        jobject source,
+        jobject target,
+        jboolean centerCrop
+) {
+    LockedBitmap src(env, source);
+    LockedBitmap dst(env, target);
+    if (!src.isValid() || !dst.isValid()) return JNI_FALSE;
+
+    ImageView srcView = src.view();
+    MutableImageView dstView = dst.mutableView();
+    bakingapp::image::Rect region = centerCrop
+        ? bakingapp::image::centerCropRect(srcView.width, srcView.height,
+                                           dstView.width, dstView.height)
+        : bakingapp::image::Rect{0, 0, srcView.width, srcView.height};
+
+    if (!bakingapp::image::resizeAreaAverage(srcView, region, dstView)) return JNI_FALSE;
+
+    ThumbnailCache* cache = fromHandle(handle);
+    if (cache != nullptr) {
+        ImageView stored{dstView.pixels, dstView.width, dstView.height, dstView.stride};
+        cache->store(static_cast<uint64_t>(key), stored);
+    }
+    return JNI_TRUE;
+}
+
+} // extern "C"
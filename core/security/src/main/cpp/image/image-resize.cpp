@@ -0,0 +1,234 @@
+#include "image/image-resize.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+#include "common/thread-pool.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bakingapp::image {
+
+namespace {
+    /**
+     * Filter weights are 2.14 fixed point and sum to exactly WEIGHT_ONE per
+     * output pixel. The vertical pass keeps 8 fractional bits (>> 6) so the
+     * horizontal pass still fits in 32-bit accumulators:
+     * 255 * 2^8 * 2^14 < 2^32.
+     */
+    constexpr int WEIGHT_BITS = 14;
+    constexpr uint32_t WEIGHT_ONE = 1u << WEIGHT_BITS;
+    constexpr int VERTICAL_SHIFT = 6;
+    constexpr int FINAL_SHIFT = WEIGHT_BITS + (WEIGHT_BITS - VERTICAL_SHIFT);
+
+    // Below this many source pixels a resize stays on the calling thread;
+    // above it, bands of destination rows go to the shared pool
+    constexpr uint64_t PARALLEL_MIN_PIXELS = 512 * 1024;
+    constexpr size_t ROWS_PER_BAND = 8;
+
+    /**
+     * Per-axis filter taps: destination index i reads count[i] source samples
+     * starting at start[i], with weights at weights[i * maxTaps].
+     */
+    struct AxisFilter {
+        uint32_t* start = nullptr;
+        uint32_t* count = nullptr;
+        uint16_t* weights = nullptr;
+        uint32_t maxTaps = 0;
+
+        ~AxisFilter() {
+            taggedFree(start);
+            taggedFree(count);
+            taggedFree(weights);
+        }
+
+        bool build(uint32_t srcLength, uint32_t dstLength) {
+            const double scale = static_cast<double>(srcLength) / dstLength;
+            maxTaps = static_cast<uint32_t>(std::ceil(scale)) + 1;
+
+            start = static_cast<uint32_t*>(
+                taggedMalloc(MemoryTag::IMAGES, dstLength * sizeof(uint32_t)));
+            count = static_cast<uint32_t*>(
+                taggedMalloc(MemoryTag::IMAGES, dstLength * sizeof(uint32_t)));
+            weights = static_cast<uint16_t*>(taggedCalloc(
+                MemoryTag::IMAGES, static_cast<size_t>(dstLength) * maxTaps, sizeof(uint16_t)));
+            if (start == nullptr || count == nullptr || weights == nullptr) return false;
+
+            for (uint32_t i = 0; i < dstLength; i++) {
+                const double lo = i * scale;
+                const double hi = (i + 1) * scale;
+                uint32_t first = static_cast<uint32_t>(lo);
+                uint32_t last = static_cast<uint32_t>(std::ceil(hi));
+                if (last > srcLength) last = srcLength;
+                if (first >= last) first = last - 1;
+
+                // Weights are differences of the rounded cumulative coverage,
+                // so they are never negative and always sum to WEIGHT_ONE and
+                // a flat input stays exactly flat.
+                uint16_t* w = weights + static_cast<size_t>(i) * maxTaps;
+                uint32_t taps = 0;
+                uint32_t previous = 0;
+                double covered = 0;
+                for (uint32_t j = first; j < last && taps < maxTaps; j++) {
+                    covered += std::fmin(hi, j + 1.0) - std::fmax(lo, static_cast<double>(j));
+                    auto cumulative = static_cast<uint32_t>(std::lround(covered / scale * WEIGHT_ONE));
+                    if (cumulative > WEIGHT_ONE || j + 1 == last) cumulative = WEIGHT_ONE;
+                    w[taps++] = static_cast<uint16_t>(cumulative - previous);
+                    previous = cumulative;
+                }
+                start[i] = first;
+                count[i] = taps;
+            }
+            return true;
+        }
+    };
+
+    /**
+     * acc[i] += weight * src[i] over a row of bytes
+     */
+    void accumulateRow(uint32_t* __restrict acc, const uint8_t* __restrict src,
+                       size_t length, uint16_t weight) {
+        size_t i = 0;
+#if defined(__ARM_NEON)
+        for (; i + 16 <= length; i += 16) {
+            uint8x16_t pixels = vld1q_u8(src + i);
+            uint16x8_t lo = vmovl_u8(vget_low_u8(pixels));
+            uint16x8_t hi = vmovl_u8(vget_high_u8(pixels));
+            vst1q_u32(acc + i, vmlal_n_u16(vld1q_u32(acc + i), vget_low_u16(lo), weight));
+            vst1q_u32(acc + i + 4, vmlal_n_u16(vld1q_u32(acc + i + 4), vget_high_u16(lo), weight));
+            vst1q_u32(acc + i + 8, vmlal_n_u16(vld1q_u32(acc + i + 8), vget_low_u16(hi), weight));
+            vst1q_u32(acc + i + 12, vmlal_n_u16(vld1q_u32(acc + i + 12), vget_high_u16(hi), weight));
+        }
+#elif defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i w = _mm_set1_epi16(static_cast<short>(weight));
+        for (; i + 16 <= length; i += 16) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i halves[2] = {_mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero)};
+            for (int h = 0; h < 2; h++) {
+                // 16x16 -> 32-bit products from the low and high halves
+                __m128i low = _mm_mullo_epi16(halves[h], w);
+                __m128i high = _mm_mulhi_epu16(halves[h], w);
+                __m128i p0 = _mm_unpacklo_epi16(low, high);
+                __m128i p1 = _mm_unpackhi_epi16(low, high);
+                auto* a = reinterpret_cast<__m128i*>(acc + i + h * 8);
+                _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), p0));
+                _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), p1));
+            }
+        }
+#endif
+        for (; i < length; i++) {
+            acc[i] += static_cast<uint32_t>(src[i]) * weight;
+        }
+    }
+
+    void narrowRow(uint16_t* __restrict dst, const uint32_t* __restrict acc, size_t length) {
+        constexpr uint32_t round = 1u << (VERTICAL_SHIFT - 1);
+        for (size_t i = 0; i < length; i++) {
+            dst[i] = static_cast<uint16_t>((acc[i] + round) >> VERTICAL_SHIFT);
+        }
+    }
+
+    void horizontalPass(uint8_t* __restrict dst, const uint16_t* __restrict row,
+                        const AxisFilter& filter, uint32_t dstWidth) {
+        constexpr uint32_t round = 1u << (FINAL_SHIFT - 1);
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            const uint16_t* px = row + static_cast<size_t>(filter.start[x]) * BYTES_PER_PIXEL;
+            const uint16_t* w = filter.weights + static_cast<size_t>(x) * filter.maxTaps;
+            uint32_t r = 0, g = 0, b = 0, a = 0;
+            for (uint32_t k = 0; k < filter.count[x]; k++) {
+                r += px[0] * static_cast<uint32_t>(w[k]);
+                g += px[1] * static_cast<uint32_t>(w[k]);
+                b += px[2] * static_cast<uint32_t>(w[k]);
+                a += px[3] * static_cast<uint32_t>(w[k]);
+                px += BYTES_PER_PIXEL;
+            }
+            dst[0] = static_cast<uint8_t>((r + round) >> FINAL_SHIFT);
+            dst[1] = static_cast<uint8_t>((g + round) >> FINAL_SHIFT);
+            dst[2] = static_cast<uint8_t>((b + round) >> FINAL_SHIFT);
+            dst[3] = static_cast<uint8_t>((a + round) >> FINAL_SHIFT);
+            dst += BYTES_PER_PIXEL;
+        }
+    }
+}
+
+Rect centerCropRect(uint32_t srcWidth, uint32_t srcHeight,
+                    uint32_t dstWidth, uint32_t dstHeight) {
+    if (srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0) {
+        return Rect{0, 0, srcWidth, srcHeight};
+    }
+    // Compare srcW/srcH with dstW/dstH without floating point
+    const uint64_t srcCross = static_cast<uint64_t>(srcWidth) * dstHeight;
+    const uint64_t dstCross = static_cast<uint64_t>(dstWidth) * srcHeight;
+    if (srcCross > dstCross) {
+        auto width = static_cast<uint32_t>(dstCross / dstHeight);
+        if (width == 0) width = 1;
+        return Rect{(srcWidth - width) / 2, 0, width, srcHeight};
+    }
+    auto height = static_cast<uint32_t>(srcCross / dstWidth);
+    if (height == 0) height = 1;
+    return Rect{0, (srcHeight - height) / 2, srcWidth, height};
+}
+
+bool resizeAreaAverage(const ImageView& src, const Rect& srcRect,
+                       const MutableImageView& dst) {
+    if (src.pixels == nullptr || dst.pixels == nullptr) return false;
+    if (srcRect.width == 0 || srcRect.height == 0 || dst.width == 0 || dst.height == 0) {
+        return false;
+    }
+    if (srcRect.x + srcRect.width > src.width || srcRect.y + srcRect.height > src.height) {
+        return false;
+    }
+
+    AxisFilter horizontal;
+    AxisFilter vertical;
+    if (!horizontal.build(srcRect.width, dst.width) ||
+        !vertical.build(srcRect.height, dst.height)) {
+        return false;
+    }
+
+    const size_t rowLength = static_cast<size_t>(srcRect.width) * BYTES_PER_PIXEL;
+    const uint8_t* origin = src.pixels + static_cast<size_t>(srcRect.x) * BYTES_PER_PIXEL;
+    std::atomic<bool> failed {false};
+
+    // Rows are independent; each band has its own scratch rows
+    auto resizeRows = [&](size_t firstRow, size_t endRow) {
+        auto* acc = static_cast<uint32_t*>(
+            taggedMalloc(MemoryTag::IMAGES, rowLength * sizeof(uint32_t)));
+        auto* narrowed = static_cast<uint16_t*>(
+            taggedMalloc(MemoryTag::IMAGES, rowLength * sizeof(uint16_t)));
+        if (acc == nullptr || narrowed == nullptr) {
+            failed.store(true, std::memory_order_relaxed);
+        } else {
+            for (size_t y = firstRow; y < endRow; y++) {
+                std::memset(acc, 0, rowLength * sizeof(uint32_t));
+                const uint16_t* w = vertical.weights + y * vertical.maxTaps;
+                for (uint32_t k = 0; k < vertical.count[y]; k++) {
+                    const size_t sy = srcRect.y + vertical.start[y] + k;
+                    accumulateRow(acc, origin + sy * src.stride, rowLength, w[k]);
+                }
+                narrowRow(narrowed, acc, rowLength);
+                horizontalPass(dst.pixels + y * dst.stride, narrowed, horizontal, dst.width);
+            }
+        }
+        taggedFree(acc);
+        taggedFree(narrowed);
+    };
+
+    const uint64_t srcPixels = static_cast<uint64_t>(srcRect.width) * srcRect.height;
+    if (srcPixels < PARALLEL_MIN_PIXELS) {
+        resizeRows(0, dst.height);
+    } else {
+        ThreadPool::shared().parallelFor(0, dst.height, ROWS_PER_BAND, resizeRows);
+    }
+    return !failed.load(std::memory_order_relaxed);
+}
+
+} // namespace bakingapp::image
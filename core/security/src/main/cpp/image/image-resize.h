@@ -0,0 +1,64 @@
+/**
+ * Area-average (box filter) image resizing for RGBA8888 thumbnails.
+ *
+ * Every destination pixel is the exact coverage-weighted mean of the source
+ * pixels it overlaps, which is the alias-free choice for the large downscale
+ * factors we see between recipe photos and list cells.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::image {
+
+constexpr uint32_t BYTES_PER_PIXEL = 4;
+
+struct Rect {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+/**
+ * Read-only view over RGBA8888 pixels. stride is in bytes.
+ */
+struct ImageView {
+    const uint8_t* pixels;
+    uint32_t width;
+    uint32_t height;
+    size_t stride;
+};
+
+struct MutableImageView {
+    uint8_t* pixels;
+    uint32_t width;
+    uint32_t height;
+    size_t stride;
+};
+
+/**
+ * Largest centered region of the source with the destination aspect ratio,
+ * so the result fills the cell without distortion ("center crop")
+ */
+Rect centerCropRect(uint32_t srcWidth, uint32_t srcHeight,
+                    uint32_t dstWidth, uint32_t dstHeight);
+
+/**
+ * Resizes srcRect of src into the whole of dst.
+ *
+ * @return false on invalid geometry or allocation failure
+ */
+bool resizeAreaAverage(const ImageView& src, const Rect& srcRect,
+                       const MutableImageView& dst);
+
+/**
+ * Convenience overload resizing the full source image
+ */
+inline bool resizeAreaAverage(const ImageView& src, const MutableImageView& dst) {
+    return resizeAreaAverage(src, Rect{0, 0, src.width, src.height}, dst);
+}
+
+} // namespace bakingapp::image
@@ -0,0 +1,213 @@
+#include "image/thumbnail-cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "common/hash.h"
+#include "common/native-memory.h"
+
+namespace bakingapp::image {
+
+namespace {
+    constexpr uint32_t BLOB_MAGIC = 0x424B5448;    // "BKTH"
+
+    struct BlobHeader {
+        uint32_t magic;
+        uint32_t width;
+        uint32_t height;
+        uint32_t reserved;
+    };
+}
+
+bool ThumbnailCache::open(const char* directory, uint32_t capacity) {
+    LockGuard lock(mutex_);
+    index_.close();
+
+    size_t dirLength = strlen(directory);
+    if (dirLength + 32 >= sizeof(directory_)) return false;
+    memcpy(directory_, directory, dirLength + 1);
+    if (!ensureDirectory(directory_)) return false;
+
+    char path[sizeof(directory_) + 16];
+    snprintf(path, sizeof(path), "%s/index.bin", directory_);
+    return index_.open(path, capacity);
+}
+
+void ThumbnailCache::close() {
+    LockGuard lock(mutex_);
+    index_.close();
+}
+
+uint64_t ThumbnailCache::keyFor(const char* url, size_t length, uint32_t width, uint32_t height,
+                                bool centerCrop) {
+    uint64_t seed = (static_cast<uint64_t>(width) << 32) | height;
+    if (centerCrop) seed ^= 0x9E3779B97F4A7C15ull;
+    uint64_t key = hash64(url, length, seed);
+    return key == 0 ? 1 : key;
+}
+
+bool ThumbnailCache::contentReferenced(uint64_t content) {
+    bool referenced = false;
+    index_.forEach([&](const Slot& slot) { referenced |= slot.content == content; });
+    return referenced;
+}
+
+void ThumbnailCache::dropBlobIfUnreferenced(uint64_t content) {
+    if (contentReferenced(content)) return;
+    char path[sizeof(directory_) + 32];
+    blobPath(content, path, sizeof(path));
+    unlink(path);
+}
+
+void ThumbnailCache::blobPath(uint64_t content, char* out, size_t outSize) const {
+    snprintf(out, outSize, "%s/%016llx.thumb", directory_,
+             static_cast<unsigned long long>(content));
+}
+
+void ThumbnailCache::evictOldest() {
+    const uint32_t used = index_.count();
+    if (used == 0) return;
+
+    auto* ages = static_cast<uint64_t*>(taggedMalloc(MemoryTag::CACHES, used * sizeof(uint64_t)));
+    if (ages == nullptr) return;
+    uint32_t n = 0;
+    index_.forEach([&](const Slot& slot) { ages[n++] = slot.lastUse; });
+    const uint32_t evictCount = std::max<uint32_t>(1, index_.capacity() / 4);
+    const uint32_t cut = std::min(evictCount, n) - 1;
+    std::nth_element(ages, ages + cut, ages + n);
+    const uint64_t threshold = ages[cut];
+
+    // Collect victims first: backward shifting would move not-yet-visited
+    // slots under the scan.
+    n = 0;
+    index_.forEach([&](const Slot& slot) {
+        if (slot.lastUse <= threshold) ages[n++] = slot.key;
+    });
+    for (uint32_t v = 0; v < n; v++) {
+        Slot* slot = index_.find(ages[v]);
+        if (slot == nullptr) continue;
+        const uint64_t content = slot->content;
+        index_.erase(slot);
+        dropBlobIfUnreferenced(content);
+    }
+    taggedFree(ages);
+}
+
+bool ThumbnailCache::lookup(uint64_t key, uint32_t* width, uint32_t* height) {
+    LockGuard lock(mutex_);
+    if (!index_.isOpen()) return false;
+    Slot* slot = index_.find(key);
+    if (slot == nullptr) return false;
+    slot->lastUse = ++index_.extra().clock;
+    if (width != nullptr) *width = slot->width;
+    if (height != nullptr) *height = slot->height;
+    return true;
+}
+
+bool ThumbnailCache::read(uint64_t key, const MutableImageView& dst) {
+    LockGuard lock(mutex_);
+    if (!index_.isOpen()) return false;
+    Slot* slot = index_.find(key);
+    if (slot == nullptr || slot->width != dst.width || slot->height != dst.height) return false;
+
+    char path[sizeof(directory_) + 32];
+    blobPath(slot->content, path, sizeof(path));
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // Blob vanished (cleared by the system); drop the dangling entry
+        index_.erase(slot);
+        return false;
+    }
+
+    BlobHeader blob {};
+    bool ok = readFully(fd, &blob, sizeof(blob), 0) && blob.magic == BLOB_MAGIC &&
+              blob.width == dst.width && blob.height == dst.height;
+    const size_t rowBytes = static_cast<size_t>(dst.width) * BYTES_PER_PIXEL;
+    for (uint32_t y = 0; ok && y < dst.height; y++) {
+        ok = readFully(fd, dst.pixels + y * dst.stride, rowBytes, sizeof(blob) + y * rowBytes);
+    }
+    ::close(fd);
+
+    if (ok) slot->lastUse = ++index_.extra().clock;
+    return ok;
+}
+
+bool ThumbnailCache::store(uint64_t key, const ImageView& thumbnail) {
+    if (key == 0 || thumbnail.pixels == nullptr || thumbnail.width == 0 ||
+        thumbnail.height == 0) {
+        return false;
+    }
+
+    // Pack rows contiguously behind the blob header
+    const size_t rowBytes = static_cast<size_t>(thumbnail.width) * BYTES_PER_PIXEL;
+    const size_t pixelBytes = rowBytes * thumbnail.height;
+    auto* blob = static_cast<uint8_t*>(
+        taggedMalloc(MemoryTag::CACHES, sizeof(BlobHeader) + pixelBytes));
+    if (blob == nullptr) return false;
+    BlobHeader blobHeader {BLOB_MAGIC, thumbnail.width, thumbnail.height, 0};
+    memcpy(blob, &blobHeader, sizeof(blobHeader));
+    for (uint32_t y = 0; y < thumbnail.height; y++) {
+        memcpy(blob + sizeof(BlobHeader) + y * rowBytes,
+               thumbnail.pixels + y * thumbnail.stride, rowBytes);
+    }
+    uint64_t content = hash64(blob, sizeof(BlobHeader) + pixelBytes);
+    if (content == 0) content = 1;
+
+    LockGuard lock(mutex_);
+    if (!index_.isOpen()) {
+        taggedFree(blob);
+        return false;
+    }
+
+    char path[sizeof(directory_) + 32];
+    blobPath(content, path, sizeof(path));
+    bool ok = access(path, F_OK) == 0 ||
+              writeFileAtomically(path, blob, sizeof(BlobHeader) + pixelBytes);
+    taggedFree(blob);
+    if (!ok) return false;
+
+    if (index_.find(key) == nullptr && (index_.count() + 1) * 4 > index_.capacity() * 3) {
+        evictOldest();
+    }
+    Slot* slot = index_.insert(key);
+    if (slot == nullptr) return false;
+    const uint64_t previous = slot->content;
+    slot->content = content;
+    slot->width = thumbnail.width;
+    slot->height = thumbnail.height;
+    slot->bytes = static_cast<uint32_t>(pixelBytes);
+    slot->lastUse = ++index_.extra().clock;
+
+    if (previous != 0 && previous != content) dropBlobIfUnreferenced(previous);
+    return true;
+}
+
+bool ThumbnailCache::remove(uint64_t key) {
+    LockGuard lock(mutex_);
+    if (!index_.isOpen()) return false;
+    Slot* slot = index_.find(key);
+    if (slot == nullptr) return false;
+    const uint64_t content = slot->content;
+    index_.erase(slot);
+    dropBlobIfUnreferenced(content);
+    return true;
+}
+
+uint32_t ThumbnailCache::count() {
+    LockGuard lock(mutex_);
+    return index_.isOpen() ? index_.count() : 0;
+}
+
+uint64_t ThumbnailCache::storedBytes() {
+    LockGuard lock(mutex_);
+    if (!index_.isOpen()) return 0;
+    uint64_t total = 0;
+    index_.forEach([&](const Slot& slot) { total += slot.bytes; });
+    return total;
+}
+
+} // namespace bakingapp::image
@@ -0,0 +1,103 @@
+/**
+ * Content-addressed on-disk thumbnail cache.
+ *
+ * Layout inside the cache directory:
+ *   index.bin          mmap'd open-addressing table: request key -> blob
+ *   <content>.thumb    RGBA8888 pixels, named by the hash of their content
+ *
+ * Request keys are hash64(url) mixed with the cell size, so the same photo
+ * cached for two cell sizes yields two entries, while identical thumbnails
+ * reached through different URLs share one blob.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/mapped-hash-table.h"
+#include "common/mutex.h"
+#include "image/image-resize.h"
+
+namespace bakingapp::image {
+
+class ThumbnailCache {
+public:
+    static constexpr uint32_t DEFAULT_CAPACITY = 4096;
+
+    ThumbnailCache() = default;
+    ~ThumbnailCache() = default;
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+    /**
+     * Opens or creates the cache in directory. capacity is rounded up to a
+     * power of two; an index created with another capacity is discarded.
+     */
+    bool open(const char* directory, uint32_t capacity = DEFAULT_CAPACITY);
+
+    void close();
+
+    /**
+     * Request key for a source URL rendered at a given cell size, cropped
+     * to fill the cell or fitted inside it
+     */
+    static uint64_t keyFor(const char* url, size_t length, uint32_t width, uint32_t height,
+                           bool centerCrop);
+
+    /**
+     * Looks up a cached thumbnail and reports its dimensions
+     */
+    bool lookup(uint64_t key, uint32_t* width, uint32_t* height);
+
+    /**
+     * Copies a cached thumbnail into dst, which must match its dimensions
+     */
+    bool read(uint64_t key, const MutableImageView& dst);
+
+    /**
+     * Stores a thumbnail under key, evicting the least recently used quarter
+     * of the table when it is more than three quarters full
+     */
+    bool store(uint64_t key, const ImageView& thumbnail);
+
+    bool remove(uint64_t key);
+
+    uint32_t count();
+
+    /**
+     * Total thumbnail bytes referenced by the index (shared blobs counted once
+     * per entry)
+     */
+    uint64_t storedBytes();
+
+private:
+    struct Slot {
+        uint64_t key;
+        uint64_t content;
+        uint32_t width;
+        uint32_t height;
+        uint32_t bytes;
+        uint32_t reserved;
+        uint64_t lastUse;
+    };
+
+    struct Counters {
+        uint64_t clock;
+        uint64_t reserved;
+    };
+
+    using Index = MappedHashTable<Slot, 0x424B5449 /* "BKTI" */, 1, Counters>;
+
+    void evictOldest();
+    bool contentReferenced(uint64_t content);
+    void dropBlobIfUnreferenced(uint64_t content);
+    void blobPath(uint64_t content, char* out, size_t outSize) const;
+
+    Mutex mutex_;
+    Index index_;
+    char directory_[384] = {};
+};
+
+} // namespace bakingapp::image
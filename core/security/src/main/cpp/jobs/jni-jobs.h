@@ -0,0 +1,46 @@
+/**
+ * Native half of NativeJobs: async jobs whose outcome completes a Kotlin
+ * CompletableDeferred through one cached static upcall
+ * (NativeJobs.onJobComplete), called on the pool worker that ran the job.
+ */
+
+#pragma once
+
+#include <jni.h>
+
+#include <atomic>
+
+#include "common/async-jobs.h"
+
+namespace bakingapp::jobs {
+
+/**
+ * A Job started from a JNI call. result() runs after work() returned DONE
+ * and builds the object the deferred completes with (nullptr for none);
+ * release() then frees whatever the job holds, global refs included, and
+ * the job itself.
+ */
+struct JniJob : Job {
+    jobject (*result)(JNIEnv* env, JniJob* job) = nullptr;
+    void (*release)(JNIEnv* env, JniJob* job) = nullptr;
+
+    // Set when the worker could not reach the VM; the next JNI call into
+    // the bridge reports the job instead
+    JobStatus unreportedStatus = JobStatus::FAILED;
+    JniJob* nextUnreported = nullptr;
+};
+
+/**
+ * Submits job under the id the Kotlin side registered its deferred with
+ *
+ * @return false if NativeJobs is not initialized or the job could not be
+ *   queued; the job has been released then
+ */
+bool submit(JNIEnv* env, JniJob* job, jlong id);
+
+/**
+ * Reports and releases jobs that finished on a worker without a JNIEnv
+ */
+void reportUnreported(JNIEnv* env);
+
+} // namespace bakingapp::jobs
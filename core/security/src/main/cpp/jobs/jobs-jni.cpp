@@ -0,0 +1,133 @@
+/**
+ * JNI bridge for NativeJobs
+ *
+ * nativeInit() caches the JavaVM, NativeJobs' class and its static
+ * onJobComplete(long, int, Object) method; pool workers cannot look up app
+ * classes themselves, as FindClass on a native thread only sees the system
+ * class loader. Workers are attached to the VM for their whole life (see
+ * JNI_OnLoad), so finishing a job is one GetEnv plus one upcall. A worker
+ * that cannot reach the VM parks the job instead, and the next submit or
+ * cancel releases it and resumes its caller.
+ */
+
+#include "jobs/jni-jobs.h"
+
+using bakingapp::AsyncJobs;
+using bakingapp::Job;
+using bakingapp::JobStatus;
+using bakingapp::jobs::JniJob;
+
+namespace {
+    JavaVM* javaVm = nullptr;
+    jclass jobsClass = nullptr;
+    jmethodID onJobComplete = nullptr;
+    std::atomic<JniJob*> unreported {nullptr};
+
+    JNIEnv* workerEnv() {
+        JNIEnv* env = nullptr;
+        if (javaVm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) == JNI_OK) return env;
+        // A pool started before JNI_OnLoad installed the attach hooks
+        JavaVMAttachArgs args {JNI_VERSION_1_6, "native-job", nullptr};
+        return javaVm->AttachCurrentThreadAsDaemon(&env, &args) == JNI_OK ? env : nullptr;
+    }
+
+    void report(JNIEnv* env, JniJob* jniJob, JobStatus status) {
+        const jlong id = static_cast<jlong>(jniJob->id);
+        jobject result = nullptr;
+        if (status == JobStatus::DONE && jniJob->result != nullptr) {
+            result = jniJob->result(env, jniJob);
+            if (env->ExceptionCheck()) {
+                env->ExceptionClear();
+                status = JobStatus::FAILED;
+            }
+        }
+        jniJob->release(env, jniJob);
+
+        env->CallStaticVoidMethod(jobsClass, onJobComplete, id, static_cast<jint>(status), result);
+        if (env->ExceptionCheck()) env->ExceptionClear();
+        // Workers never return to Java, so their local refs are never freed for them
+        if (result != nullptr) env->DeleteLocalRef(result);
+    }
+
+    void finishJob(Job* job, JobStatus status) {
+        auto* jniJob = static_cast<JniJob*>(job);
+        JNIEnv* env = workerEnv();
+        if (env != nullptr) {
+            report(env, jniJob, status);
+            return;
+        }
+        // No VM to report to from here; park the job for a thread that has one
+        jniJob->unreportedStatus = status;
+        jniJob->nextUnreported = unreported.load(std::memory_order_relaxed);
+        while (!unreported.compare_exchange_weak(jniJob->nextUnreported, jniJob,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+        }
+    }
+}
+
+namespace bakingapp::jobs {
+
+bool submit(JNIEnv* env, JniJob* job, jlong id) {
+    reportUnreported(env);
+    if (onJobComplete != nullptr) {
+        job->id = static_cast<uint64_t>(id);
+        job->finish = finishJob;
+        if (AsyncJobs::shared().submit(job)) return true;
+    }
+    job->release(env, job);
+    return false;
+}
+
+void reportUnreported(JNIEnv* env) {
+    if (unreported.load(std::memory_order_relaxed) == nullptr) return;
+    JniJob* job = unreported.exchange(nullptr, std::memory_order_acquire);
+    while (job != nullptr) {
+        JniJob* next = job->nextUnreported;
+        report(env, job, job->unreportedStatus);
+        job = next;
+    }
+}
+
+} // namespace bakingapp::jobs
+
+extern "C" {
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_jobs_NativeJobs_nativeInit(
+        JNIEnv* env,
+        jobject thiz
+) {
+    if (onJobComplete != nullptr) return JNI_TRUE;
+    if (env->GetJavaVM(&javaVm) != JNI_OK) return JNI_FALSE;
+
+    jclass localClass = env->GetObjectClass(thiz);
+    jmethodID method = env->GetStaticMethodID(localClass, "onJobComplete",
+                                              "(JILjava/lang/Object;)V");
+    if (method == nullptr) {
+        env->ExceptionClear();
+        return JNI_FALSE;
+    }
+    jobsClass = static_cast<jclass>(env->NewGlobalRef(localClass));
+    env->DeleteLocalRef(localClass);
+    if (jobsClass == nullptr) return JNI_FALSE;
+    onJobComplete = method;
+    return JNI_TRUE;
+}
+
+/**
+ * Also reports jobs parked by workers that could not reach the VM
+ *
+ * @return false if the job already finished (or never existed)
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_jobs_NativeJobs_nativeCancel(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong jobId
+) {
+    bakingapp::jobs::reportUnreported(env);
+    return AsyncJobs::shared().cancel(static_cast<uint64_t>(jobId)) ? JNI_TRUE : JNI_FALSE;
+}
+
+} // extern "C"
@@ -0,0 +1,107 @@
+/**
+ * The application's key registry, instantiated from key-definitions.h
+ */
+
+#pragma once
+
+#include "keys/key-definitions.h"
+#include "keys/key-registry.h"
+
+namespace bakingapp::keys {
+
+/**
+ * Numeric key IDs in declaration order
+ */
+enum class KeyId : uint16_t {
+#define BAKINGAPP_KEY_ID(id, name, value) id,
+    BAKINGAPP_KEY_DEFINITIONS(BAKINGAPP_KEY_ID)
+#undef BAKINGAPP_KEY_ID
+    COUNT
+};
+
+constexpr size_t APP_KEY_COUNT = static_cast<size_t>(KeyId::COUNT);
+
+#define BAKINGAPP_KEY_LENGTH(id, name, value) + (sizeof(value) - 1)
+constexpr size_t APP_KEY_BYTES = 0 BAKINGAPP_KEY_DEFINITIONS(BAKINGAPP_KEY_LENGTH);
+#undef BAKINGAPP_KEY_LENGTH
+
+/**
+ * The plaintext definitions live only inside this constexpr function,
+ * which is never called at run time
+ */
+constexpr KeyRegistry<APP_KEY_COUNT, APP_KEY_BYTES> buildAppKeys() {
+    constexpr KeyDefinition definitions[] = {
+#define BAKINGAPP_KEY_ENTRY(id, name, value) KeyDefinition{name, value},
+        BAKINGAPP_KEY_DEFINITIONS(BAKINGAPP_KEY_ENTRY)
+#undef BAKINGAPP_KEY_ENTRY
+    };
+    return buildKeyRegistry<APP_KEY_COUNT, APP_KEY_BYTES>(definitions);
+}
+
+inline constexpr KeyRegistry<APP_KEY_COUNT, APP_KEY_BYTES> APP_KEYS = buildAppKeys();
+static_assert(APP_KEYS.valid, "duplicate key names or perfect hash construction failed");
+
+/**
+ * Largest key length, for sizing stack decode buffers
+ */
+constexpr size_t maxKeyLength() {
+    size_t longest = 0;
+    for (size_t i = 0; i < APP_KEY_COUNT; i++) {
+        if (APP_KEYS.lengths[i] > longest) longest = APP_KEYS.lengths[i];
+    }
+    return longest;
+}
+
+inline int32_t findKey(KeyId id) {
+    return APP_KEYS.find(static_cast<size_t>(id));
+}
+
+inline int32_t findKey(std::string_view name) {
+    return APP_KEYS.find(name);
+}
+
+constexpr size_t BLOB_KEY_HEX_LENGTH = sizeof(BAKINGAPP_BLOB_KEY) - 1;
+
+/**
+ * The key blob's key, encoded as a one-entry registry
+ */
+constexpr KeyRegistry<1, BLOB_KEY_HEX_LENGTH> buildBlobKey() {
+    constexpr KeyDefinition definitions[] = {KeyDefinition{"blob", BAKINGAPP_BLOB_KEY}};
+    return buildKeyRegistry<1, BLOB_KEY_HEX_LENGTH>(definitions);
+}
+
+inline constexpr KeyRegistry<1, BLOB_KEY_HEX_LENGTH> BLOB_KEY = buildBlobKey();
+static_assert(BLOB_KEY.valid, "blob key registry construction failed");
+
+/**
+ * Decodes the key blob's key into out, wiping the hex digits
+ *
+ * @return false if BAKINGAPP_BLOB_KEY is not 2 * size hex digits
+ */
+inline bool decodeBlobKey(uint8_t* out, size_t size) {
+    if (BLOB_KEY_HEX_LENGTH != 2 * size) return false;
+    char hex[BLOB_KEY_HEX_LENGTH + 1];
+    BLOB_KEY.decode(0, hex, sizeof(hex));
+    bool valid = true;
+    for (size_t i = 0; i < BLOB_KEY_HEX_LENGTH; i++) {
+        const char c = hex[i];
+        uint8_t nibble = 0;
+        if (c >= '0' && c <= '9') {
+            nibble = static_cast<uint8_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            nibble = static_cast<uint8_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            nibble = static_cast<uint8_t>(c - 'A' + 10);
+        } else {
+            valid = false;
+        }
+        out[i / 2] = static_cast<uint8_t>(i % 2 == 0 ? nibble << 4 : out[i / 2] | nibble);
+    }
+    volatile char* wipe = hex;
+    for (size_t i = 0; i < sizeof(hex); i++) {
+        wipe[i] = 0;
+    }
+    return valid;
+}
+
+} // namespace bakingapp::keys
@@ -0,0 +1,316 @@
+#include "keys/key-blob.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+#include "crypto/secure-random.h"
+#include "crypto/sha256.h"
+
+namespace bakingapp::keys {
+
+using crypto::CHACHA20_NONCE_BYTES;
+using crypto::POLY1305_TAG_BYTES;
+using crypto::secureZero;
+
+namespace {
+    constexpr uint32_t BLOB_MAGIC = 0x424B4B42; // "BKKB"
+    constexpr uint32_t BLOB_VERSION = 1;
+
+    struct BlobHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t count;
+        uint32_t reserved;
+    };
+
+    /**
+     * Also the AAD of its value, so an entry cannot be pointed at another
+     * entry's value or given another name
+     */
+    struct BlobEntry {
+        uint64_t fingerprint;
+        uint32_t offset;        // of the ciphertext, from the start of the blob
+        uint32_t length;        // of the plaintext; the tag follows it
+        uint8_t nonce[CHACHA20_NONCE_BYTES];
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(BlobHeader) == 16, "blob layout");
+    static_assert(sizeof(BlobEntry) == 32, "blob layout");
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    uint64_t entryFingerprint(const uint8_t* data, uint32_t index) {
+        uint64_t fp;
+        memcpy(&fp, data + sizeof(BlobHeader) + index * sizeof(BlobEntry), sizeof(fp));
+        return fp;
+    }
+}
+
+KeyBlob::KeyBlob(uint32_t cacheCapacity) : capacity_(cacheCapacity > 0 ? cacheCapacity : 1) {
+    // Decrypted values go once the app is in the background; the blob key
+    // stays, so they are decrypted again on demand
+    trimHandler_ = addTrimHandler(
+        [](void* context, int level) {
+            auto* blob = static_cast<KeyBlob*>(context);
+            if (level < TRIM_MEMORY_BACKGROUND) return;
+            LockGuard lock(blob->mutex_);
+            blob->dropCacheLocked();
+        },
+        this);
+}
+
+KeyBlob::~KeyBlob() {
+    removeTrimHandler(trimHandler_);
+    close();
+}
+
+bool KeyBlob::open(const char* path, const uint8_t key[BLOB_KEY_BYTES]) {
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st {};
+    const bool opened = fstat(fd, &st) == 0 &&
+                        open(fd, 0, static_cast<size_t>(st.st_size), key);
+    ::close(fd);
+    return opened;
+}
+
+bool KeyBlob::open(int fd, uint64_t offset, size_t length, const uint8_t key[BLOB_KEY_BYTES]) {
+    LockGuard lock(mutex_);
+    closeLocked();
+    if (length < sizeof(BlobHeader)) return false;
+
+    // mmap() wants a page-aligned offset; an asset is only 4-byte aligned
+    // inside its APK
+    const auto page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t start = offset & ~(page - 1);
+    const auto skip = static_cast<size_t>(offset - start);
+    void* mapping = mmap(nullptr, length + skip, PROT_READ, MAP_PRIVATE, fd,
+                         static_cast<off_t>(start));
+    if (mapping == MAP_FAILED) return false;
+    // Lookups touch the header, a few index pages and one value
+    madvise(mapping, length + skip, MADV_RANDOM);
+    mapping_ = mapping;
+    mappingBytes_ = length + skip;
+    data_ = static_cast<const uint8_t*>(mapping) + skip;
+    size_ = length;
+
+    BlobHeader header {};
+    memcpy(&header, data_, sizeof(header));
+    const size_t maxEntries = (size_ - sizeof(BlobHeader)) / sizeof(BlobEntry);
+    if (header.magic != BLOB_MAGIC || header.version != BLOB_VERSION ||
+        header.count > maxEntries || !mapSecureRegion()) {
+        closeLocked();
+        return false;
+    }
+    entries_ = header.count;
+    memcpy(key_, key, BLOB_KEY_BYTES);
+    return true;
+}
+
+bool KeyBlob::mapSecureRegion() {
+    const size_t slotsOffset = alignUp(BLOB_KEY_BYTES, alignof(Slot));
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t bytes = alignUp(slotsOffset + sizeof(Slot) * capacity_, page);
+    void* region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1, 0);
+    if (region == MAP_FAILED) return false;
+    // Best effort, as for the derived-key cache: values are wiped on every
+    // path either way
+    mlock(region, bytes);
+#ifdef MADV_DONTDUMP
+    madvise(region, bytes, MADV_DONTDUMP);
+#endif
+    recordAllocation(MemoryTag::KEYS, bytes);
+    region_ = region;
+    regionBytes_ = bytes;
+    key_ = static_cast<uint8_t*>(region);
+    // Anonymous pages are zeroed: every slot starts unused
+    slots_ = reinterpret_cast<Slot*>(key_ + slotsOffset);
+    return true;
+}
+
+void KeyBlob::close() {
+    LockGuard lock(mutex_);
+    closeLocked();
+}
+
+void KeyBlob::closeLocked() {
+    if (region_ != nullptr) {
+        secureZero(region_, regionBytes_);
+        munlock(region_, regionBytes_);
+        munmap(region_, regionBytes_);
+        recordRelease(MemoryTag::KEYS, regionBytes_);
+    }
+    if (mapping_ != nullptr) munmap(mapping_, mappingBytes_);
+    mapping_ = nullptr;
+    mappingBytes_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+    entries_ = 0;
+    region_ = nullptr;
+    regionBytes_ = 0;
+    key_ = nullptr;
+    slots_ = nullptr;
+    cached_ = 0;
+    nextEviction_ = 0;
+}
+
+void KeyBlob::dropCacheLocked() {
+    if (slots_ != nullptr) secureZero(slots_, sizeof(Slot) * cached_);
+    cached_ = 0;
+    nextEviction_ = 0;
+}
+
+bool KeyBlob::isOpen() {
+    LockGuard lock(mutex_);
+    return data_ != nullptr;
+}
+
+bool KeyBlob::get(std::string_view name, char* out, size_t capacity, size_t* length) {
+    const uint64_t fp = fingerprint(name);
+    LockGuard lock(mutex_);
+    if (data_ == nullptr) return false;
+
+    const Slot* slot = nullptr;
+    for (uint32_t i = 0; i < cached_; i++) {
+        if (slots_[i].used && slots_[i].fingerprint == fp) {
+            slot = &slots_[i];
+            hits_++;
+            break;
+        }
+    }
+    if (slot == nullptr) slot = decrypt(fp);
+    if (slot == nullptr) return false;
+
+    *length = slot->length;
+    if (slot->length + 1 <= capacity) memcpy(out, slot->value, slot->length + 1);
+    return true;
+}
+
+const KeyBlob::Slot* KeyBlob::decrypt(uint64_t fp) {
+    // The index is sorted by fingerprint; binary search for the first >= fp
+    uint32_t low = 0;
+    uint32_t high = entries_;
+    while (low < high) {
+        const uint32_t middle = low + (high - low) / 2;
+        if (entryFingerprint(data_, middle) < fp) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == entries_ || entryFingerprint(data_, low) != fp) return nullptr;
+
+    BlobEntry entry {};
+    memcpy(&entry, data_ + sizeof(BlobHeader) + low * sizeof(BlobEntry), sizeof(entry));
+    const uint64_t end = static_cast<uint64_t>(entry.offset) + entry.length + POLY1305_TAG_BYTES;
+    if (entry.length > MAX_BLOB_VALUE_LENGTH || end > size_) {
+        failures_++;
+        return nullptr;
+    }
+
+    Slot* slot;
+    const bool fresh = cached_ < capacity_;
+    if (fresh) {
+        slot = &slots_[cached_++];
+    } else {
+        slot = &slots_[nextEviction_];
+        nextEviction_ = (nextEviction_ + 1) % capacity_;
+        secureZero(slot, sizeof(Slot));
+        evictions_++;
+    }
+    // Decrypted in place in locked memory, never through the stack or heap
+    auto* value = reinterpret_cast<uint8_t*>(slot->value);
+    memcpy(value, data_ + entry.offset, entry.length);
+    decrypts_++;
+    if (!crypto::aeadOpen(key_, entry.nonce, reinterpret_cast<const uint8_t*>(&entry),
+                          sizeof(entry), value, entry.length,
+                          data_ + entry.offset + entry.length)) {
+        secureZero(slot, sizeof(Slot));
+        if (fresh) cached_--;
+        failures_++;
+        return nullptr;
+    }
+    slot->value[entry.length] = '\0';
+    slot->fingerprint = fp;
+    slot->length = entry.length;
+    slot->used = true;
+    return slot;
+}
+
+KeyBlobStats KeyBlob::stats() {
+    LockGuard lock(mutex_);
+    uint32_t cached = 0;
+    for (uint32_t i = 0; i < cached_; i++) {
+        if (slots_[i].used) cached++;
+    }
+    return {entries_, cached, hits_, decrypts_, evictions_, failures_};
+}
+
+size_t keyBlobSize(const KeyDefinition* definitions, size_t count) {
+    size_t size = sizeof(BlobHeader) + count * sizeof(BlobEntry);
+    for (size_t i = 0; i < count; i++) size += definitions[i].value.size() + POLY1305_TAG_BYTES;
+    return size;
+}
+
+size_t encodeKeyBlob(const KeyDefinition* definitions, size_t count,
+                     const uint8_t key[BLOB_KEY_BYTES], uint8_t* out, size_t capacity) {
+    const size_t size = keyBlobSize(definitions, count);
+    if (size > capacity || size > UINT32_MAX) return 0;
+
+    auto* order = static_cast<uint32_t*>(
+        taggedMalloc(MemoryTag::KEYS, sizeof(uint32_t) * (count > 0 ? count : 1)));
+    auto* fps = static_cast<uint64_t*>(
+        taggedMalloc(MemoryTag::KEYS, sizeof(uint64_t) * (count > 0 ? count : 1)));
+    if (order == nullptr || fps == nullptr) {
+        taggedFree(order);
+        taggedFree(fps);
+        return 0;
+    }
+    bool valid = true;
+    for (size_t i = 0; i < count; i++) {
+        order[i] = static_cast<uint32_t>(i);
+        fps[i] = fingerprint(definitions[i].name);
+        if (definitions[i].value.size() > MAX_BLOB_VALUE_LENGTH) valid = false;
+    }
+    std::sort(order, order + count, [fps](uint32_t a, uint32_t b) { return fps[a] < fps[b]; });
+    for (size_t i = 1; i < count; i++) {
+        if (fps[order[i]] == fps[order[i - 1]]) valid = false;
+    }
+
+    if (valid) {
+        const BlobHeader header {BLOB_MAGIC, BLOB_VERSION, static_cast<uint32_t>(count), 0};
+        memcpy(out, &header, sizeof(header));
+        size_t offset = sizeof(BlobHeader) + count * sizeof(BlobEntry);
+        for (size_t i = 0; i < count; i++) {
+            const KeyDefinition& definition = definitions[order[i]];
+            BlobEntry entry {};
+            entry.fingerprint = fps[order[i]];
+            entry.offset = static_cast<uint32_t>(offset);
+            entry.length = static_cast<uint32_t>(definition.value.size());
+            crypto::randomBytes(entry.nonce, sizeof(entry.nonce));
+            memcpy(out + sizeof(BlobHeader) + i * sizeof(BlobEntry), &entry, sizeof(entry));
+
+            uint8_t* value = out + offset;
+            memcpy(value, definition.value.data(), entry.length);
+            crypto::aeadSeal(key, entry.nonce, reinterpret_cast<const uint8_t*>(&entry),
+                             sizeof(entry), value, entry.length, value + entry.length);
+            offset += entry.length + POLY1305_TAG_BYTES;
+        }
+    }
+    taggedFree(order);
+    taggedFree(fps);
+    return valid ? size : 0;
+}
+
+} // namespace bakingapp::keys
@@ -0,0 +1,145 @@
+/**
+ * Encrypted key blob, read from a mapped file
+ *
+ * Keys that ship as an asset rather than in the compiled registry, so that
+ * rotating one replaces a file instead of rebuilding the library for every
+ * ABI. The blob is a fixed header, an index sorted by name fingerprint and
+ * the values, each sealed on its own with ChaCha20-Poly1305 under a key
+ * compiled into the library (app-keys.h).
+ *
+ * Opening maps the file and checks the header only, so it costs the same
+ * however many keys the blob holds. A value is decrypted the first time it
+ * is asked for (a binary search of the index, then one aeadOpen) and kept
+ * in a small cache that is locked in memory and left out of core dumps,
+ * like the derived-key cache. The cache is wiped when the app moves to the
+ * background (trimMemory()).
+ *
+ * Layout, little-endian:
+ *   header   magic "BKKB", version, entry count (16 bytes)
+ *   index    count entries of fingerprint, offset, length, nonce (32 bytes
+ *            each), sorted by fingerprint; an entry is the AAD of its value
+ *   values   ciphertext followed by its tag, at the entry's offset
+ *
+ * scripts/encode_keys.py --blob writes the asset; encodeKeyBlob() writes
+ * the same format for tests and benchmarks.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "common/mutex.h"
+#include "crypto/chacha20-poly1305.h"
+#include "keys/key-registry.h"
+
+namespace bakingapp::keys {
+
+constexpr size_t BLOB_KEY_BYTES = crypto::CHACHA20_KEY_BYTES;
+constexpr size_t MAX_BLOB_VALUE_LENGTH = 255;
+constexpr uint32_t DEFAULT_BLOB_CACHE_CAPACITY = 32;
+
+struct KeyBlobStats {
+    uint32_t entries;
+    uint32_t cached;
+    uint64_t hits;
+    uint64_t decrypts;
+    uint64_t evictions;
+    uint64_t failures;      // entries whose tag did not match
+};
+
+class KeyBlob {
+public:
+    /**
+     * @param cacheCapacity decrypted values kept at once; the oldest is
+     *   wiped to make room
+     */
+    explicit KeyBlob(uint32_t cacheCapacity = DEFAULT_BLOB_CACHE_CAPACITY);
+    ~KeyBlob();
+
+    KeyBlob(const KeyBlob&) = delete;
+    KeyBlob& operator=(const KeyBlob&) = delete;
+
+    /**
+     * Maps a blob file and copies key into locked memory
+     *
+     * @return false if the file cannot be mapped or its header is invalid
+     */
+    bool open(const char* path, const uint8_t key[BLOB_KEY_BYTES]);
+
+    /**
+     * Maps length bytes of fd from offset, e.g. an uncompressed APK asset.
+     * fd may be closed once this returns.
+     */
+    bool open(int fd, uint64_t offset, size_t length, const uint8_t key[BLOB_KEY_BYTES]);
+
+    /**
+     * Unmaps the blob and wipes the key and every cached value
+     */
+    void close();
+
+    bool isOpen();
+
+    /**
+     * Copies the value of name into out, NUL-terminated
+     *
+     * @param length set to the value length; a value that does not fit in
+     *   capacity (with its NUL) is reported but not copied
+     * @return false if name is not in the blob or its entry fails to open
+     */
+    bool get(std::string_view name, char* out, size_t capacity, size_t* length);
+
+    KeyBlobStats stats();
+
+private:
+    struct Slot {
+        uint64_t fingerprint;
+        uint32_t length;
+        bool used;
+        char value[MAX_BLOB_VALUE_LENGTH + 1];
+    };
+
+    bool mapSecureRegion();
+    void closeLocked();
+    void dropCacheLocked();
+    const Slot* decrypt(uint64_t fingerprint);
+
+    Mutex mutex_;
+    uint32_t capacity_;
+    // The blob mapping; data_ is the blob inside it, which starts past the
+    // page-aligned mapping when it sits inside a larger file
+    void* mapping_ = nullptr;
+    size_t mappingBytes_ = 0;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    uint32_t entries_ = 0;
+    // Mapped, locked and excluded from dumps: the blob key, then the slots
+    void* region_ = nullptr;
+    size_t regionBytes_ = 0;
+    uint8_t* key_ = nullptr;
+    Slot* slots_ = nullptr;
+    uint32_t cached_ = 0;
+    uint32_t nextEviction_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t decrypts_ = 0;
+    uint64_t evictions_ = 0;
+    uint64_t failures_ = 0;
+    uint32_t trimHandler_ = 0;
+};
+
+/**
+ * Bytes encodeKeyBlob() writes for these definitions
+ */
+size_t keyBlobSize(const KeyDefinition* definitions, size_t count);
+
+/**
+ * Seals definitions into a blob under key, each with a random nonce
+ *
+ * @return the bytes written, or 0 if out is too small, a value is longer
+ *   than MAX_BLOB_VALUE_LENGTH or two names share a fingerprint
+ */
+size_t encodeKeyBlob(const KeyDefinition* definitions, size_t count,
+                     const uint8_t key[BLOB_KEY_BYTES], uint8_t* out, size_t capacity);
+
+} // namespace bakingapp::keys
@@ -0,0 +1,52 @@
+/**
+ * Key definitions for the native key registry
+ *
+ * KEY(identifier, "lookup.name", "value")
+ *   identifier  - numeric ID (KeyId::identifier) used from native code
+ *   lookup.name - string ID passed to NativeKeyProvider.getKey()
+ *   value       - plaintext, encoded at compile time (never in the binary)
+ *
+ * WARNING: Never commit real production keys to version control!
+ * CI regenerates this file from its secret store with
+ * `scripts/encode_keys.py --definitions keys.properties`.
+ */
+
+#pragma once
+
+#define BAKINGAPP_KEY_DEFINITIONS(KEY)                                                  \
+    /* Default keys (NativeKeyProvider.getApiKey() / getSecretKey()) */                 \
+    KEY(API, "api", "bk_fake_api_key_12345_demo")                                       \
+    KEY(SECRET, "secret", "sk_fake_secret_key_67890_demo")                              \
+    /* Per environment */                                                               \
+    KEY(PROD_API, "prod.api", "bk_fake_prod_api_key_31337_demo")                        \
+    KEY(PROD_SECRET, "prod.secret", "sk_fake_prod_secret_key_24680_demo")               \
+    KEY(STAGING_API, "staging.api", "bk_fake_staging_api_key_11111_demo")               \
+    KEY(STAGING_SECRET, "staging.secret", "sk_fake_staging_secret_key_22222_demo")      \
+    KEY(DEV_API, "dev.api", "bk_fake_dev_api_key_33333_demo")                           \
+    KEY(DEV_SECRET, "dev.secret", "sk_fake_dev_secret_key_44444_demo")                  \
+    /* Per endpoint */                                                                  \
+    KEY(RECIPES_API, "endpoint.recipes", "bk_fake_recipes_endpoint_key_demo")           \
+    KEY(AUTH_API, "endpoint.auth", "bk_fake_auth_endpoint_key_demo")                    \
+    KEY(SEARCH_API, "endpoint.search", "bk_fake_search_endpoint_key_demo")              \
+    KEY(MEDIA_API, "endpoint.media", "bk_fake_media_endpoint_key_demo")                 \
+    KEY(UPLOAD_API, "endpoint.upload", "bk_fake_upload_endpoint_key_demo")              \
+    KEY(ANALYTICS_API, "endpoint.analytics", "bk_fake_analytics_endpoint_key_demo")     \
+    KEY(PUSH_API, "endpoint.push", "bk_fake_push_endpoint_key_demo")                    \
+    KEY(SYNC_API, "endpoint.sync", "bk_fake_sync_endpoint_key_demo")                    \
+    /* Per partner */                                                                   \
+    KEY(PARTNER_GROCER_API, "partner.grocer.api", "bk_fake_grocer_partner_key_demo")    \
+    KEY(PARTNER_GROCER_SECRET, "partner.grocer.secret", "sk_fake_grocer_secret_demo")   \
+    KEY(PARTNER_VIDEO_API, "partner.video.api", "bk_fake_video_partner_key_demo")       \
+    KEY(PARTNER_VIDEO_SECRET, "partner.video.secret", "sk_fake_video_secret_demo")      \
+    KEY(PARTNER_NUTRITION_API, "partner.nutrition.api", "bk_fake_nutrition_key_demo")   \
+    KEY(PARTNER_NUTRITION_SECRET, "partner.nutrition.secret", "sk_fake_nutrition_demo") \
+    KEY(PARTNER_MAPS_API, "partner.maps.api", "bk_fake_maps_partner_key_demo")          \
+    KEY(PARTNER_PAYMENTS_API, "partner.payments.api", "bk_fake_payments_key_demo")      \
+    KEY(PARTNER_PAYMENTS_SECRET, "partner.payments.secret", "sk_fake_payments_demo")
+
+/**
+ * ChaCha20 key of the encrypted key blob asset (keys/key-blob.h), as 64 hex
+ * digits. Encoded like the keys above; not a lookup name. A blob sealed
+ * under another key does not open, and the registry above is used instead.
+ */
+#define BAKINGAPP_BLOB_KEY "8977efb50f050acd8df51da25d546045b70fffce8d0347f81db0297e88d4053b"
@@ -0,0 +1,215 @@
+/**
+ * Compile-time key registry
+ *
+ * Keys are declared once as plaintext in a constexpr definition list and
+ * encoded while compiling: the plaintext only exists inside constant
+ * evaluation and never reaches the binary. Lookup by name goes through a
+ * minimal perfect hash (hash-and-displace) that is also built at compile
+ * time, so a lookup is one hash, one table read and one fingerprint compare.
+ * Lookup by numeric ID is a direct index.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace bakingapp::keys {
+
+struct KeyDefinition {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * FNV-1a with a splitmix64 finalizer; constexpr so that build-time and
+ * run-time lookups agree bit for bit
+ */
+constexpr uint64_t fingerprint(std::string_view name) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 0x100000001B3ULL;
+    }
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/**
+ * Position-dependent XOR mask, so repeated characters do not produce
+ * repeated bytes in the encoded table
+ */
+constexpr uint8_t maskByte(uint64_t fp, size_t index) {
+    return static_cast<uint8_t>((fp >> ((index & 7) * 8)) ^ (index * 0x9D) ^ 0x5A);
+}
+
+template <size_t N, size_t BYTES>
+struct KeyRegistry {
+    static_assert(N > 0, "registry needs at least one key");
+    static_assert(N < 0xFFFF, "slot indexes are 16-bit");
+
+    static constexpr size_t BUCKETS = N > 1 ? N / 2 : 1;
+    static constexpr int32_t NOT_FOUND = -1;
+
+    bool valid;
+    uint64_t fingerprints[N];
+    uint32_t offsets[N];
+    uint16_t lengths[N];
+    uint16_t slotById[N];
+    uint32_t displacements[BUCKETS];
+    uint8_t encoded[BYTES > 0 ? BYTES : 1];
+
+    /**
+     * Re-mixes the fingerprint with the bucket's displacement seed
+     */
+    static constexpr uint32_t slotFor(uint64_t fp, uint32_t displacement) {
+        uint64_t h = fp ^ (displacement * 0x9E3779B97F4A7C15ULL);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        return static_cast<uint32_t>(h % N);
+    }
+
+    static constexpr size_t bucketFor(uint64_t fp) {
+        return static_cast<size_t>((fp >> 17) % BUCKETS);
+    }
+
+    /**
+     * Slot of a key name, or NOT_FOUND
+     */
+    constexpr int32_t find(std::string_view name) const {
+        const uint64_t fp = fingerprint(name);
+        const uint32_t slot = slotFor(fp, displacements[bucketFor(fp)]);
+        return fingerprints[slot] == fp ? static_cast<int32_t>(slot) : NOT_FOUND;
+    }
+
+    constexpr int32_t find(size_t id) const {
+        return id < N ? static_cast<int32_t>(slotById[id]) : NOT_FOUND;
+    }
+
+    constexpr size_t length(int32_t slot) const {
+        return lengths[slot];
+    }
+
+    /**
+     * Decodes a slot into out (NUL-terminated).
+     *
+     * @return the key length, or 0 if out is too small
+     */
+    size_t decode(int32_t slot, char* out, size_t capacity) const {
+        const size_t len = lengths[slot];
+        if (len + 1 > capacity) return 0;
+        const uint8_t* src = encoded + offsets[slot];
+        const uint64_t fp = fingerprints[slot];
+        // With a constant slot the optimizer could otherwise fold the whole
+        // decode and emit the plaintext into .rodata
+        asm volatile("" : "+r"(src));
+        uint8_t fpBytes[8];
+        for (size_t b = 0; b < 8; b++) fpBytes[b] = static_cast<uint8_t>(fp >> (b * 8));
+        // Same mask as maskByte(), without the variable shifts
+        for (size_t i = 0; i < len; i++) {
+            out[i] = static_cast<char>(src[i] ^ fpBytes[i & 7] ^
+                                       static_cast<uint8_t>(i * 0x9D) ^ 0x5A);
+        }
+        out[len] = '\0';
+        return len;
+    }
+};
+
+/**
+ * Builds the registry. Must be evaluated in a constant expression; check
+ * `valid` with a static_assert (duplicate names or a failed hash search
+ * leave it false).
+ */
+template <size_t N, size_t BYTES>
+constexpr KeyRegistry<N, BYTES> buildKeyRegistry(const KeyDefinition (&definitions)[N]) {
+    using Registry = KeyRegistry<N, BYTES>;
+    constexpr size_t B = Registry::BUCKETS;
+
+    // Seeds tried per bucket before giving up
+    constexpr uint32_t MAX_DISPLACEMENT = 1 << 16;
+
+    Registry registry {};
+    registry.valid = false;
+
+    uint64_t fps[N] = {};
+    size_t byteCount = 0;
+    for (size_t i = 0; i < N; i++) {
+        fps[i] = fingerprint(definitions[i].name);
+        byteCount += definitions[i].value.size();
+        for (size_t j = 0; j < i; j++) {
+            if (fps[j] == fps[i]) return registry;
+        }
+    }
+    if (byteCount != BYTES) return registry;
+
+    // Place the largest buckets first while the table is still empty
+    size_t bucketSize[B] = {};
+    for (size_t i = 0; i < N; i++) bucketSize[Registry::bucketFor(fps[i])]++;
+    size_t order[B] = {};
+    for (size_t b = 0; b < B; b++) order[b] = b;
+    for (size_t i = 1; i < B; i++) {
+        for (size_t j = i; j > 0 && bucketSize[order[j]] > bucketSize[order[j - 1]]; j--) {
+            size_t tmp = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = tmp;
+        }
+    }
+
+    bool occupied[N] = {};
+    size_t keyAtSlot[N] = {};
+    for (size_t o = 0; o < B; o++) {
+        const size_t bucket = order[o];
+        if (bucketSize[bucket] == 0) break;
+
+        bool placed = false;
+        for (uint32_t d = 0; d < MAX_DISPLACEMENT && !placed; d++) {
+            uint32_t slots[N] = {};
+            size_t members = 0;
+            bool fits = true;
+            for (size_t i = 0; i < N && fits; i++) {
+                if (Registry::bucketFor(fps[i]) != bucket) continue;
+                const uint32_t slot = Registry::slotFor(fps[i], d);
+                fits = !occupied[slot];
+                for (size_t m = 0; m < members && fits; m++) fits = slots[m] != slot;
+                slots[members++] = slot;
+            }
+            if (!fits) continue;
+
+            members = 0;
+            for (size_t i = 0; i < N; i++) {
+                if (Registry::bucketFor(fps[i]) != bucket) continue;
+                occupied[slots[members]] = true;
+                keyAtSlot[slots[members]] = i;
+                members++;
+            }
+            registry.displacements[bucket] = d;
+            placed = true;
+        }
+        if (!placed) return registry;
+    }
+
+    uint32_t offset = 0;
+    for (size_t slot = 0; slot < N; slot++) {
+        const size_t i = keyAtSlot[slot];
+        const std::string_view value = definitions[i].value;
+        registry.fingerprints[slot] = fps[i];
+        registry.offsets[slot] = offset;
+        registry.lengths[slot] = static_cast<uint16_t>(value.size());
+        registry.slotById[i] = static_cast<uint16_t>(slot);
+        for (size_t c = 0; c < value.size(); c++) {
+            registry.encoded[offset + c] =
+                static_cast<uint8_t>(static_cast<uint8_t>(value[c]) ^ maskByte(fps[i], c));
+        }
+        offset += static_cast<uint32_t>(value.size());
+    }
+    registry.valid = true;
+    return registry;
+}
+
+} // namespace bakingapp::keys
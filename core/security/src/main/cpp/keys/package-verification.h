@@ -0,0 +1,16 @@
+/**
+ * Calling-app check for the JNI bridges that use key material
+ */
+
+#pragma once
+
+#include <jni.h>
+
+namespace bakingapp::keys {
+
+/**
+ * Returns true if context belongs to this app (release or debug package)
+ */
+bool verifyPackageName(JNIEnv* env, jobject context);
+
+} // namespace bakingapp::keys
@@ -11,59 +11,48 @@
  * 3. String splitting (no complete key in one place)
  * 4. Package name verification (prevents use in other apps)
  *
+ * Keys are declared in keys/key-definitions.h and XOR-encoded at compile
+ * time into a perfect-hash registry (keys/key-registry.h). A key also in
+ * the encrypted key blob asset (keys/key-blob.h), once Kotlin has opened
+ * it, is served from the blob instead, so keys rotate with the asset.
+ *
  * WARNING: Never commit real production keys to version control!
  * Use this as a template and inject real keys during CI/CD builds.
  */
 
 #include <jni.h>
-#include <string>
-#include <vector>
+#include <pthread.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
 
-namespace {
-    /**
-     * XOR key for obfuscation - should be different for each key type
-     * In production, generate these randomly and never reuse
-     */
-    constexpr char XOR_KEY_API = 0x5A;
-    constexpr char XOR_KEY_SECRET = 0x7F;
+#include "common/native-memory.h"
+#include "common/thread-pool.h"
+#include "crypto/sha256.h"
+#include "keys/app-keys.h"
+#include "keys/key-blob.h"
+#include "keys/package-verification.h"
+#include "telemetry/telemetry.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::keys::APP_KEYS;
+using bakingapp::keys::BLOB_KEY_BYTES;
+using bakingapp::keys::KeyBlob;
+using bakingapp::keys::KeyId;
+using bakingapp::keys::MAX_BLOB_VALUE_LENGTH;
+using bakingapp::keys::verifyPackageName;
+using bakingapp::telemetry::EventType;
+using bakingapp::telemetry::Telemetry;
 
+namespace {
     /**
      * Expected package name for verification
      * This adds an extra layer of protection - even if the .so is extracted,
      * it won't work in an app with a different package name
      */
-    const std::string EXPECTED_PACKAGE = "com.eslam.bakingapp";
-    const std::string EXPECTED_PACKAGE_DEBUG = "com.eslam.bakingapp.debug";
-
-    /**
-     * XOR-encoded API Key
-     * Original: "bk_fake_api_key_12345_demo"
-     * To encode: for each char c in key: encoded_char = c ^ XOR_KEY_API
-     *
-     * Generate encoded keys using this Python snippet:
-     * key = "your_actual_api_key"
-     * xor_key = 0x5A
-     * encoded = [hex(ord(c) ^ xor_key) for c in key]
-     * print(', '.join(encoded))
-     */
-    const std::vector<char> API_KEY_ENCODED = {
-        0x38, 0x31, 0x1a, 0x3c, 0x3f, 0x31, 0x3b, 0x1a,
-        0x3f, 0x28, 0x3b, 0x1a, 0x31, 0x3b, 0x29, 0x1a,
-        0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x1a, 0x3e, 0x3b,
-        0x37, 0x35
-    };
-
-    /**
-     * XOR-encoded Secret Key
-     * Original: "sk_fake_secret_key_67890_demo"
-     * Encoded with XOR_KEY_SECRET (0x7F)
-     */
-    const std::vector<char> SECRET_KEY_ENCODED = {
-        0x0c, 0x14, 0x54, 0x19, 0x1e, 0x14, 0x1a, 0x54,
-        0x0c, 0x1a, 0x1c, 0x0d, 0x1a, 0x0b, 0x54, 0x14,
-        0x1a, 0x08, 0x54, 0x49, 0x48, 0x4f, 0x4e, 0x4d,
-        0x54, 0x1b, 0x1a, 0x12, 0x10
-    };
+    constexpr std::string_view EXPECTED_PACKAGE = "com.eslam.bakingapp";
+    constexpr std::string_view EXPECTED_PACKAGE_DEBUG = "com.eslam.bakingapp.debug";
 
     /**
      * Additional key parts for extra obfuscation
@@ -72,67 +61,110 @@ namespace {
     const char* KEY_PREFIX_PART_1 = "baking";
     const char* KEY_PREFIX_PART_2 = "_app_";
 
+    // Names of the keys behind getApiKeyNative() and getSecretKeyNative()
+    constexpr std::string_view API_KEY_NAME = "api";
+    constexpr std::string_view SECRET_KEY_NAME = "secret";
+
     /**
-     * Decodes an XOR-encoded byte vector to a string
+     * The key blob, set once it has opened; it lives as long as the process
      */
-    std::string decodeKey(const std::vector<char>& encoded, char xorKey) {
-        std::string decoded;
-        decoded.reserve(encoded.size());
-        for (char c : encoded) {
-            decoded += static_cast<char>(c ^ xorKey);
-        }
-        return decoded;
-    }
+    std::atomic<KeyBlob*> sharedBlob{nullptr};
+    pthread_mutex_t blobMutex = PTHREAD_MUTEX_INITIALIZER;
 
     /**
-     * Verifies the calling app's package name
-     * Returns true if the package name matches expected values
+     * Looks name up in the key blob, then decodes the registry slot if the
+     * blob does not hold it, into a Java string, wiping the native copy
      */
-    bool verifyPackageName(JNIEnv* env, jobject context) {
-        // Get Context class
-        jclass contextClass = env->GetObjectClass(context);
-        if (contextClass == nullptr) return false;
-
-        // Get getPackageName method
-        jmethodID getPackageNameMethod = env->GetMethodID(
-            contextClass,
-            "getPackageName",
-            "()Ljava/lang/String;"
-        );
-        if (getPackageNameMethod == nullptr) return false;
-
-        // Call getPackageName()
-        auto packageNameObj = (jstring) env->CallObjectMethod(
-            context,
-            getPackageNameMethod
-        );
-        if (packageNameObj == nullptr) return false;
-
-        // Convert to C++ string
-        const char* packageNameChars = env->GetStringUTFChars(packageNameObj, nullptr);
-        std::string packageName(packageNameChars);
-        env->ReleaseStringUTFChars(packageNameObj, packageNameChars);
-
-        // Verify package name
-        return packageName == EXPECTED_PACKAGE ||
-               packageName == EXPECTED_PACKAGE_DEBUG;
+    jstring decodeKey(JNIEnv* env, std::string_view name, int32_t slot) {
+        Telemetry::shared().record(EventType::KEY_FETCH, static_cast<uint32_t>(slot));
+        constexpr size_t CAPACITY = MAX_BLOB_VALUE_LENGTH > bakingapp::keys::maxKeyLength()
+                                        ? MAX_BLOB_VALUE_LENGTH
+                                        : bakingapp::keys::maxKeyLength();
+        char decoded[CAPACITY + 1];
+        size_t length = 0;
+        KeyBlob* blob = sharedBlob.load(std::memory_order_acquire);
+        const bool inBlob = blob != nullptr && blob->get(name, decoded, sizeof(decoded), &length);
+        if (!inBlob) {
+            if (slot < 0) {
+                return env->NewStringUTF("");
+            }
+            APP_KEYS.decode(slot, decoded, sizeof(decoded));
+        }
+        jstring result = env->NewStringUTF(decoded);
+        bakingapp::crypto::secureZero(decoded, sizeof(decoded));
+        return result;
     }
 
     /**
      * Builds a composite key with runtime concatenation
      * This prevents the full key from appearing in any single location
      */
-    std::string buildCompositeIdentifier() {
-        std::string result;
-        result += KEY_PREFIX_PART_1;
-        result += KEY_PREFIX_PART_2;
-        result += "v1";
-        return result;
+    void buildCompositeIdentifier(char* out, size_t capacity) {
+        snprintf(out, capacity, "%s%s%s", KEY_PREFIX_PART_1, KEY_PREFIX_PART_2, "v1");
     }
+
+    /**
+     * Native pool workers are attached once, as daemons, so they show up
+     * in thread dumps and never hold up VM shutdown
+     */
+    void attachWorker(uint32_t index, void* context) {
+        auto* vm = static_cast<JavaVM*>(context);
+        char name[32];
+        snprintf(name, sizeof(name), "native-pool-%u", index);
+        JavaVMAttachArgs args {JNI_VERSION_1_6, name, nullptr};
+        JNIEnv* env = nullptr;
+        vm->AttachCurrentThreadAsDaemon(&env, &args);
+    }
+
+    void detachWorker(uint32_t /* index */, void* context) {
+        static_cast<JavaVM*>(context)->DetachCurrentThread();
+    }
+}
+
+namespace bakingapp::keys {
+
+bool verifyPackageName(JNIEnv* env, jobject context) {
+    // Get Context class
+    jclass contextClass = env->GetObjectClass(context);
+    if (contextClass == nullptr) return false;
+
+    // Get getPackageName method
+    jmethodID getPackageNameMethod = env->GetMethodID(
+        contextClass,
+        "getPackageName",
+        "()Ljava/lang/String;"
+    );
+    if (getPackageNameMethod == nullptr) return false;
+
+    // Call getPackageName()
+    auto packageNameObj = (jstring) env->CallObjectMethod(
+        context,
+        getPackageNameMethod
+    );
+    if (packageNameObj == nullptr) return false;
+
+    // Compare in place against the expected names
+    const char* packageNameChars = env->GetStringUTFChars(packageNameObj, nullptr);
+    if (packageNameChars == nullptr) return false;
+    const std::string_view packageName(
+        packageNameChars, static_cast<size_t>(env->GetStringUTFLength(packageNameObj)));
+    const bool matches = packageName == EXPECTED_PACKAGE ||
+                         packageName == EXPECTED_PACKAGE_DEBUG;
+    env->ReleaseStringUTFChars(packageNameObj, packageNameChars);
+
+    return matches;
 }
 
+} // namespace bakingapp::keys
+
 extern "C" {
 
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /* reserved */) {
+    bakingapp::ThreadPool::setSharedHooks({attachWorker, detachWorker, vm});
+    Telemetry::shared().record(EventType::LIBRARY_LOAD);
+    return JNI_VERSION_1_6;
+}
+
 /**
  * Returns the decoded API key after package verification
  * 
@@ -153,8 +185,7 @@ Java_com_eslam_bakingapp_core_security_NativeKeyProvider_getApiKeyNative(
     }
 
     // Decode and return the API key
-    std::string apiKey = decodeKey(API_KEY_ENCODED, XOR_KEY_API);
-    return env->NewStringUTF(apiKey.c_str());
+    return decodeKey(env, API_KEY_NAME, bakingapp::keys::findKey(KeyId::API));
 }
 
 /**
@@ -177,8 +208,81 @@ Java_com_eslam_bakingapp_core_security_NativeKeyProvider_getSecretKeyNative(
     }
 
     // Decode and return the secret key
-    std::string secretKey = decodeKey(SECRET_KEY_ENCODED, XOR_KEY_SECRET);
-    return env->NewStringUTF(secretKey.c_str());
+    return decodeKey(env, SECRET_KEY_NAME, bakingapp::keys::findKey(KeyId::SECRET));
+}
+
+/**
+ * Returns any registry key by its string ID after package verification
+ *
+ * @param env JNI environment pointer
+ * @param thiz Reference to the calling object
+ * @param context Android Context for package verification
+ * @param id Key name from key-definitions.h, e.g. "staging.api"
+ * @return Decoded key, or empty string if the ID is unknown or verification fails
+ */
+JNIEXPORT jstring JNICALL
+Java_com_eslam_bakingapp_core_security_NativeKeyProvider_getKeyNative(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jobject context,
+        jstring id
+) {
+    if (id == nullptr || !verifyPackageName(env, context)) {
+        return env->NewStringUTF("");
+    }
+
+    const char* idChars = env->GetStringUTFChars(id, nullptr);
+    if (idChars == nullptr) {
+        return env->NewStringUTF("");
+    }
+    const std::string_view name(idChars, static_cast<size_t>(env->GetStringUTFLength(id)));
+    jstring result = decodeKey(env, name, bakingapp::keys::findKey(name));
+    env->ReleaseStringUTFChars(id, idChars);
+
+    return result;
+}
+
+/**
+ * Opens the encrypted key blob asset; later key fetches look in it before
+ * the compiled registry. Opening maps the blob and reads its header only.
+ *
+ * @param env JNI environment pointer
+ * @param thiz Reference to the calling object
+ * @param fd Descriptor of the file holding the blob, e.g. the APK; may be
+ *   closed once this returns
+ * @param offset Start of the blob in that file
+ * @param length Blob size in bytes
+ * @return true if the blob is open, now or from an earlier call
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_NativeKeyProvider_openKeyBlobNative(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jint fd,
+        jlong offset,
+        jlong length
+) {
+    if (fd < 0 || offset < 0 || length <= 0) {
+        return JNI_FALSE;
+    }
+
+    pthread_mutex_lock(&blobMutex);
+    bool opened = sharedBlob.load(std::memory_order_relaxed) != nullptr;
+    if (!opened) {
+        uint8_t key[BLOB_KEY_BYTES];
+        auto* blob = bakingapp::createTagged<KeyBlob>(MemoryTag::KEYS);
+        opened = blob != nullptr && bakingapp::keys::decodeBlobKey(key, sizeof(key)) &&
+                 blob->open(fd, static_cast<uint64_t>(offset), static_cast<size_t>(length), key);
+        bakingapp::crypto::secureZero(key, sizeof(key));
+        if (opened) {
+            sharedBlob.store(blob, std::memory_order_release);
+        } else {
+            bakingapp::destroyTagged(blob);
+        }
+    }
+    pthread_mutex_unlock(&blobMutex);
+
+    return opened ? JNI_TRUE : JNI_FALSE;
 }
 
 /**
@@ -194,8 +298,9 @@ Java_com_eslam_bakingapp_core_security_NativeKeyProvider_getAppIdentifierNative(
         JNIEnv* env,
         jobject /* thiz */
 ) {
-    std::string identifier = buildCompositeIdentifier();
-    return env->NewStringUTF(identifier.c_str());
+    char identifier[32];
+    buildCompositeIdentifier(identifier, sizeof(identifier));
+    return env->NewStringUTF(identifier);
 }
 
 /**
@@ -218,12 +323,14 @@ Java_com_eslam_bakingapp_core_security_NativeKeyProvider_validateKeyFormatNative
     }
 
     const char* keyChars = env->GetStringUTFChars(keyToValidate, nullptr);
-    std::string key(keyChars);
-    env->ReleaseStringUTFChars(keyToValidate, keyChars);
+    if (keyChars == nullptr) {
+        return JNI_FALSE;
+    }
 
     // Validate key format: should start with "bk_" or "sk_"
-    bool isValid = (key.length() > 3) &&
-                   (key.substr(0, 3) == "bk_" || key.substr(0, 3) == "sk_");
+    bool isValid = strlen(keyChars) > 3 &&
+                   (strncmp(keyChars, "bk_", 3) == 0 || strncmp(keyChars, "sk_", 3) == 0);
+    env->ReleaseStringUTFChars(keyToValidate, keyChars);
 
     return isValid ? JNI_TRUE : JNI_FALSE;
 }
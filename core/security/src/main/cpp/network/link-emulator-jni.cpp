@@ -0,0 +1,153 @@
+/**
+ * JNI bridge for the network link emulator
+ *
+ * nativeCreate() caches NativeLinkEmulator's static onRelease(long, boolean)
+ * and starts the timer thread, attached to the VM as a daemon for its whole
+ * life. Every release is one upcall from that thread; the Kotlin side only
+ * hands the request on to OkHttp's dispatcher there.
+ */
+
+#include <jni.h>
+
+#include "common/native-memory.h"
+#include "network/link-emulator.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::WorkerHooks;
+using bakingapp::network::LinkDirection;
+using bakingapp::network::LinkEmulator;
+using bakingapp::network::LinkProfile;
+
+namespace {
+    struct JniLink {
+        LinkEmulator emulator;
+        JavaVM* vm = nullptr;
+        jclass owner = nullptr;
+        jmethodID onRelease = nullptr;
+        JNIEnv* env = nullptr;      // the timer thread's
+    };
+
+    JniLink* fromHandle(jlong handle) {
+        return reinterpret_cast<JniLink*>(handle);
+    }
+
+    void attachTimer(uint32_t /* index */, void* context) {
+        auto* link = static_cast<JniLink*>(context);
+        JavaVMAttachArgs args {JNI_VERSION_1_6, "native-link", nullptr};
+        if (link->vm->AttachCurrentThreadAsDaemon(&link->env, &args) != JNI_OK) {
+            link->env = nullptr;
+        }
+    }
+
+    void detachTimer(uint32_t /* index */, void* context) {
+        auto* link = static_cast<JniLink*>(context);
+        if (link->env != nullptr) link->vm->DetachCurrentThread();
+        link->env = nullptr;
+    }
+
+    void release(uint64_t ticket, bool delivered, void* context) {
+        auto* link = static_cast<JniLink*>(context);
+        JNIEnv* env = link->env;
+        if (env == nullptr) return;
+        env->CallStaticVoidMethod(link->owner, link->onRelease, static_cast<jlong>(ticket),
+                                  delivered ? JNI_TRUE : JNI_FALSE);
+        if (env->ExceptionCheck()) env->ExceptionClear();
+    }
+
+    void destroyLink(JNIEnv* env, JniLink* link) {
+        link->emulator.stop();
+        if (link->owner != nullptr) env->DeleteGlobalRef(link->owner);
+        bakingapp::destroyTagged(link);
+    }
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_network_NativeLinkEmulator_nativeCreate(
+        JNIEnv* env,
+        jobject thiz
+) {
+    auto* link = bakingapp::createTagged<JniLink>(MemoryTag::RUNTIME);
+    if (link == nullptr) return 0;
+    if (env->GetJavaVM(&link->vm) != JNI_OK) {
+        destroyLink(env, link);
+        return 0;
+    }
+
+    jclass localClass = env->GetObjectClass(thiz);
+    link->onRelease = env->GetStaticMethodID(localClass, "onRelease", "(JZ)V");
+    if (link->onRelease == nullptr) {
+        env->ExceptionClear();
+        env->DeleteLocalRef(localClass);
+        destroyLink(env, link);
+        return 0;
+    }
+    link->owner = static_cast<jclass>(env->NewGlobalRef(localClass));
+    env->DeleteLocalRef(localClass);
+
+    const WorkerHooks hooks {attachTimer, detachTimer, link};
+    if (link->owner == nullptr || !link->emulator.start(release, link, &hooks)) {
+        destroyLink(env, link);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(link);
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_network_NativeLinkEmulator_nativeConfigure(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle,
+        jint latencyMicros,
+        jint jitterMicros,
+        jlong bytesPerSecond,
+        jint burstBytes,
+        jint lossPerMillion,
+        jint packetBytes
+) {
+    JniLink* link = fromHandle(handle);
+    if (link == nullptr) return;
+
+    LinkProfile profile;
+    profile.latencyMicros = static_cast<uint32_t>(latencyMicros > 0 ? latencyMicros : 0);
+    profile.jitterMicros = static_cast<uint32_t>(jitterMicros > 0 ? jitterMicros : 0);
+    profile.bytesPerSecond = static_cast<uint64_t>(bytesPerSecond > 0 ? bytesPerSecond : 0);
+    profile.burstBytes = static_cast<uint32_t>(burstBytes > 0 ? burstBytes : 0);
+    profile.lossPerMillion = static_cast<uint32_t>(lossPerMillion > 0 ? lossPerMillion : 0);
+    profile.packetBytes = static_cast<uint32_t>(packetBytes > 0 ? packetBytes : 1);
+    link->emulator.configure(profile);
+}
+
+/**
+ * @return the ticket onRelease will report, or 0 if the transfer could not
+ *   be queued
+ */
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_network_NativeLinkEmulator_nativeTransfer(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle,
+        jboolean upstream,
+        jlong bytes
+) {
+    JniLink* link = fromHandle(handle);
+    if (link == nullptr) return 0;
+    const LinkDirection direction = upstream ? LinkDirection::UP : LinkDirection::DOWN;
+    return static_cast<jlong>(
+        link->emulator.transfer(direction, static_cast<uint64_t>(bytes > 0 ? bytes : 0)));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_network_NativeLinkEmulator_nativeCancel(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle,
+        jlong ticket
+) {
+    JniLink* link = fromHandle(handle);
+    return link != nullptr && link->emulator.cancel(static_cast<uint64_t>(ticket))
+               ? JNI_TRUE : JNI_FALSE;
+}
+
+} // extern "C"
@@ -0,0 +1,276 @@
+#include "network/link-emulator.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+#include "common/native-memory.h"
+
+namespace bakingapp::network {
+
+namespace {
+    constexpr int64_t NANOS_PER_SECOND = 1000000000LL;
+    constexpr int64_t MIN_RETRANSMIT_TIMEOUT_NANOS = 200LL * 1000 * 1000;
+    constexpr uint32_t INITIAL_HEAP_CAPACITY = 256;
+    constexpr double PER_MILLION = 1e6;
+}
+
+int64_t monotonicNanos() {
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * NANOS_PER_SECOND + ts.tv_nsec;
+}
+
+// ==================== LinkModel ====================
+
+void LinkModel::configure(const LinkProfile& profile, int64_t nowNanos) {
+    profile_ = profile;
+    if (profile_.packetBytes == 0) profile_.packetBytes = 1;
+    for (Bucket& bucket : buckets_) {
+        bucket.tokens = profile_.burstBytes;
+        bucket.updatedNanos = nowNanos;
+    }
+}
+
+uint64_t LinkModel::nextRandom() {
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 7;
+    random_ ^= random_ << 17;
+    return random_;
+}
+
+double LinkModel::uniform() {
+    return static_cast<double>(nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int64_t LinkModel::retransmitTimeoutNanos() const {
+    // Roughly TCP's: a round trip plus margin, never below 200 ms
+    const int64_t roundTrip = 2 * (static_cast<int64_t>(profile_.latencyMicros) +
+                                   profile_.jitterMicros) * 1000;
+    return roundTrip * 2 > MIN_RETRANSMIT_TIMEOUT_NANOS ? roundTrip * 2
+                                                         : MIN_RETRANSMIT_TIMEOUT_NANOS;
+}
+
+LinkPlan LinkModel::plan(LinkDirection direction, uint64_t bytes, int64_t nowNanos) {
+    LinkPlan plan {nowNanos, 0, true};
+
+    // Bandwidth: the bytes leave once the bucket is out of debt
+    if (profile_.bytesPerSecond > 0) {
+        Bucket& bucket = buckets_[static_cast<uint8_t>(direction)];
+        if (nowNanos > bucket.updatedNanos) {
+            const double refill = static_cast<double>(nowNanos - bucket.updatedNanos) *
+                                  profile_.bytesPerSecond / NANOS_PER_SECOND;
+            bucket.tokens += refill;
+            if (bucket.tokens > profile_.burstBytes) bucket.tokens = profile_.burstBytes;
+            bucket.updatedNanos = nowNanos;
+        }
+        bucket.tokens -= static_cast<double>(bytes);
+        if (bucket.tokens < 0) {
+            plan.deadlineNanos += static_cast<int64_t>(-bucket.tokens * NANOS_PER_SECOND /
+                                                       profile_.bytesPerSecond);
+        }
+    }
+
+    plan.deadlineNanos += static_cast<int64_t>(profile_.latencyMicros) * 1000;
+    if (profile_.jitterMicros > 0) {
+        plan.deadlineNanos += static_cast<int64_t>(uniform() * profile_.jitterMicros * 1000);
+    }
+
+    // Loss: jump from one lost packet to the next with geometric gaps
+    // instead of drawing once per packet
+    if (profile_.lossPerMillion > 0) {
+        const double loss = profile_.lossPerMillion >= PER_MILLION
+                                ? 1.0 : profile_.lossPerMillion / PER_MILLION;
+        const uint64_t packets = bytes == 0 ? 1 : (bytes + profile_.packetBytes - 1) /
+                                                  profile_.packetBytes;
+        const double logKeep = loss < 1.0 ? std::log(1.0 - loss) : 0;
+        uint64_t packet = 0;
+        while (true) {
+            if (loss < 1.0) {
+                const double u = 1.0 - uniform();   // (0, 1]
+                packet += static_cast<uint64_t>(std::log(u) / logKeep);
+            }
+            if (packet >= packets) break;
+
+            // Packet `packet` is lost; its retransmissions may be too
+            uint32_t attempts = 1;
+            while (attempts <= MAX_RETRANSMITS && uniform() < loss) attempts++;
+            plan.retransmits += attempts > MAX_RETRANSMITS ? MAX_RETRANSMITS : attempts;
+            if (attempts > MAX_RETRANSMITS) {
+                plan.delivered = false;
+                break;
+            }
+            packet++;
+        }
+        plan.deadlineNanos += static_cast<int64_t>(plan.retransmits) * retransmitTimeoutNanos();
+    }
+    return plan;
+}
+
+// ==================== LinkEmulator ====================
+
+LinkEmulator::~LinkEmulator() {
+    stop();
+    taggedFree(heap_);
+}
+
+bool LinkEmulator::start(LinkRelease release, void* context, const WorkerHooks* hooks) {
+    LockGuard lock(mutex_);
+    if (running_) return false;
+    release_ = release;
+    context_ = context;
+    hasHooks_ = hooks != nullptr;
+    if (hooks != nullptr) hooks_ = *hooks;
+    model_.configure(model_.profile(), monotonicNanos());
+
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&wake_, &attributes);
+    pthread_condattr_destroy(&attributes);
+
+    stopping_ = false;
+    if (pthread_create(&thread_, nullptr, threadMain, this) != 0) {
+        pthread_cond_destroy(&wake_);
+        return false;
+    }
+    running_ = true;
+    return true;
+}
+
+void LinkEmulator::stop() {
+    {
+        LockGuard lock(mutex_);
+        if (!running_) return;
+        stopping_ = true;
+        pthread_cond_signal(&wake_);
+    }
+    pthread_join(thread_, nullptr);
+
+    LockGuard lock(mutex_);
+    running_ = false;
+    count_ = 0;
+    pthread_cond_destroy(&wake_);
+}
+
+void LinkEmulator::configure(const LinkProfile& profile) {
+    LockGuard lock(mutex_);
+    model_.configure(profile, monotonicNanos());
+}
+
+uint64_t LinkEmulator::transfer(LinkDirection direction, uint64_t bytes) {
+    LockGuard lock(mutex_);
+    if (!running_) return 0;
+    const LinkPlan plan = model_.plan(direction, bytes, monotonicNanos());
+    const Entry entry {plan.deadlineNanos, nextTicket_, plan.delivered};
+    if (!push(entry)) return 0;
+    nextTicket_++;
+    // Only an earlier first deadline changes how long the thread sleeps
+    if (heap_[0].ticket == entry.ticket) pthread_cond_signal(&wake_);
+    return entry.ticket;
+}
+
+bool LinkEmulator::cancel(uint64_t ticket) {
+    LockGuard lock(mutex_);
+    for (uint32_t i = 0; i < count_; i++) {
+        if (heap_[i].ticket == ticket) {
+            removeAt(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t LinkEmulator::pending() {
+    LockGuard lock(mutex_);
+    return count_;
+}
+
+bool LinkEmulator::push(const Entry& entry) {
+    if (count_ == capacity_) {
+        const uint32_t grown = capacity_ > 0 ? capacity_ * 2 : INITIAL_HEAP_CAPACITY;
+        auto* heap = static_cast<Entry*>(
+            taggedRealloc(MemoryTag::RUNTIME, heap_, sizeof(Entry) * grown));
+        if (heap == nullptr) return false;
+        heap_ = heap;
+        capacity_ = grown;
+    }
+    heap_[count_] = entry;
+    siftUp(count_++);
+    return true;
+}
+
+void LinkEmulator::removeAt(uint32_t index) {
+    count_--;
+    if (index == count_) return;
+    heap_[index] = heap_[count_];
+    siftUp(index);
+    siftDown(index);
+}
+
+void LinkEmulator::siftUp(uint32_t index) {
+    const Entry entry = heap_[index];
+    while (index > 0) {
+        const uint32_t parent = (index - 1) / 2;
+        if (heap_[parent].deadlineNanos <= entry.deadlineNanos) break;
+        heap_[index] = heap_[parent];
+        index = parent;
+    }
+    heap_[index] = entry;
+}
+
+void LinkEmulator::siftDown(uint32_t index) {
+    const Entry entry = heap_[index];
+    while (true) {
+        uint32_t child = index * 2 + 1;
+        if (child >= count_) break;
+        if (child + 1 < count_ && heap_[child + 1].deadlineNanos < heap_[child].deadlineNanos) {
+            child++;
+        }
+        if (heap_[child].deadlineNanos >= entry.deadlineNanos) break;
+        heap_[index] = heap_[child];
+        index = child;
+    }
+    heap_[index] = entry;
+}
+
+void* LinkEmulator::threadMain(void* argument) {
+    auto* emulator = static_cast<LinkEmulator*>(argument);
+    pthread_setname_np(pthread_self(), "bk-link");
+    if (emulator->hasHooks_ && emulator->hooks_.onStart != nullptr) {
+        emulator->hooks_.onStart(0, emulator->hooks_.context);
+    }
+    emulator->run();
+    if (emulator->hasHooks_ && emulator->hooks_.onStop != nullptr) {
+        emulator->hooks_.onStop(0, emulator->hooks_.context);
+    }
+    return nullptr;
+}
+
+void LinkEmulator::run() {
+    mutex_.lock();
+    while (!stopping_) {
+        if (count_ == 0) {
+            pthread_cond_wait(&wake_, mutex_.native());
+            continue;
+        }
+        const int64_t now = monotonicNanos();
+        if (heap_[0].deadlineNanos > now) {
+            const int64_t deadline = heap_[0].deadlineNanos;
+            timespec until {static_cast<time_t>(deadline / NANOS_PER_SECOND),
+                            static_cast<long>(deadline % NANOS_PER_SECOND)};
+            pthread_cond_timedwait(&wake_, mutex_.native(), &until);
+            continue;
+        }
+
+        // Release outside the lock so the callback may queue the next leg
+        const Entry due = heap_[0];
+        removeAt(0);
+        mutex_.unlock();
+        release_(due.ticket, due.delivered, context_);
+        mutex_.lock();
+    }
+    mutex_.unlock();
+}
+
+} // namespace bakingapp::network
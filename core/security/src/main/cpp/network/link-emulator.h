@@ -0,0 +1,160 @@
+/**
+ * Network link emulator for debug builds
+ *
+ * Decides when a transfer of n bytes over an emulated link would arrive,
+ * and releases it then from a single timer thread, so any number of
+ * delayed requests are in flight without a thread each.
+ *
+ * LinkModel is the pure part, driven by explicit timestamps:
+ * - latency: fixed one-way delay plus uniform jitter in [0, jitter)
+ * - bandwidth: one token bucket per direction, refilled at the link rate
+ *   and at most burstBytes deep; a transfer takes its bytes out at once
+ *   and may leave the bucket in debt, which later transfers queue behind
+ * - loss: each packet of packetBytes is lost independently; a lost packet
+ *   costs a retransmission timeout, and the transfer fails once one packet
+ *   was lost more than MAX_RETRANSMITS times in a row
+ *
+ * LinkEmulator adds the timer thread: a binary min-heap of deadlines under
+ * a mutex, and a condition variable on CLOCK_MONOTONIC that sleeps until
+ * the earliest one.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+
+#include "common/mutex.h"
+#include "common/thread-pool.h"
+
+namespace bakingapp::network {
+
+constexpr uint32_t MAX_RETRANSMITS = 3;
+
+enum class LinkDirection : uint8_t {
+    UP = 0,
+    DOWN = 1,
+};
+
+struct LinkProfile {
+    uint32_t latencyMicros = 0;         // one way
+    uint32_t jitterMicros = 0;
+    uint64_t bytesPerSecond = 0;        // 0: unlimited
+    uint32_t burstBytes = 64 * 1024;
+    uint32_t lossPerMillion = 0;        // per packet
+    uint32_t packetBytes = 1500;
+};
+
+struct LinkPlan {
+    int64_t deadlineNanos;
+    uint32_t retransmits;
+    bool delivered;
+};
+
+class LinkModel {
+public:
+    explicit LinkModel(uint64_t seed = 0x9E3779B97F4A7C15ULL) : random_(seed | 1) {}
+
+    /**
+     * Takes effect for transfers planned from now on; buckets start full
+     */
+    void configure(const LinkProfile& profile, int64_t nowNanos);
+
+    const LinkProfile& profile() const { return profile_; }
+
+    /**
+     * When bytes sent at nowNanos would have crossed the link
+     */
+    LinkPlan plan(LinkDirection direction, uint64_t bytes, int64_t nowNanos);
+
+private:
+    struct Bucket {
+        double tokens;          // bytes; negative while in debt
+        int64_t updatedNanos;
+    };
+
+    uint64_t nextRandom();
+    double uniform();
+    int64_t retransmitTimeoutNanos() const;
+
+    LinkProfile profile_ {};
+    Bucket buckets_[2] {};
+    uint64_t random_;
+};
+
+/**
+ * Called on the timer thread for each released transfer
+ */
+using LinkRelease = void (*)(uint64_t ticket, bool delivered, void* context);
+
+class LinkEmulator {
+public:
+    LinkEmulator() = default;
+    ~LinkEmulator();
+
+    LinkEmulator(const LinkEmulator&) = delete;
+    LinkEmulator& operator=(const LinkEmulator&) = delete;
+
+    /**
+     * Starts the timer thread. hooks run on it (index 0) as it starts and
+     * stops, e.g. to attach it to the JVM.
+     */
+    bool start(LinkRelease release, void* context, const WorkerHooks* hooks = nullptr);
+
+    /**
+     * Joins the timer thread; transfers still pending are dropped
+     */
+    void stop();
+
+    void configure(const LinkProfile& profile);
+
+    /**
+     * Plans a transfer and queues its release
+     *
+     * @return a ticket (never 0), or 0 when out of memory or not started
+     */
+    uint64_t transfer(LinkDirection direction, uint64_t bytes);
+
+    /**
+     * @return false if the ticket was already released (or never existed)
+     */
+    bool cancel(uint64_t ticket);
+
+    uint32_t pending();
+
+private:
+    struct Entry {
+        int64_t deadlineNanos;
+        uint64_t ticket;
+        bool delivered;
+    };
+
+    bool push(const Entry& entry);
+    void removeAt(uint32_t index);
+    void siftUp(uint32_t index);
+    void siftDown(uint32_t index);
+    void run();
+    static void* threadMain(void* argument);
+
+    Mutex mutex_;
+    pthread_cond_t wake_ {};
+    pthread_t thread_ {};
+    bool running_ = false;
+    bool stopping_ = false;
+
+    LinkModel model_;
+    Entry* heap_ = nullptr;
+    uint32_t count_ = 0;
+    uint32_t capacity_ = 0;
+    uint64_t nextTicket_ = 1;
+
+    LinkRelease release_ = nullptr;
+    void* context_ = nullptr;
+    WorkerHooks hooks_ {};
+    bool hasHooks_ = false;
+};
+
+int64_t monotonicNanos();
+
+} // namespace bakingapp::network
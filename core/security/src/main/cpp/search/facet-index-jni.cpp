@@ -0,0 +1,263 @@
+/**
+ * JNI bridge for NativeFacetIndex
+ *
+ * One FacetIndex behind a lock. Recipes come in one call per recipe. A
+ * filter crosses as one accepted-value mask per facet, built by the caller
+ * from the value lists nativeValues() returns (a value's id is its index
+ * there); evaluation fills a counts array and returns the matching ids.
+ */
+
+#include <jni.h>
+
+#include <cstdlib>
+
+#include "common/jni-text.h"
+#include "common/mutex.h"
+#include "common/native-memory.h"
+#include "search/facet-index.h"
+#include "search/jni-index.h"
+
+using bakingapp::JniText;
+using bakingapp::LockGuard;
+using bakingapp::MemoryTag;
+using bakingapp::search::FACET_COUNT;
+using bakingapp::search::Facet;
+using bakingapp::search::FacetCounts;
+using bakingapp::search::FacetFilter;
+using bakingapp::search::FacetIndex;
+using bakingapp::search::FacetRecipe;
+using bakingapp::search::FacetStats;
+using bakingapp::search::MAX_FACET_VALUES;
+using bakingapp::taggedFree;
+using bakingapp::taggedMalloc;
+
+namespace {
+    constexpr jint MAX_LIMIT = 1000;
+    // [total, then MAX_FACET_VALUES counts per facet]
+    constexpr jsize COUNTS_LENGTH = 1 + FACET_COUNT * MAX_FACET_VALUES;
+
+    using JniIndex = bakingapp::search::JniIndex<FacetIndex>;
+
+    uint32_t minutes(jint value) {
+        return value > 0 ? static_cast<uint32_t>(value) : 0;
+    }
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeFacetIndex_nativeCreate(
+        JNIEnv* /* env */,
+        jobject /* thiz */
+) {
+    return reinterpret_cast<jlong>(bakingapp::createTagged<JniIndex>(MemoryTag::INDEXES));
+}
+
+/**
+ * Adds one recipe or replaces its values
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeFacetIndex_nativeSetRecipe(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id,
+        jstring category,
+        jstring difficulty,
+        jboolean favorite,
+        jint prepMinutes,
+        jint cookMinutes
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    JniText categoryText(env, category);
+    JniText difficultyText(env, difficulty);
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    const FacetRecipe recipe {categoryText.chars(), categoryText.length(),
+                              difficultyText.chars(), difficultyText.length(),
+                              favorite == JNI_TRUE, minutes(prepMinutes), minutes(cookMinutes)};
+    LockGuard lock(index->mutex);
+    return index->index.setRecipe(idText.chars(), idText.length(), recipe) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeFacetIndex_nativeSetFavorite(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id,
+        jboolean favorite
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    const bool set =
+        index->index.setFavorite(idText.chars(), idText.length(), favorite == JNI_TRUE);
+    return set ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeFacetIndex_nativeRemoveRecipe(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    return index->index.removeRecipe(idText.chars(), idText.length()) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return the category or difficulty values by id; null for other facets
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeFacetIndex_nativeValues(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jint facet
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr ||
+        (facet != static_cast<jint>(Facet::CATEGORY) &&
+         facet != static_cast<jint>(Facet::DIFFICULTY))) {
+        return nullptr;
+    }
+    jclass stringClass = env->FindClass("java/lang/String");
+    if (stringClass == nullptr) return nullptr;
+
+    LockGuard lock(index->mutex);
+    const auto which = static_cast<Facet>(facet);
+    const uint32_t count = index->index.valueCount(which);
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(count), stringClass, nullptr);
+    for (uint32_t value = 0; result != nullptr && value < count; value++) {
+        // Interned values are NUL-terminated
+        jstring text = env->NewStringUTF(index->index.valueText(which, value, nullptr));
+        if (text == nullptr) {
+            result = nullptr;
+            break;
+        }
+        env->SetObjectArrayElement(result, static_cast<jsize>(value), text);
+        env->DeleteLocalRef(text);
+    }
+    return result;
+}
+
+/**
+ * Matches a filter and counts every facet value in one pass
+ *
+ * @param masks accepted values per facet, in Facet order
+ * @param counts receives the total, then MAX_FACET_VALUES counts per facet
+ * @return up to limit matching recipe ids, in indexing order
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeFacetIndex_nativeEvaluate(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jlongArray masks,
+        jlongArray counts,
+        jint limit
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || masks == nullptr || counts == nullptr || limit < 0 ||
+        env->GetArrayLength(masks) != static_cast<jsize>(FACET_COUNT) ||
+        env->GetArrayLength(counts) < COUNTS_LENGTH) {
+        return nullptr;
+    }
+    if (limit > MAX_LIMIT) limit = MAX_LIMIT;
+
+    FacetFilter filter {};
+    jlong values[FACET_COUNT];
+    env->GetLongArrayRegion(masks, 0, FACET_COUNT, values);
+    for (uint32_t f = 0; f < FACET_COUNT; f++) {
+        filter.values[f] = static_cast<uint64_t>(values[f]);
+    }
+
+    jclass stringClass = env->FindClass("java/lang/String");
+    if (stringClass == nullptr) return nullptr;
+    auto* facetCounts = static_cast<FacetCounts*>(
+        taggedMalloc(MemoryTag::INDEXES, sizeof(FacetCounts)));
+    // One more than limit so a zero limit still gets a buffer
+    auto* recipes = static_cast<uint32_t*>(
+        taggedMalloc(MemoryTag::INDEXES, sizeof(uint32_t) * (static_cast<size_t>(limit) + 1)));
+    if (facetCounts == nullptr || recipes == nullptr) {
+        taggedFree(facetCounts);
+        taggedFree(recipes);
+        return nullptr;
+    }
+
+    jobjectArray result = nullptr;
+    {
+        LockGuard lock(index->mutex);
+        const size_t count =
+            index->index.evaluate(filter, facetCounts, recipes, static_cast<size_t>(limit));
+        result = env->NewObjectArray(static_cast<jsize>(count), stringClass, nullptr);
+        for (size_t i = 0; result != nullptr && i < count; i++) {
+            // Ids were NUL-terminated when they were interned
+            jstring id = env->NewStringUTF(index->index.recipeId(recipes[i], nullptr));
+            if (id == nullptr) {
+                result = nullptr;
+                break;
+            }
+            env->SetObjectArrayElement(result, static_cast<jsize>(i), id);
+            env->DeleteLocalRef(id);
+        }
+    }
+    if (result != nullptr) {
+        jlong out[COUNTS_LENGTH];
+        out[0] = static_cast<jlong>(facetCounts->total);
+        for (uint32_t f = 0; f < FACET_COUNT; f++) {
+            for (uint32_t v = 0; v < MAX_FACET_VALUES; v++) {
+                out[1 + f * MAX_FACET_VALUES + v] = facetCounts->values[f][v];
+            }
+        }
+        env->SetLongArrayRegion(counts, 0, COUNTS_LENGTH, out);
+    }
+    taggedFree(facetCounts);
+    taggedFree(recipes);
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeFacetIndex_nativeClear(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return;
+    LockGuard lock(index->mutex);
+    index->index.clear();
+}
+
+/**
+ * @return [recipes, values, bitsetBytes]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeFacetIndex_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return nullptr;
+    FacetStats stats;
+    {
+        LockGuard lock(index->mutex);
+        stats = index->index.stats();
+    }
+    const jlong values[3] = {stats.recipes, stats.values, static_cast<jlong>(stats.bitsetBytes)};
+    jlongArray result = env->NewLongArray(3);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 3, values);
+    return result;
+}
+
+} // extern "C"
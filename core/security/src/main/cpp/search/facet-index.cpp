@@ -0,0 +1,350 @@
+#include "search/facet-index.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bakingapp::search {
+
+using strings::StringPool;
+
+namespace {
+    // Rows per evaluation step, and the unit bitsets grow by; the step's
+    // masks (a few KB) stay in L1 while every value's bitset streams past
+    constexpr uint32_t BLOCK_WORDS = 64;
+
+    constexpr uint32_t CATEGORY = static_cast<uint32_t>(Facet::CATEGORY);
+    constexpr uint32_t DIFFICULTY = static_cast<uint32_t>(Facet::DIFFICULTY);
+    constexpr uint32_t FAVORITE = static_cast<uint32_t>(Facet::FAVORITE);
+    constexpr uint32_t PREP_TIME = static_cast<uint32_t>(Facet::PREP_TIME);
+    constexpr uint32_t COOK_TIME = static_cast<uint32_t>(Facet::COOK_TIME);
+
+    inline uint32_t popcount(uint64_t word) {
+        return static_cast<uint32_t>(__builtin_popcountll(word));
+    }
+
+    /**
+     * The bits set in a & b over one block
+     */
+    uint32_t andCount(const uint64_t* a, const uint64_t* b) {
+#if defined(__ARM_NEON)
+        // Per-byte counts, summed pairwise into 16-bit lanes: at most
+        // 16 bits per lane per step, 512 over the 32 steps
+        uint16x8_t counts = vdupq_n_u16(0);
+        for (uint32_t i = 0; i < BLOCK_WORDS; i += 2) {
+            const uint64x2_t v = vandq_u64(vld1q_u64(a + i), vld1q_u64(b + i));
+            counts = vpadalq_u8(counts, vcntq_u8(vreinterpretq_u8_u64(v)));
+        }
+        const uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(counts));
+        return static_cast<uint32_t>(vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1));
+#elif defined(__SSE2__)
+        // SSE2 has no popcount: bits are summed within each byte by halving
+        // steps, then the bytes of each 64-bit lane by _mm_sad_epu8
+        const __m128i m1 = _mm_set1_epi8(0x55);
+        const __m128i m2 = _mm_set1_epi8(0x33);
+        const __m128i m4 = _mm_set1_epi8(0x0F);
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sums = zero;
+        for (uint32_t i = 0; i < BLOCK_WORDS; i += 2) {
+            __m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), m1));
+            v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi64(v, 2), m2));
+            v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), m4);
+            sums = _mm_add_epi64(sums, _mm_sad_epu8(v, zero));
+        }
+        alignas(16) uint64_t lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sums);
+        return static_cast<uint32_t>(lanes[0] + lanes[1]);
+#else
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < BLOCK_WORDS; i++) count += popcount(a[i] & b[i]);
+        return count;
+#endif
+    }
+
+    inline void andInto(uint64_t* out, const uint64_t* a) {
+        for (uint32_t i = 0; i < BLOCK_WORDS; i++) out[i] &= a[i];
+    }
+
+    inline void orInto(uint64_t* out, const uint64_t* a) {
+        for (uint32_t i = 0; i < BLOCK_WORDS; i++) out[i] |= a[i];
+    }
+
+    inline bool testBit(const uint64_t* bits, uint32_t row) {
+        return (bits[row >> 6] >> (row & 63)) & 1;
+    }
+}
+
+FacetIndex::~FacetIndex() {
+    clear();
+    taggedFree(live_);
+    for (uint8_t* column : columns_) taggedFree(column);
+}
+
+bool FacetIndex::setRecipe(const char* id, size_t idLength, const FacetRecipe& recipe) {
+    if (idLength == 0 || idLength > MAX_ID_LENGTH) return false;
+
+    uint8_t values[FACET_COUNT];
+    const uint32_t category = internValue(Facet::CATEGORY, recipe.category, recipe.categoryLength);
+    const uint32_t difficulty =
+        internValue(Facet::DIFFICULTY, recipe.difficulty, recipe.difficultyLength);
+    if (category == NO_VALUE || difficulty == NO_VALUE) return false;
+    values[CATEGORY] = static_cast<uint8_t>(category);
+    values[DIFFICULTY] = static_cast<uint8_t>(difficulty);
+    values[FAVORITE] = recipe.favorite ? 1 : 0;
+    values[PREP_TIME] = static_cast<uint8_t>(timeBucket(recipe.prepMinutes));
+    values[COOK_TIME] = static_cast<uint8_t>(timeBucket(recipe.cookMinutes));
+
+    const uint32_t row = ids_.intern(id, idLength);
+    if (row == StringPool::NONE || !reserveRows(row + 1)) return false;
+    const bool live = testBit(live_, row);
+    bool set = true;
+    for (uint32_t f = 0; f < FACET_COUNT; f++) {
+        if (live) clearBit(f, columns_[f][row], row);
+        set &= setBit(f, values[f], row);
+        columns_[f][row] = values[f];
+    }
+    if (!live) {
+        live_[row >> 6] |= uint64_t{1} << (row & 63);
+        liveCount_++;
+    }
+    return set;
+}
+
+bool FacetIndex::setFavorite(const char* id, size_t idLength, bool favorite) {
+    const uint32_t row = ids_.find(id, idLength);
+    if (row == StringPool::NONE || row >= wordCapacity_ * 64 || !testBit(live_, row)) {
+        return false;
+    }
+    const uint8_t value = favorite ? 1 : 0;
+    clearBit(FAVORITE, columns_[FAVORITE][row], row);
+    columns_[FAVORITE][row] = value;
+    return setBit(FAVORITE, value, row);
+}
+
+bool FacetIndex::removeRecipe(const char* id, size_t idLength) {
+    const uint32_t row = ids_.find(id, idLength);
+    if (row == StringPool::NONE || row >= wordCapacity_ * 64 || !testBit(live_, row)) {
+        return false;
+    }
+    for (uint32_t f = 0; f < FACET_COUNT; f++) clearBit(f, columns_[f][row], row);
+    live_[row >> 6] &= ~(uint64_t{1} << (row & 63));
+    liveCount_--;
+    return true;
+}
+
+size_t FacetIndex::evaluate(const FacetFilter& filter, FacetCounts* counts, uint32_t* recipes,
+                            size_t limit) const {
+    if (counts != nullptr) memset(counts, 0, sizeof(FacetCounts));
+    if (liveCount_ == 0) return 0;
+
+    // A facet whose filter accepts every value it has restricts nothing
+    // and is skipped; one accepting none of them matches nothing
+    bool filtered[FACET_COUNT];
+    uint32_t filteredCount = 0;
+    for (uint32_t f = 0; f < FACET_COUNT; f++) {
+        filtered[f] = (present_[f] & ~filter.values[f]) != 0;
+        filteredCount += filtered[f];
+    }
+
+    // Only the words up to the highest row ever used
+    const uint32_t rows = ids_.size() + 1;
+    const uint32_t blocks = ((rows + 63) / 64 + BLOCK_WORDS - 1) / BLOCK_WORDS;
+    alignas(16) uint64_t selected[FACET_COUNT][BLOCK_WORDS];
+    alignas(16) uint64_t others[BLOCK_WORDS];
+    alignas(16) uint64_t match[BLOCK_WORDS];
+    size_t written = 0;
+    uint64_t total = 0;
+
+    for (uint32_t block = 0; block < blocks; block++) {
+        const size_t start = static_cast<size_t>(block) * BLOCK_WORDS;
+        const uint64_t* live = live_ + start;
+
+        // Rows holding an accepted value, per filtered facet
+        for (uint32_t f = 0; f < FACET_COUNT; f++) {
+            if (!filtered[f]) continue;
+            memset(selected[f], 0, sizeof(selected[f]));
+            for (uint64_t accepted = present_[f] & filter.values[f]; accepted != 0;
+                 accepted &= accepted - 1) {
+                orInto(selected[f], bits_[f][__builtin_ctzll(accepted)] + start);
+            }
+        }
+        memcpy(match, live, sizeof(match));
+        for (uint32_t f = 0; f < FACET_COUNT; f++) {
+            if (filtered[f]) andInto(match, selected[f]);
+        }
+
+        if (counts != nullptr) {
+            const uint32_t matched = andCount(match, match);
+            total += matched;
+            for (uint32_t f = 0; f < FACET_COUNT; f++) {
+                if (present_[f] == 0) continue;
+                // Leaving out an unfiltered facet changes nothing
+                const uint64_t* base = match;
+                uint32_t remaining = matched;
+                if (filtered[f]) {
+                    base = live;
+                    if (filteredCount > 1) {
+                        memcpy(others, live, sizeof(others));
+                        for (uint32_t g = 0; g < FACET_COUNT; g++) {
+                            if (g != f && filtered[g]) andInto(others, selected[g]);
+                        }
+                        base = others;
+                    }
+                    remaining = andCount(base, base);
+                }
+                if (remaining == 0) continue;
+                // Every live row has exactly one value per facet, so the
+                // last value's count is what the others leave
+                const uint32_t last = 63 - static_cast<uint32_t>(__builtin_clzll(present_[f]));
+                for (uint64_t values = present_[f] & ~(uint64_t{1} << last); values != 0;
+                     values &= values - 1) {
+                    const uint32_t value = static_cast<uint32_t>(__builtin_ctzll(values));
+                    const uint32_t count = andCount(base, bits_[f][value] + start);
+                    counts->values[f][value] += count;
+                    remaining -= count;
+                }
+                counts->values[f][last] += remaining;
+            }
+        }
+
+        for (uint32_t w = 0; w < BLOCK_WORDS && written < limit; w++) {
+            for (uint64_t word = match[w]; word != 0 && written < limit; word &= word - 1) {
+                recipes[written++] =
+                    static_cast<uint32_t>((start + w) * 64 + __builtin_ctzll(word));
+            }
+        }
+    }
+    if (counts != nullptr) counts->total = total;
+    return written;
+}
+
+const char* FacetIndex::recipeId(uint32_t recipe, size_t* length) const {
+    return ids_.text(recipe, length);
+}
+
+uint32_t FacetIndex::findValue(Facet facet, const char* text, size_t length) const {
+    uint32_t id = StringPool::NONE;
+    if (facet == Facet::CATEGORY) {
+        id = categories_.find(text, length);
+    } else if (facet == Facet::DIFFICULTY) {
+        id = difficulties_.find(text, length);
+    }
+    return id != StringPool::NONE ? id - 1 : NO_VALUE;
+}
+
+uint32_t FacetIndex::valueCount(Facet facet) const {
+    switch (facet) {
+        case Facet::CATEGORY: return categories_.size();
+        case Facet::DIFFICULTY: return difficulties_.size();
+        case Facet::FAVORITE: return 2;
+        case Facet::PREP_TIME:
+        case Facet::COOK_TIME: return TIME_BUCKETS;
+    }
+    return 0;
+}
+
+const char* FacetIndex::valueText(Facet facet, uint32_t value, size_t* length) const {
+    if (facet == Facet::CATEGORY) return categories_.text(value + 1, length);
+    if (facet == Facet::DIFFICULTY) return difficulties_.text(value + 1, length);
+    return nullptr;
+}
+
+uint32_t FacetIndex::timeBucket(uint32_t minutes) {
+    uint32_t bucket = 0;
+    while (bucket < TIME_BUCKETS - 1 && minutes > TIME_BUCKET_LIMITS[bucket]) bucket++;
+    return bucket;
+}
+
+FacetStats FacetIndex::stats() const {
+    FacetStats stats {liveCount_, categories_.size() + difficulties_.size(), 0};
+    const uint64_t bitsetBytes = uint64_t{wordCapacity_} * sizeof(uint64_t);
+    if (live_ != nullptr) stats.bitsetBytes += bitsetBytes;
+    for (uint32_t f = 0; f < FACET_COUNT; f++) {
+        stats.bitsetBytes += bitsetBytes * static_cast<uint32_t>(__builtin_popcountll(present_[f]));
+    }
+    return stats;
+}
+
+void FacetIndex::clear() {
+    for (uint32_t f = 0; f < FACET_COUNT; f++) {
+        for (uint64_t*& bits : bits_[f]) {
+            taggedFree(bits);
+            bits = nullptr;
+        }
+        present_[f] = 0;
+        if (columns_[f] != nullptr) memset(columns_[f], 0, size_t{wordCapacity_} * 64);
+    }
+    if (live_ != nullptr) memset(live_, 0, sizeof(uint64_t) * wordCapacity_);
+    ids_.clear();
+    categories_.clear();
+    difficulties_.clear();
+    liveCount_ = 0;
+}
+
+uint32_t FacetIndex::internValue(Facet facet, const char* text, size_t length) {
+    StringPool& pool = facet == Facet::CATEGORY ? categories_ : difficulties_;
+    uint32_t id = pool.find(text, length);
+    // Checked before interning so a rejected value does not use up an id
+    if (id == StringPool::NONE && pool.size() < MAX_FACET_VALUES) id = pool.intern(text, length);
+    return id != StringPool::NONE ? id - 1 : NO_VALUE;
+}
+
+bool FacetIndex::reserveRows(uint32_t rows) {
+    const uint32_t words = ((rows + 63) / 64 + BLOCK_WORDS - 1) / BLOCK_WORDS * BLOCK_WORDS;
+    if (words <= wordCapacity_) return true;
+    const uint32_t capacity = std::max(words, wordCapacity_ * 2);
+    const size_t added = capacity - wordCapacity_;
+
+    // Each array is zeroed past the old capacity as soon as it grows, so a
+    // failure partway leaves the grown ones merely oversized
+    auto grow = [&](uint64_t** bits) {
+        auto* grown = static_cast<uint64_t*>(
+            taggedRealloc(MemoryTag::INDEXES, *bits, sizeof(uint64_t) * capacity));
+        if (grown == nullptr) return false;
+        memset(grown + wordCapacity_, 0, sizeof(uint64_t) * added);
+        *bits = grown;
+        return true;
+    };
+    if (!grow(&live_)) return false;
+    for (uint32_t f = 0; f < FACET_COUNT; f++) {
+        for (uint64_t*& bits : bits_[f]) {
+            if (bits != nullptr && !grow(&bits)) return false;
+        }
+        auto* column = static_cast<uint8_t*>(
+            taggedRealloc(MemoryTag::INDEXES, columns_[f], size_t{capacity} * 64));
+        if (column == nullptr) return false;
+        memset(column + size_t{wordCapacity_} * 64, 0, added * 64);
+        columns_[f] = column;
+    }
+    wordCapacity_ = capacity;
+    return true;
+}
+
+bool FacetIndex::setBit(uint32_t facet, uint32_t value, uint32_t row) {
+    uint64_t*& bits = bits_[facet][value];
+    if (bits == nullptr) {
+        bits = static_cast<uint64_t*>(
+            taggedCalloc(MemoryTag::INDEXES, wordCapacity_, sizeof(uint64_t)));
+        if (bits == nullptr) return false;
+        present_[facet] |= uint64_t{1} << value;
+    }
+    bits[row >> 6] |= uint64_t{1} << (row & 63);
+    return true;
+}
+
+void FacetIndex::clearBit(uint32_t facet, uint32_t value, uint32_t row) {
+    uint64_t* bits = bits_[facet][value];
+    if (bits != nullptr) bits[row >> 6] &= ~(uint64_t{1} << (row & 63));
+}
+
+} // namespace bakingapp::search
@@ -0,0 +1,173 @@
+/**
+ * Columnar facet index over recipe category, difficulty, favorite status
+ * and prep/cook time
+ *
+ * Every facet value holds a bitset with one bit per recipe row (rows are
+ * numbered by interned recipe id), and a byte column per facet records
+ * each row's value so an update knows which bits to clear. Category and
+ * difficulty values are interned strings; favorite is 0 or 1; times are
+ * bucketed by TIME_BUCKET_LIMITS.
+ *
+ * evaluate() answers a filter (any of a set of values per facet, every
+ * facet at once) in one pass over the bitsets, a block of rows at a time:
+ * it builds each facet's selection mask, ANDs them into the match mask
+ * and counts, for every value of every facet, the rows that would match
+ * if that facet alone were not filtered. Those are the counts a filter
+ * screen shows next to each choice. The counting runs 128 bits at a time
+ * with NEON or SSE2.
+ *
+ * Not synchronized: callers that share an index serialize on their own lock.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "strings/string-pool.h"
+
+namespace bakingapp::search {
+
+enum class Facet : uint8_t {
+    CATEGORY,
+    DIFFICULTY,
+    FAVORITE,
+    PREP_TIME,
+    COOK_TIME,
+};
+
+constexpr uint32_t FACET_COUNT = 5;
+
+// Distinct values per facet, so a filter fits a 64-bit mask
+constexpr uint32_t MAX_FACET_VALUES = 64;
+
+// Inclusive upper bounds in minutes of the time buckets; one more bucket
+// takes everything longer
+constexpr uint32_t TIME_BUCKET_LIMITS[] = {10, 20, 30, 45, 60, 90, 120};
+constexpr uint32_t TIME_BUCKETS = sizeof(TIME_BUCKET_LIMITS) / sizeof(uint32_t) + 1;
+
+/**
+ * One recipe's facet values
+ */
+struct FacetRecipe {
+    const char* category;
+    size_t categoryLength;
+    const char* difficulty;
+    size_t difficultyLength;
+    bool favorite;
+    uint32_t prepMinutes;
+    uint32_t cookMinutes;
+};
+
+/**
+ * Accepted values per facet, a bit per value; a recipe matches when each
+ * of its values is accepted
+ */
+struct FacetFilter {
+    static constexpr uint64_t ANY = ~uint64_t{0};
+
+    uint64_t values[FACET_COUNT];
+};
+
+struct FacetCounts {
+    uint64_t total;     // recipes matching the whole filter
+    // Per value, the recipes matching every other facet's part of the filter
+    uint32_t values[FACET_COUNT][MAX_FACET_VALUES];
+};
+
+struct FacetStats {
+    uint32_t recipes;   // live
+    uint32_t values;    // distinct categories and difficulties
+    uint64_t bitsetBytes;
+};
+
+class FacetIndex {
+public:
+    // Longest recipe id; a UUID with room to spare
+    static constexpr size_t MAX_ID_LENGTH = 63;
+
+    // Returned by findValue() for a value no recipe ever had
+    static constexpr uint32_t NO_VALUE = MAX_FACET_VALUES;
+
+    FacetIndex() = default;
+    ~FacetIndex();
+
+    FacetIndex(const FacetIndex&) = delete;
+    FacetIndex& operator=(const FacetIndex&) = delete;
+
+    /**
+     * Adds a recipe or replaces its values
+     *
+     * @return false for an empty or overlong id, a category or difficulty
+     *   beyond MAX_FACET_VALUES distinct ones, or when out of memory
+     */
+    bool setRecipe(const char* id, size_t idLength, const FacetRecipe& recipe);
+
+    /**
+     * @return false if no recipe has that id
+     */
+    bool setFavorite(const char* id, size_t idLength, bool favorite);
+
+    /**
+     * @return false if no recipe has that id
+     */
+    bool removeRecipe(const char* id, size_t idLength);
+
+    /**
+     * Matches filter against every recipe and counts every facet value
+     *
+     * @param recipes receives the first limit matching rows, ascending
+     * @return the number of rows written
+     */
+    size_t evaluate(const FacetFilter& filter, FacetCounts* counts, uint32_t* recipes,
+                    size_t limit) const;
+
+    /**
+     * @return the id of a row from evaluate()
+     */
+    const char* recipeId(uint32_t recipe, size_t* length) const;
+
+    /**
+     * @return the value id of a category or difficulty, NO_VALUE if unseen
+     */
+    uint32_t findValue(Facet facet, const char* text, size_t length) const;
+
+    /**
+     * @return how many values facet has had; a value id is below this
+     */
+    uint32_t valueCount(Facet facet) const;
+
+    /**
+     * @return the text of a category or difficulty value, nullptr otherwise
+     */
+    const char* valueText(Facet facet, uint32_t value, size_t* length) const;
+
+    static uint32_t timeBucket(uint32_t minutes);
+
+    FacetStats stats() const;
+
+    /**
+     * Drops every recipe and value
+     */
+    void clear();
+
+private:
+    uint32_t internValue(Facet facet, const char* text, size_t length);
+    bool reserveRows(uint32_t rows);
+    bool setBit(uint32_t facet, uint32_t value, uint32_t row);
+    void clearBit(uint32_t facet, uint32_t value, uint32_t row);
+
+    strings::StringPool ids_;
+    strings::StringPool categories_;
+    strings::StringPool difficulties_;
+
+    // Bitsets by facet and value, nullptr until a row has the value
+    uint64_t* bits_[FACET_COUNT][MAX_FACET_VALUES] = {};
+    uint64_t present_[FACET_COUNT] = {};    // values with a bitset
+    uint64_t* live_ = nullptr;
+    uint8_t* columns_[FACET_COUNT] = {};    // value by row
+    uint32_t wordCapacity_ = 0;             // per bitset; rows / 64
+    uint32_t liveCount_ = 0;
+};
+
+} // namespace bakingapp::search
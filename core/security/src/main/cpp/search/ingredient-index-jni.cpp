@@ -0,0 +1,210 @@
+/**
+ * JNI bridge for NativeIngredientIndex
+ *
+ * One IngredientIndex behind a lock, loaded from and saved to a snapshot
+ * file the caller names. Recipes come in one call per recipe with their
+ * ingredient names joined by '\n'; query phrases are joined the same way.
+ */
+
+#include <jni.h>
+
+#include <cstdlib>
+
+#include "common/jni-text.h"
+#include "common/mutex.h"
+#include "common/native-memory.h"
+#include "search/ingredient-index.h"
+#include "search/jni-index.h"
+
+using bakingapp::JniText;
+using bakingapp::LockGuard;
+using bakingapp::MemoryTag;
+using bakingapp::search::IngredientIndex;
+using bakingapp::search::IngredientStats;
+using bakingapp::taggedFree;
+using bakingapp::taggedMalloc;
+
+namespace {
+    constexpr jint MAX_LIMIT = 1000;
+
+    using JniIndex = bakingapp::search::JniIndex<IngredientIndex>;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeCreate(
+        JNIEnv* /* env */,
+        jobject /* thiz */
+) {
+    return reinterpret_cast<jlong>(bakingapp::createTagged<JniIndex>(MemoryTag::INDEXES));
+}
+
+/**
+ * Replaces the contents with a saved snapshot
+ *
+ * @return false if there is none or it is damaged; the index is then empty
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeLoad(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring path
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || path == nullptr) return JNI_FALSE;
+    JniText pathText(env, path);
+    if (pathText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    return index->index.load(pathText.chars()) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeSave(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring path
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || path == nullptr) return JNI_FALSE;
+    JniText pathText(env, path);
+    if (pathText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    return index->index.save(pathText.chars()) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Indexes one recipe, replacing its earlier ingredients
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeSetRecipe(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id,
+        jstring ingredients
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    JniText ingredientsText(env, ingredients);
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    const bool set = index->index.setRecipe(idText.chars(), idText.length(),
+                                            ingredientsText.chars(), ingredientsText.length());
+    return set ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeRemoveRecipe(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    return index->index.removeRecipe(idText.chars(), idText.length()) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return up to limit recipe ids, in indexing order
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeQuery(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring include,
+        jstring exclude,
+        jint limit
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || limit <= 0) return nullptr;
+    if (limit > MAX_LIMIT) limit = MAX_LIMIT;
+    JniText includeText(env, include);
+    JniText excludeText(env, exclude);
+
+    jclass stringClass = env->FindClass("java/lang/String");
+    if (stringClass == nullptr) return nullptr;
+    auto* recipes = static_cast<uint32_t*>(
+        taggedMalloc(MemoryTag::INDEXES, sizeof(uint32_t) * static_cast<size_t>(limit)));
+    if (recipes == nullptr) return nullptr;
+
+    LockGuard lock(index->mutex);
+    const size_t count = index->index.query(includeText.chars(), includeText.length(),
+                                            excludeText.chars(), excludeText.length(), recipes,
+                                            static_cast<size_t>(limit));
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(count), stringClass, nullptr);
+    for (size_t i = 0; result != nullptr && i < count; i++) {
+        // Ids were NUL-terminated when they were interned
+        jstring id = env->NewStringUTF(index->index.recipeId(recipes[i], nullptr));
+        if (id == nullptr) {
+            result = nullptr;
+            break;
+        }
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), id);
+        env->DeleteLocalRef(id);
+    }
+    taggedFree(recipes);
+    return result;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeCount(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring include,
+        jstring exclude
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return 0;
+    JniText includeText(env, include);
+    JniText excludeText(env, exclude);
+    LockGuard lock(index->mutex);
+    return static_cast<jlong>(index->index.count(includeText.chars(), includeText.length(),
+                                                 excludeText.chars(), excludeText.length()));
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeClear(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return;
+    LockGuard lock(index->mutex);
+    index->index.clear();
+}
+
+/**
+ * @return [recipes, ingredients, bitmapBytes]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeIngredientIndex_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return nullptr;
+    IngredientStats stats;
+    {
+        LockGuard lock(index->mutex);
+        stats = index->index.stats();
+    }
+    const jlong values[3] = {stats.recipes, stats.ingredients,
+                             static_cast<jlong>(stats.bitmapBytes)};
+    jlongArray result = env->NewLongArray(3);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 3, values);
+    return result;
+}
+
+} // extern "C"
@@ -0,0 +1,483 @@
+#include "search/ingredient-index.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/hash.h"
+#include "common/mapped-file.h"
+#include "common/native-memory.h"
+#include "search/text-analyzer.h"
+
+namespace bakingapp::search {
+
+using strings::StringPool;
+
+namespace {
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x58494B42;   // "BKIX"
+    constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+    struct SnapshotHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recipes;       // every interned id, dead ones too
+        uint32_t keys;
+        uint64_t payloadBytes;
+        uint64_t checksum;      // hash64 of the payload
+    };
+
+    /**
+     * Cuts the next '\n'-separated line off the front of text
+     */
+    bool nextLine(const char** text, const char* end, const char** line, size_t* length) {
+        if (*text >= end) return false;
+        const auto* newline = static_cast<const char*>(memchr(*text, '\n', end - *text));
+        const char* stop = newline != nullptr ? newline : end;
+        *line = *text;
+        *length = static_cast<size_t>(stop - *text);
+        *text = stop + 1;
+        return true;
+    }
+
+    /**
+     * Whether phrase occurs in key starting and ending on word boundaries
+     */
+    bool containsPhrase(const char* key, size_t keyLength, const char* phrase, size_t length) {
+        const char* const end = key + keyLength;
+        for (const char* p = key; static_cast<size_t>(end - p) >= length; p++) {
+            p = static_cast<const char*>(memmem(p, end - p, phrase, length));
+            if (p == nullptr) return false;
+            if ((p == key || p[-1] == ' ') && (p + length == end || p[length] == ' ')) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    class Cursor {
+    public:
+        Cursor(const uint8_t* data, size_t length) : p_(data), end_(data + length) {}
+
+        bool read(void* out, size_t length) {
+            if (static_cast<size_t>(end_ - p_) < length) return false;
+            memcpy(out, p_, length);
+            p_ += length;
+            return true;
+        }
+
+        const uint8_t* take(size_t length) {
+            if (static_cast<size_t>(end_ - p_) < length) return nullptr;
+            const uint8_t* taken = p_;
+            p_ += length;
+            return taken;
+        }
+
+        const uint8_t* position() const { return p_; }
+        size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+        void skip(size_t length) { p_ += length; }
+
+    private:
+        const uint8_t* p_;
+        const uint8_t* const end_;
+    };
+}
+
+IngredientIndex::BitmapTable::~BitmapTable() {
+    clear();
+    taggedFree(bitmaps_);
+}
+
+RoaringBitmap* IngredientIndex::BitmapTable::at(uint32_t id) {
+    if (id > capacity_) {
+        const uint32_t capacity = std::max(id, capacity_ == 0 ? 256u : capacity_ * 2);
+        auto* bitmaps = static_cast<RoaringBitmap**>(
+            taggedRealloc(MemoryTag::INDEXES, bitmaps_, sizeof(RoaringBitmap*) * capacity));
+        if (bitmaps == nullptr) return nullptr;
+        memset(bitmaps + capacity_, 0, sizeof(RoaringBitmap*) * (capacity - capacity_));
+        bitmaps_ = bitmaps;
+        capacity_ = capacity;
+    }
+    if (bitmaps_[id - 1] == nullptr) {
+        bitmaps_[id - 1] = bakingapp::createTagged<RoaringBitmap>(MemoryTag::INDEXES);
+    }
+    return bitmaps_[id - 1];
+}
+
+void IngredientIndex::BitmapTable::clear() {
+    for (uint32_t i = 0; i < capacity_; i++) {
+        bakingapp::destroyTagged(bitmaps_[i]);
+        bitmaps_[i] = nullptr;
+    }
+}
+
+IngredientIndex::~IngredientIndex() {
+    clear();
+    taggedFree(recipes_);
+    taggedFree(keyLists_);
+    taggedFree(candidateKeys_);
+}
+
+bool IngredientIndex::setRecipe(const char* id, size_t idLength, const char* ingredients,
+                                size_t length) {
+    if (idLength == 0 || idLength > MAX_ID_LENGTH) return false;
+
+    uint32_t keys[MAX_INGREDIENTS];
+    uint32_t keyCount = 0;
+    char key[MAX_PHRASE_LENGTH];
+    const char* cursor = ingredients;
+    const char* line;
+    size_t lineLength;
+    while (keyCount < MAX_INGREDIENTS &&
+           nextLine(&cursor, ingredients + length, &line, &lineLength)) {
+        const size_t n = normalizePhrase(line, lineLength, key);
+        if (n == 0) continue;
+        const uint32_t keyRef = internKey(key, n);
+        if (keyRef == StringPool::NONE) return false;
+        if (std::find(keys, keys + keyCount, keyRef) == keys + keyCount) keys[keyCount++] = keyRef;
+    }
+
+    const uint32_t recipe = ids_.intern(id, idLength);
+    uint32_t offset = 0;
+    if (recipe == StringPool::NONE || !reserveRecipes(recipe) ||
+        !appendKeys(keys, keyCount, &offset) || !live_.add(recipe)) {
+        return false;
+    }
+    Recipe& entry = recipes_[recipe - 1];
+    for (uint32_t i = 0; i < entry.keyCount; i++) {
+        recipesByKey_.at(keyLists_[entry.offset + i])->remove(recipe);
+    }
+    bool added = true;
+    for (uint32_t i = 0; i < keyCount; i++) added &= recipesByKey_.at(keys[i])->add(recipe);
+    entry = {offset, static_cast<uint16_t>(keyCount), 1};
+    return added;
+}
+
+bool IngredientIndex::removeRecipe(const char* id, size_t idLength) {
+    const uint32_t recipe = ids_.find(id, idLength);
+    if (recipe == StringPool::NONE || recipe > recipeCapacity_) return false;
+    Recipe& entry = recipes_[recipe - 1];
+    if (!entry.live) return false;
+    for (uint32_t i = 0; i < entry.keyCount; i++) {
+        recipesByKey_.at(keyLists_[entry.offset + i])->remove(recipe);
+    }
+    entry = {0, 0, 0};
+    live_.remove(recipe);
+    return true;
+}
+
+size_t IngredientIndex::query(const char* include, size_t includeLength, const char* exclude,
+                              size_t excludeLength, uint32_t* recipes, size_t limit) {
+    PhraseSets includes;
+    PhraseSets excludes;
+    if (!resolve(include, includeLength, includeUnions_, &includes) ||
+        !resolve(exclude, excludeLength, excludeUnions_, &excludes) || includes.empty) {
+        return 0;
+    }
+    const RoaringBitmap* result = combine(&includes, excludes);
+    return result != nullptr ? result->toArray(recipes, limit) : 0;
+}
+
+uint64_t IngredientIndex::count(const char* include, size_t includeLength, const char* exclude,
+                                size_t excludeLength) {
+    PhraseSets includes;
+    PhraseSets excludes;
+    if (!resolve(include, includeLength, includeUnions_, &includes) ||
+        !resolve(exclude, excludeLength, excludeUnions_, &excludes) || includes.empty) {
+        return 0;
+    }
+    // Counts straight off the sets when there is nothing to subtract
+    if (excludes.count == 0 && includes.count <= 2) {
+        if (includes.count == 0) return live_.cardinality();
+        if (includes.count == 1) return includes.sets[0]->cardinality();
+        return RoaringBitmap::andCardinality(*includes.sets[0], *includes.sets[1]);
+    }
+    const RoaringBitmap* result = combine(&includes, excludes);
+    return result != nullptr ? result->cardinality() : 0;
+}
+
+bool IngredientIndex::resolve(const char* text, size_t length, RoaringBitmap* unions,
+                              PhraseSets* out) {
+    out->count = 0;
+    out->empty = false;
+    if (text == nullptr) return true;
+
+    char phrase[MAX_PHRASE_LENGTH];
+    const char* cursor = text;
+    const char* line;
+    size_t lineLength;
+    while (out->count < MAX_QUERY_PHRASES && nextLine(&cursor, text + length, &line, &lineLength)) {
+        const size_t n = normalizePhrase(line, lineLength, phrase);
+        if (n == 0) continue;
+
+        // Keys holding every word of the phrase, then those holding it in one piece
+        const RoaringBitmap* candidates = nullptr;
+        bool multiWord = false;
+        for (size_t start = 0; start < n;) {
+            const auto* space = static_cast<const char*>(memchr(phrase + start, ' ', n - start));
+            const size_t end = space != nullptr ? static_cast<size_t>(space - phrase) : n;
+            const RoaringBitmap* keys = keysByWord_.find(words_.find(phrase + start, end - start));
+            if (keys == nullptr) {
+                candidates = nullptr;
+                break;
+            }
+            if (candidates == nullptr) {
+                candidates = keys;
+            } else if (!candidates_.assign(*candidates, SetOperation::AND, *keys)) {
+                return false;
+            } else {
+                candidates = &candidates_;
+                multiWord = true;
+            }
+            start = end + 1;
+        }
+        const uint64_t candidateCount = candidates != nullptr ? candidates->cardinality() : 0;
+        if (candidateCount > candidateCapacity_) {
+            auto* grown = static_cast<uint32_t*>(taggedRealloc(
+                MemoryTag::INDEXES, candidateKeys_, sizeof(uint32_t) * candidateCount));
+            if (grown == nullptr) return false;
+            candidateKeys_ = grown;
+            candidateCapacity_ = static_cast<uint32_t>(candidateCount);
+        }
+        const size_t keyCount =
+            candidates != nullptr ? candidates->toArray(candidateKeys_, candidateCount) : 0;
+
+        RoaringBitmap* merged = &unions[out->count];
+        const RoaringBitmap* first = nullptr;
+        uint32_t matches = 0;
+        for (size_t k = 0; k < keyCount; k++) {
+            const RoaringBitmap* bitmap = recipesByKey_.find(candidateKeys_[k]);
+            if (bitmap == nullptr || bitmap->isEmpty()) continue;
+            size_t keyLength = 0;
+            const char* keyText = keys_.text(candidateKeys_[k], &keyLength);
+            if (multiWord && !containsPhrase(keyText, keyLength, phrase, n)) continue;
+            if (++matches == 1) {
+                first = bitmap;
+            } else if (!merged->assign(matches == 2 ? *first : *merged, SetOperation::OR,
+                                       *bitmap)) {
+                return false;
+            }
+        }
+        if (matches == 0) {
+            out->empty = true;
+            continue;
+        }
+        out->sets[out->count++] = matches == 1 ? first : merged;
+    }
+    return true;
+}
+
+const RoaringBitmap* IngredientIndex::combine(PhraseSets* include, const PhraseSets& exclude) {
+    // Smallest first, so the running intersection only shrinks from there
+    std::sort(include->sets, include->sets + include->count,
+              [](const RoaringBitmap* a, const RoaringBitmap* b) {
+                  return a->cardinality() < b->cardinality();
+              });
+    const RoaringBitmap* base = include->count > 0 ? include->sets[0] : &live_;
+    if (include->count <= 1 && exclude.count == 0) return base;
+
+    const bool copied = include->count > 1
+        ? result_.assign(*base, SetOperation::AND, *include->sets[1])
+        : result_.copyFrom(*base);
+    if (!copied) return nullptr;
+    for (uint32_t i = 2; i < include->count && !result_.isEmpty(); i++) {
+        if (!result_.assign(result_, SetOperation::AND, *include->sets[i])) return nullptr;
+    }
+    for (uint32_t i = 0; i < exclude.count && !result_.isEmpty(); i++) {
+        if (!result_.assign(result_, SetOperation::AND_NOT, *exclude.sets[i])) return nullptr;
+    }
+    return &result_;
+}
+
+const char* IngredientIndex::recipeId(uint32_t recipe, size_t* length) const {
+    return ids_.text(recipe, length);
+}
+
+bool IngredientIndex::load(const char* path) {
+    clear();
+    MappedFile file;
+    SnapshotHeader header {};
+    if (!file.openReadOnly(path) || file.size() < sizeof(header)) return false;
+    memcpy(&header, file.data(), sizeof(header));
+    const uint8_t* payload = file.data() + sizeof(header);
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.payloadBytes != file.size() - sizeof(header) ||
+        hash64(payload, header.payloadBytes) != header.checksum) {
+        return false;
+    }
+
+    Cursor cursor(payload, header.payloadBytes);
+    bool ok = true;
+    uint32_t keys[MAX_INGREDIENTS];
+    for (uint32_t recipe = 1; ok && recipe <= header.recipes; recipe++) {
+        uint8_t idLength = 0;
+        uint8_t live = 0;
+        uint16_t keyCount = 0;
+        const uint8_t* id = nullptr;
+        ok = cursor.read(&idLength, 1) && (id = cursor.take(idLength)) != nullptr &&
+             cursor.read(&live, 1) && cursor.read(&keyCount, 2) && keyCount <= MAX_INGREDIENTS &&
+             cursor.read(keys, sizeof(uint32_t) * keyCount) &&
+             ids_.intern(reinterpret_cast<const char*>(id), idLength) == recipe &&
+             reserveRecipes(recipe);
+        for (uint32_t i = 0; ok && i < keyCount; i++) {
+            ok = keys[i] != StringPool::NONE && keys[i] <= header.keys;
+        }
+        uint32_t offset = 0;
+        ok = ok && appendKeys(keys, keyCount, &offset) && (!live || live_.add(recipe));
+        if (ok && live) recipes_[recipe - 1] = {offset, keyCount, 1};
+    }
+    for (uint32_t key = 1; ok && key <= header.keys; key++) {
+        uint16_t length = 0;
+        const uint8_t* text = nullptr;
+        RoaringBitmap* bitmap = nullptr;
+        ok = cursor.read(&length, 2) && (text = cursor.take(length)) != nullptr &&
+             internKey(reinterpret_cast<const char*>(text), length) == key &&
+             (bitmap = recipesByKey_.at(key)) != nullptr;
+        if (!ok) break;
+        const size_t read = bitmap->deserialize(cursor.position(), cursor.remaining());
+        ok = read > 0;
+        cursor.skip(read);
+    }
+    if (!ok || cursor.remaining() != 0) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool IngredientIndex::save(const char* path) const {
+    size_t payloadBytes = 0;
+    for (uint32_t recipe = 1; recipe <= ids_.size(); recipe++) {
+        size_t idLength = 0;
+        ids_.text(recipe, &idLength);
+        const uint32_t keyCount = recipe <= recipeCapacity_ ? recipes_[recipe - 1].keyCount : 0;
+        payloadBytes += 1 + idLength + 1 + 2 + sizeof(uint32_t) * keyCount;
+    }
+    for (uint32_t key = 1; key <= keys_.size(); key++) {
+        size_t length = 0;
+        keys_.text(key, &length);
+        const RoaringBitmap* bitmap = recipesByKey_.find(key);
+        payloadBytes += 2 + length + (bitmap != nullptr ? bitmap->serializedSize() : 4);
+    }
+
+    auto* buffer = static_cast<uint8_t*>(
+        taggedMalloc(MemoryTag::INDEXES, sizeof(SnapshotHeader) + payloadBytes));
+    if (buffer == nullptr) return false;
+    uint8_t* p = buffer + sizeof(SnapshotHeader);
+    for (uint32_t recipe = 1; recipe <= ids_.size(); recipe++) {
+        size_t idLength = 0;
+        const char* id = ids_.text(recipe, &idLength);
+        const Recipe entry = recipe <= recipeCapacity_ ? recipes_[recipe - 1] : Recipe {0, 0, 0};
+        *p++ = static_cast<uint8_t>(idLength);
+        memcpy(p, id, idLength);
+        p += idLength;
+        *p++ = static_cast<uint8_t>(entry.live);
+        memcpy(p, &entry.keyCount, 2);
+        p += 2;
+        memcpy(p, keyLists_ + entry.offset, sizeof(uint32_t) * entry.keyCount);
+        p += sizeof(uint32_t) * entry.keyCount;
+    }
+    for (uint32_t key = 1; key <= keys_.size(); key++) {
+        size_t length = 0;
+        const char* text = keys_.text(key, &length);
+        const auto length16 = static_cast<uint16_t>(length);
+        memcpy(p, &length16, 2);
+        memcpy(p + 2, text, length);
+        p += 2 + length;
+        const RoaringBitmap* bitmap = recipesByKey_.find(key);
+        if (bitmap != nullptr) {
+            bitmap->serialize(p);
+            p += bitmap->serializedSize();
+        } else {
+            memset(p, 0, 4);
+            p += 4;
+        }
+    }
+
+    const SnapshotHeader header {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, ids_.size(), keys_.size(),
+                                 payloadBytes,
+                                 hash64(buffer + sizeof(SnapshotHeader), payloadBytes)};
+    memcpy(buffer, &header, sizeof(header));
+    const bool written = writeFileAtomically(path, buffer, sizeof(header) + payloadBytes);
+    taggedFree(buffer);
+    return written;
+}
+
+IngredientStats IngredientIndex::stats() const {
+    IngredientStats stats {static_cast<uint32_t>(live_.cardinality()), 0, live_.memoryBytes()};
+    for (uint32_t key = 1; key <= keys_.size(); key++) {
+        const RoaringBitmap* bitmap = recipesByKey_.find(key);
+        if (bitmap == nullptr) continue;
+        if (!bitmap->isEmpty()) stats.ingredients++;
+        stats.bitmapBytes += bitmap->memoryBytes();
+    }
+    for (uint32_t word = 1; word <= words_.size(); word++) {
+        const RoaringBitmap* bitmap = keysByWord_.find(word);
+        if (bitmap != nullptr) stats.bitmapBytes += bitmap->memoryBytes();
+    }
+    return stats;
+}
+
+void IngredientIndex::clear() {
+    recipesByKey_.clear();
+    keysByWord_.clear();
+    if (recipes_ != nullptr) memset(recipes_, 0, sizeof(Recipe) * recipeCapacity_);
+    ids_.clear();
+    keys_.clear();
+    words_.clear();
+    live_.clear();
+    keyListLength_ = 0;
+    for (uint32_t i = 0; i < MAX_QUERY_PHRASES; i++) {
+        includeUnions_[i].clear();
+        excludeUnions_[i].clear();
+    }
+    result_.clear();
+    candidates_.clear();
+}
+
+bool IngredientIndex::reserveRecipes(uint32_t count) {
+    if (count <= recipeCapacity_) return true;
+    const uint32_t capacity =
+        std::max(count, recipeCapacity_ == 0 ? 1024u : recipeCapacity_ * 2);
+    auto* recipes = static_cast<Recipe*>(
+        taggedRealloc(MemoryTag::INDEXES, recipes_, sizeof(Recipe) * capacity));
+    if (recipes == nullptr) return false;
+    memset(recipes + recipeCapacity_, 0, sizeof(Recipe) * (capacity - recipeCapacity_));
+    recipes_ = recipes;
+    recipeCapacity_ = capacity;
+    return true;
+}
+
+bool IngredientIndex::appendKeys(const uint32_t* keys, uint32_t count, uint32_t* offset) {
+    if (keyListLength_ + count > keyListCapacity_) {
+        const uint32_t capacity = std::max(keyListLength_ + count,
+                                           keyListCapacity_ == 0 ? 4096u : keyListCapacity_ * 2);
+        auto* lists = static_cast<uint32_t*>(
+            taggedRealloc(MemoryTag::INDEXES, keyLists_, sizeof(uint32_t) * capacity));
+        if (lists == nullptr) return false;
+        keyLists_ = lists;
+        keyListCapacity_ = capacity;
+    }
+    memcpy(keyLists_ + keyListLength_, keys, sizeof(uint32_t) * count);
+    *offset = keyListLength_;
+    keyListLength_ += count;
+    return true;
+}
+
+uint32_t IngredientIndex::internKey(const char* key, size_t length) {
+    const uint32_t known = keys_.size();
+    const uint32_t id = keys_.intern(key, length);
+    if (id == StringPool::NONE || recipesByKey_.at(id) == nullptr) return StringPool::NONE;
+    if (id <= known) return id;
+
+    for (size_t start = 0; start < length;) {
+        const auto* space = static_cast<const char*>(memchr(key + start, ' ', length - start));
+        const size_t end = space != nullptr ? static_cast<size_t>(space - key) : length;
+        const uint32_t word = words_.intern(key + start, end - start);
+        RoaringBitmap* keys = word != StringPool::NONE ? keysByWord_.at(word) : nullptr;
+        if (keys == nullptr || !keys->add(id)) return StringPool::NONE;
+        start = end + 1;
+    }
+    return id;
+}
+
+} // namespace bakingapp::search
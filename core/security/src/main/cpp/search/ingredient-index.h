@@ -0,0 +1,175 @@
+/**
+ * Ingredient -> recipes inverted index for "what can I cook with these"
+ *
+ * Each ingredient name is normalized into a key by search/text-analyzer.h
+ * (folded, stemmed words joined by single spaces, so "Cherry Tomatoes"
+ * and "cherry tomato" are one key) and each key holds a RoaringBitmap of
+ * the recipes that use it. Recipes are numbered by their interned id.
+ *
+ * A query phrase matches every key it appears in on word boundaries:
+ * "tomato" finds "tomato" and "cherry tomato", not "tomatillo". Keys are
+ * in turn indexed by word, in bitmaps of key ids, so a phrase only looks
+ * at the keys holding all of its words. A query is the intersection over
+ * its include phrases minus the union of its exclude phrases; count()
+ * skips building the result where it can.
+ *
+ * save() writes a snapshot (ids, per-recipe keys and the serialized
+ * bitmaps) atomically; load() maps one and rebuilds the index from it
+ * without re-analyzing any text.
+ *
+ * Not synchronized: callers that share an index serialize on their own lock.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "search/roaring-bitmap.h"
+#include "strings/string-pool.h"
+
+namespace bakingapp::search {
+
+struct IngredientStats {
+    uint32_t recipes;       // live
+    uint32_t ingredients;   // keys used by a live recipe
+    uint64_t bitmapBytes;
+};
+
+class IngredientIndex {
+public:
+    // Longest recipe id; a UUID with room to spare
+    static constexpr size_t MAX_ID_LENGTH = 63;
+
+    // Distinct ingredients kept per recipe, and phrases per query side
+    static constexpr uint32_t MAX_INGREDIENTS = 128;
+    static constexpr uint32_t MAX_QUERY_PHRASES = 16;
+
+    IngredientIndex() = default;
+    ~IngredientIndex();
+
+    IngredientIndex(const IngredientIndex&) = delete;
+    IngredientIndex& operator=(const IngredientIndex&) = delete;
+
+    /**
+     * Indexes a recipe, replacing its earlier ingredients
+     *
+     * @param ingredients ingredient names separated by '\n'
+     * @return false for an empty or overlong id, or when out of memory
+     */
+    bool setRecipe(const char* id, size_t idLength, const char* ingredients, size_t length);
+
+    /**
+     * @return false if no recipe has that id
+     */
+    bool removeRecipe(const char* id, size_t idLength);
+
+    /**
+     * Finds the recipes using every include phrase and no exclude phrase;
+     * no include phrase means every recipe
+     *
+     * @param include phrases separated by '\n', as is exclude
+     * @return the number of recipes written, in ascending order
+     */
+    size_t query(const char* include, size_t includeLength, const char* exclude,
+                 size_t excludeLength, uint32_t* recipes, size_t limit);
+
+    /**
+     * The number of recipes query() would find without a limit
+     */
+    uint64_t count(const char* include, size_t includeLength, const char* exclude,
+                   size_t excludeLength);
+
+    /**
+     * @return the id of a recipe from query()
+     */
+    const char* recipeId(uint32_t recipe, size_t* length) const;
+
+    /**
+     * Replaces the contents with a snapshot from save()
+     *
+     * @return false if the file is missing or malformed, leaving the index empty
+     */
+    bool load(const char* path);
+
+    bool save(const char* path) const;
+
+    IngredientStats stats() const;
+
+    /**
+     * Drops every recipe and ingredient
+     */
+    void clear();
+
+private:
+    struct Recipe {
+        uint32_t offset;            // into keyLists_
+        uint16_t keyCount;
+        uint16_t live;
+    };
+
+    // Phrase sets for one side of a query; each points at a key bitmap
+    // or, when the phrase matches several keys, at a scratch union
+    struct PhraseSets {
+        const RoaringBitmap* sets[MAX_QUERY_PHRASES];
+        uint32_t count;
+        bool empty;                 // some phrase matched nothing
+    };
+
+    // Bitmaps by pool id, created on first use
+    class BitmapTable {
+    public:
+        BitmapTable() = default;
+        ~BitmapTable();
+
+        BitmapTable(const BitmapTable&) = delete;
+        BitmapTable& operator=(const BitmapTable&) = delete;
+
+        /**
+         * @return the bitmap of id, nullptr when out of memory
+         */
+        RoaringBitmap* at(uint32_t id);
+
+        /**
+         * @return the bitmap of id, nullptr if it was never created
+         */
+        const RoaringBitmap* find(uint32_t id) const {
+            return id - 1 < capacity_ ? bitmaps_[id - 1] : nullptr;
+        }
+
+        void clear();
+
+    private:
+        RoaringBitmap** bitmaps_ = nullptr;     // by id - 1
+        uint32_t capacity_ = 0;
+    };
+
+    uint32_t internKey(const char* key, size_t length);
+    bool resolve(const char* text, size_t length, RoaringBitmap* unions, PhraseSets* out);
+    const RoaringBitmap* combine(PhraseSets* include, const PhraseSets& exclude);
+    bool reserveRecipes(uint32_t count);
+    bool appendKeys(const uint32_t* keys, uint32_t count, uint32_t* offset);
+
+    strings::StringPool ids_;
+    strings::StringPool keys_;
+    strings::StringPool words_;
+    BitmapTable recipesByKey_;
+    BitmapTable keysByWord_;
+    Recipe* recipes_ = nullptr;         // by id - 1
+    uint32_t recipeCapacity_ = 0;
+    RoaringBitmap live_;
+
+    uint32_t* keyLists_ = nullptr;      // replaced lists stay until clear()
+    uint32_t keyListLength_ = 0;
+    uint32_t keyListCapacity_ = 0;
+
+    // Scratch space reused across queries
+    RoaringBitmap includeUnions_[MAX_QUERY_PHRASES];
+    RoaringBitmap excludeUnions_[MAX_QUERY_PHRASES];
+    RoaringBitmap result_;
+    RoaringBitmap candidates_;
+    uint32_t* candidateKeys_ = nullptr;
+    uint32_t candidateCapacity_ = 0;
+};
+
+} // namespace bakingapp::search
@@ -0,0 +1,23 @@
+/**
+ * The handle the search JNI bridges hand to Kotlin: one index behind a lock.
+ */
+
+#pragma once
+
+#include <jni.h>
+
+#include "common/mutex.h"
+
+namespace bakingapp::search {
+
+template <typename Index>
+struct JniIndex {
+    Mutex mutex;
+    Index index;
+
+    static JniIndex* fromHandle(jlong handle) {
+        return reinterpret_cast<JniIndex*>(handle);
+    }
+};
+
+} // namespace bakingapp::search
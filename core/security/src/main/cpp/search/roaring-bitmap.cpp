@@ -0,0 +1,693 @@
+#include "search/roaring-bitmap.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bakingapp::search {
+
+using Container = RoaringBitmap::Container;
+
+namespace {
+    constexpr uint16_t ARRAY = 1;
+    constexpr uint16_t BITMAP = 2;
+    // An array this full takes as much memory as a bitmap
+    constexpr uint32_t ARRAY_MAX = 4096;
+    constexpr size_t WORDS = 1024;
+    constexpr size_t BITMAP_BYTES = WORDS * sizeof(uint64_t);
+    // Serialized container header: u16 key, u16 kind, u32 cardinality
+    constexpr size_t HEADER_BYTES = 8;
+
+    inline uint16_t* values(const Container& c) { return static_cast<uint16_t*>(c.data); }
+    inline uint64_t* words(const Container& c) { return static_cast<uint64_t*>(c.data); }
+
+    inline uint32_t popcount(uint64_t word) {
+        return static_cast<uint32_t>(__builtin_popcountll(word));
+    }
+
+    inline bool testBit(const uint64_t* bits, uint16_t value) {
+        return (bits[value >> 6] >> (value & 63)) & 1;
+    }
+
+    inline void setBit(uint64_t* bits, uint16_t value) {
+        bits[value >> 6] |= uint64_t{1} << (value & 63);
+    }
+
+    inline void clearBit(uint64_t* bits, uint16_t value) {
+        bits[value >> 6] &= ~(uint64_t{1} << (value & 63));
+    }
+
+    // ==================== Word kernels ====================
+
+    struct AndWords {
+#if defined(__ARM_NEON)
+        static uint64x2_t apply(uint64x2_t a, uint64x2_t b) { return vandq_u64(a, b); }
+#elif defined(__SSE2__)
+        static __m128i apply(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+#endif
+        static uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+    };
+
+    struct OrWords {
+#if defined(__ARM_NEON)
+        static uint64x2_t apply(uint64x2_t a, uint64x2_t b) { return vorrq_u64(a, b); }
+#elif defined(__SSE2__)
+        static __m128i apply(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+#endif
+        static uint64_t apply(uint64_t a, uint64_t b) { return a | b; }
+    };
+
+    struct AndNotWords {
+#if defined(__ARM_NEON)
+        static uint64x2_t apply(uint64x2_t a, uint64x2_t b) { return vbicq_u64(a, b); }
+#elif defined(__SSE2__)
+        // _mm_andnot_si128 negates its first operand
+        static __m128i apply(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+#endif
+        static uint64_t apply(uint64_t a, uint64_t b) { return a & ~b; }
+    };
+
+    /**
+     * out = a op b over a whole bitmap, 128 bits at a time
+     *
+     * @param out nullptr to only count
+     * @return the bits set in the result
+     */
+    template <typename Op>
+    uint32_t combineWords(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+#if defined(__ARM_NEON)
+        // Per-byte counts, summed pairwise into 16-bit lanes: at most
+        // 16 bits per lane per step, 8192 over the 512 steps
+        uint16x8_t counts = vdupq_n_u16(0);
+        for (size_t i = 0; i < WORDS; i += 2) {
+            const uint64x2_t v = Op::apply(vld1q_u64(a + i), vld1q_u64(b + i));
+            if (out != nullptr) vst1q_u64(out + i, v);
+            counts = vpadalq_u8(counts, vcntq_u8(vreinterpretq_u8_u64(v)));
+        }
+        const uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(counts));
+        return static_cast<uint32_t>(vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1));
+#elif defined(__SSE2__)
+        // SSE2 has no popcount; the lanes are counted as 64-bit words
+        uint32_t count = 0;
+        alignas(16) uint64_t lanes[2];
+        for (size_t i = 0; i < WORDS; i += 2) {
+            const __m128i v = Op::apply(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+            if (out != nullptr) {
+                out[i] = lanes[0];
+                out[i + 1] = lanes[1];
+            }
+            count += popcount(lanes[0]) + popcount(lanes[1]);
+        }
+        return count;
+#else
+        uint32_t count = 0;
+        for (size_t i = 0; i < WORDS; i++) {
+            const uint64_t v = Op::apply(a[i], b[i]);
+            if (out != nullptr) out[i] = v;
+            count += popcount(v);
+        }
+        return count;
+#endif
+    }
+
+    /**
+     * Sorted-array intersection; gallops through the longer array when
+     * the other is much shorter
+     *
+     * @param out nullptr to only count
+     */
+    uint32_t intersectArrays(const uint16_t* a, uint32_t na, const uint16_t* b, uint32_t nb,
+                             uint16_t* out) {
+        if (na > nb) {
+            std::swap(a, b);
+            std::swap(na, nb);
+        }
+        uint32_t n = 0;
+        if (static_cast<uint64_t>(na) * 64 < nb) {
+            const uint16_t* from = b;
+            const uint16_t* const end = b + nb;
+            for (uint32_t i = 0; i < na && from != end; i++) {
+                from = std::lower_bound(from, end, a[i]);
+                if (from != end && *from == a[i]) {
+                    if (out != nullptr) out[n] = a[i];
+                    n++;
+                    from++;
+                }
+            }
+            return n;
+        }
+        uint32_t i = 0;
+        uint32_t j = 0;
+        while (i < na && j < nb) {
+            if (a[i] < b[j]) {
+                i++;
+            } else if (a[i] > b[j]) {
+                j++;
+            } else {
+                if (out != nullptr) out[n] = a[i];
+                n++;
+                i++;
+                j++;
+            }
+        }
+        return n;
+    }
+
+    // ==================== Containers ====================
+
+    bool newArray(Container* c, uint16_t key, uint32_t capacity) {
+        void* data = taggedMalloc(MemoryTag::INDEXES, sizeof(uint16_t) * std::max(capacity, 1u));
+        if (data == nullptr) return false;
+        *c = {key, ARRAY, 0, capacity, data};
+        return true;
+    }
+
+    bool newBitmap(Container* c, uint16_t key, bool zeroed) {
+        void* data = zeroed ? taggedCalloc(MemoryTag::INDEXES, WORDS, sizeof(uint64_t))
+                            : taggedMalloc(MemoryTag::INDEXES, BITMAP_BYTES);
+        if (data == nullptr) return false;
+        *c = {key, BITMAP, 0, 0, data};
+        return true;
+    }
+
+    bool copyContainer(const Container& from, Container* to) {
+        const size_t bytes =
+            from.kind == ARRAY ? sizeof(uint16_t) * from.cardinality : BITMAP_BYTES;
+        void* data = taggedMalloc(MemoryTag::INDEXES, std::max<size_t>(bytes, 1));
+        if (data == nullptr) return false;
+        memcpy(data, from.data, bytes);
+        *to = {from.key, from.kind, from.cardinality, from.kind == ARRAY ? from.cardinality : 0,
+               data};
+        return true;
+    }
+
+    /**
+     * Frees an empty container's data, and turns a bitmap small enough
+     * into an array; a failed conversion keeps the (still valid) bitmap
+     */
+    void settle(Container* c) {
+        if (c->cardinality == 0) {
+            taggedFree(c->data);
+            c->data = nullptr;
+            return;
+        }
+        if (c->kind != BITMAP || c->cardinality > ARRAY_MAX) return;
+        auto* array = static_cast<uint16_t*>(
+            taggedMalloc(MemoryTag::INDEXES, sizeof(uint16_t) * c->cardinality));
+        if (array == nullptr) return;
+        uint32_t n = 0;
+        const uint64_t* bits = words(*c);
+        for (size_t i = 0; i < WORDS; i++) {
+            for (uint64_t word = bits[i]; word != 0; word &= word - 1) {
+                array[n++] = static_cast<uint16_t>(i * 64 + __builtin_ctzll(word));
+            }
+        }
+        taggedFree(c->data);
+        c->data = array;
+        c->kind = ARRAY;
+        c->capacity = c->cardinality;
+    }
+
+    // The kernels below fill out with a settled result; cardinality 0
+    // means there is none. They return false when out of memory.
+
+    bool andContainers(const Container& a, const Container& b, Container* out) {
+        if (a.kind == ARRAY && b.kind == ARRAY) {
+            if (!newArray(out, a.key, std::min(a.cardinality, b.cardinality))) return false;
+            out->cardinality = intersectArrays(values(a), a.cardinality, values(b),
+                                               b.cardinality, values(*out));
+        } else if (a.kind == ARRAY || b.kind == ARRAY) {
+            const Container& array = a.kind == ARRAY ? a : b;
+            const uint64_t* bits = words(a.kind == ARRAY ? b : a);
+            if (!newArray(out, a.key, array.cardinality)) return false;
+            uint16_t* result = values(*out);
+            uint32_t n = 0;
+            for (uint32_t i = 0; i < array.cardinality; i++) {
+                const uint16_t value = values(array)[i];
+                if (testBit(bits, value)) result[n++] = value;
+            }
+            out->cardinality = n;
+        } else {
+            if (!newBitmap(out, a.key, false)) return false;
+            out->cardinality = combineWords<AndWords>(words(a), words(b), words(*out));
+        }
+        settle(out);
+        return true;
+    }
+
+    bool orContainers(const Container& a, const Container& b, Container* out) {
+        if (a.kind == ARRAY && b.kind == ARRAY && a.cardinality + b.cardinality <= ARRAY_MAX) {
+            if (!newArray(out, a.key, a.cardinality + b.cardinality)) return false;
+            const uint16_t* x = values(a);
+            const uint16_t* y = values(b);
+            uint16_t* result = values(*out);
+            uint32_t i = 0;
+            uint32_t j = 0;
+            uint32_t n = 0;
+            while (i < a.cardinality && j < b.cardinality) {
+                if (x[i] < y[j]) {
+                    result[n++] = x[i++];
+                } else if (x[i] > y[j]) {
+                    result[n++] = y[j++];
+                } else {
+                    result[n++] = x[i++];
+                    j++;
+                }
+            }
+            while (i < a.cardinality) result[n++] = x[i++];
+            while (j < b.cardinality) result[n++] = y[j++];
+            out->cardinality = n;
+        } else if (a.kind == BITMAP && b.kind == BITMAP) {
+            if (!newBitmap(out, a.key, false)) return false;
+            out->cardinality = combineWords<OrWords>(words(a), words(b), words(*out));
+        } else {
+            // Start from the bitmap, if any, and set the array's values
+            const bool hasBitmap = a.kind == BITMAP || b.kind == BITMAP;
+            const Container& base = a.kind == BITMAP ? a : b;
+            if (hasBitmap) {
+                if (!copyContainer(base, out)) return false;
+            } else if (!newBitmap(out, a.key, true)) {
+                return false;
+            }
+            uint64_t* bits = words(*out);
+            uint32_t n = out->cardinality;
+            const Container* operands[] = {&a, &b};
+            for (const Container* array : operands) {
+                if (array->kind != ARRAY || (hasBitmap && array == &base)) continue;
+                for (uint32_t i = 0; i < array->cardinality; i++) {
+                    const uint16_t value = values(*array)[i];
+                    if (!testBit(bits, value)) {
+                        setBit(bits, value);
+                        n++;
+                    }
+                }
+            }
+            out->cardinality = n;
+        }
+        settle(out);
+        return true;
+    }
+
+    bool andNotContainers(const Container& a, const Container& b, Container* out) {
+        if (a.kind == ARRAY) {
+            if (!newArray(out, a.key, a.cardinality)) return false;
+            const uint16_t* x = values(a);
+            uint16_t* result = values(*out);
+            uint32_t n = 0;
+            if (b.kind == ARRAY) {
+                const uint16_t* y = values(b);
+                uint32_t j = 0;
+                for (uint32_t i = 0; i < a.cardinality; i++) {
+                    while (j < b.cardinality && y[j] < x[i]) j++;
+                    if (j == b.cardinality || y[j] != x[i]) result[n++] = x[i];
+                }
+            } else {
+                for (uint32_t i = 0; i < a.cardinality; i++) {
+                    if (!testBit(words(b), x[i])) result[n++] = x[i];
+                }
+            }
+            out->cardinality = n;
+        } else if (b.kind == ARRAY) {
+            if (!copyContainer(a, out)) return false;
+            uint64_t* bits = words(*out);
+            for (uint32_t i = 0; i < b.cardinality; i++) {
+                const uint16_t value = values(b)[i];
+                if (testBit(bits, value)) {
+                    clearBit(bits, value);
+                    out->cardinality--;
+                }
+            }
+        } else {
+            if (!newBitmap(out, a.key, false)) return false;
+            out->cardinality = combineWords<AndNotWords>(words(a), words(b), words(*out));
+        }
+        settle(out);
+        return true;
+    }
+
+    uint32_t andCount(const Container& a, const Container& b) {
+        if (a.kind == ARRAY && b.kind == ARRAY) {
+            return intersectArrays(values(a), a.cardinality, values(b), b.cardinality, nullptr);
+        }
+        if (a.kind == ARRAY || b.kind == ARRAY) {
+            const Container& array = a.kind == ARRAY ? a : b;
+            const uint64_t* bits = words(a.kind == ARRAY ? b : a);
+            uint32_t n = 0;
+            for (uint32_t i = 0; i < array.cardinality; i++) n += testBit(bits, values(array)[i]);
+            return n;
+        }
+        return combineWords<AndWords>(words(a), words(b), nullptr);
+    }
+
+    void freeContainers(Container* containers, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++) taggedFree(containers[i].data);
+        taggedFree(containers);
+    }
+}
+
+RoaringBitmap::~RoaringBitmap() {
+    clear();
+    taggedFree(containers_);
+}
+
+int32_t RoaringBitmap::find(uint16_t key) const {
+    int32_t low = 0;
+    int32_t high = static_cast<int32_t>(count_) - 1;
+    while (low <= high) {
+        const int32_t middle = (low + high) / 2;
+        const uint16_t candidate = containers_[middle].key;
+        if (candidate < key) {
+            low = middle + 1;
+        } else if (candidate > key) {
+            high = middle - 1;
+        } else {
+            return middle;
+        }
+    }
+    return -(low + 1);
+}
+
+bool RoaringBitmap::reserve(uint32_t count) {
+    if (count <= capacity_) return true;
+    const uint32_t capacity = std::max(count, capacity_ == 0 ? 4u : capacity_ * 2);
+    auto* containers = static_cast<Container*>(
+        taggedRealloc(MemoryTag::INDEXES, containers_, sizeof(Container) * capacity));
+    if (containers == nullptr) return false;
+    containers_ = containers;
+    capacity_ = capacity;
+    return true;
+}
+
+bool RoaringBitmap::add(uint32_t value) {
+    const auto key = static_cast<uint16_t>(value >> 16);
+    const auto low = static_cast<uint16_t>(value);
+    int32_t index = find(key);
+    if (index < 0) {
+        index = -index - 1;
+        Container created;
+        if (!reserve(count_ + 1) || !newArray(&created, key, 4)) return false;
+        memmove(containers_ + index + 1, containers_ + index,
+                sizeof(Container) * (count_ - static_cast<uint32_t>(index)));
+        containers_[index] = created;
+        count_++;
+    }
+
+    Container& c = containers_[index];
+    if (c.kind == BITMAP) {
+        if (!testBit(words(c), low)) {
+            setBit(words(c), low);
+            c.cardinality++;
+        }
+        return true;
+    }
+    uint16_t* array = values(c);
+    const uint32_t position =
+        static_cast<uint32_t>(std::lower_bound(array, array + c.cardinality, low) - array);
+    if (position < c.cardinality && array[position] == low) return true;
+
+    if (c.cardinality == ARRAY_MAX) {
+        auto* bits = static_cast<uint64_t*>(
+            taggedCalloc(MemoryTag::INDEXES, WORDS, sizeof(uint64_t)));
+        if (bits == nullptr) return false;
+        for (uint32_t i = 0; i < c.cardinality; i++) setBit(bits, array[i]);
+        setBit(bits, low);
+        taggedFree(c.data);
+        c = {key, BITMAP, c.cardinality + 1, 0, bits};
+        return true;
+    }
+    if (c.cardinality == c.capacity) {
+        const uint32_t capacity = std::min(ARRAY_MAX, std::max(4u, c.capacity * 2));
+        auto* grown = static_cast<uint16_t*>(
+            taggedRealloc(MemoryTag::INDEXES, c.data, sizeof(uint16_t) * capacity));
+        if (grown == nullptr) return false;
+        c.data = grown;
+        c.capacity = capacity;
+        array = grown;
+    }
+    memmove(array + position + 1, array + position,
+            sizeof(uint16_t) * (c.cardinality - position));
+    array[position] = low;
+    c.cardinality++;
+    return true;
+}
+
+bool RoaringBitmap::remove(uint32_t value) {
+    const auto low = static_cast<uint16_t>(value);
+    const int32_t index = find(static_cast<uint16_t>(value >> 16));
+    if (index < 0) return false;
+
+    Container& c = containers_[index];
+    if (c.kind == BITMAP) {
+        if (!testBit(words(c), low)) return false;
+        clearBit(words(c), low);
+        c.cardinality--;
+        settle(&c);
+    } else {
+        uint16_t* array = values(c);
+        uint16_t* at = std::lower_bound(array, array + c.cardinality, low);
+        if (at == array + c.cardinality || *at != low) return false;
+        memmove(at, at + 1, sizeof(uint16_t) * static_cast<size_t>(array + c.cardinality - at - 1));
+        c.cardinality--;
+        settle(&c);
+    }
+    if (c.cardinality == 0) {
+        memmove(containers_ + index, containers_ + index + 1,
+                sizeof(Container) * (count_ - static_cast<uint32_t>(index) - 1));
+        count_--;
+    }
+    return true;
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    const int32_t index = find(static_cast<uint16_t>(value >> 16));
+    if (index < 0) return false;
+    const Container& c = containers_[index];
+    const auto low = static_cast<uint16_t>(value);
+    if (c.kind == BITMAP) return testBit(words(c), low);
+    return std::binary_search(values(c), values(c) + c.cardinality, low);
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < count_; i++) total += containers_[i].cardinality;
+    return total;
+}
+
+bool RoaringBitmap::assign(const RoaringBitmap& a, SetOperation operation,
+                           const RoaringBitmap& b) {
+    // Built into new storage, so a or b may be this bitmap
+    const uint32_t capacity = operation == SetOperation::OR ? a.count_ + b.count_ : a.count_;
+    auto* result = static_cast<Container*>(
+        taggedMalloc(MemoryTag::INDEXES, sizeof(Container) * std::max(capacity, 1u)));
+    if (result == nullptr) return false;
+    uint32_t n = 0;
+    bool ok = true;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (ok && i < a.count_) {
+        const Container& x = a.containers_[i];
+        while (j < b.count_ && b.containers_[j].key < x.key) {
+            if (operation == SetOperation::OR) {
+                ok = copyContainer(b.containers_[j], &result[n]);
+                if (!ok) break;
+                n++;
+            }
+            j++;
+        }
+        if (!ok) break;
+        const bool matched = j < b.count_ && b.containers_[j].key == x.key;
+        Container out {};
+        switch (operation) {
+            case SetOperation::AND:
+                if (matched) ok = andContainers(x, b.containers_[j], &out);
+                break;
+            case SetOperation::OR:
+                ok = matched ? orContainers(x, b.containers_[j], &out) : copyContainer(x, &out);
+                break;
+            case SetOperation::AND_NOT:
+                ok = matched ? andNotContainers(x, b.containers_[j], &out) : copyContainer(x, &out);
+                break;
+        }
+        if (ok && out.cardinality > 0) result[n++] = out;
+        if (matched) j++;
+        i++;
+    }
+    while (ok && operation == SetOperation::OR && j < b.count_) {
+        ok = copyContainer(b.containers_[j++], &result[n]);
+        if (ok) n++;
+    }
+    if (!ok) {
+        freeContainers(result, n);
+        return false;
+    }
+    freeContainers(containers_, count_);
+    containers_ = result;
+    count_ = n;
+    capacity_ = std::max(capacity, 1u);
+    return true;
+}
+
+bool RoaringBitmap::copyFrom(const RoaringBitmap& other) {
+    if (&other == this) return true;
+    auto* result = static_cast<Container*>(
+        taggedMalloc(MemoryTag::INDEXES, sizeof(Container) * std::max(other.count_, 1u)));
+    if (result == nullptr) return false;
+    for (uint32_t i = 0; i < other.count_; i++) {
+        if (!copyContainer(other.containers_[i], &result[i])) {
+            freeContainers(result, i);
+            return false;
+        }
+    }
+    freeContainers(containers_, count_);
+    containers_ = result;
+    count_ = other.count_;
+    capacity_ = std::max(other.count_, 1u);
+    return true;
+}
+
+uint64_t RoaringBitmap::andCardinality(const RoaringBitmap& a, const RoaringBitmap& b) {
+    uint64_t total = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i < a.count_ && j < b.count_) {
+        const uint16_t x = a.containers_[i].key;
+        const uint16_t y = b.containers_[j].key;
+        if (x < y) {
+            i++;
+        } else if (x > y) {
+            j++;
+        } else {
+            total += andCount(a.containers_[i++], b.containers_[j++]);
+        }
+    }
+    return total;
+}
+
+size_t RoaringBitmap::toArray(uint32_t* out, size_t capacity) const {
+    size_t n = 0;
+    for (uint32_t i = 0; i < count_ && n < capacity; i++) {
+        const Container& c = containers_[i];
+        const uint32_t high = static_cast<uint32_t>(c.key) << 16;
+        if (c.kind == ARRAY) {
+            for (uint32_t k = 0; k < c.cardinality && n < capacity; k++) {
+                out[n++] = high | values(c)[k];
+            }
+            continue;
+        }
+        const uint64_t* bits = words(c);
+        for (size_t w = 0; w < WORDS && n < capacity; w++) {
+            for (uint64_t word = bits[w]; word != 0 && n < capacity; word &= word - 1) {
+                out[n++] = high | static_cast<uint32_t>(w * 64 + __builtin_ctzll(word));
+            }
+        }
+    }
+    return n;
+}
+
+size_t RoaringBitmap::serializedSize() const {
+    size_t size = sizeof(uint32_t);
+    for (uint32_t i = 0; i < count_; i++) {
+        const Container& c = containers_[i];
+        size += HEADER_BYTES + (c.kind == ARRAY ? sizeof(uint16_t) * c.cardinality : BITMAP_BYTES);
+    }
+    return size;
+}
+
+void RoaringBitmap::serialize(uint8_t* out) const {
+    memcpy(out, &count_, sizeof(uint32_t));
+    out += sizeof(uint32_t);
+    for (uint32_t i = 0; i < count_; i++) {
+        const Container& c = containers_[i];
+        memcpy(out, &c.key, 2);
+        memcpy(out + 2, &c.kind, 2);
+        memcpy(out + 4, &c.cardinality, 4);
+        out += HEADER_BYTES;
+        const size_t bytes = c.kind == ARRAY ? sizeof(uint16_t) * c.cardinality : BITMAP_BYTES;
+        memcpy(out, c.data, bytes);
+        out += bytes;
+    }
+}
+
+size_t RoaringBitmap::deserialize(const uint8_t* data, size_t length) {
+    uint32_t count = 0;
+    if (length < sizeof(uint32_t)) return 0;
+    memcpy(&count, data, sizeof(uint32_t));
+    // Every container takes at least a header and one value
+    if (count > 65536 || count > (length - sizeof(uint32_t)) / (HEADER_BYTES + 2)) return 0;
+
+    auto* result = static_cast<Container*>(
+        taggedMalloc(MemoryTag::INDEXES, sizeof(Container) * std::max(count, 1u)));
+    if (result == nullptr) return 0;
+    size_t offset = sizeof(uint32_t);
+    uint32_t n = 0;
+    bool ok = true;
+    while (ok && n < count) {
+        Container header {};
+        ok = length - offset >= HEADER_BYTES;
+        if (!ok) break;
+        memcpy(&header.key, data + offset, 2);
+        memcpy(&header.kind, data + offset + 2, 2);
+        memcpy(&header.cardinality, data + offset + 4, 4);
+        offset += HEADER_BYTES;
+        const size_t bytes = header.kind == ARRAY ? sizeof(uint16_t) * header.cardinality
+                                                  : BITMAP_BYTES;
+        ok = (header.kind == ARRAY || header.kind == BITMAP) && header.cardinality > 0 &&
+             header.cardinality <= 65536 &&
+             (header.kind == BITMAP || header.cardinality <= ARRAY_MAX) &&
+             (n == 0 || header.key > result[n - 1].key) && length - offset >= bytes;
+        if (!ok) break;
+        header.data = taggedMalloc(MemoryTag::INDEXES, bytes);
+        ok = header.data != nullptr;
+        if (!ok) break;
+        memcpy(header.data, data + offset, bytes);
+        offset += bytes;
+        header.capacity = header.kind == ARRAY ? header.cardinality : 0;
+        result[n++] = header;
+
+        // Arrays strictly ascending, bitmaps counted right
+        if (header.kind == ARRAY) {
+            for (uint32_t k = 1; ok && k < header.cardinality; k++) {
+                ok = values(header)[k - 1] < values(header)[k];
+            }
+        } else {
+            uint32_t bits = 0;
+            for (size_t w = 0; w < WORDS; w++) bits += popcount(words(header)[w]);
+            ok = bits == header.cardinality;
+        }
+    }
+    if (!ok) {
+        freeContainers(result, n);
+        return 0;
+    }
+    freeContainers(containers_, count_);
+    containers_ = result;
+    count_ = count;
+    capacity_ = std::max(count, 1u);
+    return offset;
+}
+
+size_t RoaringBitmap::memoryBytes() const {
+    size_t bytes = sizeof(Container) * capacity_;
+    for (uint32_t i = 0; i < count_; i++) {
+        const Container& c = containers_[i];
+        bytes += c.kind == ARRAY ? sizeof(uint16_t) * c.capacity : BITMAP_BYTES;
+    }
+    return bytes;
+}
+
+void RoaringBitmap::clear() {
+    for (uint32_t i = 0; i < count_; i++) taggedFree(containers_[i].data);
+    count_ = 0;
+}
+
+} // namespace bakingapp::search
@@ -0,0 +1,110 @@
+/**
+ * Compressed set of 32-bit integers (a roaring bitmap)
+ *
+ * Values are split by their high 16 bits into containers of up to 65536
+ * values. A sparse container is a sorted array of the low halves (at most
+ * 4096 of them, 8 KB); a dense one is a 65536-bit bitmap, also 8 KB, so
+ * neither ever takes more than the other would. Bitmap-bitmap operations
+ * run 128 bits at a time with NEON or SSE2 and count bits as they go.
+ *
+ * Not synchronized.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::search {
+
+enum class SetOperation : uint8_t {
+    AND,
+    OR,
+    AND_NOT,
+};
+
+class RoaringBitmap {
+public:
+    RoaringBitmap() = default;
+    ~RoaringBitmap();
+
+    RoaringBitmap(const RoaringBitmap&) = delete;
+    RoaringBitmap& operator=(const RoaringBitmap&) = delete;
+
+    /**
+     * @return false when out of memory
+     */
+    bool add(uint32_t value);
+
+    /**
+     * @return false if value was not in the set
+     */
+    bool remove(uint32_t value);
+
+    bool contains(uint32_t value) const;
+
+    uint64_t cardinality() const;
+
+    bool isEmpty() const { return count_ == 0; }
+
+    /**
+     * Replaces the contents with a op b; either may be this bitmap
+     *
+     * @return false when out of memory, leaving this bitmap unchanged
+     */
+    bool assign(const RoaringBitmap& a, SetOperation operation, const RoaringBitmap& b);
+
+    bool copyFrom(const RoaringBitmap& other);
+
+    /**
+     * |a AND b| without building the intersection
+     */
+    static uint64_t andCardinality(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    /**
+     * Writes the smallest values, ascending
+     *
+     * @return how many were written, at most capacity
+     */
+    size_t toArray(uint32_t* out, size_t capacity) const;
+
+    size_t serializedSize() const;
+
+    /**
+     * Writes serializedSize() bytes into out
+     */
+    void serialize(uint8_t* out) const;
+
+    /**
+     * Replaces the contents with a serialize() output at the start of data
+     *
+     * @return the bytes read, or 0 if they are malformed or memory ran out
+     */
+    size_t deserialize(const uint8_t* data, size_t length);
+
+    /**
+     * Heap bytes held, containers included
+     */
+    size_t memoryBytes() const;
+
+    void clear();
+
+    // Public only for the container kernels in roaring-bitmap.cpp
+    struct Container {
+        uint16_t key;               // high 16 bits of the values
+        uint16_t kind;
+        uint32_t cardinality;
+        uint32_t capacity;          // array containers: values allocated
+        void* data;                 // uint16_t[capacity] or uint64_t[1024]
+    };
+
+private:
+    bool reserve(uint32_t count);
+    int32_t find(uint16_t key) const;
+
+    Container* containers_ = nullptr;   // by key, ascending
+    uint32_t count_ = 0;
+    uint32_t capacity_ = 0;
+};
+
+} // namespace bakingapp::search
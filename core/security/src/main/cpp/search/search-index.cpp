@@ -0,0 +1,309 @@
+#include "search/search-index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+#include "search/text-analyzer.h"
+
+namespace bakingapp::search {
+
+using strings::StringPool;
+
+namespace {
+    // Per-occurrence weight of each SearchField
+    constexpr uint32_t FIELD_WEIGHTS[SEARCH_FIELD_COUNT] = {4, 2, 3, 1};
+
+    constexpr uint32_t MAX_QUERY_TERMS = 16 + SearchIndex::MAX_PREFIX_TERMS;
+
+    inline size_t writeVarint(uint8_t* out, uint32_t value) {
+        size_t n = 0;
+        while (value >= 0x80) {
+            out[n++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = static_cast<uint8_t>(value);
+        return n;
+    }
+
+    inline uint32_t readVarint(const uint8_t** cursor) {
+        const uint8_t* p = *cursor;
+        uint32_t value = 0;
+        for (uint32_t shift = 0;; shift += 7) {
+            const uint8_t byte = *p++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (byte < 0x80) break;
+        }
+        *cursor = p;
+        return value;
+    }
+
+    // Better hits first: higher score, then the earlier document
+    inline bool better(const SearchHit& a, const SearchHit& b) {
+        return a.score > b.score || (a.score == b.score && a.document < b.document);
+    }
+
+    void addTerm(uint32_t* terms, uint32_t* count, uint32_t term) {
+        if (term == StringPool::NONE || *count == MAX_QUERY_TERMS) return;
+        for (uint32_t i = 0; i < *count; i++) {
+            if (terms[i] == term) return;
+        }
+        terms[(*count)++] = term;
+    }
+}
+
+SearchIndex::~SearchIndex() {
+    clear();
+    taggedFree(postings_);
+    taggedFree(documents_);
+    taggedFree(current_);
+    taggedFree(counts_);
+    taggedFree(scores_);
+    taggedFree(touched_);
+}
+
+bool SearchIndex::add(const char* id, size_t idLength, const char* const* fields,
+                      const size_t* lengths) {
+    if (idLength == 0 || idLength > MAX_ID_LENGTH) return false;
+    uint32_t length = 0;
+    if (!collectTerms(fields, lengths, &length)) return false;
+    if (!reserveDocuments(documentCount_ + 1)) return false;
+
+    const uint32_t idRef = ids_.intern(id, idLength);
+    if (idRef == StringPool::NONE) return false;
+    if (idRef > currentCapacity_) {
+        const uint32_t capacity =
+            std::max(idRef, currentCapacity_ == 0 ? 1024u : currentCapacity_ * 2);
+        auto* current = static_cast<uint32_t*>(
+            taggedRealloc(MemoryTag::INDEXES, current_, sizeof(uint32_t) * capacity));
+        if (current == nullptr) return false;
+        memset(current + currentCapacity_, 0, sizeof(uint32_t) * (capacity - currentCapacity_));
+        current_ = current;
+        currentCapacity_ = capacity;
+    }
+    if (current_[idRef - 1] != 0) kill(current_[idRef - 1] - 1);
+
+    const uint32_t document = documentCount_++;
+    documents_[document] = {idRef, length};
+    current_[idRef - 1] = document + 1;
+    live_++;
+    liveLength_ += length;
+
+    for (uint32_t i = 0; i < countLength_; i++) {
+        if (!appendPosting(counts_[i].term, document, counts_[i].count)) {
+            kill(document);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SearchIndex::remove(const char* id, size_t idLength) {
+    const uint32_t idRef = ids_.find(id, idLength);
+    if (idRef == StringPool::NONE || current_[idRef - 1] == 0) return false;
+    kill(current_[idRef - 1] - 1);
+    return true;
+}
+
+size_t SearchIndex::search(const char* query, size_t length, bool prefixLast, SearchHit* hits,
+                           size_t limit) {
+    if (live_ == 0 || limit == 0) return 0;
+
+    uint32_t terms[MAX_QUERY_TERMS];
+    uint32_t termCount = 0;
+    char word[MAX_TERM_LENGTH];
+    char last[MAX_TERM_LENGTH];
+    size_t lastLength = 0;
+    bool lastAtEnd = false;
+    TermReader reader(query, length);
+    for (size_t n; (n = reader.next(word)) > 0;) {
+        memcpy(last, word, n);
+        lastLength = n;
+        lastAtEnd = reader.atEnd();
+        n = stemTerm(word, n);
+        addTerm(terms, &termCount, terms_.find(word, n));
+    }
+
+    if (prefixLast && lastAtEnd && lastLength >= 2) {
+        char stem[MAX_TERM_LENGTH];
+        memcpy(stem, last, lastLength);
+        const size_t stemLength = stemTerm(stem, lastLength);
+        uint32_t expanded = 0;
+        for (uint32_t term = 1; term <= terms_.size() && expanded < MAX_PREFIX_TERMS; term++) {
+            size_t n = 0;
+            const char* text = terms_.text(term, &n);
+            if ((n > lastLength && memcmp(text, last, lastLength) == 0) ||
+                (n > stemLength && memcmp(text, stem, stemLength) == 0)) {
+                addTerm(terms, &termCount, term);
+                expanded++;
+            }
+        }
+    }
+
+    const float averageLength = std::max(1.0f, static_cast<float>(liveLength_) / live_);
+    touchedCount_ = 0;
+    for (uint32_t i = 0; i < termCount; i++) scoreTerm(terms[i], averageLength);
+
+    // Keep the best `limit` in a heap whose top is the worst of them
+    size_t count = 0;
+    for (uint32_t i = 0; i < touchedCount_; i++) {
+        const uint32_t document = touched_[i];
+        const SearchHit hit {document, scores_[document]};
+        scores_[document] = 0;
+        if (count < limit) {
+            hits[count++] = hit;
+            std::push_heap(hits, hits + count, better);
+        } else if (better(hit, hits[0])) {
+            std::pop_heap(hits, hits + count, better);
+            hits[count - 1] = hit;
+            std::push_heap(hits, hits + count, better);
+        }
+    }
+    std::sort_heap(hits, hits + count, better);
+    return count;
+}
+
+const char* SearchIndex::documentId(uint32_t document, size_t* length) const {
+    if (document >= documentCount_) return nullptr;
+    return ids_.text(documents_[document].id, length);
+}
+
+SearchStats SearchIndex::stats() const {
+    return {live_, documentCount_ - live_, terms_.size(), postingBytes_};
+}
+
+void SearchIndex::clear() {
+    for (uint32_t i = 0; i < terms_.size() && i < postingsCapacity_; i++) {
+        taggedFree(postings_[i].bytes);
+    }
+    if (postings_ != nullptr) memset(postings_, 0, sizeof(Postings) * postingsCapacity_);
+    if (current_ != nullptr) memset(current_, 0, sizeof(uint32_t) * currentCapacity_);
+    terms_.clear();
+    ids_.clear();
+    postingBytes_ = 0;
+    documentCount_ = 0;
+    live_ = 0;
+    liveLength_ = 0;
+}
+
+bool SearchIndex::collectTerms(const char* const* fields, const size_t* lengths,
+                               uint32_t* length) {
+    countLength_ = 0;
+    char term[MAX_TERM_LENGTH];
+    for (size_t field = 0; field < SEARCH_FIELD_COUNT; field++) {
+        if (fields[field] == nullptr) continue;
+        TermReader reader(fields[field], lengths[field]);
+        for (size_t n; (n = reader.next(term)) > 0;) {
+            n = stemTerm(term, n);
+            const uint32_t id = terms_.intern(term, n);
+            if (id == StringPool::NONE) return false;
+            if (countLength_ == countCapacity_) {
+                const uint32_t capacity = countCapacity_ == 0 ? 256 : countCapacity_ * 2;
+                auto* counts = static_cast<TermCount*>(
+                    taggedRealloc(MemoryTag::INDEXES, counts_, sizeof(TermCount) * capacity));
+                if (counts == nullptr) return false;
+                counts_ = counts;
+                countCapacity_ = capacity;
+            }
+            counts_[countLength_++] = {id, FIELD_WEIGHTS[field]};
+            *length += FIELD_WEIGHTS[field];
+        }
+    }
+
+    // One entry per term, weights summed
+    std::sort(counts_, counts_ + countLength_,
+              [](const TermCount& a, const TermCount& b) { return a.term < b.term; });
+    uint32_t merged = 0;
+    for (uint32_t i = 0; i < countLength_; i++) {
+        if (merged > 0 && counts_[merged - 1].term == counts_[i].term) {
+            counts_[merged - 1].count += counts_[i].count;
+        } else {
+            counts_[merged++] = counts_[i];
+        }
+    }
+    countLength_ = merged;
+    return true;
+}
+
+bool SearchIndex::appendPosting(uint32_t term, uint32_t document, uint32_t frequency) {
+    if (term > postingsCapacity_) {
+        const uint32_t capacity =
+            std::max(term, postingsCapacity_ == 0 ? 1024u : postingsCapacity_ * 2);
+        auto* postings = static_cast<Postings*>(
+            taggedRealloc(MemoryTag::INDEXES, postings_, sizeof(Postings) * capacity));
+        if (postings == nullptr) return false;
+        memset(postings + postingsCapacity_, 0, sizeof(Postings) * (capacity - postingsCapacity_));
+        postings_ = postings;
+        postingsCapacity_ = capacity;
+    }
+    Postings& list = postings_[term - 1];
+    if (list.capacity - list.length < 10) {
+        const uint32_t capacity = list.capacity == 0 ? 16 : list.capacity * 2;
+        auto* bytes = static_cast<uint8_t*>(
+            taggedRealloc(MemoryTag::INDEXES, list.bytes, capacity));
+        if (bytes == nullptr) return false;
+        postingBytes_ += capacity - list.capacity;
+        list.bytes = bytes;
+        list.capacity = capacity;
+    }
+    // The first delta is from document 0, so it may itself be 0
+    list.length += writeVarint(list.bytes + list.length, document - list.lastDocument);
+    list.length += writeVarint(list.bytes + list.length, frequency);
+    list.lastDocument = document;
+    list.documentFrequency++;
+    return true;
+}
+
+void SearchIndex::kill(uint32_t document) {
+    Document& doc = documents_[document];
+    if (doc.id == StringPool::NONE) return;
+    if (current_[doc.id - 1] == document + 1) current_[doc.id - 1] = 0;
+    doc.id = StringPool::NONE;
+    live_--;
+    liveLength_ -= doc.length;
+}
+
+void SearchIndex::scoreTerm(uint32_t term, float averageLength) {
+    if (term > postingsCapacity_) return;
+    const Postings& list = postings_[term - 1];
+    if (list.documentFrequency == 0) return;
+    const float df = static_cast<float>(list.documentFrequency);
+    const float rest = list.documentFrequency < live_ ? static_cast<float>(live_) - df : 0.0f;
+    const float idf = logf(1.0f + (rest + 0.5f) / (df + 0.5f));
+
+    const uint8_t* p = list.bytes;
+    const uint8_t* const end = list.bytes + list.length;
+    uint32_t document = 0;
+    while (p < end) {
+        document += readVarint(&p);
+        const float frequency = static_cast<float>(readVarint(&p));
+        const Document& doc = documents_[document];
+        if (doc.id == StringPool::NONE) continue;
+        const float norm = K1 * (1.0f - B + B * static_cast<float>(doc.length) / averageLength);
+        if (scores_[document] == 0) touched_[touchedCount_++] = document;
+        scores_[document] += idf * frequency * (K1 + 1.0f) / (frequency + norm);
+    }
+}
+
+bool SearchIndex::reserveDocuments(uint32_t count) {
+    if (count <= documentCapacity_) return true;
+    const uint32_t capacity =
+        std::max(count, documentCapacity_ == 0 ? 1024u : documentCapacity_ * 2);
+    auto* documents = static_cast<Document*>(
+        taggedRealloc(MemoryTag::INDEXES, documents_, sizeof(Document) * capacity));
+    if (documents != nullptr) documents_ = documents;
+    auto* scores = static_cast<float*>(
+        taggedRealloc(MemoryTag::INDEXES, scores_, sizeof(float) * capacity));
+    if (scores != nullptr) scores_ = scores;
+    auto* touched = static_cast<uint32_t*>(
+        taggedRealloc(MemoryTag::INDEXES, touched_, sizeof(uint32_t) * capacity));
+    if (touched != nullptr) touched_ = touched;
+    if (documents == nullptr || scores == nullptr || touched == nullptr) return false;
+    memset(scores_ + documentCapacity_, 0, sizeof(float) * (capacity - documentCapacity_));
+    documentCapacity_ = capacity;
+    return true;
+}
+
+} // namespace bakingapp::search
@@ -0,0 +1,151 @@
+/**
+ * In-memory full-text index over recipes, ranked by BM25
+ *
+ * Each recipe is a document with four fields, analyzed into terms by
+ * search/text-analyzer.h. Term occurrences are weighted by field (a word
+ * in the name counts more than one in a step) and summed per document, as
+ * in BM25F; the weighted sum is the term frequency BM25 sees, and the
+ * weighted term count is the document length.
+ *
+ * Terms are interned (strings/string-pool.h) and each term keeps a
+ * postings list of (document delta, frequency) varints, appended in
+ * document order. Documents are numbered as they are added; replacing or
+ * removing one only marks the old number dead, and its postings are
+ * skipped until clear(). Dead documents still count in document
+ * frequencies, which only dulls idf slightly until the next rebuild.
+ *
+ * Not synchronized: callers that share an index serialize on their own lock.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "strings/string-pool.h"
+
+namespace bakingapp::search {
+
+enum class SearchField : uint8_t {
+    NAME = 0,
+    DESCRIPTION = 1,
+    INGREDIENTS = 2,
+    STEPS = 3,
+};
+
+constexpr size_t SEARCH_FIELD_COUNT = 4;
+
+struct SearchHit {
+    uint32_t document;
+    float score;
+};
+
+struct SearchStats {
+    uint32_t documents;     // live
+    uint32_t dead;          // replaced or removed, still in postings
+    uint32_t terms;
+    uint64_t postingBytes;
+};
+
+class SearchIndex {
+public:
+    // Longest document id; a UUID with room to spare
+    static constexpr size_t MAX_ID_LENGTH = 63;
+
+    // Expansions of a partly typed last query word, by prefix
+    static constexpr uint32_t MAX_PREFIX_TERMS = 32;
+
+    SearchIndex() = default;
+    ~SearchIndex();
+
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+    /**
+     * Indexes a document, replacing any earlier one with the same id
+     *
+     * @param fields SEARCH_FIELD_COUNT UTF-8 texts, indexed by SearchField;
+     *   nullptr for an empty field
+     * @return false for an empty or overlong id, or when out of memory
+     */
+    bool add(const char* id, size_t idLength, const char* const* fields, const size_t* lengths);
+
+    /**
+     * @return false if no document has that id
+     */
+    bool remove(const char* id, size_t idLength);
+
+    /**
+     * Ranks the documents matching any query word
+     *
+     * @param prefixLast also match terms that start with the last word
+     *   when it runs up to the end of the query (search as you type)
+     * @return the number of hits written, best first
+     */
+    size_t search(const char* query, size_t length, bool prefixLast, SearchHit* hits,
+                  size_t limit);
+
+    /**
+     * @return the id of a document from a hit
+     */
+    const char* documentId(uint32_t document, size_t* length) const;
+
+    SearchStats stats() const;
+
+    /**
+     * Drops every document and term
+     */
+    void clear();
+
+private:
+    static constexpr float K1 = 1.2f;
+    static constexpr float B = 0.75f;
+
+    struct Postings {
+        uint8_t* bytes;
+        uint32_t length;
+        uint32_t capacity;
+        uint32_t documentFrequency;
+        uint32_t lastDocument;
+    };
+
+    struct Document {
+        uint32_t id;                // in ids_, StringPool::NONE once dead
+        uint32_t length;            // weighted term count
+    };
+
+    struct TermCount {
+        uint32_t term;
+        uint32_t count;
+    };
+
+    bool appendPosting(uint32_t term, uint32_t document, uint32_t frequency);
+    bool collectTerms(const char* const* fields, const size_t* lengths, uint32_t* length);
+    void kill(uint32_t document);
+    void scoreTerm(uint32_t term, float averageLength);
+    bool reserveDocuments(uint32_t count);
+
+    strings::StringPool terms_;
+    strings::StringPool ids_;
+    Postings* postings_ = nullptr;      // by term - 1
+    uint32_t postingsCapacity_ = 0;
+    uint64_t postingBytes_ = 0;
+
+    Document* documents_ = nullptr;
+    uint32_t documentCount_ = 0;
+    uint32_t documentCapacity_ = 0;
+    uint32_t* current_ = nullptr;       // document + 1 by id - 1, 0 once removed
+    uint32_t currentCapacity_ = 0;
+    uint32_t live_ = 0;
+    uint64_t liveLength_ = 0;
+
+    // Scratch space reused across calls
+    TermCount* counts_ = nullptr;
+    uint32_t countCapacity_ = 0;
+    uint32_t countLength_ = 0;
+    float* scores_ = nullptr;           // by document, sized like documents_
+    uint32_t* touched_ = nullptr;
+    uint32_t touchedCount_ = 0;
+};
+
+} // namespace bakingapp::search
@@ -0,0 +1,171 @@
+/**
+ * JNI bridge for NativeRecipeSearchIndex
+ *
+ * One SearchIndex behind a lock. Documents come in one call per recipe
+ * with the ingredient names and step texts already joined by the caller;
+ * searches return the ranked recipe ids as a String array.
+ */
+
+#include <jni.h>
+
+#include <cstdlib>
+
+#include "common/jni-text.h"
+#include "common/mutex.h"
+#include "common/native-memory.h"
+#include "search/jni-index.h"
+#include "search/search-index.h"
+
+using bakingapp::JniText;
+using bakingapp::LockGuard;
+using bakingapp::MemoryTag;
+using bakingapp::search::SEARCH_FIELD_COUNT;
+using bakingapp::search::SearchHit;
+using bakingapp::search::SearchIndex;
+using bakingapp::search::SearchStats;
+using bakingapp::taggedFree;
+using bakingapp::taggedMalloc;
+
+namespace {
+    constexpr jint MAX_LIMIT = 1000;
+
+    using JniIndex = bakingapp::search::JniIndex<SearchIndex>;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeRecipeSearchIndex_nativeCreate(
+        JNIEnv* /* env */,
+        jobject /* thiz */
+) {
+    return reinterpret_cast<jlong>(bakingapp::createTagged<JniIndex>(MemoryTag::INDEXES));
+}
+
+/**
+ * Indexes one recipe, replacing an earlier version with the same id
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeRecipeSearchIndex_nativeAdd(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id,
+        jstring name,
+        jstring description,
+        jstring ingredients,
+        jstring steps
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    JniText texts[SEARCH_FIELD_COUNT] = {
+        {env, name}, {env, description}, {env, ingredients}, {env, steps},
+    };
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    const char* fields[SEARCH_FIELD_COUNT];
+    size_t lengths[SEARCH_FIELD_COUNT];
+    for (size_t i = 0; i < SEARCH_FIELD_COUNT; i++) {
+        fields[i] = texts[i].chars();
+        lengths[i] = texts[i].length();
+    }
+
+    LockGuard lock(index->mutex);
+    const bool added = index->index.add(idText.chars(), idText.length(), fields, lengths);
+    return added ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeRecipeSearchIndex_nativeRemove(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    return index->index.remove(idText.chars(), idText.length()) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return up to limit recipe ids, best match first
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeRecipeSearchIndex_nativeSearch(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring query,
+        jint limit,
+        jboolean prefixLast
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || query == nullptr || limit <= 0) return nullptr;
+    if (limit > MAX_LIMIT) limit = MAX_LIMIT;
+    JniText queryText(env, query);
+    if (queryText.chars() == nullptr) return nullptr;
+
+    jclass stringClass = env->FindClass("java/lang/String");
+    if (stringClass == nullptr) return nullptr;
+    auto* hits = static_cast<SearchHit*>(
+        taggedMalloc(MemoryTag::INDEXES, sizeof(SearchHit) * static_cast<size_t>(limit)));
+    if (hits == nullptr) return nullptr;
+
+    LockGuard lock(index->mutex);
+    const size_t count = index->index.search(queryText.chars(), queryText.length(),
+                                             prefixLast == JNI_TRUE, hits,
+                                             static_cast<size_t>(limit));
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(count), stringClass, nullptr);
+    for (size_t i = 0; result != nullptr && i < count; i++) {
+        // Ids were NUL-terminated when they were interned
+        jstring id = env->NewStringUTF(index->index.documentId(hits[i].document, nullptr));
+        if (id == nullptr) {
+            result = nullptr;
+            break;
+        }
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), id);
+        env->DeleteLocalRef(id);
+    }
+    taggedFree(hits);
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeRecipeSearchIndex_nativeClear(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return;
+    LockGuard lock(index->mutex);
+    index->index.clear();
+}
+
+/**
+ * @return [documents, dead, terms, postingBytes]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeRecipeSearchIndex_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return nullptr;
+    SearchStats stats;
+    {
+        LockGuard lock(index->mutex);
+        stats = index->index.stats();
+    }
+    const jlong values[4] = {stats.documents, stats.dead, stats.terms,
+                             static_cast<jlong>(stats.postingBytes)};
+    jlongArray result = env->NewLongArray(4);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 4, values);
+    return result;
+}
+
+} // extern "C"
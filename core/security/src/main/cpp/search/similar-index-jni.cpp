@@ -0,0 +1,161 @@
+/**
+ * JNI bridge for NativeSimilarRecipeIndex
+ *
+ * One SimilarIndex behind a lock. Recipes come in one call per recipe with
+ * their ingredient names joined by '\n'; a lookup returns the similar ids
+ * and fills a caller-supplied array with their estimated similarities.
+ */
+
+#include <jni.h>
+
+#include <algorithm>
+
+#include "common/jni-text.h"
+#include "common/mutex.h"
+#include "common/native-memory.h"
+#include "search/jni-index.h"
+#include "search/similar-index.h"
+
+using bakingapp::JniText;
+using bakingapp::LockGuard;
+using bakingapp::MemoryTag;
+using bakingapp::search::SimilarIndex;
+using bakingapp::search::SimilarRecipe;
+using bakingapp::search::SimilarStats;
+
+namespace {
+    using JniIndex = bakingapp::search::JniIndex<SimilarIndex>;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeSimilarRecipeIndex_nativeCreate(
+        JNIEnv* /* env */,
+        jobject /* thiz */
+) {
+    return reinterpret_cast<jlong>(bakingapp::createTagged<JniIndex>(MemoryTag::INDEXES));
+}
+
+/**
+ * Indexes one recipe, replacing its earlier ingredients
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeSimilarRecipeIndex_nativeSetRecipe(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id,
+        jstring ingredients
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    JniText ingredientsText(env, ingredients);
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    const bool set = index->index.setRecipe(idText.chars(), idText.length(),
+                                            ingredientsText.chars(), ingredientsText.length());
+    return set ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeSimilarRecipeIndex_nativeRemoveRecipe(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr) return JNI_FALSE;
+    JniText idText(env, id);
+    if (idText.chars() == nullptr) return JNI_FALSE;
+    LockGuard lock(index->mutex);
+    return index->index.removeRecipe(idText.chars(), idText.length()) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @param similarities receives the estimated similarity of each id, so
+ *   it must hold at least as many as are returned
+ * @return the most similar recipe ids, best first
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeSimilarRecipeIndex_nativeSimilar(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id,
+        jfloat minSimilarity,
+        jfloatArray similarities,
+        jint limit
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr || id == nullptr || similarities == nullptr || limit <= 0) {
+        return nullptr;
+    }
+    limit = std::min<jint>({limit, env->GetArrayLength(similarities),
+                            static_cast<jint>(SimilarIndex::MAX_RESULTS)});
+    JniText idText(env, id);
+    if (idText.chars() == nullptr) return nullptr;
+    jclass stringClass = env->FindClass("java/lang/String");
+    if (stringClass == nullptr) return nullptr;
+
+    SimilarRecipe results[SimilarIndex::MAX_RESULTS];
+    jfloat scores[SimilarIndex::MAX_RESULTS];
+    LockGuard lock(index->mutex);
+    const size_t count = index->index.similar(idText.chars(), idText.length(), minSimilarity,
+                                              results, static_cast<size_t>(limit));
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(count), stringClass, nullptr);
+    for (size_t i = 0; result != nullptr && i < count; i++) {
+        // Ids were NUL-terminated when they were interned
+        jstring other = env->NewStringUTF(index->index.recipeId(results[i].recipe, nullptr));
+        if (other == nullptr) {
+            result = nullptr;
+            break;
+        }
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), other);
+        env->DeleteLocalRef(other);
+        scores[i] = results[i].similarity;
+    }
+    if (result != nullptr) {
+        env->SetFloatArrayRegion(similarities, 0, static_cast<jsize>(count), scores);
+    }
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeSimilarRecipeIndex_nativeClear(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return;
+    LockGuard lock(index->mutex);
+    index->index.clear();
+}
+
+/**
+ * @return [recipes, buckets, entries, staleEntries, bytes]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_search_NativeSimilarRecipeIndex_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniIndex* index = JniIndex::fromHandle(handle);
+    if (index == nullptr) return nullptr;
+    SimilarStats stats;
+    {
+        LockGuard lock(index->mutex);
+        stats = index->index.stats();
+    }
+    const jlong values[5] = {stats.recipes, stats.buckets, stats.entries, stats.staleEntries,
+                             static_cast<jlong>(stats.bytes)};
+    jlongArray result = env->NewLongArray(5);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+} // extern "C"
@@ -0,0 +1,401 @@
+#include "search/similar-index.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/hash.h"
+#include "common/native-memory.h"
+#include "search/text-analyzer.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bakingapp::search {
+
+using strings::StringPool;
+using strings::StringPoolStats;
+
+namespace {
+    // Buckets rebuilt no sooner than this many entries
+    constexpr uint32_t MIN_REBUILD_ENTRIES = 4096;
+
+    /**
+     * Lane i hashes x to a[i] * x + b[i] mod 2^32: a different permutation
+     * of the 32-bit values per lane, since every a[i] is odd
+     */
+    struct LaneSeeds {
+        alignas(16) uint32_t a[SIGNATURE_LANES];
+        alignas(16) uint32_t b[SIGNATURE_LANES];
+    };
+
+    constexpr uint32_t splitMix(uint64_t* state) {
+        uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<uint32_t>(z ^ (z >> 31));
+    }
+
+    constexpr LaneSeeds makeSeeds() {
+        LaneSeeds seeds {};
+        uint64_t state = 0x5DEECE66DULL;
+        for (uint32_t i = 0; i < SIGNATURE_LANES; i++) {
+            seeds.a[i] = splitMix(&state) | 1;
+            seeds.b[i] = splitMix(&state);
+        }
+        return seeds;
+    }
+
+    constexpr LaneSeeds SEEDS = makeSeeds();
+
+#if defined(__SSE2__) && !defined(__ARM_NEON)
+    // SSE2 lacks a 32-bit multiply-low and unsigned compares: even and odd
+    // lanes go through _mm_mul_epu32, and values are compared with their
+    // sign bits flipped
+    inline __m128i mulLow32(__m128i a, __m128i b) {
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+#endif
+
+    /**
+     * Lanes where a and b agree
+     */
+    uint32_t equalLanes(const uint16_t* a, const uint16_t* b) {
+#if defined(__ARM_NEON)
+        // Each equal lane is all ones; subtracting it counts one
+        uint16x8_t counts = vdupq_n_u16(0);
+        for (uint32_t i = 0; i < SIGNATURE_LANES; i += 8) {
+            counts = vsubq_u16(counts, vceqq_u16(vld1q_u16(a + i), vld1q_u16(b + i)));
+        }
+        const uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(counts));
+        return static_cast<uint32_t>(vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1));
+#elif defined(__SSE2__)
+        __m128i counts = _mm_setzero_si128();
+        for (uint32_t i = 0; i < SIGNATURE_LANES; i += 8) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            counts = _mm_sub_epi16(counts, _mm_cmpeq_epi16(x, y));
+        }
+        // Eight 16-bit counts of at most 16 each: sum them as bytes
+        const __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+        return static_cast<uint32_t>(_mm_cvtsi128_si32(sums) +
+                                     _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+#else
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < SIGNATURE_LANES; i++) count += a[i] == b[i];
+        return count;
+#endif
+    }
+
+    inline uint64_t bandKey(const uint16_t* signature, uint32_t band) {
+        uint64_t key;
+        memcpy(&key, signature + band * ROWS_PER_BAND, sizeof(key));
+        return key;
+    }
+
+    inline uint32_t bucketHash(uint32_t band, uint64_t key) {
+        uint64_t h = (key ^ (uint64_t{band} << 56)) * detail::PRIME64_1;
+        h ^= h >> 29;
+        return static_cast<uint32_t>(h ^ (h >> 32));
+    }
+
+    /**
+     * Cuts the next '\n'-separated line off the front of text
+     */
+    bool nextLine(const char** text, const char* end, const char** line, size_t* length) {
+        if (*text >= end) return false;
+        const auto* newline = static_cast<const char*>(memchr(*text, '\n', end - *text));
+        const char* stop = newline != nullptr ? newline : end;
+        *line = *text;
+        *length = static_cast<size_t>(stop - *text);
+        *text = stop + 1;
+        return true;
+    }
+}
+
+static_assert(ROWS_PER_BAND * sizeof(uint16_t) == sizeof(uint64_t), "a band packs one key");
+
+void minHash(const uint64_t* hashes, size_t count, uint32_t* minima) {
+#if defined(__ARM_NEON)
+    uint32x4_t lanes[SIGNATURE_LANES / 4];
+    for (auto& lane : lanes) lane = vdupq_n_u32(UINT32_MAX);
+    for (size_t e = 0; e < count; e++) {
+        const uint32x4_t x = vdupq_n_u32(static_cast<uint32_t>(hashes[e] ^ (hashes[e] >> 32)));
+        for (uint32_t i = 0; i < SIGNATURE_LANES / 4; i++) {
+            const uint32x4_t v =
+                vmlaq_u32(vld1q_u32(SEEDS.b + i * 4), vld1q_u32(SEEDS.a + i * 4), x);
+            lanes[i] = vminq_u32(lanes[i], v);
+        }
+    }
+    for (uint32_t i = 0; i < SIGNATURE_LANES / 4; i++) vst1q_u32(minima + i * 4, lanes[i]);
+#elif defined(__SSE2__)
+    const __m128i sign = _mm_set1_epi32(INT32_MIN);
+    __m128i lanes[SIGNATURE_LANES / 4];
+    for (auto& lane : lanes) lane = _mm_set1_epi32(INT32_MAX);     // UINT32_MAX, flipped
+    for (size_t e = 0; e < count; e++) {
+        const __m128i x = _mm_set1_epi32(static_cast<int32_t>(hashes[e] ^ (hashes[e] >> 32)));
+        for (uint32_t i = 0; i < SIGNATURE_LANES / 4; i++) {
+            const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(SEEDS.a + i * 4));
+            const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(SEEDS.b + i * 4));
+            const __m128i v = _mm_xor_si128(_mm_add_epi32(mulLow32(a, x), b), sign);
+            const __m128i greater = _mm_cmpgt_epi32(lanes[i], v);
+            lanes[i] = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, lanes[i]));
+        }
+    }
+    for (uint32_t i = 0; i < SIGNATURE_LANES / 4; i++) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(minima + i * 4), _mm_xor_si128(lanes[i], sign));
+    }
+#else
+    for (uint32_t i = 0; i < SIGNATURE_LANES; i++) minima[i] = UINT32_MAX;
+    for (size_t e = 0; e < count; e++) {
+        const auto x = static_cast<uint32_t>(hashes[e] ^ (hashes[e] >> 32));
+        for (uint32_t i = 0; i < SIGNATURE_LANES; i++) {
+            minima[i] = std::min(minima[i], SEEDS.a[i] * x + SEEDS.b[i]);
+        }
+    }
+#endif
+}
+
+SimilarIndex::~SimilarIndex() {
+    taggedFree(recipes_);
+    taggedFree(buckets_);
+    taggedFree(entries_);
+}
+
+bool SimilarIndex::setRecipe(const char* id, size_t idLength, const char* ingredients,
+                             size_t length) {
+    if (idLength == 0 || idLength > MAX_ID_LENGTH) return false;
+
+    uint64_t hashes[MAX_INGREDIENTS];
+    uint32_t count = 0;
+    char key[MAX_PHRASE_LENGTH];
+    const char* cursor = ingredients;
+    const char* line;
+    size_t lineLength;
+    while (count < MAX_INGREDIENTS && nextLine(&cursor, ingredients + length, &line, &lineLength)) {
+        const size_t n = normalizePhrase(line, lineLength, key);
+        if (n > 0) hashes[count++] = hash64(key, n);
+    }
+
+    const uint32_t recipe = ids_.intern(id, idLength);
+    if (recipe == StringPool::NONE || !reserveRecipes(recipe)) return false;
+    Recipe& entry = recipes_[recipe - 1];
+    if (entry.live) {
+        entry.live = 0;
+        liveCount_--;
+        staleEntries_ += BANDS;
+    }
+    if (count == 0) return true;
+
+    // Duplicate ingredients hash alike and leave the minima unchanged
+    uint32_t minima[SIGNATURE_LANES];
+    minHash(hashes, count, minima);
+    for (uint32_t i = 0; i < SIGNATURE_LANES; i++) {
+        entry.signature[i] = static_cast<uint16_t>(minima[i]);
+    }
+    entry.live = 1;
+    liveCount_++;
+    if (staleEntries_ >= MIN_REBUILD_ENTRIES && staleEntries_ > entryCount_ - staleEntries_) {
+        return rebuild();
+    }
+    return addEntries(recipe);
+}
+
+bool SimilarIndex::removeRecipe(const char* id, size_t idLength) {
+    const uint32_t recipe = ids_.find(id, idLength);
+    if (recipe == StringPool::NONE || recipe > recipeCapacity_) return false;
+    Recipe& entry = recipes_[recipe - 1];
+    if (!entry.live) return false;
+    entry.live = 0;
+    liveCount_--;
+    staleEntries_ += BANDS;
+    return true;
+}
+
+size_t SimilarIndex::similar(const char* id, size_t idLength, float minSimilarity,
+                             SimilarRecipe* results, size_t limit) {
+    const uint32_t query = ids_.find(id, idLength);
+    if (query == StringPool::NONE || query > recipeCapacity_ || !recipes_[query - 1].live) {
+        return 0;
+    }
+    limit = std::min<size_t>(limit, MAX_RESULTS);
+    if (limit == 0) return 0;
+
+    const uint16_t* signature = recipes_[query - 1].signature;
+    const auto minEqual = static_cast<uint32_t>(
+        std::max(0.0f, minSimilarity) * SIGNATURE_LANES + 0.999f);
+    if (++stamp_ == 0) {
+        for (uint32_t i = 0; i < recipeCapacity_; i++) recipes_[i].stamp = 0;
+        stamp_ = 1;
+    }
+    recipes_[query - 1].stamp = stamp_;
+
+    // Best first; ties keep the order they were found in
+    uint32_t equal[MAX_RESULTS];
+    size_t found = 0;
+    for (uint32_t band = 0; band < BANDS; band++) {
+        const uint64_t key = bandKey(signature, band);
+        const Bucket* bucket = findBucket(band, key);
+        if (bucket == nullptr) continue;
+        for (uint32_t e = bucket->head; e != 0; e = entries_[e - 1].next) {
+            const uint32_t recipe = entries_[e - 1].recipe;
+            Recipe& candidate = recipes_[recipe - 1];
+            // Stale entries are left behind by updates; the recipe's
+            // current band tells them apart
+            if (candidate.stamp == stamp_ || !candidate.live ||
+                bandKey(candidate.signature, band) != key) {
+                continue;
+            }
+            candidate.stamp = stamp_;
+
+            const uint32_t score = equalLanes(signature, candidate.signature);
+            if (score < minEqual || (found == limit && score <= equal[found - 1])) continue;
+            size_t at = found < limit ? found++ : found - 1;
+            for (; at > 0 && equal[at - 1] < score; at--) {
+                equal[at] = equal[at - 1];
+                results[at] = results[at - 1];
+            }
+            equal[at] = score;
+            results[at] = {recipe, static_cast<float>(score) / SIGNATURE_LANES};
+        }
+    }
+    return found;
+}
+
+const char* SimilarIndex::recipeId(uint32_t recipe, size_t* length) const {
+    return ids_.text(recipe, length);
+}
+
+float SimilarIndex::estimate(const char* id, size_t idLength, const char* otherId,
+                             size_t otherLength) const {
+    const uint32_t a = ids_.find(id, idLength);
+    const uint32_t b = ids_.find(otherId, otherLength);
+    if (a == StringPool::NONE || b == StringPool::NONE || a > recipeCapacity_ ||
+        b > recipeCapacity_ || !recipes_[a - 1].live || !recipes_[b - 1].live) {
+        return -1.0f;
+    }
+    return static_cast<float>(equalLanes(recipes_[a - 1].signature, recipes_[b - 1].signature)) /
+           SIGNATURE_LANES;
+}
+
+SimilarStats SimilarIndex::stats() const {
+    const StringPoolStats pool = ids_.stats();
+    return {liveCount_, bucketCount_, entryCount_, staleEntries_,
+            pool.arenaBytes + pool.indexBytes + uint64_t{recipeCapacity_} * sizeof(Recipe) +
+                uint64_t{bucketCapacity_} * sizeof(Bucket) +
+                uint64_t{entryCapacity_} * sizeof(Entry)};
+}
+
+void SimilarIndex::clear() {
+    ids_.clear();
+    taggedFree(recipes_);
+    taggedFree(buckets_);
+    taggedFree(entries_);
+    recipes_ = nullptr;
+    buckets_ = nullptr;
+    entries_ = nullptr;
+    recipeCapacity_ = 0;
+    liveCount_ = 0;
+    stamp_ = 0;
+    bucketCapacity_ = 0;
+    bucketCount_ = 0;
+    entryCount_ = 0;
+    entryCapacity_ = 0;
+    staleEntries_ = 0;
+}
+
+SimilarIndex::Bucket* SimilarIndex::findBucket(uint32_t band, uint64_t key) const {
+    if (bucketCapacity_ == 0) return nullptr;
+    const uint32_t mask = bucketCapacity_ - 1;
+    for (uint32_t i = bucketHash(band, key) & mask;; i = (i + 1) & mask) {
+        Bucket& bucket = buckets_[i];
+        if (bucket.band == 0) return nullptr;
+        if (bucket.band == band + 1 && bucket.key == key) return &bucket;
+    }
+}
+
+bool SimilarIndex::addEntries(uint32_t recipe) {
+    if (entryCount_ + BANDS > entryCapacity_) {
+        const uint32_t capacity = std::max(entryCount_ + BANDS,
+                                           entryCapacity_ == 0 ? 4096u : entryCapacity_ * 2);
+        auto* entries = static_cast<Entry*>(
+            taggedRealloc(MemoryTag::INDEXES, entries_, sizeof(Entry) * capacity));
+        if (entries == nullptr) return false;
+        entries_ = entries;
+        entryCapacity_ = capacity;
+    }
+    // Below half full after every band adds a bucket
+    if (!reserveBuckets(bucketCount_ + BANDS)) return false;
+
+    const uint16_t* signature = recipes_[recipe - 1].signature;
+    const uint32_t mask = bucketCapacity_ - 1;
+    for (uint32_t band = 0; band < BANDS; band++) {
+        const uint64_t key = bandKey(signature, band);
+        uint32_t i = bucketHash(band, key) & mask;
+        while (buckets_[i].band != 0 && (buckets_[i].band != band + 1 || buckets_[i].key != key)) {
+            i = (i + 1) & mask;
+        }
+        Bucket& bucket = buckets_[i];
+        if (bucket.band == 0) {
+            bucket = {key, band + 1, 0};
+            bucketCount_++;
+        }
+        entries_[entryCount_] = {recipe, bucket.head};
+        bucket.head = ++entryCount_;
+    }
+    return true;
+}
+
+bool SimilarIndex::reserveRecipes(uint32_t count) {
+    if (count <= recipeCapacity_) return true;
+    const uint32_t capacity = std::max(count, recipeCapacity_ == 0 ? 256u : recipeCapacity_ * 2);
+    auto* recipes = static_cast<Recipe*>(
+        taggedRealloc(MemoryTag::INDEXES, recipes_, sizeof(Recipe) * capacity));
+    if (recipes == nullptr) return false;
+    memset(recipes + recipeCapacity_, 0, sizeof(Recipe) * (capacity - recipeCapacity_));
+    recipes_ = recipes;
+    recipeCapacity_ = capacity;
+    return true;
+}
+
+bool SimilarIndex::reserveBuckets(uint32_t count) {
+    if (count * 2 <= bucketCapacity_) return true;
+    uint32_t capacity = bucketCapacity_ == 0 ? 1024 : bucketCapacity_;
+    while (capacity < count * 2) capacity *= 2;
+    auto* buckets = static_cast<Bucket*>(
+        taggedCalloc(MemoryTag::INDEXES, capacity, sizeof(Bucket)));
+    if (buckets == nullptr) return false;
+
+    const uint32_t mask = capacity - 1;
+    for (uint32_t b = 0; b < bucketCapacity_; b++) {
+        const Bucket& bucket = buckets_[b];
+        if (bucket.band == 0) continue;
+        uint32_t i = bucketHash(bucket.band - 1, bucket.key) & mask;
+        while (buckets[i].band != 0) i = (i + 1) & mask;
+        buckets[i] = bucket;
+    }
+    taggedFree(buckets_);
+    buckets_ = buckets;
+    bucketCapacity_ = capacity;
+    return true;
+}
+
+bool SimilarIndex::rebuild() {
+    if (bucketCapacity_ > 0) memset(buckets_, 0, sizeof(Bucket) * bucketCapacity_);
+    bucketCount_ = 0;
+    entryCount_ = 0;
+    staleEntries_ = 0;
+    bool added = true;
+    for (uint32_t r = 1; r <= recipeCapacity_ && added; r++) {
+        if (recipes_[r - 1].live) added = addEntries(r);
+    }
+    return added;
+}
+
+} // namespace bakingapp::search
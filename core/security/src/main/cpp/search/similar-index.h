@@ -0,0 +1,162 @@
+/**
+ * MinHash/LSH index of recipes by ingredient set, for "similar recipes"
+ *
+ * Each ingredient name is normalized as the ingredient index does it
+ * (search/text-analyzer.h) and hashed; a recipe's signature keeps, for each
+ * of SIGNATURE_LANES hash functions, the smallest value over its
+ * ingredients. Two recipes agree on a lane with probability equal to the
+ * Jaccard similarity of their ingredient sets, so the fraction of equal
+ * lanes estimates it. Signatures are computed four lanes at a time with
+ * NEON or SSE2 and stored as 16-bit fingerprints of each minimum.
+ *
+ * Locality-sensitive hashing finds the candidates: the signature is cut
+ * into BANDS bands of ROWS_PER_BAND lanes, and recipes with an identical
+ * band share a bucket. A lookup gathers the recipes sharing any band with
+ * the query, scores each by its equal lanes and keeps the best, so it
+ * touches a few buckets rather than every recipe. With 32 bands of 4,
+ * pairs at 0.5 similarity meet in some band 87% of the time, pairs at 0.2
+ * under 5%.
+ *
+ * Updates are incremental: setRecipe() files the new bands and leaves the
+ * old entries in place, skipped on lookup because the recipe's current
+ * band no longer matches; the buckets are rebuilt once stale entries
+ * outnumber live ones.
+ *
+ * Not synchronized: callers that share an index serialize on their own lock.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "strings/string-pool.h"
+
+namespace bakingapp::search {
+
+constexpr uint32_t SIGNATURE_LANES = 128;
+constexpr uint32_t BANDS = 32;
+constexpr uint32_t ROWS_PER_BAND = SIGNATURE_LANES / BANDS;
+
+/**
+ * Computes the minima of every lane over a set of 64-bit element hashes
+ *
+ * @param minima SIGNATURE_LANES values; all ones for an empty set
+ */
+void minHash(const uint64_t* hashes, size_t count, uint32_t* minima);
+
+/**
+ * One lookup result; similarity is the estimated Jaccard similarity
+ */
+struct SimilarRecipe {
+    uint32_t recipe;
+    float similarity;
+};
+
+struct SimilarStats {
+    uint32_t recipes;       // live, with at least one ingredient
+    uint32_t buckets;
+    uint32_t entries;       // band entries, stale ones included
+    uint32_t staleEntries;
+    uint64_t bytes;
+};
+
+class SimilarIndex {
+public:
+    // Longest recipe id; a UUID with room to spare
+    static constexpr size_t MAX_ID_LENGTH = 63;
+
+    // Distinct ingredients hashed per recipe
+    static constexpr uint32_t MAX_INGREDIENTS = 128;
+
+    // Results per lookup
+    static constexpr uint32_t MAX_RESULTS = 64;
+
+    SimilarIndex() = default;
+    ~SimilarIndex();
+
+    SimilarIndex(const SimilarIndex&) = delete;
+    SimilarIndex& operator=(const SimilarIndex&) = delete;
+
+    /**
+     * Indexes a recipe, replacing its earlier ingredients; a recipe with
+     * none is kept out of the buckets
+     *
+     * @param ingredients ingredient names separated by '\n'
+     * @return false for an empty or overlong id, or when out of memory
+     */
+    bool setRecipe(const char* id, size_t idLength, const char* ingredients, size_t length);
+
+    /**
+     * @return false if no recipe has that id
+     */
+    bool removeRecipe(const char* id, size_t idLength);
+
+    /**
+     * Finds the recipes most similar to an indexed one, best first
+     *
+     * @param minSimilarity results estimated below it are left out
+     * @return the number written, at most min(limit, MAX_RESULTS); 0 for
+     *   an unknown recipe
+     */
+    size_t similar(const char* id, size_t idLength, float minSimilarity,
+                   SimilarRecipe* results, size_t limit);
+
+    /**
+     * @return the id of a recipe from similar()
+     */
+    const char* recipeId(uint32_t recipe, size_t* length) const;
+
+    /**
+     * The estimated similarity of two indexed recipes, -1 if either is
+     * unknown or has no ingredients
+     */
+    float estimate(const char* id, size_t idLength, const char* otherId, size_t otherLength) const;
+
+    SimilarStats stats() const;
+
+    /**
+     * Drops every recipe
+     */
+    void clear();
+
+private:
+    struct Recipe {
+        uint16_t signature[SIGNATURE_LANES];
+        uint32_t live;              // indexed with at least one ingredient
+        uint32_t stamp;             // last lookup that scored it
+    };
+
+    struct Bucket {
+        uint64_t key;               // the band's lanes, packed
+        uint32_t band;              // + 1; 0 marks an empty slot
+        uint32_t head;              // first entry + 1
+    };
+
+    struct Entry {
+        uint32_t recipe;
+        uint32_t next;              // + 1; 0 ends the chain
+    };
+
+    Bucket* findBucket(uint32_t band, uint64_t key) const;
+    bool addEntries(uint32_t recipe);
+    bool reserveRecipes(uint32_t count);
+    bool reserveBuckets(uint32_t count);
+    bool rebuild();
+
+    strings::StringPool ids_;
+    Recipe* recipes_ = nullptr;     // by id - 1
+    uint32_t recipeCapacity_ = 0;
+    uint32_t liveCount_ = 0;
+    uint32_t stamp_ = 0;
+
+    Bucket* buckets_ = nullptr;     // open addressing, power of two
+    uint32_t bucketCapacity_ = 0;
+    uint32_t bucketCount_ = 0;
+    Entry* entries_ = nullptr;
+    uint32_t entryCount_ = 0;
+    uint32_t entryCapacity_ = 0;
+    uint32_t staleEntries_ = 0;
+};
+
+} // namespace bakingapp::search
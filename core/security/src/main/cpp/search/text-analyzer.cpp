@@ -0,0 +1,251 @@
+#include "search/text-analyzer.h"
+
+#include <cstring>
+
+namespace bakingapp::search {
+
+namespace {
+    // foldCodePoint() results that are not characters of a word
+    constexpr uint32_t SEPARATOR = 0;
+    constexpr uint32_t IGNORABLE = 1;       // skipped without ending the word
+
+    // Base letters of U+00E0..U+00FF; 0 keeps the letter
+    constexpr char LATIN1_BASE[32] = {
+        'a', 'a', 'a', 'a', 'a', 'a', 0, 'c', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+        0, 'n', 'o', 'o', 'o', 'o', 'o', 0, 'o', 'u', 'u', 'u', 'u', 'y', 0, 'y',
+    };
+
+    /**
+     * Decodes one UTF-8 sequence; malformed bytes come back as U+FFFD one at
+     * a time
+     */
+    uint32_t decodeUtf8(const uint8_t** cursor, const uint8_t* end) {
+        const uint8_t* p = *cursor;
+        const uint8_t lead = p[0];
+        size_t size = 1;
+        uint32_t codePoint = 0xFFFD;
+        if (lead < 0x80) {
+            codePoint = lead;
+        } else if ((lead & 0xE0) == 0xC0) {
+            size = 2;
+            codePoint = lead & 0x1Fu;
+        } else if ((lead & 0xF0) == 0xE0) {
+            size = 3;
+            codePoint = lead & 0x0Fu;
+        } else if ((lead & 0xF8) == 0xF0) {
+            size = 4;
+            codePoint = lead & 0x07u;
+        }
+        if (size > 1) {
+            if (static_cast<size_t>(end - p) < size) {
+                size = 1;
+                codePoint = 0xFFFD;
+            } else {
+                for (size_t i = 1; i < size; i++) {
+                    if ((p[i] & 0xC0) != 0x80) {
+                        size = 1;
+                        codePoint = 0xFFFD;
+                        break;
+                    }
+                    codePoint = codePoint << 6 | (p[i] & 0x3Fu);
+                }
+            }
+        }
+        *cursor = p + size;
+        return codePoint;
+    }
+
+    size_t encodeUtf8(uint32_t codePoint, char* out) {
+        if (codePoint < 0x80) {
+            out[0] = static_cast<char>(codePoint);
+            return 1;
+        }
+        if (codePoint < 0x800) {
+            out[0] = static_cast<char>(0xC0 | codePoint >> 6);
+            out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 2;
+        }
+        if (codePoint < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | codePoint >> 12);
+            out[1] = static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+            out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<char>(0xF0 | codePoint >> 18);
+        out[1] = static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+        out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 4;
+    }
+
+    /**
+     * @return the folded form of a word character, SEPARATOR or IGNORABLE
+     */
+    uint32_t foldCodePoint(uint32_t c) {
+        if (c < 0x80) {
+            if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) return c;
+            if (c >= 'A' && c <= 'Z') return c + 32;
+            return c == '\'' ? IGNORABLE : SEPARATOR;
+        }
+        if (c < 0xC0) return SEPARATOR;                 // Latin-1 punctuation and signs
+        if (c <= 0xFF) {
+            if (c == 0xD7 || c == 0xF7) return SEPARATOR;
+            if (c == 0xDF) return c;                    // ß has no single-letter fold
+            c |= 0x20;
+            return LATIN1_BASE[c - 0xE0] != 0 ? static_cast<uint32_t>(LATIN1_BASE[c - 0xE0]) : c;
+        }
+        if (c < 0x180) {                                // Latin Extended-A: case pairs
+            if (c == 0x178) return 'y';
+            if (c == 0x17F) return 's';
+            const bool upperEven = c < 0x138 || (c >= 0x14A && c < 0x178);
+            const bool upperOdd = (c >= 0x139 && c < 0x149) || (c >= 0x179 && c < 0x17F);
+            if ((upperEven && c % 2 == 0) || (upperOdd && c % 2 == 1)) return c + 1;
+            return c;
+        }
+        if (c >= 0x300 && c < 0x370) return IGNORABLE;  // combining accents
+        if (c >= 0x370 && c < 0x400) {                  // Greek
+            if (c == 0x37E || c == 0x387 || c == 0x375 || c == 0x384 || c == 0x385) {
+                return SEPARATOR;
+            }
+            if (c >= 0x391 && c <= 0x3A9) return c + 32;
+            if (c == 0x3C2) return 0x3C3;               // final sigma
+            if (c == 0x386) return 0x3AC;
+            if (c >= 0x388 && c <= 0x38A) return c + 37;
+            if (c == 0x38C) return 0x3CC;
+            if (c == 0x38E || c == 0x38F) return c + 63;
+            return c;
+        }
+        if (c >= 0x400 && c < 0x500) {                  // Cyrillic
+            if (c < 0x410) return c + 80;
+            if (c < 0x430) return c + 32;
+            if (c >= 0x482 && c <= 0x489) return SEPARATOR;
+            return c;
+        }
+        if (c == 0x2019) return IGNORABLE;              // right single quotation mark
+        // General punctuation to misc. symbols, CJK punctuation, surrogates
+        // (from modified UTF-8), specials, emoji
+        if ((c >= 0x2000 && c < 0x2C00) || (c >= 0x3000 && c < 0x3040) ||
+            (c >= 0xD800 && c < 0xE000) || (c >= 0xFE10 && c < 0xFE70) ||
+            (c >= 0xFF00 && c < 0xFF10) || c >= 0xFFF0 || (c >= 0x1F000 && c < 0x1FB00)) {
+            return SEPARATOR;
+        }
+        return c;
+    }
+
+    inline bool endsWith(const char* term, size_t length, const char* suffix, size_t n) {
+        return length >= n && memcmp(term + length - n, suffix, n) == 0;
+    }
+
+    struct Irregular {
+        const char* word;
+        const char* stem;
+    };
+
+    // Plurals the suffix rules get wrong; their stems still go through the
+    // final step, like the singular does
+    constexpr Irregular IRREGULAR[] = {
+        {"brownies", "brownie"}, {"calves", "calf"}, {"cookies", "cookie"},
+        {"halves", "half"},      {"knives", "knife"}, {"leaves", "leaf"},
+        {"loaves", "loaf"},      {"pies", "pie"},     {"smoothies", "smoothie"},
+        {"veggies", "veggie"},
+    };
+
+    inline bool isVowel(char c) {
+        return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u';
+    }
+}
+
+size_t TermReader::next(char* term) {
+    if (p_ == end_) return 0;
+    size_t length = 0;
+    lastTouchedEnd_ = false;
+    while (p_ < end_) {
+        const uint32_t folded = foldCodePoint(decodeUtf8(&p_, end_));
+        if (folded == IGNORABLE) continue;
+        if (folded == SEPARATOR) {
+            if (length > 0) return length;
+            continue;
+        }
+        char bytes[4];
+        const size_t n = encodeUtf8(folded, bytes);
+        // Past the limit the rest of the word is read and dropped
+        if (length + n <= MAX_TERM_LENGTH) {
+            memcpy(term + length, bytes, n);
+            length += n;
+        }
+    }
+    lastTouchedEnd_ = length > 0;
+    return length;
+}
+
+size_t stemTerm(char* term, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (static_cast<uint8_t>(term[i]) >= 0x80) return length;
+    }
+    if (length <= 3) return length;
+
+    // Plurals: "tomatoes" -> "tomato", "berries" -> "berry", "eggs" -> "egg"
+    bool irregular = false;
+    for (const Irregular& word : IRREGULAR) {
+        const size_t n = strlen(word.word);
+        if (n == length && memcmp(term, word.word, n) == 0) {
+            length = strlen(word.stem);
+            memcpy(term, word.stem, length);
+            irregular = true;
+            break;
+        }
+    }
+    if (!irregular) {
+        if (endsWith(term, length, "ies", 3) && length > 4) {
+            term[length - 3] = 'y';
+            length -= 2;
+        } else if (endsWith(term, length, "oes", 3) && length > 4) {
+            length -= 2;
+        } else if (endsWith(term, length, "sses", 4) || endsWith(term, length, "ches", 4) ||
+                   endsWith(term, length, "shes", 4) || endsWith(term, length, "xes", 3) ||
+                   endsWith(term, length, "zes", 3)) {
+            length -= 2;
+        } else if (term[length - 1] == 's' && !endsWith(term, length, "ss", 2) &&
+                   !endsWith(term, length, "us", 2) && !endsWith(term, length, "is", 2)) {
+            length -= 1;
+        }
+    }
+
+    // Verb forms: "whisked", "whisking" -> "whisk", "chopped" -> "chop"
+    bool stripped = false;
+    if (endsWith(term, length, "ied", 3) && length > 4) {
+        term[length - 3] = 'y';
+        length -= 2;
+    } else if (endsWith(term, length, "ing", 3) && length > 5) {
+        length -= 3;
+        stripped = true;
+    } else if (endsWith(term, length, "ed", 2) && length > 4) {
+        length -= 2;
+        stripped = true;
+    }
+    if (stripped && length >= 2 && term[length - 1] == term[length - 2] &&
+        !isVowel(term[length - 1]) && term[length - 1] != 'l' && term[length - 1] != 's' &&
+        term[length - 1] != 'z') {
+        length -= 1;
+    }
+
+    // Silent e, so "bake" meets "baking" and "baked"
+    if (length > 3 && term[length - 1] == 'e') length -= 1;
+    return length;
+}
+
+size_t normalizePhrase(const char* text, size_t length, char* out) {
+    TermReader reader(text, length);
+    char term[MAX_TERM_LENGTH];
+    size_t n = 0;
+    for (size_t t; (t = reader.next(term)) > 0;) {
+        t = stemTerm(term, t);
+        if (n + (n > 0) + t > MAX_PHRASE_LENGTH) break;
+        if (n > 0) out[n++] = ' ';
+        memcpy(out + n, term, t);
+        n += t;
+    }
+    return n;
+}
+
+} // namespace bakingapp::search
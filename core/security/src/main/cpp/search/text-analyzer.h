@@ -0,0 +1,67 @@
+/**
+ * Splits recipe text into search terms
+ *
+ * Words are runs of letters and digits in UTF-8 text. Each is case folded
+ * (ASCII, Latin-1, Latin Extended-A, Greek and Cyrillic), Latin-1 accents
+ * are dropped ("crème" -> "creme"), and apostrophes inside a word are
+ * skipped ("baker's" -> "bakers"). stemTerm() then reduces English words
+ * to a cooking-domain stem, so "tomatoes", "tomato" and "Tomato" index
+ * and query alike. Index and query text must go through the same steps;
+ * stems are keys, not words ("baking" -> "bak").
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::search {
+
+// Longer words are cut at a character boundary
+constexpr size_t MAX_TERM_LENGTH = 32;
+
+// Longest normalized phrase; longer ones are cut at a word
+constexpr size_t MAX_PHRASE_LENGTH = 128;
+
+class TermReader {
+public:
+    TermReader(const char* text, size_t length)
+        : p_(reinterpret_cast<const uint8_t*>(text)),
+          end_(reinterpret_cast<const uint8_t*>(text) + length) {}
+
+    /**
+     * Writes the next folded word into term (MAX_TERM_LENGTH bytes)
+     *
+     * @return its length, or 0 at the end of the text
+     */
+    size_t next(char* term);
+
+    /**
+     * Whether the last word ran up to the end of the text, as the word
+     * still being typed in a search box does
+     */
+    bool atEnd() const { return p_ == end_ && lastTouchedEnd_; }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* const end_;
+    bool lastTouchedEnd_ = false;
+};
+
+/**
+ * Stems a folded word in place
+ *
+ * @return the stem length; words with non-ASCII letters are kept as they are
+ */
+size_t stemTerm(char* term, size_t length);
+
+/**
+ * Folds and stems every word of text, joined by single spaces, so
+ * "Cherry Tomatoes" and "cherry tomato" give the same phrase
+ *
+ * @param out MAX_PHRASE_LENGTH bytes
+ * @return the phrase length, 0 when text has no words
+ */
+size_t normalizePhrase(const char* text, size_t length, char* out);
+
+} // namespace bakingapp::search
@@ -0,0 +1,194 @@
+#include "sort/radix-sort.h"
+
+#include <cstring>
+
+namespace bakingapp::sort {
+
+namespace {
+    constexpr int PASSES = 8;
+    constexpr size_t BUCKETS = 256;
+
+    // Most values in a row that sortValues() takes for a jump up
+    constexpr size_t MAX_JUMPED = 8;
+
+    // Flipping the sign bit makes signed order unsigned order
+    constexpr uint64_t SIGN_BIT = 1ULL << 63;
+
+    inline uint64_t ordered(int64_t value) {
+        return static_cast<uint64_t>(value) ^ SIGN_BIT;
+    }
+
+    void insertionSort(int64_t* values, size_t count) {
+        for (size_t i = 1; i < count; i++) {
+            const int64_t value = values[i];
+            size_t j = i;
+            while (j > 0 && values[j - 1] > value) {
+                values[j] = values[j - 1];
+                j--;
+            }
+            values[j] = value;
+        }
+    }
+
+    void reverse(int64_t* values, size_t count) {
+        for (size_t i = 0, j = count - 1; i < j; i++, j--) {
+            const int64_t value = values[i];
+            values[i] = values[j];
+            values[j] = value;
+        }
+    }
+
+    /**
+     * Merges the sorted runs values[0, kept) and displaced[0, count - kept)
+     * into values, from the back, so nothing is overwritten before it is read
+     */
+    void mergeBack(int64_t* values, size_t kept, const int64_t* displaced, size_t count) {
+        size_t i = kept;
+        size_t j = count - kept;
+        size_t write = count;
+        while (j > 0) {
+            if (i > 0 && values[i - 1] > displaced[j - 1]) {
+                values[--write] = values[--i];
+            } else {
+                values[--write] = displaced[--j];
+            }
+        }
+    }
+
+    void siftDown(int64_t* heap, size_t count, size_t i) {
+        const int64_t value = heap[i];
+        for (;;) {
+            size_t child = 2 * i + 1;
+            if (child >= count) break;
+            if (child + 1 < count && heap[child + 1] > heap[child]) child++;
+            if (heap[child] <= value) break;
+            heap[i] = heap[child];
+            i = child;
+        }
+        heap[i] = value;
+    }
+}
+
+void radixSort(int64_t* values, size_t count, int64_t* scratch) {
+    if (count <= SMALL_SORT) {
+        insertionSort(values, count);
+        return;
+    }
+
+    // Every pass's histogram in one read of the input
+    size_t counts[PASSES][BUCKETS] = {};
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t key = ordered(values[i]);
+        for (int pass = 0; pass < PASSES; pass++) {
+            counts[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    int64_t* from = values;
+    int64_t* to = scratch;
+    const uint64_t first = ordered(values[0]);
+    for (int pass = 0; pass < PASSES; pass++) {
+        const unsigned shift = pass * 8;
+        size_t* histogram = counts[pass];
+        // Every value has this byte: the pass would not move anything
+        if (histogram[(first >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+            const size_t n = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            const int64_t value = from[i];
+            to[histogram[(ordered(value) >> shift) & 0xFF]++] = value;
+        }
+        int64_t* swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != values) memcpy(values, from, count * sizeof(int64_t));
+}
+
+SortPath sortValues(int64_t* values, size_t count, int64_t* scratch) {
+    if (count < 2) return SortPath::SORTED;
+
+    size_t descents = 0;
+    for (size_t i = 1; i < count; i++) descents += values[i] < values[i - 1];
+    if (descents == 0) return SortPath::SORTED;
+    if (descents == count - 1) {
+        reverse(values, count);
+        return SortPath::REVERSED;
+    }
+    if (count <= SMALL_SORT) {
+        insertionSort(values, count);
+        return SortPath::INSERTION;
+    }
+
+    // Keep the values that continue the ascending run in place and move
+    // the rest aside, giving up as soon as too many have to move. A value
+    // below the run either dipped, and moves, or ends a few values that
+    // jumped up, which move instead: otherwise they would displace
+    // everything after them.
+    const size_t limit = count / MOSTLY_SORTED_DIVISOR;
+    size_t kept = 1;
+    size_t displaced = 0;
+    for (size_t i = 1; i < count; i++) {
+        const int64_t value = values[i];
+        if (value >= values[kept - 1]) {
+            values[kept++] = value;
+            continue;
+        }
+        size_t jumped = 1;
+        while (jumped < kept && jumped < MAX_JUMPED && values[kept - jumped - 1] > value) jumped++;
+        const bool dipped = jumped < kept && values[kept - jumped - 1] > value;
+        const size_t moving = dipped ? 1 : jumped;
+        if (displaced + moving <= limit) {
+            if (dipped) {
+                scratch[displaced++] = value;
+            } else {
+                memcpy(scratch + displaced, values + kept - jumped, jumped * sizeof(int64_t));
+                displaced += jumped;
+                kept -= jumped;
+                values[kept++] = value;
+            }
+        } else {
+            // values[kept, i) is free again: put the displaced back and
+            // sort everything
+            memcpy(values + kept, scratch, displaced * sizeof(int64_t));
+            radixSort(values, count, scratch);
+            return SortPath::RADIX;
+        }
+    }
+
+    // The displaced fit in the hole they left behind the kept run, which
+    // then serves as their radix scratch
+    radixSort(scratch, displaced, values + kept);
+    mergeBack(values, kept, scratch, count);
+    return SortPath::MERGED;
+}
+
+size_t smallestValues(const int64_t* values, size_t count, size_t k, int64_t* out) {
+    if (k > count) k = count;
+    if (k == 0) return 0;
+
+    memcpy(out, values, k * sizeof(int64_t));
+    for (size_t i = k / 2; i-- > 0;) siftDown(out, k, i);
+    for (size_t i = k; i < count; i++) {
+        if (values[i] < out[0]) {
+            out[0] = values[i];
+            siftDown(out, k, 0);
+        }
+    }
+
+    // Heap sort the survivors: the largest goes last
+    for (size_t end = k - 1; end > 0; end--) {
+        const int64_t largest = out[0];
+        out[0] = out[end];
+        out[end] = largest;
+        siftDown(out, end, 0);
+    }
+    return k;
+}
+
+} // namespace bakingapp::sort
@@ -0,0 +1,66 @@
+/**
+ * Sorting and top-K over packed 64-bit keys
+ *
+ * Callers pack what they sort by and where it came from into one value,
+ * (key << ordinalBits) | ordinal, so a list of objects is ordered by
+ * sorting plain integers: equal keys then keep their original order, and
+ * the ordinals say where each object goes.
+ *
+ * sortValues() is adaptive. Input that is already in order (or exactly in
+ * reverse) costs one compare pass. Input that is mostly in order, like a
+ * list re-sorted after a few values were added or changed, has its
+ * out-of-order values pulled aside, sorted on their own and merged back:
+ * O(n) plus the cost of sorting the displaced few. Anything else gets an
+ * LSD radix sort, 8 bits a pass, that skips the passes where every value
+ * has the same byte, so small keys take fewer than eight.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::sort {
+
+// Up to this many values insertion sort beats the radix passes
+constexpr size_t SMALL_SORT = 64;
+
+// Input with more than count / MOSTLY_SORTED_DIVISOR out-of-order values
+// is radix sorted instead of merged
+constexpr size_t MOSTLY_SORTED_DIVISOR = 16;
+
+/**
+ * How sortValues() ordered its input
+ */
+enum class SortPath : uint8_t {
+    SORTED = 0,     // already in order
+    REVERSED = 1,   // in strictly descending order, reversed
+    INSERTION = 2,  // small input
+    MERGED = 3,     // mostly in order, displaced values merged back
+    RADIX = 4,      // full radix sort
+};
+
+/**
+ * LSD radix sort, ascending as signed values
+ *
+ * @param scratch room for count values
+ */
+void radixSort(int64_t* values, size_t count, int64_t* scratch);
+
+/**
+ * Sorts ascending as signed values, taking the cheapest path that fits
+ *
+ * @param scratch room for count values
+ */
+SortPath sortValues(int64_t* values, size_t count, int64_t* scratch);
+
+/**
+ * The k smallest values, ascending, through a k-entry max-heap: one
+ * compare for each value that does not make the cut
+ *
+ * @param out room for k values
+ * @return min(k, count)
+ */
+size_t smallestValues(const int64_t* values, size_t count, size_t k, int64_t* out);
+
+} // namespace bakingapp::sort
@@ -0,0 +1,101 @@
+/**
+ * JNI bridge for NativeKeySorter
+ *
+ * Stateless: the packed values are sorted in place inside the long[] the
+ * caller passes, pinned as a critical region, with scratch memory taken
+ * before the pin. Nothing in between calls back into the VM.
+ */
+
+#include <jni.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+#include "sort/radix-sort.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::sort::smallestValues;
+using bakingapp::sort::sortValues;
+using bakingapp::taggedFree;
+using bakingapp::taggedMalloc;
+
+namespace {
+    // From this share of the input on, sorting a copy beats the heap
+    constexpr size_t HEAP_DIVISOR = 8;
+}
+
+extern "C" {
+
+/**
+ * Sorts values ascending in place
+ *
+ * @return the SortPath taken, or -1 if no scratch memory was available
+ */
+JNIEXPORT jint JNICALL
+Java_com_eslam_bakingapp_core_security_sort_NativeKeySorter_nativeSort(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlongArray values
+) {
+    if (values == nullptr) return -1;
+    const auto count = static_cast<size_t>(env->GetArrayLength(values));
+    auto* scratch = static_cast<int64_t*>(
+        taggedMalloc(MemoryTag::RUNTIME, sizeof(int64_t) * (count > 0 ? count : 1)));
+    if (scratch == nullptr) return -1;
+
+    jint path = -1;
+    auto* data = static_cast<int64_t*>(env->GetPrimitiveArrayCritical(values, nullptr));
+    if (data != nullptr) {
+        path = static_cast<jint>(sortValues(data, count, scratch));
+        env->ReleasePrimitiveArrayCritical(values, data, 0);
+    }
+    taggedFree(scratch);
+    return path;
+}
+
+/**
+ * @return the k smallest values, ascending (all of them if there are
+ *   fewer), or null if no memory was available
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_sort_NativeKeySorter_nativeSmallest(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlongArray values,
+        jint k
+) {
+    if (values == nullptr || k < 0) return nullptr;
+    const auto count = static_cast<size_t>(env->GetArrayLength(values));
+    const size_t wanted = static_cast<size_t>(k) < count ? static_cast<size_t>(k) : count;
+    const bool sortAll = wanted * HEAP_DIVISOR >= count;
+
+    // Sorting everything needs a copy and its scratch; the heap just k
+    const size_t capacity = sortAll ? 2 * count : wanted;
+    auto* buffer = static_cast<int64_t*>(
+        taggedMalloc(MemoryTag::RUNTIME, sizeof(int64_t) * (capacity > 0 ? capacity : 1)));
+    if (buffer == nullptr) return nullptr;
+
+    bool done = false;
+    auto* data = static_cast<int64_t*>(env->GetPrimitiveArrayCritical(values, nullptr));
+    if (data != nullptr) {
+        if (sortAll) {
+            memcpy(buffer, data, count * sizeof(int64_t));
+        } else {
+            smallestValues(data, count, wanted, buffer);
+        }
+        env->ReleasePrimitiveArrayCritical(values, data, JNI_ABORT);
+        if (sortAll) sortValues(buffer, count, buffer + count);
+        done = true;
+    }
+
+    jlongArray result = done ? env->NewLongArray(static_cast<jsize>(wanted)) : nullptr;
+    if (result != nullptr && wanted > 0) {
+        env->SetLongArrayRegion(result, 0, static_cast<jsize>(wanted),
+                                reinterpret_cast<const jlong*>(buffer));
+    }
+    taggedFree(buffer);
+    return result;
+}
+
+} // extern "C"
@@ -0,0 +1,211 @@
+/**
+ * JNI bridge for the transactional secure store
+ *
+ * A Kotlin transaction is buffered on the JVM side and arrives as one
+ * nativeCommit() call: parallel arrays of keys and values, a null value
+ * standing for a removal. Values are UTF-8 bytes encoded by the caller.
+ */
+
+#include <jni.h>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+#include "crypto/sha256.h"
+#include "store/secure-store.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::crypto::secureZero;
+using bakingapp::store::MAX_STORE_KEY_LENGTH;
+using bakingapp::store::MAX_STORE_VALUE_LENGTH;
+using bakingapp::store::STORE_KEY_BYTES;
+using bakingapp::store::SecureStore;
+using bakingapp::store::StoreStats;
+using bakingapp::store::StoreTransaction;
+using bakingapp::taggedFree;
+using bakingapp::taggedMalloc;
+
+namespace {
+    // Values up to this size are read through the stack
+    constexpr size_t STACK_VALUE_BYTES = 1024;
+
+    SecureStore* fromHandle(jlong handle) {
+        return reinterpret_cast<SecureStore*>(handle);
+    }
+
+    /**
+     * A store key copied out of a Java string (modified UTF-8)
+     */
+    struct Key {
+        char chars[MAX_STORE_KEY_LENGTH + 1];    // GetStringUTFRegion adds a NUL
+        size_t length = 0;
+
+        Key(JNIEnv* env, jstring string) {
+            if (string == nullptr) return;
+            const jsize utfLength = env->GetStringUTFLength(string);
+            if (utfLength <= 0 || static_cast<size_t>(utfLength) > MAX_STORE_KEY_LENGTH) return;
+            env->GetStringUTFRegion(string, 0, env->GetStringLength(string), chars);
+            length = static_cast<size_t>(utfLength);
+        }
+    };
+
+    /**
+     * Adds one put (or, for a null value, a removal) to transaction
+     */
+    bool addOperation(JNIEnv* env, StoreTransaction& transaction, jstring keyString,
+                      jbyteArray value) {
+        const Key key(env, keyString);
+        if (key.length == 0) return false;
+        if (value == nullptr) return transaction.remove(key.chars, key.length);
+
+        const auto length = static_cast<size_t>(env->GetArrayLength(value));
+        if (length > MAX_STORE_VALUE_LENGTH) return false;
+        auto* bytes = static_cast<uint8_t*>(
+            taggedMalloc(MemoryTag::STORE, length > 0 ? length : 1));
+        if (bytes == nullptr) return false;
+        env->GetByteArrayRegion(value, 0, static_cast<jsize>(length),
+                                reinterpret_cast<jbyte*>(bytes));
+        const bool added = transaction.put(key.chars, key.length, bytes, length);
+        secureZero(bytes, length);
+        taggedFree(bytes);
+        return added;
+    }
+}
+
+extern "C" {
+
+/**
+ * @param key STORE_KEY_BYTES bytes, copied; the caller wipes its array
+ * @return a handle, or 0 if the log could not be opened
+ */
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_store_NativeSecureStore_nativeOpen(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring file,
+        jbyteArray key
+) {
+    if (file == nullptr || key == nullptr ||
+        env->GetArrayLength(key) != static_cast<jsize>(STORE_KEY_BYTES)) {
+        return 0;
+    }
+    uint8_t keyBytes[STORE_KEY_BYTES];
+    env->GetByteArrayRegion(key, 0, static_cast<jsize>(STORE_KEY_BYTES),
+                            reinterpret_cast<jbyte*>(keyBytes));
+
+    const char* path = env->GetStringUTFChars(file, nullptr);
+    if (path == nullptr) {
+        secureZero(keyBytes, sizeof(keyBytes));
+        return 0;
+    }
+    auto* store = bakingapp::createTagged<SecureStore>(MemoryTag::STORE);
+    const bool opened = store != nullptr && store->open(path, keyBytes);
+    env->ReleaseStringUTFChars(file, path);
+    secureZero(keyBytes, sizeof(keyBytes));
+
+    if (!opened) {
+        bakingapp::destroyTagged(store);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(store);
+}
+
+/**
+ * Commits keys[i] = values[i] for every i as one transaction, returning
+ * once it is on storage
+ *
+ * @return false (nothing stored) for mismatched arrays, an invalid key or
+ *   value, or a failed write
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_store_NativeSecureStore_nativeCommit(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jobjectArray keys,
+        jobjectArray values
+) {
+    SecureStore* store = fromHandle(handle);
+    if (store == nullptr || keys == nullptr || values == nullptr) return JNI_FALSE;
+    const jsize count = env->GetArrayLength(keys);
+    if (env->GetArrayLength(values) != count) return JNI_FALSE;
+
+    StoreTransaction transaction;
+    for (jsize i = 0; i < count; i++) {
+        auto key = static_cast<jstring>(env->GetObjectArrayElement(keys, i));
+        auto value = static_cast<jbyteArray>(env->GetObjectArrayElement(values, i));
+        const bool added = addOperation(env, transaction, key, value);
+        env->DeleteLocalRef(key);
+        if (value != nullptr) env->DeleteLocalRef(value);
+        if (!added) return JNI_FALSE;
+    }
+    return store->commit(transaction) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return the value's bytes, or null if the key is absent
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_eslam_bakingapp_core_security_store_NativeSecureStore_nativeGet(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring keyString
+) {
+    SecureStore* store = fromHandle(handle);
+    const Key key(env, keyString);
+    if (store == nullptr || key.length == 0) return nullptr;
+
+    uint8_t onStack[STACK_VALUE_BYTES];
+    uint8_t* buffer = onStack;
+    size_t capacity = sizeof(onStack);
+    size_t length = 0;
+    jbyteArray result = nullptr;
+    // A commit between two reads may grow the value again
+    while (store->get(key.chars, key.length, buffer, capacity, &length)) {
+        if (length <= capacity) {
+            result = env->NewByteArray(static_cast<jsize>(length));
+            if (result != nullptr && length > 0) {
+                env->SetByteArrayRegion(result, 0, static_cast<jsize>(length),
+                                        reinterpret_cast<const jbyte*>(buffer));
+            }
+            break;
+        }
+        if (buffer != onStack) {
+            secureZero(buffer, capacity);
+            taggedFree(buffer);
+        }
+        buffer = static_cast<uint8_t*>(taggedMalloc(MemoryTag::STORE, length));
+        if (buffer == nullptr) return nullptr;
+        capacity = length;
+    }
+    secureZero(buffer, capacity);
+    if (buffer != onStack) taggedFree(buffer);
+    return result;
+}
+
+/**
+ * @return [keys, transactions, flushes, usedBytes, liveBytes, droppedBytes]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_store_NativeSecureStore_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    SecureStore* store = fromHandle(handle);
+    StoreStats stats = store != nullptr ? store->stats() : StoreStats{};
+    const jlong values[] = {
+        static_cast<jlong>(stats.keys),
+        static_cast<jlong>(stats.transactions),
+        static_cast<jlong>(stats.flushes),
+        static_cast<jlong>(stats.usedBytes),
+        static_cast<jlong>(stats.liveBytes),
+        static_cast<jlong>(stats.droppedBytes),
+    };
+    jlongArray result = env->NewLongArray(6);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
+
+} // extern "C"
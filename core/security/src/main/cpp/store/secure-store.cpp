@@ -0,0 +1,551 @@
+#include "store/secure-store.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "common/hash.h"
+#include "common/mapped-file.h"
+#include "common/native-memory.h"
+#include "crypto/secure-random.h"
+#include "crypto/sha256.h"
+
+namespace bakingapp::store {
+
+using crypto::CHACHA20_NONCE_BYTES;
+using crypto::POLY1305_TAG_BYTES;
+using crypto::secureZero;
+
+namespace {
+    constexpr uint32_t STORE_MAGIC = 0x53534B42; // "BKSS"
+    constexpr uint32_t STORE_VERSION = 1;
+    constexpr uint64_t COMPACTION_MIN_BYTES = 16 * 1024;
+    constexpr size_t MIN_TRANSACTION_CAPACITY = 256;
+
+    enum : uint8_t { OP_PUT = 1, OP_REMOVE = 2 };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t reserved;
+    };
+
+    /**
+     * Followed by the sealed operations and their tag. The tag also covers
+     * everything in this header after the CRC.
+     */
+    struct RecordHeader {
+        uint32_t crc;           // CRC32 of the rest of the record
+        uint32_t length;        // this header, payload and tag
+        uint32_t operations;
+        uint8_t nonce[CHACHA20_NONCE_BYTES];
+    };
+
+    struct OperationHeader {
+        uint8_t op;
+        uint8_t reserved;
+        uint16_t keyLength;
+        uint32_t valueLength;   // 0 for OP_REMOVE
+    };
+
+    static_assert(sizeof(FileHeader) == 16, "file layout");
+    static_assert(sizeof(RecordHeader) == 24, "file layout");
+    static_assert(sizeof(OperationHeader) == 8, "file layout");
+
+    constexpr size_t AAD_OFFSET = sizeof(uint32_t);
+    constexpr size_t AAD_LENGTH = sizeof(RecordHeader) - AAD_OFFSET;
+    constexpr size_t RECORD_OVERHEAD = sizeof(RecordHeader) + POLY1305_TAG_BYTES;
+
+    uint32_t recordCrc(const uint8_t* record, size_t length) {
+        const auto crc = crc32(0L, record + sizeof(uint32_t),
+                               static_cast<uInt>(length - sizeof(uint32_t)));
+        return static_cast<uint32_t>(crc);
+    }
+
+    /**
+     * Walks a payload's operations, checking each lies inside it
+     */
+    bool validOperations(const uint8_t* payload, size_t length, uint32_t operations) {
+        size_t position = 0;
+        for (uint32_t i = 0; i < operations; i++) {
+            if (length - position < sizeof(OperationHeader)) return false;
+            OperationHeader header {};
+            memcpy(&header, payload + position, sizeof(header));
+            if ((header.op != OP_PUT && header.op != OP_REMOVE) || header.keyLength == 0 ||
+                header.keyLength > MAX_STORE_KEY_LENGTH ||
+                header.valueLength > MAX_STORE_VALUE_LENGTH) {
+                return false;
+            }
+            position += sizeof(header);
+            const size_t body = size_t {header.keyLength} + header.valueLength;
+            if (length - position < body) return false;
+            position += body;
+        }
+        return position == length;
+    }
+
+    bool writeHeader(int fd) {
+        const FileHeader header {STORE_MAGIC, STORE_VERSION, 0};
+        return ftruncate(fd, 0) == 0 && writeFully(fd, &header, sizeof(header), 0) &&
+               fdatasync(fd) == 0;
+    }
+}
+
+// ==================== StoreTransaction ====================
+
+StoreTransaction::~StoreTransaction() {
+    if (data_ == nullptr) return;
+    secureZero(data_, capacity_);
+    taggedFree(data_);
+}
+
+void StoreTransaction::begin() {
+    if (data_ != nullptr) secureZero(data_, length_);
+    length_ = 0;
+    operations_ = 0;
+    failed_ = false;
+}
+
+bool StoreTransaction::put(const char* key, size_t keyLength, const void* value,
+                           size_t valueLength) {
+    return append(OP_PUT, key, keyLength, value, valueLength);
+}
+
+bool StoreTransaction::remove(const char* key, size_t keyLength) {
+    return append(OP_REMOVE, key, keyLength, nullptr, 0);
+}
+
+bool StoreTransaction::append(uint8_t op, const char* key, size_t keyLength, const void* value,
+                              size_t valueLength) {
+    if (failed_) return false;
+    const size_t needed = length_ + sizeof(OperationHeader) + keyLength + valueLength;
+    if (keyLength == 0 || keyLength > MAX_STORE_KEY_LENGTH ||
+        valueLength > MAX_STORE_VALUE_LENGTH || needed > MAX_TRANSACTION_BYTES) {
+        failed_ = true;
+        return false;
+    }
+    if (needed > capacity_) {
+        // Not taggedRealloc(MemoryTag::STORE, ): the old buffer must be wiped, not left to the heap
+        size_t capacity = capacity_ < MIN_TRANSACTION_CAPACITY ? MIN_TRANSACTION_CAPACITY
+                                                               : capacity_ * 2;
+        if (capacity < needed) capacity = needed;
+        auto* grown = static_cast<uint8_t*>(taggedMalloc(MemoryTag::STORE, capacity));
+        if (grown == nullptr) {
+            failed_ = true;
+            return false;
+        }
+        if (data_ != nullptr) {
+            memcpy(grown, data_, length_);
+            secureZero(data_, capacity_);
+            taggedFree(data_);
+        }
+        data_ = grown;
+        capacity_ = capacity;
+    }
+
+    const OperationHeader header {op, 0, static_cast<uint16_t>(keyLength),
+                                  static_cast<uint32_t>(valueLength)};
+    uint8_t* p = data_ + length_;
+    memcpy(p, &header, sizeof(header));
+    memcpy(p + sizeof(header), key, keyLength);
+    if (valueLength > 0) memcpy(p + sizeof(header) + keyLength, value, valueLength);
+    length_ = needed;
+    operations_++;
+    return true;
+}
+
+// ==================== SecureStore ====================
+
+SecureStore::SecureStore() {
+    pthread_cond_init(&flushed_, nullptr);
+}
+
+SecureStore::~SecureStore() {
+    close();
+    pthread_cond_destroy(&flushed_);
+}
+
+bool SecureStore::open(const char* path, const uint8_t key[STORE_KEY_BYTES]) {
+    close();
+    LockGuard lock(mutex_);
+    const size_t length = strlen(path);
+    if (length >= sizeof(path_)) return false;
+    memcpy(path_, path, length + 1);
+    memcpy(key_, key, STORE_KEY_BYTES);
+
+    fd_ = ::open(path_, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ >= 0 && replay()) return true;
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    clearEntries();
+    secureZero(key_, sizeof(key_));
+    return false;
+}
+
+void SecureStore::close() {
+    LockGuard lock(mutex_);
+    while (flushing_) pthread_cond_wait(&flushed_, mutex_.native());
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    clearEntries();
+    secureZero(key_, sizeof(key_));
+    end_ = 0;
+    transactions_ = 0;
+    flushes_ = 0;
+}
+
+bool SecureStore::isOpen() {
+    LockGuard lock(mutex_);
+    return fd_ >= 0;
+}
+
+void SecureStore::clearEntries() {
+    for (uint32_t i = 0; i < entryCount_; i++) {
+        secureZero(entries_[i].bytes, entries_[i].keyLength + entries_[i].valueLength);
+        taggedFree(entries_[i].bytes);
+    }
+    taggedFree(entries_);
+    entries_ = nullptr;
+    entryCount_ = entryCapacity_ = 0;
+    liveValueBytes_ = 0;
+}
+
+bool SecureStore::replay() {
+    clearEntries();
+    droppedBytes_ = 0;
+
+    struct stat st {};
+    if (fstat(fd_, &st) != 0) return false;
+    const auto size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(FileHeader)) {
+        droppedBytes_ = size;
+        end_ = sizeof(FileHeader);
+        return writeHeader(fd_);
+    }
+
+    auto* data = static_cast<uint8_t*>(taggedMalloc(MemoryTag::STORE, size));
+    if (data == nullptr) return false;
+    if (!readFully(fd_, data, size, 0)) {
+        taggedFree(data);
+        return false;
+    }
+
+    FileHeader header {};
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != STORE_MAGIC || header.version != STORE_VERSION) {
+        // Not a log this version can read: start over
+        taggedFree(data);
+        droppedBytes_ = size;
+        end_ = sizeof(FileHeader);
+        return writeHeader(fd_);
+    }
+
+    size_t position = sizeof(FileHeader);
+    while (size - position >= RECORD_OVERHEAD) {
+        RecordHeader record {};
+        memcpy(&record, data + position, sizeof(record));
+        if (record.length < RECORD_OVERHEAD || record.length > size - position ||
+            recordCrc(data + position, record.length) != record.crc) {
+            break;
+        }
+        uint8_t* payload = data + position + sizeof(RecordHeader);
+        const size_t payloadLength = record.length - RECORD_OVERHEAD;
+        if (!crypto::aeadOpen(key_, record.nonce, data + position + AAD_OFFSET, AAD_LENGTH,
+                              payload, payloadLength, payload + payloadLength)) {
+            break;
+        }
+        const bool applied = applyOperations(payload, payloadLength, record.operations);
+        secureZero(payload, payloadLength);
+        if (!applied) break;
+        position += record.length;
+    }
+    taggedFree(data);
+
+    // The rest is a torn flush, or records this key cannot open: cut it
+    // off so the next flush continues from the last good record
+    end_ = position;
+    if (position < size) {
+        droppedBytes_ = size - position;
+        if (ftruncate(fd_, static_cast<off_t>(position)) != 0 || fdatasync(fd_) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SecureStore::applyOperations(const uint8_t* payload, size_t length, uint32_t operations) {
+    if (!validOperations(payload, length, operations)) return false;
+    size_t position = 0;
+    for (uint32_t i = 0; i < operations; i++) {
+        OperationHeader header {};
+        memcpy(&header, payload + position, sizeof(header));
+        const auto* key = reinterpret_cast<const char*>(payload + position + sizeof(header));
+        if (header.op == OP_PUT) {
+            if (!set(key, header.keyLength, payload + position + sizeof(header) + header.keyLength,
+                     header.valueLength)) {
+                return false;
+            }
+        } else {
+            erase(key, header.keyLength);
+        }
+        position += sizeof(header) + header.keyLength + header.valueLength;
+    }
+    return true;
+}
+
+/**
+ * The size of the log compact() would write
+ */
+uint64_t SecureStore::liveBytes() const {
+    return sizeof(FileHeader) + (entryCount_ > 0 ? RECORD_OVERHEAD + liveValueBytes_ : 0);
+}
+
+int32_t SecureStore::find(uint64_t hash, const char* key, size_t keyLength) const {
+    for (uint32_t i = 0; i < entryCount_; i++) {
+        const Entry& entry = entries_[i];
+        if (entry.hash == hash && entry.keyLength == keyLength &&
+            memcmp(entry.bytes, key, keyLength) == 0) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
+
+bool SecureStore::set(const char* key, size_t keyLength, const uint8_t* value,
+                      size_t valueLength) {
+    auto* bytes = static_cast<uint8_t*>(taggedMalloc(MemoryTag::STORE, keyLength + valueLength));
+    if (bytes == nullptr) return false;
+    memcpy(bytes, key, keyLength);
+    if (valueLength > 0) memcpy(bytes + keyLength, value, valueLength);
+
+    const uint64_t hash = hash64(key, keyLength);
+    const int32_t index = find(hash, key, keyLength);
+    if (index >= 0) {
+        Entry& entry = entries_[index];
+        liveValueBytes_ -= entry.valueLength;
+        secureZero(entry.bytes, entry.keyLength + entry.valueLength);
+        taggedFree(entry.bytes);
+        entry.bytes = bytes;
+        entry.valueLength = static_cast<uint32_t>(valueLength);
+        liveValueBytes_ += valueLength;
+        return true;
+    }
+
+    if (entryCount_ == entryCapacity_) {
+        const uint32_t capacity = entryCapacity_ == 0 ? 8 : entryCapacity_ * 2;
+        auto* grown = static_cast<Entry*>(
+            taggedRealloc(MemoryTag::STORE, entries_, capacity * sizeof(Entry)));
+        if (grown == nullptr) {
+            taggedFree(bytes);
+            return false;
+        }
+        entries_ = grown;
+        entryCapacity_ = capacity;
+    }
+    entries_[entryCount_++] = {hash, bytes, static_cast<uint32_t>(keyLength),
+                               static_cast<uint32_t>(valueLength)};
+    liveValueBytes_ += sizeof(OperationHeader) + keyLength + valueLength;
+    return true;
+}
+
+void SecureStore::erase(const char* key, size_t keyLength) {
+    const int32_t index = find(hash64(key, keyLength), key, keyLength);
+    if (index < 0) return;
+    Entry& entry = entries_[index];
+    liveValueBytes_ -= sizeof(OperationHeader) + entry.keyLength + entry.valueLength;
+    secureZero(entry.bytes, entry.keyLength + entry.valueLength);
+    taggedFree(entry.bytes);
+    entry = entries_[--entryCount_];
+}
+
+uint8_t* SecureStore::seal(const uint8_t* payload, size_t payloadLength, uint32_t operations,
+                           size_t* recordLength) {
+    const size_t length = RECORD_OVERHEAD + payloadLength;
+    auto* record = static_cast<uint8_t*>(taggedMalloc(MemoryTag::STORE, length));
+    if (record == nullptr) return nullptr;
+
+    RecordHeader header {};
+    header.length = static_cast<uint32_t>(length);
+    header.operations = operations;
+    if (!crypto::randomBytes(header.nonce, sizeof(header.nonce))) {
+        taggedFree(record);
+        return nullptr;
+    }
+    memcpy(record, &header, sizeof(header));
+    uint8_t* sealed = record + sizeof(RecordHeader);
+    memcpy(sealed, payload, payloadLength);
+    crypto::aeadSeal(key_, header.nonce, record + AAD_OFFSET, AAD_LENGTH, sealed, payloadLength,
+                     sealed + payloadLength);
+    const uint32_t crc = recordCrc(record, length);
+    memcpy(record, &crc, sizeof(crc));
+    *recordLength = length;
+    return record;
+}
+
+bool SecureStore::commit(const StoreTransaction& transaction) {
+    if (transaction.failed_) return false;
+    if (transaction.operations_ == 0) return true;
+
+    // Sealed before taking the lock, so concurrent commits encrypt in
+    // parallel and only queue for the write
+    size_t length = 0;
+    uint8_t* record = seal(transaction.data_, transaction.length_, transaction.operations_,
+                           &length);
+    if (record == nullptr) return false;
+
+    PendingCommit pending {record, length, &transaction, nullptr, false, false};
+    {
+        LockGuard lock(mutex_);
+        if (queueTail_ != nullptr) {
+            queueTail_->next = &pending;
+        } else {
+            queueHead_ = &pending;
+        }
+        queueTail_ = &pending;
+
+        // Whoever finds no flush running writes everything queued so far,
+        // its own record included; the rest wait for that flush or lead
+        // the next one
+        while (!pending.done) {
+            if (flushing_) {
+                pthread_cond_wait(&flushed_, mutex_.native());
+            } else {
+                flushQueued();
+            }
+        }
+    }
+    taggedFree(record);
+    return pending.written;
+}
+
+void SecureStore::flushQueued() {
+    flushing_ = true;
+    PendingCommit* batch = queueHead_;
+    queueHead_ = queueTail_ = nullptr;
+
+    size_t total = 0;
+    uint32_t count = 0;
+    for (PendingCommit* p = batch; p != nullptr; p = p->next) {
+        total += p->length;
+        count++;
+    }
+    // A lone record is written where it is; a group is gathered first
+    uint8_t* gathered = nullptr;
+    if (count > 1) {
+        gathered = static_cast<uint8_t*>(taggedMalloc(MemoryTag::STORE, total));
+        if (gathered != nullptr) {
+            size_t offset = 0;
+            for (PendingCommit* p = batch; p != nullptr; p = p->next) {
+                memcpy(gathered + offset, p->record, p->length);
+                offset += p->length;
+            }
+        }
+    }
+    const uint8_t* data = count > 1 ? gathered : batch->record;
+    const int fd = fd_;
+    const uint64_t offset = end_;
+
+    // Readers only need the map, which nothing changes until the flush is
+    // applied: let them in during the I/O
+    mutex_.unlock();
+    const bool written = fd >= 0 && data != nullptr && writeFully(fd, data, total, offset) &&
+                         fdatasync(fd) == 0;
+    taggedFree(gathered);
+    mutex_.lock();
+
+    if (written) {
+        end_ += total;
+        flushes_++;
+    }
+    for (PendingCommit* p = batch; p != nullptr;) {
+        PendingCommit* next = p->next;
+        if (written) {
+            const StoreTransaction& transaction = *p->transaction;
+            applyOperations(transaction.data_, transaction.length_, transaction.operations_);
+            transactions_++;
+        }
+        p->written = written;
+        p->done = true;
+        p = next;
+    }
+
+    if (written && end_ >= COMPACTION_MIN_BYTES && end_ > liveBytes() * 2) compact();
+
+    flushing_ = false;
+    pthread_cond_broadcast(&flushed_);
+}
+
+/**
+ * Rewrites the live values as one record in a file that atomically
+ * replaces the log. Runs as part of a flush, so no other write competes.
+ */
+bool SecureStore::compact() {
+    uint8_t* payload = nullptr;
+    if (entryCount_ > 0) {
+        payload = static_cast<uint8_t*>(taggedMalloc(MemoryTag::STORE, liveValueBytes_));
+        if (payload == nullptr) return false;
+    }
+    size_t position = 0;
+    for (uint32_t i = 0; i < entryCount_; i++) {
+        const Entry& entry = entries_[i];
+        const OperationHeader header {OP_PUT, 0, static_cast<uint16_t>(entry.keyLength),
+                                      entry.valueLength};
+        memcpy(payload + position, &header, sizeof(header));
+        memcpy(payload + position + sizeof(header), entry.bytes,
+               entry.keyLength + entry.valueLength);
+        position += sizeof(header) + entry.keyLength + entry.valueLength;
+    }
+
+    size_t recordLength = 0;
+    uint8_t* record = nullptr;
+    if (payload != nullptr) {
+        record = seal(payload, position, entryCount_, &recordLength);
+        secureZero(payload, position);
+        taggedFree(payload);
+        if (record == nullptr) return false;
+    }
+
+    const size_t total = sizeof(FileHeader) + recordLength;
+    auto* buffer = static_cast<uint8_t*>(taggedMalloc(MemoryTag::STORE, total));
+    if (buffer == nullptr) {
+        taggedFree(record);
+        return false;
+    }
+    const FileHeader header {STORE_MAGIC, STORE_VERSION, 0};
+    memcpy(buffer, &header, sizeof(header));
+    if (record != nullptr) memcpy(buffer + sizeof(header), record, recordLength);
+    taggedFree(record);
+    const bool written = writeFileAtomically(path_, buffer, total);
+    taggedFree(buffer);
+    if (!written) return false;
+
+    // The old descriptor now points at the unlinked log
+    const int fd = ::open(path_, O_RDWR | O_CLOEXEC);
+    ::close(fd_);
+    fd_ = fd;
+    end_ = total;
+    return fd >= 0;
+}
+
+bool SecureStore::get(const char* key, size_t keyLength, uint8_t* out, size_t capacity,
+                      size_t* length) {
+    LockGuard lock(mutex_);
+    const int32_t index = find(hash64(key, keyLength), key, keyLength);
+    if (index < 0) return false;
+    const Entry& entry = entries_[index];
+    *length = entry.valueLength;
+    if (out != nullptr && entry.valueLength <= capacity) {
+        memcpy(out, entry.bytes + entry.keyLength, entry.valueLength);
+    }
+    return true;
+}
+
+StoreStats SecureStore::stats() {
+    LockGuard lock(mutex_);
+    return {entryCount_, transactions_, flushes_, end_, liveBytes(), droppedBytes_};
+}
+
+} // namespace bakingapp::store
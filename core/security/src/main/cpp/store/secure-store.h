@@ -0,0 +1,171 @@
+/**
+ * Encrypted, transactional key-value store for credentials
+ *
+ * An append-only log of commit records. A transaction (begin(), any number
+ * of put() and remove(), then SecureStore::commit()) becomes one record:
+ * its operations are serialized and sealed with ChaCha20-Poly1305 in a
+ * single pass under a fresh random nonce, so after a crash it is found
+ * whole or not at all. Sealing runs on the committing thread, outside the
+ * store's lock.
+ *
+ * Commits are grouped: the thread that finds no flush in progress writes
+ * every record queued so far with one pwrite() and one fdatasync(), while
+ * threads arriving meanwhile queue theirs for the next flush. N threads
+ * committing at once cost two flushes at most rather than N. commit()
+ * returns once its record is on storage.
+ *
+ * open() replays the log into an in-memory map. A record torn by a crash
+ * fails its CRC, and one sealed under another key (or altered) fails its
+ * tag; either ends the log, and what follows is truncated. Once dead
+ * records outweigh the live values, the log is rewritten as one record.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+
+#include "common/mutex.h"
+#include "crypto/chacha20-poly1305.h"
+
+namespace bakingapp::store {
+
+constexpr size_t STORE_KEY_BYTES = crypto::CHACHA20_KEY_BYTES;
+constexpr size_t MAX_STORE_KEY_LENGTH = 255;
+constexpr size_t MAX_STORE_VALUE_LENGTH = 64 * 1024;
+constexpr size_t MAX_TRANSACTION_BYTES = 1024 * 1024;
+
+/**
+ * Operations buffered for one commit. Rejected operations (a key or value
+ * too long, or out of memory) fail the whole transaction at commit().
+ * The buffer is wiped when the transaction is begun again or destroyed.
+ */
+class StoreTransaction {
+public:
+    StoreTransaction() = default;
+    ~StoreTransaction();
+
+    StoreTransaction(const StoreTransaction&) = delete;
+    StoreTransaction& operator=(const StoreTransaction&) = delete;
+
+    /**
+     * Discards any operations; a new transaction is already begun
+     */
+    void begin();
+
+    bool put(const char* key, size_t keyLength, const void* value, size_t valueLength);
+    bool remove(const char* key, size_t keyLength);
+
+    uint32_t operations() const { return operations_; }
+    bool failed() const { return failed_; }
+
+private:
+    friend class SecureStore;
+
+    bool append(uint8_t op, const char* key, size_t keyLength, const void* value,
+                size_t valueLength);
+
+    uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+    size_t capacity_ = 0;
+    uint32_t operations_ = 0;
+    bool failed_ = false;
+};
+
+struct StoreStats {
+    uint32_t keys;
+    uint64_t transactions;     // committed since open
+    uint64_t flushes;          // pwrite() + fdatasync() pairs they took
+    uint64_t usedBytes;        // log size
+    uint64_t liveBytes;        // what a compacted log would use
+    uint64_t droppedBytes;     // torn, corrupt or undecryptable tail discarded by open
+};
+
+class SecureStore {
+public:
+    SecureStore();
+    ~SecureStore();
+
+    SecureStore(const SecureStore&) = delete;
+    SecureStore& operator=(const SecureStore&) = delete;
+
+    /**
+     * Opens or creates the log and replays it with key (copied; wiped on
+     * close). Records sealed under another key are discarded.
+     */
+    bool open(const char* path, const uint8_t key[STORE_KEY_BYTES]);
+    void close();
+    bool isOpen();
+
+    /**
+     * Seals transaction, then waits until a flush has written it
+     *
+     * @return false (nothing applied) if the transaction failed, or its
+     *   record could not be sealed or written. An empty one succeeds
+     *   without writing.
+     */
+    bool commit(const StoreTransaction& transaction);
+
+    /**
+     * Copies key's value into out when it fits in capacity
+     *
+     * @return false if the key is absent; otherwise *length is the value's
+     *   length, which may exceed capacity
+     */
+    bool get(const char* key, size_t keyLength, uint8_t* out, size_t capacity, size_t* length);
+
+    StoreStats stats();
+
+private:
+    struct Entry {
+        uint64_t hash;
+        uint8_t* bytes;         // key, then value
+        uint32_t keyLength;
+        uint32_t valueLength;
+    };
+
+    struct PendingCommit {
+        const uint8_t* record;
+        size_t length;
+        const StoreTransaction* transaction;
+        PendingCommit* next;
+        bool done;
+        bool written;
+    };
+
+    bool replay();
+    void flushQueued();
+    bool applyOperations(const uint8_t* payload, size_t length, uint32_t operations);
+    bool set(const char* key, size_t keyLength, const uint8_t* value, size_t valueLength);
+    void erase(const char* key, size_t keyLength);
+    int32_t find(uint64_t hash, const char* key, size_t keyLength) const;
+    uint8_t* seal(const uint8_t* payload, size_t payloadLength, uint32_t operations,
+                  size_t* recordLength);
+    bool compact();
+    void clearEntries();
+    uint64_t liveBytes() const;
+
+    Mutex mutex_;
+    pthread_cond_t flushed_ {};
+    bool flushing_ = false;
+    PendingCommit* queueHead_ = nullptr;
+    PendingCommit* queueTail_ = nullptr;
+
+    int fd_ = -1;
+    char path_[512] = {};
+    uint8_t key_[STORE_KEY_BYTES] = {};
+
+    uint64_t end_ = 0;
+    uint64_t transactions_ = 0;
+    uint64_t flushes_ = 0;
+    uint64_t droppedBytes_ = 0;
+    uint64_t liveValueBytes_ = 0;    // operation headers, keys and values
+
+    // A store holds a handful of credentials: lookups scan
+    Entry* entries_ = nullptr;
+    uint32_t entryCount_ = 0;
+    uint32_t entryCapacity_ = 0;
+};
+
+} // namespace bakingapp::store
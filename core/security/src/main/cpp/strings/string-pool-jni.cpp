@@ -0,0 +1,236 @@
+/**
+ * JNI bridge for NativeStringPool
+ *
+ * Moshi hands over the raw bytes of a JSON string token; it is decoded and
+ * interned natively, and each distinct value is turned into a Java String
+ * once and kept as a global reference next to its pool ID. Every later
+ * occurrence returns that same instance, so the JVM holds one String per
+ * distinct value instead of one per occurrence.
+ *
+ * Global references are a bounded resource and the values are server
+ * text, so the pool stops at MAX_SHARED_STRINGS: past it, only values
+ * already held are shared and the rest decode as usual. Once the app is
+ * in the background the shared Strings are dropped and the pool refills
+ * on the next payload.
+ */
+
+#include <jni.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/mutex.h"
+#include "common/native-memory.h"
+#include "strings/string-pool.h"
+#include "sync/json-records.h"
+
+using bakingapp::LockGuard;
+using bakingapp::MemoryTag;
+using bakingapp::Mutex;
+using bakingapp::TRIM_MEMORY_BACKGROUND;
+using bakingapp::strings::StringPool;
+using bakingapp::strings::StringPoolStats;
+using bakingapp::taggedRealloc;
+
+namespace {
+    // Decoding never lengthens a token beyond its bytes between the quotes
+    constexpr size_t MAX_TOKEN_BYTES = StringPool::MAX_LENGTH + 2;
+    // Far above the categories, difficulties and units of a real catalog,
+    // far below the VM's global reference table
+    constexpr uint32_t MAX_SHARED_STRINGS = 4096;
+
+    struct JniPool {
+        Mutex mutex;
+        StringPool pool;
+        JavaVM* vm = nullptr;
+        jobject* strings = nullptr;     // global refs, by ID - 1
+        uint32_t capacity = 0;
+        uint64_t lookups = 0;
+    };
+
+    JniPool* fromHandle(jlong handle) {
+        return reinterpret_cast<JniPool*>(handle);
+    }
+
+    void releaseStrings(JNIEnv* env, JniPool* pool) {
+        for (uint32_t i = 0; i < pool->pool.size() && i < pool->capacity; i++) {
+            if (pool->strings[i] != nullptr) env->DeleteGlobalRef(pool->strings[i]);
+            pool->strings[i] = nullptr;
+        }
+    }
+
+    /**
+     * Runs on the thread calling onTrimMemory(), which the VM knows
+     */
+    void trimPool(void* context, int level) {
+        auto* pool = static_cast<JniPool*>(context);
+        if (level < TRIM_MEMORY_BACKGROUND) return;
+        JNIEnv* env = nullptr;
+        if (pool->vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) return;
+        LockGuard lock(pool->mutex);
+        releaseStrings(env, pool);
+        pool->pool.clear();
+    }
+
+    /**
+     * NewStringUTF takes modified UTF-8, which differs from the real thing
+     * for NUL and supplementary characters; anything but plain ASCII goes
+     * through UTF-16 instead
+     */
+    jstring newString(JNIEnv* env, const char* text, size_t length) {
+        bool ascii = true;
+        for (size_t i = 0; i < length && ascii; i++) {
+            const auto c = static_cast<uint8_t>(text[i]);
+            ascii = c != 0 && c < 0x80;
+        }
+        if (ascii) return env->NewStringUTF(text);
+
+        jchar units[StringPool::MAX_LENGTH];    // never more units than bytes
+        size_t count = 0;
+        const auto* p = reinterpret_cast<const uint8_t*>(text);
+        const uint8_t* const end = p + length;
+        while (p < end) {
+            uint32_t codePoint = 0xFFFD;
+            size_t size = 1;
+            if (p[0] < 0x80) {
+                codePoint = p[0];
+            } else if ((p[0] & 0xE0) == 0xC0 && end - p >= 2) {
+                codePoint = (p[0] & 0x1Fu) << 6 | (p[1] & 0x3Fu);
+                size = 2;
+            } else if ((p[0] & 0xF0) == 0xE0 && end - p >= 3) {
+                codePoint = (p[0] & 0x0Fu) << 12 | (p[1] & 0x3Fu) << 6 | (p[2] & 0x3Fu);
+                size = 3;
+            } else if ((p[0] & 0xF8) == 0xF0 && end - p >= 4) {
+                codePoint = (p[0] & 0x07u) << 18 | (p[1] & 0x3Fu) << 12 | (p[2] & 0x3Fu) << 6 |
+                            (p[3] & 0x3Fu);
+                size = 4;
+            }
+            p += size;
+            if (codePoint >= 0x10000) {
+                codePoint -= 0x10000;
+                units[count++] = static_cast<jchar>(0xD800 + (codePoint >> 10));
+                units[count++] = static_cast<jchar>(0xDC00 + (codePoint & 0x3FF));
+            } else {
+                units[count++] = static_cast<jchar>(codePoint);
+            }
+        }
+        return env->NewString(units, static_cast<jsize>(count));
+    }
+}
+
+extern "C" {
+
+/**
+ * The pool lives as long as the process, and so does its trim handler
+ */
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_strings_NativeStringPool_nativeCreate(
+        JNIEnv* env,
+        jobject /* thiz */
+) {
+    auto* pool = bakingapp::createTagged<JniPool>(MemoryTag::STRINGS);
+    if (pool == nullptr) return 0;
+    if (env->GetJavaVM(&pool->vm) != JNI_OK) {
+        bakingapp::destroyTagged(pool);
+        return 0;
+    }
+    bakingapp::addTrimHandler(trimPool, pool);
+    return reinterpret_cast<jlong>(pool);
+}
+
+/**
+ * Interns the JSON string token in token[0, length), quotes included
+ *
+ * @return the shared String, or null if the token is malformed or too long,
+ *   or a new value once the pool is full (decode it the usual way then)
+ */
+JNIEXPORT jstring JNICALL
+Java_com_eslam_bakingapp_core_security_strings_NativeStringPool_nativeInternJson(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jbyteArray token,
+        jint length
+) {
+    JniPool* pool = fromHandle(handle);
+    if (pool == nullptr || token == nullptr || length < 2 ||
+        static_cast<size_t>(length) > MAX_TOKEN_BYTES || length > env->GetArrayLength(token)) {
+        return nullptr;
+    }
+    uint8_t raw[MAX_TOKEN_BYTES];
+    env->GetByteArrayRegion(token, 0, length, reinterpret_cast<jbyte*>(raw));
+    char text[StringPool::MAX_LENGTH + 1];
+    const size_t textLength = bakingapp::sync::decodeJsonString(
+        raw, static_cast<size_t>(length), text, StringPool::MAX_LENGTH);
+    if (textLength == SIZE_MAX) return nullptr;
+    text[textLength] = '\0';
+
+    LockGuard lock(pool->mutex);
+    pool->lookups++;
+    const uint32_t id = pool->pool.size() < MAX_SHARED_STRINGS
+                        ? pool->pool.intern(text, textLength)
+                        : pool->pool.find(text, textLength);
+    if (id == StringPool::NONE) return nullptr;
+    if (id > pool->capacity) {
+        const uint32_t capacity = pool->capacity == 0 ? 64 : pool->capacity * 2;
+        auto* strings = static_cast<jobject*>(
+            taggedRealloc(MemoryTag::STRINGS, pool->strings, sizeof(jobject) * capacity));
+        if (strings == nullptr) return nullptr;
+        memset(strings + pool->capacity, 0, sizeof(jobject) * (capacity - pool->capacity));
+        pool->strings = strings;
+        pool->capacity = capacity;
+    }
+    jobject& shared = pool->strings[id - 1];
+    if (shared == nullptr) {
+        jstring local = newString(env, text, textLength);
+        if (local == nullptr) return nullptr;
+        shared = env->NewGlobalRef(local);
+        if (shared == nullptr) return local;
+        env->DeleteLocalRef(local);
+    }
+    return static_cast<jstring>(env->NewLocalRef(shared));
+}
+
+/**
+ * Drops every shared String; values already handed out stay valid
+ */
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_strings_NativeStringPool_nativeClear(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniPool* pool = fromHandle(handle);
+    if (pool == nullptr) return;
+    LockGuard lock(pool->mutex);
+    releaseStrings(env, pool);
+    pool->pool.clear();
+}
+
+/**
+ * @return [strings, lookups, textBytes, nativeBytes]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_strings_NativeStringPool_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    JniPool* pool = fromHandle(handle);
+    if (pool == nullptr) return nullptr;
+    jlong values[4];
+    {
+        LockGuard lock(pool->mutex);
+        const StringPoolStats stats = pool->pool.stats();
+        values[0] = static_cast<jlong>(stats.strings);
+        values[1] = static_cast<jlong>(pool->lookups);
+        values[2] = static_cast<jlong>(stats.textBytes);
+        values[3] = static_cast<jlong>(stats.arenaBytes + stats.indexBytes +
+                                       sizeof(jobject) * pool->capacity);
+    }
+    jlongArray result = env->NewLongArray(4);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 4, values);
+    return result;
+}
+
+} // extern "C"
@@ -0,0 +1,147 @@
+#include "strings/string-pool.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/hash.h"
+#include "common/native-memory.h"
+
+namespace bakingapp::strings {
+
+namespace {
+    inline uint32_t hashText(const char* text, size_t length) {
+        // Never 0, so a zeroed bucket cannot match by hash alone
+        return static_cast<uint32_t>(hash64(text, length)) | 1u;
+    }
+}
+
+StringPool::~StringPool() {
+    clear();
+    taggedFree(buckets_);
+    taggedFree(slots_);
+}
+
+uint32_t StringPool::probe(const char* text, size_t length, uint32_t hash,
+                           uint32_t* bucket) const {
+    for (uint32_t i = hash & bucketMask_;; i = (i + 1) & bucketMask_) {
+        const Bucket& candidate = buckets_[i];
+        if (candidate.id == NONE) {
+            *bucket = i;
+            return NONE;
+        }
+        if (candidate.hash == hash) {
+            const Slot& slot = slots_[candidate.id - 1];
+            if (slot.length == length && memcmp(slot.text, text, length) == 0) {
+                *bucket = i;
+                return candidate.id;
+            }
+        }
+    }
+}
+
+uint32_t StringPool::find(const char* text, size_t length) const {
+    if (buckets_ == nullptr || length > MAX_LENGTH) return NONE;
+    uint32_t bucket;
+    return probe(text, length, hashText(text, length), &bucket);
+}
+
+uint32_t StringPool::intern(const char* text, size_t length) {
+    if (length > MAX_LENGTH) return NONE;
+    // Kept at most 3/4 full so probes stay short and always end
+    if (buckets_ == nullptr || (count_ + 1) * 4 > (bucketMask_ + 1) * 3) {
+        if (!grow()) return NONE;
+    }
+
+    const uint32_t hash = hashText(text, length);
+    uint32_t bucket;
+    const uint32_t existing = probe(text, length, hash, &bucket);
+    if (existing != NONE) return existing;
+
+    char* copy = allocate(length + 1);
+    if (copy == nullptr) return NONE;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+
+    const uint32_t id = ++count_;
+    slots_[id - 1] = {copy, static_cast<uint32_t>(length)};
+    buckets_[bucket] = {hash, id};
+    textBytes_ += length;
+    return id;
+}
+
+const char* StringPool::text(uint32_t id, size_t* length) const {
+    if (id == NONE || id > count_) return nullptr;
+    const Slot& slot = slots_[id - 1];
+    if (length != nullptr) *length = slot.length;
+    return slot.text;
+}
+
+StringPoolStats StringPool::stats() const {
+    return {count_, textBytes_, arenaBytes_,
+            static_cast<uint64_t>(buckets_ != nullptr ? bucketMask_ + 1 : 0) * sizeof(Bucket) +
+                static_cast<uint64_t>(slotCapacity_) * sizeof(Slot)};
+}
+
+void StringPool::clear() {
+    while (chunks_ != nullptr) {
+        Chunk* next = chunks_->next;
+        taggedFree(chunks_);
+        chunks_ = next;
+    }
+    if (buckets_ != nullptr) memset(buckets_, 0, sizeof(Bucket) * (bucketMask_ + 1));
+    count_ = 0;
+    textBytes_ = 0;
+    arenaBytes_ = 0;
+}
+
+bool StringPool::grow() {
+    const uint32_t bucketCount = buckets_ == nullptr ? INITIAL_BUCKETS : (bucketMask_ + 1) * 2;
+    auto* buckets = static_cast<Bucket*>(
+        taggedCalloc(MemoryTag::STRINGS, bucketCount, sizeof(Bucket)));
+    // One slot per string the new table can hold at 3/4 load
+    const uint32_t slotCapacity = bucketCount / 4 * 3;
+    auto* slots = static_cast<Slot*>(
+        taggedRealloc(MemoryTag::STRINGS, slots_, sizeof(Slot) * slotCapacity));
+    if (buckets == nullptr || slots == nullptr) {
+        taggedFree(buckets);
+        if (slots != nullptr) slots_ = slots;
+        return false;
+    }
+    slots_ = slots;
+    slotCapacity_ = slotCapacity;
+
+    // Rehash from the stored hashes; the text is not touched
+    const uint32_t mask = bucketCount - 1;
+    if (buckets_ != nullptr) {
+        for (uint32_t i = 0; i <= bucketMask_; i++) {
+            const Bucket& old = buckets_[i];
+            if (old.id == NONE) continue;
+            uint32_t j = old.hash & mask;
+            while (buckets[j].id != NONE) j = (j + 1) & mask;
+            buckets[j] = old;
+        }
+        taggedFree(buckets_);
+    }
+    buckets_ = buckets;
+    bucketMask_ = mask;
+    return true;
+}
+
+char* StringPool::allocate(size_t bytes) {
+    if (chunks_ == nullptr || chunks_->capacity - chunks_->used < bytes) {
+        static_assert(MAX_LENGTH + 1 <= (CHUNK_BYTES - sizeof(Chunk)) / 2,
+                      "a string must fit a chunk with room to spare");
+        auto* chunk = static_cast<Chunk*>(taggedMalloc(MemoryTag::STRINGS, CHUNK_BYTES));
+        if (chunk == nullptr) return nullptr;
+        chunk->next = chunks_;
+        chunk->used = 0;
+        chunk->capacity = CHUNK_BYTES - sizeof(Chunk);
+        chunks_ = chunk;
+        arenaBytes_ += CHUNK_BYTES;
+    }
+    char* out = reinterpret_cast<char*>(chunks_ + 1) + chunks_->used;
+    chunks_->used += bytes;
+    return out;
+}
+
+} // namespace bakingapp::strings
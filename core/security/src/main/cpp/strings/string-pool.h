@@ -0,0 +1,98 @@
+/**
+ * Interning pool for short strings that repeat across a payload
+ *
+ * Each distinct string gets a small dense ID (1, 2, ...) for the life of
+ * the pool. The text is copied once into a bump-allocated arena of 64 KB
+ * chunks and never moves, so text() pointers stay valid until clear().
+ * Lookups go through an open-addressing table of (hash, id) pairs that
+ * only touches the arena on a hash match.
+ *
+ * Not synchronized: callers that share a pool serialize on their own lock.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::strings {
+
+struct StringPoolStats {
+    uint32_t strings;
+    uint64_t textBytes;     // distinct text, without terminators
+    uint64_t arenaBytes;    // chunks allocated for it
+    uint64_t indexBytes;    // hash table plus the id -> text slots
+};
+
+class StringPool {
+public:
+    static constexpr uint32_t NONE = 0;
+    // Longer strings are rarely repeated; they are not worth a slot
+    static constexpr size_t MAX_LENGTH = 1024;
+
+    StringPool() = default;
+    ~StringPool();
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /**
+     * @return the ID of text, adding it if new; NONE if it is longer than
+     *   MAX_LENGTH or memory ran out
+     */
+    uint32_t intern(const char* text, size_t length);
+
+    /**
+     * @return the ID of text, or NONE if it was never interned
+     */
+    uint32_t find(const char* text, size_t length) const;
+
+    /**
+     * @return the NUL-terminated text of id, or nullptr for an unknown ID
+     */
+    const char* text(uint32_t id, size_t* length) const;
+
+    uint32_t size() const { return count_; }
+
+    StringPoolStats stats() const;
+
+    /**
+     * Forgets every string; IDs start over from 1
+     */
+    void clear();
+
+private:
+    static constexpr uint32_t INITIAL_BUCKETS = 256;
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    struct Bucket {
+        uint32_t hash;
+        uint32_t id;                    // NONE when empty
+    };
+
+    struct Slot {
+        const char* text;
+        uint32_t length;
+    };
+
+    struct Chunk {
+        Chunk* next;
+        size_t used;
+        size_t capacity;
+    };
+
+    uint32_t probe(const char* text, size_t length, uint32_t hash, uint32_t* bucket) const;
+    bool grow();
+    char* allocate(size_t bytes);
+
+    Bucket* buckets_ = nullptr;
+    uint32_t bucketMask_ = 0;
+    Slot* slots_ = nullptr;
+    uint32_t slotCapacity_ = 0;
+    uint32_t count_ = 0;
+    Chunk* chunks_ = nullptr;           // newest first
+    uint64_t textBytes_ = 0;
+    uint64_t arenaBytes_ = 0;
+};
+
+} // namespace bakingapp::strings
@@ -0,0 +1,156 @@
+/**
+ * JNI bridge for the content-hash delta table
+ *
+ * Bodies come in as direct ByteBuffers so the splitter and hash read the
+ * response bytes in place. The diff runs as a NativeJobs job on the native
+ * pool and completes with one byte array in the packed DeltaList format
+ * (u8 kind, u8 idLength, id bytes).
+ */
+
+#include <jni.h>
+
+#include "common/native-memory.h"
+#include "jobs/jni-jobs.h"
+#include "sync/delta-table.h"
+
+using bakingapp::Job;
+using bakingapp::JobStatus;
+using bakingapp::MemoryTag;
+using bakingapp::jobs::JniJob;
+using bakingapp::sync::DeltaList;
+using bakingapp::sync::DeltaTable;
+
+namespace {
+    constexpr const char* ARRAY_KEY = "recipes";
+
+    DeltaTable* fromHandle(jlong handle) {
+        return reinterpret_cast<DeltaTable*>(handle);
+    }
+
+    struct DiffJob : bakingapp::jobs::JniJob {
+        DeltaTable* table = nullptr;
+        jobject body = nullptr;     // global ref keeping the direct buffer alive
+        const uint8_t* data = nullptr;
+        size_t length = 0;
+        DeltaList list;
+    };
+
+    JobStatus runDiff(Job* job) {
+        auto* diff = static_cast<DiffJob*>(job);
+        if (diff->table->diff(diff->data, diff->length, ARRAY_KEY, &diff->list,
+                              &diff->cancelled)) {
+            return JobStatus::DONE;
+        }
+        return diff->isCancelled() ? JobStatus::CANCELLED : JobStatus::FAILED;
+    }
+
+    jobject diffResult(JNIEnv* env, JniJob* job) {
+        const DeltaList& list = static_cast<DiffJob*>(job)->list;
+        jbyteArray result = env->NewByteArray(static_cast<jsize>(list.length));
+        if (result != nullptr && list.length > 0) {
+            env->SetByteArrayRegion(result, 0, static_cast<jsize>(list.length),
+                                    reinterpret_cast<const jbyte*>(list.data));
+        }
+        return result;
+    }
+
+    void releaseDiff(JNIEnv* env, JniJob* job) {
+        auto* diff = static_cast<DiffJob*>(job);
+        env->DeleteGlobalRef(diff->body);
+        bakingapp::destroyTagged(diff);
+    }
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_sync_NativeRecipeDeltaSync_nativeOpen(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring file
+) {
+    if (file == nullptr) return 0;
+
+    const char* path = env->GetStringUTFChars(file, nullptr);
+    if (path == nullptr) return 0;
+    auto* table = bakingapp::createTagged<DeltaTable>(MemoryTag::PARSERS);
+    bool opened = table != nullptr && table->open(path);
+    env->ReleaseStringUTFChars(file, path);
+
+    if (!opened) {
+        bakingapp::destroyTagged(table);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(table);
+}
+
+/**
+ * Starts diffing the first length bytes of a RecipeListResponse body on the
+ * native pool; the job completes with the packed delta, or with null if
+ * the body could not be diffed
+ *
+ * @return false if the job could not be started
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_sync_NativeRecipeDeltaSync_nativeSubmitDiff(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jobject body,
+        jint length,
+        jlong jobId
+) {
+    DeltaTable* table = fromHandle(handle);
+    if (table == nullptr || body == nullptr || length < 0) return JNI_FALSE;
+
+    const void* address = env->GetDirectBufferAddress(body);
+    const jlong capacity = env->GetDirectBufferCapacity(body);
+    if (address == nullptr || capacity < length) return JNI_FALSE;
+
+    auto* job = bakingapp::createTagged<DiffJob>(MemoryTag::PARSERS);
+    if (job == nullptr) return JNI_FALSE;
+    job->body = env->NewGlobalRef(body);
+    if (job->body == nullptr) {
+        bakingapp::destroyTagged(job);
+        return JNI_FALSE;
+    }
+    job->work = runDiff;
+    job->result = diffResult;
+    job->release = releaseDiff;
+    job->table = table;
+    job->data = static_cast<const uint8_t*>(address);
+    job->length = static_cast<size_t>(length);
+    return bakingapp::jobs::submit(env, job, jobId) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_sync_NativeRecipeDeltaSync_nativeCommit(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    DeltaTable* table = fromHandle(handle);
+    return table != nullptr && table->commit() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_sync_NativeRecipeDeltaSync_nativeAbort(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    DeltaTable* table = fromHandle(handle);
+    if (table != nullptr) table->abort();
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_sync_NativeRecipeDeltaSync_nativeReset(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    DeltaTable* table = fromHandle(handle);
+    if (table != nullptr) table->reset();
+}
+
+} // extern "C"
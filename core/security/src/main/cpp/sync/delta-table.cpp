@@ -0,0 +1,211 @@
+#include "sync/delta-table.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "common/hash.h"
+#include "common/native-memory.h"
+#include "sync/json-records.h"
+
+namespace bakingapp::sync {
+
+namespace {
+    constexpr uint32_t INITIAL_CAPACITY = 256;
+    constexpr size_t INITIAL_LIST_BYTES = 1024;
+    constexpr uint32_t CANCEL_CHECK_INTERVAL = 256;
+
+    // 0 marks an empty slot / an uncommitted id
+    inline uint64_t nonZero(uint64_t hash) {
+        return hash == 0 ? 1 : hash;
+    }
+}
+
+DeltaList::~DeltaList() {
+    taggedFree(data);
+}
+
+bool DeltaList::append(DeltaKind kind, const char* id, size_t idLength) {
+    const size_t needed = length + 2 + idLength;
+    if (needed > capacity) {
+        size_t grown = capacity > 0 ? capacity * 2 : INITIAL_LIST_BYTES;
+        while (grown < needed) grown *= 2;
+        auto* buffer = static_cast<uint8_t*>(taggedRealloc(MemoryTag::PARSERS, data, grown));
+        if (buffer == nullptr) return false;
+        data = buffer;
+        capacity = grown;
+    }
+    data[length] = static_cast<uint8_t>(kind);
+    data[length + 1] = static_cast<uint8_t>(idLength);
+    memcpy(data + length + 2, id, idLength);
+    length = needed;
+
+    switch (kind) {
+        case DeltaKind::INSERTED: inserted++; break;
+        case DeltaKind::CHANGED: changed++; break;
+        case DeltaKind::DELETED: deleted++; break;
+    }
+    return true;
+}
+
+void DeltaList::clear() {
+    length = 0;
+    inserted = changed = deleted = unchanged = 0;
+}
+
+DeltaTable::~DeltaTable() {
+    close();
+}
+
+bool DeltaTable::open(const char* path) {
+    LockGuard lock(mutex_);
+    index_.close();
+    pending_ = false;
+
+    const size_t length = strlen(path);
+    if (length >= sizeof(path_)) return false;
+    memcpy(path_, path, length + 1);
+    return index_.openExisting(path_, INITIAL_CAPACITY);
+}
+
+void DeltaTable::close() {
+    LockGuard lock(mutex_);
+    index_.close();
+    pending_ = false;
+}
+
+bool DeltaTable::isOpen() {
+    LockGuard lock(mutex_);
+    return index_.isOpen();
+}
+
+bool DeltaTable::diff(const uint8_t* json, size_t length, const char* arrayKey, DeltaList* out,
+                      const std::atomic<bool>* cancelled) {
+    LockGuard lock(mutex_);
+    out->clear();
+    pending_ = false;
+    if (!index_.isOpen()) return false;
+
+    // Slots seen by an abandoned pass keep that pass's number, which no
+    // later pass reuses
+    uint32_t pass = index_.extra().pass + 1;
+    if (pass == 0) pass = 1;
+    index_.extra().pass = pass;
+
+    JsonRecordScanner scanner;
+    if (!scanner.open(json, length, arrayKey)) return false;
+    JsonRecord record;
+    uint32_t records = 0;
+    while (scanner.next(&record)) {
+        if (++records % CANCEL_CHECK_INTERVAL == 0 && cancelled != nullptr &&
+            cancelled->load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (record.idLength == 0) continue;
+        const uint64_t hash = nonZero(hash64(json + record.offset, record.length));
+        if (!observe(reinterpret_cast<const char*>(json + record.idOffset), record.idLength,
+                     hash, out)) {
+            return false;
+        }
+    }
+    if (scanner.failed()) return false;
+
+    bool listed = true;
+    index_.forEach([&](const Slot& slot) {
+        if (slot.content != 0 && slot.seen != pass) {
+            listed = listed && out->append(DeltaKind::DELETED, slot.id, slot.idLength);
+        }
+    });
+    pending_ = listed;
+    return listed;
+}
+
+bool DeltaTable::observe(const char* id, size_t idLength, uint64_t hash, DeltaList* out) {
+    if (idLength > MAX_DELTA_ID_LENGTH) return false;
+
+    const uint64_t key = nonZero(hash64(id, idLength));
+    Slot* slot = index_.find(key);
+    if (slot == nullptr) {
+        // Keep probe chains short: at most 3/4 full
+        if ((index_.count() + 1) * 4 > index_.capacity() * 3 && !grow()) return false;
+        slot = index_.insert(key);
+        if (slot == nullptr) return false;
+        slot->idLength = static_cast<uint8_t>(idLength);
+        memcpy(slot->id, id, idLength);
+    } else if (slot->idLength != idLength || memcmp(slot->id, id, idLength) != 0) {
+        return false;   // 64-bit id hash collision
+    }
+
+    slot->pending = hash;
+    slot->seen = index_.extra().pass;
+    if (slot->content == 0) return out->append(DeltaKind::INSERTED, id, idLength);
+    if (slot->content != hash) return out->append(DeltaKind::CHANGED, id, idLength);
+    out->unchanged++;
+    return true;
+}
+
+/**
+ * Copies the table into one of twice the capacity next to it, then renames
+ * it over the original, so a crash mid-way leaves one complete table
+ */
+bool DeltaTable::grow() {
+    char tmpPath[sizeof(path_) + 8];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.grow", path_);
+    unlink(tmpPath);
+
+    Index grown;
+    if (!grown.open(tmpPath, index_.capacity() * 2) || grown.capacity() <= index_.capacity()) {
+        grown.close();
+        unlink(tmpPath);
+        return false;
+    }
+    index_.forEach([&](const Slot& slot) { *grown.insert(slot.key) = slot; });
+    grown.extra() = index_.extra();
+    const bool synced = grown.sync();
+    grown.close();
+
+    if (!synced || rename(tmpPath, path_) != 0) {
+        unlink(tmpPath);
+        return false;
+    }
+    index_.close();
+    return index_.openExisting(path_, INITIAL_CAPACITY);
+}
+
+bool DeltaTable::commit() {
+    LockGuard lock(mutex_);
+    if (!pending_) return false;
+    pending_ = false;
+
+    const uint32_t pass = index_.extra().pass;
+    index_.eraseIf([pass](Slot& slot) {
+        if (slot.seen != pass) return true;
+        slot.content = slot.pending;
+        return false;
+    });
+    return index_.sync();
+}
+
+void DeltaTable::abort() {
+    LockGuard lock(mutex_);
+    pending_ = false;
+}
+
+void DeltaTable::reset() {
+    LockGuard lock(mutex_);
+    pending_ = false;
+    if (index_.isOpen()) index_.clear();
+}
+
+DeltaTableStats DeltaTable::stats() {
+    LockGuard lock(mutex_);
+    DeltaTableStats result {};
+    if (!index_.isOpen()) return result;
+    result.records = index_.count();
+    result.capacity = index_.capacity();
+    result.slotBytes = static_cast<uint64_t>(index_.capacity()) * sizeof(Slot);
+    return result;
+}
+
+} // namespace bakingapp::sync
@@ -0,0 +1,138 @@
+/**
+ * Content-hash delta table for list syncs
+ *
+ * Remembers, per record id, a hash of the record's raw JSON as of the last
+ * sync that reached the database. diff() splits a new response body into
+ * records (sync/json-records.h), hashes each byte range and reports only
+ * the ids that were inserted, changed or deleted since then, so the caller
+ * can write just those rows.
+ *
+ * The id -> hash map is a MappedHashTable in its own file. A diff is
+ * tentative until commit(), which the caller issues once the rows are in
+ * the database; a crash or abort() in between leaves the table as of the
+ * previous commit, so the next diff reports the same changes again.
+ * Hashes are XXH64 (common/hash.h): the split, not the hash, bounds the
+ * pass.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "common/mapped-hash-table.h"
+#include "common/mutex.h"
+
+namespace bakingapp::sync {
+
+// A UUID with room to spare; longer ids make diff() fail
+constexpr size_t MAX_DELTA_ID_LENGTH = 43;
+
+enum class DeltaKind : uint8_t {
+    INSERTED = 1,
+    CHANGED = 2,
+    DELETED = 3,
+};
+
+/**
+ * diff() output. Entries are packed as u8 kind, u8 idLength, id bytes.
+ */
+struct DeltaList {
+    uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t capacity = 0;
+    uint32_t inserted = 0;
+    uint32_t changed = 0;
+    uint32_t deleted = 0;
+    uint32_t unchanged = 0;
+
+    DeltaList() = default;
+    ~DeltaList();
+
+    DeltaList(const DeltaList&) = delete;
+    DeltaList& operator=(const DeltaList&) = delete;
+
+    bool append(DeltaKind kind, const char* id, size_t idLength);
+    void clear();
+};
+
+struct DeltaTableStats {
+    uint32_t records;       // ids as of the last commit (plus any pending inserts)
+    uint32_t capacity;
+    uint64_t slotBytes;     // size of the mapped slots
+};
+
+class DeltaTable {
+public:
+    DeltaTable() = default;
+    ~DeltaTable();
+
+    DeltaTable(const DeltaTable&) = delete;
+    DeltaTable& operator=(const DeltaTable&) = delete;
+
+    bool open(const char* path);
+    void close();
+    bool isOpen();
+
+    /**
+     * Diffs the elements of the array under arrayKey against the last
+     * commit. Elements without an "id" are ignored. Starts a new pending
+     * pass, discarding any uncommitted one.
+     *
+     * @param cancelled polled every few hundred records; once set, the
+     *   pass is abandoned as if it had failed
+     * @return false if the body cannot be split or an id is too long; the
+     *   caller should then write everything
+     */
+    bool diff(const uint8_t* json, size_t length, const char* arrayKey, DeltaList* out,
+              const std::atomic<bool>* cancelled = nullptr);
+
+    /**
+     * Makes the last diff the new baseline: changed hashes are stored and
+     * ids it did not see are dropped
+     *
+     * @return false if there is no pending diff
+     */
+    bool commit();
+
+    /**
+     * Discards the pending diff
+     */
+    void abort();
+
+    /**
+     * Forgets every id, e.g. when the database was cleared; the next diff
+     * reports everything as inserted
+     */
+    void reset();
+
+    DeltaTableStats stats();
+
+private:
+    struct Slot {
+        uint64_t key;                       // hash64 of the id
+        uint64_t content;                   // committed hash, 0 if never committed
+        uint64_t pending;                   // hash seen by pass `seen`
+        uint32_t seen;
+        uint8_t idLength;
+        char id[MAX_DELTA_ID_LENGTH];
+    };
+
+    struct Counters {
+        uint32_t pass;
+        uint32_t reserved;
+    };
+
+    using Index = MappedHashTable<Slot, 0x424B4454 /* "BKDT" */, 1, Counters>;
+
+    bool observe(const char* id, size_t idLength, uint64_t hash, DeltaList* out);
+    bool grow();
+
+    Mutex mutex_;
+    Index index_;
+    char path_[512] = {};
+    bool pending_ = false;
+};
+
+} // namespace bakingapp::sync
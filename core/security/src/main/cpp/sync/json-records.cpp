@@ -0,0 +1,344 @@
+#include "sync/json-records.h"
+
+#include <cstring>
+
+namespace bakingapp::sync {
+
+namespace {
+    constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    inline bool isWhitespace(uint8_t c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    inline bool endsScalar(uint8_t c) {
+        return c == ',' || c == '}' || c == ']' || isWhitespace(c);
+    }
+
+    // Bytes skipContainer() has to look at
+    struct StructuralBytes {
+        bool table[256] = {};
+
+        constexpr StructuralBytes() {
+            table[static_cast<uint8_t>('"')] = true;
+            table[static_cast<uint8_t>('{')] = true;
+            table[static_cast<uint8_t>('}')] = true;
+            table[static_cast<uint8_t>('[')] = true;
+            table[static_cast<uint8_t>(']')] = true;
+        }
+    };
+    constexpr StructuralBytes STRUCTURAL;
+
+    inline int hexValue(uint8_t c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    /**
+     * Reads the four hex digits of a \u escape at p
+     *
+     * @return the code unit, or -1
+     */
+    inline int32_t readCodeUnit(const uint8_t* p) {
+        int32_t unit = 0;
+        for (int i = 0; i < 4; i++) {
+            const int digit = hexValue(p[i]);
+            if (digit < 0) return -1;
+            unit = unit << 4 | digit;
+        }
+        return unit;
+    }
+
+    inline size_t encodeUtf8(uint32_t codePoint, char* out) {
+        if (codePoint < 0x80) {
+            out[0] = static_cast<char>(codePoint);
+            return 1;
+        }
+        if (codePoint < 0x800) {
+            out[0] = static_cast<char>(0xC0 | codePoint >> 6);
+            out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 2;
+        }
+        if (codePoint < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | codePoint >> 12);
+            out[1] = static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+            out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<char>(0xF0 | codePoint >> 18);
+        out[1] = static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+        out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 4;
+    }
+}
+
+bool JsonRecordScanner::open(const uint8_t* json, size_t length, const char* arrayKey) {
+    json_ = json;
+    length_ = length;
+    first_ = true;
+    done_ = true;
+    failed_ = false;
+
+    const size_t keyLength = strlen(arrayKey);
+    size_t p = skipWhitespace(0);
+    if (p >= length_ || json_[p] != '{') return fail();
+    p = skipWhitespace(p + 1);
+    if (p < length_ && json_[p] == '}') return false;
+
+    for (;;) {
+        if (p >= length_ || json_[p] != '"') return fail();
+        const size_t keyStart = p + 1;
+        const size_t keyEnd = skipString(p);
+        if (keyEnd == NPOS) return fail();
+        p = skipWhitespace(keyEnd);
+        if (p >= length_ || json_[p] != ':') return fail();
+        p = skipWhitespace(p + 1);
+        if (p >= length_) return fail();
+
+        if (keyEnd - 1 - keyStart == keyLength &&
+            memcmp(json_ + keyStart, arrayKey, keyLength) == 0 && json_[p] == '[') {
+            pos_ = p + 1;
+            done_ = false;
+            return true;
+        }
+
+        p = skipWhitespace(skipValue(p));
+        if (p >= length_) return fail();
+        if (json_[p] == '}') return false;
+        if (json_[p] != ',') return fail();
+        p = skipWhitespace(p + 1);
+    }
+}
+
+bool JsonRecordScanner::captureFields(const char* const* keys, size_t count) {
+    if (count > MAX_RECORD_FIELDS) return false;
+    fieldKeys_ = keys;
+    fieldCount_ = count;
+    for (size_t f = 0; f < count; f++) fieldLengths_[f] = strlen(keys[f]);
+    return true;
+}
+
+bool JsonRecordScanner::next(JsonRecord* record) {
+    if (done_) return false;
+
+    size_t p = skipWhitespace(pos_);
+    if (p >= length_) return fail();
+    if (json_[p] == ']') {
+        done_ = true;
+        return false;
+    }
+    if (!first_) {
+        if (json_[p] != ',') return fail();
+        p = skipWhitespace(p + 1);
+        if (p >= length_) return fail();
+    }
+    first_ = false;
+
+    record->offset = p;
+    record->idOffset = 0;
+    record->idLength = 0;
+    for (size_t f = 0; f < fieldCount_; f++) {
+        record->fieldOffsets[f] = 0;
+        record->fieldLengths[f] = 0;
+    }
+
+    if (json_[p] != '{') {
+        const size_t end = skipValue(p);
+        if (end == NPOS) return fail();
+        record->length = end - p;
+        pos_ = end;
+        return true;
+    }
+
+    p = skipWhitespace(p + 1);
+    if (p < length_ && json_[p] == '}') {
+        record->length = p + 1 - record->offset;
+        pos_ = p + 1;
+        return true;
+    }
+
+    for (;;) {
+        if (p >= length_ || json_[p] != '"') return fail();
+        const size_t keyStart = p + 1;
+        const size_t keyEnd = skipString(p);
+        if (keyEnd == NPOS) return fail();
+        p = skipWhitespace(keyEnd);
+        if (p >= length_ || json_[p] != ':') return fail();
+        p = skipWhitespace(p + 1);
+
+        const size_t valueEnd = skipValue(p);
+        if (valueEnd == NPOS) return fail();
+        if (keyEnd - 1 - keyStart == 2 && json_[keyStart] == 'i' && json_[keyStart + 1] == 'd') {
+            const bool quoted = json_[p] == '"';
+            record->idOffset = quoted ? p + 1 : p;
+            record->idLength = quoted ? valueEnd - p - 2 : valueEnd - p;
+        }
+        for (size_t f = 0; f < fieldCount_; f++) {
+            if (keyEnd - 1 - keyStart == fieldLengths_[f] &&
+                memcmp(json_ + keyStart, fieldKeys_[f], fieldLengths_[f]) == 0) {
+                record->fieldOffsets[f] = p;
+                record->fieldLengths[f] = valueEnd - p;
+            }
+        }
+
+        p = skipWhitespace(valueEnd);
+        if (p >= length_) return fail();
+        if (json_[p] == '}') break;
+        if (json_[p] != ',') return fail();
+        p = skipWhitespace(p + 1);
+    }
+
+    record->length = p + 1 - record->offset;
+    pos_ = p + 1;
+    return true;
+}
+
+size_t JsonRecordScanner::skipWhitespace(size_t pos) const {
+    while (pos < length_ && isWhitespace(json_[pos])) pos++;
+    return pos;
+}
+
+/**
+ * pos is at the opening quote; returns the position after the closing one
+ */
+size_t JsonRecordScanner::skipString(size_t pos) const {
+    size_t from = pos + 1;
+    while (from < length_) {
+        const auto* quote = static_cast<const uint8_t*>(memchr(json_ + from, '"', length_ - from));
+        if (quote == nullptr) return NPOS;
+
+        // Escaped if preceded by an odd run of backslashes
+        const uint8_t* back = quote;
+        while (back > json_ + pos + 1 && back[-1] == '\\') back--;
+        const size_t at = static_cast<size_t>(quote - json_);
+        if (((quote - back) & 1) == 0) return at + 1;
+        from = at + 1;
+    }
+    return NPOS;
+}
+
+size_t JsonRecordScanner::skipValue(size_t pos) const {
+    if (pos >= length_) return NPOS;
+    switch (json_[pos]) {
+        case '"':
+            return skipString(pos);
+        case '{':
+        case '[':
+            return skipContainer(pos);
+        default: {
+            size_t end = pos;
+            while (end < length_ && !endsScalar(json_[end])) end++;
+            return end > pos ? end : NPOS;
+        }
+    }
+}
+
+/**
+ * Bracket depth only; whether each container is well-formed inside is
+ * left to whoever decodes the record
+ */
+size_t JsonRecordScanner::skipContainer(size_t pos) const {
+    size_t depth = 0;
+    size_t p = pos;
+    while (p < length_) {
+        const uint8_t c = json_[p];
+        if (!STRUCTURAL.table[c]) {
+            p++;
+            continue;
+        }
+        if (c == '"') {
+            p = skipString(p);
+            if (p == NPOS) return NPOS;
+            continue;
+        }
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) return p + 1;
+        }
+        p++;
+    }
+    return NPOS;
+}
+
+bool JsonRecordScanner::fail() {
+    done_ = true;
+    failed_ = true;
+    return false;
+}
+
+// ==================== String decoding ====================
+
+size_t decodeJsonString(const uint8_t* token, size_t length, char* out, size_t capacity) {
+    if (length < 2 || token[0] != '"' || token[length - 1] != '"') return NPOS;
+    const uint8_t* p = token + 1;
+    const uint8_t* const end = token + length - 1;
+
+    const size_t raw = static_cast<size_t>(end - p);
+    if (memchr(p, '\\', raw) == nullptr) {
+        if (raw > capacity) return NPOS;
+        for (size_t i = 0; i < raw; i++) {
+            if (p[i] < 0x20) return NPOS;
+        }
+        memcpy(out, p, raw);
+        return raw;
+    }
+
+    size_t n = 0;
+    while (p < end) {
+        const uint8_t c = *p;
+        if (c < 0x20) return NPOS;
+        if (c != '\\') {
+            if (n == capacity) return NPOS;
+            out[n++] = static_cast<char>(c);
+            p++;
+            continue;
+        }
+        if (end - p < 2) return NPOS;
+        const uint8_t escaped = p[1];
+        p += 2;
+        char simple = 0;
+        switch (escaped) {
+            case '"': simple = '"'; break;
+            case '\\': simple = '\\'; break;
+            case '/': simple = '/'; break;
+            case 'b': simple = '\b'; break;
+            case 'f': simple = '\f'; break;
+            case 'n': simple = '\n'; break;
+            case 'r': simple = '\r'; break;
+            case 't': simple = '\t'; break;
+            case 'u': break;
+            default: return NPOS;
+        }
+        if (simple != 0) {
+            if (n == capacity) return NPOS;
+            out[n++] = simple;
+            continue;
+        }
+
+        if (end - p < 4) return NPOS;
+        int32_t unit = readCodeUnit(p);
+        p += 4;
+        if (unit < 0 || (unit >= 0xDC00 && unit <= 0xDFFF)) return NPOS;
+        uint32_t codePoint = static_cast<uint32_t>(unit);
+        if (unit >= 0xD800 && unit <= 0xDBFF) {
+            if (end - p < 6 || p[0] != '\\' || p[1] != 'u') return NPOS;
+            const int32_t low = readCodeUnit(p + 2);
+            if (low < 0xDC00 || low > 0xDFFF) return NPOS;
+            p += 6;
+            codePoint = 0x10000 + ((static_cast<uint32_t>(unit) - 0xD800) << 10) +
+                        (static_cast<uint32_t>(low) - 0xDC00);
+        }
+        char encoded[4];
+        const size_t encodedLength = encodeUtf8(codePoint, encoded);
+        if (capacity - n < encodedLength) return NPOS;
+        memcpy(out + n, encoded, encodedLength);
+        n += encodedLength;
+    }
+    return n;
+}
+
+} // namespace bakingapp::sync
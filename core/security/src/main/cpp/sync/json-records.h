@@ -0,0 +1,95 @@
+/**
+ * Record splitter for JSON list responses
+ *
+ * Finds the array under a top-level key of a response body (the "recipes"
+ * of a RecipeListResponse) and yields the exact byte range of each element
+ * together with the raw value of its top-level "id". Nothing is decoded or
+ * copied: the scan only tracks nesting and skips strings with memchr, so
+ * the ranges can be hashed straight from the network buffer.
+ *
+ * Top-level fields other than "id" can be captured the same way
+ * (captureFields()), e.g. the timestamps sync/timestamps.h parses.
+ *
+ * The input is assumed to be JSON the server produced; malformed input
+ * stops the scan and sets failed(), it never reads out of bounds.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::sync {
+
+// Fields captureFields() takes besides "id"
+constexpr size_t MAX_RECORD_FIELDS = 4;
+
+struct JsonRecord {
+    size_t offset;      // the element's first byte
+    size_t length;      // up to and including its last byte
+    size_t idOffset;    // "id" value, without the quotes if it is a string
+    size_t idLength;    // 0 if the element has no "id"
+
+    // The raw value tokens of the captured fields, quotes included;
+    // length 0 if the element has no such field
+    size_t fieldOffsets[MAX_RECORD_FIELDS];
+    size_t fieldLengths[MAX_RECORD_FIELDS];
+};
+
+class JsonRecordScanner {
+public:
+    /**
+     * Positions the scanner before the first element of the array under
+     * arrayKey in the top-level object
+     *
+     * @return false if there is no such array
+     */
+    bool open(const uint8_t* json, size_t length, const char* arrayKey);
+
+    /**
+     * Makes next() report the values of these top-level fields of each
+     * element, in this order. The keys must outlive the scan.
+     *
+     * @return false if there are more than MAX_RECORD_FIELDS
+     */
+    bool captureFields(const char* const* keys, size_t count);
+
+    /**
+     * @return false after the last element or on malformed input
+     */
+    bool next(JsonRecord* record);
+
+    bool failed() const { return failed_; }
+
+private:
+    size_t skipWhitespace(size_t pos) const;
+    size_t skipString(size_t pos) const;
+    size_t skipValue(size_t pos) const;
+    size_t skipContainer(size_t pos) const;
+    bool fail();
+
+    const char* const* fieldKeys_ = nullptr;
+    size_t fieldLengths_[MAX_RECORD_FIELDS] = {};
+    size_t fieldCount_ = 0;
+
+    const uint8_t* json_ = nullptr;
+    size_t length_ = 0;
+    size_t pos_ = 0;
+    bool first_ = true;
+    bool done_ = true;
+    bool failed_ = false;
+};
+
+/**
+ * Decodes a JSON string token, quotes included, into UTF-8
+ *
+ * Unescaped tokens (almost all of them) are a single copy. \uXXXX escapes
+ * are re-encoded, surrogate pairs combined.
+ *
+ * @return the decoded length, or SIZE_MAX if the token is malformed (bad
+ *   escape, lone surrogate, raw control character) or needs more than
+ *   capacity bytes
+ */
+size_t decodeJsonString(const uint8_t* token, size_t length, char* out, size_t capacity);
+
+} // namespace bakingapp::sync
@@ -0,0 +1,151 @@
+/**
+ * JNI bridge for NativeTimestampParser
+ *
+ * Stateless: each call parses a whole batch and returns one long[] of
+ * epoch milliseconds, Long.MIN_VALUE where a timestamp is missing or
+ * malformed. Batches come in either as one String of '\n'-separated
+ * timestamps or as a raw RecipeListResponse body, read in place.
+ */
+
+#include <jni.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+#include "sync/json-records.h"
+#include "sync/timestamps.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::sync::MAX_RECORD_FIELDS;
+using bakingapp::sync::parseRecordTimestamps;
+using bakingapp::sync::parseTimestampLines;
+using bakingapp::taggedFree;
+using bakingapp::taggedMalloc;
+
+namespace {
+    // Longest array or field key
+    constexpr size_t MAX_KEY_LENGTH = 63;
+
+    jlongArray toLongArray(JNIEnv* env, const int64_t* values, size_t count) {
+        jlongArray result = env->NewLongArray(static_cast<jsize>(count));
+        if (result != nullptr && count > 0) {
+            env->SetLongArrayRegion(result, 0, static_cast<jsize>(count),
+                                    reinterpret_cast<const jlong*>(values));
+        }
+        return result;
+    }
+
+    /**
+     * Up to MAX_RECORD_FIELDS '\n'-separated keys, copied and NUL-terminated
+     */
+    struct FieldKeys {
+        char chars[MAX_RECORD_FIELDS][MAX_KEY_LENGTH + 1];
+        const char* keys[MAX_RECORD_FIELDS];
+        size_t count = 0;
+
+        bool parse(const char* text, size_t length) {
+            size_t pos = 0;
+            while (pos <= length) {
+                const auto* newline = static_cast<const char*>(memchr(text + pos, '\n', length - pos));
+                const size_t end = newline != nullptr ? static_cast<size_t>(newline - text) : length;
+                if (count == MAX_RECORD_FIELDS || end == pos || end - pos > MAX_KEY_LENGTH) {
+                    return false;
+                }
+                memcpy(chars[count], text + pos, end - pos);
+                chars[count][end - pos] = '\0';
+                keys[count] = chars[count];
+                count++;
+                pos = end + 1;
+            }
+            return true;
+        }
+    };
+}
+
+extern "C" {
+
+/**
+ * Parses count '\n'-separated timestamps
+ *
+ * @return count epoch milliseconds, or null if text does not hold count lines
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_sync_NativeTimestampParser_nativeParseLines(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring text,
+        jint count
+) {
+    if (text == nullptr || count <= 0) return nullptr;
+    const char* chars = env->GetStringUTFChars(text, nullptr);
+    if (chars == nullptr) return nullptr;
+    const auto length = static_cast<size_t>(env->GetStringUTFLength(text));
+    auto* values = static_cast<int64_t*>(
+        taggedMalloc(MemoryTag::PARSERS, sizeof(int64_t) * static_cast<size_t>(count)));
+
+    jlongArray result = nullptr;
+    if (values != nullptr &&
+        parseTimestampLines(chars, length, values, static_cast<size_t>(count)) ==
+            static_cast<size_t>(count)) {
+        result = toLongArray(env, values, static_cast<size_t>(count));
+    }
+    env->ReleaseStringUTFChars(text, chars);
+    taggedFree(values);
+    return result;
+}
+
+/**
+ * Parses the '\n'-separated fields of each element of the array under
+ * arrayKey in a JSON body
+ *
+ * @return one value per field per element, element by element, or null if
+ *   the body has no such array or is malformed
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_sync_NativeTimestampParser_nativeParseRecords(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jbyteArray body,
+        jstring arrayKey,
+        jstring fields
+) {
+    if (body == nullptr || arrayKey == nullptr || fields == nullptr) return nullptr;
+    char array[MAX_KEY_LENGTH + 1];
+    const jsize arrayLength = env->GetStringUTFLength(arrayKey);
+    if (arrayLength <= 0 || static_cast<size_t>(arrayLength) > MAX_KEY_LENGTH) return nullptr;
+    env->GetStringUTFRegion(arrayKey, 0, env->GetStringLength(arrayKey), array);
+
+    FieldKeys keys;
+    const char* fieldChars = env->GetStringUTFChars(fields, nullptr);
+    if (fieldChars == nullptr) return nullptr;
+    const bool parsed =
+        keys.parse(fieldChars, static_cast<size_t>(env->GetStringUTFLength(fields)));
+    env->ReleaseStringUTFChars(fields, fieldChars);
+    if (!parsed) return nullptr;
+
+    jbyte* bytes = env->GetByteArrayElements(body, nullptr);
+    if (bytes == nullptr) return nullptr;
+    const auto* json = reinterpret_cast<const uint8_t*>(bytes);
+    const auto length = static_cast<size_t>(env->GetArrayLength(body));
+
+    // Counted first (the scan alone is memchr-fast), then parsed
+    jlongArray result = nullptr;
+    const size_t records =
+        parseRecordTimestamps(json, length, array, keys.keys, keys.count, nullptr, 0);
+    if (records != static_cast<size_t>(-1)) {
+        const size_t count = records * keys.count;
+        auto* values = static_cast<int64_t*>(
+            taggedMalloc(MemoryTag::PARSERS, sizeof(int64_t) * (count > 0 ? count : 1)));
+        if (values != nullptr &&
+            parseRecordTimestamps(json, length, array, keys.keys, keys.count, values, count) ==
+                records) {
+            result = toLongArray(env, values, count);
+        }
+        taggedFree(values);
+    }
+    env->ReleaseByteArrayElements(body, bytes, JNI_ABORT);
+    return result;
+}
+
+} // extern "C"
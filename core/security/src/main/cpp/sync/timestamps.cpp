@@ -0,0 +1,244 @@
+#include "sync/timestamps.h"
+
+#include <cstring>
+
+#include "sync/json-records.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bakingapp::sync {
+
+namespace {
+    constexpr size_t PREFIX_BYTES = 16;         // "YYYY-MM-DDThh:mm"
+    constexpr size_t DATE_BYTES = 10;           // "YYYY-MM-DD"
+    constexpr size_t SECONDS_BYTES = 19;        // "YYYY-MM-DDThh:mm:ss"
+    constexpr size_t MAX_TOKEN_BYTES = 64;      // escaped tokens are decoded into this
+    constexpr int MAX_FRACTION_DIGITS = 9;
+
+    // Per prefix byte: a digit (0xFF), a separator (its value), or the
+    // date/time separator checked on its own (WILDCARD)
+    alignas(16) constexpr uint8_t DIGITS[PREFIX_BYTES] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0, 0xFF, 0xFF, 0, 0xFF, 0xFF, 0, 0xFF, 0xFF, 0, 0xFF, 0xFF,
+    };
+    alignas(16) constexpr uint8_t SEPARATORS[PREFIX_BYTES] = {
+        0, 0, 0, 0, '-', 0, 0, '-', 0, 0, 0, 0, 0, ':', 0, 0,
+    };
+    alignas(16) constexpr uint8_t WILDCARD[PREFIX_BYTES] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0, 0, 0, 0, 0,
+    };
+
+    inline bool isDigit(char c) {
+        return static_cast<uint8_t>(c - '0') <= 9;
+    }
+
+    /**
+     * Checks the 16-byte prefix and writes each byte minus '0' to digits
+     */
+    inline bool checkPrefix(const char* text, uint8_t digits[PREFIX_BYTES]) {
+#if defined(__ARM_NEON)
+        const uint8x16_t x = vld1q_u8(reinterpret_cast<const uint8_t*>(text));
+        const uint8x16_t values = vsubq_u8(x, vdupq_n_u8('0'));
+        const uint8x16_t isDigit = vcleq_u8(values, vdupq_n_u8(9));
+        const uint8x16_t isSeparator = vceqq_u8(x, vld1q_u8(SEPARATORS));
+        const uint8x16_t ok = vorrq_u8(vbslq_u8(vld1q_u8(DIGITS), isDigit, isSeparator),
+                                       vld1q_u8(WILDCARD));
+        vst1q_u8(digits, values);
+        // All ones in every byte; vminvq_u8 is AArch64-only
+        const uint8x8_t folded = vand_u8(vget_low_u8(ok), vget_high_u8(ok));
+        return vget_lane_u64(vreinterpret_u64_u8(folded), 0) == UINT64_MAX;
+#elif defined(__SSE2__)
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+        const __m128i values = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+        // Unsigned value <= 9: saturating 9 off leaves zero
+        const __m128i isDigit = _mm_cmpeq_epi8(_mm_subs_epu8(values, _mm_set1_epi8(9)),
+                                               _mm_setzero_si128());
+        const __m128i isSeparator =
+            _mm_cmpeq_epi8(x, _mm_load_si128(reinterpret_cast<const __m128i*>(SEPARATORS)));
+        const __m128i digitMask = _mm_load_si128(reinterpret_cast<const __m128i*>(DIGITS));
+        const __m128i ok = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(digitMask, isDigit),
+                         _mm_andnot_si128(digitMask, isSeparator)),
+            _mm_load_si128(reinterpret_cast<const __m128i*>(WILDCARD)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(digits), values);
+        return _mm_movemask_epi8(ok) == 0xFFFF;
+#else
+        bool ok = true;
+        for (size_t i = 0; i < PREFIX_BYTES; i++) {
+            digits[i] = static_cast<uint8_t>(text[i] - '0');
+            if (WILDCARD[i] != 0) continue;
+            ok &= DIGITS[i] != 0 ? digits[i] <= 9 : static_cast<uint8_t>(text[i]) == SEPARATORS[i];
+        }
+        return ok;
+#endif
+    }
+
+    inline bool checkDate(const char* text, uint8_t digits[PREFIX_BYTES]) {
+        for (size_t i = 0; i < DATE_BYTES; i++) {
+            digits[i] = static_cast<uint8_t>(text[i] - '0');
+            if (DIGITS[i] != 0 ? digits[i] > 9 : static_cast<uint8_t>(text[i]) != SEPARATORS[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline uint32_t twoDigits(const uint8_t* digits) {
+        return digits[0] * 10u + digits[1];
+    }
+
+    inline bool isLeapYear(int64_t year) {
+        return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    }
+
+    inline uint32_t daysInMonth(int64_t year, uint32_t month) {
+        static constexpr uint8_t DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && isLeapYear(year) ? 29 : DAYS[month - 1];
+    }
+
+    /**
+     * Days since 1970-01-01 of a proleptic Gregorian date (Howard
+     * Hinnant's days_from_civil)
+     */
+    int64_t daysFromCivil(int64_t year, uint32_t month, uint32_t day) {
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const int64_t yearOfEra = year - era * 400;
+        const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    /**
+     * Reads the fraction and offset from pos to the end
+     */
+    bool parseTail(const char* text, size_t pos, size_t length, int64_t* fractionMillis,
+                   int64_t* offsetSeconds) {
+        *fractionMillis = 0;
+        *offsetSeconds = 0;
+        if (pos < length && (text[pos] == '.' || text[pos] == ',')) {
+            pos++;
+            int count = 0;
+            int64_t millis = 0;
+            while (pos < length && isDigit(text[pos])) {
+                if (++count > MAX_FRACTION_DIGITS) return false;
+                if (count <= 3) millis = millis * 10 + (text[pos] - '0');
+                pos++;
+            }
+            if (count == 0) return false;
+            for (; count < 3; count++) millis *= 10;
+            *fractionMillis = millis;
+        }
+        if (pos == length) return true;
+
+        const char sign = text[pos];
+        if (sign == 'Z' || sign == 'z') return pos + 1 == length;
+        if (sign != '+' && sign != '-') return false;
+        pos++;
+        if (length - pos < 2 || !isDigit(text[pos]) || !isDigit(text[pos + 1])) return false;
+        const uint32_t hours = (text[pos] - '0') * 10u + (text[pos + 1] - '0');
+        pos += 2;
+        uint32_t minutes = 0;
+        if (pos < length) {
+            if (text[pos] == ':') pos++;
+            if (length - pos != 2 || !isDigit(text[pos]) || !isDigit(text[pos + 1])) {
+                return false;
+            }
+            minutes = (text[pos] - '0') * 10u + (text[pos + 1] - '0');
+        }
+        if (hours > 23 || minutes > 59) return false;
+        const int64_t offset = hours * 3600 + minutes * 60;
+        *offsetSeconds = sign == '-' ? -offset : offset;
+        return true;
+    }
+}
+
+bool parseTimestamp(const char* text, size_t length, int64_t* millis) {
+    uint8_t digits[PREFIX_BYTES];
+    uint32_t hour = 0;
+    uint32_t minute = 0;
+    uint32_t second = 0;
+    int64_t fraction = 0;
+    int64_t offset = 0;
+    if (length == DATE_BYTES) {
+        if (!checkDate(text, digits)) return false;
+    } else {
+        if (length < SECONDS_BYTES || !checkPrefix(text, digits)) return false;
+        const char separator = text[DATE_BYTES];
+        if (separator != 'T' && separator != 't' && separator != ' ') return false;
+        if (text[16] != ':' || !isDigit(text[17]) || !isDigit(text[18])) return false;
+        hour = twoDigits(digits + 11);
+        minute = twoDigits(digits + 14);
+        second = (text[17] - '0') * 10u + (text[18] - '0');
+        if (hour > 23 || minute > 59 || second > 59) return false;
+        if (!parseTail(text, SECONDS_BYTES, length, &fraction, &offset)) return false;
+    }
+
+    const int64_t year = twoDigits(digits) * 100 + twoDigits(digits + 2);
+    const uint32_t month = twoDigits(digits + 5);
+    const uint32_t day = twoDigits(digits + 8);
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) return false;
+
+    const int64_t seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 +
+                            minute * 60 + second - offset;
+    *millis = seconds * 1000 + fraction;
+    return true;
+}
+
+size_t parseTimestampLines(const char* text, size_t length, int64_t* out, size_t capacity) {
+    size_t count = 0;
+    size_t pos = 0;
+    for (;;) {
+        const auto* newline = static_cast<const char*>(memchr(text + pos, '\n', length - pos));
+        const size_t end = newline != nullptr ? static_cast<size_t>(newline - text) : length;
+        if (count < capacity) {
+            int64_t millis = NO_TIMESTAMP;
+            out[count] = parseTimestamp(text + pos, end - pos, &millis) ? millis : NO_TIMESTAMP;
+        }
+        count++;
+        if (newline == nullptr) return count;
+        pos = end + 1;
+    }
+}
+
+bool parseTimestampToken(const uint8_t* token, size_t length, int64_t* millis) {
+    if (length < 2 || token[0] != '"' || token[length - 1] != '"') return false;
+    if (memchr(token + 1, '\\', length - 2) == nullptr) {
+        return parseTimestamp(reinterpret_cast<const char*>(token) + 1, length - 2, millis);
+    }
+    // Escapes inside a timestamp are rare enough to decode first
+    char decoded[MAX_TOKEN_BYTES];
+    const size_t decodedLength = decodeJsonString(token, length, decoded, sizeof(decoded));
+    return decodedLength != static_cast<size_t>(-1) &&
+           parseTimestamp(decoded, decodedLength, millis);
+}
+
+size_t parseRecordTimestamps(const uint8_t* json, size_t length, const char* arrayKey,
+                             const char* const* fields, size_t fieldCount, int64_t* out,
+                             size_t capacity) {
+    constexpr size_t FAILED = static_cast<size_t>(-1);
+    JsonRecordScanner scanner;
+    if (fieldCount == 0 || !scanner.captureFields(fields, fieldCount)) return FAILED;
+    if (!scanner.open(json, length, arrayKey)) return FAILED;
+
+    size_t records = 0;
+    JsonRecord record;
+    while (scanner.next(&record)) {
+        if ((records + 1) * fieldCount <= capacity) {
+            int64_t* row = out + records * fieldCount;
+            for (size_t f = 0; f < fieldCount; f++) {
+                int64_t millis = NO_TIMESTAMP;
+                row[f] = parseTimestampToken(json + record.fieldOffsets[f],
+                                             record.fieldLengths[f], &millis)
+                    ? millis : NO_TIMESTAMP;
+            }
+        }
+        records++;
+    }
+    return scanner.failed() ? FAILED : records;
+}
+
+} // namespace bakingapp::sync
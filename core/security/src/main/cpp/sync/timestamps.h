@@ -0,0 +1,57 @@
+/**
+ * ISO-8601 timestamps to epoch milliseconds, in batches
+ *
+ * Accepts the RFC 3339 profile servers send: a calendar date, 'T' (or 't'
+ * or a space), hh:mm:ss, an optional fraction after '.' or ',' of up to
+ * nine digits (cut to milliseconds, as Instant.toEpochMilli() does) and an
+ * optional offset: 'Z', +hh:mm, +hhmm or +hh, or the same with '-'. A
+ * missing offset means UTC, and a bare date is its midnight UTC.
+ *
+ * The fixed "YYYY-MM-DDThh:mm" prefix, 16 bytes, is checked in one
+ * NEON or SSE2 compare: every digit position must hold a digit and every
+ * separator its separator. Only the fields and the variable tail are then
+ * read one byte at a time.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::sync {
+
+// Written for a missing or malformed timestamp (Long.MIN_VALUE in Kotlin)
+constexpr int64_t NO_TIMESTAMP = INT64_MIN;
+
+/**
+ * @return false, millis untouched, if text is not a valid timestamp
+ */
+bool parseTimestamp(const char* text, size_t length, int64_t* millis);
+
+/**
+ * Parses '\n'-separated timestamps; an empty line is NO_TIMESTAMP
+ *
+ * @return the number of lines, of which the first capacity are written
+ */
+size_t parseTimestampLines(const char* text, size_t length, int64_t* out, size_t capacity);
+
+/**
+ * Parses a JSON string token, quotes included; null or any other value is
+ * not a timestamp
+ */
+bool parseTimestampToken(const uint8_t* token, size_t length, int64_t* millis);
+
+/**
+ * For each element of the array under arrayKey in a JSON body, parses its
+ * top-level fields as timestamps, straight from the body's bytes: out gets
+ * fieldCount values per element, in element order
+ *
+ * @param fieldCount at most MAX_RECORD_FIELDS (sync/json-records.h)
+ * @return the number of elements, of which the first capacity / fieldCount
+ *   are written; SIZE_MAX if the body could not be scanned
+ */
+size_t parseRecordTimestamps(const uint8_t* json, size_t length, const char* arrayKey,
+                             const char* const* fields, size_t fieldCount, int64_t* out,
+                             size_t capacity);
+
+} // namespace bakingapp::sync
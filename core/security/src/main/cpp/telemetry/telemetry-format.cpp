@@ -0,0 +1,114 @@
+#include "telemetry/telemetry-format.h"
+
+#include <cstring>
+
+namespace bakingapp::telemetry {
+
+namespace {
+    size_t writeVarint(uint64_t value, uint8_t* out) {
+        size_t length = 0;
+        while (value >= 0x80) {
+            out[length++] = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        out[length++] = static_cast<uint8_t>(value);
+        return length;
+    }
+}
+
+const char* eventName(uint32_t type) {
+    switch (static_cast<EventType>(type)) {
+        case EventType::LIBRARY_LOAD: return "library-load";
+        case EventType::KEY_FETCH: return "key-fetch";
+        case EventType::AUTH_HEADER: return "auth-header";
+        case EventType::TIMER_TICK: return "timer-tick";
+    }
+    return nullptr;
+}
+
+size_t encodeBatch(uint32_t ring, uint64_t dropped, int64_t originNanos,
+                   const TelemetryEvent* events, size_t count, uint8_t* out) {
+    size_t length = 0;
+    length += writeVarint(ring, out + length);
+    length += writeVarint(count, out + length);
+    length += writeVarint(dropped, out + length);
+    const int64_t first = count > 0 ? events[0].timestampNanos : originNanos;
+    length += writeVarint(static_cast<uint64_t>(first > originNanos ? first - originNanos : 0),
+                          out + length);
+
+    int64_t previous = first;
+    for (size_t i = 0; i < count; i++) {
+        const TelemetryEvent& event = events[i];
+        const int64_t delta = event.timestampNanos - previous;
+        length += writeVarint(static_cast<uint64_t>(delta > 0 ? delta : 0), out + length);
+        length += writeVarint(event.type, out + length);
+        length += writeVarint(event.value, out + length);
+        length += writeVarint(event.extra, out + length);
+        if (delta > 0) previous = event.timestampNanos;
+    }
+    return length;
+}
+
+// ==================== TelemetryReader ====================
+
+bool TelemetryReader::open(const uint8_t* data, size_t size) {
+    if (data == nullptr || size < sizeof(FileHeader)) return false;
+    memcpy(&header_, data, sizeof(FileHeader));
+    if (header_.magic != TELEMETRY_MAGIC || header_.version != TELEMETRY_VERSION) return false;
+    data_ = data;
+    size_ = size;
+    position_ = sizeof(FileHeader);
+    return true;
+}
+
+bool TelemetryReader::readVarint(uint64_t* value) {
+    uint64_t result = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (position_ >= size_) return false;
+        const uint8_t byte = data_[position_++];
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TelemetryReader::next(BatchInfo* info, TelemetryEvent* out, size_t capacity) {
+    const size_t start = position_;
+    uint64_t ring = 0;
+    uint64_t count = 0;
+    uint64_t dropped = 0;
+    uint64_t first = 0;
+    if (!readVarint(&ring) || !readVarint(&count) || !readVarint(&dropped) ||
+        !readVarint(&first)) {
+        // Back to the batch start, so atEnd() tells a cut-off batch apart
+        position_ = start;
+        return false;
+    }
+    info->ring = static_cast<uint32_t>(ring);
+    info->count = static_cast<uint32_t>(count);
+    info->dropped = dropped;
+
+    int64_t timestamp = header_.monotonicNanos + static_cast<int64_t>(first);
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t delta = 0;
+        uint64_t type = 0;
+        uint64_t value = 0;
+        uint64_t extra = 0;
+        if (!readVarint(&delta) || !readVarint(&type) || !readVarint(&value) ||
+            !readVarint(&extra)) {
+            position_ = start;
+            return false;
+        }
+        timestamp += static_cast<int64_t>(delta);
+        if (i < capacity) {
+            out[i] = TelemetryEvent {timestamp, static_cast<uint32_t>(type),
+                                     static_cast<uint32_t>(value), extra};
+        }
+    }
+    return true;
+}
+
+} // namespace bakingapp::telemetry
@@ -0,0 +1,111 @@
+/**
+ * On-disk format of the telemetry file
+ *
+ * A 24-byte header, then batches appended by the flusher, one per drained
+ * ring. Everything after the header is LEB128 varints:
+ *
+ *   batch  := ring count dropped firstNanos event*
+ *   event  := deltaNanos type value extra
+ *
+ * ring is the producer thread's ring id, dropped the events that ring lost
+ * to a full buffer since its previous batch, firstNanos the first event's
+ * timestamp relative to the header's monotonicNanos, and deltaNanos each
+ * event's distance to the one before it (0 for the first). Timestamps
+ * within a ring never go backwards, so a typical 24-byte event takes 5 to
+ * 8 bytes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bakingapp::telemetry {
+
+/**
+ * Event ids shared with TelemetryEvent (TelemetryRecorder.kt); keep both
+ * in sync. Ids are never reused, so old files stay readable.
+ */
+enum class EventType : uint32_t {
+    LIBRARY_LOAD = 1,       // value: 0
+    KEY_FETCH = 2,          // value: registry slot, or -1 for an unknown id
+    AUTH_HEADER = 3,        // value: 1 if a token was attached
+    TIMER_TICK = 4,         // value: events returned, extra: live timers
+};
+
+const char* eventName(uint32_t type);
+
+struct TelemetryEvent {
+    int64_t timestampNanos;     // CLOCK_MONOTONIC
+    uint32_t type;
+    uint32_t value;
+    uint64_t extra;
+};
+
+constexpr uint32_t TELEMETRY_MAGIC = 0x4C544B42;    // "BKTL"
+constexpr uint32_t TELEMETRY_VERSION = 1;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    int64_t monotonicNanos;     // origin of the batch timestamps
+    int64_t realtimeNanos;      // CLOCK_REALTIME at the same instant
+};
+
+/**
+ * Worst-case encoded size of a batch of count events
+ */
+constexpr size_t maxBatchBytes(size_t count) {
+    return 4 * 10 + count * (10 + 5 + 5 + 10);
+}
+
+/**
+ * Encodes one batch into out, which must hold maxBatchBytes(count)
+ *
+ * @return the bytes written
+ */
+size_t encodeBatch(uint32_t ring, uint64_t dropped, int64_t originNanos,
+                   const TelemetryEvent* events, size_t count, uint8_t* out);
+
+struct BatchInfo {
+    uint32_t ring;
+    uint32_t count;
+    uint64_t dropped;
+};
+
+/**
+ * Walks a telemetry file held in memory, batch by batch
+ */
+class TelemetryReader {
+public:
+    /**
+     * @return false if data does not start with a valid header
+     */
+    bool open(const uint8_t* data, size_t size);
+
+    const FileHeader& header() const { return header_; }
+
+    /**
+     * Decodes the next batch's events into out (capacity events at most;
+     * the rest of the batch is skipped). Timestamps come back absolute.
+     *
+     * @return false at the end of the data or on a truncated batch
+     */
+    bool next(BatchInfo* info, TelemetryEvent* out, size_t capacity);
+
+    /**
+     * After next() returned false: whether that was the end of the data
+     * rather than a batch cut short
+     */
+    bool atEnd() const { return position_ == size_; }
+
+private:
+    bool readVarint(uint64_t* value);
+
+    FileHeader header_ {};
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t position_ = 0;
+};
+
+} // namespace bakingapp::telemetry
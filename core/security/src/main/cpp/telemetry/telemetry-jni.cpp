@@ -0,0 +1,75 @@
+/**
+ * JNI bridge for NativeTelemetry
+ *
+ * All calls go to Telemetry::shared(), which the other bridges record into
+ * directly (key fetches, timer ticks); Kotlin only records the events that
+ * happen on its side, such as auth header injections.
+ */
+
+#include <jni.h>
+
+#include "telemetry/telemetry.h"
+
+using bakingapp::telemetry::EventType;
+using bakingapp::telemetry::Telemetry;
+using bakingapp::telemetry::TelemetryStats;
+
+extern "C" {
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_telemetry_NativeTelemetry_nativeStart(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring path,
+        jint flushIntervalMillis
+) {
+    if (path == nullptr) return JNI_FALSE;
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    if (pathChars == nullptr) return JNI_FALSE;
+    const bool started = Telemetry::shared().start(
+        pathChars, static_cast<uint32_t>(flushIntervalMillis > 0 ? flushIntervalMillis : 1));
+    env->ReleaseStringUTFChars(path, pathChars);
+    return started ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_eslam_bakingapp_core_security_telemetry_NativeTelemetry_nativeRecord(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jint type,
+        jint value,
+        jlong extra
+) {
+    Telemetry::shared().record(static_cast<EventType>(type), static_cast<uint32_t>(value),
+                               static_cast<uint64_t>(extra));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_telemetry_NativeTelemetry_nativeFlush(
+        JNIEnv* /* env */,
+        jobject /* thiz */
+) {
+    return Telemetry::shared().flush() ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return [rings, flushedEvents, droppedEvents, fileBytes]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_telemetry_NativeTelemetry_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */
+) {
+    const TelemetryStats stats = Telemetry::shared().stats();
+    const jlong values[] = {
+        static_cast<jlong>(stats.rings),
+        static_cast<jlong>(stats.flushedEvents),
+        static_cast<jlong>(stats.droppedEvents),
+        static_cast<jlong>(stats.fileBytes),
+    };
+    jlongArray result = env->NewLongArray(4);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 4, values);
+    return result;
+}
+
+} // extern "C"
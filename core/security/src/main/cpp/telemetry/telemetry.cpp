@@ -0,0 +1,259 @@
+#include "telemetry/telemetry.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <new>
+#include <unistd.h>
+
+#include "common/native-memory.h"
+
+namespace bakingapp::telemetry {
+
+namespace {
+    constexpr int64_t NANOS_PER_SECOND = 1000000000LL;
+    constexpr int64_t NANOS_PER_MILLI = 1000000LL;
+
+    // Tells instances apart in the thread-local ring cache; 0 is "none"
+    std::atomic<uint64_t> nextGeneration {1};
+
+    alignas(Telemetry) unsigned char sharedStorage[sizeof(Telemetry)];
+    pthread_once_t sharedOnce = PTHREAD_ONCE_INIT;
+    Telemetry* sharedTelemetry = nullptr;
+
+    void createShared() {
+        sharedTelemetry = new (sharedStorage) Telemetry();
+    }
+
+    int64_t realtimeNanos() {
+        timespec ts {};
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * NANOS_PER_SECOND + ts.tv_nsec;
+    }
+}
+
+// ==================== EventRing ====================
+
+uint32_t EventRing::drain(TelemetryEvent* out, uint32_t capacity) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t available = head - tail;
+    if (available > capacity) available = capacity;
+    for (uint64_t i = 0; i < available; i++) {
+        out[i] = slots_[(tail + i) & (CAPACITY - 1)];
+    }
+    tail_.store(tail + available, std::memory_order_release);
+    return static_cast<uint32_t>(available);
+}
+
+// ==================== Telemetry ====================
+
+Telemetry& Telemetry::shared() {
+    pthread_once(&sharedOnce, createShared);
+    return *sharedTelemetry;
+}
+
+Telemetry::Telemetry()
+    : generation_(nextGeneration.fetch_add(1, std::memory_order_relaxed)) {
+    pthread_key_create(&threadKey_, retireRing);
+}
+
+Telemetry::~Telemetry() {
+    stop();
+    // No more retireRing() calls after this, so the rings can go
+    pthread_key_delete(threadKey_);
+    EventRing* ring = rings_.load(std::memory_order_acquire);
+    while (ring != nullptr) {
+        EventRing* next = ring->next;
+        ring->~EventRing();
+        free(ring);
+        recordRelease(MemoryTag::TELEMETRY, sizeof(EventRing));
+        ring = next;
+    }
+    taggedFree(buffer_);
+    taggedFree(scratch_);
+}
+
+void Telemetry::retireRing(void* ring) {
+    static_cast<EventRing*>(ring)->retired.store(true, std::memory_order_release);
+}
+
+EventRing* Telemetry::registerThread() {
+    EventRing* ring = nullptr;
+    {
+        LockGuard lock(ringMutex_);
+        for (EventRing* other = rings_.load(std::memory_order_relaxed); other != nullptr;
+             other = other->next) {
+            bool retired = true;
+            if (other->retired.compare_exchange_strong(retired, false,
+                                                       std::memory_order_acquire)) {
+                ring = other;
+                break;
+            }
+        }
+        if (ring == nullptr) {
+            // Over-aligned, so not through create()
+            void* memory = nullptr;
+            if (posix_memalign(&memory, alignof(EventRing), sizeof(EventRing)) != 0) {
+                return nullptr;
+            }
+            recordAllocation(MemoryTag::TELEMETRY, sizeof(EventRing));
+            ring = new (memory) EventRing();
+            ring->id = ringCount_++;
+            ring->next = rings_.load(std::memory_order_relaxed);
+            rings_.store(ring, std::memory_order_release);
+        }
+    }
+    pthread_setspecific(threadKey_, ring);
+    current_ = ThreadRing {generation_, ring};
+    return ring;
+}
+
+bool Telemetry::start(const char* path, uint32_t flushIntervalMillis, uint64_t maxFileBytes) {
+    LockGuard lock(flushMutex_);
+    if (running_ || path == nullptr) return false;
+
+    if (buffer_ == nullptr) {
+        buffer_ = static_cast<uint8_t*>(
+            taggedMalloc(MemoryTag::TELEMETRY, maxBatchBytes(EventRing::CAPACITY)));
+        scratch_ = static_cast<TelemetryEvent*>(
+            taggedMalloc(MemoryTag::TELEMETRY, sizeof(TelemetryEvent) * EventRing::CAPACITY));
+        if (buffer_ == nullptr || scratch_ == nullptr) {
+            taggedFree(buffer_);
+            taggedFree(scratch_);
+            buffer_ = nullptr;
+            scratch_ = nullptr;
+            return false;
+        }
+    }
+
+    fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd_ < 0) return false;
+    intervalMillis_ = flushIntervalMillis > 0 ? flushIntervalMillis : 1;
+    maxFileBytes_ = maxFileBytes;
+    originNanos_ = telemetryNanos();
+    fileBytes_ = 0;
+    if (!writeHeader()) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&wake_, &attributes);
+    pthread_condattr_destroy(&attributes);
+
+    stopping_ = false;
+    if (pthread_create(&thread_, nullptr, threadMain, this) != 0) {
+        pthread_cond_destroy(&wake_);
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    running_ = true;
+    return true;
+}
+
+void Telemetry::stop() {
+    {
+        LockGuard lock(flushMutex_);
+        if (!running_) return;
+        stopping_ = true;
+        pthread_cond_signal(&wake_);
+    }
+    pthread_join(thread_, nullptr);
+
+    LockGuard lock(flushMutex_);
+    flushLocked();
+    ::close(fd_);
+    fd_ = -1;
+    running_ = false;
+    pthread_cond_destroy(&wake_);
+}
+
+bool Telemetry::flush() {
+    LockGuard lock(flushMutex_);
+    return running_ && flushLocked();
+}
+
+TelemetryStats Telemetry::stats() {
+    TelemetryStats stats {};
+    for (EventRing* ring = rings_.load(std::memory_order_acquire); ring != nullptr;
+         ring = ring->next) {
+        stats.rings++;
+        stats.droppedEvents += ring->dropped();
+    }
+    LockGuard lock(flushMutex_);
+    stats.flushedEvents = flushedEvents_;
+    stats.fileBytes = fileBytes_;
+    return stats;
+}
+
+bool Telemetry::writeAll(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        const ssize_t written = ::write(fd_, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool Telemetry::writeHeader() {
+    const FileHeader header {TELEMETRY_MAGIC, TELEMETRY_VERSION, originNanos_, realtimeNanos()};
+    if (!writeAll(reinterpret_cast<const uint8_t*>(&header), sizeof(header))) return false;
+    fileBytes_ = sizeof(header);
+    return true;
+}
+
+bool Telemetry::flushLocked() {
+    bool ok = true;
+    for (EventRing* ring = rings_.load(std::memory_order_acquire); ring != nullptr;
+         ring = ring->next) {
+        const uint32_t count = ring->drain(scratch_, EventRing::CAPACITY);
+        const uint64_t dropped = ring->dropped();
+        const uint64_t newDrops = dropped - ring->reportedDrops;
+        if (count == 0 && newDrops == 0) continue;
+        ring->reportedDrops = dropped;
+
+        const size_t length = encodeBatch(ring->id, newDrops, originNanos_, scratch_, count,
+                                          buffer_);
+        if (maxFileBytes_ > 0 && fileBytes_ + length > maxFileBytes_) {
+            if (ftruncate(fd_, 0) != 0 || lseek(fd_, 0, SEEK_SET) != 0 || !writeHeader()) {
+                ok = false;
+                continue;
+            }
+        }
+        if (!writeAll(buffer_, length)) {
+            ok = false;
+            continue;
+        }
+        fileBytes_ += length;
+        flushedEvents_ += count;
+    }
+    return ok;
+}
+
+void* Telemetry::threadMain(void* argument) {
+    pthread_setname_np(pthread_self(), "bk-telemetry");
+    static_cast<Telemetry*>(argument)->run();
+    return nullptr;
+}
+
+void Telemetry::run() {
+    LockGuard lock(flushMutex_);
+    while (!stopping_) {
+        const int64_t deadline = telemetryNanos() + intervalMillis_ * NANOS_PER_MILLI;
+        timespec until {static_cast<time_t>(deadline / NANOS_PER_SECOND),
+                        static_cast<long>(deadline % NANOS_PER_SECOND)};
+        pthread_cond_timedwait(&wake_, flushMutex_.native(), &until);
+        if (!stopping_) flushLocked();
+    }
+}
+
+} // namespace bakingapp::telemetry
@@ -0,0 +1,199 @@
+/**
+ * Hot-path event telemetry
+ *
+ * Every producer thread records into a ring of its own: a single-producer,
+ * single-consumer queue of fixed-size binary events (telemetry-format.h),
+ * so record() is a clock read, a 24-byte store and one release store of
+ * the ring's head. No lock, no syscall, and no allocation after a thread's
+ * first event. A full ring drops the event and counts the loss instead of
+ * stalling the caller.
+ *
+ * One background thread ("bk-telemetry") drains all rings on an interval
+ * and appends them, one batch per ring, to a file in the compact encoding
+ * of telemetry-format.h; tools/telemetry-decode.cpp prints such a file.
+ * Events recorded before start() wait in the rings, up to their capacity.
+ *
+ * A thread's ring is retired when the thread exits and handed to the next
+ * thread that records, so short-lived threads do not accumulate rings; a
+ * ring id therefore names a producer slot rather than one thread. Threads
+ * must stop recording before their Telemetry is destroyed.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <pthread.h>
+
+#include "common/mutex.h"
+#include "telemetry/telemetry-format.h"
+
+namespace bakingapp::telemetry {
+
+/**
+ * Single-producer, single-consumer ring of events
+ */
+class EventRing {
+public:
+    static constexpr uint32_t CAPACITY = 1024;     // power of two
+
+    /**
+     * Producer only
+     *
+     * @return false (and counts a drop) when the ring is full
+     */
+    bool push(const TelemetryEvent& event) {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ >= CAPACITY) {
+            // Only look at the consumer's cache line when the stale view
+            // says full
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ >= CAPACITY) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+                return false;
+            }
+        }
+        slots_[head & (CAPACITY - 1)] = event;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer only: moves up to capacity events into out
+     */
+    uint32_t drain(TelemetryEvent* out, uint32_t capacity);
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    uint32_t id = 0;
+    EventRing* next = nullptr;          // Telemetry's list of all rings
+    std::atomic<bool> retired {false};  // the producer thread exited
+    uint64_t reportedDrops = 0;         // consumer's view of dropped()
+
+private:
+    alignas(64) std::atomic<uint64_t> head_ {0};
+    uint64_t cachedTail_ = 0;
+    std::atomic<uint64_t> dropped_ {0};
+    alignas(64) std::atomic<uint64_t> tail_ {0};
+    alignas(64) TelemetryEvent slots_[CAPACITY];
+};
+
+struct TelemetryStats {
+    uint32_t rings;
+    uint64_t flushedEvents;
+    uint64_t droppedEvents;
+    uint64_t fileBytes;
+};
+
+inline int64_t telemetryNanos() {
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+class Telemetry {
+public:
+    static constexpr uint32_t DEFAULT_FLUSH_INTERVAL_MILLIS = 1000;
+    static constexpr uint64_t DEFAULT_MAX_FILE_BYTES = 4 * 1024 * 1024;
+
+    Telemetry();
+    ~Telemetry();
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    /**
+     * Truncates the file at path, writes its header and starts the
+     * flusher. Batch timestamps are relative to the header's monotonic
+     * origin, which a reboot resets, so a file only ever holds one
+     * session; one that grows past maxFileBytes is started over.
+     */
+    bool start(const char* path, uint32_t flushIntervalMillis = DEFAULT_FLUSH_INTERVAL_MILLIS,
+               uint64_t maxFileBytes = DEFAULT_MAX_FILE_BYTES);
+
+    /**
+     * Flushes once more, joins the flusher and closes the file
+     */
+    void stop();
+
+    /**
+     * Drains every ring into the file now
+     *
+     * @return false if not started or a write failed
+     */
+    bool flush();
+
+    /**
+     * Off: record() returns at once without touching a ring
+     */
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    void record(EventType type, uint32_t value = 0, uint64_t extra = 0) {
+        if (!enabled_.load(std::memory_order_relaxed)) return;
+        EventRing* ring = threadRing();
+        if (ring == nullptr) return;
+        ring->push(TelemetryEvent {telemetryNanos(), static_cast<uint32_t>(type), value, extra});
+    }
+
+    TelemetryStats stats();
+
+    /**
+     * The process-wide instance the JNI bridges record into; enabled from
+     * the start, flushing once the JNI bridge starts it
+     */
+    static Telemetry& shared();
+
+private:
+    struct ThreadRing {
+        uint64_t generation;
+        EventRing* ring;
+    };
+
+    EventRing* threadRing() {
+        ThreadRing& cached = current_;
+        if (cached.generation == generation_) return cached.ring;
+        return registerThread();
+    }
+
+    EventRing* registerThread();
+    bool flushLocked();
+    bool writeAll(const uint8_t* data, size_t size);
+    bool writeHeader();
+    void run();
+    static void* threadMain(void* argument);
+    static void retireRing(void* ring);
+
+    // Constant-initialized and defined inline, so reading it needs no TLS
+    // init guard. Caches one instance: a thread that alternates between two
+    // would take a new ring on every switch.
+    static inline thread_local ThreadRing current_ {0, nullptr};
+
+    const uint64_t generation_;
+    std::atomic<bool> enabled_ {true};
+    pthread_key_t threadKey_ {};
+
+    // Ring list; appended under ringMutex_, walked by the flusher
+    Mutex ringMutex_;
+    std::atomic<EventRing*> rings_ {nullptr};
+    uint32_t ringCount_ = 0;
+
+    // File and flusher state, under flushMutex_
+    Mutex flushMutex_;
+    pthread_cond_t wake_ {};
+    pthread_t thread_ {};
+    bool running_ = false;
+    bool stopping_ = false;
+    int fd_ = -1;
+    int64_t originNanos_ = 0;
+    uint32_t intervalMillis_ = DEFAULT_FLUSH_INTERVAL_MILLIS;
+    uint64_t maxFileBytes_ = DEFAULT_MAX_FILE_BYTES;
+    uint64_t fileBytes_ = 0;
+    uint64_t flushedEvents_ = 0;
+    uint8_t* buffer_ = nullptr;
+    TelemetryEvent* scratch_ = nullptr;
+};
+
+} // namespace bakingapp::telemetry
@@ -0,0 +1,141 @@
+/**
+ * Host tests for the asynchronous job registry
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <sched.h>
+
+#include "common/async-jobs.h"
+#include "common/thread-pool.h"
+#include "test/test-util.h"
+
+using namespace bakingapp;
+
+namespace {
+    struct CountingJob : Job {
+        std::atomic<uint32_t>* worked;
+        std::atomic<uint32_t>* finished;
+        std::atomic<int32_t>* lastStatus;
+        std::atomic<bool>* release;     // work() spins until set, if non-null
+    };
+
+    JobStatus countWork(Job* job) {
+        auto* counting = static_cast<CountingJob*>(job);
+        counting->worked->fetch_add(1);
+        if (counting->release != nullptr) {
+            while (!counting->release->load() && !job->isCancelled()) sched_yield();
+            if (job->isCancelled()) return JobStatus::CANCELLED;
+        }
+        return JobStatus::DONE;
+    }
+
+    void countFinish(Job* job, JobStatus status) {
+        auto* counting = static_cast<CountingJob*>(job);
+        counting->lastStatus->store(static_cast<int32_t>(status));
+        counting->finished->fetch_add(1);
+    }
+
+    void initJob(CountingJob* job, uint64_t id, std::atomic<uint32_t>* worked,
+                 std::atomic<uint32_t>* finished, std::atomic<int32_t>* lastStatus) {
+        job->id = id;
+        job->work = countWork;
+        job->finish = countFinish;
+        job->worked = worked;
+        job->finished = finished;
+        job->lastStatus = lastStatus;
+        job->release = nullptr;
+    }
+
+    void waitFor(const std::atomic<uint32_t>& counter, uint32_t value) {
+        while (counter.load() < value) sched_yield();
+    }
+}
+
+TEST(everyJobFinishesOnce) {
+    ThreadPool pool;
+    CHECK(pool.start(3));
+    AsyncJobs jobs(pool);
+
+    constexpr uint32_t COUNT = 10000;
+    auto* list = static_cast<CountingJob*>(calloc(COUNT, sizeof(CountingJob)));
+    std::atomic<uint32_t> worked {0};
+    std::atomic<uint32_t> finished {0};
+    std::atomic<int32_t> status {-1};
+    for (uint32_t i = 0; i < COUNT; i++) {
+        new (&list[i]) CountingJob();
+        initJob(&list[i], i + 1, &worked, &finished, &status);
+        CHECK(jobs.submit(&list[i]));
+    }
+    waitFor(finished, COUNT);
+    CHECK_EQ(COUNT, worked.load());
+    CHECK_EQ(static_cast<int32_t>(JobStatus::DONE), status.load());
+    CHECK_EQ(0u, jobs.inFlight());
+    CHECK(!jobs.cancel(1));
+    free(list);
+}
+
+TEST(rejectsDuplicateIdsAndPoolsWithoutWorkers) {
+    std::atomic<uint32_t> worked {0};
+    std::atomic<uint32_t> finished {0};
+    std::atomic<int32_t> status {-1};
+    std::atomic<bool> release {false};
+
+    ThreadPool idle;
+    CHECK(idle.start(0));
+    AsyncJobs idleJobs(idle);
+    CountingJob lost;
+    initJob(&lost, 7, &worked, &finished, &status);
+    CHECK(!idleJobs.submit(&lost));
+    CHECK_EQ(0u, idleJobs.inFlight());
+
+    ThreadPool pool;
+    CHECK(pool.start(1));
+    AsyncJobs jobs(pool);
+    CountingJob first;
+    CountingJob second;
+    initJob(&first, 7, &worked, &finished, &status);
+    initJob(&second, 7, &worked, &finished, &status);
+    first.release = &release;
+    CHECK(jobs.submit(&first));
+    CHECK(!jobs.submit(&second));
+    release.store(true);
+    waitFor(finished, 1);
+    CHECK(jobs.submit(&second));
+    waitFor(finished, 2);
+}
+
+TEST(cancellationSkipsQueuedJobsAndReachesRunningOnes) {
+    ThreadPool pool;
+    CHECK(pool.start(1));
+    AsyncJobs jobs(pool);
+    std::atomic<uint32_t> worked {0};
+    std::atomic<uint32_t> finished {0};
+    std::atomic<int32_t> runningStatus {-1};
+    std::atomic<int32_t> queuedStatus {-1};
+    std::atomic<bool> release {false};
+
+    // The only worker is held by the running job, so the second one queues
+    CountingJob running;
+    CountingJob queued;
+    initJob(&running, 1, &worked, &finished, &runningStatus);
+    initJob(&queued, 2, &worked, &finished, &queuedStatus);
+    running.release = &release;
+    CHECK(jobs.submit(&running));
+    waitFor(worked, 1);
+    CHECK(jobs.submit(&queued));
+
+    CHECK(jobs.cancel(2));
+    CHECK(jobs.cancel(1));
+    waitFor(finished, 2);
+    CHECK_EQ(1u, worked.load());
+    CHECK_EQ(static_cast<int32_t>(JobStatus::CANCELLED), runningStatus.load());
+    CHECK_EQ(static_cast<int32_t>(JobStatus::CANCELLED), queuedStatus.load());
+    CHECK(!jobs.cancel(1));
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,253 @@
+/**
+ * Host tests for the crypto primitives (against the RFC vectors) and the
+ * derived-key cache
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "crypto/chacha20-poly1305.h"
+#include "crypto/derived-key-cache.h"
+#include "crypto/sha256.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::crypto;
+
+namespace {
+    size_t fromHex(const char* hex, uint8_t* out) {
+        size_t length = 0;
+        auto nibble = [](char c) {
+            return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+        };
+        for (; hex[0] != '\0' && hex[1] != '\0'; hex += 2) {
+            out[length++] = static_cast<uint8_t>(nibble(hex[0]) << 4 | nibble(hex[1]));
+        }
+        return length;
+    }
+
+    bool equalsHex(const uint8_t* bytes, size_t length, const char* hex) {
+        uint8_t expected[256];
+        return fromHex(hex, expected) == length && memcmp(bytes, expected, length) == 0;
+    }
+
+    struct Master {
+        const char* secret;
+        int reads = 0;
+    };
+
+    size_t readMaster(uint8_t* out, size_t capacity, void* context) {
+        auto* master = static_cast<Master*>(context);
+        master->reads++;
+        const size_t length = strlen(master->secret);
+        if (length > capacity) return 0;
+        memcpy(out, master->secret, length);
+        return length;
+    }
+
+    const uint8_t SALT[] = {'b', 'k', '-', 's', 'a', 'l', 't'};
+
+    bool signWith(DerivedKeyCache& cache, const char* purpose, const char* session,
+                  uint8_t mac[SHA256_BYTES]) {
+        return cache.sign(purpose, strlen(purpose), session, strlen(session), "m", 1, mac);
+    }
+}
+
+TEST(sha256MatchesFips180) {
+    uint8_t digest[SHA256_BYTES];
+    sha256("abc", 3, digest);
+    CHECK(equalsHex(digest, sizeof(digest),
+                    "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+
+    // Streaming across block boundaries gives the same digest
+    const char* message = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    Sha256 hash;
+    for (size_t i = 0; message[i] != '\0'; i += 5) {
+        const size_t rest = strlen(message + i);
+        hash.update(message + i, rest < 5 ? rest : 5);
+    }
+    hash.finish(digest);
+    CHECK(equalsHex(digest, sizeof(digest),
+                    "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+}
+
+TEST(hmacMatchesRfc4231) {
+    uint8_t mac[SHA256_BYTES];
+    const char* data = "what do ya want for nothing?";
+    hmacSha256(reinterpret_cast<const uint8_t*>("Jefe"), 4, data, strlen(data), mac);
+    CHECK(equalsHex(mac, sizeof(mac),
+                    "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+
+    // Keys longer than a block are hashed first (test case 6)
+    uint8_t key[131];
+    memset(key, 0xAA, sizeof(key));
+    const char* large = "Test Using Larger Than Block-Size Key - Hash Key First";
+    hmacSha256(key, sizeof(key), large, strlen(large), mac);
+    CHECK(equalsHex(mac, sizeof(mac),
+                    "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"));
+}
+
+TEST(hkdfMatchesRfc5869) {
+    uint8_t ikm[22];
+    memset(ikm, 0x0B, sizeof(ikm));
+    uint8_t salt[13];
+    for (uint8_t i = 0; i < sizeof(salt); i++) salt[i] = i;
+    uint8_t info[10];
+    for (uint8_t i = 0; i < sizeof(info); i++) info[i] = static_cast<uint8_t>(0xF0 + i);
+
+    uint8_t prk[SHA256_BYTES];
+    hkdfExtract(salt, sizeof(salt), ikm, sizeof(ikm), prk);
+    CHECK(equalsHex(prk, sizeof(prk),
+                    "077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5"));
+
+    uint8_t okm[42];
+    CHECK(hkdfExpand(prk, info, sizeof(info), okm, sizeof(okm)));
+    CHECK(equalsHex(okm, sizeof(okm),
+                    "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf"
+                    "34007208d5b887185865"));
+
+    uint8_t tooLong[1];
+    CHECK(!hkdfExpand(prk, info, sizeof(info), tooLong, 255 * SHA256_BYTES + 1));
+}
+
+TEST(aeadMatchesRfc8439) {
+    uint8_t key[CHACHA20_KEY_BYTES];
+    for (uint8_t i = 0; i < sizeof(key); i++) key[i] = static_cast<uint8_t>(0x80 + i);
+    const uint8_t nonce[CHACHA20_NONCE_BYTES] = {
+        0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    };
+    const uint8_t aad[] = {0x50, 0x51, 0x52, 0x53, 0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7};
+    const char* plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you "
+                            "only one tip for the future, sunscreen would be it.";
+    const size_t length = strlen(plaintext);
+    uint8_t data[128];
+    memcpy(data, plaintext, length);
+
+    uint8_t tag[POLY1305_TAG_BYTES];
+    aeadSeal(key, nonce, aad, sizeof(aad), data, length, tag);
+    CHECK(equalsHex(data, length,
+                    "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+                    "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+                    "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+                    "3ff4def08e4b7a9de576d26586cec64b6116"));
+    CHECK(equalsHex(tag, sizeof(tag), "1ae10b594f09e26a7e902ecbd0600691"));
+
+    // A flipped tag bit leaves the ciphertext alone
+    tag[0] ^= 1;
+    CHECK(!aeadOpen(key, nonce, aad, sizeof(aad), data, length, tag));
+    CHECK(data[0] == 0xD3);
+    tag[0] ^= 1;
+    CHECK(aeadOpen(key, nonce, aad, sizeof(aad), data, length, tag));
+    CHECK(memcmp(data, plaintext, length) == 0);
+}
+
+TEST(subkeysAreHkdfOfPurposeAndSession) {
+    Master master {"master-secret"};
+    DerivedKeyCache cache(readMaster, &master, SALT, sizeof(SALT), 4);
+    CHECK(cache.isValid());
+
+    uint8_t prk[SHA256_BYTES];
+    hkdfExtract(SALT, sizeof(SALT), reinterpret_cast<const uint8_t*>(master.secret),
+                strlen(master.secret), prk);
+    const char info[] = "request\0session-1";
+    uint8_t subkey[SUBKEY_BYTES];
+    hkdfExpand(prk, info, sizeof(info) - 1, subkey, sizeof(subkey));
+    uint8_t expected[SHA256_BYTES];
+    hmacSha256(subkey, sizeof(subkey), "m", 1, expected);
+
+    uint8_t mac[SHA256_BYTES];
+    CHECK(signWith(cache, "request", "session-1", mac));
+    CHECK(memcmp(mac, expected, sizeof(mac)) == 0);
+    CHECK(cache.verify("request", 7, "session-1", 9, "m", 1, mac));
+    CHECK(!cache.verify("request", 7, "session-2", 9, "m", 1, mac));
+
+    // The split between purpose and session is part of the key
+    uint8_t shifted[SHA256_BYTES];
+    CHECK(signWith(cache, "requests", "ession-1", shifted));
+    CHECK(memcmp(mac, shifted, sizeof(mac)) != 0);
+
+    // The master secret is read once, not per derivation
+    CHECK_EQ(1, master.reads);
+}
+
+TEST(sealedDataOpensOnlyUnderTheSameSubkey) {
+    Master master {"master-secret"};
+    DerivedKeyCache cache(readMaster, &master, SALT, sizeof(SALT), 4);
+    const uint8_t nonce[CHACHA20_NONCE_BYTES] = {1, 2, 3};
+    uint8_t data[] = "favourite recipes";
+    uint8_t tag[POLY1305_TAG_BYTES];
+    CHECK(cache.seal("storage", 7, "s1", 2, nonce, nullptr, 0, data, sizeof(data), tag));
+    CHECK(memcmp(data, "favourite recipes", sizeof(data)) != 0);
+    CHECK(!cache.open("storage", 7, "s2", 2, nonce, nullptr, 0, data, sizeof(data), tag));
+    CHECK(cache.open("storage", 7, "s1", 2, nonce, nullptr, 0, data, sizeof(data), tag));
+    CHECK(memcmp(data, "favourite recipes", sizeof(data)) == 0);
+}
+
+TEST(cacheEvictsLeastRecentlyUsed) {
+    Master master {"master-secret"};
+    DerivedKeyCache cache(readMaster, &master, SALT, sizeof(SALT), 2);
+    uint8_t mac[SHA256_BYTES];
+    CHECK(signWith(cache, "p", "a", mac));
+    CHECK(signWith(cache, "p", "b", mac));
+    CHECK(signWith(cache, "p", "a", mac));      // a is now the most recent
+    CHECK(signWith(cache, "p", "c", mac));      // evicts b
+
+    DerivedKeyStats stats = cache.stats();
+    CHECK_EQ(1u, stats.hits);
+    CHECK_EQ(3u, stats.misses);
+    CHECK_EQ(1u, stats.evictions);
+    CHECK_EQ(2u, stats.size);
+
+    CHECK(signWith(cache, "p", "a", mac));
+    CHECK_EQ(2u, cache.stats().hits);
+    CHECK(signWith(cache, "p", "b", mac));
+    CHECK_EQ(4u, cache.stats().misses);
+}
+
+TEST(invalidateDropsEverySubkeyOfASession) {
+    Master master {"master-secret"};
+    DerivedKeyCache cache(readMaster, &master, SALT, sizeof(SALT), 8);
+    uint8_t before[SHA256_BYTES];
+    CHECK(signWith(cache, "request", "s1", before));
+    uint8_t mac[SHA256_BYTES];
+    CHECK(signWith(cache, "storage", "s1", mac));
+    CHECK(signWith(cache, "request", "s2", mac));
+
+    CHECK_EQ(2u, cache.invalidate("s1", 2));
+    CHECK_EQ(1u, cache.stats().size);
+    CHECK_EQ(0u, cache.invalidate("s1", 2));
+
+    // Re-derived on demand, to the same key
+    uint8_t after[SHA256_BYTES];
+    CHECK(signWith(cache, "request", "s1", after));
+    CHECK(memcmp(before, after, sizeof(before)) == 0);
+    CHECK_EQ(4u, cache.stats().misses);
+
+    cache.clear();
+    CHECK_EQ(0u, cache.stats().size);
+    CHECK(signWith(cache, "request", "s1", after));
+    CHECK(memcmp(before, after, sizeof(before)) == 0);
+    CHECK_EQ(2, master.reads);
+}
+
+TEST(rejectsMalformedIdsAndMissingSecret) {
+    Master master {"master-secret"};
+    DerivedKeyCache cache(readMaster, &master, SALT, sizeof(SALT), 4);
+    uint8_t mac[SHA256_BYTES];
+    CHECK(!cache.sign("", 0, "s", 1, "m", 1, mac));
+    CHECK(!cache.sign("p", 1, "", 0, "m", 1, mac));
+    CHECK(!cache.sign("a\0b", 3, "s", 1, "m", 1, mac));
+    char longSession[MAX_SESSION_LENGTH + 1];
+    memset(longSession, 'x', sizeof(longSession));
+    CHECK(!cache.sign("p", 1, longSession, sizeof(longSession), "m", 1, mac));
+    CHECK(cache.sign("p", 1, longSession, MAX_SESSION_LENGTH, "m", 1, mac));
+    CHECK_EQ(1, master.reads);
+
+    Master empty {""};
+    DerivedKeyCache unavailable(readMaster, &empty, SALT, sizeof(SALT), 4);
+    CHECK(!unavailable.sign("p", 1, "s", 1, "m", 1, mac));
+    CHECK_EQ(0u, unavailable.stats().size);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,257 @@
+/**
+ * Host tests for the JSON record splitter and the content-hash delta table
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "sync/delta-table.h"
+#include "sync/json-records.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::sync;
+
+namespace {
+    void tablePath(char* out, size_t size, const char* prefix) {
+        char dir[256];
+        bakingapp::test::makeTempDir(dir, sizeof(dir), prefix);
+        snprintf(out, size, "%s/recipes.delta", dir);
+    }
+
+    bool diff(DeltaTable& table, const char* json, DeltaList* out) {
+        return table.diff(reinterpret_cast<const uint8_t*>(json), strlen(json), "recipes", out);
+    }
+
+    /**
+     * Whether the list holds id with the given kind
+     */
+    bool contains(const DeltaList& list, DeltaKind kind, const char* id) {
+        const size_t idLength = strlen(id);
+        for (size_t p = 0; p < list.length; p += 2 + list.data[p + 1]) {
+            if (list.data[p] == static_cast<uint8_t>(kind) && list.data[p + 1] == idLength &&
+                memcmp(list.data + p + 2, id, idLength) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool spanEquals(const char* json, size_t offset, size_t length, const char* expected) {
+        return length == strlen(expected) && memcmp(json + offset, expected, length) == 0;
+    }
+
+    constexpr const char* BASE =
+        R"({"recipes":[{"id":"a","name":"Apple Pie"},{"id":"b","name":"Banana Bread"},)"
+        R"({"id":"c","name":"Carrot Cake"}],"page":1})";
+}
+
+TEST(scannerSplitsRecordsAndIds) {
+    const char* json =
+        " { \"total\": 2, \"meta\": {\"recipes\": []},\n"
+        "   \"recipes\" : [ {\"name\":\"say \\\"hi\\\\\",\"id\":\"r-1\",\"tags\":[[1],{\"id\":9}]} ,\n"
+        "   {\"id\": 42 , \"steps\":[\"]\"]}, {\"name\":\"no id\"}, 7, {} ] }";
+
+    JsonRecordScanner scanner;
+    CHECK(scanner.open(reinterpret_cast<const uint8_t*>(json), strlen(json), "recipes"));
+
+    JsonRecord records[6];
+    size_t count = 0;
+    while (count < 6 && scanner.next(&records[count])) count++;
+    CHECK(!scanner.failed());
+    CHECK_EQ(5u, count);
+
+    CHECK(spanEquals(json, records[0].offset, records[0].length,
+                     "{\"name\":\"say \\\"hi\\\\\",\"id\":\"r-1\",\"tags\":[[1],{\"id\":9}]}"));
+    CHECK(spanEquals(json, records[0].idOffset, records[0].idLength, "r-1"));
+    CHECK(spanEquals(json, records[1].idOffset, records[1].idLength, "42"));
+    CHECK(spanEquals(json, records[1].offset, records[1].length,
+                     "{\"id\": 42 , \"steps\":[\"]\"]}"));
+    CHECK_EQ(0u, records[2].idLength);
+    CHECK(spanEquals(json, records[3].offset, records[3].length, "7"));
+    CHECK(spanEquals(json, records[4].offset, records[4].length, "{}"));
+}
+
+TEST(scannerRejectsMissingArraysAndTruncatedInput) {
+    JsonRecordScanner scanner;
+    const char* noArray = R"({"recipe":[{"id":"a"}],"recipes":null})";
+    CHECK(!scanner.open(reinterpret_cast<const uint8_t*>(noArray), strlen(noArray), "recipes"));
+    CHECK(!scanner.failed());
+
+    // Every prefix of a valid body either fails or ends cleanly, without
+    // reading past its end
+    const size_t length = strlen(BASE);
+    for (size_t cut = 0; cut < length; cut++) {
+        JsonRecord record;
+        if (!scanner.open(reinterpret_cast<const uint8_t*>(BASE), cut, "recipes")) continue;
+        size_t records = 0;
+        while (scanner.next(&record)) {
+            CHECK(record.offset + record.length <= cut);
+            records++;
+        }
+        CHECK(scanner.failed() || records == 3);
+    }
+}
+
+TEST(reportsOnlyRealChanges) {
+    char path[512];
+    tablePath(path, sizeof(path), "delta-changes");
+    DeltaTable table;
+    CHECK(table.open(path));
+
+    DeltaList list;
+    CHECK(diff(table, BASE, &list));
+    CHECK_EQ(3u, list.inserted);
+    CHECK(contains(list, DeltaKind::INSERTED, "b"));
+    CHECK(table.commit());
+    CHECK(!table.commit());
+
+    CHECK(diff(table, BASE, &list));
+    CHECK_EQ(0u, list.length);
+    CHECK_EQ(3u, list.unchanged);
+    CHECK(table.commit());
+
+    const char* next =
+        R"({"recipes":[{"id":"a","name":"Apple Pie"},{"id":"c","name":"Carrot Cake!"},)"
+        R"({"id":"d","name":"Danish"}],"page":1})";
+    CHECK(diff(table, next, &list));
+    CHECK_EQ(1u, list.inserted);
+    CHECK_EQ(1u, list.changed);
+    CHECK_EQ(1u, list.deleted);
+    CHECK_EQ(1u, list.unchanged);
+    CHECK(contains(list, DeltaKind::INSERTED, "d"));
+    CHECK(contains(list, DeltaKind::CHANGED, "c"));
+    CHECK(contains(list, DeltaKind::DELETED, "b"));
+    CHECK(table.commit());
+    CHECK_EQ(3u, table.stats().records);
+
+    CHECK(diff(table, next, &list));
+    CHECK_EQ(0u, list.length);
+}
+
+TEST(abortKeepsTheLastCommit) {
+    char path[512];
+    tablePath(path, sizeof(path), "delta-abort");
+    DeltaTable table;
+    CHECK(table.open(path));
+
+    DeltaList list;
+    CHECK(diff(table, BASE, &list));
+    CHECK(table.commit());
+
+    const char* next = R"({"recipes":[{"id":"a","name":"Apricot Tart"},{"id":"e"}]})";
+    CHECK(diff(table, next, &list));
+    table.abort();
+    CHECK(!table.commit());
+
+    // An uncommitted diff is superseded by the next one, as after a crash
+    CHECK(diff(table, next, &list));
+    CHECK(diff(table, next, &list));
+    CHECK_EQ(1u, list.inserted);
+    CHECK_EQ(1u, list.changed);
+    CHECK_EQ(2u, list.deleted);
+
+    CHECK(diff(table, BASE, &list));
+    CHECK_EQ(0u, list.length);
+    CHECK(table.commit());
+    CHECK_EQ(3u, table.stats().records);
+}
+
+TEST(persistsAndGrows) {
+    char path[512];
+    tablePath(path, sizeof(path), "delta-grow");
+
+    constexpr int RECIPES = 2000;
+    const size_t capacity = RECIPES * 48 + 64;
+    auto* json = static_cast<char*>(malloc(capacity));
+    auto build = [&](int changedEvery) {
+        size_t n = static_cast<size_t>(snprintf(json, capacity, "{\"recipes\":["));
+        for (int i = 0; i < RECIPES; i++) {
+            const int version = changedEvery > 0 && i % changedEvery == 0 ? 2 : 1;
+            n += static_cast<size_t>(snprintf(json + n, capacity - n,
+                                              "%s{\"id\":\"recipe-%05d\",\"v\":%d}",
+                                              i == 0 ? "" : ",", i, version));
+        }
+        snprintf(json + n, capacity - n, "]}");
+    };
+
+    {
+        DeltaTable table;
+        CHECK(table.open(path));
+        build(0);
+        DeltaList list;
+        CHECK(diff(table, json, &list));
+        CHECK_EQ(static_cast<uint32_t>(RECIPES), list.inserted);
+        CHECK(table.commit());
+        CHECK(table.stats().capacity >= RECIPES * 4 / 3);
+    }
+
+    DeltaTable table;
+    CHECK(table.open(path));
+    CHECK_EQ(static_cast<uint32_t>(RECIPES), table.stats().records);
+    build(100);
+    DeltaList list;
+    CHECK(diff(table, json, &list));
+    CHECK_EQ(0u, list.inserted);
+    CHECK_EQ(static_cast<uint32_t>(RECIPES / 100), list.changed);
+    CHECK(contains(list, DeltaKind::CHANGED, "recipe-01900"));
+    CHECK(!contains(list, DeltaKind::CHANGED, "recipe-01901"));
+    free(json);
+}
+
+TEST(resetAndUnusableBodies) {
+    char path[512];
+    tablePath(path, sizeof(path), "delta-reset");
+    DeltaTable table;
+    CHECK(table.open(path));
+
+    DeltaList list;
+    CHECK(diff(table, BASE, &list));
+    CHECK(table.commit());
+    table.reset();
+    CHECK(diff(table, BASE, &list));
+    CHECK_EQ(3u, list.inserted);
+    CHECK_EQ(0u, list.deleted);
+
+    CHECK(!diff(table, R"({"recipes":[{"id":"a"},)", &list));
+    CHECK(!diff(table, R"({"items":[]})", &list));
+    CHECK(!diff(table, R"({"recipes":[{"id":"0123456789012345678901234567890123456789abcd"}]})",
+                &list));
+    CHECK(!table.commit());
+}
+
+TEST(cancelledDiffLeavesTheLastCommit) {
+    char path[512];
+    tablePath(path, sizeof(path), "delta-cancel");
+    DeltaTable table;
+    CHECK(table.open(path));
+
+    // Enough records to reach a cancellation check
+    char body[64 * 1024];
+    size_t length = static_cast<size_t>(snprintf(body, sizeof(body), "{\"recipes\":["));
+    for (int i = 0; i < 2000; i++) {
+        length += static_cast<size_t>(snprintf(body + length, sizeof(body) - length,
+                                               "%s{\"id\":\"%d\"}", i > 0 ? "," : "", i));
+    }
+    length += static_cast<size_t>(snprintf(body + length, sizeof(body) - length, "]}"));
+    CHECK(length < sizeof(body));
+    const auto* json = reinterpret_cast<const uint8_t*>(body);
+
+    DeltaList list;
+    CHECK(table.diff(json, length, "recipes", &list));
+    CHECK(table.commit());
+
+    std::atomic<bool> cancelled {true};
+    CHECK(!table.diff(json, length, "recipes", &list, &cancelled));
+    CHECK(!table.commit());
+
+    cancelled.store(false);
+    CHECK(table.diff(json, length, "recipes", &list, &cancelled));
+    CHECK_EQ(0u, list.length);
+    CHECK_EQ(2000u, list.unchanged);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
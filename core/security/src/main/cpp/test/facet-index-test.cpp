@@ -0,0 +1,257 @@
+/**
+ * Host tests for the facet index
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "search/facet-index.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::search;
+
+namespace {
+    constexpr uint32_t CATEGORY = static_cast<uint32_t>(Facet::CATEGORY);
+    constexpr uint32_t DIFFICULTY = static_cast<uint32_t>(Facet::DIFFICULTY);
+    constexpr uint32_t FAVORITE = static_cast<uint32_t>(Facet::FAVORITE);
+    constexpr uint32_t PREP_TIME = static_cast<uint32_t>(Facet::PREP_TIME);
+    constexpr uint32_t COOK_TIME = static_cast<uint32_t>(Facet::COOK_TIME);
+
+    bool setRecipe(FacetIndex& index, const char* id, const char* category,
+                   const char* difficulty, bool favorite, uint32_t prep, uint32_t cook) {
+        const FacetRecipe recipe {category, strlen(category), difficulty, strlen(difficulty),
+                                  favorite, prep, cook};
+        return index.setRecipe(id, strlen(id), recipe);
+    }
+
+    FacetFilter any() {
+        FacetFilter filter {};
+        for (uint64_t& values : filter.values) values = FacetFilter::ANY;
+        return filter;
+    }
+
+    uint64_t bit(uint32_t value) {
+        return uint64_t{1} << value;
+    }
+
+    uint32_t value(const FacetIndex& index, Facet facet, const char* text) {
+        return index.findValue(facet, text, strlen(text));
+    }
+
+    /**
+     * Evaluates and joins the matching recipe ids with spaces
+     */
+    const char* evaluate(const FacetIndex& index, const FacetFilter& filter, FacetCounts* counts) {
+        static char out[256];
+        uint32_t recipes[8];
+        const size_t count = index.evaluate(filter, counts, recipes, 8);
+        size_t length = 0;
+        for (size_t i = 0; i < count; i++) {
+            size_t n = 0;
+            const char* id = index.recipeId(recipes[i], &n);
+            if (length > 0) out[length++] = ' ';
+            memcpy(out + length, id, n);
+            length += n;
+        }
+        out[length] = '\0';
+        return out;
+    }
+
+    void addRecipes(FacetIndex& index) {
+        setRecipe(index, "brownies", "cakes", "easy", true, 15, 25);
+        setRecipe(index, "sourdough", "breads", "hard", false, 60, 45);
+        setRecipe(index, "cookies", "cookies", "easy", false, 10, 12);
+        setRecipe(index, "baguette", "breads", "medium", true, 30, 25);
+        setRecipe(index, "cheesecake", "cakes", "medium", false, 30, 70);
+    }
+}
+
+TEST(bucketsTimes) {
+    CHECK_EQ(0u, FacetIndex::timeBucket(0));
+    CHECK_EQ(0u, FacetIndex::timeBucket(10));
+    CHECK_EQ(1u, FacetIndex::timeBucket(11));
+    CHECK_EQ(4u, FacetIndex::timeBucket(60));
+    CHECK_EQ(TIME_BUCKETS - 1, FacetIndex::timeBucket(121));
+    CHECK_EQ(TIME_BUCKETS - 1, FacetIndex::timeBucket(100000));
+}
+
+TEST(countsEveryFacetAgainstTheOthers) {
+    FacetIndex index;
+    addRecipes(index);
+    CHECK_EQ(5u, index.stats().recipes);
+    const uint32_t cakes = value(index, Facet::CATEGORY, "cakes");
+    const uint32_t breads = value(index, Facet::CATEGORY, "breads");
+    const uint32_t cookies = value(index, Facet::CATEGORY, "cookies");
+    const uint32_t easy = value(index, Facet::DIFFICULTY, "easy");
+    const uint32_t medium = value(index, Facet::DIFFICULTY, "medium");
+    CHECK_EQ(3u, index.valueCount(Facet::CATEGORY));
+    CHECK_EQ(FacetIndex::NO_VALUE, value(index, Facet::CATEGORY, "pies"));
+
+    FacetCounts counts;
+    CHECK(strcmp(evaluate(index, any(), &counts),
+                 "brownies sourdough cookies baguette cheesecake") == 0);
+    CHECK_EQ(5u, counts.total);
+    CHECK_EQ(2u, counts.values[CATEGORY][cakes]);
+    CHECK_EQ(2u, counts.values[CATEGORY][breads]);
+    CHECK_EQ(1u, counts.values[CATEGORY][cookies]);
+    CHECK_EQ(2u, counts.values[FAVORITE][1]);
+    CHECK_EQ(1u, counts.values[COOK_TIME][FacetIndex::timeBucket(70)]);
+
+    // Category counts ignore the category filter; the rest respect it
+    FacetFilter filter = any();
+    filter.values[CATEGORY] = bit(cakes);
+    CHECK(strcmp(evaluate(index, filter, &counts), "brownies cheesecake") == 0);
+    CHECK_EQ(2u, counts.total);
+    CHECK_EQ(2u, counts.values[CATEGORY][breads]);
+    CHECK_EQ(1u, counts.values[CATEGORY][cookies]);
+    CHECK_EQ(1u, counts.values[DIFFICULTY][easy]);
+    CHECK_EQ(1u, counts.values[DIFFICULTY][medium]);
+    CHECK_EQ(1u, counts.values[FAVORITE][1]);
+
+    // Two filtered facets: each is counted against the other alone
+    filter.values[CATEGORY] = bit(cakes) | bit(breads);
+    filter.values[FAVORITE] = bit(1);
+    CHECK(strcmp(evaluate(index, filter, &counts), "brownies baguette") == 0);
+    CHECK_EQ(2u, counts.total);
+    CHECK_EQ(1u, counts.values[CATEGORY][cakes]);
+    CHECK_EQ(1u, counts.values[CATEGORY][breads]);
+    CHECK_EQ(0u, counts.values[CATEGORY][cookies]);
+    CHECK_EQ(2u, counts.values[FAVORITE][1]);
+    CHECK_EQ(2u, counts.values[FAVORITE][0]);
+
+    filter = any();
+    filter.values[PREP_TIME] = bit(FacetIndex::timeBucket(30));
+    filter.values[DIFFICULTY] = bit(medium);
+    CHECK(strcmp(evaluate(index, filter, &counts), "baguette cheesecake") == 0);
+    CHECK_EQ(2u, counts.values[DIFFICULTY][medium]);
+    CHECK_EQ(0u, counts.values[DIFFICULTY][easy]);
+
+    // Accepting no value that exists matches nothing, but still counts
+    filter = any();
+    filter.values[CATEGORY] = 0;
+    CHECK(strcmp(evaluate(index, filter, &counts), "") == 0);
+    CHECK_EQ(0u, counts.total);
+    CHECK_EQ(2u, counts.values[CATEGORY][cakes]);
+}
+
+TEST(updatesFavoritesAndRemovals) {
+    FacetIndex index;
+    addRecipes(index);
+    FacetFilter favorites = any();
+    favorites.values[FAVORITE] = bit(1);
+    FacetCounts counts;
+    CHECK(index.setFavorite("cookies", 7, true));
+    CHECK(index.setFavorite("brownies", 8, false));
+    CHECK(!index.setFavorite("missing", 7, true));
+    CHECK(strcmp(evaluate(index, favorites, &counts), "cookies baguette") == 0);
+
+    // Replacing a recipe moves it between values
+    CHECK(setRecipe(index, "cookies", "biscuits", "easy", true, 5, 8));
+    CHECK_EQ(0u, index.evaluate(favorites, &counts, nullptr, 0));
+    CHECK_EQ(0u, counts.values[CATEGORY][value(index, Facet::CATEGORY, "cookies")]);
+    CHECK_EQ(1u, counts.values[CATEGORY][value(index, Facet::CATEGORY, "biscuits")]);
+    CHECK_EQ(2u, counts.total);
+
+    CHECK(index.removeRecipe("baguette", 8));
+    CHECK(!index.removeRecipe("baguette", 8));
+    CHECK(!index.setFavorite("baguette", 8, true));
+    CHECK(strcmp(evaluate(index, favorites, &counts), "cookies") == 0);
+    CHECK_EQ(4u, index.stats().recipes);
+    CHECK(!setRecipe(index, "", "cakes", "easy", false, 1, 1));
+
+    index.clear();
+    CHECK_EQ(0u, index.stats().recipes);
+    CHECK_EQ(0u, index.valueCount(Facet::CATEGORY));
+    CHECK(strcmp(evaluate(index, any(), &counts), "") == 0);
+    CHECK(setRecipe(index, "bread", "breads", "easy", false, 1, 1));
+    CHECK(strcmp(evaluate(index, any(), &counts), "bread") == 0);
+}
+
+TEST(rejectsTooManyValues) {
+    FacetIndex index;
+    char id[16];
+    char category[16];
+    for (uint32_t i = 0; i < MAX_FACET_VALUES; i++) {
+        snprintf(id, sizeof(id), "r%u", i);
+        snprintf(category, sizeof(category), "c%u", i);
+        CHECK(setRecipe(index, id, category, "easy", false, 1, 1));
+    }
+    CHECK(!setRecipe(index, "extra", "one too many", "easy", false, 1, 1));
+    CHECK(setRecipe(index, "extra", "c5", "easy", false, 1, 1));
+    CHECK_EQ(MAX_FACET_VALUES, index.valueCount(Facet::CATEGORY));
+    CHECK_EQ(MAX_FACET_VALUES + 1, index.stats().recipes);
+}
+
+TEST(matchesBruteForceAcrossBlocks) {
+    // Enough rows for several evaluation blocks, with holes from removals
+    constexpr uint32_t ROWS = 20000;
+    const char* categories[] = {"cakes", "breads", "cookies", "pies", "pastries"};
+    const char* difficulties[] = {"easy", "medium", "hard"};
+    auto* values = static_cast<uint8_t(*)[FACET_COUNT]>(malloc(ROWS * FACET_COUNT));
+    auto* live = static_cast<bool*>(malloc(ROWS));
+    FacetIndex index;
+    uint32_t state = 12345;
+    char id[16];
+    for (uint32_t r = 0; r < ROWS; r++) {
+        state = state * 1664525u + 1013904223u;
+        const uint32_t c = (state >> 8) % 5;
+        const uint32_t d = (state >> 12) % 3;
+        const bool favorite = (state >> 16) % 7 == 0;
+        const uint32_t prep = (state >> 18) % 150;
+        const uint32_t cook = (state >> 20) % 200;
+        snprintf(id, sizeof(id), "recipe-%u", r);
+        CHECK(setRecipe(index, id, categories[c], difficulties[d], favorite, prep, cook));
+        values[r][CATEGORY] = static_cast<uint8_t>(value(index, Facet::CATEGORY, categories[c]));
+        values[r][DIFFICULTY] =
+            static_cast<uint8_t>(value(index, Facet::DIFFICULTY, difficulties[d]));
+        values[r][FAVORITE] = favorite;
+        values[r][PREP_TIME] = static_cast<uint8_t>(FacetIndex::timeBucket(prep));
+        values[r][COOK_TIME] = static_cast<uint8_t>(FacetIndex::timeBucket(cook));
+        live[r] = true;
+    }
+    for (uint32_t r = 0; r < ROWS; r += 11) {
+        snprintf(id, sizeof(id), "recipe-%u", r);
+        CHECK(index.removeRecipe(id, strlen(id)));
+        live[r] = false;
+    }
+
+    FacetFilter filter = any();
+    filter.values[CATEGORY] = bit(0) | bit(3);
+    filter.values[FAVORITE] = bit(0);
+    filter.values[COOK_TIME] = bit(2) | bit(3) | bit(4) | bit(7);
+    FacetCounts counts;
+    const size_t written = index.evaluate(filter, &counts, nullptr, 0);
+    CHECK_EQ(0u, written);
+
+    uint64_t total = 0;
+    uint32_t expected[FACET_COUNT][MAX_FACET_VALUES] = {};
+    for (uint32_t r = 0; r < ROWS; r++) {
+        if (!live[r]) continue;
+        uint32_t misses = 0;
+        uint32_t missed = 0;
+        for (uint32_t f = 0; f < FACET_COUNT; f++) {
+            if ((filter.values[f] & bit(values[r][f])) == 0) {
+                misses++;
+                missed = f;
+            }
+        }
+        total += misses == 0;
+        for (uint32_t f = 0; f < FACET_COUNT; f++) {
+            if (misses == 0 || (misses == 1 && missed == f)) expected[f][values[r][f]]++;
+        }
+    }
+    CHECK_EQ(total, counts.total);
+    bool same = true;
+    for (uint32_t f = 0; f < FACET_COUNT; f++) {
+        for (uint32_t v = 0; v < MAX_FACET_VALUES; v++) same &= expected[f][v] == counts.values[f][v];
+    }
+    CHECK(same);
+    free(values);
+    free(live);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,185 @@
+/**
+ * Host tests for the area-average resizer and the thumbnail cache
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+
+#include "common/hash.h"
+#include "image/image-resize.h"
+#include "image/thumbnail-cache.h"
+#include "test/test-util.h"
+
+using namespace bakingapp;
+using namespace bakingapp::image;
+
+namespace {
+    struct Pixels {
+        explicit Pixels(uint32_t w, uint32_t h) : width(w), height(h) {
+            data = static_cast<uint8_t*>(calloc(static_cast<size_t>(w) * h, 4));
+        }
+        ~Pixels() { free(data); }
+
+        ImageView view() const { return ImageView{data, width, height, width * 4u}; }
+        MutableImageView mutableView() { return MutableImageView{data, width, height, width * 4u}; }
+        uint8_t* at(uint32_t x, uint32_t y) { return data + (static_cast<size_t>(y) * width + x) * 4; }
+
+        uint8_t* data;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    void fill(Pixels& p, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+        for (uint32_t i = 0; i < p.width * p.height; i++) {
+            p.data[i * 4] = r;
+            p.data[i * 4 + 1] = g;
+            p.data[i * 4 + 2] = b;
+            p.data[i * 4 + 3] = a;
+        }
+    }
+
+    int countBlobs(const char* dir) {
+        int blobs = 0;
+        DIR* d = opendir(dir);
+        while (dirent* entry = readdir(d)) {
+            if (strstr(entry->d_name, ".thumb") != nullptr) blobs++;
+        }
+        closedir(d);
+        return blobs;
+    }
+}
+
+TEST(hash64MatchesReferenceVectors) {
+    CHECK(hash64("", 0) == 0xEF46DB3751D8E999ULL);
+    CHECK(hash64("a", 1) == 0xD24EC4F1A98C6E5BULL);
+    CHECK(hash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+}
+
+TEST(flatImageStaysFlatAtAnyScale) {
+    Pixels src(1003, 751);
+    fill(src, 200, 100, 50, 255);
+    const uint32_t sizes[][2] = {{360, 270}, {97, 13}, {1, 1}, {1003, 751}, {1500, 900}};
+    for (const auto& size : sizes) {
+        Pixels dst(size[0], size[1]);
+        CHECK(resizeAreaAverage(src.view(), dst.mutableView()));
+        bool flat = true;
+        for (uint32_t i = 0; i < dst.width * dst.height; i++) {
+            flat &= dst.data[i * 4] == 200 && dst.data[i * 4 + 1] == 100 &&
+                    dst.data[i * 4 + 2] == 50 && dst.data[i * 4 + 3] == 255;
+        }
+        CHECK(flat);
+    }
+}
+
+TEST(twoByTwoBlocksAverageExactly) {
+    Pixels src(4, 2);
+    const uint8_t values[] = {0, 100, 20, 40, 255, 255, 0, 0};
+    for (uint32_t x = 0; x < 4; x++) {
+        for (uint32_t y = 0; y < 2; y++) {
+            memset(src.at(x, y), values[y * 4 + x], 4);
+        }
+    }
+    Pixels dst(2, 1);
+    CHECK(resizeAreaAverage(src.view(), dst.mutableView()));
+    CHECK_EQ(153, dst.at(0, 0)[0]);  // (0 + 100 + 255 + 255) / 4 = 152.5
+    CHECK_EQ(15, dst.at(1, 0)[0]);   // (20 + 40 + 0 + 0) / 4
+}
+
+TEST(centerCropKeepsDestinationAspect) {
+    Rect wide = centerCropRect(2000, 1000, 300, 300);
+    CHECK_EQ(1000u, wide.width);
+    CHECK_EQ(1000u, wide.height);
+    CHECK_EQ(500u, wide.x);
+
+    Rect tall = centerCropRect(1000, 3000, 400, 300);
+    CHECK_EQ(1000u, tall.width);
+    CHECK_EQ(750u, tall.height);
+    CHECK_EQ(1125u, tall.y);
+}
+
+TEST(rejectsInvalidGeometry) {
+    Pixels src(10, 10);
+    Pixels dst(5, 5);
+    CHECK(!resizeAreaAverage(src.view(), Rect{8, 0, 5, 5}, dst.mutableView()));
+    CHECK(!resizeAreaAverage(src.view(), Rect{0, 0, 0, 5}, dst.mutableView()));
+}
+
+TEST(cacheRoundTripsAndPersists) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "thumb-cache");
+
+    Pixels thumb(32, 24);
+    for (uint32_t i = 0; i < 32 * 24 * 4; i++) thumb.data[i] = static_cast<uint8_t>(i * 7);
+    const char* url = "https://example.com/cake.jpg";
+    const uint64_t key = ThumbnailCache::keyFor(url, strlen(url), 32, 24, true);
+    CHECK(key != ThumbnailCache::keyFor(url, strlen(url), 64, 48, true));
+    // A fitted thumbnail of the same cell is a different image
+    CHECK(key != ThumbnailCache::keyFor(url, strlen(url), 32, 24, false));
+
+    {
+        ThumbnailCache cache;
+        CHECK(cache.open(dir, 64));
+        CHECK(cache.store(key, thumb.view()));
+        CHECK_EQ(1u, cache.count());
+    }
+
+    ThumbnailCache reopened;
+    CHECK(reopened.open(dir, 64));
+    uint32_t w = 0, h = 0;
+    CHECK(reopened.lookup(key, &w, &h));
+    CHECK_EQ(32u, w);
+    CHECK_EQ(24u, h);
+
+    Pixels out(32, 24);
+    CHECK(reopened.read(key, out.mutableView()));
+    CHECK(memcmp(out.data, thumb.data, 32 * 24 * 4) == 0);
+
+    Pixels wrongSize(16, 12);
+    CHECK(!reopened.read(key, wrongSize.mutableView()));
+}
+
+TEST(identicalThumbnailsShareOneBlob) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "thumb-dedup");
+
+    Pixels thumb(8, 8);
+    fill(thumb, 1, 2, 3, 4);
+    ThumbnailCache cache;
+    CHECK(cache.open(dir, 64));
+    CHECK(cache.store(ThumbnailCache::keyFor("a", 1, 8, 8, true), thumb.view()));
+    CHECK(cache.store(ThumbnailCache::keyFor("b", 1, 8, 8, true), thumb.view()));
+    CHECK_EQ(2u, cache.count());
+    CHECK_EQ(1, countBlobs(dir));
+
+    CHECK(cache.remove(ThumbnailCache::keyFor("a", 1, 8, 8, true)));
+    CHECK_EQ(1, countBlobs(dir));
+    CHECK(cache.remove(ThumbnailCache::keyFor("b", 1, 8, 8, true)));
+    CHECK_EQ(0, countBlobs(dir));
+}
+
+TEST(evictsLeastRecentlyUsedWhenFull) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "thumb-evict");
+
+    ThumbnailCache cache;
+    CHECK(cache.open(dir, 16));
+    Pixels thumb(4, 4);
+    char url[32];
+    for (int i = 0; i < 40; i++) {
+        fill(thumb, static_cast<uint8_t>(i), 0, 0, 255);
+        int n = snprintf(url, sizeof(url), "url-%d", i);
+        CHECK(cache.store(ThumbnailCache::keyFor(url, n, 4, 4, true), thumb.view()));
+        // Keep url-0 hot so it survives every eviction round
+        cache.lookup(ThumbnailCache::keyFor("url-0", 5, 4, 4, true), nullptr, nullptr);
+    }
+    CHECK(cache.count() <= 12u);
+    CHECK(cache.lookup(ThumbnailCache::keyFor("url-0", 5, 4, 4, true), nullptr, nullptr));
+    CHECK(cache.lookup(ThumbnailCache::keyFor("url-39", 6, 4, 4, true), nullptr, nullptr));
+    CHECK(!cache.lookup(ThumbnailCache::keyFor("url-1", 5, 4, 4, true), nullptr, nullptr));
+    CHECK_EQ(static_cast<int>(cache.count()), countBlobs(dir));
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
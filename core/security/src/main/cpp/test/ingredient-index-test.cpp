@@ -0,0 +1,231 @@
+/**
+ * Host tests for the roaring bitmap and the ingredient index
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "search/ingredient-index.h"
+#include "search/roaring-bitmap.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::search;
+
+namespace {
+    constexpr uint32_t UNIVERSE = 3 * 65536;
+
+    /**
+     * Fills a bitmap and a plain bool-per-value reference with the same
+     * values: sparse in the first container, dense in the second, a run
+     * straddling the array/bitmap threshold in the third
+     */
+    void fill(RoaringBitmap& bitmap, bool* reference, uint32_t seed) {
+        uint32_t state = seed;
+        for (uint32_t value = 0; value < UNIVERSE; value++) {
+            state = state * 1664525u + 1013904223u;
+            const uint32_t roll = state >> 16;
+            const bool member = value < 65536 ? roll % 97 == 0
+                : value < 2 * 65536 ? roll % 3 != 0
+                : value - 2 * 65536 < 4000 + seed * 50;
+            reference[value] = member;
+            if (member) bitmap.add(value);
+        }
+    }
+
+    bool matches(const RoaringBitmap& bitmap, const bool* reference) {
+        uint64_t expected = 0;
+        for (uint32_t value = 0; value < UNIVERSE; value++) {
+            if (bitmap.contains(value) != reference[value]) return false;
+            expected += reference[value];
+        }
+        return bitmap.cardinality() == expected;
+    }
+
+    bool setRecipe(IngredientIndex& index, const char* id, const char* ingredients) {
+        return index.setRecipe(id, strlen(id), ingredients, strlen(ingredients));
+    }
+
+    /**
+     * Queries and joins the recipe ids with spaces
+     */
+    const char* query(IngredientIndex& index, const char* include, const char* exclude = "") {
+        static char out[256];
+        uint32_t recipes[8];
+        const size_t count =
+            index.query(include, strlen(include), exclude, strlen(exclude), recipes, 8);
+        CHECK_EQ(count, index.count(include, strlen(include), exclude, strlen(exclude)));
+        size_t length = 0;
+        for (size_t i = 0; i < count; i++) {
+            size_t n = 0;
+            const char* id = index.recipeId(recipes[i], &n);
+            if (length > 0) out[length++] = ' ';
+            memcpy(out + length, id, n);
+            length += n;
+        }
+        out[length] = '\0';
+        return out;
+    }
+
+    void addRecipes(IngredientIndex& index) {
+        setRecipe(index, "salsa", "Cherry Tomatoes\nOnion\nLime juice\nCoriander");
+        setRecipe(index, "omelette", "eggs\nbutter\nchives");
+        setRecipe(index, "shakshuka", "Tomatoes\nEggs\nOnions\nCumin");
+        setRecipe(index, "cake", "plain flour\nEGGS\nunsalted butter\ncaster sugar");
+        setRecipe(index, "verde", "Tomatillos\nonion\nlime juice");
+    }
+}
+
+TEST(addsAndRemovesAcrossContainerKinds) {
+    RoaringBitmap bitmap;
+    CHECK(bitmap.isEmpty());
+    for (uint32_t value = 0; value < 5000; value++) CHECK(bitmap.add(value * 2));
+    CHECK(bitmap.add(0x12345678));
+    CHECK(bitmap.add(0x12345678));
+    CHECK_EQ(5001u, bitmap.cardinality());
+    CHECK(bitmap.contains(9998));
+    CHECK(!bitmap.contains(9999));
+    CHECK(bitmap.contains(0x12345678));
+
+    // Back under the array threshold, and then empty again
+    for (uint32_t value = 0; value < 5000; value++) CHECK(bitmap.remove(value * 2));
+    CHECK(!bitmap.remove(2));
+    CHECK_EQ(1u, bitmap.cardinality());
+    CHECK(bitmap.remove(0x12345678));
+    CHECK(bitmap.isEmpty());
+
+    const uint32_t added[] = {70000, 5, 0xFFFFFFFF, 65536};
+    for (uint32_t value : added) CHECK(bitmap.add(value));
+    uint32_t values[4];
+    CHECK_EQ(4u, bitmap.toArray(values, 4));
+    CHECK_EQ(5u, values[0]);
+    CHECK_EQ(65536u, values[1]);
+    CHECK_EQ(70000u, values[2]);
+    CHECK_EQ(0xFFFFFFFFu, values[3]);
+    CHECK_EQ(2u, bitmap.toArray(values, 2));
+}
+
+TEST(setOperationsMatchReference) {
+    auto* a = static_cast<bool*>(malloc(UNIVERSE));
+    auto* b = static_cast<bool*>(malloc(UNIVERSE));
+    auto* expected = static_cast<bool*>(malloc(UNIVERSE));
+    RoaringBitmap x;
+    RoaringBitmap y;
+    fill(x, a, 1);
+    fill(y, b, 7);
+    CHECK(matches(x, a));
+    CHECK(matches(y, b));
+
+    const SetOperation operations[] = {SetOperation::AND, SetOperation::OR,
+                                       SetOperation::AND_NOT};
+    for (SetOperation operation : operations) {
+        for (uint32_t value = 0; value < UNIVERSE; value++) {
+            expected[value] = operation == SetOperation::AND ? a[value] && b[value]
+                : operation == SetOperation::OR ? a[value] || b[value]
+                : a[value] && !b[value];
+        }
+        RoaringBitmap result;
+        CHECK(result.assign(x, operation, y));
+        CHECK(matches(result, expected));
+
+        // In place, with the left operand as the destination
+        RoaringBitmap copy;
+        CHECK(copy.copyFrom(x));
+        CHECK(copy.assign(copy, operation, y));
+        CHECK(matches(copy, expected));
+        if (operation == SetOperation::AND) {
+            CHECK_EQ(result.cardinality(), RoaringBitmap::andCardinality(x, y));
+        }
+    }
+    free(a);
+    free(b);
+    free(expected);
+}
+
+TEST(serializesAndRejectsMalformedBytes) {
+    auto* reference = static_cast<bool*>(malloc(UNIVERSE));
+    RoaringBitmap bitmap;
+    fill(bitmap, reference, 3);
+    const size_t size = bitmap.serializedSize();
+    auto* bytes = static_cast<uint8_t*>(malloc(size));
+    bitmap.serialize(bytes);
+
+    RoaringBitmap restored;
+    CHECK_EQ(size, restored.deserialize(bytes, size));
+    CHECK(matches(restored, reference));
+    CHECK_EQ(0u, restored.deserialize(bytes, size - 1));
+    CHECK(matches(restored, reference));
+    memcpy(bytes + 4 + 8 + 2, bytes + 4 + 8, 2);  // a repeated value in the first array
+    CHECK_EQ(0u, restored.deserialize(bytes, size));
+    free(bytes);
+    free(reference);
+}
+
+TEST(matchesIngredientPhrases) {
+    IngredientIndex index;
+    addRecipes(index);
+    CHECK_EQ(5u, index.stats().recipes);
+
+    CHECK(strcmp(query(index, "egg"), "omelette shakshuka cake") == 0);
+    // A phrase matches inside longer names, on word boundaries only
+    CHECK(strcmp(query(index, "tomato"), "salsa shakshuka") == 0);
+    CHECK(strcmp(query(index, "Cherry tomato"), "salsa") == 0);
+    CHECK(strcmp(query(index, "butter"), "omelette cake") == 0);
+    CHECK(strcmp(query(index, "eggs\nbutter"), "omelette cake") == 0);
+    CHECK(strcmp(query(index, "eggs\nbutter\nflour"), "cake") == 0);
+    CHECK(strcmp(query(index, "onion\nlime"), "salsa verde") == 0);
+    CHECK(strcmp(query(index, "onion", "tomato"), "verde") == 0);
+    CHECK(strcmp(query(index, "", "eggs\nlime"), "") == 0);
+    CHECK(strcmp(query(index, "", "onion"), "omelette cake") == 0);
+    // An ingredient nobody uses matches nothing, even next to ones in use
+    CHECK(strcmp(query(index, "eggs\nsaffron"), "") == 0);
+    CHECK(strcmp(query(index, "eggs", "saffron"), "omelette shakshuka cake") == 0);
+}
+
+TEST(updatesAndPersistsRecipes) {
+    IngredientIndex index;
+    addRecipes(index);
+    CHECK(setRecipe(index, "omelette", "eggs\nmushrooms"));
+    CHECK(strcmp(query(index, "butter"), "cake") == 0);
+    CHECK(strcmp(query(index, "mushroom"), "omelette") == 0);
+    CHECK(index.removeRecipe("cake", 4));
+    CHECK(!index.removeRecipe("cake", 4));
+    CHECK(!index.removeRecipe("missing", 7));
+    CHECK(strcmp(query(index, "eggs"), "omelette shakshuka") == 0);
+    CHECK(!setRecipe(index, "", "eggs"));
+
+    char dir[256];
+    char path[300];
+    bakingapp::test::makeTempDir(dir, sizeof(dir), "ingredient-index");
+    snprintf(path, sizeof(path), "%s/ingredients.index", dir);
+    CHECK(index.save(path));
+
+    IngredientIndex restored;
+    CHECK(restored.load(path));
+    CHECK_EQ(4u, restored.stats().recipes);
+    CHECK(strcmp(query(restored, "eggs"), "omelette shakshuka") == 0);
+    CHECK(strcmp(query(restored, "onion", "tomato"), "verde") == 0);
+    // Updates after a load keep the saved numbering
+    CHECK(setRecipe(restored, "cake", "eggs\nflour"));
+    CHECK(strcmp(query(restored, "eggs\nflour"), "cake") == 0);
+
+    // A corrupted snapshot is rejected as a whole
+    FILE* file = fopen(path, "r+b");
+    fseek(file, -1, SEEK_END);
+    fputc('x', file);
+    fclose(file);
+    CHECK(!restored.load(path));
+    CHECK_EQ(0u, restored.stats().recipes);
+    CHECK(!restored.load("/nonexistent/ingredients.index"));
+
+    index.clear();
+    CHECK_EQ(0u, index.stats().recipes);
+    CHECK(strcmp(query(index, "eggs"), "") == 0);
+    remove(path);
+    rmdir(dir);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,238 @@
+/**
+ * Host tests for the encrypted key blob: lazy decryption and caching,
+ * tampered and foreign blobs, blobs inside a larger file, eviction, and
+ * the shipped asset against the compiled registry
+ *
+ * Usage: key-blob-test [keys.blob]
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <unistd.h>
+
+#include "keys/app-keys.h"
+#include "keys/key-blob.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::keys;
+
+namespace {
+    const char* assetPath = nullptr;
+
+    const uint8_t KEY[BLOB_KEY_BYTES] = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 11, 12, 13, 14, 15, 16,
+                                         17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30,
+                                         31, 32};
+
+    const KeyDefinition DEFINITIONS[] = {
+        {"api", "bk_blob_api_key"},
+        {"secret", "sk_blob_secret_key"},
+        {"partner.grocer.api", "bk_blob_grocer_key"},
+    };
+    constexpr size_t COUNT = sizeof(DEFINITIONS) / sizeof(DEFINITIONS[0]);
+
+    /**
+     * Seals DEFINITIONS into a file after padding bytes of filler
+     *
+     * @return the blob size
+     */
+    size_t writeBlob(char* path, size_t pathSize, const char* prefix, size_t padding = 0) {
+        char dir[256];
+        bakingapp::test::makeTempDir(dir, sizeof(dir), prefix);
+        snprintf(path, pathSize, "%s/keys.blob", dir);
+        uint8_t blob[1024];
+        const size_t size = encodeKeyBlob(DEFINITIONS, COUNT, KEY, blob, sizeof(blob));
+        FILE* file = fopen(path, "wb");
+        for (size_t i = 0; i < padding; i++) fputc('x', file);
+        fwrite(blob, 1, size, file);
+        fclose(file);
+        return size;
+    }
+
+    bool holds(KeyBlob& blob, const char* name, const char* value) {
+        char out[MAX_BLOB_VALUE_LENGTH + 1];
+        size_t length = 0;
+        return blob.get(name, out, sizeof(out), &length) && length == strlen(value) &&
+               strcmp(out, value) == 0;
+    }
+
+    void flipByte(const char* path, off_t offset) {
+        const int fd = open(path, O_RDWR);
+        uint8_t byte = 0;
+        pread(fd, &byte, 1, offset);
+        byte ^= 0x01;
+        pwrite(fd, &byte, 1, offset);
+        close(fd);
+    }
+}
+
+TEST(decryptsEntriesOnFirstUseOnly) {
+    char path[512];
+    const size_t size = writeBlob(path, sizeof(path), "key-blob-lazy");
+    CHECK_EQ(keyBlobSize(DEFINITIONS, COUNT), size);
+
+    KeyBlob blob;
+    CHECK(blob.open(path, KEY));
+    KeyBlobStats stats = blob.stats();
+    CHECK_EQ(3u, stats.entries);
+    CHECK_EQ(0u, stats.decrypts);
+
+    CHECK(holds(blob, "secret", "sk_blob_secret_key"));
+    CHECK(holds(blob, "secret", "sk_blob_secret_key"));
+    CHECK(holds(blob, "partner.grocer.api", "bk_blob_grocer_key"));
+    stats = blob.stats();
+    CHECK_EQ(2u, stats.decrypts);
+    CHECK_EQ(1u, stats.hits);
+    CHECK_EQ(2u, stats.cached);
+
+    size_t length = 0;
+    char out[MAX_BLOB_VALUE_LENGTH + 1];
+    CHECK(!blob.get("staging.api", out, sizeof(out), &length));
+
+    // Values longer than the caller's buffer report their length only
+    char small[4] = "old";
+    CHECK(blob.get("api", small, sizeof(small), &length));
+    CHECK_EQ(strlen("bk_blob_api_key"), length);
+    CHECK(strcmp(small, "old") == 0);
+
+    blob.close();
+    CHECK(!blob.isOpen());
+    CHECK(!blob.get("api", out, sizeof(out), &length));
+}
+
+TEST(rejectsTamperedAndForeignBlobs) {
+    char path[512];
+    const size_t size = writeBlob(path, sizeof(path), "key-blob-tamper");
+
+    uint8_t otherKey[BLOB_KEY_BYTES];
+    memcpy(otherKey, KEY, sizeof(otherKey));
+    otherKey[31] ^= 0x80;
+    {
+        // The header carries no key: a foreign blob opens, but nothing in it does
+        KeyBlob foreign;
+        CHECK(foreign.open(path, otherKey));
+        CHECK(!holds(foreign, "api", "bk_blob_api_key"));
+        CHECK_EQ(1u, foreign.stats().failures);
+        CHECK_EQ(0u, foreign.stats().cached);
+    }
+
+    // The last byte is the tag of one value; the other values still open
+    flipByte(path, static_cast<off_t>(size - 1));
+    KeyBlob blob;
+    CHECK(blob.open(path, KEY));
+    int opened = 0;
+    for (const KeyDefinition& definition : DEFINITIONS) {
+        char value[64];
+        memcpy(value, definition.value.data(), definition.value.size());
+        value[definition.value.size()] = '\0';
+        char name[64];
+        memcpy(name, definition.name.data(), definition.name.size());
+        name[definition.name.size()] = '\0';
+        if (holds(blob, name, value)) opened++;
+    }
+    CHECK_EQ(2, opened);
+    CHECK_EQ(1u, blob.stats().failures);
+
+    // An index entry is authenticated with its value
+    flipByte(path, static_cast<off_t>(size - 1));
+    flipByte(path, 16 + 8);             // first entry's offset
+    CHECK(blob.open(path, KEY));
+    CHECK_EQ(3u, blob.stats().entries);
+    size_t length = 0;
+    char out[MAX_BLOB_VALUE_LENGTH + 1];
+    int found = 0;
+    for (const KeyDefinition& definition : DEFINITIONS) {
+        if (blob.get(definition.name, out, sizeof(out), &length)) found++;
+    }
+    CHECK_EQ(2, found);
+
+    // A header that claims more entries than the file holds is refused
+    flipByte(path, 16 + 8);
+    uint32_t count = 1000;
+    const int fd = open(path, O_RDWR);
+    pwrite(fd, &count, sizeof(count), 8);
+    CHECK(!blob.open(path, KEY));
+    count = COUNT;
+    pwrite(fd, &count, sizeof(count), 8);
+    close(fd);
+    CHECK(blob.open(path, KEY));
+
+    // So is anything that is not a blob
+    flipByte(path, 0);
+    CHECK(!blob.open(path, KEY));
+    CHECK(!blob.open("/nonexistent/keys.blob", KEY));
+}
+
+TEST(opensBlobInsideLargerFile) {
+    char path[512];
+    constexpr size_t PADDING = 5003;    // not page aligned, like an APK asset
+    const size_t size = writeBlob(path, sizeof(path), "key-blob-offset", PADDING);
+    const int fd = open(path, O_RDONLY);
+    KeyBlob blob;
+    CHECK(blob.open(fd, PADDING, size, KEY));
+    close(fd);
+    CHECK(holds(blob, "api", "bk_blob_api_key"));
+    CHECK(holds(blob, "partner.grocer.api", "bk_blob_grocer_key"));
+}
+
+TEST(evictsOldestValueWhenFull) {
+    char path[512];
+    writeBlob(path, sizeof(path), "key-blob-evict");
+    KeyBlob blob(2);
+    CHECK(blob.open(path, KEY));
+    CHECK(holds(blob, "api", "bk_blob_api_key"));
+    CHECK(holds(blob, "secret", "sk_blob_secret_key"));
+    CHECK(holds(blob, "partner.grocer.api", "bk_blob_grocer_key"));
+    CHECK(holds(blob, "secret", "sk_blob_secret_key"));
+    CHECK(holds(blob, "api", "bk_blob_api_key"));
+    const KeyBlobStats stats = blob.stats();
+    CHECK_EQ(2u, stats.cached);
+    CHECK_EQ(2u, stats.evictions);
+    CHECK_EQ(4u, stats.decrypts);
+    CHECK_EQ(1u, stats.hits);
+}
+
+TEST(rejectsDuplicateAndOversizedDefinitions) {
+    uint8_t blob[1024];
+    const KeyDefinition duplicates[] = {{"api", "a"}, {"api", "b"}};
+    CHECK_EQ(0u, encodeKeyBlob(duplicates, 2, KEY, blob, sizeof(blob)));
+    char longValue[MAX_BLOB_VALUE_LENGTH + 2];
+    memset(longValue, 'v', sizeof(longValue));
+    const KeyDefinition oversized[] = {{"api", std::string_view(longValue, sizeof(longValue))}};
+    CHECK_EQ(0u, encodeKeyBlob(oversized, 1, KEY, blob, sizeof(blob)));
+    CHECK_EQ(0u, encodeKeyBlob(DEFINITIONS, COUNT, KEY, blob, 16));
+}
+
+TEST(shippedAssetMatchesRegistry) {
+    uint8_t key[BLOB_KEY_BYTES];
+    CHECK(decodeBlobKey(key, sizeof(key)));
+    if (assetPath == nullptr) {
+        printf("  no asset given, skipped\n");
+        return;
+    }
+    KeyBlob blob;
+    CHECK(blob.open(assetPath, key));
+    CHECK_EQ(static_cast<uint32_t>(APP_KEY_COUNT), blob.stats().entries);
+
+    const std::string_view names[] = {
+#define NAME_ENTRY(id, name, value) name,
+        BAKINGAPP_KEY_DEFINITIONS(NAME_ENTRY)
+#undef NAME_ENTRY
+    };
+    for (size_t id = 0; id < APP_KEY_COUNT; id++) {
+        char expected[maxKeyLength() + 1];
+        APP_KEYS.decode(APP_KEYS.find(id), expected, sizeof(expected));
+        char actual[MAX_BLOB_VALUE_LENGTH + 1];
+        size_t length = 0;
+        CHECK(blob.get(names[id], actual, sizeof(actual), &length));
+        CHECK(strcmp(expected, actual) == 0);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) assetPath = argv[1];
+    return bakingapp::test::runTests();
+}
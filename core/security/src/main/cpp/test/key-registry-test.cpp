@@ -0,0 +1,129 @@
+/**
+ * Host tests for the compile-time key registry
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include "keys/app-keys.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::keys;
+
+namespace {
+    constexpr KeyRegistry<3, 29> buildSmallRegistry() {
+        constexpr KeyDefinition definitions[] = {
+            {"alpha", "first_value"},
+            {"beta", "second"},
+            {"gamma", "hidden_value"},
+        };
+        return buildKeyRegistry<3, 29>(definitions);
+    }
+
+    constexpr auto SMALL = buildSmallRegistry();
+    static_assert(SMALL.valid, "small registry must build");
+
+    // Lookups are usable in constant expressions too
+    static_assert(SMALL.find(std::string_view("beta")) >= 0, "beta must resolve");
+    static_assert(SMALL.find(std::string_view("delta")) == decltype(SMALL)::NOT_FOUND,
+                  "unknown names must not resolve");
+
+    constexpr KeyRegistry<2, 2> buildDuplicateRegistry() {
+        constexpr KeyDefinition definitions[] = {{"same", "a"}, {"same", "b"}};
+        return buildKeyRegistry<2, 2>(definitions);
+    }
+    static_assert(!buildDuplicateRegistry().valid, "duplicate names must be rejected");
+
+    /**
+     * Builds "left_right" at run time, so expected values are never
+     * embedded in this binary as literals
+     */
+    const char* joined(const char* left, const char* right) {
+        static char buffer[64];
+        // volatile stops the compiler from folding the result into a literal
+        const char* volatile opaqueLeft = left;
+        const char* volatile opaqueRight = right;
+        snprintf(buffer, sizeof(buffer), "%s_%s", opaqueLeft, opaqueRight);
+        return buffer;
+    }
+
+    bool executableContains(const char* needle) {
+        FILE* f = fopen("/proc/self/exe", "rb");
+        if (f == nullptr) return false;
+        static char buffer[1 << 16];
+        const size_t needleLength = strlen(needle);
+        size_t carried = 0;
+        bool found = false;
+        while (!found) {
+            size_t n = fread(buffer + carried, 1, sizeof(buffer) - carried, f);
+            if (n == 0) break;
+            const size_t total = carried + n;
+            found = memmem(buffer, total, needle, needleLength) != nullptr;
+            carried = needleLength - 1 < total ? needleLength - 1 : total;
+            memmove(buffer, buffer + total - carried, carried);
+        }
+        fclose(f);
+        return found;
+    }
+}
+
+TEST(smallRegistryDecodesEveryKey) {
+    char out[32];
+    CHECK_EQ(11u, SMALL.decode(SMALL.find(std::string_view("alpha")), out, sizeof(out)));
+    CHECK(strcmp(out, joined("first", "value")) == 0);
+    SMALL.decode(SMALL.find(std::string_view("beta")), out, sizeof(out));
+    CHECK(strcmp(out, "second") == 0);
+    SMALL.decode(SMALL.find(static_cast<size_t>(2)), out, sizeof(out));
+    CHECK(strcmp(out, joined("hidden", "value")) == 0);
+}
+
+TEST(decodeRejectsShortBuffers) {
+    char out[6];
+    CHECK_EQ(0u, SMALL.decode(SMALL.find(std::string_view("beta")), out, sizeof(out)));
+    CHECK_EQ(6u, SMALL.decode(SMALL.find(std::string_view("beta")), out, 7) + 0 * sizeof(out));
+}
+
+TEST(plaintextNeverReachesTheBinary) {
+    CHECK(!executableContains(joined("hidden", "value")));
+    CHECK(!executableContains(joined("first", "value")));
+    CHECK(!executableContains(joined("bk_fake_api_key", "12345_demo")));
+}
+
+TEST(appKeysAreAPerfectHash) {
+    bool seen[APP_KEY_COUNT] = {};
+    for (size_t id = 0; id < APP_KEY_COUNT; id++) {
+        int32_t slot = APP_KEYS.find(id);
+        CHECK(slot >= 0 && static_cast<size_t>(slot) < APP_KEY_COUNT);
+        CHECK(!seen[slot]);
+        seen[slot] = true;
+    }
+}
+
+TEST(appKeysResolveByNameAndId) {
+    const std::string_view names[] = {
+#define NAME_ENTRY(id, name, value) name,
+        BAKINGAPP_KEY_DEFINITIONS(NAME_ENTRY)
+#undef NAME_ENTRY
+    };
+    char out[maxKeyLength() + 1];
+    for (size_t id = 0; id < APP_KEY_COUNT; id++) {
+        const int32_t slot = findKey(names[id]);
+        CHECK_EQ(APP_KEYS.find(id), slot);
+        CHECK(APP_KEYS.decode(slot, out, sizeof(out)) > 3);
+        // Same format rule as validateKeyFormatNative
+        CHECK(strncmp(out, "bk_", 3) == 0 || strncmp(out, "sk_", 3) == 0);
+    }
+    CHECK_EQ(-1, findKey("missing.key"));
+    CHECK_EQ(-1, findKey(""));
+    CHECK_EQ(-1, APP_KEYS.find(APP_KEY_COUNT));
+
+    APP_KEYS.decode(findKey(KeyId::API), out, sizeof(out));
+    CHECK(strncmp(out, "bk_", 3) == 0);
+    APP_KEYS.decode(findKey(KeyId::SECRET), out, sizeof(out));
+    CHECK(strncmp(out, "sk_", 3) == 0);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,152 @@
+/**
+ * Host tests for the network link emulator
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <sched.h>
+
+#include "network/link-emulator.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::network;
+
+namespace {
+    constexpr int64_t MILLIS = 1000 * 1000;
+
+    struct Released {
+        std::atomic<uint32_t> count {0};
+        std::atomic<uint32_t> lost {0};
+        uint64_t order[8] = {};
+    };
+
+    void recordRelease(uint64_t ticket, bool delivered, void* context) {
+        auto* released = static_cast<Released*>(context);
+        const uint32_t index = released->count.load();
+        if (index < 8) released->order[index] = ticket;
+        if (!delivered) released->lost.fetch_add(1);
+        released->count.store(index + 1);
+    }
+
+    LinkProfile latencyOnly(uint32_t millis) {
+        LinkProfile profile;
+        profile.latencyMicros = millis * 1000;
+        return profile;
+    }
+}
+
+TEST(latencyAndJitterBoundTheDeadline) {
+    LinkModel model;
+    LinkProfile profile;
+    profile.latencyMicros = 10000;
+    profile.jitterMicros = 5000;
+    model.configure(profile, 0);
+
+    bool jittered = false;
+    for (int i = 0; i < 1000; i++) {
+        const LinkPlan plan = model.plan(LinkDirection::UP, 100, 1000 * MILLIS);
+        CHECK(plan.delivered);
+        CHECK(plan.deadlineNanos >= 1010 * MILLIS);
+        CHECK(plan.deadlineNanos < 1015 * MILLIS);
+        jittered = jittered || plan.deadlineNanos != 1010 * MILLIS;
+    }
+    CHECK(jittered);
+}
+
+TEST(tokenBucketShapesEachDirection) {
+    LinkModel model;
+    LinkProfile profile;
+    profile.bytesPerSecond = 1000 * 1000;
+    profile.burstBytes = 64 * 1000;
+    model.configure(profile, 0);
+
+    // The burst goes out at once, the rest queues at the link rate
+    CHECK_EQ(0, model.plan(LinkDirection::DOWN, 64 * 1000, 0).deadlineNanos);
+    CHECK_EQ(100 * MILLIS, model.plan(LinkDirection::DOWN, 100 * 1000, 0).deadlineNanos);
+    CHECK_EQ(150 * MILLIS, model.plan(LinkDirection::DOWN, 50 * 1000, 0).deadlineNanos);
+    CHECK_EQ(0, model.plan(LinkDirection::UP, 1000, 0).deadlineNanos);
+
+    // Debt is paid off at 150 ms; a second later the bucket is full again
+    // but no fuller
+    CHECK_EQ(1150 * MILLIS, model.plan(LinkDirection::DOWN, 64 * 1000, 1150 * MILLIS).deadlineNanos);
+    CHECK_EQ(1151 * MILLIS, model.plan(LinkDirection::DOWN, 1000, 1150 * MILLIS).deadlineNanos);
+}
+
+TEST(lossCostsRetransmitsAndEventuallyFails) {
+    LinkModel model;
+    LinkProfile profile = latencyOnly(50);
+    model.configure(profile, 0);
+    LinkPlan plan = model.plan(LinkDirection::UP, 1 << 20, 0);
+    CHECK(plan.delivered);
+    CHECK_EQ(0u, plan.retransmits);
+
+    profile.lossPerMillion = 1000000;
+    model.configure(profile, 0);
+    plan = model.plan(LinkDirection::UP, 10, 0);
+    CHECK(!plan.delivered);
+    CHECK_EQ(MAX_RETRANSMITS, plan.retransmits);
+    // Each retransmission waits 2 round trips (200 ms here)
+    CHECK_EQ(50 * MILLIS + 3 * 200 * MILLIS, plan.deadlineNanos);
+
+    // 1% of 100 packets: about one retransmission per transfer
+    profile.lossPerMillion = 10000;
+    model.configure(profile, 0);
+    uint32_t retransmits = 0;
+    uint32_t failed = 0;
+    for (int i = 0; i < 1000; i++) {
+        plan = model.plan(LinkDirection::DOWN, 150000, 0);
+        retransmits += plan.retransmits;
+        failed += !plan.delivered;
+    }
+    CHECK(retransmits > 800 && retransmits < 1200);
+    CHECK_EQ(0u, failed);
+}
+
+TEST(timerThreadReleasesByDeadline) {
+    LinkEmulator emulator;
+    Released released;
+    CHECK(emulator.start(recordRelease, &released));
+
+    emulator.configure(latencyOnly(60));
+    const uint64_t slow = emulator.transfer(LinkDirection::UP, 100);
+    emulator.configure(latencyOnly(20));
+    const uint64_t fast = emulator.transfer(LinkDirection::UP, 100);
+    emulator.configure(latencyOnly(40));
+    const uint64_t middle = emulator.transfer(LinkDirection::UP, 100);
+    emulator.configure(latencyOnly(10));
+    const uint64_t cancelled = emulator.transfer(LinkDirection::UP, 100);
+    CHECK(slow != 0 && fast != 0 && middle != 0 && cancelled != 0);
+    CHECK(emulator.cancel(cancelled));
+    CHECK_EQ(3u, emulator.pending());
+
+    while (released.count.load() < 3) sched_yield();
+    CHECK_EQ(fast, released.order[0]);
+    CHECK_EQ(middle, released.order[1]);
+    CHECK_EQ(slow, released.order[2]);
+    CHECK(!emulator.cancel(slow));
+    CHECK_EQ(0u, emulator.pending());
+    emulator.stop();
+    CHECK_EQ(3u, released.count.load());
+}
+
+TEST(thousandsInFlightOnOneThread) {
+    LinkEmulator emulator;
+    Released released;
+    CHECK(emulator.start(recordRelease, &released));
+    LinkProfile profile = latencyOnly(20);
+    profile.jitterMicros = 30000;
+    profile.lossPerMillion = 1000000;
+    emulator.configure(profile);
+
+    const int64_t start = monotonicNanos();
+    for (int i = 0; i < 5000; i++) CHECK(emulator.transfer(LinkDirection::DOWN, 1000) != 0);
+    CHECK(emulator.pending() > 0);
+    while (released.count.load() < 5000) sched_yield();
+    CHECK_EQ(5000u, released.lost.load());
+    // 20-50 ms plus 3 retransmission timeouts, not 5000 of them in a row
+    CHECK(monotonicNanos() - start < 2000 * MILLIS);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,280 @@
+/**
+ * Host tests for native memory accounting: the tagged allocator, every
+ * subsystem's counters returning to where they started once its objects
+ * are gone, and the trim handlers
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "cache/response-cache.h"
+#include "common/native-memory.h"
+#include "common/thread-pool.h"
+#include "crypto/derived-key-cache.h"
+#include "image/image-resize.h"
+#include "keys/key-blob.h"
+#include "search/ingredient-index.h"
+#include "search/search-index.h"
+#include "store/secure-store.h"
+#include "strings/string-pool.h"
+#include "sync/delta-table.h"
+#include "telemetry/telemetry.h"
+#include "test/test-util.h"
+#include "timers/timer-table.h"
+
+using namespace bakingapp;
+
+namespace {
+    int64_t current(MemoryTag tag) {
+        return memoryUsage(tag).currentBytes;
+    }
+
+    uint64_t allocations(MemoryTag tag) {
+        return memoryUsage(tag).allocations;
+    }
+
+    size_t readMaster(uint8_t* out, size_t capacity, void* /* context */) {
+        const char secret[] = "memory-test-master";
+        if (capacity < sizeof(secret)) return 0;
+        memcpy(out, secret, sizeof(secret));
+        return sizeof(secret);
+    }
+
+    const uint8_t SALT[] = {1, 2, 3, 4};
+
+    struct Trimmed {
+        int calls;
+        int lastLevel;
+    };
+
+    void recordTrim(void* context, int level) {
+        auto* trimmed = static_cast<Trimmed*>(context);
+        trimmed->calls++;
+        trimmed->lastLevel = level;
+    }
+}
+
+TEST(taggedAllocatorCountsEveryBlock) {
+    const MemoryUsage before = memoryUsage(MemoryTag::RUNTIME);
+    void* block = taggedMalloc(MemoryTag::RUNTIME, 100);
+    CHECK(block != nullptr);
+    CHECK_EQ(before.currentBytes + 100, current(MemoryTag::RUNTIME));
+
+    // Grows in place or moves, and keeps its contents and tag either way
+    memset(block, 0x5A, 100);
+    block = taggedRealloc(MemoryTag::STRINGS, block, 4000);
+    CHECK(block != nullptr);
+    CHECK_EQ(0x5A, static_cast<uint8_t*>(block)[99]);
+    CHECK_EQ(before.currentBytes + 4000, current(MemoryTag::RUNTIME));
+    CHECK(memoryUsage(MemoryTag::RUNTIME).peakBytes >= before.currentBytes + 4000);
+
+    auto* zeroed = static_cast<uint32_t*>(taggedCalloc(MemoryTag::RUNTIME, 16, sizeof(uint32_t)));
+    CHECK(zeroed != nullptr);
+    for (size_t i = 0; i < 16; i++) CHECK_EQ(0u, zeroed[i]);
+    CHECK_EQ(before.currentBytes + 4064, current(MemoryTag::RUNTIME));
+
+    taggedFree(block);
+    taggedFree(zeroed);
+    taggedFree(nullptr);
+    CHECK_EQ(before.currentBytes, current(MemoryTag::RUNTIME));
+    CHECK_EQ(before.allocations + 3, allocations(MemoryTag::RUNTIME));
+
+    // An overflowing count is refused, not wrapped
+    CHECK(taggedCalloc(MemoryTag::RUNTIME, SIZE_MAX / 2, 4) == nullptr);
+    CHECK_EQ(before.currentBytes, current(MemoryTag::RUNTIME));
+}
+
+TEST(createTaggedCountsTheObject) {
+    const int64_t before = current(MemoryTag::INDEXES);
+    auto* index = createTagged<search::SearchIndex>(MemoryTag::INDEXES);
+    CHECK(index != nullptr);
+    CHECK(current(MemoryTag::INDEXES) >= before + static_cast<int64_t>(sizeof(*index)));
+    destroyTagged(index);
+    CHECK_EQ(before, current(MemoryTag::INDEXES));
+}
+
+TEST(subsystemsReturnToZeroOnTeardown) {
+    int64_t baseline[MEMORY_TAG_COUNT];
+    uint64_t made[MEMORY_TAG_COUNT];
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+        baseline[i] = current(static_cast<MemoryTag>(i));
+        made[i] = allocations(static_cast<MemoryTag>(i));
+    }
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "native-memory");
+    char path[320];
+    {
+        uint8_t key[keys::BLOB_KEY_BYTES] = {7};
+        const keys::KeyDefinition definitions[] = {{"api", "bk_memory_test"}};
+        uint8_t blob[256];
+        const size_t size = keys::encodeKeyBlob(definitions, 1, key, blob, sizeof(blob));
+        snprintf(path, sizeof(path), "%s/keys.blob", dir);
+        FILE* file = fopen(path, "wb");
+        fwrite(blob, 1, size, file);
+        fclose(file);
+        keys::KeyBlob keyBlob;
+        CHECK(keyBlob.open(path, key));
+        CHECK(current(MemoryTag::KEYS) > baseline[0]);
+
+        crypto::DerivedKeyCache derived(readMaster, nullptr, SALT, sizeof(SALT));
+        uint8_t mac[crypto::SHA256_BYTES];
+        CHECK(derived.sign("auth", 4, "session", 7, "body", 4, mac));
+
+        search::SearchIndex index;
+        const char* fields[search::SEARCH_FIELD_COUNT] = {"Lemon tart", "Sharp and sweet",
+                                                          "lemons butter sugar eggs", "Bake"};
+        size_t lengths[search::SEARCH_FIELD_COUNT];
+        for (size_t i = 0; i < search::SEARCH_FIELD_COUNT; i++) lengths[i] = strlen(fields[i]);
+        CHECK(index.add("tart", 4, fields, lengths));
+
+        search::IngredientIndex ingredients;
+        const char list[] = "flour\nbutter\nsugar";
+        CHECK(ingredients.setRecipe("shortbread", 10, list, sizeof(list) - 1));
+
+        snprintf(path, sizeof(path), "%s/responses", dir);
+        cache::ResponseCache responses;
+        CHECK(responses.open(path));
+        const char body[] = "{\"recipes\":[{\"id\":1,\"name\":\"Brownies\"}]}";
+        CHECK(responses.put(1, body, sizeof(body)));
+
+        uint8_t pixels[64 * 64 * 4] = {};
+        uint8_t scaled[16 * 16 * 4];
+        CHECK(image::resizeAreaAverage(image::ImageView{pixels, 64, 64, 64 * 4},
+                                       image::MutableImageView{scaled, 16, 16, 16 * 4}));
+
+        snprintf(path, sizeof(path), "%s/store.log", dir);
+        const uint8_t storeKey[store::STORE_KEY_BYTES] = {3};
+        store::SecureStore secureStore;
+        CHECK(secureStore.open(path, storeKey));
+        store::StoreTransaction transaction;
+        CHECK(transaction.put("token", 5, "abc", 3));
+        CHECK(secureStore.commit(transaction));
+
+        strings::StringPool pool;
+        CHECK(pool.intern("cups", 4) != strings::StringPool::NONE);
+
+        timers::TimerTable timers;
+        CHECK(timers.add(60, true, 0) >= 0);
+
+        snprintf(path, sizeof(path), "%s/delta.bin", dir);
+        sync::DeltaTable delta;
+        CHECK(delta.open(path));
+        sync::DeltaList changes;
+        const char json[] = "{\"recipes\":[{\"id\":\"1\",\"name\":\"Scones\"}]}";
+        CHECK(delta.diff(reinterpret_cast<const uint8_t*>(json), sizeof(json) - 1, "recipes",
+                         &changes));
+
+        snprintf(path, sizeof(path), "%s/telemetry.bin", dir);
+        telemetry::Telemetry telemetry;
+        CHECK(telemetry.start(path, 1));
+        telemetry.record(telemetry::EventType::KEY_FETCH);
+        telemetry.stop();
+
+        ThreadPool threads;
+        CHECK(threads.start(2));
+
+        for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+            if (allocations(static_cast<MemoryTag>(i)) == made[i]) {
+                printf("  no allocations for tag %zu\n", i);
+                CHECK(false);
+            }
+        }
+    }
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+        if (current(static_cast<MemoryTag>(i)) != baseline[i]) {
+            printf("  tag %zu: %lld bytes left\n", i,
+                   static_cast<long long>(current(static_cast<MemoryTag>(i)) - baseline[i]));
+            CHECK(false);
+        }
+    }
+}
+
+TEST(trimHandlersRunUntilRemoved) {
+    Trimmed first {};
+    Trimmed second {};
+    const uint32_t firstId = addTrimHandler(recordTrim, &first);
+    const uint32_t secondId = addTrimHandler(recordTrim, &second);
+    CHECK(firstId != 0 && secondId != 0 && firstId != secondId);
+
+    trimMemory(TRIM_MEMORY_RUNNING_LOW);
+    CHECK_EQ(1, first.calls);
+    CHECK_EQ(TRIM_MEMORY_RUNNING_LOW, second.lastLevel);
+
+    removeTrimHandler(firstId);
+    removeTrimHandler(0);
+    trimMemory(TRIM_MEMORY_COMPLETE);
+    CHECK_EQ(1, first.calls);
+    CHECK_EQ(2, second.calls);
+    CHECK_EQ(TRIM_MEMORY_COMPLETE, second.lastLevel);
+    removeTrimHandler(secondId);
+
+    // A full registry refuses, and the freed slot is handed out again
+    uint32_t ids[MAX_TRIM_HANDLERS];
+    uint32_t added = 0;
+    while (added < MAX_TRIM_HANDLERS) {
+        ids[added] = addTrimHandler(recordTrim, &first);
+        if (ids[added] == 0) break;
+        added++;
+    }
+    CHECK_EQ(0u, addTrimHandler(recordTrim, &first));
+    removeTrimHandler(ids[0]);
+    const uint32_t reused = addTrimHandler(recordTrim, &first);
+    CHECK_EQ(ids[0], reused);
+    for (uint32_t i = 0; i < added; i++) removeTrimHandler(ids[i]);
+}
+
+TEST(trimReleasesResponseStreams) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "native-memory-trim");
+    cache::ResponseCache responses;
+    CHECK(responses.open(dir));
+    const char body[] = "{\"recipes\":[{\"id\":2,\"name\":\"Focaccia\"}]}";
+    CHECK(responses.put(2, body, sizeof(body)));
+    char out[sizeof(body)];
+    CHECK(responses.read(2, out, sizeof(out)));
+
+    // Still visible: the zlib state is dropped only once the UI is hidden
+    CHECK_EQ(0, trimMemory(TRIM_MEMORY_RUNNING_MODERATE));
+    const int64_t withStreams = current(MemoryTag::CACHES);
+    const int64_t released = trimMemory(TRIM_MEMORY_UI_HIDDEN);
+    CHECK(released > 256 * 1024);
+    CHECK_EQ(withStreams - released, current(MemoryTag::CACHES));
+
+    // And set up again on the next use
+    memset(out, 0, sizeof(out));
+    CHECK(responses.read(2, out, sizeof(out)));
+    CHECK(memcmp(out, body, sizeof(body)) == 0);
+    CHECK_EQ(withStreams, current(MemoryTag::CACHES));
+}
+
+TEST(trimWipesDecryptedKeys) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "native-memory-keys");
+    char path[320];
+    snprintf(path, sizeof(path), "%s/keys.blob", dir);
+    uint8_t key[keys::BLOB_KEY_BYTES] = {9};
+    const keys::KeyDefinition definitions[] = {{"api", "bk_trim_test"}};
+    uint8_t blob[256];
+    const size_t size = keys::encodeKeyBlob(definitions, 1, key, blob, sizeof(blob));
+    FILE* file = fopen(path, "wb");
+    fwrite(blob, 1, size, file);
+    fclose(file);
+
+    keys::KeyBlob keyBlob;
+    CHECK(keyBlob.open(path, key));
+    char value[keys::MAX_BLOB_VALUE_LENGTH + 1];
+    size_t length = 0;
+    CHECK(keyBlob.get("api", value, sizeof(value), &length));
+    trimMemory(TRIM_MEMORY_UI_HIDDEN);
+    CHECK_EQ(1u, keyBlob.stats().cached);
+    trimMemory(TRIM_MEMORY_BACKGROUND);
+    CHECK_EQ(0u, keyBlob.stats().cached);
+    CHECK(keyBlob.get("api", value, sizeof(value), &length));
+    CHECK(strcmp(value, "bk_trim_test") == 0);
+    CHECK_EQ(2u, keyBlob.stats().decrypts);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
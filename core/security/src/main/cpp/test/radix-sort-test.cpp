@@ -0,0 +1,151 @@
+/**
+ * Host tests for the packed-key sort: each path against std::sort, signed
+ * keys, the mostly-sorted merge and top-K
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "sort/radix-sort.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::sort;
+using bakingapp::bench::Random;
+
+namespace {
+    struct Buffers {
+        int64_t* values;
+        int64_t* expected;
+        int64_t* scratch;
+
+        explicit Buffers(size_t count)
+            : values(static_cast<int64_t*>(malloc(sizeof(int64_t) * (count + 1)))),
+              expected(static_cast<int64_t*>(malloc(sizeof(int64_t) * (count + 1)))),
+              scratch(static_cast<int64_t*>(malloc(sizeof(int64_t) * (count + 1)))) {}
+
+        ~Buffers() {
+            free(values);
+            free(expected);
+            free(scratch);
+        }
+    };
+
+    /**
+     * Sorts values with sortValues() and checks the result and the path
+     */
+    void checkSort(int64_t* values, size_t count, SortPath expectedPath) {
+        Buffers buffers(count);
+        memcpy(buffers.expected, values, count * sizeof(int64_t));
+        std::sort(buffers.expected, buffers.expected + count);
+        CHECK_EQ(static_cast<int>(expectedPath), static_cast<int>(sortValues(values, count, buffers.scratch)));
+        CHECK(memcmp(values, buffers.expected, count * sizeof(int64_t)) == 0);
+    }
+}
+
+TEST(radixSortMatchesStdSort) {
+    Random random(1);
+    const size_t SIZES[] = {0, 1, 2, 63, 64, 65, 1000, 100000};
+    for (size_t count : SIZES) {
+        Buffers buffers(count);
+        // Full-width signed values, then small keys that skip most passes
+        for (int narrow = 0; narrow < 2; narrow++) {
+            for (size_t i = 0; i < count; i++) {
+                const uint64_t bits = random.next();
+                buffers.values[i] = narrow != 0 ? static_cast<int64_t>(bits % 5000) - 2500
+                                                : static_cast<int64_t>(bits);
+            }
+            memcpy(buffers.expected, buffers.values, count * sizeof(int64_t));
+            std::sort(buffers.expected, buffers.expected + count);
+            radixSort(buffers.values, count, buffers.scratch);
+            CHECK(memcmp(buffers.values, buffers.expected, count * sizeof(int64_t)) == 0);
+        }
+    }
+
+    int64_t extremes[] = {INT64_MAX, 0, -1, INT64_MIN, 1, INT64_MIN + 1, INT64_MAX - 1};
+    int64_t scratch[7];
+    radixSort(extremes, 7, scratch);
+    CHECK_EQ(INT64_MIN, extremes[0]);
+    CHECK_EQ(-1, extremes[2]);
+    CHECK_EQ(INT64_MAX, extremes[6]);
+}
+
+TEST(takesTheCheapestPath) {
+    constexpr size_t COUNT = 10000;
+    Buffers buffers(COUNT);
+    int64_t* values = buffers.values;
+
+    for (size_t i = 0; i < COUNT; i++) values[i] = static_cast<int64_t>(i) * 3;
+    checkSort(values, COUNT, SortPath::SORTED);
+
+    for (size_t i = 0; i < COUNT; i++) values[i] = -static_cast<int64_t>(i);
+    checkSort(values, COUNT, SortPath::REVERSED);
+
+    // Ties are not descents
+    for (size_t i = 0; i < COUNT; i++) values[i] = static_cast<int64_t>(i / 10);
+    checkSort(values, COUNT, SortPath::SORTED);
+
+    int64_t small[] = {5, 3, 9, 1, 3};
+    checkSort(small, 5, SortPath::INSERTION);
+
+    Random random(2);
+    for (size_t i = 0; i < COUNT; i++) values[i] = static_cast<int64_t>(random.next() >> 1);
+    checkSort(values, COUNT, SortPath::RADIX);
+}
+
+TEST(mergesMostlySortedInput) {
+    constexpr size_t COUNT = 10000;
+    Buffers buffers(COUNT);
+    int64_t* values = buffers.values;
+    Random random(3);
+
+    // A sorted list with a few values changed, and one appended at the end
+    // that belongs at the front
+    for (size_t i = 0; i < COUNT; i++) values[i] = static_cast<int64_t>(i) * 10;
+    for (int changed = 0; changed < 50; changed++) {
+        values[random.below(COUNT)] = static_cast<int64_t>(random.below(COUNT * 10));
+    }
+    values[COUNT - 1] = -5;
+    checkSort(values, COUNT, SortPath::MERGED);
+
+    // Displaced values beyond the limit fall back to a full sort
+    for (size_t i = 0; i < COUNT; i++) values[i] = static_cast<int64_t>(i) * 10;
+    for (size_t i = 0; i < COUNT; i += MOSTLY_SORTED_DIVISOR / 2) values[i] = -static_cast<int64_t>(i);
+    checkSort(values, COUNT, SortPath::RADIX);
+
+    // More displaced values than SMALL_SORT are radix sorted in the hole
+    for (size_t i = 0; i < COUNT; i++) values[i] = static_cast<int64_t>(i) * 10;
+    for (size_t i = 1; i < COUNT; i += MOSTLY_SORTED_DIVISOR * 2) {
+        values[i] = static_cast<int64_t>(random.below(COUNT * 10));
+    }
+    checkSort(values, COUNT, SortPath::MERGED);
+}
+
+TEST(topKMatchesPartialSort) {
+    constexpr size_t COUNT = 50000;
+    Buffers buffers(COUNT);
+    Random random(4);
+    for (size_t i = 0; i < COUNT; i++) {
+        buffers.values[i] = static_cast<int64_t>(random.next());
+        buffers.expected[i] = buffers.values[i];
+    }
+    std::sort(buffers.expected, buffers.expected + COUNT);
+
+    const size_t KS[] = {1, 2, 10, 100, 5000, COUNT};
+    for (size_t k : KS) {
+        CHECK_EQ(k, smallestValues(buffers.values, COUNT, k, buffers.scratch));
+        CHECK(memcmp(buffers.scratch, buffers.expected, k * sizeof(int64_t)) == 0);
+    }
+    CHECK_EQ(0u, smallestValues(buffers.values, COUNT, 0, buffers.scratch));
+    int64_t three[] = {7, -2, 4};
+    int64_t out[3];
+    CHECK_EQ(3u, smallestValues(three, 3, 10, out));
+    CHECK_EQ(-2, out[0]);
+    CHECK_EQ(7, out[2]);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
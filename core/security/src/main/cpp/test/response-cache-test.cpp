@@ -0,0 +1,232 @@
+/**
+ * Host tests for the offline response cache and its dictionary trainer
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bench/recipe-corpus.h"
+#include "cache/dictionary-trainer.h"
+#include "cache/response-cache.h"
+#include "test/test-util.h"
+
+using namespace bakingapp;
+using namespace bakingapp::cache;
+
+namespace {
+    constexpr size_t PAGE_CAPACITY = 128 * 1024;
+
+    struct Page {
+        explicit Page(uint32_t index, uint32_t pageSize = 5) {
+            bench::Random random(index + 1);
+            data = static_cast<char*>(malloc(PAGE_CAPACITY));
+            size = bench::makeRecipeListJson(random, index, pageSize, data, PAGE_CAPACITY);
+        }
+        ~Page() { free(data); }
+
+        char* data;
+        size_t size;
+    };
+
+    bool readMatches(ResponseCache& cache, uint64_t key, const Page& page) {
+        uint32_t rawSize = 0;
+        if (!cache.lookup(key, &rawSize) || rawSize != page.size) return false;
+        auto* buffer = static_cast<char*>(malloc(rawSize));
+        bool ok = cache.read(key, buffer, rawSize) && memcmp(buffer, page.data, rawSize) == 0;
+        free(buffer);
+        return ok;
+    }
+}
+
+TEST(trainerBuildsDictionaryWithinCapacity) {
+    Page a(0), b(1), c(2);
+    const uint8_t* samples[] = {reinterpret_cast<uint8_t*>(a.data),
+                                reinterpret_cast<uint8_t*>(b.data),
+                                reinterpret_cast<uint8_t*>(c.data)};
+    const size_t sizes[] = {a.size, b.size, c.size};
+    uint8_t dictionary[4096];
+    const size_t size = trainDictionary(samples, sizes, 3, dictionary, sizeof(dictionary));
+    CHECK(size > 0);
+    CHECK(size <= sizeof(dictionary));
+    // Field names shared by every page must make it in
+    CHECK(memmem(dictionary, size, "\"unit\":\"", 8) != nullptr ||
+          memmem(dictionary, size, "\"quantity\":", 11) != nullptr);
+
+    const char tiny[] = "{}";
+    const uint8_t* tinySamples[] = {reinterpret_cast<const uint8_t*>(tiny)};
+    const size_t tinySizes[] = {2};
+    CHECK_EQ(0u, trainDictionary(tinySamples, tinySizes, 1, dictionary, sizeof(dictionary)));
+}
+
+TEST(roundTripsAndPersists) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "response-cache");
+    Page page(7);
+    const uint64_t key = ResponseCache::keyFor("recipes?page=1", 14);
+    {
+        ResponseCache cache;
+        CHECK(cache.open(dir));
+        CHECK(cache.put(key, page.data, page.size));
+        CHECK(readMatches(cache, key, page));
+        CHECK(!cache.lookup(key + 1, nullptr));
+    }
+    ResponseCache reopened;
+    CHECK(reopened.open(dir));
+    CHECK(readMatches(reopened, key, page));
+    ResponseCacheStats stats = reopened.stats();
+    CHECK_EQ(1u, stats.entries);
+    CHECK(stats.compressedBytes < page.size / 3);
+}
+
+TEST(rejectsShortBuffers) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "response-short");
+    ResponseCache cache;
+    CHECK(cache.open(dir));
+    Page page(1);
+    CHECK(cache.put(1, page.data, page.size));
+    char small[16];
+    CHECK(!cache.read(1, small, sizeof(small)));
+    CHECK(readMatches(cache, 1, page));
+}
+
+TEST(identicalBodiesShareOneRecord) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "response-dedup");
+    ResponseCache cache;
+    CHECK(cache.open(dir));
+    Page page(3);
+    CHECK(cache.put(1, page.data, page.size));
+    const uint64_t fileBytes = cache.stats().fileBytes;
+    CHECK(cache.put(2, page.data, page.size));
+    CHECK_EQ(fileBytes, cache.stats().fileBytes);
+    CHECK_EQ(2u, cache.stats().entries);
+    CHECK(readMatches(cache, 2, page));
+}
+
+TEST(trainsDictionaryFromEarlyResponses) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "response-dict");
+    ResponseCache cache;
+    CHECK(cache.open(dir));
+    for (uint32_t i = 0; i < ResponseCache::TRAINING_SAMPLES; i++) {
+        Page page(i);
+        CHECK(cache.put(100 + i, page.data, page.size));
+    }
+    const uint32_t dictionaryId = cache.stats().dictionaryId;
+    CHECK(dictionaryId != 0);
+
+    // Records from before training stay readable, new ones shrink
+    Page first(0);
+    CHECK(readMatches(cache, 100, first));
+    Page later(50, 1);
+    const uint64_t before = cache.stats().fileBytes;
+    CHECK(cache.put(200, later.data, later.size));
+    const uint64_t withDictionary = cache.stats().fileBytes - before;
+
+    char plainDir[256];
+    test::makeTempDir(plainDir, sizeof(plainDir), "response-plain");
+    ResponseCache plain;
+    CHECK(plain.open(plainDir));
+    const uint64_t plainBefore = plain.stats().fileBytes;
+    CHECK(plain.put(200, later.data, later.size));
+    const uint64_t withoutDictionary = plain.stats().fileBytes - plainBefore;
+    CHECK(withDictionary < withoutDictionary);
+
+    cache.close();
+    ResponseCache reopened;
+    CHECK(reopened.open(dir));
+    CHECK_EQ(dictionaryId, reopened.stats().dictionaryId);
+    CHECK(readMatches(reopened, 200, later));
+}
+
+TEST(corruptRecordsAreDropped) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "response-corrupt");
+    Page page(4);
+    {
+        ResponseCache cache;
+        CHECK(cache.open(dir));
+        CHECK(cache.put(9, page.data, page.size));
+    }
+
+    char path[300];
+    snprintf(path, sizeof(path), "%s/responses.dat", dir);
+    int fd = open(path, O_RDWR);
+    CHECK(fd >= 0);
+    const off_t middle = static_cast<off_t>(lseek(fd, 0, SEEK_END) / 2);
+    uint8_t byte = 0;
+    CHECK(pread(fd, &byte, 1, middle) == 1);
+    byte ^= 0x5A;
+    CHECK(pwrite(fd, &byte, 1, middle) == 1);
+    close(fd);
+
+    ResponseCache cache;
+    CHECK(cache.open(dir));
+    auto* buffer = static_cast<char*>(malloc(page.size));
+    CHECK(!cache.read(9, buffer, page.size));
+    CHECK(!cache.lookup(9, nullptr));
+    free(buffer);
+}
+
+TEST(compactionReclaimsOverwrittenRecords) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "response-compact");
+    ResponseCache cache;
+    CHECK(cache.open(dir));
+    for (uint32_t i = 0; i < 20; i++) {
+        Page page(i);
+        CHECK(cache.put(1, page.data, page.size));
+    }
+    Page keep(40);
+    CHECK(cache.put(2, keep.data, keep.size));
+
+    const ResponseCacheStats before = cache.stats();
+    CHECK(cache.compact());
+    const ResponseCacheStats after = cache.stats();
+    CHECK(after.fileBytes < before.fileBytes);
+    CHECK_EQ(after.compressedBytes, after.fileBytes);
+    CHECK(readMatches(cache, 2, keep));
+    Page last(19);
+    CHECK(readMatches(cache, 1, last));
+
+    cache.close();
+    ResponseCache reopened;
+    CHECK(reopened.open(dir));
+    CHECK(readMatches(reopened, 2, keep));
+}
+
+TEST(evictsLeastRecentlyUsedWhenFull) {
+    char dir[256];
+    test::makeTempDir(dir, sizeof(dir), "response-evict");
+    ResponseCache cache;
+    CHECK(cache.open(dir, 16));
+
+    // Distinct bodies so every key gets its own record
+    Page page(0, 1);
+    auto putVariant = [&](uint64_t key) {
+        page.data[page.size - 2] = static_cast<char>('a' + key);
+        return cache.put(key, page.data, page.size);
+    };
+    for (uint64_t key = 1; key <= 12; key++) CHECK(putVariant(key));
+    CHECK_EQ(12u, cache.stats().entries);
+
+    char* buffer = static_cast<char*>(malloc(page.size));
+    CHECK(cache.read(1, buffer, page.size));
+    free(buffer);
+
+    // The 13th entry crosses 3/4 load and drops the oldest quarter (2..5)
+    CHECK(putVariant(13));
+    CHECK_EQ(9u, cache.stats().entries);
+    CHECK(cache.lookup(1, nullptr));
+    CHECK(!cache.lookup(2, nullptr));
+    CHECK(!cache.lookup(5, nullptr));
+    CHECK(cache.lookup(6, nullptr));
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,152 @@
+/**
+ * Host tests for the recipe text analyzer and BM25 search index
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "search/search-index.h"
+#include "search/text-analyzer.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::search;
+
+namespace {
+    /**
+     * Analyzes text and joins its stems with spaces
+     */
+    const char* analyze(const char* text) {
+        static char out[256];
+        size_t length = 0;
+        char term[MAX_TERM_LENGTH];
+        TermReader reader(text, strlen(text));
+        for (size_t n; (n = reader.next(term)) > 0;) {
+            n = stemTerm(term, n);
+            if (length > 0) out[length++] = ' ';
+            memcpy(out + length, term, n);
+            length += n;
+        }
+        out[length] = '\0';
+        return out;
+    }
+
+    bool add(SearchIndex& index, const char* id, const char* name, const char* description,
+             const char* ingredients, const char* steps) {
+        const char* fields[SEARCH_FIELD_COUNT] = {name, description, ingredients, steps};
+        size_t lengths[SEARCH_FIELD_COUNT];
+        for (size_t i = 0; i < SEARCH_FIELD_COUNT; i++) {
+            lengths[i] = fields[i] != nullptr ? strlen(fields[i]) : 0;
+        }
+        return index.add(id, strlen(id), fields, lengths);
+    }
+
+    /**
+     * Searches and joins the hit ids with spaces
+     */
+    const char* search(SearchIndex& index, const char* query, bool prefixLast = false) {
+        static char out[256];
+        SearchHit hits[8];
+        const size_t count = index.search(query, strlen(query), prefixLast, hits, 8);
+        size_t length = 0;
+        for (size_t i = 0; i < count; i++) {
+            size_t n = 0;
+            const char* id = index.documentId(hits[i].document, &n);
+            if (length > 0) out[length++] = ' ';
+            memcpy(out + length, id, n);
+            length += n;
+        }
+        out[length] = '\0';
+        return out;
+    }
+
+    void addRecipes(SearchIndex& index) {
+        add(index, "soup", "Tomato Soup", "A warm soup for winter.",
+            "tomatoes\nonion\nvegetable stock", "Chop the onion.\nSimmer everything.");
+        add(index, "pie", "Apple Pie", "Flaky pastry with apples.",
+            "apples\nflour\nbutter\nsugar", "Rub the butter into the flour.\nBake until golden.");
+        add(index, "salad", "Summer Salad", "Crisp and fresh.",
+            "lettuce\ncucumber\nolive oil", "Toss with a tomato dressing.");
+        add(index, "brulee", "Crème Brûlée", "Baked custard under burnt sugar.",
+            "cream\neggs\nsugar\nvanilla", "Baking in a water bath keeps it smooth.");
+    }
+}
+
+TEST(foldsCaseAndAccents) {
+    CHECK(strcmp(analyze("TOMATO Soup"), "tomato soup") == 0);
+    CHECK(strcmp(analyze("Crème BRÛLÉE, piña"), "crem brule pina") == 0);
+    CHECK(strcmp(analyze("baker's  half-and-half"), "baker half and half") == 0);
+    CHECK(strcmp(analyze("ŁÓDŹ Ωμέγα ПИРОГ"), "łodź ωμέγα пирог") == 0);
+    CHECK(strcmp(analyze("—!?"), "") == 0);
+
+    char term[MAX_TERM_LENGTH];
+    const char* longWord = "supercalifragilisticexpialidociousness and";
+    TermReader reader(longWord, strlen(longWord));
+    CHECK_EQ(MAX_TERM_LENGTH, reader.next(term));
+    CHECK_EQ(3u, reader.next(term));
+    CHECK(reader.atEnd());
+}
+
+TEST(stemsCookingWords) {
+    CHECK(strcmp(analyze("tomatoes tomato Tomato"), "tomato tomato tomato") == 0);
+    CHECK(strcmp(analyze("berries berry"), "berry berry") == 0);
+    CHECK(strcmp(analyze("cookies cookie pies pie"), "cooki cooki pie pie") == 0);
+    CHECK(strcmp(analyze("bake baked baking"), "bak bak bak") == 0);
+    CHECK(strcmp(analyze("chopped chopping chop"), "chop chop chop") == 0);
+    CHECK(strcmp(analyze("peaches leaves eggs glass"), "peach leaf egg glass") == 0);
+    CHECK(strcmp(analyze("fried dried rolled"), "fry dry roll") == 0);
+}
+
+TEST(ranksByBm25AcrossFields) {
+    SearchIndex index;
+    addRecipes(index);
+    CHECK_EQ(4u, index.stats().documents);
+
+    // A name match outranks the same word in a step
+    CHECK(strcmp(search(index, "tomatoes"), "soup salad") == 0);
+    // Ingredient names are indexed
+    CHECK(strcmp(search(index, "cucumber"), "salad") == 0);
+    // Rarer words weigh more: "vanilla" only appears once
+    CHECK(strcmp(search(index, "sugar vanilla"), "brulee pie") == 0);
+    CHECK(strcmp(search(index, "creme brulee"), "brulee") == 0);
+    CHECK(strcmp(search(index, "baked"), "brulee pie") == 0);
+    CHECK(strcmp(search(index, "chocolate"), "") == 0);
+    CHECK(strcmp(search(index, ""), "") == 0);
+}
+
+TEST(matchesPartlyTypedLastWord) {
+    SearchIndex index;
+    addRecipes(index);
+    CHECK(strcmp(search(index, "cucu"), "") == 0);
+    CHECK(strcmp(search(index, "cucu", true), "salad") == 0);
+    CHECK(strcmp(search(index, "fresh cucu", true), "salad") == 0);
+    // A finished word is not expanded
+    CHECK(strcmp(search(index, "cucu ", true), "") == 0);
+}
+
+TEST(replacesAndRemovesDocuments) {
+    SearchIndex index;
+    addRecipes(index);
+    CHECK(add(index, "soup", "Pumpkin Soup", nullptr, "pumpkin", nullptr));
+    CHECK(strcmp(search(index, "tomato"), "salad") == 0);
+    CHECK(strcmp(search(index, "pumpkin"), "soup") == 0);
+    CHECK_EQ(4u, index.stats().documents);
+    CHECK_EQ(1u, index.stats().dead);
+
+    CHECK(index.remove("salad", 5));
+    CHECK(!index.remove("salad", 5));
+    CHECK(!index.remove("missing", 7));
+    CHECK(strcmp(search(index, "tomato"), "") == 0);
+    CHECK_EQ(3u, index.stats().documents);
+
+    CHECK(!add(index, "", "Empty id", nullptr, nullptr, nullptr));
+    index.clear();
+    CHECK_EQ(0u, index.stats().documents);
+    CHECK_EQ(0u, index.stats().terms);
+    CHECK(strcmp(search(index, "pumpkin"), "") == 0);
+    CHECK(add(index, "soup", "Pumpkin Soup", nullptr, nullptr, nullptr));
+    CHECK(strcmp(search(index, "pumpkin"), "soup") == 0);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
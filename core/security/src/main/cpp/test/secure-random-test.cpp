@@ -0,0 +1,181 @@
+/**
+ * Host tests for the per-thread ChaCha20 generator: the SIMD key stream,
+ * the FIPS 140-2 tests, reseeding and fork safety
+ */
+
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "crypto/chacha20-poly1305.h"
+#include "crypto/secure-random.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::crypto;
+
+namespace {
+    bool allZero(const uint8_t* bytes, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            if (bytes[i] != 0) return false;
+        }
+        return true;
+    }
+
+    /**
+     * A sample that passes, retried once: good output fails about once in
+     * ten thousand
+     */
+    void passingSample(uint8_t* sample) {
+        for (int attempt = 0; attempt < 2; attempt++) {
+            CHECK(randomBytes(sample, FIPS_SAMPLE_BYTES));
+            if (passesFipsTests(sample)) return;
+        }
+        CHECK(false);
+    }
+
+    void* drawFromThread(void* out) {
+        randomBytes(static_cast<uint8_t*>(out), 64);
+        return nullptr;
+    }
+}
+
+TEST(blocksMatchTheScalarKeyStream) {
+    uint8_t key[CHACHA20_KEY_BYTES];
+    uint8_t nonce[CHACHA20_NONCE_BYTES];
+    for (size_t i = 0; i < sizeof(key); i++) key[i] = static_cast<uint8_t>(i * 31 + 7);
+    for (size_t i = 0; i < sizeof(nonce); i++) nonce[i] = static_cast<uint8_t>(i * 17 + 3);
+
+    // Every tail length, and a counter that wraps inside a SIMD group
+    uint8_t blocks[11 * CHACHA20_BLOCK_BYTES];
+    uint8_t single[CHACHA20_BLOCK_BYTES];
+    constexpr uint32_t COUNTERS[] = {0, 1, 0xFFFFFFFD};
+    for (uint32_t counter : COUNTERS) {
+        for (size_t count = 0; count <= 11; count++) {
+            memset(blocks, 0xAA, sizeof(blocks));
+            chacha20Blocks(key, counter, nonce, blocks, count);
+            for (size_t b = 0; b < count; b++) {
+                chacha20Block(key, counter + static_cast<uint32_t>(b), nonce, single);
+                CHECK(memcmp(single, blocks + b * CHACHA20_BLOCK_BYTES, sizeof(single)) == 0);
+            }
+            // Nothing written past count blocks
+            for (size_t i = count * CHACHA20_BLOCK_BYTES; i < sizeof(blocks); i++) {
+                CHECK_EQ(0xAA, blocks[i]);
+            }
+        }
+    }
+}
+
+TEST(fipsTestsRejectBiasedSamples) {
+    uint8_t sample[FIPS_SAMPLE_BYTES];
+    passingSample(sample);
+
+    // Monobit
+    uint8_t biased[FIPS_SAMPLE_BYTES];
+    memset(biased, 0, sizeof(biased));
+    CHECK(!passesFipsTests(biased));
+
+    // Balanced bits but only two nibble values, and every run of length 1
+    memset(biased, 0x55, sizeof(biased));
+    CHECK(!passesFipsTests(biased));
+
+    // A long run in otherwise good output
+    memcpy(biased, sample, sizeof(biased));
+    memset(biased + 1000, 0xFF, 4);
+    biased[999] &= 0xFE;
+    biased[1004] &= 0x7F;
+    CHECK(!passesFipsTests(biased));
+
+    CHECK(randomSelfTest());
+}
+
+TEST(fillsEverySizeWithFreshBytes) {
+    uint8_t previous[600] = {};
+    uint8_t out[600];
+    for (size_t length = 1; length <= sizeof(out); length++) {
+        CHECK(randomBytes(out, length));
+        if (length >= 16) {
+            CHECK(!allZero(out, length));
+            CHECK(memcmp(out, previous, length) != 0);
+        }
+        memcpy(previous, out, length);
+    }
+    CHECK(randomBytes(out, 0));
+
+    // Bulk requests, whole blocks and not, pass the statistical tests
+    const size_t bulk = 3 * RESEED_BYTES + 17;
+    auto* large = static_cast<uint8_t*>(malloc(bulk));
+    const RandomStats before = randomStats();
+    CHECK(randomBytes(large, bulk));
+    CHECK(!allZero(large + bulk - 16, 16));
+    const RandomStats after = randomStats();
+    CHECK(after.generatedBytes - before.generatedBytes >= bulk);
+    CHECK(after.reseeds - before.reseeds >= 2);
+    bool passed = false;
+    for (size_t offset = 0; offset + FIPS_SAMPLE_BYTES <= bulk && !passed;
+         offset += RESEED_BYTES) {
+        passed = passesFipsTests(large + offset);
+    }
+    CHECK(passed);
+    free(large);
+}
+
+TEST(reseedsOnTheByteBudget) {
+    uint8_t out[128];
+    CHECK(randomBytes(out, sizeof(out)));
+    const uint64_t before = randomStats().reseeds;
+    for (size_t total = 0; total <= RESEED_BYTES; total += sizeof(out)) {
+        CHECK(randomBytes(out, sizeof(out)));
+    }
+    CHECK(randomStats().reseeds > before);
+}
+
+TEST(threadsDrawIndependentStreams) {
+    uint8_t first[64];
+    uint8_t second[64];
+    const uint64_t before = randomStats().reseeds;
+    pthread_t a;
+    pthread_t b;
+    pthread_create(&a, nullptr, drawFromThread, first);
+    pthread_create(&b, nullptr, drawFromThread, second);
+    pthread_join(a, nullptr);
+    pthread_join(b, nullptr);
+    CHECK(memcmp(first, second, sizeof(first)) != 0);
+    CHECK_EQ(before + 2, randomStats().reseeds);    // each seeded its own
+}
+
+TEST(childReseedsAfterFork) {
+    uint8_t out[32];
+    CHECK(randomBytes(out, sizeof(out)));
+
+    // Without the fork hook the child would hand out the parent's next bytes
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    const pid_t child = fork();
+    if (child == 0) {
+        uint8_t message[sizeof(out) + 1];
+        randomBytes(message, sizeof(out));
+        message[sizeof(out)] = static_cast<uint8_t>(randomStats().forkReseeds);
+        const bool written = write(fds[1], message, sizeof(message)) == sizeof(message);
+        _exit(written ? 0 : 1);
+    }
+    CHECK(child > 0);
+    CHECK(randomBytes(out, sizeof(out)));
+    uint8_t message[sizeof(out) + 1] = {};
+    CHECK(read(fds[0], message, sizeof(message)) == static_cast<ssize_t>(sizeof(message)));
+    int status = 0;
+    waitpid(child, &status, 0);
+    close(fds[0]);
+    close(fds[1]);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    CHECK(memcmp(out, message, sizeof(out)) != 0);
+    CHECK(message[sizeof(out)] >= 1);
+    CHECK_EQ(0u, randomStats().forkReseeds);       // the parent kept its stream
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
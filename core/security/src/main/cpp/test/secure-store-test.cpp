@@ -0,0 +1,270 @@
+/**
+ * Host tests for the transactional secure store: atomic commits, replay,
+ * torn and foreign records, group commit from many threads and compaction
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "store/secure-store.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::store;
+
+namespace {
+    constexpr int THREADS = 8;
+    constexpr int COMMITS_PER_THREAD = 50;
+
+    const uint8_t KEY[STORE_KEY_BYTES] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+                                          17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30,
+                                          31, 32};
+
+    void storePath(char* out, size_t size, const char* prefix) {
+        char dir[256];
+        bakingapp::test::makeTempDir(dir, sizeof(dir), prefix);
+        snprintf(out, size, "%s/secure.store", dir);
+    }
+
+    bool put(StoreTransaction& transaction, const char* key, const char* value) {
+        return transaction.put(key, strlen(key), value, strlen(value));
+    }
+
+    /**
+     * True if key holds exactly value
+     */
+    bool holds(SecureStore& store, const char* key, const char* value) {
+        char out[256];
+        size_t length = 0;
+        if (!store.get(key, strlen(key), reinterpret_cast<uint8_t*>(out), sizeof(out), &length)) {
+            return false;
+        }
+        return length == strlen(value) && memcmp(out, value, length) == 0;
+    }
+
+    bool absent(SecureStore& store, const char* key) {
+        size_t length = 0;
+        return !store.get(key, strlen(key), nullptr, 0, &length);
+    }
+
+    off_t fileSize(const char* path) {
+        struct stat st {};
+        return stat(path, &st) == 0 ? st.st_size : -1;
+    }
+
+    struct Committer {
+        SecureStore* store;
+        int thread;
+        int failures;
+    };
+
+    void* commitMany(void* argument) {
+        auto* committer = static_cast<Committer*>(argument);
+        for (int i = 0; i < COMMITS_PER_THREAD; i++) {
+            char key[32];
+            char value[32];
+            snprintf(key, sizeof(key), "t%d-k%d", committer->thread, i);
+            snprintf(value, sizeof(value), "v%d", i);
+            StoreTransaction transaction;
+            put(transaction, key, value);
+            put(transaction, "shared", key);
+            if (!committer->store->commit(transaction)) committer->failures++;
+        }
+        return nullptr;
+    }
+}
+
+TEST(commitsWholeTransactionsAndReplaysThem) {
+    char path[512];
+    storePath(path, sizeof(path), "secure-store-replay");
+    {
+        SecureStore store;
+        CHECK(store.open(path, KEY));
+        StoreTransaction login;
+        CHECK(put(login, "access_token", "eyJhbGciOi.access"));
+        CHECK(put(login, "refresh_token", "eyJhbGciOi.refresh"));
+        CHECK(put(login, "token_expiry", "1700003600000"));
+        CHECK_EQ(3u, login.operations());
+        CHECK(store.commit(login));
+        CHECK(holds(store, "access_token", "eyJhbGciOi.access"));
+
+        StoreTransaction refresh;
+        CHECK(put(refresh, "access_token", "second"));
+        CHECK(refresh.remove("refresh_token", strlen("refresh_token")));
+        CHECK(store.commit(refresh));
+
+        const StoreStats stats = store.stats();
+        CHECK_EQ(2u, stats.keys);
+        CHECK_EQ(2u, stats.transactions);
+        CHECK_EQ(2u, stats.flushes);
+        CHECK_EQ(static_cast<off_t>(stats.usedBytes), fileSize(path));
+    }
+
+    SecureStore reopened;
+    CHECK(reopened.open(path, KEY));
+    CHECK(holds(reopened, "access_token", "second"));
+    CHECK(holds(reopened, "token_expiry", "1700003600000"));
+    CHECK(absent(reopened, "refresh_token"));
+    CHECK_EQ(0u, reopened.stats().droppedBytes);
+
+    // Values longer than the caller's buffer report their length only
+    char small[4];
+    size_t length = 0;
+    CHECK(reopened.get("access_token", 12, reinterpret_cast<uint8_t*>(small), sizeof(small),
+                       &length));
+    CHECK_EQ(6u, length);
+}
+
+TEST(rejectsFailedAndSkipsEmptyTransactions) {
+    char path[512];
+    storePath(path, sizeof(path), "secure-store-reject");
+    SecureStore store;
+    CHECK(store.open(path, KEY));
+
+    StoreTransaction empty;
+    CHECK(store.commit(empty));
+    CHECK_EQ(0u, store.stats().flushes);
+
+    // One bad operation fails the whole transaction
+    char longKey[MAX_STORE_KEY_LENGTH + 2];
+    memset(longKey, 'k', sizeof(longKey) - 1);
+    longKey[sizeof(longKey) - 1] = '\0';
+    StoreTransaction transaction;
+    CHECK(put(transaction, "user_id", "42"));
+    CHECK(!put(transaction, longKey, "x"));
+    CHECK(transaction.failed());
+    CHECK(!put(transaction, "user_name", "later"));
+    CHECK(!store.commit(transaction));
+    CHECK(absent(store, "user_id"));
+
+    transaction.begin();
+    CHECK(!transaction.failed());
+    CHECK(put(transaction, "user_id", "42"));
+    CHECK(store.commit(transaction));
+    CHECK(holds(store, "user_id", "42"));
+}
+
+TEST(dropsTornAndForeignRecords) {
+    char path[512];
+    storePath(path, sizeof(path), "secure-store-torn");
+    off_t firstEnd = 0;
+    {
+        SecureStore store;
+        CHECK(store.open(path, KEY));
+        StoreTransaction first;
+        put(first, "user_email", "baker@example.com");
+        CHECK(store.commit(first));
+        firstEnd = fileSize(path);
+        StoreTransaction second;
+        put(second, "user_email", "other@example.com");
+        put(second, "user_name", "Other");
+        CHECK(store.commit(second));
+    }
+
+    // Cut the second record short, as a crash mid-flush would
+    CHECK(truncate(path, fileSize(path) - 5) == 0);
+    {
+        SecureStore store;
+        CHECK(store.open(path, KEY));
+        CHECK(holds(store, "user_email", "baker@example.com"));
+        CHECK(absent(store, "user_name"));
+        CHECK(store.stats().droppedBytes > 0);
+        CHECK_EQ(firstEnd, fileSize(path));
+
+        StoreTransaction after;
+        put(after, "user_name", "Baker");
+        CHECK(store.commit(after));
+    }
+    {
+        SecureStore store;
+        CHECK(store.open(path, KEY));
+        CHECK(holds(store, "user_name", "Baker"));
+        CHECK_EQ(0u, store.stats().droppedBytes);
+    }
+
+    // Under another key no record opens: the log starts over
+    uint8_t otherKey[STORE_KEY_BYTES];
+    memcpy(otherKey, KEY, sizeof(otherKey));
+    otherKey[0] ^= 1;
+    SecureStore foreign;
+    CHECK(foreign.open(path, otherKey));
+    CHECK_EQ(0u, foreign.stats().keys);
+    CHECK(foreign.stats().droppedBytes > 0);
+    CHECK_EQ(16, fileSize(path));
+}
+
+TEST(groupsConcurrentCommits) {
+    char path[512];
+    storePath(path, sizeof(path), "secure-store-group");
+    {
+        SecureStore store;
+        CHECK(store.open(path, KEY));
+        pthread_t threads[THREADS];
+        Committer committers[THREADS];
+        for (int t = 0; t < THREADS; t++) {
+            committers[t] = {&store, t, 0};
+            pthread_create(&threads[t], nullptr, commitMany, &committers[t]);
+        }
+        for (int t = 0; t < THREADS; t++) {
+            pthread_join(threads[t], nullptr);
+            CHECK_EQ(0, committers[t].failures);
+        }
+        const StoreStats stats = store.stats();
+        CHECK_EQ(static_cast<uint64_t>(THREADS * COMMITS_PER_THREAD), stats.transactions);
+        CHECK(stats.flushes <= stats.transactions);
+        printf("  %llu transactions in %llu flushes\n",
+               static_cast<unsigned long long>(stats.transactions),
+               static_cast<unsigned long long>(stats.flushes));
+    }
+
+    // Every commit that returned is in the log, in an order the map agrees with
+    SecureStore store;
+    CHECK(store.open(path, KEY));
+    CHECK_EQ(static_cast<uint32_t>(THREADS * COMMITS_PER_THREAD + 1), store.stats().keys);
+    char key[32];
+    snprintf(key, sizeof(key), "t%d-k%d", THREADS - 1, COMMITS_PER_THREAD - 1);
+    CHECK(holds(store, key, "v49"));
+    char shared[32];
+    size_t length = 0;
+    CHECK(store.get("shared", 6, reinterpret_cast<uint8_t*>(shared), sizeof(shared), &length));
+    CHECK(length > 0 && shared[0] == 't');
+}
+
+TEST(compactsOverwrittenValues) {
+    char path[512];
+    storePath(path, sizeof(path), "secure-store-compact");
+    char value[128];
+    {
+        SecureStore store;
+        CHECK(store.open(path, KEY));
+        for (int i = 0; i < 1000; i++) {
+            snprintf(value, sizeof(value), "access-token-%04d-%0100d", i, 0);
+            StoreTransaction transaction;
+            put(transaction, "access_token", value);
+            put(transaction, "token_expiry", "1700003600000");
+            CHECK(store.commit(transaction));
+        }
+        const StoreStats stats = store.stats();
+        CHECK(stats.usedBytes < 2 * 16 * 1024);
+        CHECK_EQ(static_cast<off_t>(stats.usedBytes), fileSize(path));
+
+        // Commits after a compaction go to the new file
+        StoreTransaction last;
+        put(last, "user_id", "7");
+        CHECK(store.commit(last));
+    }
+    SecureStore store;
+    CHECK(store.open(path, KEY));
+    CHECK(holds(store, "access_token", value));
+    CHECK(holds(store, "user_id", "7"));
+    CHECK_EQ(3u, store.stats().keys);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,209 @@
+/**
+ * Host tests for the MinHash/LSH similar-recipe index
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "common/hash.h"
+#include "search/similar-index.h"
+#include "test/test-util.h"
+
+using namespace bakingapp;
+using namespace bakingapp::search;
+
+namespace {
+    bool setRecipe(SimilarIndex& index, const char* id, const char* ingredients) {
+        return index.setRecipe(id, strlen(id), ingredients, strlen(ingredients));
+    }
+
+    float estimate(const SimilarIndex& index, const char* a, const char* b) {
+        return index.estimate(a, strlen(a), b, strlen(b));
+    }
+
+    /**
+     * Looks up the recipes similar to id and joins theirs with spaces
+     */
+    const char* similar(SimilarIndex& index, const char* id, float minSimilarity = 0.0f) {
+        static char out[256];
+        SimilarRecipe results[8];
+        const size_t count = index.similar(id, strlen(id), minSimilarity, results, 8);
+        size_t length = 0;
+        for (size_t i = 0; i < count; i++) {
+            size_t n = 0;
+            const char* other = index.recipeId(results[i].recipe, &n);
+            if (length > 0) out[length++] = ' ';
+            memcpy(out + length, other, n);
+            length += n;
+        }
+        out[length] = '\0';
+        return out;
+    }
+
+    /**
+     * Ingredients "item <first>" to "item <last - 1>", one per line
+     */
+    const char* items(uint32_t first, uint32_t last) {
+        static char out[4096];
+        size_t length = 0;
+        for (uint32_t i = first; i < last; i++) {
+            length += snprintf(out + length, sizeof(out) - length, "item %u\n", i);
+        }
+        out[length] = '\0';
+        return out;
+    }
+}
+
+TEST(minHashKeepsTheUnsignedMinimumPerLane) {
+    uint64_t hashes[64];
+    for (uint32_t i = 0; i < 64; i++) hashes[i] = hash64(&i, sizeof(i));
+
+    uint32_t minima[SIGNATURE_LANES];
+    minHash(hashes, 0, minima);
+    for (uint32_t lane = 0; lane < SIGNATURE_LANES; lane++) CHECK_EQ(UINT32_MAX, minima[lane]);
+
+    // The set's minima are the smallest of each element's own values,
+    // compared as unsigned whatever the SIMD path does
+    uint32_t expected[SIGNATURE_LANES];
+    std::fill(expected, expected + SIGNATURE_LANES, UINT32_MAX);
+    uint32_t single[SIGNATURE_LANES];
+    bool highBits = false;
+    for (uint32_t i = 0; i < 64; i++) {
+        minHash(hashes + i, 1, single);
+        for (uint32_t lane = 0; lane < SIGNATURE_LANES; lane++) {
+            expected[lane] = std::min(expected[lane], single[lane]);
+            highBits |= single[lane] >= 0x80000000u;
+        }
+    }
+    CHECK(highBits);
+    minHash(hashes, 64, minima);
+    CHECK(memcmp(expected, minima, sizeof(minima)) == 0);
+
+    // Order does not matter
+    std::reverse(hashes, hashes + 64);
+    minHash(hashes, 64, single);
+    CHECK(memcmp(single, minima, sizeof(minima)) == 0);
+}
+
+TEST(estimatesJaccardSimilarity) {
+    SimilarIndex index;
+    CHECK(setRecipe(index, "a", items(0, 40)));
+    CHECK(setRecipe(index, "b", items(20, 60)));          // 20 of 60 shared
+    CHECK(setRecipe(index, "c", items(0, 36)));           // 36 of 40
+    CHECK(setRecipe(index, "d", items(100, 140)));        // none
+    CHECK(fabsf(estimate(index, "a", "b") - 20.0f / 60) < 0.15f);
+    CHECK(fabsf(estimate(index, "a", "c") - 36.0f / 40) < 0.1f);
+    CHECK(estimate(index, "a", "d") < 0.05f);
+    CHECK_EQ(1.0f, estimate(index, "a", "a"));
+    CHECK_EQ(-1.0f, estimate(index, "a", "missing"));
+
+    // Ingredients are normalized before hashing, and repeats count once
+    CHECK(setRecipe(index, "salad", "Cherry Tomatoes\nOlive oil\nBasil"));
+    CHECK(setRecipe(index, "caprese", "basil\n olive OIL \ncherry tomato\nBasil"));
+    CHECK_EQ(1.0f, estimate(index, "salad", "caprese"));
+}
+
+TEST(findsSimilarRecipesBestFirst) {
+    SimilarIndex index;
+    CHECK(setRecipe(index, "sponge", "flour\nsugar\nbutter\neggs\nmilk\nbaking powder"));
+    CHECK(setRecipe(index, "victoria", "flour\nsugar\nbutter\neggs\nbaking powder\njam"));
+    CHECK(setRecipe(index, "twin", "flour\nsugar\nbutter\neggs\nmilk\nbaking powder"));
+    CHECK(setRecipe(index, "pizza", "flour\nyeast\nwater\nsalt\ntomato\nmozzarella"));
+    CHECK(setRecipe(index, "empty", ""));
+
+    // The recipe itself is left out; unrelated ones share no band
+    CHECK(strcmp(similar(index, "sponge"), "twin victoria") == 0);
+    CHECK(strcmp(similar(index, "sponge", 0.9f), "twin") == 0);
+    CHECK(strcmp(similar(index, "pizza"), "") == 0);
+    CHECK(strcmp(similar(index, "empty"), "") == 0);
+    CHECK(strcmp(similar(index, "missing"), "") == 0);
+
+    SimilarRecipe results[SimilarIndex::MAX_RESULTS];
+    CHECK_EQ(1u, index.similar("sponge", 6, 0.0f, results, 1));
+    CHECK_EQ(1.0f, results[0].similarity);
+    CHECK_EQ(0u, index.similar("sponge", 6, 0.0f, results, 0));
+    CHECK_EQ(4u, index.stats().recipes);
+}
+
+TEST(updatesReplaceAndRemoveRecipes) {
+    SimilarIndex index;
+    CHECK(setRecipe(index, "a", items(0, 10)));
+    CHECK(setRecipe(index, "b", items(0, 10)));
+    CHECK(setRecipe(index, "c", items(50, 60)));
+    CHECK(strcmp(similar(index, "a"), "b") == 0);
+
+    // Stale band entries of the old ingredients no longer match
+    CHECK(setRecipe(index, "b", items(50, 60)));
+    CHECK(strcmp(similar(index, "a"), "") == 0);
+    CHECK(strcmp(similar(index, "c"), "b") == 0);
+    CHECK_EQ(BANDS, index.stats().staleEntries);
+
+    CHECK(index.removeRecipe("c", 1));
+    CHECK(!index.removeRecipe("c", 1));
+    CHECK(strcmp(similar(index, "b"), "") == 0);
+    CHECK(setRecipe(index, "c", items(50, 60)));
+    CHECK(strcmp(similar(index, "b"), "c") == 0);
+    CHECK(!setRecipe(index, "", items(0, 1)));
+
+    // Enough updates rebuild the buckets without their stale entries
+    char ingredients[64];
+    for (uint32_t i = 0; i < 200; i++) {
+        snprintf(ingredients, sizeof(ingredients), "item 0\nitem 1\nvariant %u", i);
+        CHECK(setRecipe(index, "a", ingredients));
+    }
+    const SimilarStats stats = index.stats();
+    CHECK_EQ(3u, stats.recipes);
+    CHECK(stats.staleEntries < stats.entries);
+    CHECK(stats.entries < 200 * BANDS);
+    CHECK(strcmp(similar(index, "b"), "c") == 0);
+
+    index.clear();
+    CHECK_EQ(0u, index.stats().recipes);
+    CHECK(strcmp(similar(index, "b"), "") == 0);
+    CHECK(setRecipe(index, "x", items(0, 5)));
+    CHECK(setRecipe(index, "y", items(0, 5)));
+    CHECK(strcmp(similar(index, "x"), "y") == 0);
+}
+
+TEST(findsMostNeighboursAboveHalfSimilarity) {
+    // Recipes in families sharing most ingredients; each family member
+    // should find nearly all of the others
+    constexpr uint32_t FAMILIES = 50;
+    constexpr uint32_t MEMBERS = 4;
+    SimilarIndex index;
+    char id[16];
+    char ingredients[512];
+    for (uint32_t f = 0; f < FAMILIES; f++) {
+        for (uint32_t m = 0; m < MEMBERS; m++) {
+            size_t length = 0;
+            for (uint32_t i = 0; i < 12; i++) {
+                length += snprintf(ingredients + length, sizeof(ingredients) - length,
+                                   "family %u item %u\n", f, i);
+            }
+            snprintf(ingredients + length, sizeof(ingredients) - length, "own %u %u", f, m);
+            snprintf(id, sizeof(id), "r%u-%u", f, m);
+            CHECK(setRecipe(index, id, ingredients));
+        }
+    }
+    SimilarRecipe results[8];
+    uint32_t found = 0;
+    for (uint32_t f = 0; f < FAMILIES; f++) {
+        snprintf(id, sizeof(id), "r%u-0", f);
+        const size_t count = index.similar(id, strlen(id), 0.5f, results, 8);
+        for (size_t i = 0; i < count; i++) {
+            size_t length = 0;
+            const char* other = index.recipeId(results[i].recipe, &length);
+            CHECK(strncmp(other, id, strlen(id) - 1) == 0);
+        }
+        found += static_cast<uint32_t>(count);
+    }
+    // 12 of 14 shared: about 0.86 similar, found in some band almost surely
+    CHECK(found >= FAMILIES * (MEMBERS - 1) * 95 / 100);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,106 @@
+/**
+ * Host tests for the string interning pool and JSON string decoding
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "strings/string-pool.h"
+#include "sync/json-records.h"
+#include "test/test-util.h"
+
+using bakingapp::strings::StringPool;
+using bakingapp::sync::decodeJsonString;
+
+namespace {
+    size_t decode(const char* token, char* out, size_t capacity) {
+        return decodeJsonString(reinterpret_cast<const uint8_t*>(token), strlen(token), out,
+                                capacity);
+    }
+}
+
+TEST(equalTextSharesAnId) {
+    StringPool pool;
+    const uint32_t cakes = pool.intern("cakes", 5);
+    const uint32_t breads = pool.intern("breads", 6);
+    CHECK_EQ(1u, cakes);
+    CHECK_EQ(2u, breads);
+    CHECK_EQ(cakes, pool.intern("cakes", 5));
+    CHECK_EQ(breads, pool.find("breads", 6));
+    CHECK_EQ(StringPool::NONE, pool.find("pies", 4));
+    CHECK_EQ(2u, pool.size());
+
+    // Length is part of the key, and so is the empty string
+    CHECK(pool.intern("cake", 4) != cakes);
+    CHECK(pool.intern("", 0) != StringPool::NONE);
+
+    size_t length = 0;
+    CHECK(strcmp(pool.text(breads, &length), "breads") == 0);
+    CHECK_EQ(6u, length);
+    CHECK(pool.text(StringPool::NONE, &length) == nullptr);
+    CHECK(pool.text(99, &length) == nullptr);
+}
+
+TEST(growsWithoutMovingText) {
+    StringPool pool;
+    char text[32];
+    const char* first = nullptr;
+    for (uint32_t i = 0; i < 50000; i++) {
+        const int n = snprintf(text, sizeof(text), "value-%u", i);
+        CHECK_EQ(i + 1, pool.intern(text, static_cast<size_t>(n)));
+        if (i == 0) first = pool.text(1, nullptr);
+    }
+    CHECK(pool.text(1, nullptr) == first);
+    for (uint32_t i = 0; i < 50000; i += 997) {
+        const int n = snprintf(text, sizeof(text), "value-%u", i);
+        CHECK_EQ(i + 1, pool.find(text, static_cast<size_t>(n)));
+    }
+    const auto stats = pool.stats();
+    CHECK_EQ(50000u, stats.strings);
+    CHECK(stats.arenaBytes >= stats.textBytes + 50000);
+
+    char tooLong[StringPool::MAX_LENGTH + 1] = {};
+    CHECK_EQ(StringPool::NONE, pool.intern(tooLong, sizeof(tooLong)));
+
+    pool.clear();
+    CHECK_EQ(0u, pool.size());
+    CHECK_EQ(StringPool::NONE, pool.find("value-1", 7));
+    CHECK_EQ(1u, pool.intern("value-1", 7));
+}
+
+TEST(decodesPlainAndEscapedTokens) {
+    char out[64];
+    CHECK_EQ(4u, decode("\"easy\"", out, sizeof(out)));
+    CHECK(memcmp(out, "easy", 4) == 0);
+    CHECK_EQ(0u, decode("\"\"", out, sizeof(out)));
+
+    CHECK_EQ(7u, decode("\"a\\\"b\\\\c\\/\\n\"", out, sizeof(out)));
+    CHECK(memcmp(out, "a\"b\\c/\n", 7) == 0);
+
+    // é, € and a surrogate pair (U+1F370, shortcake)
+    const size_t n = decode("\"\\u00e9\\u20AC\\ud83c\\udf70\"", out, sizeof(out));
+    CHECK_EQ(2u + 3u + 4u, n);
+    CHECK(memcmp(out, "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x8D\xB0", n) == 0);
+
+    // Raw UTF-8 passes through untouched
+    CHECK_EQ(2u, decode("\"\xC3\xA9\"", out, sizeof(out)));
+}
+
+TEST(rejectsMalformedTokens) {
+    char out[8];
+    CHECK_EQ(SIZE_MAX, decode("easy", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"a\\\"", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"\\x\"", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"\\u12\"", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"\\ud83c\"", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"\\udf70\"", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"a\tb\"", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"too long for it\"", out, sizeof(out)));
+    CHECK_EQ(SIZE_MAX, decode("\"\\n\\n\\n\\n\\n\\n\\n\\n\\n\"", out, sizeof(out)));
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,239 @@
+/**
+ * Host tests for the telemetry rings, flusher and file format
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <pthread.h>
+
+#include "telemetry/telemetry.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::telemetry;
+
+namespace {
+    constexpr uint32_t THREADS = 4;
+    constexpr uint32_t EVENTS_PER_THREAD = 20000;
+
+    struct Producer {
+        Telemetry* telemetry;
+        pthread_barrier_t* alive;
+        uint32_t index;
+    };
+
+    void* produce(void* argument) {
+        auto* producer = static_cast<Producer*>(argument);
+        for (uint32_t i = 0; i < EVENTS_PER_THREAD; i++) {
+            producer->telemetry->record(EventType::KEY_FETCH, i, producer->index);
+        }
+        // No thread exits (and hands its ring on) before all have recorded
+        pthread_barrier_wait(producer->alive);
+        return nullptr;
+    }
+
+    void* recordOnce(void* argument) {
+        static_cast<Telemetry*>(argument)->record(EventType::TIMER_TICK);
+        return nullptr;
+    }
+
+    uint8_t* readFile(const char* path, size_t* size) {
+        FILE* file = fopen(path, "rb");
+        if (file == nullptr) return nullptr;
+        fseek(file, 0, SEEK_END);
+        *size = static_cast<size_t>(ftell(file));
+        fseek(file, 0, SEEK_SET);
+        auto* data = static_cast<uint8_t*>(malloc(*size > 0 ? *size : 1));
+        if (fread(data, 1, *size, file) != *size) *size = 0;
+        fclose(file);
+        return data;
+    }
+
+    void tempFile(char* out, size_t size) {
+        char dir[256];
+        bakingapp::test::makeTempDir(dir, sizeof(dir), "telemetry-test");
+        snprintf(out, size, "%s/events.bin", dir);
+    }
+}
+
+TEST(batchRoundTripsThroughTheReader) {
+    const int64_t origin = 5000000000LL;
+    const TelemetryEvent events[] = {
+        {origin + 100, 2, 7, 0},
+        {origin + 100, 3, 1, 0},
+        {origin + 250000, 4, 3, 12},
+        {origin + 9000000000LL, 2, 0xFFFFFFFFu, 0xFFFFFFFFFFFFFFFFULL},
+    };
+    uint8_t data[sizeof(FileHeader) + maxBatchBytes(4)];
+    const FileHeader header {TELEMETRY_MAGIC, TELEMETRY_VERSION, origin, 0};
+    memcpy(data, &header, sizeof(header));
+    const size_t length = encodeBatch(9, 3, origin, events, 4, data + sizeof(header));
+    CHECK(length < sizeof(events));
+
+    TelemetryReader reader;
+    CHECK(reader.open(data, sizeof(header) + length));
+    BatchInfo info {};
+    TelemetryEvent decoded[4] = {};
+    CHECK(reader.next(&info, decoded, 4));
+    CHECK_EQ(9u, info.ring);
+    CHECK_EQ(4u, info.count);
+    CHECK_EQ(3u, info.dropped);
+    for (int i = 0; i < 4; i++) {
+        CHECK_EQ(events[i].timestampNanos, decoded[i].timestampNanos);
+        CHECK_EQ(events[i].type, decoded[i].type);
+        CHECK_EQ(events[i].value, decoded[i].value);
+        CHECK(events[i].extra == decoded[i].extra);
+    }
+    CHECK(!reader.next(&info, decoded, 4));
+    CHECK(reader.atEnd());
+
+    // A truncated batch is reported, not half-decoded
+    CHECK(reader.open(data, sizeof(header) + length - 1));
+    CHECK(!reader.next(&info, decoded, 4));
+    CHECK(!reader.atEnd());
+}
+
+TEST(fullRingDropsAndCounts) {
+    auto* ring = static_cast<EventRing*>(aligned_alloc(alignof(EventRing), sizeof(EventRing)));
+    new (ring) EventRing();
+    for (uint32_t i = 0; i < EventRing::CAPACITY; i++) {
+        CHECK(ring->push(TelemetryEvent {i, 1, i, 0}));
+    }
+    CHECK(!ring->push(TelemetryEvent {0, 1, 0, 0}));
+    CHECK_EQ(1u, ring->dropped());
+
+    TelemetryEvent out[16];
+    CHECK_EQ(16u, ring->drain(out, 16));
+    CHECK_EQ(0u, out[0].value);
+    CHECK_EQ(15u, out[15].value);
+    // Space freed by the consumer is seen once the producer looks again
+    CHECK(ring->push(TelemetryEvent {0, 1, 99, 0}));
+    ring->~EventRing();
+    free(ring);
+}
+
+TEST(flusherWritesEveryEventInOrder) {
+    char path[300];
+    tempFile(path, sizeof(path));
+
+    Telemetry telemetry;
+    CHECK(telemetry.start(path, 1));
+    pthread_barrier_t alive;
+    pthread_barrier_init(&alive, nullptr, THREADS);
+    pthread_t threads[THREADS];
+    Producer producers[THREADS];
+    for (uint32_t t = 0; t < THREADS; t++) {
+        producers[t] = Producer {&telemetry, &alive, t};
+        pthread_create(&threads[t], nullptr, produce, &producers[t]);
+    }
+    for (pthread_t thread : threads) pthread_join(thread, nullptr);
+    pthread_barrier_destroy(&alive);
+    telemetry.stop();
+
+    const TelemetryStats stats = telemetry.stats();
+    CHECK_EQ(THREADS, stats.rings);
+    CHECK_EQ(static_cast<uint64_t>(THREADS) * EVENTS_PER_THREAD,
+             stats.flushedEvents + stats.droppedEvents);
+
+    size_t size = 0;
+    uint8_t* data = readFile(path, &size);
+    CHECK_EQ(stats.fileBytes, size);
+    TelemetryReader reader;
+    CHECK(reader.open(data, size));
+
+    // Per producer: values increasing (gaps are drops), timestamps never
+    // going backwards
+    uint32_t nextValue[THREADS] = {};
+    int64_t lastTime[THREADS] = {};
+    uint64_t dropped = 0;
+    uint64_t events = 0;
+    BatchInfo info {};
+    auto* batch = static_cast<TelemetryEvent*>(malloc(sizeof(TelemetryEvent) *
+                                                      EventRing::CAPACITY));
+    while (reader.next(&info, batch, EventRing::CAPACITY)) {
+        dropped += info.dropped;
+        for (uint32_t i = 0; i < info.count; i++) {
+            const uint32_t producer = static_cast<uint32_t>(batch[i].extra);
+            CHECK(producer < THREADS);
+            if (producer >= THREADS) break;
+            CHECK_EQ(static_cast<uint32_t>(EventType::KEY_FETCH), batch[i].type);
+            CHECK(batch[i].value >= nextValue[producer]);
+            CHECK(batch[i].timestampNanos >= lastTime[producer]);
+            nextValue[producer] = batch[i].value + 1;
+            lastTime[producer] = batch[i].timestampNanos;
+            events++;
+        }
+    }
+    CHECK_EQ(stats.flushedEvents, events);
+    CHECK_EQ(stats.droppedEvents, dropped);
+    free(batch);
+    free(data);
+}
+
+TEST(exitedThreadsHandTheirRingOn) {
+    char path[300];
+    tempFile(path, sizeof(path));
+
+    Telemetry telemetry;
+    CHECK(telemetry.start(path, 60000));
+    for (int i = 0; i < 8; i++) {
+        pthread_t thread;
+        pthread_create(&thread, nullptr, recordOnce, &telemetry);
+        pthread_join(thread, nullptr);
+    }
+    CHECK(telemetry.flush());
+    const TelemetryStats stats = telemetry.stats();
+    CHECK_EQ(1u, stats.rings);
+    CHECK_EQ(8u, stats.flushedEvents);
+}
+
+TEST(oversizedFileStartsOver) {
+    char path[300];
+    tempFile(path, sizeof(path));
+
+    Telemetry telemetry;
+    CHECK(telemetry.start(path, 60000, 4096));
+    for (int round = 0; round < 20; round++) {
+        for (uint32_t i = 0; i < 500; i++) telemetry.record(EventType::AUTH_HEADER, 1, i);
+        CHECK(telemetry.flush());
+    }
+    telemetry.stop();
+
+    size_t size = 0;
+    uint8_t* data = readFile(path, &size);
+    CHECK(size <= 4096);
+    TelemetryReader reader;
+    CHECK(reader.open(data, size));
+    BatchInfo info {};
+    TelemetryEvent batch[500];
+    uint32_t batches = 0;
+    while (reader.next(&info, batch, 500)) {
+        CHECK_EQ(500u, info.count);
+        batches++;
+    }
+    CHECK(batches >= 1);
+    free(data);
+}
+
+TEST(disabledRecordingLeavesNoTrace) {
+    char path[300];
+    tempFile(path, sizeof(path));
+
+    Telemetry telemetry;
+    telemetry.setEnabled(false);
+    telemetry.record(EventType::KEY_FETCH);
+    CHECK_EQ(0u, telemetry.stats().rings);
+
+    // Recorded before start(): waits in the ring
+    telemetry.setEnabled(true);
+    telemetry.record(EventType::KEY_FETCH, 1);
+    CHECK(telemetry.start(path, 60000));
+    CHECK(telemetry.flush());
+    CHECK_EQ(1u, telemetry.stats().flushedEvents);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,91 @@
+/**
+ * Tiny assertion helpers for the host-side native tests.
+ *
+ * Each test binary registers its cases with TEST() and calls runTests()
+ * from main(); a non-zero exit code fails the ctest run.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace bakingapp::test {
+
+struct TestCase {
+    const char* name;
+    void (*body)();
+};
+
+inline int& failureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+inline TestCase* registry() {
+    static TestCase cases[128];
+    return cases;
+}
+
+inline int& registeredCount() {
+    static int count = 0;
+    return count;
+}
+
+struct Registrar {
+    Registrar(const char* name, void (*body)()) {
+        registry()[registeredCount()++] = TestCase{name, body};
+    }
+};
+
+inline int runTests() {
+    for (int i = 0; i < registeredCount(); i++) {
+        int before = failureCount();
+        registry()[i].body();
+        printf("[%s] %s\n", failureCount() == before ? "PASS" : "FAIL", registry()[i].name);
+    }
+    printf("%d test(s), %d failure(s)\n", registeredCount(), failureCount());
+    return failureCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Creates a fresh scratch directory under $TMPDIR (or /tmp)
+ */
+inline void makeTempDir(char* out, size_t outSize, const char* prefix) {
+    const char* base = getenv("TMPDIR");
+    snprintf(out, outSize, "%s/%s-XXXXXX", base != nullptr ? base : "/tmp", prefix);
+    if (mkdtemp(out) == nullptr) {
+        perror("mkdtemp");
+        exit(EXIT_FAILURE);
+    }
+}
+
+} // namespace bakingapp::test
+
+#define TEST(name)                                                        \
+    static void name();                                                   \
+    static bakingapp::test::Registrar name##_registrar(#name, name);      \
+    static void name()
+
+#define CHECK(condition)                                                  \
+    do {                                                                  \
+        if (!(condition)) {                                               \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n",                  \
+                    __FILE__, __LINE__, #condition);                      \
+            bakingapp::test::failureCount()++;                            \
+        }                                                                 \
+    } while (0)
+
+#define CHECK_EQ(expected, actual)                                        \
+    do {                                                                  \
+        auto expectedValue = (expected);                                  \
+        auto actualValue = (actual);                                      \
+        if (!(expectedValue == actualValue)) {                            \
+            fprintf(stderr, "%s:%d: CHECK_EQ failed: %s == %s (%lld vs %lld)\n", \
+                    __FILE__, __LINE__, #expected, #actual,               \
+                    static_cast<long long>(expectedValue),                \
+                    static_cast<long long>(actualValue));                 \
+            bakingapp::test::failureCount()++;                            \
+        }                                                                 \
+    } while (0)
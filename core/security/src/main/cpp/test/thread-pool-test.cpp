@@ -0,0 +1,294 @@
+/**
+ * Host tests for the work-stealing thread pool
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "common/thread-pool.h"
+#include "test/test-util.h"
+
+using namespace bakingapp;
+
+namespace {
+    struct CountingTask : Task {
+        std::atomic<uint32_t>* runs;
+    };
+
+    void countRun(Task* task) {
+        static_cast<CountingTask*>(task)->runs->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Fork-join sum of [from, to) that splits down to 1k-element leaves
+     */
+    struct SumTask : Task {
+        ThreadPool* pool;
+        uint64_t from;
+        uint64_t to;
+        uint64_t result;
+    };
+
+    void sumRange(Task* task) {
+        auto* sum = static_cast<SumTask*>(task);
+        if (sum->to - sum->from <= 1024) {
+            uint64_t total = 0;
+            for (uint64_t i = sum->from; i < sum->to; i++) total += i;
+            sum->result = total;
+            return;
+        }
+        const uint64_t middle = sum->from + (sum->to - sum->from) / 2;
+        SumTask left;
+        left.run = sumRange;
+        left.pool = sum->pool;
+        left.from = sum->from;
+        left.to = middle;
+        SumTask right = left;
+        right.from = middle;
+        right.to = sum->to;
+
+        TaskGroup group(*sum->pool);
+        group.spawn(&right);
+        sumRange(&left);
+        group.wait();
+        sum->result = left.result + right.result;
+    }
+
+    std::atomic<uint32_t> hookStarts {0};
+    std::atomic<uint32_t> hookStops {0};
+
+    void onStart(uint32_t, void*) { hookStarts.fetch_add(1); }
+    void onStop(uint32_t, void*) { hookStops.fetch_add(1); }
+
+    bool coversEachIndexOnce(ThreadPool& pool, size_t count, size_t grain) {
+        auto* hits = static_cast<std::atomic<uint8_t>*>(calloc(count + 1, sizeof(std::atomic<uint8_t>)));
+        pool.parallelFor(0, count, grain, [&](size_t from, size_t to) {
+            for (size_t i = from; i < to; i++) hits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+        bool ok = true;
+        for (size_t i = 0; i < count; i++) ok = ok && hits[i].load() == 1;
+        free(hits);
+        return ok;
+    }
+
+    /**
+     * A posted job waiting on a group that another worker keeps busy,
+     * with a second posted job queued meanwhile
+     */
+    struct NestedWait;
+
+    struct NestedTask : Task {
+        NestedWait* state;
+    };
+
+    struct NestedWait {
+        ThreadPool* pool;
+        NestedTask waiter;
+        NestedTask slow;
+        NestedTask queued;
+        pthread_t waiterThread;
+        std::atomic<bool> slowStarted {false};
+        std::atomic<bool> waiting {false};
+        std::atomic<bool> queuedRanInWait {false};
+        std::atomic<uint32_t> finished {0};
+    };
+
+    void runSlow(Task* task) {
+        static_cast<NestedTask*>(task)->state->slowStarted.store(true);
+        usleep(20000);
+    }
+
+    void runQueued(Task* task) {
+        NestedWait* state = static_cast<NestedTask*>(task)->state;
+        if (pthread_equal(pthread_self(), state->waiterThread) && state->waiting.load()) {
+            state->queuedRanInWait.store(true);
+        }
+        state->finished.fetch_add(1);
+    }
+
+    void runWaiter(Task* task) {
+        NestedWait* state = static_cast<NestedTask*>(task)->state;
+        state->waiterThread = pthread_self();
+        TaskGroup group(*state->pool);
+        group.spawn(&state->slow);
+        // Stolen by the other worker, so the wait below has nothing of its own to run
+        while (!state->slowStarted.load()) sched_yield();
+        state->pool->post(&state->queued);
+        state->waiting.store(true);
+        group.wait();
+        state->waiting.store(false);
+        state->finished.fetch_add(1);
+    }
+
+    void* parallelForFromThread(void* argument) {
+        auto* pool = static_cast<ThreadPool*>(argument);
+        bool ok = true;
+        for (int round = 0; round < 50; round++) ok = ok && coversEachIndexOnce(*pool, 10000, 16);
+        return ok ? argument : nullptr;
+    }
+}
+
+TEST(dequeIsLifoForTheOwnerAndFifoForThieves) {
+    auto* deque = static_cast<WorkDeque*>(aligned_alloc(alignof(WorkDeque), sizeof(WorkDeque)));
+    new (deque) WorkDeque();
+    Task tasks[3];
+    for (Task& task : tasks) CHECK(deque->push(&task));
+
+    CHECK(deque->steal() == &tasks[0]);
+    CHECK(deque->pop() == &tasks[2]);
+    CHECK(deque->pop() == &tasks[1]);
+    CHECK(deque->pop() == nullptr);
+    CHECK(deque->steal() == nullptr);
+
+    Task filler;
+    int64_t pushed = 0;
+    while (deque->push(&filler)) pushed++;
+    CHECK_EQ(WorkDeque::CAPACITY, pushed);
+    deque->~WorkDeque();
+    free(deque);
+}
+
+TEST(parallelForCoversEveryIndexOnce) {
+    const uint32_t workerCounts[] = {0, 1, 3};
+    for (uint32_t workers : workerCounts) {
+        ThreadPool pool;
+        CHECK(pool.start(workers));
+        CHECK(coversEachIndexOnce(pool, 0, 1));
+        CHECK(coversEachIndexOnce(pool, 1, 1));
+        CHECK(coversEachIndexOnce(pool, 7, 100));
+        CHECK(coversEachIndexOnce(pool, 1000, 1));
+        CHECK(coversEachIndexOnce(pool, 123457, 64));
+    }
+}
+
+TEST(forkJoinRecursesAcrossWorkers) {
+    ThreadPool pool;
+    CHECK(pool.start(3));
+    SumTask root;
+    root.run = sumRange;
+    root.pool = &pool;
+    root.from = 0;
+    root.to = 1 << 20;
+    sumRange(&root);
+    CHECK_EQ((uint64_t {1} << 20) * ((uint64_t {1} << 20) - 1) / 2, root.result);
+
+    // Nested parallelFor from inside pool tasks
+    std::atomic<uint64_t> total {0};
+    pool.parallelFor(0, 64, 1, [&](size_t from, size_t to) {
+        for (size_t outer = from; outer < to; outer++) {
+            pool.parallelFor(0, 1000, 10, [&](size_t a, size_t b) {
+                total.fetch_add(b - a, std::memory_order_relaxed);
+            });
+        }
+    });
+    CHECK_EQ(64u * 1000u, total.load());
+}
+
+TEST(everyTaskRunsExactlyOnceUnderStealing) {
+    ThreadPool pool;
+    CHECK(pool.start(4));
+
+    constexpr uint32_t TASKS = 50000;
+    auto* tasks = static_cast<CountingTask*>(calloc(TASKS, sizeof(CountingTask)));
+    auto* runs = static_cast<std::atomic<uint32_t>*>(calloc(TASKS, sizeof(std::atomic<uint32_t>)));
+    {
+        // Spawned mostly from workers, so they land in their deques and
+        // get stolen (or run inline once a deque is full)
+        pool.parallelFor(0, 4, 1, [&](size_t from, size_t to) {
+            TaskGroup group(pool);
+            for (size_t i = from * TASKS / 4; i < to * TASKS / 4; i++) {
+                tasks[i].run = countRun;
+                tasks[i].runs = &runs[i];
+                group.spawn(&tasks[i]);
+            }
+            group.wait();
+        });
+        TaskGroup group(pool);
+        for (uint32_t i = 0; i < TASKS; i++) group.spawn(&tasks[i]);
+        group.wait();
+    }
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < TASKS; i++) wrong += runs[i].load() != 2;
+    CHECK_EQ(0u, wrong);
+    free(tasks);
+    free(runs);
+}
+
+TEST(externalThreadsShareThePool) {
+    ThreadPool pool;
+    CHECK(pool.start(2));
+    pthread_t threads[4];
+    for (pthread_t& thread : threads) pthread_create(&thread, nullptr, parallelForFromThread, &pool);
+    for (pthread_t& thread : threads) {
+        void* result = nullptr;
+        pthread_join(thread, &result);
+        CHECK(result == &pool);
+    }
+}
+
+TEST(postedTasksRunOnWorkersOnly) {
+    ThreadPool idle;
+    CHECK(idle.start(0));
+    CountingTask lost;
+    CHECK(!idle.post(&lost));
+
+    ThreadPool pool;
+    CHECK(pool.start(2));
+    constexpr uint32_t TASKS = 5000;
+    auto* tasks = static_cast<CountingTask*>(calloc(TASKS, sizeof(CountingTask)));
+    std::atomic<uint32_t> runs {0};
+    for (uint32_t i = 0; i < TASKS; i++) {
+        tasks[i].run = countRun;
+        tasks[i].runs = &runs;
+        CHECK(pool.post(&tasks[i]));
+    }
+    // A group waiting here helps with its own tasks but leaves posted ones
+    CHECK(coversEachIndexOnce(pool, 10000, 1));
+    while (runs.load() != TASKS) sched_yield();
+    free(tasks);
+}
+
+TEST(nestedWaitLeavesPostedTasksAlone) {
+    ThreadPool pool;
+    CHECK(pool.start(2));
+    for (int round = 0; round < 5; round++) {
+        NestedWait state;
+        state.pool = &pool;
+        state.waiter.run = runWaiter;
+        state.slow.run = runSlow;
+        state.queued.run = runQueued;
+        state.waiter.state = state.slow.state = state.queued.state = &state;
+        CHECK(pool.post(&state.waiter));
+        while (state.finished.load() != 2) sched_yield();
+        CHECK(!state.queuedRanInWait.load());
+    }
+}
+
+TEST(hooksRunOncePerWorker) {
+    {
+        ThreadPool pool;
+        WorkerHooks hooks {onStart, onStop, nullptr};
+        CHECK(pool.start(3, &hooks));
+        CHECK(coversEachIndexOnce(pool, 1000, 1));
+    }
+    CHECK_EQ(3u, hookStarts.load());
+    CHECK_EQ(3u, hookStops.load());
+}
+
+TEST(sharedPoolUsesThePerformanceCores) {
+    const uint32_t cores = performanceCoreCount();
+    CHECK(cores >= 1);
+    CHECK(cores <= static_cast<uint32_t>(sysconf(_SC_NPROCESSORS_CONF)));
+    CHECK_EQ(cores > 1 ? cores : 2, ThreadPool::shared().concurrency());
+    CHECK(coversEachIndexOnce(ThreadPool::shared(), 100000, 100));
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,365 @@
+/**
+ * Host tests for the timer journal, including recovery after the writing
+ * process is killed mid-append
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "test/test-util.h"
+#include "timers/timer-journal.h"
+
+using namespace bakingapp::timers;
+
+namespace {
+    constexpr int64_t MILLIS = 1000000;
+    constexpr int64_t SECOND = 1000 * MILLIS;
+    constexpr int64_t BOOT_NANOS = 5000 * SECOND;
+    constexpr int64_t WALL_MILLIS = 1700000000000;
+
+    struct Recovered {
+        uint8_t status;
+        bool running;
+        int64_t remainingSeconds;
+        char id[64];
+        char metadata[64];
+    };
+
+    struct SnapshotHeader {
+        uint8_t status;
+        uint8_t running;
+        uint16_t idLength;
+        uint32_t metadataLength;
+        int64_t remainingSeconds;
+    };
+
+    void journalPath(char* out, size_t size, const char* prefix) {
+        char dir[256];
+        bakingapp::test::makeTempDir(dir, sizeof(dir), prefix);
+        snprintf(out, size, "%s/timers.journal", dir);
+    }
+
+    JournalState at(uint8_t status, bool running, int64_t remaining, int64_t offsetMillis = 0) {
+        return {status, running, remaining, BOOT_NANOS + offsetMillis * MILLIS,
+                WALL_MILLIS + offsetMillis};
+    }
+
+    bool putTimer(TimerJournal& journal, const char* id, const char* metadata,
+                  const JournalState& state) {
+        return journal.put(id, strlen(id), metadata, strlen(metadata), state);
+    }
+
+    /**
+     * Parses a snapshot into out, metadata truncated to what fits
+     */
+    size_t recover(TimerJournal& journal, int64_t nowNanos, int64_t nowWall, Recovered* out,
+                   size_t capacity) {
+        const size_t required = journal.snapshot(nowNanos, nowWall, nullptr, 0);
+        auto* buffer = static_cast<uint8_t*>(malloc(required + 1));
+        const size_t used = journal.snapshot(nowNanos, nowWall, buffer, required);
+        size_t count = 0;
+        for (size_t p = 0; p < used && count < capacity; count++) {
+            SnapshotHeader header {};
+            memcpy(&header, buffer + p, sizeof(header));
+            Recovered& timer = out[count];
+            timer.status = header.status;
+            timer.running = header.running != 0;
+            timer.remainingSeconds = header.remainingSeconds;
+            memcpy(timer.id, buffer + p + sizeof(header), header.idLength);
+            timer.id[header.idLength] = '\0';
+            const size_t kept = header.metadataLength < sizeof(timer.metadata) - 1
+                ? header.metadataLength : sizeof(timer.metadata) - 1;
+            memcpy(timer.metadata, buffer + p + sizeof(header) + header.idLength, kept);
+            timer.metadata[kept] = '\0';
+            p += (sizeof(header) + header.idLength + header.metadataLength + 7) & ~size_t {7};
+        }
+        free(buffer);
+        return count;
+    }
+
+    const Recovered* findTimer(const Recovered* timers, size_t count, const char* id) {
+        for (size_t i = 0; i < count; i++) {
+            if (strcmp(timers[i].id, id) == 0) return &timers[i];
+        }
+        return nullptr;
+    }
+
+    off_t fileSize(const char* path) {
+        struct stat info {};
+        return stat(path, &info) == 0 ? info.st_size : -1;
+    }
+}
+
+TEST(roundTripsAcrossReopen) {
+    char path[512];
+    journalPath(path, sizeof(path), "journal-roundtrip");
+    {
+        TimerJournal journal;
+        CHECK(journal.open(path));
+        CHECK(putTimer(journal, "eggs", "Boil eggs", at(0, false, 300)));
+        CHECK(putTimer(journal, "bread", "Proof dough", at(0, false, 3600)));
+        CHECK(putTimer(journal, "rice", "Rice", at(0, false, 900)));
+        CHECK(journal.transition("bread", 5, at(1, false, 1800)));
+        CHECK(journal.remove("rice", 4));
+        CHECK(!journal.remove("rice", 4));
+        CHECK(!journal.transition("rice", 4, at(1, true, 10)));
+        CHECK_EQ(2u, journal.stats().liveTimers);
+    }
+
+    TimerJournal journal;
+    CHECK(journal.open(path));
+    CHECK_EQ(0u, journal.stats().droppedBytes);
+    CHECK_EQ(5u, journal.stats().records);
+
+    Recovered timers[4];
+    CHECK_EQ(2u, recover(journal, BOOT_NANOS, WALL_MILLIS, timers, 4));
+    const Recovered* bread = findTimer(timers, 2, "bread");
+    CHECK(bread != nullptr);
+    if (bread != nullptr) {
+        CHECK_EQ(1, bread->status);
+        CHECK_EQ(1800, bread->remainingSeconds);
+        CHECK(strcmp(bread->metadata, "Proof dough") == 0);
+    }
+    CHECK(findTimer(timers, 2, "rice") == nullptr);
+}
+
+TEST(runningTimersLoseElapsedTime) {
+    char path[512];
+    journalPath(path, sizeof(path), "journal-elapsed");
+    TimerJournal journal;
+    CHECK(journal.open(path));
+    CHECK(putTimer(journal, "running", "", at(1, true, 100)));
+    CHECK(putTimer(journal, "paused", "", at(2, false, 100)));
+    CHECK(putTimer(journal, "done", "", at(1, true, 5)));
+
+    Recovered timers[4];
+    // Same boot, 30.5 s later: a partial second still counts as remaining
+    CHECK_EQ(3u, recover(journal, BOOT_NANOS + 30500 * MILLIS, WALL_MILLIS + 30500, timers, 4));
+    CHECK_EQ(70, findTimer(timers, 3, "running")->remainingSeconds);
+    CHECK_EQ(100, findTimer(timers, 3, "paused")->remainingSeconds);
+    CHECK_EQ(0, findTimer(timers, 3, "done")->remainingSeconds);
+    CHECK(findTimer(timers, 3, "done")->running);
+
+    // The monotonic clock wins over a wall clock set back by the user
+    CHECK_EQ(3u, recover(journal, BOOT_NANOS + 10 * SECOND, WALL_MILLIS - 3600000, timers, 4));
+    CHECK_EQ(90, findTimer(timers, 3, "running")->remainingSeconds);
+
+    // After a reboot the monotonic clock restarted; fall back to wall time
+    CHECK_EQ(3u, recover(journal, 20 * SECOND, WALL_MILLIS + 40000, timers, 4));
+    CHECK_EQ(60, findTimer(timers, 3, "running")->remainingSeconds);
+}
+
+TEST(tornTailIsDropped) {
+    char path[512];
+    journalPath(path, sizeof(path), "journal-torn");
+    {
+        TimerJournal journal;
+        CHECK(journal.open(path));
+        CHECK(putTimer(journal, "a", "first", at(0, false, 10)));
+        CHECK(putTimer(journal, "b", "second", at(0, false, 20)));
+    }
+
+    // Flip a byte inside the second record's metadata
+    const int fd = open(path, O_RDWR);
+    CHECK(fd >= 0);
+    const uint8_t garbage = 0xFF;
+    CHECK_EQ(1, static_cast<int>(pwrite(fd, &garbage, 1, 16 + 48 + 41)));
+    close(fd);
+
+    TimerJournal journal;
+    CHECK(journal.open(path));
+    CHECK_EQ(1u, journal.stats().liveTimers);
+    CHECK(journal.stats().droppedBytes > 0);
+
+    // Appends continue from the last good record
+    CHECK(putTimer(journal, "c", "third", at(0, false, 30)));
+    journal.close();
+    CHECK(journal.open(path));
+    CHECK_EQ(0u, journal.stats().droppedBytes);
+
+    Recovered timers[4];
+    CHECK_EQ(2u, recover(journal, BOOT_NANOS, WALL_MILLIS, timers, 4));
+    CHECK(findTimer(timers, 2, "a") != nullptr);
+    CHECK(findTimer(timers, 2, "c") != nullptr);
+}
+
+TEST(foreignFileIsReset) {
+    char path[512];
+    journalPath(path, sizeof(path), "journal-foreign");
+    const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    CHECK(fd >= 0);
+    const char text[] = "not a journal";
+    CHECK_EQ(static_cast<int>(sizeof(text)), static_cast<int>(write(fd, text, sizeof(text))));
+    close(fd);
+
+    TimerJournal journal;
+    CHECK(journal.open(path));
+    CHECK_EQ(0u, journal.stats().liveTimers);
+    CHECK(journal.stats().droppedBytes > 0);
+    CHECK(putTimer(journal, "a", "", at(0, false, 1)));
+}
+
+TEST(compactionKeepsLatestState) {
+    char path[512];
+    journalPath(path, sizeof(path), "journal-compact");
+    TimerJournal journal;
+    CHECK(journal.open(path));
+    CHECK(!journal.needsCompaction());
+
+    char id[32];
+    for (int i = 0; i < 50; i++) {
+        snprintf(id, sizeof(id), "timer-%d", i);
+        CHECK(putTimer(journal, id, "metadata", at(0, false, 600)));
+    }
+    // Start and pause every timer many times; remove every other one
+    for (int round = 0; round < 40; round++) {
+        for (int i = 0; i < 50; i++) {
+            snprintf(id, sizeof(id), "timer-%d", i);
+            CHECK(journal.transition(id, strlen(id), at(round % 2 == 0 ? 1 : 2, round % 2 == 0,
+                                                        600 - round, round * 1000)));
+        }
+    }
+    for (int i = 0; i < 50; i += 2) {
+        snprintf(id, sizeof(id), "timer-%d", i);
+        CHECK(journal.remove(id, strlen(id)));
+    }
+    CHECK(journal.needsCompaction());
+
+    const JournalStats before = journal.stats();
+    CHECK(journal.compact());
+    const JournalStats after = journal.stats();
+    CHECK_EQ(25u, after.liveTimers);
+    CHECK_EQ(25u, after.records);
+    CHECK_EQ(before.liveBytes, after.usedBytes);
+    CHECK(!journal.needsCompaction());
+
+    // Still appendable, and the compacted file replays to the same state
+    CHECK(putTimer(journal, "late", "", at(0, false, 5)));
+    journal.close();
+    CHECK(journal.open(path));
+    Recovered timers[32];
+    CHECK_EQ(26u, recover(journal, BOOT_NANOS + 39000 * MILLIS, WALL_MILLIS + 39000, timers, 32));
+    const Recovered* last = findTimer(timers, 26, "timer-49");
+    CHECK(last != nullptr);
+    if (last != nullptr) {
+        CHECK_EQ(2, last->status);
+        CHECK_EQ(561, last->remainingSeconds);
+    }
+    CHECK(findTimer(timers, 26, "timer-48") == nullptr);
+}
+
+TEST(reusedIdsAfterRemoval) {
+    char path[512];
+    journalPath(path, sizeof(path), "journal-reuse");
+    TimerJournal journal;
+    CHECK(journal.open(path));
+    CHECK(putTimer(journal, "x", "old", at(0, false, 1)));
+    CHECK(journal.remove("x", 1));
+    CHECK(putTimer(journal, "x", "new", at(0, false, 2)));
+    journal.close();
+
+    CHECK(journal.open(path));
+    Recovered timers[2];
+    CHECK_EQ(1u, recover(journal, BOOT_NANOS, WALL_MILLIS, timers, 2));
+    CHECK(strcmp(timers[0].metadata, "new") == 0);
+    CHECK_EQ(2, timers[0].remainingSeconds);
+}
+
+TEST(rejectsOversizedRecords) {
+    char path[512];
+    journalPath(path, sizeof(path), "journal-limits");
+    TimerJournal journal;
+    CHECK(journal.open(path));
+
+    char id[MAX_JOURNAL_ID_LENGTH + 2];
+    memset(id, 'i', sizeof(id));
+    CHECK(!journal.put(id, sizeof(id), nullptr, 0, at(0, false, 1)));
+    CHECK(!journal.put(id, 0, nullptr, 0, at(0, false, 1)));
+    CHECK(journal.put(id, MAX_JOURNAL_ID_LENGTH, nullptr, 0, at(0, false, 1)));
+
+    // Large metadata grows the file past its initial mapping
+    auto* metadata = static_cast<char*>(calloc(MAX_JOURNAL_METADATA_LENGTH + 1, 1));
+    CHECK(!journal.put("m", 1, metadata, MAX_JOURNAL_METADATA_LENGTH + 1, at(0, false, 1)));
+    CHECK(journal.put("m", 1, metadata, MAX_JOURNAL_METADATA_LENGTH, at(0, false, 1)));
+    free(metadata);
+    CHECK(fileSize(path) > static_cast<off_t>(MAX_JOURNAL_METADATA_LENGTH));
+    CHECK_EQ(2u, journal.stats().liveTimers);
+}
+
+/**
+ * A child appends as fast as it can, reporting over a pipe how many appends
+ * have returned. Killed at a random point, the journal must hold every
+ * acknowledged record plus at most the one in flight, and stay writable.
+ */
+TEST(recoversAfterKillMidWrite) {
+    for (int attempt = 0; attempt < 20; attempt++) {
+        char path[512];
+        journalPath(path, sizeof(path), "journal-kill");
+
+        int pipeFds[2];
+        CHECK(pipe(pipeFds) == 0);
+        const pid_t child = fork();
+        if (child == 0) {
+            close(pipeFds[0]);
+            TimerJournal journal;
+            if (!journal.open(path)) _exit(EXIT_FAILURE);
+            char id[32];
+            // Large enough metadata that kills often land inside a copy
+            static char metadata[4096];
+            memset(metadata, 'm', sizeof(metadata));
+            for (uint32_t i = 0;; i++) {
+                snprintf(id, sizeof(id), "timer-%u", i);
+                journal.put(id, strlen(id), metadata, 512 + i % 3584, at(1, true, 600, i));
+                if (write(pipeFds[1], &i, sizeof(i)) != sizeof(i)) _exit(EXIT_FAILURE);
+            }
+        }
+        CHECK(child > 0);
+        close(pipeFds[1]);
+
+        // Let it run until it has appended a varying amount, then kill it
+        const uint32_t target = 200 + static_cast<uint32_t>(attempt) * 97;
+        uint32_t acknowledged = 0;
+        uint32_t value = 0;
+        while (acknowledged < target && read(pipeFds[0], &value, sizeof(value)) == sizeof(value)) {
+            acknowledged = value + 1;
+        }
+        kill(child, SIGKILL);
+        // Drain acknowledgements written before the kill
+        while (read(pipeFds[0], &value, sizeof(value)) == sizeof(value)) acknowledged = value + 1;
+        close(pipeFds[0]);
+        int status = 0;
+        waitpid(child, &status, 0);
+        CHECK(WIFSIGNALED(status));
+
+        TimerJournal journal;
+        CHECK(journal.open(path));
+        const JournalStats stats = journal.stats();
+        CHECK(stats.liveTimers >= acknowledged);
+        CHECK(stats.liveTimers <= acknowledged + 1);
+        CHECK_EQ(stats.liveTimers, stats.records);
+
+        // Recovered timers have lost the time elapsed since their transition
+        static Recovered timers[8192];
+        const size_t count = recover(journal, BOOT_NANOS + 10000 * SECOND,
+                                     WALL_MILLIS + 10000 * 1000, timers, 8192);
+        CHECK_EQ(static_cast<size_t>(stats.liveTimers), count);
+        for (size_t i = 0; i < count; i++) CHECK_EQ(0, timers[i].remainingSeconds);
+
+        CHECK(putTimer(journal, "after", "", at(0, false, 1)));
+        journal.close();
+        CHECK(journal.open(path));
+        CHECK_EQ(stats.liveTimers + 1, journal.stats().liveTimers);
+        CHECK_EQ(0u, journal.stats().droppedBytes);
+    }
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
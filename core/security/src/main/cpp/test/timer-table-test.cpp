@@ -0,0 +1,130 @@
+/**
+ * Host tests for the native timer table
+ */
+
+#include <cstdio>
+
+#include "test/test-util.h"
+#include "timers/timer-table.h"
+
+using namespace bakingapp::timers;
+
+namespace {
+    constexpr int64_t SECOND = NANOS_PER_SECOND;
+    constexpr int64_t START = 1000 * SECOND;
+}
+
+TEST(reportsEachSecondOnce) {
+    TimerTable table;
+    const int32_t slot = table.add(3, true, START);
+    CHECK(slot >= 0);
+
+    TimerEvent events[4];
+    CHECK_EQ(0u, table.tick(START + SECOND / 2, events, 4));
+
+    CHECK_EQ(1u, table.tick(START + SECOND, events, 4));
+    CHECK_EQ(slot, events[0].slot);
+    CHECK_EQ(2, events[0].remainingSeconds);
+    CHECK_EQ(0u, table.tick(START + SECOND + SECOND / 3, events, 4));
+
+    CHECK_EQ(1u, table.tick(START + 2 * SECOND + 1, events, 4));
+    CHECK_EQ(1, events[0].remainingSeconds);
+}
+
+TEST(skippedSecondsCollapseIntoOneEvent) {
+    TimerTable table;
+    table.add(60, true, START);
+
+    TimerEvent events[4];
+    CHECK_EQ(1u, table.tick(START + 10 * SECOND + SECOND / 2, events, 4));
+    CHECK_EQ(50, events[0].remainingSeconds);
+}
+
+TEST(completesOnceAndStops) {
+    TimerTable table;
+    table.add(2, true, START);
+    CHECK_EQ(1u, table.runningCount());
+
+    TimerEvent events[4];
+    CHECK_EQ(1u, table.tick(START + 5 * SECOND, events, 4));
+    CHECK_EQ(0, events[0].remainingSeconds);
+    CHECK_EQ(0u, table.runningCount());
+    CHECK_EQ(0u, table.tick(START + 6 * SECOND, events, 4));
+}
+
+TEST(pausedTimersDoNotTick) {
+    TimerTable table;
+    const int32_t slot = table.add(10, true, START);
+
+    TimerEvent events[4];
+    CHECK_EQ(1u, table.tick(START + 3 * SECOND, events, 4));
+    CHECK_EQ(7, events[0].remainingSeconds);
+
+    CHECK(table.set(slot, 7, false, START + 3 * SECOND + SECOND / 2));
+    CHECK_EQ(0u, table.tick(START + 60 * SECOND, events, 4));
+
+    // Resuming re-anchors the deadline on the resume time
+    CHECK(table.set(slot, 7, true, START + 100 * SECOND));
+    CHECK_EQ(0u, table.tick(START + 100 * SECOND + SECOND / 2, events, 4));
+    CHECK_EQ(1u, table.tick(START + 101 * SECOND, events, 4));
+    CHECK_EQ(6, events[0].remainingSeconds);
+}
+
+TEST(startingAtZeroCompletesOnNextTick) {
+    TimerTable table;
+    const int32_t slot = table.add(0, true, START);
+
+    TimerEvent events[4];
+    CHECK_EQ(1u, table.tick(START, events, 4));
+    CHECK_EQ(slot, events[0].slot);
+    CHECK_EQ(0, events[0].remainingSeconds);
+}
+
+TEST(overflowStaysPending) {
+    TimerTable table;
+    for (int i = 0; i < 5; i++) table.add(30, true, START);
+
+    TimerEvent events[3];
+    CHECK_EQ(3u, table.tick(START + SECOND, events, 3));
+    CHECK_EQ(2u, table.tick(START + SECOND, events, 3));
+    CHECK_EQ(3, events[0].slot);
+    CHECK_EQ(4, events[1].slot);
+    CHECK_EQ(0u, table.tick(START + SECOND, events, 3));
+}
+
+TEST(removedSlotsAreReused) {
+    TimerTable table;
+    const int32_t first = table.add(5, true, START);
+    const int32_t second = table.add(5, true, START);
+    CHECK(first != second);
+    CHECK_EQ(2u, table.size());
+
+    CHECK(table.remove(first));
+    CHECK(!table.remove(first));
+    CHECK(!table.set(first, 5, true, START));
+    CHECK_EQ(1u, table.size());
+    CHECK_EQ(1u, table.runningCount());
+
+    TimerEvent events[4];
+    CHECK_EQ(1u, table.tick(START + SECOND, events, 4));
+    CHECK_EQ(second, events[0].slot);
+
+    CHECK_EQ(first, table.add(9, false, START));
+}
+
+TEST(growsPastInitialCapacity) {
+    TimerTable table;
+    constexpr int COUNT = 1000;
+    for (int i = 0; i < COUNT; i++) {
+        CHECK_EQ(i, table.add(1 + i % 7, true, START));
+    }
+
+    TimerEvent events[COUNT];
+    CHECK_EQ(static_cast<size_t>(COUNT), table.tick(START + 10 * SECOND, events, COUNT));
+    for (int i = 0; i < COUNT; i++) CHECK_EQ(0, events[i].remainingSeconds);
+    CHECK_EQ(0u, table.runningCount());
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,161 @@
+/**
+ * Host tests for the ISO-8601 batch parser: accepted forms, calendar
+ * checks against timegm(), line batches and timestamps read straight from
+ * a recipe list body
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "sync/json-records.h"
+#include "sync/timestamps.h"
+#include "test/test-util.h"
+
+using namespace bakingapp::sync;
+
+namespace {
+    int64_t parse(const char* text) {
+        int64_t millis = NO_TIMESTAMP;
+        return parseTimestamp(text, strlen(text), &millis) ? millis : NO_TIMESTAMP;
+    }
+
+    size_t parseRecords(const char* json, const char* const* fields, size_t fieldCount,
+                        int64_t* out, size_t capacity) {
+        return parseRecordTimestamps(reinterpret_cast<const uint8_t*>(json), strlen(json),
+                                     "recipes", fields, fieldCount, out, capacity);
+    }
+}
+
+TEST(parsesOffsetsAndFractions) {
+    CHECK_EQ(0, parse("1970-01-01T00:00:00Z"));
+    CHECK_EQ(1709210096789, parse("2024-02-29T12:34:56.789Z"));
+    CHECK_EQ(1709210096789, parse("2024-02-29t12:34:56.789z"));
+    CHECK_EQ(1709210096789, parse("2024-02-29 12:34:56,789"));
+    CHECK_EQ(1709210096789, parse("2024-02-29T12:34:56.789123456+00:00"));
+    CHECK_EQ(1709190296789, parse("2024-02-29T12:34:56.789+05:30"));
+    CHECK_EQ(1709190296789, parse("2024-02-29T12:34:56.789+0530"));
+    CHECK_EQ(1709210096700, parse("2024-02-29T12:34:56.7Z"));
+    CHECK_EQ(951897600000, parse("2000-03-01T00:00:00-08:00"));
+    CHECK_EQ(951897600000, parse("2000-03-01T00:00:00-08"));
+    CHECK_EQ(-1, parse("1969-12-31T23:59:59.999Z"));
+    CHECK_EQ(-62135596800000, parse("0001-01-01T00:00:00Z"));
+    CHECK_EQ(253402300799000, parse("9999-12-31T23:59:59Z"));
+    CHECK_EQ(1709164800000, parse("2024-02-29"));
+}
+
+TEST(rejectsMalformedTimestamps) {
+    const char* const REJECTED[] = {
+        "",
+        "2024-02-29T12:34",
+        "2024-02-29T12:34:5",
+        "2024/02/29T12:34:56Z",
+        "2024-02-29X12:34:56Z",
+        "2024-02-29T12-34:56Z",
+        "2024-02-29T12:34-56Z",
+        "2024-0a-29T12:34:56Z",
+        "2023-02-29T00:00:00Z",     // not a leap year
+        "1900-02-29T00:00:00Z",
+        "2024-13-01T00:00:00Z",
+        "2024-00-01T00:00:00Z",
+        "2024-04-31T00:00:00Z",
+        "2024-01-01T24:00:00Z",
+        "2024-01-01T00:60:00Z",
+        "2024-01-01T00:00:60Z",
+        "2024-01-01T00:00:00.Z",
+        "2024-01-01T00:00:00.1234567890Z",
+        "2024-01-01T00:00:00Zjunk",
+        "2024-01-01T00:00:00+5:30",
+        "2024-01-01T00:00:00+05:3",
+        "2024-01-01T00:00:00+24:00",
+        "2024-01-01T00:00:00+05:60",
+        "2024-01-01T00:00:00 ",
+        "2024-1-01",
+        "2024-01-01Z",
+    };
+    for (const char* text : REJECTED) {
+        int64_t millis = 42;
+        CHECK(!parseTimestamp(text, strlen(text), &millis));
+        CHECK_EQ(42, millis);
+    }
+    // 2000 is a leap year
+    CHECK(parse("2000-02-29T00:00:00Z") != NO_TIMESTAMP);
+}
+
+TEST(matchesTimegmAcrossTheCalendar) {
+    char text[40];
+    for (int64_t day = -719162; day < 2932896; day += 97) {
+        const time_t seconds = static_cast<time_t>(day * 86400 + (day * 7919) % 86400);
+        tm parts {};
+        gmtime_r(&seconds, &parts);
+        strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &parts);
+        if (parts.tm_year + 1900 < 1000) continue;  // %Y does not pad
+        CHECK_EQ(static_cast<int64_t>(timegm(&parts)) * 1000, parse(text));
+    }
+}
+
+TEST(parsesLineBatches) {
+    const char* text = "2024-02-29T12:34:56.789Z\n\nnot a timestamp\n1970-01-01T00:00:01Z";
+    int64_t out[4];
+    CHECK_EQ(4u, parseTimestampLines(text, strlen(text), out, 4));
+    CHECK_EQ(1709210096789, out[0]);
+    CHECK_EQ(NO_TIMESTAMP, out[1]);
+    CHECK_EQ(NO_TIMESTAMP, out[2]);
+    CHECK_EQ(1000, out[3]);
+
+    // Lines past capacity are counted, not written
+    int64_t first[2] = {7, 7};
+    CHECK_EQ(4u, parseTimestampLines(text, strlen(text), first, 1));
+    CHECK_EQ(1709210096789, first[0]);
+    CHECK_EQ(7, first[1]);
+}
+
+TEST(parsesRecordFieldsInPlace) {
+    const char* json =
+        R"({"page":1,"recipes":[)"
+        R"({"id":"a","created_at":"2024-02-29T12:34:56.789Z","updated_at":null,)"
+        R"("steps":[{"created_at":"1970-01-01T00:00:00Z"}]},)"
+        R"({"updated_at":"1970-01-01T00:00:01Z","id":"b"},)"
+        R"({"id":"c","created_at":"1970-01-01T00:00:02\u005A","updated_at":17},)"
+        R"({"id":"d","created_at":"yesterday"}]})";
+    const char* const fields[] = {"created_at", "updated_at"};
+
+    int64_t out[8];
+    CHECK_EQ(4u, parseRecords(json, fields, 2, out, 8));
+    CHECK_EQ(1709210096789, out[0]);
+    CHECK_EQ(NO_TIMESTAMP, out[1]);
+    CHECK_EQ(NO_TIMESTAMP, out[2]);        // nested fields are not the record's
+    CHECK_EQ(1000, out[3]);
+    CHECK_EQ(2000, out[4]);                // escaped
+    CHECK_EQ(NO_TIMESTAMP, out[5]);
+    CHECK_EQ(NO_TIMESTAMP, out[6]);
+    CHECK_EQ(NO_TIMESTAMP, out[7]);
+
+    // Counting pass, partial capacity, and failures
+    CHECK_EQ(4u, parseRecords(json, fields, 2, nullptr, 0));
+    int64_t partial[3] = {7, 7, 7};
+    CHECK_EQ(4u, parseRecords(json, fields, 2, partial, 3));
+    CHECK_EQ(7, partial[2]);
+    CHECK_EQ(SIZE_MAX, parseRecords(R"({"recipes":[{"id":"a",)", fields, 2, out, 8));
+    CHECK_EQ(SIZE_MAX, parseRecords(R"({"items":[]})", fields, 2, out, 8));
+    CHECK_EQ(SIZE_MAX, parseRecords(json, fields, 0, out, 8));
+    const char* const tooMany[MAX_RECORD_FIELDS + 1] = {"a", "b", "c", "d", "e"};
+    CHECK_EQ(SIZE_MAX, parseRecords(json, tooMany, MAX_RECORD_FIELDS + 1, out, 8));
+
+    // Capturing fields leaves the id ranges alone
+    JsonRecordScanner scanner;
+    JsonRecord record;
+    CHECK(scanner.captureFields(fields, 2));
+    CHECK(scanner.open(reinterpret_cast<const uint8_t*>(json), strlen(json), "recipes"));
+    CHECK(scanner.next(&record));
+    CHECK(scanner.next(&record));
+    CHECK_EQ(1u, record.idLength);
+    CHECK_EQ('b', json[record.idOffset]);
+    CHECK_EQ(0u, record.fieldLengths[0]);
+    CHECK_EQ(strlen("\"1970-01-01T00:00:01Z\""), record.fieldLengths[1]);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
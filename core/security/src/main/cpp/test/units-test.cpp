@@ -0,0 +1,161 @@
+/**
+ * Host tests for the unit interner and the ingredient scaling kernel
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "bench/bench-util.h"
+#include "test/test-util.h"
+#include "units/ingredient-scaler.h"
+#include "units/unit-interner.h"
+
+using namespace bakingapp;
+using namespace bakingapp::units;
+
+namespace {
+    uint8_t intern(UnitInterner& interner, const char* text) {
+        return interner.intern(text, strlen(text));
+    }
+
+    bool near(double expected, double actual) {
+        return std::fabs(expected - actual) <= 1e-9 * std::fmax(1.0, std::fabs(expected));
+    }
+
+    struct Converted {
+        double quantity;
+        uint8_t unit;
+    };
+
+    Converted convert(double quantity, uint8_t unit, double factor, UnitSystem system) {
+        Converted result {};
+        scaleQuantities(&quantity, &unit, 1, factor, system, &result.quantity, &result.unit);
+        return result;
+    }
+}
+
+TEST(normalizesAndMatchesAliases) {
+    UnitInterner interner;
+    CHECK_EQ(CUP, intern(interner, "cups"));
+    CHECK_EQ(CUP, intern(interner, "  Cup. "));
+    CHECK_EQ(TABLESPOON, intern(interner, "Tbsp"));
+    CHECK_EQ(FLUID_OUNCE, intern(interner, "fl   oz"));
+    CHECK_EQ(FLUID_OUNCE, intern(interner, "Fluid Ounces"));
+    CHECK_EQ(GRAM, intern(interner, "g"));
+    CHECK_EQ(NONE, intern(interner, ""));
+    CHECK_EQ(NONE, intern(interner, "   "));
+    CHECK_EQ(0u, interner.dynamicCount());
+}
+
+TEST(internsUnknownUnitsStably) {
+    UnitInterner interner;
+    const uint8_t handful = intern(interner, "handful");
+    CHECK(handful >= FIRST_DYNAMIC_UNIT);
+    CHECK_EQ(handful, intern(interner, "Handful"));
+    CHECK(intern(interner, "sprig") != handful);
+    CHECK_EQ(2u, interner.dynamicCount());
+
+    char name[MAX_UNIT_LENGTH + 1];
+    CHECK(interner.name(handful, name, sizeof(name)));
+    CHECK(strcmp(name, "handful") == 0);
+    CHECK(interner.name(TABLESPOON, name, sizeof(name)));
+    CHECK(strcmp(name, "tbsp") == 0);
+    CHECK(!interner.name(FIRST_DYNAMIC_UNIT + 100, name, sizeof(name)));
+
+    const char tooLong[] = "a unit name that is far too long to intern";
+    CHECK_EQ(UNKNOWN_UNIT, intern(interner, tooLong));
+}
+
+TEST(dynamicRangeFillsUpToUnknown) {
+    UnitInterner interner;
+    char text[16];
+    uint8_t last = 0;
+    for (int i = 0; i < UNKNOWN_UNIT - FIRST_DYNAMIC_UNIT; i++) {
+        snprintf(text, sizeof(text), "custom-%d", i);
+        last = intern(interner, text);
+    }
+    CHECK_EQ(UNKNOWN_UNIT - 1, last);
+    CHECK_EQ(UNKNOWN_UNIT, intern(interner, "one-more"));
+    CHECK_EQ(FIRST_DYNAMIC_UNIT, intern(interner, "custom-0"));
+}
+
+TEST(originalSystemOnlyScales) {
+    Converted r = convert(2.0, CUP, 1.5, UnitSystem::ORIGINAL);
+    CHECK(near(3.0, r.quantity));
+    CHECK_EQ(CUP, r.unit);
+    r = convert(3.0, PIECE, 2.0, UnitSystem::METRIC);
+    CHECK(near(6.0, r.quantity));
+    CHECK_EQ(PIECE, r.unit);
+    r = convert(1.0, FIRST_DYNAMIC_UNIT + 3, 0.5, UnitSystem::IMPERIAL);
+    CHECK(near(0.5, r.quantity));
+    CHECK_EQ(FIRST_DYNAMIC_UNIT + 3, r.unit);
+}
+
+TEST(convertsToMetricWithMagnitudeLadder) {
+    Converted r = convert(1.0, CUP, 1.0, UnitSystem::METRIC);
+    CHECK(near(236.5882365, r.quantity));
+    CHECK_EQ(MILLILITER, r.unit);
+    r = convert(8.0, CUP, 1.0, UnitSystem::METRIC);
+    CHECK(near(1.892705892, r.quantity));
+    CHECK_EQ(LITER, r.unit);
+    r = convert(500.0, GRAM, 2.0, UnitSystem::METRIC);
+    CHECK(near(1.0, r.quantity));
+    CHECK_EQ(KILOGRAM, r.unit);
+    r = convert(1.0, POUND, 1.0, UnitSystem::METRIC);
+    CHECK(near(453.59237, r.quantity));
+    CHECK_EQ(GRAM, r.unit);
+}
+
+TEST(convertsToImperialWithMagnitudeLadder) {
+    Converted r = convert(3.0, TEASPOON, 1.0, UnitSystem::IMPERIAL);
+    CHECK(near(1.0, r.quantity));
+    CHECK_EQ(TABLESPOON, r.unit);
+    r = convert(2.0, TEASPOON, 1.0, UnitSystem::IMPERIAL);
+    CHECK(near(2.0, r.quantity));
+    CHECK_EQ(TEASPOON, r.unit);
+    r = convert(4.0, TABLESPOON, 1.0, UnitSystem::IMPERIAL);
+    CHECK(near(0.25, r.quantity));
+    CHECK_EQ(CUP, r.unit);
+    r = convert(250.0, MILLILITER, 1.0, UnitSystem::IMPERIAL);
+    CHECK(near(250.0 / 236.5882365, r.quantity));
+    CHECK_EQ(CUP, r.unit);
+    r = convert(16.0, OUNCE, 1.0, UnitSystem::IMPERIAL);
+    CHECK(near(1.0, r.quantity));
+    CHECK_EQ(POUND, r.unit);
+    r = convert(100.0, GRAM, 1.0, UnitSystem::IMPERIAL);
+    CHECK(near(100.0 / 28.349523125, r.quantity));
+    CHECK_EQ(OUNCE, r.unit);
+}
+
+TEST(simdKernelMatchesScalarReference) {
+    // Odd length exercises the scalar tail
+    constexpr size_t N = 1001;
+    static double quantities[N], simd[N], scalar[N];
+    static uint8_t units[N], simdUnits[N], scalarUnits[N];
+    bench::Random random(7);
+    for (size_t i = 0; i < N; i++) {
+        quantities[i] = random.below(100000) / 100.0;
+        units[i] = static_cast<uint8_t>(random.below(4) == 0 ? FIRST_DYNAMIC_UNIT + random.below(4)
+                                                             : random.below(BUILTIN_UNIT_COUNT));
+    }
+    for (uint8_t s = 0; s < UNIT_SYSTEM_COUNT; s++) {
+        const auto system = static_cast<UnitSystem>(s);
+        scaleQuantities(quantities, units, N, 1.75, system, simd, simdUnits);
+        scaleQuantitiesScalar(quantities, units, N, 1.75, system, scalar, scalarUnits);
+        CHECK(memcmp(simd, scalar, sizeof(simd)) == 0);
+        CHECK(memcmp(simdUnits, scalarUnits, sizeof(simdUnits)) == 0);
+    }
+
+    // In place
+    memcpy(simd, quantities, sizeof(simd));
+    memcpy(simdUnits, units, sizeof(simdUnits));
+    scaleQuantities(simd, simdUnits, N, 1.75, UnitSystem::METRIC, simd, simdUnits);
+    scaleQuantitiesScalar(quantities, units, N, 1.75, UnitSystem::METRIC, scalar, scalarUnits);
+    CHECK(memcmp(simd, scalar, sizeof(simd)) == 0);
+    CHECK(memcmp(simdUnits, scalarUnits, sizeof(simdUnits)) == 0);
+}
+
+int main() {
+    return bakingapp::test::runTests();
+}
@@ -0,0 +1,104 @@
+/**
+ * JNI bridge for the native timer table
+ *
+ * The caller passes its clock (SystemClock.elapsedRealtimeNanos, which
+ * keeps counting in deep sleep) and a direct buffer; one nativeTick call
+ * returns every changed timer and completion as (slot, seconds) int pairs.
+ */
+
+#include <jni.h>
+
+#include "common/native-memory.h"
+#include "telemetry/telemetry.h"
+#include "timers/timer-table.h"
+
+using bakingapp::MemoryTag;
+using bakingapp::telemetry::EventType;
+using bakingapp::telemetry::Telemetry;
+using bakingapp::timers::TimerEvent;
+using bakingapp::timers::TimerTable;
+
+namespace {
+    TimerTable* fromHandle(jlong handle) {
+        return reinterpret_cast<TimerTable*>(handle);
+    }
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerTickEngine_nativeCreate(
+        JNIEnv* /* env */,
+        jobject /* thiz */
+) {
+    return reinterpret_cast<jlong>(bakingapp::createTagged<TimerTable>(MemoryTag::TIMERS));
+}
+
+/**
+ * @return the new timer's slot, or -1 when out of memory
+ */
+JNIEXPORT jint JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerTickEngine_nativeAdd(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle,
+        jlong remainingSeconds,
+        jboolean running,
+        jlong nowNanos
+) {
+    TimerTable* table = fromHandle(handle);
+    if (table == nullptr) return -1;
+    return table->add(remainingSeconds, running == JNI_TRUE, nowNanos);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerTickEngine_nativeSet(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle,
+        jint slot,
+        jlong remainingSeconds,
+        jboolean running,
+        jlong nowNanos
+) {
+    TimerTable* table = fromHandle(handle);
+    return table != nullptr && table->set(slot, remainingSeconds, running == JNI_TRUE, nowNanos)
+        ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerTickEngine_nativeRemove(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle,
+        jint slot
+) {
+    TimerTable* table = fromHandle(handle);
+    return table != nullptr && table->remove(slot) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return the number of 8-byte events written to the buffer
+ */
+JNIEXPORT jint JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerTickEngine_nativeTick(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jlong nowNanos,
+        jobject buffer
+) {
+    TimerTable* table = fromHandle(handle);
+    if (table == nullptr || buffer == nullptr) return 0;
+
+    void* address = env->GetDirectBufferAddress(buffer);
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (address == nullptr || capacity < 0) return 0;
+    const size_t events = table->tick(nowNanos, static_cast<TimerEvent*>(address),
+                                      static_cast<size_t>(capacity) / sizeof(TimerEvent));
+    Telemetry::shared().record(EventType::TIMER_TICK, static_cast<uint32_t>(events),
+                               table->size());
+    return static_cast<jint>(events);
+}
+
+} // extern "C"
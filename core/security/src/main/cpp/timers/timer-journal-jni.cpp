@@ -0,0 +1,211 @@
+/**
+ * JNI bridge for the crash-safe timer journal
+ *
+ * Every call takes the caller's clocks (SystemClock.elapsedRealtimeNanos and
+ * System.currentTimeMillis) so the journal itself never reads time; recovery
+ * returns the snapshot described in timer-journal.h as one byte array.
+ */
+
+#include <jni.h>
+#include <cstdlib>
+
+#include "common/jni-text.h"
+#include "common/native-memory.h"
+#include "timers/timer-journal.h"
+
+using bakingapp::JniText;
+using bakingapp::MemoryTag;
+using bakingapp::taggedFree;
+using bakingapp::taggedRealloc;
+using bakingapp::timers::JournalState;
+using bakingapp::timers::JournalStats;
+using bakingapp::timers::TimerJournal;
+
+namespace {
+    TimerJournal* fromHandle(jlong handle) {
+        return reinterpret_cast<TimerJournal*>(handle);
+    }
+
+    JournalState stateOf(jint status, jboolean running, jlong remainingSeconds,
+                         jlong monotonicNanos, jlong wallMillis) {
+        return {static_cast<uint8_t>(status), running == JNI_TRUE, remainingSeconds,
+                monotonicNanos, wallMillis};
+    }
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerJournal_nativeOpen(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jstring file
+) {
+    if (file == nullptr) return 0;
+
+    const char* path = env->GetStringUTFChars(file, nullptr);
+    if (path == nullptr) return 0;
+    auto* journal = bakingapp::createTagged<TimerJournal>(MemoryTag::TIMERS);
+    bool opened = journal != nullptr && journal->open(path);
+    env->ReleaseStringUTFChars(file, path);
+
+    if (!opened) {
+        bakingapp::destroyTagged(journal);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(journal);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerJournal_nativePut(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id,
+        jbyteArray metadata,
+        jint status,
+        jboolean running,
+        jlong remainingSeconds,
+        jlong monotonicNanos,
+        jlong wallMillis
+) {
+    TimerJournal* journal = fromHandle(handle);
+    if (journal == nullptr || metadata == nullptr) return JNI_FALSE;
+
+    JniText key(env, id);
+    if (key.chars() == nullptr) return JNI_FALSE;
+    jsize length = env->GetArrayLength(metadata);
+    jbyte* bytes = env->GetByteArrayElements(metadata, nullptr);
+    if (bytes == nullptr) return JNI_FALSE;
+    bool stored = journal->put(key.chars(), key.length(), bytes, static_cast<size_t>(length),
+                               stateOf(status, running, remainingSeconds, monotonicNanos,
+                                       wallMillis));
+    env->ReleaseByteArrayElements(metadata, bytes, JNI_ABORT);
+    return stored ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return false if the timer was never put or has been removed
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerJournal_nativeTransition(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id,
+        jint status,
+        jboolean running,
+        jlong remainingSeconds,
+        jlong monotonicNanos,
+        jlong wallMillis
+) {
+    TimerJournal* journal = fromHandle(handle);
+    if (journal == nullptr) return JNI_FALSE;
+
+    JniText key(env, id);
+    if (key.chars() == nullptr) return JNI_FALSE;
+    return journal->transition(key.chars(), key.length(),
+                               stateOf(status, running, remainingSeconds, monotonicNanos,
+                                       wallMillis))
+        ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerJournal_nativeRemove(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jstring id
+) {
+    TimerJournal* journal = fromHandle(handle);
+    if (journal == nullptr) return JNI_FALSE;
+
+    JniText key(env, id);
+    if (key.chars() == nullptr) return JNI_FALSE;
+    return journal->remove(key.chars(), key.length()) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return every live timer as of now, or null on failure
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerJournal_nativeRecover(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle,
+        jlong monotonicNanos,
+        jlong wallMillis
+) {
+    TimerJournal* journal = fromHandle(handle);
+    if (journal == nullptr) return nullptr;
+
+    // Another thread may put between sizing and copying; retry until it fits
+    size_t capacity = journal->snapshot(monotonicNanos, wallMillis, nullptr, 0);
+    uint8_t* buffer = nullptr;
+    size_t used = 0;
+    for (;;) {
+        auto* grown = static_cast<uint8_t*>(
+            taggedRealloc(MemoryTag::TIMERS, buffer, capacity > 0 ? capacity : 1));
+        if (grown == nullptr) {
+            taggedFree(buffer);
+            return nullptr;
+        }
+        buffer = grown;
+        used = journal->snapshot(monotonicNanos, wallMillis, buffer, capacity);
+        if (used <= capacity) break;
+        capacity = used;
+    }
+
+    jbyteArray result = env->NewByteArray(static_cast<jsize>(used));
+    if (result != nullptr && used > 0) {
+        env->SetByteArrayRegion(result, 0, static_cast<jsize>(used),
+                                reinterpret_cast<const jbyte*>(buffer));
+    }
+    taggedFree(buffer);
+    return result;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerJournal_nativeNeedsCompaction(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    TimerJournal* journal = fromHandle(handle);
+    return journal != nullptr && journal->needsCompaction() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerJournal_nativeCompact(
+        JNIEnv* /* env */,
+        jobject /* thiz */,
+        jlong handle
+) {
+    TimerJournal* journal = fromHandle(handle);
+    return journal != nullptr && journal->compact() ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * @return [liveTimers, records, usedBytes, liveBytes, droppedBytes]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_eslam_bakingapp_core_security_timers_NativeTimerJournal_nativeStats(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jlong handle
+) {
+    TimerJournal* journal = fromHandle(handle);
+    JournalStats stats = journal != nullptr ? journal->stats() : JournalStats{};
+    const jlong values[] = {
+        static_cast<jlong>(stats.liveTimers),
+        static_cast<jlong>(stats.records),
+        static_cast<jlong>(stats.usedBytes),
+        static_cast<jlong>(stats.liveBytes),
+        static_cast<jlong>(stats.droppedBytes),
+    };
+    jlongArray result = env->NewLongArray(5);
+    if (result != nullptr) env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+} // extern "C"
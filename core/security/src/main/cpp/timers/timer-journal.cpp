@@ -0,0 +1,427 @@
+#include "timers/timer-journal.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+#include "common/hash.h"
+#include "common/native-memory.h"
+
+namespace bakingapp::timers {
+
+namespace {
+    constexpr uint32_t JOURNAL_MAGIC = 0x4A544B42; // "BKTJ"
+    constexpr uint32_t JOURNAL_VERSION = 1;
+    constexpr size_t INITIAL_FILE_SIZE = 16 * 1024;
+    constexpr size_t FILE_GROWTH_ALIGNMENT = 4096;
+    constexpr uint64_t COMPACTION_MIN_BYTES = 64 * 1024;
+
+    // Wall time may run ahead of monotonic time by this much before the
+    // journal assumes the device rebooted since the transition
+    constexpr int64_t SAME_BOOT_TOLERANCE_MILLIS = 60 * 1000;
+
+    enum : uint8_t { OP_PUT = 1, OP_TRANSITION = 2, OP_REMOVE = 3 };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t reserved;
+    };
+
+    struct RecordHeader {
+        uint32_t crc;           // CRC32 of the rest of the record
+        uint32_t length;        // unpadded, this header included
+        uint8_t op;
+        uint8_t status;
+        uint8_t running;
+        uint8_t idLength;
+        uint32_t metadataLength;
+        int64_t remainingSeconds;
+        int64_t monotonicNanos;
+        int64_t wallMillis;
+    };
+
+    struct SnapshotHeader {
+        uint8_t status;
+        uint8_t running;
+        uint16_t idLength;
+        uint32_t metadataLength;
+        int64_t remainingSeconds;
+    };
+
+    static_assert(sizeof(FileHeader) == 16, "file layout");
+    static_assert(sizeof(RecordHeader) == 40, "file layout");
+    static_assert(sizeof(SnapshotHeader) == 16, "snapshot layout");
+
+    constexpr uint64_t align8(uint64_t value) {
+        return (value + 7) & ~uint64_t {7};
+    }
+
+    uint32_t recordCrc(const uint8_t* record, uint32_t length) {
+        const auto crc = crc32(0L, record + sizeof(uint32_t),
+                               static_cast<uInt>(length - sizeof(uint32_t)));
+        return static_cast<uint32_t>(crc);
+    }
+
+    /**
+     * Time since a transition. The monotonic clock is exact within one boot
+     * and ignores wall clock changes; across a reboot it restarts, and only
+     * wall time covers the gap. A wall clock moved forward looks the same as
+     * a reboot, which at worst completes a timer early.
+     */
+    int64_t elapsedMillis(const JournalState& state, int64_t nowMonotonicNanos,
+                          int64_t nowWallMillis) {
+        const int64_t monotonic = (nowMonotonicNanos - state.monotonicNanos) / 1000000;
+        const int64_t wall = nowWallMillis - state.wallMillis;
+        if (monotonic >= 0 && wall < monotonic + SAME_BOOT_TOLERANCE_MILLIS) return monotonic;
+        return wall > 0 ? wall : 0;
+    }
+}
+
+TimerJournal::~TimerJournal() {
+    close();
+}
+
+bool TimerJournal::open(const char* path) {
+    LockGuard lock(mutex_);
+    const size_t length = strlen(path);
+    if (length >= sizeof(path_)) return false;
+    memcpy(path_, path, length + 1);
+    if (!file_.open(path_, INITIAL_FILE_SIZE)) return false;
+    return replay();
+}
+
+void TimerJournal::close() {
+    LockGuard lock(mutex_);
+    file_.close();
+    taggedFree(entries_);
+    taggedFree(buckets_);
+    entries_ = nullptr;
+    buckets_ = nullptr;
+    entryCount_ = entryCapacity_ = bucketCount_ = 0;
+    liveCount_ = 0;
+    liveBytes_ = 0;
+    end_ = 0;
+    records_ = 0;
+}
+
+bool TimerJournal::isOpen() {
+    LockGuard lock(mutex_);
+    return file_.isOpen();
+}
+
+bool TimerJournal::replay() {
+    entryCount_ = 0;
+    liveCount_ = 0;
+    liveBytes_ = sizeof(FileHeader);
+    records_ = 0;
+    droppedBytes_ = 0;
+    if (buckets_ != nullptr) memset(buckets_, 0, bucketCount_ * sizeof(uint32_t));
+
+    uint8_t* data = file_.data();
+    const size_t size = file_.size();
+    FileHeader header {};
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION) {
+        // New file, or one this version cannot read: start over
+        bool blank = true;
+        for (size_t i = 0; i < size && blank; i++) blank = data[i] == 0;
+        if (!blank) {
+            droppedBytes_ = size;
+            memset(data, 0, size);
+        }
+        header = {JOURNAL_MAGIC, JOURNAL_VERSION, 0};
+        memcpy(data, &header, sizeof(header));
+        end_ = sizeof(FileHeader);
+        return true;
+    }
+
+    uint64_t position = sizeof(FileHeader);
+    while (position + sizeof(RecordHeader) <= size) {
+        RecordHeader record {};
+        memcpy(&record, data + position, sizeof(record));
+        if (record.length == 0 && record.crc == 0) break;
+
+        const uint64_t expected =
+            sizeof(RecordHeader) + uint64_t {record.idLength} + record.metadataLength;
+        if (record.length != expected || position + align8(record.length) > size ||
+            record.idLength == 0 || recordCrc(data + position, record.length) != record.crc) {
+            break;
+        }
+
+        const JournalState state {record.status, record.running != 0, record.remainingSeconds,
+                                  record.monotonicNanos, record.wallMillis};
+        apply(record.op, position, record.length, state);
+        position += align8(record.length);
+        records_++;
+    }
+    end_ = position;
+
+    // Whatever follows the last valid record is a torn append, at most one
+    // record long; clear it so the next append starts from zeros
+    const uint64_t tornLimit = position +
+        align8(sizeof(RecordHeader) + MAX_JOURNAL_ID_LENGTH + MAX_JOURNAL_METADATA_LENGTH);
+    size_t last = tornLimit < size ? static_cast<size_t>(tornLimit) : size;
+    while (last > position && data[last - 1] == 0) last--;
+    if (last > position) {
+        droppedBytes_ = last - position;
+        memset(data + position, 0, last - position);
+    }
+    return true;
+}
+
+const uint8_t* TimerJournal::recordId(uint64_t offset, size_t* length) const {
+    const uint8_t* record = file_.data() + offset;
+    *length = record[offsetof(RecordHeader, idLength)];
+    return record + sizeof(RecordHeader);
+}
+
+int32_t TimerJournal::find(uint64_t hash, const char* id, size_t idLength) const {
+    if (bucketCount_ == 0) return -1;
+    const uint32_t mask = bucketCount_ - 1;
+    for (uint32_t i = static_cast<uint32_t>(hash) & mask; buckets_[i] != 0; i = (i + 1) & mask) {
+        const Entry& entry = entries_[buckets_[i] - 1];
+        if (entry.hash != hash) continue;
+        size_t length = 0;
+        const uint8_t* stored = recordId(entry.putOffset, &length);
+        if (length == idLength && memcmp(stored, id, idLength) == 0) {
+            return static_cast<int32_t>(buckets_[i] - 1);
+        }
+    }
+    return -1;
+}
+
+bool TimerJournal::rebuildBuckets(uint32_t bucketCount) {
+    auto* buckets = static_cast<uint32_t*>(
+        taggedCalloc(MemoryTag::TIMERS, bucketCount, sizeof(uint32_t)));
+    if (buckets == nullptr) return false;
+    const uint32_t mask = bucketCount - 1;
+    for (uint32_t e = 0; e < entryCount_; e++) {
+        uint32_t i = static_cast<uint32_t>(entries_[e].hash) & mask;
+        while (buckets[i] != 0) i = (i + 1) & mask;
+        buckets[i] = e + 1;
+    }
+    taggedFree(buckets_);
+    buckets_ = buckets;
+    bucketCount_ = bucketCount;
+    return true;
+}
+
+/**
+ * Adds an entry for hash and returns its index, or -1 when out of memory
+ */
+int32_t TimerJournal::insert(uint64_t hash) {
+    if (entryCount_ == entryCapacity_) {
+        const uint32_t capacity = entryCapacity_ == 0 ? 16 : entryCapacity_ * 2;
+        auto* grown = static_cast<Entry*>(
+            taggedRealloc(MemoryTag::TIMERS, entries_, capacity * sizeof(Entry)));
+        if (grown == nullptr) return -1;
+        entries_ = grown;
+        entryCapacity_ = capacity;
+    }
+    if ((entryCount_ + 1) * 2 > bucketCount_ &&
+        !rebuildBuckets(bucketCount_ == 0 ? 32 : bucketCount_ * 2)) {
+        return -1;
+    }
+    const uint32_t index = entryCount_++;
+    entries_[index] = {};
+    entries_[index].hash = hash;
+    const uint32_t mask = bucketCount_ - 1;
+    uint32_t i = static_cast<uint32_t>(hash) & mask;
+    while (buckets_[i] != 0) i = (i + 1) & mask;
+    buckets_[i] = index + 1;
+    return static_cast<int32_t>(index);
+}
+
+void TimerJournal::apply(uint8_t op, uint64_t offset, uint32_t length,
+                         const JournalState& state) {
+    size_t idLength = 0;
+    const auto* id = reinterpret_cast<const char*>(recordId(offset, &idLength));
+    const uint64_t hash = hash64(id, idLength);
+    int32_t index = find(hash, id, idLength);
+
+    switch (op) {
+        case OP_PUT: {
+            if (index < 0) index = insert(hash);
+            if (index < 0) return;
+            Entry& entry = entries_[index];
+            if (entry.live) {
+                liveBytes_ -= align8(entry.putLength);
+            } else {
+                entry.live = true;
+                liveCount_++;
+            }
+            entry.putOffset = offset;
+            entry.putLength = length;
+            entry.state = state;
+            liveBytes_ += align8(length);
+            break;
+        }
+        case OP_TRANSITION:
+            if (index >= 0 && entries_[index].live) entries_[index].state = state;
+            break;
+        case OP_REMOVE:
+            if (index >= 0 && entries_[index].live) {
+                entries_[index].live = false;
+                liveCount_--;
+                liveBytes_ -= align8(entries_[index].putLength);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool TimerJournal::append(uint8_t op, const char* id, size_t idLength, const void* metadata,
+                          size_t metadataLength, const JournalState& state) {
+    if (!file_.isOpen() || idLength == 0 || idLength > MAX_JOURNAL_ID_LENGTH ||
+        metadataLength > MAX_JOURNAL_METADATA_LENGTH) {
+        return false;
+    }
+
+    const auto length = static_cast<uint32_t>(sizeof(RecordHeader) + idLength + metadataLength);
+    const uint64_t needed = end_ + align8(length);
+    if (needed > file_.size()) {
+        uint64_t size = file_.size() * 2;
+        if (size < needed) size = needed;
+        size = (size + FILE_GROWTH_ALIGNMENT - 1) & ~uint64_t {FILE_GROWTH_ALIGNMENT - 1};
+        if (!file_.resize(size)) return false;
+    }
+
+    uint8_t* record = file_.data() + end_;
+    RecordHeader header {};
+    header.length = length;
+    header.op = op;
+    header.status = state.status;
+    header.running = state.running ? 1 : 0;
+    header.idLength = static_cast<uint8_t>(idLength);
+    header.metadataLength = static_cast<uint32_t>(metadataLength);
+    header.remainingSeconds = state.remainingSeconds;
+    header.monotonicNanos = state.monotonicNanos;
+    header.wallMillis = state.wallMillis;
+
+    // Body first, CRC last: a kill anywhere before the final store leaves a
+    // record whose CRC does not match
+    memcpy(record + sizeof(RecordHeader), id, idLength);
+    if (metadataLength > 0) memcpy(record + sizeof(RecordHeader) + idLength, metadata, metadataLength);
+    memcpy(record, &header, sizeof(header));
+    const uint32_t crc = recordCrc(record, length);
+    memcpy(record, &crc, sizeof(crc));
+
+    const uint64_t offset = end_;
+    end_ += align8(length);
+    records_++;
+    apply(op, offset, length, state);
+    return true;
+}
+
+bool TimerJournal::put(const char* id, size_t idLength, const void* metadata,
+                       size_t metadataLength, const JournalState& state) {
+    LockGuard lock(mutex_);
+    return append(OP_PUT, id, idLength, metadata, metadataLength, state);
+}
+
+bool TimerJournal::transition(const char* id, size_t idLength, const JournalState& state) {
+    LockGuard lock(mutex_);
+    const int32_t index = find(hash64(id, idLength), id, idLength);
+    if (index < 0 || !entries_[index].live) return false;
+    return append(OP_TRANSITION, id, idLength, nullptr, 0, state);
+}
+
+bool TimerJournal::remove(const char* id, size_t idLength) {
+    LockGuard lock(mutex_);
+    const int32_t index = find(hash64(id, idLength), id, idLength);
+    if (index < 0 || !entries_[index].live) return false;
+    return append(OP_REMOVE, id, idLength, nullptr, 0, JournalState {});
+}
+
+size_t TimerJournal::snapshot(int64_t nowMonotonicNanos, int64_t nowWallMillis, uint8_t* out,
+                              size_t capacity) {
+    LockGuard lock(mutex_);
+    size_t required = 0;
+    for (uint32_t e = 0; e < entryCount_; e++) {
+        if (!entries_[e].live) continue;
+        const size_t payload = entries_[e].putLength - sizeof(RecordHeader);
+        required += align8(sizeof(SnapshotHeader) + payload);
+    }
+    if (required > capacity || out == nullptr) return required;
+
+    uint8_t* p = out;
+    for (uint32_t e = 0; e < entryCount_; e++) {
+        const Entry& entry = entries_[e];
+        if (!entry.live) continue;
+
+        const uint8_t* record = file_.data() + entry.putOffset;
+        RecordHeader stored {};
+        memcpy(&stored, record, sizeof(stored));
+
+        int64_t remaining = entry.state.remainingSeconds;
+        if (entry.state.running) {
+            const int64_t millis = remaining * 1000 -
+                elapsedMillis(entry.state, nowMonotonicNanos, nowWallMillis);
+            remaining = millis <= 0 ? 0 : (millis + 999) / 1000;
+        }
+
+        const SnapshotHeader header {entry.state.status,
+                                     static_cast<uint8_t>(entry.state.running ? 1 : 0),
+                                     stored.idLength, stored.metadataLength, remaining};
+        memcpy(p, &header, sizeof(header));
+        const size_t payload = entry.putLength - sizeof(RecordHeader);
+        memcpy(p + sizeof(header), record + sizeof(RecordHeader), payload);
+        const size_t written = sizeof(header) + payload;
+        memset(p + written, 0, align8(written) - written);
+        p += align8(written);
+    }
+    return required;
+}
+
+bool TimerJournal::needsCompaction() {
+    LockGuard lock(mutex_);
+    return end_ >= COMPACTION_MIN_BYTES && end_ > liveBytes_ * 2;
+}
+
+bool TimerJournal::compact() {
+    LockGuard lock(mutex_);
+    if (!file_.isOpen()) return false;
+
+    auto* buffer = static_cast<uint8_t*>(taggedCalloc(MemoryTag::TIMERS, 1, liveBytes_));
+    if (buffer == nullptr) return false;
+    const FileHeader header {JOURNAL_MAGIC, JOURNAL_VERSION, 0};
+    memcpy(buffer, &header, sizeof(header));
+
+    // One PUT per live timer, carrying its latest state
+    uint64_t position = sizeof(FileHeader);
+    for (uint32_t e = 0; e < entryCount_; e++) {
+        const Entry& entry = entries_[e];
+        if (!entry.live) continue;
+        uint8_t* record = buffer + position;
+        memcpy(record, file_.data() + entry.putOffset, entry.putLength);
+
+        RecordHeader rewritten {};
+        memcpy(&rewritten, record, sizeof(rewritten));
+        rewritten.status = entry.state.status;
+        rewritten.running = entry.state.running ? 1 : 0;
+        rewritten.remainingSeconds = entry.state.remainingSeconds;
+        rewritten.monotonicNanos = entry.state.monotonicNanos;
+        rewritten.wallMillis = entry.state.wallMillis;
+        memcpy(record, &rewritten, sizeof(rewritten));
+        rewritten.crc = recordCrc(record, entry.putLength);
+        memcpy(record, &rewritten.crc, sizeof(rewritten.crc));
+        position += align8(entry.putLength);
+    }
+
+    const bool written = writeFileAtomically(path_, buffer, position);
+    taggedFree(buffer);
+    if (!written) return false;
+
+    if (!file_.open(path_, INITIAL_FILE_SIZE)) return false;
+    return replay();
+}
+
+JournalStats TimerJournal::stats() {
+    LockGuard lock(mutex_);
+    return {liveCount_, records_, end_, liveBytes_, droppedBytes_};
+}
+
+} // namespace bakingapp::timers
@@ -0,0 +1,142 @@
+/**
+ * Crash-safe journal of cooking-timer state transitions
+ *
+ * An append-only, mmap'd file of CRC32-checked records: PUT (a whole
+ * timer, with the caller's opaque metadata), TRANSITION (start, pause,
+ * resume, cancel, complete) and REMOVE. Ticks are never written: a running
+ * timer's remaining time is derived on recovery from its last transition's
+ * monotonic and wall-clock timestamps.
+ *
+ * Appends go through the MAP_SHARED mapping, so a record survives process
+ * death as soon as it is copied. A record torn by a kill mid-write fails
+ * its CRC and is dropped on the next open, together with anything after it.
+ * compact() rewrites the live timers into a fresh file and may run on a
+ * background thread while appends wait on the lock.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/mapped-file.h"
+#include "common/mutex.h"
+
+namespace bakingapp::timers {
+
+constexpr size_t MAX_JOURNAL_ID_LENGTH = 255;
+constexpr size_t MAX_JOURNAL_METADATA_LENGTH = 64 * 1024;
+
+/**
+ * A timer's state as of a transition
+ */
+struct JournalState {
+    uint8_t status;            // caller-defined, e.g. TimerStatus.ordinal
+    bool running;              // remaining time counts down while set
+    int64_t remainingSeconds;
+    int64_t monotonicNanos;    // SystemClock.elapsedRealtimeNanos
+    int64_t wallMillis;        // System.currentTimeMillis
+};
+
+struct JournalStats {
+    uint32_t liveTimers;
+    uint32_t records;
+    uint64_t usedBytes;        // header plus valid records
+    uint64_t liveBytes;        // what a compacted journal would use
+    uint64_t droppedBytes;     // torn or corrupt tail discarded by the last open
+};
+
+class TimerJournal {
+public:
+    TimerJournal() = default;
+    ~TimerJournal();
+
+    TimerJournal(const TimerJournal&) = delete;
+    TimerJournal& operator=(const TimerJournal&) = delete;
+
+    /**
+     * Opens or creates the journal and replays it into the in-memory index.
+     * A torn or corrupt tail is discarded.
+     */
+    bool open(const char* path);
+    void close();
+    bool isOpen();
+
+    /**
+     * Records a whole timer (created, edited or reset)
+     */
+    bool put(const char* id, size_t idLength, const void* metadata, size_t metadataLength,
+             const JournalState& state);
+
+    /**
+     * Records a state change of a timer that was put before
+     *
+     * @return false for unknown timers
+     */
+    bool transition(const char* id, size_t idLength, const JournalState& state);
+
+    bool remove(const char* id, size_t idLength);
+
+    /**
+     * Serializes every live timer as of now, running timers with their
+     * elapsed time subtracted. Entries are 8-byte aligned:
+     *
+     *   u8 status, u8 running, u16 idLength, u32 metadataLength,
+     *   i64 remainingSeconds, id bytes, metadata bytes, padding
+     *
+     * @return the bytes required; nothing is written if above capacity
+     */
+    size_t snapshot(int64_t nowMonotonicNanos, int64_t nowWallMillis, uint8_t* out,
+                    size_t capacity);
+
+    /**
+     * True once dead records outweigh live ones in a journal of some size
+     */
+    bool needsCompaction();
+
+    /**
+     * Rewrites the live timers into a new file that atomically replaces
+     * the journal
+     */
+    bool compact();
+
+    JournalStats stats();
+
+private:
+    struct Entry {
+        uint64_t hash;
+        uint64_t putOffset;     // latest PUT record, holds id and metadata
+        uint32_t putLength;
+        bool live;
+        JournalState state;
+    };
+
+    bool replay();
+    bool append(uint8_t op, const char* id, size_t idLength, const void* metadata,
+                size_t metadataLength, const JournalState& state);
+    void apply(uint8_t op, uint64_t offset, uint32_t length, const JournalState& state);
+    int32_t find(uint64_t hash, const char* id, size_t idLength) const;
+    int32_t insert(uint64_t hash);
+    bool rebuildBuckets(uint32_t bucketCount);
+    const uint8_t* recordId(uint64_t offset, size_t* length) const;
+
+    Mutex mutex_;
+    MappedFile file_;
+    char path_[512] = {};
+
+    uint64_t end_ = 0;
+    uint32_t records_ = 0;
+    uint64_t droppedBytes_ = 0;
+
+    Entry* entries_ = nullptr;
+    uint32_t entryCount_ = 0;
+    uint32_t entryCapacity_ = 0;
+    uint32_t liveCount_ = 0;
+    uint64_t liveBytes_ = 0;
+
+    // Open addressing over entries_, indices + 1 (0 = empty)
+    uint32_t* buckets_ = nullptr;
+    uint32_t bucketCount_ = 0;
+};
+
+} // namespace bakingapp::timers
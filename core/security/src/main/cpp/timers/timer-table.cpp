@@ -0,0 +1,152 @@
+#include "timers/timer-table.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "common/native-memory.h"
+
+namespace bakingapp::timers {
+
+namespace {
+    constexpr uint32_t INITIAL_CAPACITY = 64;
+
+    template <typename T>
+    bool growColumn(T*& column, uint32_t capacity) {
+        auto* grown = static_cast<T*>(
+            taggedRealloc(MemoryTag::TIMERS, column, capacity * sizeof(T)));
+        if (grown == nullptr) return false;
+        column = grown;
+        return true;
+    }
+
+    /**
+     * Whole seconds shown for a remaining duration, rounded up so a timer
+     * reads 1 until it actually reaches 0
+     */
+    int32_t displayedSeconds(int64_t remainingNanos) {
+        if (remainingNanos <= 0) return 0;
+        return static_cast<int32_t>((remainingNanos + NANOS_PER_SECOND - 1) / NANOS_PER_SECOND);
+    }
+}
+
+TimerTable::~TimerTable() {
+    taggedFree(nextChange_);
+    taggedFree(deadlines_);
+    taggedFree(reported_);
+    taggedFree(states_);
+    taggedFree(freeSlots_);
+}
+
+bool TimerTable::grow() {
+    const uint32_t capacity = capacity_ == 0 ? INITIAL_CAPACITY : capacity_ * 2;
+    // Columns that did grow keep their larger size; capacity_ only moves
+    // once all of them have
+    if (!growColumn(nextChange_, capacity) || !growColumn(deadlines_, capacity) ||
+        !growColumn(reported_, capacity) || !growColumn(states_, capacity) ||
+        !growColumn(freeSlots_, capacity)) {
+        return false;
+    }
+    capacity_ = capacity;
+    return true;
+}
+
+bool TimerTable::isLive(int32_t slot) const {
+    return slot >= 0 && static_cast<uint32_t>(slot) < highWater_ && states_[slot] != FREE;
+}
+
+void TimerTable::anchor(int32_t slot, int64_t remainingSeconds, bool running, int64_t nowNanos) {
+    const bool wasRunning = states_[slot] == RUNNING;
+    if (remainingSeconds < 0) remainingSeconds = 0;
+    if (remainingSeconds > INT32_MAX) remainingSeconds = INT32_MAX;
+
+    if (running) {
+        deadlines_[slot] = nowNanos + remainingSeconds * NANOS_PER_SECOND;
+        if (remainingSeconds == 0) {
+            // Already due: the next tick reports the completion
+            reported_[slot] = -1;
+            nextChange_[slot] = nowNanos;
+        } else {
+            reported_[slot] = static_cast<int32_t>(remainingSeconds);
+            nextChange_[slot] = deadlines_[slot] - (remainingSeconds - 1) * NANOS_PER_SECOND;
+        }
+        states_[slot] = RUNNING;
+        if (!wasRunning) running_++;
+    } else {
+        reported_[slot] = static_cast<int32_t>(remainingSeconds);
+        nextChange_[slot] = NEVER;
+        states_[slot] = STOPPED;
+        if (wasRunning) running_--;
+    }
+}
+
+int32_t TimerTable::add(int64_t remainingSeconds, bool running, int64_t nowNanos) {
+    LockGuard lock(mutex_);
+    int32_t slot;
+    if (freeCount_ > 0) {
+        slot = freeSlots_[--freeCount_];
+    } else {
+        if (highWater_ == capacity_ && !grow()) return -1;
+        slot = static_cast<int32_t>(highWater_++);
+    }
+    states_[slot] = FREE;
+    anchor(slot, remainingSeconds, running, nowNanos);
+    size_++;
+    return slot;
+}
+
+bool TimerTable::set(int32_t slot, int64_t remainingSeconds, bool running, int64_t nowNanos) {
+    LockGuard lock(mutex_);
+    if (!isLive(slot)) return false;
+    anchor(slot, remainingSeconds, running, nowNanos);
+    return true;
+}
+
+bool TimerTable::remove(int32_t slot) {
+    LockGuard lock(mutex_);
+    if (!isLive(slot)) return false;
+    if (states_[slot] == RUNNING) running_--;
+    states_[slot] = FREE;
+    nextChange_[slot] = NEVER;
+    // Never more free slots than capacity: each was handed out once
+    freeSlots_[freeCount_++] = slot;
+    size_--;
+    return true;
+}
+
+size_t TimerTable::tick(int64_t nowNanos, TimerEvent* out, size_t capacity) {
+    LockGuard lock(mutex_);
+    if (running_ == 0 || capacity == 0) return 0;
+
+    size_t written = 0;
+    const uint32_t end = highWater_;
+    for (uint32_t i = 0; i < end; i++) {
+        if (nextChange_[i] > nowNanos) continue;
+
+        const int32_t seconds = displayedSeconds(deadlines_[i] - nowNanos);
+        if (seconds != reported_[i]) {
+            if (written == capacity) break;
+            out[written++] = {static_cast<int32_t>(i), seconds};
+            reported_[i] = seconds;
+        }
+        if (seconds == 0) {
+            states_[i] = STOPPED;
+            nextChange_[i] = NEVER;
+            running_--;
+        } else {
+            nextChange_[i] = deadlines_[i] - static_cast<int64_t>(seconds - 1) * NANOS_PER_SECOND;
+        }
+    }
+    return written;
+}
+
+uint32_t TimerTable::size() {
+    LockGuard lock(mutex_);
+    return size_;
+}
+
+uint32_t TimerTable::runningCount() {
+    LockGuard lock(mutex_);
+    return running_;
+}
+
+} // namespace bakingapp::timers
@@ -0,0 +1,93 @@
+/**
+ * Structure-of-arrays table of countdown timers
+ *
+ * Remaining time is derived from a monotonic clock rather than decremented:
+ * a running timer only stores its deadline, and the whole-second value the
+ * UI last saw. Each timer also caches the instant its displayed second next
+ * changes, so a tick is one linear scan over a contiguous int64 array that
+ * touches other columns only for timers whose value actually changed.
+ *
+ * Slots are stable for the lifetime of a timer and reused after remove().
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/mutex.h"
+
+namespace bakingapp::timers {
+
+constexpr int64_t NANOS_PER_SECOND = 1000000000LL;
+
+/**
+ * A timer whose displayed whole seconds changed; 0 means it completed
+ */
+struct TimerEvent {
+    int32_t slot;
+    int32_t remainingSeconds;
+};
+
+static_assert(sizeof(TimerEvent) == 8, "events are read from a ByteBuffer");
+
+class TimerTable {
+public:
+    TimerTable() = default;
+    ~TimerTable();
+
+    TimerTable(const TimerTable&) = delete;
+    TimerTable& operator=(const TimerTable&) = delete;
+
+    /**
+     * Adds a timer and anchors it at nowNanos when running
+     *
+     * @return its slot, or -1 when out of memory
+     */
+    int32_t add(int64_t remainingSeconds, bool running, int64_t nowNanos);
+
+    /**
+     * Replaces a timer's remaining time and state (start, pause, reset)
+     */
+    bool set(int32_t slot, int64_t remainingSeconds, bool running, int64_t nowNanos);
+
+    bool remove(int32_t slot);
+
+    /**
+     * Reports timers whose whole-second remaining time changed since they
+     * were last reported. Completed timers are reported once with 0 and
+     * stop. Changes beyond capacity stay pending for the next call.
+     *
+     * @return the number of events written
+     */
+    size_t tick(int64_t nowNanos, TimerEvent* out, size_t capacity);
+
+    uint32_t size();
+    uint32_t runningCount();
+
+private:
+    static constexpr int64_t NEVER = INT64_MAX;
+
+    enum : uint8_t { FREE = 0, STOPPED = 1, RUNNING = 2 };
+
+    bool grow();
+    void anchor(int32_t slot, int64_t remainingSeconds, bool running, int64_t nowNanos);
+    bool isLive(int32_t slot) const;
+
+    Mutex mutex_;
+
+    // Columns, all indexed by slot; nextChange_ is the only one a quiet tick reads
+    int64_t* nextChange_ = nullptr;
+    int64_t* deadlines_ = nullptr;
+    int32_t* reported_ = nullptr;
+    uint8_t* states_ = nullptr;
+
+    int32_t* freeSlots_ = nullptr;
+    uint32_t freeCount_ = 0;
+    uint32_t highWater_ = 0;
+    uint32_t capacity_ = 0;
+    uint32_t size_ = 0;
+    uint32_t running_ = 0;
+};
+
+} // namespace bakingapp::timers
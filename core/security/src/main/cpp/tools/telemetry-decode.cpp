@@ -0,0 +1,136 @@
+/**
+ * Prints a telemetry file written by the native flusher
+ *
+ * Usage: telemetry-decode [--summary] <file>
+ *
+ * Pull the file from a device with
+ *   adb exec-out run-as com.eslam.bakingapp.debug cat cache/telemetry.bin > telemetry.bin
+ *
+ * One line per event: seconds since the session started, ring, event name
+ * (or its id when unknown), value and extra. Batches are per ring, so lines
+ * are ordered within a ring and only roughly across rings. --summary prints
+ * only the per-event counts, drops and the time span.
+ */
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "telemetry/telemetry-format.h"
+
+using namespace bakingapp::telemetry;
+
+namespace {
+    constexpr uint32_t MAX_TYPES = 64;
+    constexpr size_t MAX_BATCH = 64 * 1024;
+
+    uint8_t* readFile(const char* path, size_t* size) {
+        FILE* file = fopen(path, "rb");
+        if (file == nullptr) return nullptr;
+        fseek(file, 0, SEEK_END);
+        const long length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        auto* data = static_cast<uint8_t*>(malloc(length > 0 ? static_cast<size_t>(length) : 1));
+        *size = length > 0 ? fread(data, 1, static_cast<size_t>(length), file) : 0;
+        fclose(file);
+        return data;
+    }
+
+    void printType(uint32_t type) {
+        const char* name = eventName(type);
+        if (name != nullptr) {
+            printf("%-14s", name);
+        } else {
+            printf("event-%-8u", type);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    bool summaryOnly = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--summary") == 0) {
+            summaryOnly = true;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        fprintf(stderr, "usage: %s [--summary] <file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t size = 0;
+    uint8_t* data = readFile(path, &size);
+    TelemetryReader reader;
+    if (data == nullptr || !reader.open(data, size)) {
+        fprintf(stderr, "%s: not a telemetry file\n", path);
+        free(data);
+        return EXIT_FAILURE;
+    }
+
+    const FileHeader& header = reader.header();
+    const time_t started = static_cast<time_t>(header.realtimeNanos / 1000000000LL);
+    char startedText[32];
+    strftime(startedText, sizeof(startedText), "%Y-%m-%d %H:%M:%S", gmtime(&started));
+    printf("session started %s UTC\n", startedText);
+
+    auto* events = static_cast<TelemetryEvent*>(malloc(sizeof(TelemetryEvent) * MAX_BATCH));
+    uint64_t counts[MAX_TYPES] = {};
+    uint64_t otherCount = 0;
+    uint64_t total = 0;
+    uint64_t dropped = 0;
+    int64_t first = INT64_MAX;
+    int64_t last = INT64_MIN;
+
+    BatchInfo info {};
+    while (reader.next(&info, events, MAX_BATCH)) {
+        dropped += info.dropped;
+        const uint32_t count = info.count < MAX_BATCH ? info.count : MAX_BATCH;
+        for (uint32_t i = 0; i < count; i++) {
+            const TelemetryEvent& event = events[i];
+            if (event.type < MAX_TYPES) {
+                counts[event.type]++;
+            } else {
+                otherCount++;
+            }
+            total++;
+            if (event.timestampNanos < first) first = event.timestampNanos;
+            if (event.timestampNanos > last) last = event.timestampNanos;
+            if (summaryOnly) continue;
+
+            printf("%12.6f  ring %-3u ",
+                   static_cast<double>(event.timestampNanos - header.monotonicNanos) / 1e9,
+                   info.ring);
+            printType(event.type);
+            printf(" %10d %20" PRIu64 "\n", static_cast<int32_t>(event.value), event.extra);
+        }
+        if (!summaryOnly && info.dropped > 0) {
+            printf("%12s  ring %-3u %" PRIu64 " events dropped (ring full)\n", "", info.ring,
+                   info.dropped);
+        }
+    }
+    if (!reader.atEnd()) {
+        // The process died mid-write; everything before it is intact
+        printf("(truncated last batch ignored)\n");
+    }
+
+    printf("\n%" PRIu64 " events, %" PRIu64 " dropped", total, dropped);
+    if (total > 0) printf(", %.3f s span", static_cast<double>(last - first) / 1e9);
+    printf("\n");
+    for (uint32_t type = 0; type < MAX_TYPES; type++) {
+        if (counts[type] == 0) continue;
+        printf("  ");
+        printType(type);
+        printf(" %10" PRIu64 "\n", counts[type]);
+    }
+    if (otherCount > 0) printf("  %-14s %10" PRIu64 "\n", "other", otherCount);
+
+    free(events);
+    free(data);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+#include "units/ingredient-scaler.h"
+
+#include <limits>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bakingapp::units {
+
+namespace {
+    constexpr double NEVER = std::numeric_limits<double>::infinity();
+
+    // Rungs switch slightly early so exact multiples (3 tsp, 1000 g) are
+    // not lost to rounding in toBase * fromBase.
+    constexpr double RUNG_TOLERANCE = 1.0 - 1e-9;
+
+    /**
+     * One cache line per (system, code)
+     */
+    struct alignas(64) Conversion {
+        double toBase;
+        double threshold[2];
+        double fromBase[3];
+        uint8_t code[3];
+    };
+
+    struct Ladder {
+        uint8_t code[3];
+        uint8_t rungs;
+    };
+
+    constexpr Ladder ladderFor(UnitSystem system, Dimension dimension) {
+        if (system == UnitSystem::METRIC && dimension == Dimension::MASS) {
+            return {{GRAM, KILOGRAM, KILOGRAM}, 2};
+        }
+        if (system == UnitSystem::METRIC && dimension == Dimension::VOLUME) {
+            return {{MILLILITER, LITER, LITER}, 2};
+        }
+        if (system == UnitSystem::IMPERIAL && dimension == Dimension::MASS) {
+            return {{OUNCE, POUND, POUND}, 2};
+        }
+        if (system == UnitSystem::IMPERIAL && dimension == Dimension::VOLUME) {
+            return {{TEASPOON, TABLESPOON, CUP}, 3};
+        }
+        return {{NONE, NONE, NONE}, 0};
+    }
+
+    constexpr Conversion identity(uint8_t code) {
+        Conversion c {};
+        c.toBase = 1.0;
+        c.threshold[0] = NEVER;
+        c.threshold[1] = NEVER;
+        for (int i = 0; i < 3; i++) {
+            c.fromBase[i] = 1.0;
+            c.code[i] = code;
+        }
+        return c;
+    }
+
+    struct ConversionTable {
+        Conversion entries[UNIT_SYSTEM_COUNT][256];
+    };
+
+    constexpr ConversionTable buildConversions() {
+        ConversionTable table {};
+        for (size_t s = 0; s < UNIT_SYSTEM_COUNT; s++) {
+            for (uint32_t code = 0; code < 256; code++) {
+                Conversion c = identity(static_cast<uint8_t>(code));
+                const auto system = static_cast<UnitSystem>(s);
+                if (system != UnitSystem::ORIGINAL && isBuiltinUnit(static_cast<uint8_t>(code))) {
+                    const UnitInfo& unit = BUILTIN_UNITS[code];
+                    const Ladder ladder = ladderFor(system, unit.dimension);
+                    if (ladder.rungs > 0) {
+                        c.toBase = unit.toBase;
+                        for (int i = 0; i < 3; i++) {
+                            c.code[i] = ladder.code[i];
+                            c.fromBase[i] = 1.0 / BUILTIN_UNITS[ladder.code[i]].toBase;
+                        }
+                        // Rung i + 1 starts at one of its own units; the
+                        // imperial volume ladder starts cups at 1/4 cup.
+                        for (int i = 0; i + 1 < ladder.rungs; i++) {
+                            double start = BUILTIN_UNITS[ladder.code[i + 1]].toBase;
+                            if (ladder.code[i + 1] == CUP) start /= 4;
+                            c.threshold[i] = start * RUNG_TOLERANCE;
+                        }
+                    }
+                }
+                table.entries[s][code] = c;
+            }
+        }
+        return table;
+    }
+
+    constexpr ConversionTable CONVERSIONS = buildConversions();
+
+    inline void convertOne(const Conversion& c, double quantity, double factor,
+                           double* out, uint8_t* outUnit) {
+        const double base = quantity * factor * c.toBase;
+        const int rung = (base >= c.threshold[0]) + (base >= c.threshold[1]);
+        *out = base * c.fromBase[rung];
+        *outUnit = c.code[rung];
+    }
+}
+
+void scaleQuantitiesScalar(const double* quantities, const uint8_t* units, size_t count,
+                           double factor, UnitSystem system,
+                           double* outQuantities, uint8_t* outUnits) {
+    const Conversion* table = CONVERSIONS.entries[static_cast<size_t>(system) % UNIT_SYSTEM_COUNT];
+    for (size_t i = 0; i < count; i++) {
+        convertOne(table[units[i]], quantities[i], factor, &outQuantities[i], &outUnits[i]);
+    }
+}
+
+void scaleQuantities(const double* quantities, const uint8_t* units, size_t count,
+                     double factor, UnitSystem system,
+                     double* outQuantities, uint8_t* outUnits) {
+    const Conversion* table = CONVERSIONS.entries[static_cast<size_t>(system) % UNIT_SYSTEM_COUNT];
+    size_t i = 0;
+
+#if defined(__aarch64__)
+    const float64x2_t scale = vdupq_n_f64(factor);
+    for (; i + 2 <= count; i += 2) {
+        const Conversion& a = table[units[i]];
+        const Conversion& b = table[units[i + 1]];
+        const double toBase[2] = {a.toBase, b.toBase};
+        const double threshold0[2] = {a.threshold[0], b.threshold[0]};
+        const double threshold1[2] = {a.threshold[1], b.threshold[1]};
+        const float64x2_t base = vmulq_f64(vmulq_f64(vld1q_f64(quantities + i), scale),
+                                           vld1q_f64(toBase));
+        const uint64x2_t up0 = vcgeq_f64(base, vld1q_f64(threshold0));
+        const uint64x2_t up1 = vcgeq_f64(base, vld1q_f64(threshold1));
+        const int rungA = static_cast<int>((vgetq_lane_u64(up0, 0) & 1) + (vgetq_lane_u64(up1, 0) & 1));
+        const int rungB = static_cast<int>((vgetq_lane_u64(up0, 1) & 1) + (vgetq_lane_u64(up1, 1) & 1));
+        const double fromBase[2] = {a.fromBase[rungA], b.fromBase[rungB]};
+        vst1q_f64(outQuantities + i, vmulq_f64(base, vld1q_f64(fromBase)));
+        outUnits[i] = a.code[rungA];
+        outUnits[i + 1] = b.code[rungB];
+    }
+#elif defined(__SSE2__)
+    const __m128d scale = _mm_set1_pd(factor);
+    for (; i + 2 <= count; i += 2) {
+        const Conversion& a = table[units[i]];
+        const Conversion& b = table[units[i + 1]];
+        // _mm_set_pd takes the high lane first
+        const __m128d base = _mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(quantities + i), scale),
+                                        _mm_set_pd(b.toBase, a.toBase));
+        const int up0 = _mm_movemask_pd(_mm_cmpge_pd(base, _mm_set_pd(b.threshold[0], a.threshold[0])));
+        const int up1 = _mm_movemask_pd(_mm_cmpge_pd(base, _mm_set_pd(b.threshold[1], a.threshold[1])));
+        const int rungA = (up0 & 1) + (up1 & 1);
+        const int rungB = (up0 >> 1) + (up1 >> 1);
+        _mm_storeu_pd(outQuantities + i,
+                      _mm_mul_pd(base, _mm_set_pd(b.fromBase[rungB], a.fromBase[rungA])));
+        outUnits[i] = a.code[rungA];
+        outUnits[i + 1] = b.code[rungB];
+    }
+#endif
+
+    scaleQuantitiesScalar(quantities + i, units + i, count - i, factor, system,
+                          outQuantities + i, outUnits + i);
+}
+
+} // namespace bakingapp::units
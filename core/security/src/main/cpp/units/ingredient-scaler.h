@@ -0,0 +1,39 @@
+/**
+ * Batch kernel for rescaling ingredient quantities by servings and
+ * converting them between metric and imperial units.
+ *
+ * Each (target system, unit code) pair has a precomputed conversion: a
+ * factor into the base unit (g / ml) and a magnitude ladder of up to three
+ * output units, e.g. tsp < 1 tbsp <= tbsp < 1/4 cup <= cup. The kernel
+ * handles two quantities per step with SSE2 or AArch64 NEON.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "units/units.h"
+
+namespace bakingapp::units {
+
+/**
+ * Scales count quantities by factor and converts them to system.
+ *
+ * Units without a conversion (COUNT, dynamic, unknown) keep their code and
+ * are only scaled. In-place operation (outQuantities == quantities) is
+ * allowed.
+ */
+void scaleQuantities(const double* quantities, const uint8_t* units, size_t count,
+                     double factor, UnitSystem system,
+                     double* outQuantities, uint8_t* outUnits);
+
+/**
+ * Portable reference implementation, used for the tail of the SIMD loop
+ * and by the host benchmark and tests
+ */
+void scaleQuantitiesScalar(const double* quantities, const uint8_t* units, size_t count,
+                           double factor, UnitSystem system,
+                           double* outQuantities, uint8_t* outUnits);
+
+} // namespace bakingapp::units
@@ -0,0 +1,89 @@
+/**
+ * Unit definitions for ingredient scaling and conversion
+ *
+ * UNIT(identifier, "display name", dimension, base units per unit)
+ *   Mass is based on grams, volume on milliliters; COUNT units never convert.
+ *
+ * UNIT_ALIAS("text", identifier)
+ *   Normalized spellings (lowercase, single spaces, no trailing '.')
+ *   accepted by the interner in addition to the display names.
+ *
+ * Codes are the declaration order, so append new units at the end: codes
+ * are not persisted, but keeping them stable keeps logs comparable.
+ */
+
+#pragma once
+
+#define BAKINGAPP_UNIT_DEFINITIONS(UNIT)                       \
+    UNIT(NONE, "", COUNT, 1.0)                                 \
+    UNIT(PIECE, "piece", COUNT, 1.0)                           \
+    UNIT(PINCH, "pinch", COUNT, 1.0)                           \
+    UNIT(DASH, "dash", COUNT, 1.0)                             \
+    UNIT(CLOVE, "clove", COUNT, 1.0)                           \
+    UNIT(SLICE, "slice", COUNT, 1.0)                           \
+    UNIT(CAN, "can", COUNT, 1.0)                               \
+    UNIT(MILLIGRAM, "mg", MASS, 0.001)                         \
+    UNIT(GRAM, "g", MASS, 1.0)                                 \
+    UNIT(KILOGRAM, "kg", MASS, 1000.0)                         \
+    UNIT(OUNCE, "oz", MASS, 28.349523125)                      \
+    UNIT(POUND, "lb", MASS, 453.59237)                         \
+    UNIT(MILLILITER, "ml", VOLUME, 1.0)                        \
+    UNIT(DECILITER, "dl", VOLUME, 100.0)                       \
+    UNIT(LITER, "l", VOLUME, 1000.0)                           \
+    UNIT(TEASPOON, "tsp", VOLUME, 4.92892159375)               \
+    UNIT(TABLESPOON, "tbsp", VOLUME, 14.78676478125)           \
+    UNIT(FLUID_OUNCE, "fl oz", VOLUME, 29.5735295625)          \
+    UNIT(CUP, "cup", VOLUME, 236.5882365)                      \
+    UNIT(PINT, "pint", VOLUME, 473.176473)                     \
+    UNIT(QUART, "quart", VOLUME, 946.352946)                   \
+    UNIT(GALLON, "gallon", VOLUME, 3785.411784)
+
+#define BAKINGAPP_UNIT_ALIASES(UNIT_ALIAS)                     \
+    UNIT_ALIAS("pc", PIECE)                                    \
+    UNIT_ALIAS("pcs", PIECE)                                   \
+    UNIT_ALIAS("pieces", PIECE)                                \
+    UNIT_ALIAS("whole", PIECE)                                 \
+    UNIT_ALIAS("pinches", PINCH)                               \
+    UNIT_ALIAS("dashes", DASH)                                 \
+    UNIT_ALIAS("cloves", CLOVE)                                \
+    UNIT_ALIAS("slices", SLICE)                                \
+    UNIT_ALIAS("cans", CAN)                                    \
+    UNIT_ALIAS("milligram", MILLIGRAM)                         \
+    UNIT_ALIAS("milligrams", MILLIGRAM)                        \
+    UNIT_ALIAS("gr", GRAM)                                     \
+    UNIT_ALIAS("gram", GRAM)                                   \
+    UNIT_ALIAS("grams", GRAM)                                  \
+    UNIT_ALIAS("kilogram", KILOGRAM)                           \
+    UNIT_ALIAS("kilograms", KILOGRAM)                          \
+    UNIT_ALIAS("ounce", OUNCE)                                 \
+    UNIT_ALIAS("ounces", OUNCE)                                \
+    UNIT_ALIAS("lbs", POUND)                                   \
+    UNIT_ALIAS("pound", POUND)                                 \
+    UNIT_ALIAS("pounds", POUND)                                \
+    UNIT_ALIAS("milliliter", MILLILITER)                       \
+    UNIT_ALIAS("milliliters", MILLILITER)                      \
+    UNIT_ALIAS("millilitre", MILLILITER)                       \
+    UNIT_ALIAS("millilitres", MILLILITER)                      \
+    UNIT_ALIAS("deciliter", DECILITER)                         \
+    UNIT_ALIAS("decilitre", DECILITER)                         \
+    UNIT_ALIAS("liter", LITER)                                 \
+    UNIT_ALIAS("liters", LITER)                                \
+    UNIT_ALIAS("litre", LITER)                                 \
+    UNIT_ALIAS("litres", LITER)                                \
+    UNIT_ALIAS("teaspoon", TEASPOON)                           \
+    UNIT_ALIAS("teaspoons", TEASPOON)                          \
+    UNIT_ALIAS("tbs", TABLESPOON)                              \
+    UNIT_ALIAS("tbl", TABLESPOON)                              \
+    UNIT_ALIAS("tablespoon", TABLESPOON)                       \
+    UNIT_ALIAS("tablespoons", TABLESPOON)                      \
+    UNIT_ALIAS("floz", FLUID_OUNCE)                            \
+    UNIT_ALIAS("fluid ounce", FLUID_OUNCE)                     \
+    UNIT_ALIAS("fluid ounces", FLUID_OUNCE)                    \
+    UNIT_ALIAS("c", CUP)                                       \
+    UNIT_ALIAS("cups", CUP)                                    \
+    UNIT_ALIAS("pt", PINT)                                     \
+    UNIT_ALIAS("pints", PINT)                                  \
+    UNIT_ALIAS("qt", QUART)                                    \
+    UNIT_ALIAS("quarts", QUART)                                \
+    UNIT_ALIAS("gal", GALLON)                                  \
+    UNIT_ALIAS("gallons", GALLON)
@@ -0,0 +1,171 @@
+#include "units/unit-interner.h"
+
+#include <cstring>
+
+namespace bakingapp::units {
+
+namespace {
+    constexpr uint32_t fnv1a(const char* text, size_t length) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; i++) {
+            hash ^= static_cast<uint8_t>(text[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    constexpr size_t constLength(const char* text) {
+        size_t length = 0;
+        while (text[length] != '\0') length++;
+        return length;
+    }
+
+    constexpr bool constEquals(const char* a, const char* b) {
+        size_t i = 0;
+        for (; a[i] != '\0' && a[i] == b[i]; i++) {}
+        return a[i] == b[i];
+    }
+
+    struct AliasDefinition {
+        const char* text;
+        uint8_t code;
+    };
+
+    constexpr AliasDefinition ALIAS_DEFINITIONS[] = {
+#define BAKINGAPP_UNIT_NAME(identifier, name, dimension, toBase) {name, identifier},
+        BAKINGAPP_UNIT_DEFINITIONS(BAKINGAPP_UNIT_NAME)
+#undef BAKINGAPP_UNIT_NAME
+#define BAKINGAPP_UNIT_ALIAS(text, identifier) {text, identifier},
+        BAKINGAPP_UNIT_ALIASES(BAKINGAPP_UNIT_ALIAS)
+#undef BAKINGAPP_UNIT_ALIAS
+    };
+
+    constexpr uint32_t ALIAS_TABLE_SIZE = 256;
+
+    struct AliasSlot {
+        const char* text;
+        uint32_t hash;
+        uint32_t length;
+        uint8_t code;
+    };
+
+    struct AliasTable {
+        AliasSlot slots[ALIAS_TABLE_SIZE];
+        bool valid;
+    };
+
+    constexpr AliasTable buildAliasTable() {
+        AliasTable table {};
+        table.valid = true;
+        for (const AliasDefinition& alias : ALIAS_DEFINITIONS) {
+            const size_t length = constLength(alias.text);
+            if (length == 0) continue;   // NONE is matched before the table
+            if (length > MAX_UNIT_LENGTH) table.valid = false;
+            const uint32_t hash = fnv1a(alias.text, length);
+            uint32_t i = hash % ALIAS_TABLE_SIZE;
+            while (table.slots[i].text != nullptr) {
+                if (constEquals(table.slots[i].text, alias.text)) table.valid = false;
+                i = (i + 1) % ALIAS_TABLE_SIZE;
+            }
+            table.slots[i] = {alias.text, hash, static_cast<uint32_t>(length), alias.code};
+        }
+        return table;
+    }
+
+    constexpr AliasTable ALIAS_TABLE = buildAliasTable();
+    static_assert(ALIAS_TABLE.valid, "unit aliases must be unique and at most MAX_UNIT_LENGTH");
+
+    inline bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+}
+
+size_t normalizeUnit(const char* text, size_t length, char* out) {
+    size_t begin = 0;
+    size_t end = length;
+    while (begin < end && isSpace(text[begin])) begin++;
+    while (end > begin && (isSpace(text[end - 1]) || text[end - 1] == '.')) end--;
+
+    size_t n = 0;
+    bool pendingSpace = false;
+    for (size_t i = begin; i < end; i++) {
+        char c = text[i];
+        if (isSpace(c)) {
+            pendingSpace = true;
+            continue;
+        }
+        if (n + (pendingSpace ? 2 : 1) > MAX_UNIT_LENGTH) return SIZE_MAX;
+        if (pendingSpace) out[n++] = ' ';
+        pendingSpace = false;
+        out[n++] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+uint8_t findBuiltinUnit(const char* normalized, size_t length) {
+    if (length == 0) return NONE;
+    const uint32_t hash = fnv1a(normalized, length);
+    for (uint32_t i = hash % ALIAS_TABLE_SIZE;; i = (i + 1) % ALIAS_TABLE_SIZE) {
+        const AliasSlot& slot = ALIAS_TABLE.slots[i];
+        if (slot.text == nullptr) return UNKNOWN_UNIT;
+        if (slot.hash == hash && slot.length == length &&
+            memcmp(slot.text, normalized, length) == 0) {
+            return slot.code;
+        }
+    }
+}
+
+uint8_t UnitInterner::intern(const char* text, size_t length) {
+    char normalized[MAX_UNIT_LENGTH + 1];
+    const size_t n = normalizeUnit(text, length, normalized);
+    if (n == SIZE_MAX) return UNKNOWN_UNIT;
+
+    const uint8_t builtin = findBuiltinUnit(normalized, n);
+    if (builtin != UNKNOWN_UNIT) return builtin;
+
+    const uint32_t hash = fnv1a(normalized, n);
+    LockGuard lock(mutex_);
+    for (uint32_t i = 0; i < dynamicCount_; i++) {
+        const Entry& entry = dynamic_[i];
+        if (entry.hash == hash && entry.length == n && memcmp(entry.text, normalized, n) == 0) {
+            return static_cast<uint8_t>(FIRST_DYNAMIC_UNIT + i);
+        }
+    }
+    if (dynamicCount_ == DYNAMIC_CAPACITY) return UNKNOWN_UNIT;
+
+    Entry& entry = dynamic_[dynamicCount_];
+    entry.hash = hash;
+    entry.length = static_cast<uint32_t>(n);
+    memcpy(entry.text, normalized, n + 1);
+    return static_cast<uint8_t>(FIRST_DYNAMIC_UNIT + dynamicCount_++);
+}
+
+bool UnitInterner::name(uint8_t code, char* out, size_t capacity) {
+    if (capacity == 0) return false;
+    const char* source = nullptr;
+    if (isBuiltinUnit(code)) {
+        source = BUILTIN_UNITS[code].name;
+    }
+
+    LockGuard lock(mutex_);
+    if (source == nullptr && code >= FIRST_DYNAMIC_UNIT &&
+        static_cast<uint32_t>(code - FIRST_DYNAMIC_UNIT) < dynamicCount_) {
+        source = dynamic_[code - FIRST_DYNAMIC_UNIT].text;
+    }
+    if (source == nullptr) {
+        out[0] = '\0';
+        return false;
+    }
+    const size_t length = strnlen(source, capacity - 1);
+    memcpy(out, source, length);
+    out[length] = '\0';
+    return true;
+}
+
+uint32_t UnitInterner::dynamicCount() {
+    LockGuard lock(mutex_);
+    return dynamicCount_;
+}
+
+} // namespace bakingapp::units
@@ -0,0 +1,71 @@
+/**
+ * Maps free-form `IngredientDto.unit` text to one-byte unit codes.
+ *
+ * Text is normalized (ASCII lowercase, trimmed, single spaces, no trailing
+ * '.') and matched against the built-in names and aliases through a
+ * constexpr hash table. Anything else is interned into the dynamic range,
+ * so repeated unknown units share a code for the life of the process.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/mutex.h"
+#include "units/units.h"
+
+namespace bakingapp::units {
+
+constexpr size_t MAX_UNIT_LENGTH = 31;
+
+/**
+ * Writes the normalized form of text into out (MAX_UNIT_LENGTH + 1 bytes).
+ *
+ * @return the normalized length, or SIZE_MAX if it does not fit
+ */
+size_t normalizeUnit(const char* text, size_t length, char* out);
+
+/**
+ * Looks a normalized unit up among the built-in names and aliases
+ *
+ * @return the unit code, or UNKNOWN_UNIT
+ */
+uint8_t findBuiltinUnit(const char* normalized, size_t length);
+
+class UnitInterner {
+public:
+    UnitInterner() = default;
+
+    UnitInterner(const UnitInterner&) = delete;
+    UnitInterner& operator=(const UnitInterner&) = delete;
+
+    /**
+     * @return the code for text; UNKNOWN_UNIT once the dynamic range is full
+     */
+    uint8_t intern(const char* text, size_t length);
+
+    /**
+     * Copies the display name of code into out, NUL-terminated
+     *
+     * @return false for codes that were never handed out
+     */
+    bool name(uint8_t code, char* out, size_t capacity);
+
+    uint32_t dynamicCount();
+
+private:
+    static constexpr uint32_t DYNAMIC_CAPACITY = UNKNOWN_UNIT - FIRST_DYNAMIC_UNIT;
+
+    struct Entry {
+        uint32_t hash;
+        uint32_t length;
+        char text[MAX_UNIT_LENGTH + 1];
+    };
+
+    Mutex mutex_;
+    Entry dynamic_[DYNAMIC_CAPACITY] = {};
+    uint32_t dynamicCount_ = 0;
+};
+
+} // namespace bakingapp::units
@@ -0,0 +1,143 @@
+/**
+ * JNI bridge for the ingredient scaling kernel and the unit interner
+ *
+ * A whole recipe is scaled in one call: quantities and unit codes go in as
+ * primitive arrays, results come back in caller-provided arrays. The
+ * arrays are accessed as critical regions since the kernel is short and
+ * never calls back into the VM.
+ */
+
+#include <jni.h>
+
+#include "units/ingredient-scaler.h"
+#include "units/unit-interner.h"
+
+using bakingapp::units::UnitInterner;
+using bakingapp::units::UnitSystem;
+
+namespace {
+    // Namespace scope rather than a function-local static: the latter needs
+    // __cxa_guard_* from the C++ runtime, which this library does not link
+    UnitInterner sharedInterner;
+
+    UnitInterner& interner() {
+        return sharedInterner;
+    }
+
+    /**
+     * Pins a primitive array for the lifetime of the object
+     */
+    class CriticalArray {
+    public:
+        CriticalArray(JNIEnv* env, jarray array, jint mode)
+            : env_(env), array_(array), mode_(mode) {
+            if (array != nullptr) data_ = env->GetPrimitiveArrayCritical(array, nullptr);
+        }
+
+        ~CriticalArray() {
+            if (data_ != nullptr) env_->ReleasePrimitiveArrayCritical(array_, data_, mode_);
+        }
+
+        template <typename T>
+        T* as() const { return static_cast<T*>(data_); }
+
+        bool isValid() const { return data_ != nullptr; }
+
+    private:
+        JNIEnv* env_;
+        jarray array_;
+        jint mode_;
+        void* data_ = nullptr;
+    };
+}
+
+extern "C" {
+
+/**
+ * @return one unit code per string; null entries map to the empty unit
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_eslam_bakingapp_core_security_units_NativeIngredientScaler_nativeInternUnits(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jobjectArray units
+) {
+    if (units == nullptr) return nullptr;
+    const jsize count = env->GetArrayLength(units);
+    jbyteArray result = env->NewByteArray(count);
+    if (result == nullptr) return nullptr;
+
+    jbyte codes[256];
+    for (jsize begin = 0; begin < count; begin += 256) {
+        const jsize end = count - begin < 256 ? count : begin + 256;
+        for (jsize i = begin; i < end; i++) {
+            auto text = static_cast<jstring>(env->GetObjectArrayElement(units, i));
+            uint8_t code = bakingapp::units::NONE;
+            if (text != nullptr) {
+                const char* chars = env->GetStringUTFChars(text, nullptr);
+                if (chars != nullptr) {
+                    code = interner().intern(chars, static_cast<size_t>(env->GetStringUTFLength(text)));
+                    env->ReleaseStringUTFChars(text, chars);
+                }
+                env->DeleteLocalRef(text);
+            }
+            codes[i - begin] = static_cast<jbyte>(code);
+        }
+        env->SetByteArrayRegion(result, begin, end - begin, codes);
+    }
+    return result;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_eslam_bakingapp_core_security_units_NativeIngredientScaler_nativeUnitName(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jint code
+) {
+    char name[bakingapp::units::MAX_UNIT_LENGTH + 1];
+    if (code < 0 || code > 255 || !interner().name(static_cast<uint8_t>(code), name, sizeof(name))) {
+        return nullptr;
+    }
+    return env->NewStringUTF(name);
+}
+
+/**
+ * Scales and converts quantities/units into outQuantities/outUnits. All
+ * arrays must have the same length.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_eslam_bakingapp_core_security_units_NativeIngredientScaler_nativeScale(
+        JNIEnv* env,
+        jobject /* thiz */,
+        jdoubleArray quantities,
+        jbyteArray units,
+        jdouble factor,
+        jint system,
+        jdoubleArray outQuantities,
+        jbyteArray outUnits
+) {
+    if (quantities == nullptr || units == nullptr || outQuantities == nullptr ||
+        outUnits == nullptr || system < 0 || system > static_cast<jint>(UnitSystem::IMPERIAL)) {
+        return JNI_FALSE;
+    }
+    const jsize count = env->GetArrayLength(quantities);
+    if (env->GetArrayLength(units) != count || env->GetArrayLength(outQuantities) != count ||
+        env->GetArrayLength(outUnits) != count) {
+        return JNI_FALSE;
+    }
+
+    CriticalArray in(env, quantities, JNI_ABORT);
+    CriticalArray inUnits(env, units, JNI_ABORT);
+    CriticalArray out(env, outQuantities, 0);
+    CriticalArray outCodes(env, outUnits, 0);
+    if (!in.isValid() || !inUnits.isValid() || !out.isValid() || !outCodes.isValid()) {
+        return JNI_FALSE;
+    }
+    bakingapp::units::scaleQuantities(in.as<const double>(), inUnits.as<const uint8_t>(),
+                                      static_cast<size_t>(count), factor,
+                                      static_cast<UnitSystem>(system),
+                                      out.as<double>(), outCodes.as<uint8_t>());
+    return JNI_TRUE;
+}
+
+} // extern "C"
@@ -0,0 +1,64 @@
+/**
+ * Unit codes shared by the interner and the scaling kernel.
+ *
+ * Codes below FIRST_DYNAMIC_UNIT come from unit-definitions.h; unknown unit
+ * strings are interned at runtime into the range above it and are only
+ * ever scaled, never converted.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "units/unit-definitions.h"
+
+namespace bakingapp::units {
+
+enum class Dimension : uint8_t {
+    COUNT,
+    MASS,
+    VOLUME,
+};
+
+/**
+ * Target system for conversion. ORIGINAL only scales.
+ */
+enum class UnitSystem : uint8_t {
+    ORIGINAL = 0,
+    METRIC = 1,
+    IMPERIAL = 2,
+};
+
+constexpr size_t UNIT_SYSTEM_COUNT = 3;
+
+enum UnitCode : uint8_t {
+#define BAKINGAPP_UNIT_ENUM(identifier, name, dimension, toBase) identifier,
+    BAKINGAPP_UNIT_DEFINITIONS(BAKINGAPP_UNIT_ENUM)
+#undef BAKINGAPP_UNIT_ENUM
+    BUILTIN_UNIT_COUNT
+};
+
+constexpr uint8_t FIRST_DYNAMIC_UNIT = 128;
+constexpr uint8_t UNKNOWN_UNIT = 255;   // interner full or text too long
+
+static_assert(BUILTIN_UNIT_COUNT <= FIRST_DYNAMIC_UNIT, "too many built-in units");
+
+struct UnitInfo {
+    const char* name;
+    Dimension dimension;
+    double toBase;   // grams or milliliters per unit
+};
+
+inline constexpr UnitInfo BUILTIN_UNITS[] = {
+#define BAKINGAPP_UNIT_INFO(identifier, name, dimension, toBase) \
+    {name, Dimension::dimension, toBase},
+    BAKINGAPP_UNIT_DEFINITIONS(BAKINGAPP_UNIT_INFO)
+#undef BAKINGAPP_UNIT_INFO
+};
+
+constexpr bool isBuiltinUnit(uint8_t code) {
+    return code < BUILTIN_UNIT_COUNT;
+}
+
+} // namespace bakingapp::units
@@ -34,6 +34,13 @@ interface ApiKeyProvider {
      */
     fun getSecretKey(): String
 
+    /**
+     * Retrieves a key by its registry ID (e.g. "staging.api")
+     * @param id The key ID
+     * @return The key, or empty string if unavailable or unknown
+     */
+    fun getKey(id: String): String
+
     /**
      * Retrieves the app identifier
      * @return The app identifier string
@@ -58,6 +65,13 @@ interface ApiKeyProvider {
      * @return The secret key, or null if unavailable
      */
     fun getSecretKeyOrNull(): String?
+
+    /**
+     * Retrieves a key by its registry ID, returning null if unavailable
+     * @param id The key ID
+     * @return The key, or null if unavailable or unknown
+     */
+    fun getKeyOrNull(id: String): String?
 }
 
 /**
@@ -73,6 +87,8 @@ class DefaultApiKeyProvider(
 
     override fun getSecretKey(): String = nativeKeyProvider.getSecretKey()
 
+    override fun getKey(id: String): String = nativeKeyProvider.getKey(id)
+
     override fun getAppIdentifier(): String = nativeKeyProvider.getAppIdentifier()
 
     override fun validateKeyFormat(key: String): Boolean =
@@ -81,4 +97,6 @@ class DefaultApiKeyProvider(
     override fun getApiKeyOrNull(): String? = nativeKeyProvider.getApiKeyOrNull()
 
     override fun getSecretKeyOrNull(): String? = nativeKeyProvider.getSecretKeyOrNull()
+
+    override fun getKeyOrNull(id: String): String? = nativeKeyProvider.getKeyOrNull(id)
 }
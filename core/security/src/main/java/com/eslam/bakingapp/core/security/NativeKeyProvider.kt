@@ -1,8 +1,12 @@
 package com.eslam.bakingapp.core.security
 
 import android.content.Context
+import android.os.ParcelFileDescriptor
 import android.util.Log
 import dagger.hilt.android.qualifiers.ApplicationContext
+import java.io.File
+import java.io.FileNotFoundException
+import java.io.IOException
 import javax.inject.Inject
 import javax.inject.Singleton
 
@@ -19,6 +23,12 @@ import javax.inject.Singleton
  * - Package name verification (prevents use in other apps)
  * - Singleton pattern (single point of access)
  *
+ * Keys in the encrypted key blob asset ([KEY_BLOB_ASSET], written by
+ * `scripts/encode_keys.py --blob`) take precedence over the compiled ones,
+ * so a key can be rotated by shipping a new asset. The blob is mapped, not
+ * read: opening it costs the same for any number of keys, and each key is
+ * decrypted natively the first time it is fetched.
+ *
  * Usage:
  * ```kotlin
  * @Inject
@@ -36,40 +46,29 @@ class NativeKeyProvider @Inject constructor(
 ) {
     companion object {
         private const val TAG = "NativeKeyProvider"
-        private const val LIBRARY_NAME = "native-keys"
+        private const val LIBRARY_NAME = NativeLibrary.NAME
+
+        /**
+         * Asset holding the encrypted key blob; mapped in place when stored
+         * uncompressed, otherwise from a copy in noBackupFilesDir
+         */
+        const val KEY_BLOB_ASSET = "keys.blob"
 
         /**
          * Track if the native library was loaded successfully
          */
-        @Volatile
-        private var isLibraryLoaded = false
+        private val isLibraryLoaded: Boolean
+            get() = NativeLibrary.isLoaded
 
         /**
          * Error message if library loading fails
          */
-        @Volatile
-        private var loadError: String? = null
+        private val loadError: String?
+            get() = NativeLibrary.loadError
 
         init {
-            loadNativeLibrary()
-        }
-
-        /**
-         * Attempts to load the native library
-         * Called once during class initialization
-         */
-        private fun loadNativeLibrary() {
-            try {
-                System.loadLibrary(LIBRARY_NAME)
-                isLibraryLoaded = true
-                Log.d(TAG, "Native library '$LIBRARY_NAME' loaded successfully")
-            } catch (e: UnsatisfiedLinkError) {
-                loadError = e.message
-                Log.e(TAG, "Failed to load native library: ${e.message}", e)
-            } catch (e: SecurityException) {
-                loadError = e.message
-                Log.e(TAG, "Security exception loading native library: ${e.message}", e)
-            }
+            // Loads the library once, shared with the other JNI bridges
+            NativeLibrary.ensureLoaded()
         }
     }
 
@@ -87,6 +86,12 @@ class NativeKeyProvider @Inject constructor(
      */
     private external fun getSecretKeyNative(context: Context): String
 
+    /**
+     * Native method to retrieve any registry key by its string ID
+     * Package verification is performed in native code
+     */
+    private external fun getKeyNative(context: Context, id: String): String
+
     /**
      * Native method to get the app identifier
      * Built from split strings at runtime
@@ -99,6 +104,18 @@ class NativeKeyProvider @Inject constructor(
      */
     private external fun validateKeyFormatNative(keyToValidate: String): Boolean
 
+    /**
+     * Native method to map the encrypted key blob from [length] bytes of
+     * [fd] at [offset]; [fd] may be closed once it returns
+     */
+    private external fun openKeyBlobNative(fd: Int, offset: Long, length: Long): Boolean
+
+    /**
+     * Set once the key blob has been tried, whether or not it opened
+     */
+    @Volatile
+    private var keyBlobChecked = false
+
     // ==================== Public API ====================
 
     /**
@@ -122,6 +139,7 @@ class NativeKeyProvider @Inject constructor(
      */
     fun getApiKey(): String {
         ensureLibraryLoaded()
+        ensureKeyBlobChecked()
         return try {
             getApiKeyNative(context)
         } catch (e: Exception) {
@@ -141,6 +159,7 @@ class NativeKeyProvider @Inject constructor(
      */
     fun getSecretKey(): String {
         ensureLibraryLoaded()
+        ensureKeyBlobChecked()
         return try {
             getSecretKeyNative(context)
         } catch (e: Exception) {
@@ -149,6 +168,27 @@ class NativeKeyProvider @Inject constructor(
         }
     }
 
+    /**
+     * Retrieves a key from the native registry by its ID
+     * (e.g. "staging.api", "partner.grocer.secret", see key-definitions.h)
+     *
+     * @return The key, or empty string if:
+     *         - The ID is unknown
+     *         - Package verification failed
+     *
+     * @throws NativeLibraryNotLoadedException if library is not available
+     */
+    fun getKey(id: String): String {
+        ensureLibraryLoaded()
+        ensureKeyBlobChecked()
+        return try {
+            getKeyNative(context, id)
+        } catch (e: Exception) {
+            Log.e(TAG, "Error retrieving key: ${e.message}", e)
+            ""
+        }
+    }
+
     /**
      * Retrieves the app identifier built from runtime concatenation
      *
@@ -210,6 +250,80 @@ class NativeKeyProvider @Inject constructor(
         }
     }
 
+    /**
+     * Retrieves a registry key safely, returning null instead of throwing
+     *
+     * @return The key, or null if unavailable or unknown
+     */
+    fun getKeyOrNull(id: String): String? {
+        return if (isLibraryLoaded) {
+            val key = getKey(id)
+            key.takeIf { it.isNotEmpty() }
+        } else {
+            null
+        }
+    }
+
+    /**
+     * Opens the key blob before the first key fetch; if it cannot be opened,
+     * the compiled keys are used
+     */
+    private fun ensureKeyBlobChecked() {
+        if (keyBlobChecked) return
+        synchronized(this) {
+            if (!keyBlobChecked) {
+                openKeyBlob()
+                keyBlobChecked = true
+            }
+        }
+    }
+
+    /**
+     * Maps the key blob asset in place, or from a copy if the APK stores it
+     * compressed
+     */
+    private fun openKeyBlob(): Boolean {
+        if (!isLibraryLoaded) return false
+        return try {
+            context.assets.openFd(KEY_BLOB_ASSET).use { asset ->
+                openKeyBlobNative(asset.parcelFileDescriptor.fd, asset.startOffset, asset.length)
+            }
+        } catch (e: FileNotFoundException) {
+            // Also thrown for a compressed asset
+            openKeyBlobCopy()
+        } catch (e: IOException) {
+            Log.e(TAG, "Error opening key blob: ${e.message}", e)
+            false
+        }
+    }
+
+    /**
+     * Copies the asset out once per install or update, then maps the copy
+     */
+    private fun openKeyBlobCopy(): Boolean {
+        return try {
+            val copy = File(context.noBackupFilesDir, KEY_BLOB_ASSET)
+            val updated = context.packageManager
+                .getPackageInfo(context.packageName, 0).lastUpdateTime
+            if (!copy.exists() || copy.lastModified() < updated) {
+                val partial = File(context.noBackupFilesDir, "$KEY_BLOB_ASSET.tmp")
+                context.assets.open(KEY_BLOB_ASSET).use { input ->
+                    partial.outputStream().use { input.copyTo(it) }
+                }
+                if (!partial.renameTo(copy)) return false
+            }
+            ParcelFileDescriptor.open(copy, ParcelFileDescriptor.MODE_READ_ONLY).use {
+                openKeyBlobNative(it.fd, 0L, copy.length())
+            }
+        } catch (e: FileNotFoundException) {
+            Log.i(TAG, "No key blob asset, using compiled keys")
+            false
+        } catch (e: Exception) {
+            Log.e(TAG, "Error copying key blob: ${e.message}", e)
+            false
+        }
+    }
+
     /**
      * Ensures the native library is loaded before accessing native methods
      *
@@ -0,0 +1,48 @@
+package com.eslam.bakingapp.core.security
+
+import android.util.Log
+
+/**
+ * Loads the `native-keys` library exactly once for every JNI bridge in
+ * this module ([NativeKeyProvider], the thumbnail pipeline, ...).
+ *
+ * Loading failures are recorded instead of thrown so callers can fall back
+ * to their Kotlin implementations.
+ */
+internal object NativeLibrary {
+    private const val TAG = "NativeLibrary"
+    const val NAME = "native-keys"
+
+    /**
+     * Track if the native library was loaded successfully
+     */
+    @Volatile
+    var isLoaded = false
+        private set
+
+    /**
+     * Error message if library loading fails
+     */
+    @Volatile
+    var loadError: String? = null
+        private set
+
+    init {
+        try {
+            System.loadLibrary(NAME)
+            // JNI_OnLoad records a LIBRARY_LOAD telemetry event
+            isLoaded = true
+        } catch (e: UnsatisfiedLinkError) {
+            loadError = e.message
+            Log.e(TAG, "Failed to load native library: ${e.message}", e)
+        } catch (e: SecurityException) {
+            loadError = e.message
+            Log.e(TAG, "Security exception loading native library: ${e.message}", e)
+        }
+    }
+
+    /**
+     * Forces class initialization (and thus loading) and reports the result
+     */
+    fun ensureLoaded(): Boolean = isLoaded
+}
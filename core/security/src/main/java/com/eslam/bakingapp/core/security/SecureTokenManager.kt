@@ -1,21 +1,39 @@
 package com.eslam.bakingapp.core.security
 
+import android.util.Base64
+import com.eslam.bakingapp.core.common.dispatcher.IoDispatcher
+import com.eslam.bakingapp.core.network.interceptor.OfflineResponseStore
 import com.eslam.bakingapp.core.network.interceptor.TokenProvider
+import com.eslam.bakingapp.core.security.crypto.NativeSessionKeys
+import com.eslam.bakingapp.core.security.store.SecureStore
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.withContext
+import java.security.SecureRandom
 import javax.inject.Inject
 import javax.inject.Singleton
 
 /**
  * Secure token manager that implements TokenProvider interface.
- * Uses EncryptedSharedPreferences for secure token storage.
+ * Uses [SecureStore] for secure token storage: each save or clear below is
+ * one transaction, written once and atomically however many values it
+ * holds. The writes block until stored, so the suspending ones run on the
+ * IO dispatcher.
  * 
  * Security considerations:
  * - Tokens are encrypted at rest
  * - No tokens are logged
  * - Tokens can be cleared on logout or security events
+ * - Each login gets a random session ID; ending the session wipes the
+ *   [NativeSessionKeys] subkeys derived for it and the session's
+ *   [OfflineResponseStore] responses
  */
 @Singleton
 class SecureTokenManager @Inject constructor(
-    private val encryptedPrefsManager: EncryptedPreferencesManager
+    private val secureStore: SecureStore,
+    private val sessionKeys: NativeSessionKeys,
+    private val offlineResponses: OfflineResponseStore,
+    private val secureRandom: SecureRandom,
+    @IoDispatcher private val ioDispatcher: CoroutineDispatcher
 ) : TokenProvider {
     
     companion object {
@@ -25,35 +43,84 @@ class SecureTokenManager @Inject constructor(
         private const val KEY_USER_ID = "user_id"
         private const val KEY_USER_EMAIL = "user_email"
         private const val KEY_USER_NAME = "user_name"
+        private const val KEY_SESSION_ID = "session_id"
+        private const val SESSION_ID_BYTES = 16
+
+        private val ALL_KEYS = listOf(
+            KEY_ACCESS_TOKEN, KEY_REFRESH_TOKEN, KEY_TOKEN_EXPIRY,
+            KEY_USER_ID, KEY_USER_EMAIL, KEY_USER_NAME, KEY_SESSION_ID
+        )
+    }
+
+    // Values saved by versions that wrote each one to the preferences
+    private val store: SecureStore by lazy {
+        secureStore.also { it.migrateFromPreferences(ALL_KEYS) }
     }
     
     override fun getAccessToken(): String? {
-        return encryptedPrefsManager.getString(KEY_ACCESS_TOKEN)
+        return store.getString(KEY_ACCESS_TOKEN)
     }
     
     override fun getRefreshToken(): String? {
-        return encryptedPrefsManager.getString(KEY_REFRESH_TOKEN)
+        return store.getString(KEY_REFRESH_TOKEN)
     }
     
+    /**
+     * Blocks until the removal is stored; called from OkHttp's threads
+     */
     override fun clearTokens() {
-        encryptedPrefsManager.remove(KEY_ACCESS_TOKEN)
-        encryptedPrefsManager.remove(KEY_REFRESH_TOKEN)
-        encryptedPrefsManager.remove(KEY_TOKEN_EXPIRY)
+        endSession()
+        store.edit {
+            remove(KEY_ACCESS_TOKEN)
+            remove(KEY_REFRESH_TOKEN)
+            remove(KEY_TOKEN_EXPIRY)
+            remove(KEY_SESSION_ID)
+        }
     }
     
-    fun saveTokens(
+    suspend fun saveTokens(
         accessToken: String,
         refreshToken: String,
         expiresIn: Long
     ) {
-        val expiryTime = System.currentTimeMillis() + (expiresIn * 1000)
-        encryptedPrefsManager.putString(KEY_ACCESS_TOKEN, accessToken)
-        encryptedPrefsManager.putString(KEY_REFRESH_TOKEN, refreshToken)
-        encryptedPrefsManager.putLong(KEY_TOKEN_EXPIRY, expiryTime)
+        withContext(ioDispatcher) {
+            val expiryTime = System.currentTimeMillis() + (expiresIn * 1000)
+            store.edit {
+                putString(KEY_ACCESS_TOKEN, accessToken)
+                putString(KEY_REFRESH_TOKEN, refreshToken)
+                putLong(KEY_TOKEN_EXPIRY, expiryTime)
+            }
+        }
+    }
+
+    /**
+     * [saveTokens] and [saveUserInfo] in one transaction, as a login needs,
+     * starting a new session
+     */
+    suspend fun saveSession(
+        accessToken: String,
+        refreshToken: String,
+        expiresIn: Long,
+        userId: String,
+        email: String,
+        name: String
+    ) {
+        withContext(ioDispatcher) {
+            val expiryTime = System.currentTimeMillis() + (expiresIn * 1000)
+            store.edit {
+                putString(KEY_ACCESS_TOKEN, accessToken)
+                putString(KEY_REFRESH_TOKEN, refreshToken)
+                putLong(KEY_TOKEN_EXPIRY, expiryTime)
+                putString(KEY_USER_ID, userId)
+                putString(KEY_USER_EMAIL, email)
+                putString(KEY_USER_NAME, name)
+                putString(KEY_SESSION_ID, newSessionId())
+            }
+        }
     }
     
     fun isTokenExpired(): Boolean {
-        val expiryTime = encryptedPrefsManager.getLong(KEY_TOKEN_EXPIRY, 0L)
+        val expiryTime = store.getLong(KEY_TOKEN_EXPIRY, 0L)
         return System.currentTimeMillis() >= expiryTime
     }
     
@@ -61,27 +128,54 @@ class SecureTokenManager @Inject constructor(
         return getAccessToken() != null && !isTokenExpired()
     }
     
-    fun saveUserInfo(userId: String, email: String, name: String) {
-        encryptedPrefsManager.putString(KEY_USER_ID, userId)
-        encryptedPrefsManager.putString(KEY_USER_EMAIL, email)
-        encryptedPrefsManager.putString(KEY_USER_NAME, name)
+    suspend fun saveUserInfo(userId: String, email: String, name: String) {
+        withContext(ioDispatcher) {
+            store.edit {
+                putString(KEY_USER_ID, userId)
+                putString(KEY_USER_EMAIL, email)
+                putString(KEY_USER_NAME, name)
+            }
+        }
     }
     
-    fun getUserId(): String? = encryptedPrefsManager.getString(KEY_USER_ID)
+    fun getUserId(): String? = store.getString(KEY_USER_ID)
+    
+    fun getUserEmail(): String? = store.getString(KEY_USER_EMAIL)
+    
+    fun getUserName(): String? = store.getString(KEY_USER_NAME)
     
-    fun getUserEmail(): String? = encryptedPrefsManager.getString(KEY_USER_EMAIL)
+    /**
+     * The ID requests are signed under, set by [saveSession]
+     */
+    fun getSessionId(): String? = store.getString(KEY_SESSION_ID)
     
-    fun getUserName(): String? = encryptedPrefsManager.getString(KEY_USER_NAME)
+    suspend fun clearUserInfo() {
+        withContext(ioDispatcher) {
+            store.edit {
+                remove(KEY_USER_ID)
+                remove(KEY_USER_EMAIL)
+                remove(KEY_USER_NAME)
+            }
+        }
+    }
+    
+    suspend fun clearAll() {
+        withContext(ioDispatcher) {
+            endSession()
+            store.edit {
+                for (key in ALL_KEYS) remove(key)
+            }
+        }
+    }
     
-    fun clearUserInfo() {
-        encryptedPrefsManager.remove(KEY_USER_ID)
-        encryptedPrefsManager.remove(KEY_USER_EMAIL)
-        encryptedPrefsManager.remove(KEY_USER_NAME)
+    private fun newSessionId(): String {
+        val bytes = ByteArray(SESSION_ID_BYTES).also { secureRandom.nextBytes(it) }
+        return Base64.encodeToString(bytes, Base64.URL_SAFE or Base64.NO_PADDING or Base64.NO_WRAP)
     }
     
-    fun clearAll() {
-        clearTokens()
-        clearUserInfo()
+    private fun endSession() {
+        getSessionId()?.let { sessionKeys.invalidate(it) }
+        offlineResponses.clear()
     }
 }
 
@@ -0,0 +1,113 @@
+package com.eslam.bakingapp.core.security.cache
+
+import android.content.Context
+import android.util.Log
+import com.eslam.bakingapp.core.network.interceptor.OfflineResponseStore
+import com.eslam.bakingapp.core.security.NativeLibrary
+import dagger.hilt.android.qualifiers.ApplicationContext
+import java.io.File
+import java.nio.ByteBuffer
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Native, compressed on-disk store for offline API responses.
+ *
+ * Bodies are deflate-compressed with a preset dictionary the cache trains
+ * from the first recipe payloads it sees, and stored content-addressed in
+ * an append-only file behind an mmap'd URL-hash index. Reads decompress in
+ * a stream straight into a direct [ByteBuffer], which the
+ * `OfflineCacheInterceptor` hands to the Retrofit converter.
+ */
+@Singleton
+class NativeResponseCache @Inject constructor(
+    @ApplicationContext private val context: Context
+) : OfflineResponseStore {
+
+    companion object {
+        private const val TAG = "NativeResponseCache"
+        private const val CACHE_DIRECTORY = "responses"
+        private const val CACHE_CAPACITY = 1024
+    }
+
+    /**
+     * Snapshot of the cache size, see [stats]
+     */
+    data class Stats(
+        val entries: Long,
+        val rawBytes: Long,
+        val compressedBytes: Long,
+        val fileBytes: Long,
+        val hasDictionary: Boolean
+    )
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        val directory = File(context.cacheDir, CACHE_DIRECTORY).absolutePath
+        nativeOpen(directory, CACHE_CAPACITY).also {
+            if (it == 0L) Log.e(TAG, "Failed to open response cache in $directory")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeOpen(directory: String, capacity: Int): Long
+
+    private external fun nativeClose(handle: Long)
+
+    private external fun nativeKeyFor(url: String): Long
+
+    private external fun nativePut(handle: Long, key: Long, body: ByteArray): Boolean
+
+    private external fun nativeLookup(handle: Long, key: Long): Int
+
+    private external fun nativeRead(handle: Long, key: Long, buffer: ByteBuffer): Boolean
+
+    private external fun nativeRemove(handle: Long, key: Long): Boolean
+
+    private external fun nativeClear(handle: Long)
+
+    private external fun nativeStats(handle: Long): LongArray
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library and the on-disk cache are usable
+     */
+    fun isAvailable(): Boolean = handle != 0L
+
+    override fun put(url: String, body: ByteArray) {
+        if (!isAvailable() || body.isEmpty()) return
+        if (!nativePut(handle, nativeKeyFor(url), body)) {
+            Log.w(TAG, "Failed to cache response for $url")
+        }
+    }
+
+    override fun get(url: String): ByteBuffer? {
+        if (!isAvailable()) return null
+        val key = nativeKeyFor(url)
+        val size = nativeLookup(handle, key)
+        if (size < 0) return null
+        val buffer = ByteBuffer.allocateDirect(size)
+        return if (nativeRead(handle, key, buffer)) buffer else null
+    }
+
+    fun remove(url: String): Boolean =
+        isAvailable() && nativeRemove(handle, nativeKeyFor(url))
+
+    override fun clear() {
+        if (isAvailable()) nativeClear(handle)
+    }
+
+    fun stats(): Stats {
+        if (!isAvailable()) return Stats(0, 0, 0, 0, false)
+        val values = nativeStats(handle)
+        return Stats(
+            entries = values[0],
+            rawBytes = values[1],
+            compressedBytes = values[2],
+            fileBytes = values[3],
+            hasDictionary = values[4] != 0L
+        )
+    }
+}
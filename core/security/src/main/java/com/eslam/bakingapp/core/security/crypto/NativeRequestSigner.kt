@@ -0,0 +1,28 @@
+package com.eslam.bakingapp.core.security.crypto
+
+import com.eslam.bakingapp.core.network.interceptor.RequestSigner
+import com.eslam.bakingapp.core.security.SecureTokenManager
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [RequestSigner] backed by [NativeSessionKeys]: each request is signed
+ * with the signed-in session's request subkey, which never leaves native
+ * code.
+ *
+ * Signed out, or without the native library, requests go out unsigned.
+ */
+@Singleton
+class NativeRequestSigner @Inject constructor(
+    private val tokenManager: SecureTokenManager,
+    private val sessionKeys: NativeSessionKeys
+) : RequestSigner {
+
+    override fun sessionId(): String? {
+        if (tokenManager.getAccessToken() == null) return null
+        return tokenManager.getSessionId()
+    }
+
+    override fun sign(sessionId: String, message: ByteArray): ByteArray? =
+        sessionKeys.sign(NativeSessionKeys.PURPOSE_REQUEST, sessionId, message)
+}
@@ -0,0 +1,98 @@
+package com.eslam.bakingapp.core.security.crypto
+
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import java.security.SecureRandom
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [SecureRandom] backed by the native per-thread ChaCha20 generator.
+ *
+ * Every thread calling in gets its own generator, seeded from getrandom()
+ * and reseeded after 1 MiB of output and after fork(), so nonces and IVs
+ * cost neither a lock nor a syscall under parallel request load. Bulk
+ * requests are generated four ChaCha20 blocks at a time with NEON/SSE2.
+ *
+ * Usage:
+ * ```kotlin
+ * val iv = secureRandom.nextNonce()
+ * secureRandom.nextBytes(salt)
+ * ```
+ *
+ * The generator passes a SIMD known-answer check and the FIPS 140-2
+ * statistical tests before first use. Without the native library, or if
+ * the self-test fails, every call falls through to the platform
+ * [SecureRandom].
+ */
+@Singleton
+class NativeSecureRandom @Inject constructor() : SecureRandom() {
+
+    companion object {
+        private const val TAG = "NativeSecureRandom"
+        private const val ALGORITHM = "ChaCha20-PerThread"
+
+        /** A ChaCha20-Poly1305 or AES-GCM nonce */
+        const val NONCE_BYTES = 12
+    }
+
+    /**
+     * Process-wide generator counters, see [stats]
+     */
+    data class Stats(
+        val generatedBytes: Long,
+        val reseeds: Long,
+        val forkReseeds: Long
+    )
+
+    private val available: Boolean by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy false
+        nativeSelfTest().also {
+            if (!it) Log.e(TAG, "Self-test failed, using the platform SecureRandom")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeNextBytes(bytes: ByteArray): Boolean
+
+    private external fun nativeGenerateSeed(bytes: ByteArray): Boolean
+
+    private external fun nativeSelfTest(): Boolean
+
+    private external fun nativeStats(): LongArray?
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if output comes from the native generator
+     */
+    fun isAvailable(): Boolean = available
+
+    override fun getAlgorithm(): String = if (available) ALGORITHM else super.getAlgorithm()
+
+    override fun nextBytes(bytes: ByteArray) {
+        if (available && nativeNextBytes(bytes)) return
+        super.nextBytes(bytes)
+    }
+
+    /**
+     * Kernel entropy, bypassing the generator
+     */
+    override fun generateSeed(numBytes: Int): ByteArray {
+        val seed = ByteArray(numBytes)
+        if (available && nativeGenerateSeed(seed)) return seed
+        return super.generateSeed(numBytes)
+    }
+
+    /**
+     * A fresh random nonce or IV of [size] bytes
+     */
+    fun nextNonce(size: Int = NONCE_BYTES): ByteArray = ByteArray(size).also { nextBytes(it) }
+
+    fun stats(): Stats? {
+        if (!available) return null
+        val values = nativeStats() ?: return null
+        return Stats(values[0], values[1], values[2])
+    }
+}
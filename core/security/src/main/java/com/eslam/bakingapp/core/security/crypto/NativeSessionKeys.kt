@@ -0,0 +1,169 @@
+package com.eslam.bakingapp.core.security.crypto
+
+import android.content.Context
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import dagger.hilt.android.qualifiers.ApplicationContext
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Per-session, per-purpose keys derived natively from the master secret.
+ *
+ * Each (purpose, session) pair gets its own HKDF-SHA256 subkey of the
+ * secret key, cached in a bounded native LRU that is wiped on eviction.
+ * Neither the master secret nor any subkey ever reaches Kotlin: requests
+ * are signed (HMAC-SHA256) and payloads sealed (ChaCha20-Poly1305) in
+ * native code, and only MACs and ciphertext come back.
+ *
+ * Usage:
+ * ```kotlin
+ * val mac = sessionKeys.sign(PURPOSE_REQUEST, sessionId, body)
+ * val sealed = sessionKeys.seal(PURPOSE_STORAGE, sessionId, plaintext)
+ * sessionKeys.invalidate(sessionId) // on logout
+ * ```
+ *
+ * Without the native library every call returns null or false.
+ */
+@Singleton
+class NativeSessionKeys @Inject constructor(
+    @ApplicationContext private val context: Context
+) {
+
+    companion object {
+        private const val TAG = "NativeSessionKeys"
+        private const val CAPACITY = 64
+
+        const val PURPOSE_REQUEST = "request"
+        const val PURPOSE_STORAGE = "storage"
+
+        /** Longest purpose and session IDs, in UTF-8 bytes */
+        const val MAX_PURPOSE_LENGTH = 32
+        const val MAX_SESSION_LENGTH = 96
+    }
+
+    /**
+     * Snapshot of the subkey cache, see [stats]
+     */
+    data class Stats(
+        val hits: Long,
+        val misses: Long,
+        val evictions: Long,
+        val size: Long,
+        val capacity: Long
+    )
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        nativeCreate(context, CAPACITY).also {
+            if (it == 0L) Log.e(TAG, "Failed to create the session key cache")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeCreate(context: Context, capacity: Int): Long
+
+    private external fun nativeSign(
+        handle: Long,
+        purpose: String,
+        session: String,
+        message: ByteArray
+    ): ByteArray?
+
+    private external fun nativeVerify(
+        handle: Long,
+        purpose: String,
+        session: String,
+        message: ByteArray,
+        mac: ByteArray
+    ): Boolean
+
+    private external fun nativeSeal(
+        handle: Long,
+        purpose: String,
+        session: String,
+        plaintext: ByteArray,
+        aad: ByteArray?
+    ): ByteArray?
+
+    private external fun nativeOpen(
+        handle: Long,
+        purpose: String,
+        session: String,
+        sealed: ByteArray,
+        aad: ByteArray?
+    ): ByteArray?
+
+    private external fun nativeInvalidate(handle: Long, session: String): Int
+
+    private external fun nativeClear(handle: Long)
+
+    private external fun nativeStats(handle: Long): LongArray?
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library is loaded and the package check
+     * passed
+     */
+    fun isAvailable(): Boolean = handle != 0L
+
+    /**
+     * HMAC-SHA256 of [message] under the (purpose, session) subkey, or null
+     * for an empty or overlong ID
+     */
+    fun sign(purpose: String, session: String, message: ByteArray): ByteArray? {
+        if (!isAvailable()) return null
+        return nativeSign(handle, purpose, session, message)
+    }
+
+    fun verify(purpose: String, session: String, message: ByteArray, mac: ByteArray): Boolean {
+        if (!isAvailable()) return false
+        return nativeVerify(handle, purpose, session, message, mac)
+    }
+
+    /**
+     * Encrypts [plaintext] under the (purpose, session) subkey
+     *
+     * @return nonce (12 bytes) + ciphertext + tag (16 bytes), or null
+     */
+    fun seal(purpose: String, session: String, plaintext: ByteArray, aad: ByteArray? = null): ByteArray? {
+        if (!isAvailable()) return null
+        return nativeSeal(handle, purpose, session, plaintext, aad)
+    }
+
+    /**
+     * Decrypts the output of [seal]
+     *
+     * @return the plaintext, or null if [sealed] was tampered with or sealed
+     *   under another subkey
+     */
+    fun open(purpose: String, session: String, sealed: ByteArray, aad: ByteArray? = null): ByteArray? {
+        if (!isAvailable()) return null
+        return nativeOpen(handle, purpose, session, sealed, aad)
+    }
+
+    /**
+     * Wipes every subkey of [session], e.g. on logout
+     *
+     * @return the number of subkeys dropped
+     */
+    fun invalidate(session: String): Int {
+        if (!isAvailable()) return 0
+        return nativeInvalidate(handle, session)
+    }
+
+    /**
+     * Wipes all subkeys and the derived master state
+     */
+    fun clear() {
+        if (isAvailable()) nativeClear(handle)
+    }
+
+    fun stats(): Stats? {
+        if (!isAvailable()) return null
+        val values = nativeStats(handle) ?: return null
+        return Stats(values[0], values[1], values[2], values[3], values[4])
+    }
+}
@@ -1,15 +1,51 @@
 package com.eslam.bakingapp.core.security.di
 
+import com.eslam.bakingapp.core.network.emulation.LinkEmulator
+import com.eslam.bakingapp.core.network.interceptor.OfflineResponseStore
+import com.eslam.bakingapp.core.network.interceptor.RequestSigner
 import com.eslam.bakingapp.core.network.interceptor.TokenProvider
+import com.eslam.bakingapp.core.network.interning.StringInterner
+import com.eslam.bakingapp.core.network.telemetry.TelemetryRecorder
 import com.eslam.bakingapp.core.security.ApiKeyProvider
 import com.eslam.bakingapp.core.security.DefaultApiKeyProvider
 import com.eslam.bakingapp.core.security.NativeKeyProvider
 import com.eslam.bakingapp.core.security.SecureTokenManager
+import com.eslam.bakingapp.core.security.cache.NativeResponseCache
+import com.eslam.bakingapp.core.security.crypto.NativeRequestSigner
+import com.eslam.bakingapp.core.security.crypto.NativeSecureRandom
+import com.eslam.bakingapp.core.security.memory.MemoryAccounting
+import com.eslam.bakingapp.core.security.memory.NativeMemoryAccounting
+import com.eslam.bakingapp.core.security.network.NativeLinkEmulator
+import com.eslam.bakingapp.core.security.search.FacetIndex
+import com.eslam.bakingapp.core.security.search.IngredientIndex
+import com.eslam.bakingapp.core.security.search.NativeFacetIndex
+import com.eslam.bakingapp.core.security.search.NativeIngredientIndex
+import com.eslam.bakingapp.core.security.search.NativeRecipeSearchIndex
+import com.eslam.bakingapp.core.security.search.NativeSimilarRecipeIndex
+import com.eslam.bakingapp.core.security.search.RecipeSearchIndex
+import com.eslam.bakingapp.core.security.search.SimilarRecipeIndex
+import com.eslam.bakingapp.core.security.sort.KeySorter
+import com.eslam.bakingapp.core.security.sort.NativeKeySorter
+import com.eslam.bakingapp.core.security.store.NativeSecureStore
+import com.eslam.bakingapp.core.security.store.SecureStore
+import com.eslam.bakingapp.core.security.strings.NativeStringPool
+import com.eslam.bakingapp.core.security.sync.NativeRecipeDeltaSync
+import com.eslam.bakingapp.core.security.sync.NativeTimestampParser
+import com.eslam.bakingapp.core.security.sync.RecipeDeltaSync
+import com.eslam.bakingapp.core.security.sync.TimestampParser
+import com.eslam.bakingapp.core.security.telemetry.NativeTelemetry
+import com.eslam.bakingapp.core.security.timers.NativeTimerJournal
+import com.eslam.bakingapp.core.security.timers.NativeTimerTickEngine
+import com.eslam.bakingapp.core.security.timers.TimerJournal
+import com.eslam.bakingapp.core.security.timers.TimerTickEngine
+import com.eslam.bakingapp.core.security.units.IngredientScaler
+import com.eslam.bakingapp.core.security.units.NativeIngredientScaler
 import dagger.Binds
 import dagger.Module
 import dagger.Provides
 import dagger.hilt.InstallIn
 import dagger.hilt.components.SingletonComponent
+import java.security.SecureRandom
 import javax.inject.Singleton
 
 /**
@@ -17,6 +53,24 @@ import javax.inject.Singleton
  *
  * Provides:
  * - [TokenProvider] for authentication token management
+ * - [RequestSigner] for signing requests with the session's native request subkey
+ * - [OfflineResponseStore] for the compressed offline response cache
+ * - [LinkEmulator] for emulated network conditions in debug builds
+ * - [TelemetryRecorder] for hot-path event telemetry
+ * - [IngredientScaler] for native ingredient scaling and unit conversion
+ * - [TimerTickEngine] for clock-derived cooking timer countdowns
+ * - [TimerJournal] for crash-safe cooking timer state
+ * - [RecipeDeltaSync] for writing only the recipes a sync changed
+ * - [StringInterner] for one shared String per repeated recipe field value
+ * - [RecipeSearchIndex] for ranked full-text recipe search
+ * - [IngredientIndex] for finding recipes by the ingredients at hand
+ * - [FacetIndex] for filtering recipes with live per-facet counts
+ * - [SimilarRecipeIndex] for recipes sharing most of an ingredient list
+ * - [SecureRandom] for lock-free nonces and IVs from per-thread native generators
+ * - [TimestampParser] for parsing a sync's ISO-8601 timestamps in one native call
+ * - [KeySorter] for native radix and top-K sorts of lists by a Long key
+ * - [SecureStore] for credentials written in atomic, group-committed transactions
+ * - [MemoryAccounting] for per-subsystem native heap usage and trimming under memory pressure
  * - [ApiKeyProvider] for secure API key access via native code
  * - [NativeKeyProvider] for direct native library access
  */
@@ -30,6 +84,114 @@ abstract class SecurityModule {
         secureTokenManager: SecureTokenManager
     ): TokenProvider
 
+    @Binds
+    @Singleton
+    abstract fun bindRequestSigner(
+        nativeRequestSigner: NativeRequestSigner
+    ): RequestSigner
+
+    @Binds
+    @Singleton
+    abstract fun bindOfflineResponseStore(
+        nativeResponseCache: NativeResponseCache
+    ): OfflineResponseStore
+
+    @Binds
+    @Singleton
+    abstract fun bindLinkEmulator(
+        nativeLinkEmulator: NativeLinkEmulator
+    ): LinkEmulator
+
+    @Binds
+    @Singleton
+    abstract fun bindTelemetryRecorder(
+        nativeTelemetry: NativeTelemetry
+    ): TelemetryRecorder
+
+    @Binds
+    @Singleton
+    abstract fun bindIngredientScaler(
+        nativeIngredientScaler: NativeIngredientScaler
+    ): IngredientScaler
+
+    @Binds
+    @Singleton
+    abstract fun bindTimerTickEngine(
+        nativeTimerTickEngine: NativeTimerTickEngine
+    ): TimerTickEngine
+
+    @Binds
+    @Singleton
+    abstract fun bindTimerJournal(
+        nativeTimerJournal: NativeTimerJournal
+    ): TimerJournal
+
+    @Binds
+    @Singleton
+    abstract fun bindRecipeDeltaSync(
+        nativeRecipeDeltaSync: NativeRecipeDeltaSync
+    ): RecipeDeltaSync
+
+    @Binds
+    @Singleton
+    abstract fun bindStringInterner(
+        nativeStringPool: NativeStringPool
+    ): StringInterner
+
+    @Binds
+    @Singleton
+    abstract fun bindRecipeSearchIndex(
+        nativeRecipeSearchIndex: NativeRecipeSearchIndex
+    ): RecipeSearchIndex
+
+    @Binds
+    @Singleton
+    abstract fun bindIngredientIndex(
+        nativeIngredientIndex: NativeIngredientIndex
+    ): IngredientIndex
+
+    @Binds
+    @Singleton
+    abstract fun bindFacetIndex(
+        nativeFacetIndex: NativeFacetIndex
+    ): FacetIndex
+
+    @Binds
+    @Singleton
+    abstract fun bindSimilarRecipeIndex(
+        nativeSimilarRecipeIndex: NativeSimilarRecipeIndex
+    ): SimilarRecipeIndex
+
+    @Binds
+    @Singleton
+    abstract fun bindSecureRandom(
+        nativeSecureRandom: NativeSecureRandom
+    ): SecureRandom
+
+    @Binds
+    @Singleton
+    abstract fun bindTimestampParser(
+        nativeTimestampParser: NativeTimestampParser
+    ): TimestampParser
+
+    @Binds
+    @Singleton
+    abstract fun bindKeySorter(
+        nativeKeySorter: NativeKeySorter
+    ): KeySorter
+
+    @Binds
+    @Singleton
+    abstract fun bindSecureStore(
+        nativeSecureStore: NativeSecureStore
+    ): SecureStore
+
+    @Binds
+    @Singleton
+    abstract fun bindMemoryAccounting(
+        nativeMemoryAccounting: NativeMemoryAccounting
+    ): MemoryAccounting
+
     companion object {
         /**
          * Provides the ApiKeyProvider implementation.
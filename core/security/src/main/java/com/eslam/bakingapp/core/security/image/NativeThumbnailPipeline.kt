@@ -0,0 +1,127 @@
+package com.eslam.bakingapp.core.security.image
+
+import android.content.Context
+import android.graphics.Bitmap
+import android.graphics.BitmapFactory
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import dagger.hilt.android.qualifiers.ApplicationContext
+import java.io.File
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Native thumbnail pipeline for recipe images and step thumbnails.
+ *
+ * `imageUrl` / `thumbnailUrl` images are decoded with a power-of-two
+ * `inSampleSize` (never at full size), resized natively with an exact
+ * area-average filter to the cell size and written to a content-addressed
+ * on-disk cache. Cache hits are copied straight into a cell-sized bitmap,
+ * so list scrolling never allocates full-size bitmaps.
+ *
+ * Usage:
+ * ```kotlin
+ * val bitmap = thumbnailPipeline.getThumbnail(recipe.imageUrl, widthPx, heightPx) {
+ *     httpClient.download(recipe.imageUrl)
+ * }
+ * ```
+ */
+@Singleton
+class NativeThumbnailPipeline @Inject constructor(
+    @ApplicationContext private val context: Context
+) {
+    companion object {
+        private const val TAG = "NativeThumbnailPipeline"
+        private const val CACHE_DIRECTORY = "thumbnails"
+        private const val CACHE_CAPACITY = 4096
+    }
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        val directory = File(context.cacheDir, CACHE_DIRECTORY).absolutePath
+        nativeOpen(directory, CACHE_CAPACITY).also {
+            if (it == 0L) Log.e(TAG, "Failed to open thumbnail cache in $directory")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeOpen(directory: String, capacity: Int): Long
+
+    private external fun nativeClose(handle: Long)
+
+    private external fun nativeKeyFor(url: String, width: Int, height: Int, centerCrop: Boolean): Long
+
+    private external fun nativeLoad(handle: Long, key: Long, target: Bitmap): Boolean
+
+    private external fun nativeResizeAndStore(
+        handle: Long,
+        key: Long,
+        source: Bitmap,
+        target: Bitmap,
+        centerCrop: Boolean
+    ): Boolean
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library and the on-disk cache are usable
+     */
+    fun isAvailable(): Boolean = handle != 0L
+
+    /**
+     * Returns a [width] x [height] thumbnail for [url].
+     *
+     * @param encoded Supplies the encoded JPEG/PNG bytes; only invoked on a cache miss
+     * @return The thumbnail, or null if the pipeline is unavailable or decoding failed
+     */
+    fun getThumbnail(
+        url: String,
+        width: Int,
+        height: Int,
+        centerCrop: Boolean = true,
+        encoded: () -> ByteArray?
+    ): Bitmap? {
+        if (!isAvailable() || width <= 0 || height <= 0) return null
+
+        val key = nativeKeyFor(url, width, height, centerCrop)
+        val target = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+        if (nativeLoad(handle, key, target)) return target
+
+        val source = encoded()?.let { decodeSampled(it, width, height) }
+        if (source == null) {
+            target.recycle()
+            return null
+        }
+        val resized = nativeResizeAndStore(handle, key, source, target, centerCrop)
+        source.recycle()
+        if (!resized) {
+            target.recycle()
+            return null
+        }
+        return target
+    }
+
+    /**
+     * Decodes with the largest power-of-two subsampling that still leaves
+     * at least the requested size, so the native resize only ever sees an
+     * image between 1x and 2x the cell.
+     */
+    private fun decodeSampled(bytes: ByteArray, width: Int, height: Int): Bitmap? {
+        val bounds = BitmapFactory.Options().apply { inJustDecodeBounds = true }
+        BitmapFactory.decodeByteArray(bytes, 0, bytes.size, bounds)
+        if (bounds.outWidth <= 0 || bounds.outHeight <= 0) return null
+
+        var sampleSize = 1
+        while (bounds.outWidth / (sampleSize * 2) >= width &&
+            bounds.outHeight / (sampleSize * 2) >= height
+        ) {
+            sampleSize *= 2
+        }
+        val options = BitmapFactory.Options().apply {
+            inSampleSize = sampleSize
+            inPreferredConfig = Bitmap.Config.ARGB_8888
+        }
+        return BitmapFactory.decodeByteArray(bytes, 0, bytes.size, options)
+    }
+}
@@ -0,0 +1,108 @@
+package com.eslam.bakingapp.core.security.jobs
+
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.withTimeoutOrNull
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicLong
+import kotlin.coroutines.cancellation.CancellationException
+
+/**
+ * Runs long native work on the native thread pool and suspends the caller
+ * until it finishes, instead of holding a dispatcher thread in a blocking
+ * JNI call.
+ *
+ * Each job is registered under an id with a [CompletableDeferred]; the JNI
+ * bridge passes the id to native code, which queues the work and returns
+ * at once. When the work is done a pool worker makes one upcall,
+ * [onJobComplete], through a method ID cached at init. Cancelling the
+ * awaiting coroutine cancels the native job: a queued job never runs, a
+ * running one stops at its next checkpoint. A job that has not completed
+ * within its timeout is cancelled the same way and [await] returns null,
+ * so a lost completion never leaves the caller suspended for good.
+ *
+ * Usage (from a JNI bridge in this module):
+ * ```kotlin
+ * val packed: ByteArray? = NativeJobs.await { jobId -> nativeSubmitDiff(handle, body, length, jobId) }
+ * ```
+ */
+internal object NativeJobs {
+    private const val TAG = "NativeJobs"
+
+    // JobStatus in common/async-jobs.h
+    private const val DONE = 0
+    private const val CANCELLED = 2
+
+    private const val DEFAULT_TIMEOUT_MILLIS = 60_000L
+
+    private val nextId = AtomicLong(1)
+    private val pending = ConcurrentHashMap<Long, CompletableDeferred<Any?>>()
+
+    private val isInitialized: Boolean by lazy {
+        NativeLibrary.ensureLoaded() && nativeInit().also {
+            if (!it) Log.e(TAG, "Failed to set up native job completion")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeInit(): Boolean
+
+    private external fun nativeCancel(jobId: Long): Boolean
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if native jobs can be submitted
+     */
+    fun isAvailable(): Boolean = isInitialized
+
+    /**
+     * Starts a native job and suspends until it completes
+     *
+     * @param timeoutMillis How long to wait before cancelling the job
+     * @param submit Starts the job under the given id; false if it could not
+     * @return The job's result, or null if it could not be started, failed
+     *   or timed out
+     */
+    suspend fun <T : Any> await(
+        timeoutMillis: Long = DEFAULT_TIMEOUT_MILLIS,
+        submit: (jobId: Long) -> Boolean
+    ): T? {
+        if (!isInitialized) return null
+        val jobId = nextId.getAndIncrement()
+        val deferred = CompletableDeferred<Any?>()
+        pending[jobId] = deferred
+        if (!submit(jobId)) {
+            pending.remove(jobId)
+            return null
+        }
+        return try {
+            val result = withTimeoutOrNull(timeoutMillis) { deferred.await() }
+            // Still pending means no completion arrived in time
+            if (result == null && pending.remove(jobId) != null) {
+                Log.w(TAG, "Native job $jobId timed out")
+                nativeCancel(jobId)
+            }
+            @Suppress("UNCHECKED_CAST")
+            result as T?
+        } catch (e: CancellationException) {
+            nativeCancel(jobId)
+            throw e
+        }
+    }
+
+    /**
+     * Called once per job, on the native pool worker that ran it
+     */
+    @JvmStatic
+    private fun onJobComplete(jobId: Long, status: Int, result: Any?) {
+        val deferred = pending.remove(jobId) ?: return
+        when (status) {
+            DONE -> deferred.complete(result)
+            CANCELLED -> deferred.cancel()
+            else -> deferred.complete(null)
+        }
+    }
+}
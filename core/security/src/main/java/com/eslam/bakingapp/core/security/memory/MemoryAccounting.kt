@@ -0,0 +1,52 @@
+package com.eslam.bakingapp.core.security.memory
+
+/**
+ * Native subsystems whose heap is accounted separately.
+ * Ordinals match the native `MemoryTag` enum.
+ */
+enum class NativeSubsystem {
+    KEYS,
+    PARSERS,
+    INDEXES,
+    CACHES,
+    IMAGES,
+    STORE,
+    STRINGS,
+    TIMERS,
+    TELEMETRY,
+    RUNTIME
+}
+
+/**
+ * Native memory held by one subsystem
+ */
+data class SubsystemMemory(
+    val subsystem: NativeSubsystem,
+    val currentBytes: Long,
+    /** Highest [currentBytes] since the process started */
+    val peakBytes: Long,
+    /** Allocations ever made, reallocations included */
+    val allocations: Long
+)
+
+/**
+ * Per-subsystem accounting of the native heap, and the hook that lets the
+ * native caches shrink under memory pressure.
+ */
+interface MemoryAccounting {
+
+    /**
+     * A snapshot of every subsystem, empty without the native library.
+     * Counters are read one by one, so subsystems may be a few
+     * allocations apart.
+     */
+    fun getNativeMemoryStats(): List<SubsystemMemory>
+
+    /**
+     * Asks each subsystem to drop what it can rebuild, given a
+     * ComponentCallbacks2 TRIM_MEMORY_* level
+     *
+     * @return the bytes released
+     */
+    fun onTrimMemory(level: Int): Long
+}
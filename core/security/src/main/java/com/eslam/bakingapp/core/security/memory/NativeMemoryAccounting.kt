@@ -0,0 +1,53 @@
+package com.eslam.bakingapp.core.security.memory
+
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [MemoryAccounting] backed by the native tagged allocator.
+ *
+ * Every native subsystem allocates through a tagged malloc that keeps the
+ * subsystem's current bytes, high watermark and allocation count in
+ * relaxed atomics, so [getNativeMemoryStats] is one JNI call and a copy.
+ * [onTrimMemory] runs the handlers the caches registered: from
+ * TRIM_MEMORY_UI_HIDDEN the response cache frees its zlib streams, and
+ * from TRIM_MEMORY_BACKGROUND the key blob and derived-key caches wipe
+ * their decrypted keys.
+ */
+@Singleton
+class NativeMemoryAccounting @Inject constructor() : MemoryAccounting {
+
+    companion object {
+        private const val FIELDS = 3
+    }
+
+    private val available: Boolean by lazy { NativeLibrary.ensureLoaded() }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeStats(): LongArray
+
+    private external fun nativeTrimMemory(level: Int): Long
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library is loaded
+     */
+    fun isAvailable(): Boolean = available
+
+    override fun getNativeMemoryStats(): List<SubsystemMemory> {
+        if (!isAvailable()) return emptyList()
+        val values = nativeStats()
+        return NativeSubsystem.entries.map {
+            val base = it.ordinal * FIELDS
+            SubsystemMemory(it, values[base], values[base + 1], values[base + 2])
+        }
+    }
+
+    override fun onTrimMemory(level: Int): Long {
+        if (!isAvailable()) return 0
+        return nativeTrimMemory(level)
+    }
+}
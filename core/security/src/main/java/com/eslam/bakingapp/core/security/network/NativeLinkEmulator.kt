@@ -0,0 +1,119 @@
+package com.eslam.bakingapp.core.security.network
+
+import android.util.Log
+import com.eslam.bakingapp.core.network.emulation.LinkEmulator
+import com.eslam.bakingapp.core.network.emulation.LinkProfile
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [LinkEmulator] backed by a native link model and a single native timer
+ * thread.
+ *
+ * Each transfer is planned natively (token-bucket bandwidth per direction,
+ * latency plus jitter, per-packet loss with retransmission timeouts) and
+ * queued on a deadline heap; the timer thread sleeps until the earliest
+ * deadline and releases transfers through one upcall, [onRelease]. Thousands
+ * of delayed calls cost one thread and a heap entry each.
+ *
+ * Without the native library transfers are released immediately, so calls
+ * go through undelayed.
+ */
+@Singleton
+class NativeLinkEmulator @Inject constructor() : LinkEmulator {
+
+    companion object {
+        private const val TAG = "NativeLinkEmulator"
+        private const val PER_MILLION = 1_000_000
+
+        // Guarded by itself; transfer() holds it until the ticket is registered
+        private val releases = HashMap<Long, (Boolean) -> Unit>()
+
+        /**
+         * Called on the native timer thread when a transfer is due
+         */
+        @JvmStatic
+        private fun onRelease(ticket: Long, delivered: Boolean) {
+            synchronized(releases) { releases.remove(ticket) }?.invoke(delivered)
+        }
+    }
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        nativeCreate().also {
+            if (it == 0L) Log.e(TAG, "Failed to start the link emulator") else configure(it, profile)
+        }
+    }
+
+    @Volatile
+    override var isEnabled: Boolean = false
+
+    @Volatile
+    override var profile: LinkProfile = LinkProfile.DEFAULT
+        set(value) {
+            field = value
+            if (isAvailable()) configure(handle, value)
+        }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeCreate(): Long
+
+    private external fun nativeConfigure(
+        handle: Long,
+        latencyMicros: Int,
+        jitterMicros: Int,
+        bytesPerSecond: Long,
+        burstBytes: Int,
+        lossPerMillion: Int,
+        packetBytes: Int
+    )
+
+    private external fun nativeTransfer(handle: Long, upstream: Boolean, bytes: Long): Long
+
+    private external fun nativeCancel(handle: Long, ticket: Long): Boolean
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library and the timer thread are usable
+     */
+    fun isAvailable(): Boolean = handle != 0L
+
+    override fun transfer(upstream: Boolean, bytes: Long, onRelease: (delivered: Boolean) -> Unit): Long {
+        if (!isAvailable()) {
+            onRelease(true)
+            return 0L
+        }
+        // The timer thread may release the ticket at once; it waits for the
+        // lock, and so for the registration
+        synchronized(releases) {
+            val ticket = nativeTransfer(handle, upstream, bytes)
+            if (ticket == 0L) {
+                onRelease(true)
+            } else {
+                releases[ticket] = onRelease
+            }
+            return ticket
+        }
+    }
+
+    override fun cancel(ticket: Long): Boolean {
+        if (ticket == 0L || !isAvailable() || !nativeCancel(handle, ticket)) return false
+        synchronized(releases) { releases.remove(ticket) }
+        return true
+    }
+
+    private fun configure(handle: Long, profile: LinkProfile) {
+        nativeConfigure(
+            handle,
+            profile.latencyMs * 1000,
+            profile.jitterMs * 1000,
+            profile.bytesPerSecond,
+            profile.burstBytes,
+            (profile.lossRate.coerceIn(0.0, 1.0) * PER_MILLION).toInt(),
+            profile.packetBytes
+        )
+    }
+}
@@ -0,0 +1,96 @@
+package com.eslam.bakingapp.core.security.search
+
+/**
+ * Faceted recipe filtering with live counts.
+ *
+ * Recipes are filtered on any combination of category, difficulty,
+ * favorite status and prep/cook time bucket, and every evaluation also
+ * counts, for each value of each facet, the recipes that would match if
+ * that facet alone were not filtered: the numbers a filter screen shows
+ * next to each choice. The index lives in memory: build it from the
+ * database once, then keep it in step with every write.
+ */
+interface FacetIndex {
+
+    companion object {
+        /**
+         * Inclusive upper bounds in minutes of the time buckets; one more
+         * bucket takes everything longer
+         */
+        val TIME_BUCKET_LIMITS = listOf(10, 20, 30, 45, 60, 90, 120)
+
+        val TIME_BUCKETS = TIME_BUCKET_LIMITS.size + 1
+
+        fun timeBucket(minutes: Int): Int {
+            val bucket = TIME_BUCKET_LIMITS.indexOfFirst { minutes <= it }
+            return if (bucket < 0) TIME_BUCKETS - 1 else bucket
+        }
+    }
+
+    /**
+     * What gets indexed of one recipe
+     */
+    class Entry(
+        val id: String,
+        val category: String,
+        val difficulty: String,
+        val isFavorite: Boolean,
+        val prepTimeMinutes: Int,
+        val cookTimeMinutes: Int
+    )
+
+    /**
+     * Accepted values per facet; an empty set or a null [favorite] accepts
+     * every value
+     */
+    data class Filter(
+        val categories: Set<String> = emptySet(),
+        val difficulties: Set<String> = emptySet(),
+        val favorite: Boolean? = null,
+        val prepTimeBuckets: Set<Int> = emptySet(),
+        val cookTimeBuckets: Set<Int> = emptySet()
+    )
+
+    /**
+     * Per value, the recipes matching every other facet's part of the filter;
+     * time counts are indexed by bucket
+     */
+    data class Counts(
+        val categories: Map<String, Int>,
+        val difficulties: Map<String, Int>,
+        val favorites: Map<Boolean, Int>,
+        val prepTimeBuckets: List<Int>,
+        val cookTimeBuckets: List<Int>
+    )
+
+    /**
+     * @param ids the first matching recipe ids, in indexing order
+     * @param total how many recipes match in all
+     */
+    data class Evaluation(
+        val ids: List<String>,
+        val total: Long,
+        val counts: Counts
+    )
+
+    fun isAvailable(): Boolean
+
+    /**
+     * Indexes [entries], replacing earlier versions with the same ids, and
+     * drops [removedIds]
+     */
+    fun update(entries: Collection<Entry>, removedIds: Collection<String> = emptyList())
+
+    fun setFavorite(id: String, favorite: Boolean)
+
+    /**
+     * @return up to [limit] matching ids with every facet count, or null
+     *   if the index is unavailable
+     */
+    fun evaluate(filter: Filter, limit: Int): Evaluation?
+
+    /**
+     * Drops every recipe, e.g. before a full rebuild
+     */
+    fun clear()
+}
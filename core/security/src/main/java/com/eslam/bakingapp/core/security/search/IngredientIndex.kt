@@ -0,0 +1,51 @@
+package com.eslam.bakingapp.core.security.search
+
+/**
+ * "What can I cook with these": recipes by the ingredients they use.
+ *
+ * Ingredient names are folded and stemmed like search text, and a query
+ * ingredient also matches the longer names it appears in ("tomato" finds
+ * "Cherry Tomatoes", not "Tomatillos"). The index is saved to a file after
+ * every change and loaded from it on first use, so a restart needs no
+ * rebuild.
+ */
+interface IngredientIndex {
+
+    fun isAvailable(): Boolean
+
+    /**
+     * Loads the saved index
+     *
+     * @return false if there is none or it is unusable; rebuild it with
+     *   [update] from the database then
+     */
+    fun load(): Boolean
+
+    /**
+     * Indexes each recipe's ingredient names, replacing what it had, drops
+     * [removedIds] and saves
+     *
+     * @param recipes ingredient names by recipe id
+     */
+    fun update(recipes: Map<String, List<String>>, removedIds: Collection<String> = emptyList())
+
+    /**
+     * @return up to [limit] ids of recipes using every ingredient in
+     *   [include] and none in [exclude], or null if the index is unavailable
+     */
+    fun findRecipes(
+        include: List<String>,
+        exclude: List<String> = emptyList(),
+        limit: Int
+    ): List<String>?
+
+    /**
+     * @return how many recipes [findRecipes] would find without a limit
+     */
+    fun countRecipes(include: List<String>, exclude: List<String> = emptyList()): Long?
+
+    /**
+     * Drops every recipe and deletes the saved index
+     */
+    fun clear()
+}
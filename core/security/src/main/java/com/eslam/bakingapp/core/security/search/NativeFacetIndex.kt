@@ -0,0 +1,157 @@
+package com.eslam.bakingapp.core.security.search
+
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Native [FacetIndex]: a bitset per facet value, evaluated and counted a
+ * block of rows at a time with SIMD popcounts.
+ *
+ * A filter crosses JNI as one accepted-value mask per facet. Category and
+ * difficulty values are numbered natively in order of first use; their
+ * names are fetched per evaluation to build the masks and label the counts.
+ */
+@Singleton
+class NativeFacetIndex @Inject constructor() : FacetIndex {
+
+    companion object {
+        private const val TAG = "NativeFacetIndex"
+
+        // Facet order and value limit of search/facet-index.h
+        private const val CATEGORY = 0
+        private const val DIFFICULTY = 1
+        private const val FAVORITE = 2
+        private const val PREP_TIME = 3
+        private const val COOK_TIME = 4
+        private const val FACET_COUNT = 5
+        private const val MAX_FACET_VALUES = 64
+        private const val ANY = -1L
+    }
+
+    /**
+     * Snapshot of the index, see [stats]
+     */
+    data class Stats(
+        val recipes: Long,
+        val values: Long,
+        val bitsetBytes: Long
+    )
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        nativeCreate().also {
+            if (it == 0L) Log.e(TAG, "Failed to create the facet index")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeCreate(): Long
+
+    private external fun nativeSetRecipe(
+        handle: Long,
+        id: String,
+        category: String,
+        difficulty: String,
+        favorite: Boolean,
+        prepMinutes: Int,
+        cookMinutes: Int
+    ): Boolean
+
+    private external fun nativeSetFavorite(handle: Long, id: String, favorite: Boolean): Boolean
+
+    private external fun nativeRemoveRecipe(handle: Long, id: String): Boolean
+
+    private external fun nativeValues(handle: Long, facet: Int): Array<String>?
+
+    private external fun nativeEvaluate(
+        handle: Long,
+        masks: LongArray,
+        counts: LongArray,
+        limit: Int
+    ): Array<String>?
+
+    private external fun nativeClear(handle: Long)
+
+    private external fun nativeStats(handle: Long): LongArray?
+
+    // ==================== Public API ====================
+
+    override fun isAvailable(): Boolean = handle != 0L
+
+    override fun update(entries: Collection<FacetIndex.Entry>, removedIds: Collection<String>) {
+        if (!isAvailable()) return
+        for (id in removedIds) nativeRemoveRecipe(handle, id)
+        for (entry in entries) {
+            val set = nativeSetRecipe(
+                handle,
+                entry.id,
+                entry.category,
+                entry.difficulty,
+                entry.isFavorite,
+                entry.prepTimeMinutes,
+                entry.cookTimeMinutes
+            )
+            if (!set) Log.w(TAG, "Recipe ${entry.id} was not indexed")
+        }
+    }
+
+    override fun setFavorite(id: String, favorite: Boolean) {
+        if (!isAvailable()) return
+        nativeSetFavorite(handle, id, favorite)
+    }
+
+    override fun evaluate(filter: FacetIndex.Filter, limit: Int): FacetIndex.Evaluation? {
+        if (!isAvailable()) return null
+        val categories = nativeValues(handle, CATEGORY) ?: return null
+        val difficulties = nativeValues(handle, DIFFICULTY) ?: return null
+
+        val masks = longArrayOf(
+            mask(filter.categories.map { categories.indexOf(it) }),
+            mask(filter.difficulties.map { difficulties.indexOf(it) }),
+            filter.favorite?.let { 1L shl (if (it) 1 else 0) } ?: ANY,
+            mask(filter.prepTimeBuckets),
+            mask(filter.cookTimeBuckets)
+        )
+        val counts = LongArray(1 + FACET_COUNT * MAX_FACET_VALUES)
+        val ids = nativeEvaluate(handle, masks, counts, limit) ?: return null
+
+        fun count(facet: Int, value: Int) = counts[1 + facet * MAX_FACET_VALUES + value].toInt()
+        return FacetIndex.Evaluation(
+            ids = ids.asList(),
+            total = counts[0],
+            counts = FacetIndex.Counts(
+                categories = categories.withIndex()
+                    .associate { (i, name) -> name to count(CATEGORY, i) },
+                difficulties = difficulties.withIndex()
+                    .associate { (i, name) -> name to count(DIFFICULTY, i) },
+                favorites = mapOf(false to count(FAVORITE, 0), true to count(FAVORITE, 1)),
+                prepTimeBuckets = List(FacetIndex.TIME_BUCKETS) { count(PREP_TIME, it) },
+                cookTimeBuckets = List(FacetIndex.TIME_BUCKETS) { count(COOK_TIME, it) }
+            )
+        )
+    }
+
+    override fun clear() {
+        if (!isAvailable()) return
+        nativeClear(handle)
+    }
+
+    fun stats(): Stats? {
+        if (!isAvailable()) return null
+        val values = nativeStats(handle) ?: return null
+        return Stats(values[0], values[1], values[2])
+    }
+
+    /**
+     * Accepts every value for an empty selection; values the index has
+     * never seen (negative here) accept nothing
+     */
+    private fun mask(values: Collection<Int>): Long {
+        if (values.isEmpty()) return ANY
+        return values.filter { it in 0 until MAX_FACET_VALUES }
+            .fold(0L) { mask, value -> mask or (1L shl value) }
+    }
+}
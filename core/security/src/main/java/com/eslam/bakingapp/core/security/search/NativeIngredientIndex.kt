@@ -0,0 +1,124 @@
+package com.eslam.bakingapp.core.security.search
+
+import android.content.Context
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import dagger.hilt.android.qualifiers.ApplicationContext
+import java.io.File
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Native [IngredientIndex]: one roaring bitmap of recipes per ingredient,
+ * intersected and subtracted with SIMD word kernels.
+ *
+ * Ingredient names and query ingredients are passed joined by newlines.
+ * The snapshot lives in filesDir, next to the database it mirrors, and
+ * is rewritten atomically after every [update].
+ */
+@Singleton
+class NativeIngredientIndex @Inject constructor(
+    @ApplicationContext private val context: Context
+) : IngredientIndex {
+
+    companion object {
+        private const val TAG = "NativeIngredientIndex"
+        private const val INDEX_FILE = "ingredients.index"
+    }
+
+    /**
+     * Snapshot of the index, see [stats]
+     */
+    data class Stats(
+        val recipes: Long,
+        val ingredients: Long,
+        val bitmapBytes: Long
+    )
+
+    private val file: File by lazy { File(context.filesDir, INDEX_FILE) }
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        nativeCreate().also {
+            if (it == 0L) Log.e(TAG, "Failed to create the ingredient index")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeCreate(): Long
+
+    private external fun nativeLoad(handle: Long, path: String): Boolean
+
+    private external fun nativeSave(handle: Long, path: String): Boolean
+
+    private external fun nativeSetRecipe(handle: Long, id: String, ingredients: String): Boolean
+
+    private external fun nativeRemoveRecipe(handle: Long, id: String): Boolean
+
+    private external fun nativeQuery(
+        handle: Long,
+        include: String,
+        exclude: String,
+        limit: Int
+    ): Array<String>?
+
+    private external fun nativeCount(handle: Long, include: String, exclude: String): Long
+
+    private external fun nativeClear(handle: Long)
+
+    private external fun nativeStats(handle: Long): LongArray?
+
+    // ==================== Public API ====================
+
+    override fun isAvailable(): Boolean = handle != 0L
+
+    override fun load(): Boolean {
+        if (!isAvailable() || !file.exists()) return false
+        return nativeLoad(handle, file.absolutePath).also {
+            if (!it) Log.w(TAG, "Discarding unreadable ingredient index")
+        }
+    }
+
+    override fun update(recipes: Map<String, List<String>>, removedIds: Collection<String>) {
+        if (!isAvailable()) return
+        for (id in removedIds) nativeRemoveRecipe(handle, id)
+        for ((id, ingredients) in recipes) {
+            if (!nativeSetRecipe(handle, id, ingredients.joinToString("\n"))) {
+                Log.w(TAG, "Recipe $id was not indexed")
+            }
+        }
+        if (!nativeSave(handle, file.absolutePath)) Log.w(TAG, "Failed to save ${file.path}")
+    }
+
+    override fun findRecipes(
+        include: List<String>,
+        exclude: List<String>,
+        limit: Int
+    ): List<String>? {
+        if (!isAvailable()) return null
+        return nativeQuery(
+            handle,
+            include.joinToString("\n"),
+            exclude.joinToString("\n"),
+            limit
+        )?.asList()
+    }
+
+    override fun countRecipes(include: List<String>, exclude: List<String>): Long? {
+        if (!isAvailable()) return null
+        return nativeCount(handle, include.joinToString("\n"), exclude.joinToString("\n"))
+    }
+
+    override fun clear() {
+        if (!isAvailable()) return
+        nativeClear(handle)
+        file.delete()
+    }
+
+    fun stats(): Stats? {
+        if (!isAvailable()) return null
+        val values = nativeStats(handle) ?: return null
+        return Stats(values[0], values[1], values[2])
+    }
+}
@@ -0,0 +1,104 @@
+package com.eslam.bakingapp.core.security.search
+
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Native [RecipeSearchIndex]: an in-memory inverted index with a
+ * cooking-aware tokenizer and BM25 ranking.
+ *
+ * Ingredient names and step texts are passed joined by newlines, one
+ * JNI call per recipe. Replaced and removed recipes are only marked dead
+ * natively; [clear] and a rebuild reclaim their postings.
+ */
+@Singleton
+class NativeRecipeSearchIndex @Inject constructor() : RecipeSearchIndex {
+
+    companion object {
+        private const val TAG = "NativeRecipeSearch"
+    }
+
+    /**
+     * Snapshot of the index, see [stats]
+     */
+    data class Stats(
+        val documents: Long,
+        val dead: Long,
+        val terms: Long,
+        val postingBytes: Long
+    )
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        nativeCreate().also {
+            if (it == 0L) Log.e(TAG, "Failed to create the search index")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeCreate(): Long
+
+    private external fun nativeAdd(
+        handle: Long,
+        id: String,
+        name: String,
+        description: String,
+        ingredients: String,
+        steps: String
+    ): Boolean
+
+    private external fun nativeRemove(handle: Long, id: String): Boolean
+
+    private external fun nativeSearch(
+        handle: Long,
+        query: String,
+        limit: Int,
+        prefixLast: Boolean
+    ): Array<String>?
+
+    private external fun nativeClear(handle: Long)
+
+    private external fun nativeStats(handle: Long): LongArray?
+
+    // ==================== Public API ====================
+
+    override fun isAvailable(): Boolean = handle != 0L
+
+    override fun add(documents: Collection<RecipeSearchIndex.Document>) {
+        if (!isAvailable()) return
+        for (document in documents) {
+            val added = nativeAdd(
+                handle,
+                document.id,
+                document.name,
+                document.description,
+                document.ingredients.joinToString("\n"),
+                document.steps.joinToString("\n")
+            )
+            if (!added) Log.w(TAG, "Recipe ${document.id} was not indexed")
+        }
+    }
+
+    override fun remove(ids: Collection<String>) {
+        if (!isAvailable()) return
+        for (id in ids) nativeRemove(handle, id)
+    }
+
+    override fun search(query: String, limit: Int, prefixLast: Boolean): List<String>? {
+        if (!isAvailable()) return null
+        return nativeSearch(handle, query, limit, prefixLast)?.asList()
+    }
+
+    override fun clear() {
+        if (isAvailable()) nativeClear(handle)
+    }
+
+    fun stats(): Stats? {
+        if (!isAvailable()) return null
+        val values = nativeStats(handle) ?: return null
+        return Stats(values[0], values[1], values[2], values[3])
+    }
+}
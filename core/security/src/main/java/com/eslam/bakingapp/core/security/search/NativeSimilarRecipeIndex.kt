@@ -0,0 +1,101 @@
+package com.eslam.bakingapp.core.security.search
+
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Native [SimilarRecipeIndex]: 128-lane MinHash signatures computed with
+ * SIMD, bucketed by LSH bands so a lookup only scores recipes sharing a
+ * band with the query.
+ *
+ * Ingredient names are passed joined by newlines. Lookups return the ids
+ * and fill a float array with their similarities, one call per lookup.
+ */
+@Singleton
+class NativeSimilarRecipeIndex @Inject constructor() : SimilarRecipeIndex {
+
+    companion object {
+        private const val TAG = "NativeSimilarIndex"
+
+        // SimilarIndex::MAX_RESULTS in search/similar-index.h
+        private const val MAX_RESULTS = 64
+    }
+
+    /**
+     * Snapshot of the index, see [stats]
+     */
+    data class Stats(
+        val recipes: Long,
+        val buckets: Long,
+        val entries: Long,
+        val staleEntries: Long,
+        val bytes: Long
+    )
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        nativeCreate().also {
+            if (it == 0L) Log.e(TAG, "Failed to create the similar-recipe index")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeCreate(): Long
+
+    private external fun nativeSetRecipe(handle: Long, id: String, ingredients: String): Boolean
+
+    private external fun nativeRemoveRecipe(handle: Long, id: String): Boolean
+
+    private external fun nativeSimilar(
+        handle: Long,
+        id: String,
+        minSimilarity: Float,
+        similarities: FloatArray,
+        limit: Int
+    ): Array<String>?
+
+    private external fun nativeClear(handle: Long)
+
+    private external fun nativeStats(handle: Long): LongArray?
+
+    // ==================== Public API ====================
+
+    override fun isAvailable(): Boolean = handle != 0L
+
+    override fun update(recipes: Map<String, List<String>>, removedIds: Collection<String>) {
+        if (!isAvailable()) return
+        for (id in removedIds) nativeRemoveRecipe(handle, id)
+        for ((id, ingredients) in recipes) {
+            if (!nativeSetRecipe(handle, id, ingredients.joinToString("\n"))) {
+                Log.w(TAG, "Recipe $id was not indexed")
+            }
+        }
+    }
+
+    override fun findSimilar(
+        id: String,
+        limit: Int,
+        minSimilarity: Float
+    ): List<SimilarRecipeIndex.Match>? {
+        if (!isAvailable()) return null
+        if (limit <= 0) return emptyList()
+        val similarities = FloatArray(limit.coerceAtMost(MAX_RESULTS))
+        val ids = nativeSimilar(handle, id, minSimilarity, similarities, similarities.size)
+            ?: return null
+        return ids.mapIndexed { i, other -> SimilarRecipeIndex.Match(other, similarities[i]) }
+    }
+
+    override fun clear() {
+        if (!isAvailable()) return
+        nativeClear(handle)
+    }
+
+    fun stats(): Stats? {
+        if (!isAvailable()) return null
+        val values = nativeStats(handle) ?: return null
+        return Stats(values[0], values[1], values[2], values[3], values[4])
+    }
+}
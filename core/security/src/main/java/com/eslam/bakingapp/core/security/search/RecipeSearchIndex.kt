@@ -0,0 +1,46 @@
+package com.eslam.bakingapp.core.security.search
+
+/**
+ * Ranked full-text search over recipe names, descriptions, ingredient
+ * names and step text.
+ *
+ * Words are case folded, stripped of accents and stemmed for cooking text
+ * ("Tomatoes" finds "tomato"), and matches are ranked by BM25 with a name
+ * hit counting most. The index lives in memory: build it from the
+ * database once, then keep it in step with every write.
+ */
+interface RecipeSearchIndex {
+
+    /**
+     * What gets indexed of one recipe
+     */
+    class Document(
+        val id: String,
+        val name: String,
+        val description: String,
+        val ingredients: List<String>,
+        val steps: List<String>
+    )
+
+    fun isAvailable(): Boolean
+
+    /**
+     * Indexes [documents], replacing earlier versions with the same ids
+     */
+    fun add(documents: Collection<Document>)
+
+    fun remove(ids: Collection<String>)
+
+    /**
+     * @param prefixLast also match words starting with the last one while
+     *   it is still being typed
+     * @return up to [limit] recipe ids, best match first, or null if
+     *   search is unavailable
+     */
+    fun search(query: String, limit: Int, prefixLast: Boolean = true): List<String>?
+
+    /**
+     * Drops every document, e.g. before a full rebuild
+     */
+    fun clear()
+}
@@ -0,0 +1,45 @@
+package com.eslam.bakingapp.core.security.search
+
+/**
+ * "Similar recipes": recipes ranked by how much of their ingredient list
+ * they share with another.
+ *
+ * Similarity is the Jaccard similarity of the two ingredient sets (shared
+ * ingredients over all distinct ones), estimated from MinHash signatures
+ * so a lookup never compares a recipe against every other. Ingredient
+ * names are folded and stemmed first, as [IngredientIndex] does. The index
+ * lives in memory: build it from the database once, then keep it in step
+ * with every write.
+ */
+interface SimilarRecipeIndex {
+
+    /**
+     * @param similarity estimated Jaccard similarity, 0 to 1
+     */
+    data class Match(
+        val id: String,
+        val similarity: Float
+    )
+
+    fun isAvailable(): Boolean
+
+    /**
+     * Indexes each recipe's ingredient names, replacing what it had, and
+     * drops [removedIds]
+     *
+     * @param recipes ingredient names by recipe id
+     */
+    fun update(recipes: Map<String, List<String>>, removedIds: Collection<String> = emptyList())
+
+    /**
+     * @return up to [limit] recipes at least [minSimilarity] similar to the
+     *   recipe [id], best first and without it; null if the index is
+     *   unavailable
+     */
+    fun findSimilar(id: String, limit: Int, minSimilarity: Float = 0f): List<Match>?
+
+    /**
+     * Drops every recipe, e.g. before a full rebuild
+     */
+    fun clear()
+}
@@ -0,0 +1,26 @@
+package com.eslam.bakingapp.core.security.sort
+
+/**
+ * Orders lists by a Long key, such as a created-at time.
+ *
+ * Both calls are stable: items with equal keys keep their order, as with
+ * [sortedBy] and [sortedByDescending].
+ */
+interface KeySorter {
+
+    /**
+     * [items] ordered by [key], newest first when [descending]
+     */
+    fun <T> sortedBy(items: List<T>, descending: Boolean = false, key: (T) -> Long): List<T>
+
+    /**
+     * The first [count] items [sortedBy] would return, without ordering
+     * the rest
+     */
+    fun <T> topBy(
+        items: List<T>,
+        count: Int,
+        descending: Boolean = false,
+        key: (T) -> Long
+    ): List<T>
+}
@@ -0,0 +1,95 @@
+package com.eslam.bakingapp.core.security.sort
+
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [KeySorter] backed by the native packed-key sort.
+ *
+ * Each item's key, offset from the smallest (or largest) one, is packed
+ * above its index into a long, so a single long[] is sorted in one JNI call
+ * and the indices then put the items in order. The native sort checks
+ * for input that is already in order, or in reverse, in one pass, merges
+ * the few values out of place in a mostly sorted list, and radix sorts
+ * the rest; [topBy] keeps a heap of the first count instead.
+ *
+ * Lists shorter than [NATIVE_MIN_ITEMS], keys whose range leaves no room
+ * for the index, and a missing native library take the Kotlin sorts.
+ */
+@Singleton
+class NativeKeySorter @Inject constructor() : KeySorter {
+
+    companion object {
+        /** Below it, a JNI call costs more than the sort it saves */
+        const val NATIVE_MIN_ITEMS = 64
+    }
+
+    private val available: Boolean by lazy { NativeLibrary.ensureLoaded() }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeSort(values: LongArray): Int
+
+    private external fun nativeSmallest(values: LongArray, k: Int): LongArray?
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if long enough lists are sorted natively
+     */
+    fun isAvailable(): Boolean = available
+
+    override fun <T> sortedBy(items: List<T>, descending: Boolean, key: (T) -> Long): List<T> {
+        val packed = pack(items, descending, key)
+        if (packed == null || nativeSort(packed) < 0) {
+            return if (descending) items.sortedByDescending(key) else items.sortedBy(key)
+        }
+        return unpack(items, packed)
+    }
+
+    override fun <T> topBy(
+        items: List<T>,
+        count: Int,
+        descending: Boolean,
+        key: (T) -> Long
+    ): List<T> {
+        if (count <= 0) return emptyList()
+        val packed = pack(items, descending, key)
+        val smallest = packed?.let { nativeSmallest(it, count) }
+            ?: return (if (descending) items.sortedByDescending(key) else items.sortedBy(key)).take(count)
+        return unpack(items, smallest)
+    }
+
+    /**
+     * (key offset shl index bits) or index per item, so that ascending
+     * values are the requested order; null if the list should not be
+     * sorted natively
+     */
+    private fun <T> pack(items: List<T>, descending: Boolean, key: (T) -> Long): LongArray? {
+        if (!available || items.size < NATIVE_MIN_ITEMS) return null
+        val keys = LongArray(items.size) { key(items[it]) }
+        var min = keys[0]
+        var max = keys[0]
+        for (k in keys) {
+            if (k < min) min = k
+            if (k > max) max = k
+        }
+        val range = max - min
+        if (range < 0) return null  // overflowed
+        val indexBits = 64 - (items.size - 1).toLong().countLeadingZeroBits()
+        val keyBits = 64 - range.countLeadingZeroBits()
+        if (keyBits + indexBits > 63) return null
+
+        return LongArray(items.size) { i ->
+            val offset = if (descending) max - keys[i] else keys[i] - min
+            (offset shl indexBits) or i.toLong()
+        }
+    }
+
+    private fun <T> unpack(items: List<T>, packed: LongArray): List<T> {
+        val indexBits = 64 - (items.size - 1).toLong().countLeadingZeroBits()
+        val mask = (1L shl indexBits) - 1
+        return List(packed.size) { items[(packed[it] and mask).toInt()] }
+    }
+}
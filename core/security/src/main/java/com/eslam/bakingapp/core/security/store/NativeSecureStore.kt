@@ -0,0 +1,188 @@
+package com.eslam.bakingapp.core.security.store
+
+import android.content.Context
+import android.util.Base64
+import android.util.Log
+import com.eslam.bakingapp.core.security.EncryptedPreferencesManager
+import com.eslam.bakingapp.core.security.NativeLibrary
+import dagger.hilt.android.qualifiers.ApplicationContext
+import java.io.File
+import java.security.SecureRandom
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [SecureStore] backed by the native transactional log.
+ *
+ * A transaction is buffered here and committed in one JNI call: its values
+ * are sealed together with ChaCha20-Poly1305 and appended as one record,
+ * fsync'd before [edit] returns, so [edit] blocks the calling thread; the
+ * first call also unwraps the log's key and replays the log. Transactions committed at the same time
+ * from several threads share a single write and fsync. A record torn by a
+ * crash is dropped whole on the next open.
+ *
+ * The log's 32-byte key is drawn from the injected [SecureRandom] and kept
+ * in [EncryptedPreferencesManager], wrapped by the Android Keystore; losing
+ * it loses the log, as losing the Keystore key loses the preferences.
+ * Without the native library, transactions go to those preferences
+ * instead, as one apply() each.
+ */
+@Singleton
+class NativeSecureStore @Inject constructor(
+    @ApplicationContext private val context: Context,
+    private val preferences: EncryptedPreferencesManager,
+    private val secureRandom: SecureRandom
+) : SecureStore {
+
+    companion object {
+        private const val TAG = "NativeSecureStore"
+        private const val STORE_FILE = "secure.store"
+        private const val KEY_STORE_KEY = "secure_store_key"
+        private const val STORE_KEY_BYTES = 32
+    }
+
+    /**
+     * Snapshot of the log, see [stats]
+     */
+    data class Stats(
+        val keys: Long,
+        val transactions: Long,
+        val flushes: Long,
+        val usedBytes: Long,
+        val liveBytes: Long,
+        val droppedBytes: Long
+    )
+
+    /**
+     * Values as given: String, Long, or null for a removal
+     */
+    private class BufferedTransaction : SecureStore.Transaction {
+        val keys = ArrayList<String>()
+        val values = ArrayList<Any?>()
+
+        override fun putString(key: String, value: String) {
+            keys += key
+            values += value
+        }
+
+        override fun putLong(key: String, value: Long) {
+            keys += key
+            values += value
+        }
+
+        override fun remove(key: String) {
+            keys += key
+            values += null
+        }
+    }
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        val key = storeKey() ?: return@lazy 0L
+        val path = File(context.filesDir, STORE_FILE).absolutePath
+        nativeOpen(path, key).also {
+            key.fill(0)
+            if (it == 0L) Log.e(TAG, "Failed to open secure store $path")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeOpen(path: String, key: ByteArray): Long
+
+    private external fun nativeCommit(handle: Long, keys: Array<String>, values: Array<ByteArray?>): Boolean
+
+    private external fun nativeGet(handle: Long, key: String): ByteArray?
+
+    private external fun nativeStats(handle: Long): LongArray
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library and the log file are usable
+     */
+    fun isAvailable(): Boolean = handle != 0L
+
+    override fun getString(key: String): String? {
+        if (!isAvailable()) return preferences.encryptedPrefs.all[key]?.toString()
+        return nativeGet(handle, key)?.let { String(it, Charsets.UTF_8) }
+    }
+
+    override fun getLong(key: String, defaultValue: Long): Long =
+        getString(key)?.toLongOrNull() ?: defaultValue
+
+    override fun edit(block: SecureStore.Transaction.() -> Unit): Boolean {
+        val transaction = BufferedTransaction().apply(block)
+        if (transaction.keys.isEmpty()) return true
+        if (!isAvailable()) {
+            val editor = preferences.encryptedPrefs.edit()
+            transaction.keys.forEachIndexed { i, key ->
+                when (val value = transaction.values[i]) {
+                    null -> editor.remove(key)
+                    is Long -> editor.putLong(key, value)
+                    else -> editor.putString(key, value.toString())
+                }
+            }
+            editor.apply()
+            return true
+        }
+
+        val values = Array(transaction.values.size) { i ->
+            transaction.values[i]?.toString()?.toByteArray(Charsets.UTF_8)
+        }
+        val stored = nativeCommit(handle, transaction.keys.toTypedArray(), values)
+        values.forEach { it?.fill(0) }
+        if (!stored) Log.w(TAG, "Failed to commit ${transaction.keys.size} secure values")
+        return stored
+    }
+
+    override fun migrateFromPreferences(keys: List<String>) {
+        if (!isAvailable()) return
+        val stored = preferences.encryptedPrefs.all
+        val present = keys.filter { stored[it] != null }
+        if (present.isEmpty()) return
+
+        val moved = edit {
+            for (key in present) putString(key, stored.getValue(key).toString())
+        }
+        if (moved) {
+            val editor = preferences.encryptedPrefs.edit()
+            present.forEach { editor.remove(it) }
+            editor.apply()
+        }
+    }
+
+    fun stats(): Stats {
+        if (!isAvailable()) return Stats(0, 0, 0, 0, 0, 0)
+        val values = nativeStats(handle)
+        return Stats(
+            keys = values[0],
+            transactions = values[1],
+            flushes = values[2],
+            usedBytes = values[3],
+            liveBytes = values[4],
+            droppedBytes = values[5]
+        )
+    }
+
+    /**
+     * The log's key, created on first use. Written with commit() rather
+     * than apply(): nothing may be sealed under a key that is not stored.
+     */
+    private fun storeKey(): ByteArray? {
+        preferences.getString(KEY_STORE_KEY)?.let { encoded ->
+            val key = Base64.decode(encoded, Base64.NO_WRAP)
+            if (key.size == STORE_KEY_BYTES) return key
+        }
+        val key = ByteArray(STORE_KEY_BYTES).also { secureRandom.nextBytes(it) }
+        val saved = preferences.encryptedPrefs.edit()
+            .putString(KEY_STORE_KEY, Base64.encodeToString(key, Base64.NO_WRAP))
+            .commit()
+        if (!saved) {
+            key.fill(0)
+            Log.e(TAG, "Failed to save the secure store key")
+            return null
+        }
+        return key
+    }
+}
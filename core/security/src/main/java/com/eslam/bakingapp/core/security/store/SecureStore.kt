@@ -0,0 +1,40 @@
+package com.eslam.bakingapp.core.security.store
+
+/**
+ * Encrypted key-value storage for credentials, written a transaction at a
+ * time.
+ *
+ * Everything put or removed in one [edit] block is stored together or not
+ * at all, and costs one write to storage however many values it holds.
+ */
+interface SecureStore {
+
+    /**
+     * The operations of one [edit], applied in order
+     */
+    interface Transaction {
+        fun putString(key: String, value: String)
+        fun putLong(key: String, value: Long)
+        fun remove(key: String)
+    }
+
+    fun getString(key: String): String?
+
+    fun getLong(key: String, defaultValue: Long = 0L): Long
+
+    /**
+     * Stores [block]'s operations as one transaction, returning once they
+     * are written. Blocks on disk I/O (and on the first call, on opening
+     * the store), so call it off the main thread.
+     *
+     * @return false if nothing was stored
+     */
+    fun edit(block: Transaction.() -> Unit): Boolean
+
+    /**
+     * Moves [keys] stored in the encrypted preferences before this store
+     * existed into it, in one transaction. A no-op once they are moved, or
+     * for a store kept in those preferences.
+     */
+    fun migrateFromPreferences(keys: List<String>)
+}
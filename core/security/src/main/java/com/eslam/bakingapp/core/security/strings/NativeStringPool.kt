@@ -0,0 +1,81 @@
+package com.eslam.bakingapp.core.security.strings
+
+import android.util.Log
+import com.eslam.bakingapp.core.network.interning.StringInterner
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Native interning pool for repeated recipe fields.
+ *
+ * JSON string tokens are decoded and looked up natively; each distinct
+ * value gets a small ID and one Java String, created on first sight and
+ * kept as a global reference, so every later occurrence returns that
+ * same instance. A 100k-recipe payload then holds a handful of category,
+ * difficulty and unit Strings instead of about a million.
+ *
+ * At most 4096 distinct values are shared, so messy or hostile server
+ * text cannot fill the VM's global reference table; later new values,
+ * like those dropped by a background memory trim, decode as usual.
+ *
+ * Without the native library [isAvailable] is false and Moshi decodes
+ * these fields as usual.
+ */
+@Singleton
+class NativeStringPool @Inject constructor() : StringInterner {
+
+    companion object {
+        private const val TAG = "NativeStringPool"
+    }
+
+    /**
+     * Snapshot of the pool, see [stats]
+     */
+    data class Stats(
+        val strings: Long,
+        val lookups: Long,
+        val textBytes: Long,
+        val nativeBytes: Long
+    )
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        nativeCreate().also {
+            if (it == 0L) Log.e(TAG, "Failed to create the string pool")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeCreate(): Long
+
+    private external fun nativeInternJson(handle: Long, token: ByteArray, length: Int): String?
+
+    private external fun nativeClear(handle: Long)
+
+    private external fun nativeStats(handle: Long): LongArray?
+
+    // ==================== Public API ====================
+
+    override fun isAvailable(): Boolean = handle != 0L
+
+    override fun internJsonString(token: ByteArray, length: Int): String? {
+        if (!isAvailable()) return null
+        return nativeInternJson(handle, token, length)
+    }
+
+    /**
+     * Drops every shared String; values already handed out stay valid,
+     * later ones get new instances
+     */
+    fun clear() {
+        if (isAvailable()) nativeClear(handle)
+    }
+
+    fun stats(): Stats? {
+        if (!isAvailable()) return null
+        val values = nativeStats(handle) ?: return null
+        return Stats(values[0], values[1], values[2], values[3])
+    }
+}
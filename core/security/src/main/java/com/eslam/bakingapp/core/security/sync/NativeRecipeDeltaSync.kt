@@ -0,0 +1,111 @@
+package com.eslam.bakingapp.core.security.sync
+
+import android.content.Context
+import android.util.Log
+import com.eslam.bakingapp.core.security.NativeLibrary
+import com.eslam.bakingapp.core.security.jobs.NativeJobs
+import dagger.hilt.android.qualifiers.ApplicationContext
+import java.io.File
+import java.nio.ByteBuffer
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [RecipeDeltaSync] backed by a native mmap'd id -> content-hash table.
+ *
+ * The body is split into recipes and hashed in place (XXH64 over each
+ * recipe's raw bytes), without decoding it; a direct [ByteBuffer] is read
+ * as is, a heap one is copied into a direct buffer first. The diff runs on
+ * the native thread pool ([NativeJobs]), so no thread is held while it
+ * works. The table lives in filesDir next to the database it mirrors.
+ *
+ * Without the native library [diff] returns null and callers write every
+ * recipe, as before.
+ */
+@Singleton
+class NativeRecipeDeltaSync @Inject constructor(
+    @ApplicationContext private val context: Context
+) : RecipeDeltaSync {
+
+    companion object {
+        private const val TAG = "NativeRecipeDeltaSync"
+        private const val TABLE_FILE = "recipes.delta"
+
+        // DeltaKind in sync/delta-table.h
+        private const val INSERTED = 1
+        private const val CHANGED = 2
+    }
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        val path = File(context.filesDir, TABLE_FILE).absolutePath
+        nativeOpen(path).also {
+            if (it == 0L) Log.e(TAG, "Failed to open delta table $path")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeOpen(path: String): Long
+
+    private external fun nativeSubmitDiff(
+        handle: Long,
+        body: ByteBuffer,
+        length: Int,
+        jobId: Long
+    ): Boolean
+
+    private external fun nativeCommit(handle: Long): Boolean
+
+    private external fun nativeAbort(handle: Long)
+
+    private external fun nativeReset(handle: Long)
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library and the table file are usable
+     */
+    fun isAvailable(): Boolean = handle != 0L
+
+    override suspend fun diff(body: ByteBuffer): RecipeDeltaSync.Delta? {
+        if (!isAvailable()) return null
+        val direct = if (body.isDirect) {
+            body.slice()
+        } else {
+            ByteBuffer.allocateDirect(body.remaining()).put(body.duplicate()).apply { flip() }
+        }
+        val packed = NativeJobs.await<ByteArray> { jobId ->
+            nativeSubmitDiff(handle, direct, direct.remaining(), jobId)
+        } ?: return null
+
+        val inserted = ArrayList<String>()
+        val changed = ArrayList<String>()
+        val deleted = ArrayList<String>()
+        var position = 0
+        while (position + 2 <= packed.size) {
+            val kind = packed[position].toInt()
+            val idLength = packed[position + 1].toInt() and 0xFF
+            val id = String(packed, position + 2, idLength, Charsets.UTF_8)
+            when (kind) {
+                INSERTED -> inserted += id
+                CHANGED -> changed += id
+                else -> deleted += id
+            }
+            position += 2 + idLength
+        }
+        return RecipeDeltaSync.Delta(inserted, changed, deleted)
+    }
+
+    override fun commit() {
+        if (isAvailable() && !nativeCommit(handle)) Log.w(TAG, "Nothing to commit")
+    }
+
+    override fun abort() {
+        if (isAvailable()) nativeAbort(handle)
+    }
+
+    override fun reset() {
+        if (isAvailable()) nativeReset(handle)
+    }
+}
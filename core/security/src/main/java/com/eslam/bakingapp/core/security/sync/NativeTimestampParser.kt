@@ -0,0 +1,140 @@
+package com.eslam.bakingapp.core.security.sync
+
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [TimestampParser] backed by the native batch parser.
+ *
+ * A batch is one JNI call: values go down '\n'-joined, or a JSON body is
+ * read in place, and one LongArray comes back. The fixed
+ * "YYYY-MM-DDThh:mm" prefix of each timestamp is validated in a single
+ * NEON/SSE2 compare. Without the native library the same grammar is
+ * parsed in Kotlin, one value at a time; [parseRecords] then returns null.
+ */
+@Singleton
+class NativeTimestampParser @Inject constructor() : TimestampParser {
+
+    companion object {
+        private const val MILLIS_PER_DAY = 86_400_000L
+        private val DAYS_IN_MONTH = intArrayOf(31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31)
+
+        /**
+         * The Kotlin fallback, with the native grammar (sync/timestamps.h)
+         */
+        private fun parseOne(text: String): Long {
+            val length = text.length
+            if (length != 10 && length < 19) return TimestampParser.INVALID
+            fun digits(at: Int, count: Int): Int {
+                var value = 0
+                for (i in at until at + count) {
+                    val digit = text[i] - '0'
+                    if (digit !in 0..9) return -1
+                    value = value * 10 + digit
+                }
+                return value
+            }
+
+            val year = digits(0, 4)
+            val month = digits(5, 2)
+            val day = digits(8, 2)
+            if (year < 0 || month !in 1..12 || day < 1 || text[4] != '-' || text[7] != '-') {
+                return TimestampParser.INVALID
+            }
+            val leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)
+            if (day > if (month == 2 && leap) 29 else DAYS_IN_MONTH[month - 1]) {
+                return TimestampParser.INVALID
+            }
+            val midnight = daysFromCivil(year.toLong(), month, day) * MILLIS_PER_DAY
+            if (length == 10) return midnight
+
+            val hour = digits(11, 2)
+            val minute = digits(14, 2)
+            val second = digits(17, 2)
+            if (text[10] != 'T' && text[10] != 't' && text[10] != ' ') return TimestampParser.INVALID
+            if (text[13] != ':' || text[16] != ':') return TimestampParser.INVALID
+            if (hour !in 0..23 || minute !in 0..59 || second !in 0..59) return TimestampParser.INVALID
+
+            var pos = 19
+            var fraction = 0L
+            if (pos < length && (text[pos] == '.' || text[pos] == ',')) {
+                pos++
+                var count = 0
+                while (pos < length && text[pos] in '0'..'9') {
+                    if (++count > 9) return TimestampParser.INVALID
+                    if (count <= 3) fraction = fraction * 10 + (text[pos] - '0')
+                    pos++
+                }
+                if (count == 0) return TimestampParser.INVALID
+                repeat(maxOf(0, 3 - count)) { fraction *= 10 }
+            }
+
+            var offsetSeconds = 0L
+            if (pos < length) {
+                val sign = text[pos]
+                if (sign == 'Z' || sign == 'z') {
+                    if (pos + 1 != length) return TimestampParser.INVALID
+                } else {
+                    if (sign != '+' && sign != '-') return TimestampParser.INVALID
+                    pos++
+                    if (length - pos < 2) return TimestampParser.INVALID
+                    val hours = digits(pos, 2)
+                    pos += 2
+                    var minutes = 0
+                    if (pos < length) {
+                        if (text[pos] == ':') pos++
+                        if (length - pos != 2) return TimestampParser.INVALID
+                        minutes = digits(pos, 2)
+                    }
+                    if (hours !in 0..23 || minutes !in 0..59) return TimestampParser.INVALID
+                    offsetSeconds = hours * 3600L + minutes * 60L
+                    if (sign == '-') offsetSeconds = -offsetSeconds
+                }
+            }
+            return midnight + (hour * 3600L + minute * 60L + second - offsetSeconds) * 1000 + fraction
+        }
+
+        /**
+         * Days since 1970-01-01 (Howard Hinnant's days_from_civil)
+         */
+        private fun daysFromCivil(year: Long, month: Int, day: Int): Long {
+            val y = if (month <= 2) year - 1 else year
+            val era = (if (y >= 0) y else y - 399) / 400
+            val yearOfEra = y - era * 400
+            val dayOfYear = (153 * (if (month > 2) month - 3 else month + 9) + 2) / 5 + day - 1
+            val dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear
+            return era * 146097 + dayOfEra - 719468
+        }
+    }
+
+    private val available: Boolean by lazy { NativeLibrary.ensureLoaded() }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeParseLines(text: String, count: Int): LongArray?
+
+    private external fun nativeParseRecords(body: ByteArray, arrayKey: String, fields: String): LongArray?
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if batches are parsed natively
+     */
+    fun isAvailable(): Boolean = available
+
+    override fun parse(values: List<String?>): LongArray {
+        if (values.isEmpty()) return LongArray(0)
+        if (available) {
+            // A value spanning lines is not a timestamp either
+            val text = values.joinToString("\n") { if (it == null || '\n' in it) "" else it }
+            nativeParseLines(text, values.size)?.let { return it }
+        }
+        return LongArray(values.size) { i -> values[i]?.let(::parseOne) ?: TimestampParser.INVALID }
+    }
+
+    override fun parseRecords(body: ByteArray, arrayKey: String, fields: List<String>): LongArray? {
+        if (!available || fields.isEmpty()) return null
+        return nativeParseRecords(body, arrayKey, fields.joinToString("\n"))
+    }
+}
@@ -0,0 +1,56 @@
+package com.eslam.bakingapp.core.security.sync
+
+import java.nio.ByteBuffer
+
+/**
+ * Content-hash delta between recipe list syncs.
+ *
+ * Remembers a hash of each recipe's raw JSON as of the last sync that was
+ * written to the database, so a refresh only has to write the recipes the
+ * server actually inserted, changed or deleted. A [diff] is tentative:
+ * [commit] it once its rows are in the database, or [abort] it if the
+ * write failed, and the next diff reports the same changes again.
+ */
+interface RecipeDeltaSync {
+
+    /**
+     * Recipe ids that differ from the last committed sync
+     */
+    class Delta(
+        val inserted: List<String>,
+        val changed: List<String>,
+        val deleted: List<String>
+    ) {
+        val isEmpty: Boolean get() = inserted.isEmpty() && changed.isEmpty() && deleted.isEmpty()
+
+        /**
+         * Ids whose rows have to be (re)written
+         */
+        val upserts: Set<String> get() = HashSet<String>(inserted.size + changed.size).apply {
+            addAll(inserted)
+            addAll(changed)
+        }
+    }
+
+    /**
+     * Diffs a RecipeListResponse body, from its position to its limit,
+     * against the last committed sync. Suspends while the diff runs;
+     * cancelling the caller stops it.
+     *
+     * @return null if the body could not be diffed; write everything then
+     */
+    suspend fun diff(body: ByteBuffer): Delta?
+
+    /**
+     * Makes the last [diff] the baseline for the next one
+     */
+    fun commit()
+
+    fun abort()
+
+    /**
+     * Forgets every recipe, e.g. after the database was cleared or written
+     * without a diff
+     */
+    fun reset()
+}
@@ -0,0 +1,31 @@
+package com.eslam.bakingapp.core.security.sync
+
+/**
+ * ISO-8601 timestamps to epoch milliseconds, a whole sync at a time.
+ *
+ * Accepts what servers send: "2024-02-29T12:34:56.789Z", with a numeric
+ * offset (+05:30, +0530, +05) instead of 'Z', up to nine fraction digits
+ * (cut to milliseconds), no offset (UTC) or a bare date (midnight UTC).
+ * Anything else parses to [INVALID].
+ */
+interface TimestampParser {
+
+    companion object {
+        /** A missing or malformed timestamp */
+        const val INVALID = Long.MIN_VALUE
+    }
+
+    /**
+     * Parses each value, [INVALID] for null ones
+     */
+    fun parse(values: List<String?>): LongArray
+
+    /**
+     * Parses [fields] of each element of the array under [arrayKey], straight
+     * from a JSON body: one value per field per element, in element order
+     *
+     * @return null if the body cannot be read this way; parse the decoded
+     *   values instead
+     */
+    fun parseRecords(body: ByteArray, arrayKey: String, fields: List<String>): LongArray?
+}
@@ -0,0 +1,85 @@
+package com.eslam.bakingapp.core.security.telemetry
+
+import android.content.Context
+import android.util.Log
+import com.eslam.bakingapp.core.network.telemetry.TelemetryEvent
+import com.eslam.bakingapp.core.network.telemetry.TelemetryRecorder
+import com.eslam.bakingapp.core.security.NativeLibrary
+import dagger.hilt.android.qualifiers.ApplicationContext
+import java.io.File
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [TelemetryRecorder] backed by native per-thread rings.
+ *
+ * Each thread records into its own lock-free ring of fixed-size binary
+ * events; a native thread appends them to cacheDir/telemetry.bin in
+ * batches once a second. The native bridges record key fetches and timer
+ * ticks themselves, so only Kotlin-side events cross JNI here. Decode a
+ * pulled file with the host tool built from tools/telemetry-decode.cpp.
+ *
+ * Without the native library nothing is recorded.
+ */
+@Singleton
+class NativeTelemetry @Inject constructor(
+    @ApplicationContext private val context: Context
+) : TelemetryRecorder {
+
+    companion object {
+        private const val TAG = "NativeTelemetry"
+        private const val TELEMETRY_FILE = "telemetry.bin"
+        private const val FLUSH_INTERVAL_MILLIS = 1000
+    }
+
+    /**
+     * Snapshot of the recorder, see [stats]
+     */
+    data class Stats(
+        val rings: Long,
+        val flushedEvents: Long,
+        val droppedEvents: Long,
+        val fileBytes: Long
+    )
+
+    private val started: Boolean by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy false
+        val path = File(context.cacheDir, TELEMETRY_FILE).absolutePath
+        nativeStart(path, FLUSH_INTERVAL_MILLIS).also {
+            if (!it) Log.e(TAG, "Failed to start telemetry at $path")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeStart(path: String, flushIntervalMillis: Int): Boolean
+
+    private external fun nativeRecord(type: Int, value: Int, extra: Long)
+
+    private external fun nativeFlush(): Boolean
+
+    private external fun nativeStats(): LongArray
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library is loaded and the file is open
+     */
+    fun isAvailable(): Boolean = started
+
+    override fun record(event: TelemetryEvent, value: Int, extra: Long) {
+        if (!isAvailable()) return
+        nativeRecord(event.id, value, extra)
+    }
+
+    /**
+     * Writes everything recorded so far, e.g. before pulling the file
+     */
+    fun flush(): Boolean = isAvailable() && nativeFlush()
+
+    fun stats(): Stats? {
+        if (!isAvailable()) return null
+        val values = nativeStats()
+        return Stats(values[0], values[1], values[2], values[3])
+    }
+}
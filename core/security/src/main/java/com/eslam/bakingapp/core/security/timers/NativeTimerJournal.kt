@@ -0,0 +1,189 @@
+package com.eslam.bakingapp.core.security.timers
+
+import android.content.Context
+import android.os.SystemClock
+import android.util.Log
+import com.eslam.bakingapp.core.common.dispatcher.IoDispatcher
+import com.eslam.bakingapp.core.security.NativeLibrary
+import dagger.hilt.android.qualifiers.ApplicationContext
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.launch
+import java.io.File
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.concurrent.atomic.AtomicBoolean
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [TimerJournal] backed by a native append-only, CRC-checked file.
+ *
+ * Records are copied into a MAP_SHARED mapping, so each one survives the
+ * process being killed as soon as the call returns; a record torn by a kill
+ * mid-write is dropped on the next open. The file lives in filesDir (the
+ * system may clear cacheDir) and is compacted on the IO dispatcher once
+ * dead records outweigh live ones.
+ *
+ * Without the native library the journal records nothing and timers are
+ * kept in memory only, as before.
+ */
+@Singleton
+class NativeTimerJournal @Inject constructor(
+    @ApplicationContext private val context: Context,
+    @IoDispatcher ioDispatcher: CoroutineDispatcher
+) : TimerJournal {
+
+    companion object {
+        private const val TAG = "NativeTimerJournal"
+        private const val JOURNAL_FILE = "timers.journal"
+        private const val SNAPSHOT_HEADER_BYTES = 16
+    }
+
+    /**
+     * Snapshot of the journal size, see [stats]
+     */
+    data class Stats(
+        val liveTimers: Long,
+        val records: Long,
+        val usedBytes: Long,
+        val liveBytes: Long,
+        val droppedBytes: Long
+    )
+
+    private val scope = CoroutineScope(SupervisorJob() + ioDispatcher)
+    private val compacting = AtomicBoolean(false)
+
+    private val handle: Long by lazy {
+        if (!NativeLibrary.ensureLoaded()) return@lazy 0L
+        val path = File(context.filesDir, JOURNAL_FILE).absolutePath
+        nativeOpen(path).also {
+            if (it == 0L) Log.e(TAG, "Failed to open timer journal $path")
+        }
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeOpen(path: String): Long
+
+    private external fun nativePut(
+        handle: Long,
+        id: String,
+        metadata: ByteArray,
+        status: Int,
+        running: Boolean,
+        remainingSeconds: Long,
+        monotonicNanos: Long,
+        wallMillis: Long
+    ): Boolean
+
+    private external fun nativeTransition(
+        handle: Long,
+        id: String,
+        status: Int,
+        running: Boolean,
+        remainingSeconds: Long,
+        monotonicNanos: Long,
+        wallMillis: Long
+    ): Boolean
+
+    private external fun nativeRemove(handle: Long, id: String): Boolean
+
+    private external fun nativeRecover(handle: Long, monotonicNanos: Long, wallMillis: Long): ByteArray?
+
+    private external fun nativeNeedsCompaction(handle: Long): Boolean
+
+    private external fun nativeCompact(handle: Long): Boolean
+
+    private external fun nativeStats(handle: Long): LongArray
+
+    // ==================== Public API ====================
+
+    /**
+     * Returns true if the native library and the journal file are usable
+     */
+    fun isAvailable(): Boolean = handle != 0L
+
+    override fun put(id: String, metadata: ByteArray, status: Int, running: Boolean, remainingSeconds: Long) {
+        if (!isAvailable()) return
+        val stored = nativePut(
+            handle, id, metadata, status, running, remainingSeconds,
+            SystemClock.elapsedRealtimeNanos(), System.currentTimeMillis()
+        )
+        if (!stored) Log.w(TAG, "Failed to journal timer $id")
+        compactIfNeeded()
+    }
+
+    override fun transition(id: String, status: Int, running: Boolean, remainingSeconds: Long): Boolean {
+        if (!isAvailable()) return false
+        val stored = nativeTransition(
+            handle, id, status, running, remainingSeconds,
+            SystemClock.elapsedRealtimeNanos(), System.currentTimeMillis()
+        )
+        compactIfNeeded()
+        return stored
+    }
+
+    override fun remove(id: String) {
+        if (!isAvailable()) return
+        nativeRemove(handle, id)
+        compactIfNeeded()
+    }
+
+    override fun recover(): List<TimerJournal.JournaledTimer> {
+        if (!isAvailable()) return emptyList()
+        val bytes = nativeRecover(handle, SystemClock.elapsedRealtimeNanos(), System.currentTimeMillis())
+            ?: return emptyList()
+
+        val buffer = ByteBuffer.wrap(bytes).order(ByteOrder.nativeOrder())
+        val timers = ArrayList<TimerJournal.JournaledTimer>()
+        var position = 0
+        while (position + SNAPSHOT_HEADER_BYTES <= bytes.size) {
+            val status = buffer.get(position).toInt() and 0xFF
+            val running = buffer.get(position + 1).toInt() != 0
+            val idLength = buffer.getShort(position + 2).toInt() and 0xFFFF
+            val metadataLength = buffer.getInt(position + 4)
+            val remainingSeconds = buffer.getLong(position + 8)
+
+            val idStart = position + SNAPSHOT_HEADER_BYTES
+            val metadataStart = idStart + idLength
+            timers += TimerJournal.JournaledTimer(
+                id = String(bytes, idStart, idLength, Charsets.UTF_8),
+                metadata = bytes.copyOfRange(metadataStart, metadataStart + metadataLength),
+                status = status,
+                running = running,
+                remainingSeconds = remainingSeconds
+            )
+            position = (metadataStart + metadataLength + 7) and 7.inv()
+        }
+        return timers
+    }
+
+    fun stats(): Stats {
+        if (!isAvailable()) return Stats(0, 0, 0, 0, 0)
+        val values = nativeStats(handle)
+        return Stats(
+            liveTimers = values[0],
+            records = values[1],
+            usedBytes = values[2],
+            liveBytes = values[3],
+            droppedBytes = values[4]
+        )
+    }
+
+    /**
+     * Compacts off the calling thread. Appends made meanwhile wait on the
+     * journal's lock, about a millisecond at the sizes that trigger it.
+     */
+    private fun compactIfNeeded() {
+        if (!nativeNeedsCompaction(handle) || !compacting.compareAndSet(false, true)) return
+        scope.launch {
+            try {
+                if (!nativeCompact(handle)) Log.w(TAG, "Timer journal compaction failed")
+            } finally {
+                compacting.set(false)
+            }
+        }
+    }
+}
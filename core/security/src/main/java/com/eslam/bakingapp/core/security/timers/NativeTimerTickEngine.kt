@@ -0,0 +1,142 @@
+package com.eslam.bakingapp.core.security.timers
+
+import android.os.SystemClock
+import com.eslam.bakingapp.core.security.NativeLibrary
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [TimerTickEngine] backed by the native structure-of-arrays timer table.
+ *
+ * Deadlines live in contiguous native arrays; one JNI call per [tick] scans
+ * them and writes (slot, seconds) pairs into a direct buffer. The clock is
+ * [SystemClock.elapsedRealtimeNanos], so timers keep running in deep sleep.
+ * Without the native library the same bookkeeping runs in Kotlin.
+ */
+@Singleton
+class NativeTimerTickEngine @Inject constructor() : TimerTickEngine {
+
+    companion object {
+        private const val EVENT_CAPACITY = 1024
+        private const val EVENT_BYTES = 8
+        private const val NANOS_PER_SECOND = 1_000_000_000L
+    }
+
+    /**
+     * The engine's view of a timer, as last set or reported
+     */
+    private class Tracked(
+        val slot: Int,
+        var remainingSeconds: Long,
+        var running: Boolean,
+        var deadlineNanos: Long
+    )
+
+    private val tracked = HashMap<String, Tracked>()
+    private var idsBySlot = arrayOfNulls<String>(64)
+
+    private val handle: Long by lazy {
+        if (NativeLibrary.ensureLoaded()) nativeCreate() else 0L
+    }
+
+    private val events: ByteBuffer by lazy {
+        ByteBuffer.allocateDirect(EVENT_CAPACITY * EVENT_BYTES).order(ByteOrder.nativeOrder())
+    }
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeCreate(): Long
+
+    private external fun nativeAdd(handle: Long, remainingSeconds: Long, running: Boolean, nowNanos: Long): Int
+
+    private external fun nativeSet(
+        handle: Long,
+        slot: Int,
+        remainingSeconds: Long,
+        running: Boolean,
+        nowNanos: Long
+    ): Boolean
+
+    private external fun nativeRemove(handle: Long, slot: Int): Boolean
+
+    private external fun nativeTick(handle: Long, nowNanos: Long, buffer: ByteBuffer): Int
+
+    // ==================== Public API ====================
+
+    @Synchronized
+    override fun track(id: String, remainingSeconds: Long, running: Boolean) {
+        val current = tracked[id]
+        if (current != null && current.remainingSeconds == remainingSeconds && current.running == running) {
+            return
+        }
+
+        val now = SystemClock.elapsedRealtimeNanos()
+        if (current == null) {
+            val slot = if (handle != 0L) nativeAdd(handle, remainingSeconds, running, now) else -1
+            if (slot >= 0) {
+                if (slot >= idsBySlot.size) idsBySlot = idsBySlot.copyOf(maxOf(slot + 1, idsBySlot.size * 2))
+                idsBySlot[slot] = id
+            }
+            tracked[id] = Tracked(slot, remainingSeconds, running, now + remainingSeconds * NANOS_PER_SECOND)
+            return
+        }
+
+        if (current.slot >= 0) nativeSet(handle, current.slot, remainingSeconds, running, now)
+        current.remainingSeconds = remainingSeconds
+        current.running = running
+        current.deadlineNanos = now + remainingSeconds * NANOS_PER_SECOND
+    }
+
+    @Synchronized
+    override fun retainAll(ids: Set<String>) {
+        val iterator = tracked.entries.iterator()
+        while (iterator.hasNext()) {
+            val (id, timer) = iterator.next()
+            if (id in ids) continue
+            if (timer.slot >= 0) {
+                nativeRemove(handle, timer.slot)
+                idsBySlot[timer.slot] = null
+            }
+            iterator.remove()
+        }
+    }
+
+    @Synchronized
+    override fun tick(): Map<String, Long> {
+        if (tracked.isEmpty()) return emptyMap()
+        val now = SystemClock.elapsedRealtimeNanos()
+        val changes = HashMap<String, Long>()
+
+        if (handle != 0L) {
+            do {
+                val count = nativeTick(handle, now, events)
+                for (i in 0 until count) {
+                    val slot = events.getInt(i * EVENT_BYTES)
+                    val seconds = events.getInt(i * EVENT_BYTES + 4).toLong()
+                    val id = idsBySlot.getOrNull(slot) ?: continue
+                    tracked[id]?.let { report(it, seconds) }
+                    changes[id] = seconds
+                }
+            } while (count == EVENT_CAPACITY)
+        }
+
+        // Timers the native table could not take (or no native library)
+        for ((id, timer) in tracked) {
+            if (timer.slot >= 0 || !timer.running) continue
+            val remaining = timer.deadlineNanos - now
+            val seconds = if (remaining <= 0) 0L else (remaining + NANOS_PER_SECOND - 1) / NANOS_PER_SECOND
+            if (seconds != timer.remainingSeconds || seconds == 0L) {
+                report(timer, seconds)
+                changes[id] = seconds
+            }
+        }
+        return changes
+    }
+
+    private fun report(timer: Tracked, seconds: Long) {
+        timer.remainingSeconds = seconds
+        if (seconds == 0L) timer.running = false
+    }
+}
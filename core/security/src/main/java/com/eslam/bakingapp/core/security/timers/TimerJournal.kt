@@ -0,0 +1,47 @@
+package com.eslam.bakingapp.core.security.timers
+
+/**
+ * Crash-safe record of cooking-timer state.
+ *
+ * Only state transitions are written, never ticks: a running timer's
+ * remaining time is derived on [recover] from the clocks at its last
+ * transition, so a process killed mid-countdown resumes where it would
+ * have been.
+ */
+interface TimerJournal {
+
+    /**
+     * A timer as recovered from the journal
+     *
+     * @property metadata the bytes last passed to [put]
+     * @property remainingSeconds for running timers, with the time since
+     *   their last transition already subtracted (never below 0)
+     */
+    class JournaledTimer(
+        val id: String,
+        val metadata: ByteArray,
+        val status: Int,
+        val running: Boolean,
+        val remainingSeconds: Long
+    )
+
+    /**
+     * Records a whole timer: created, edited or reset
+     */
+    fun put(id: String, metadata: ByteArray, status: Int, running: Boolean, remainingSeconds: Long)
+
+    /**
+     * Records a start, pause, resume, cancel or completion of a timer that
+     * was [put] before
+     *
+     * @return false if the timer is unknown to the journal
+     */
+    fun transition(id: String, status: Int, running: Boolean, remainingSeconds: Long): Boolean
+
+    fun remove(id: String)
+
+    /**
+     * Every timer put and not removed, as of now
+     */
+    fun recover(): List<JournaledTimer>
+}
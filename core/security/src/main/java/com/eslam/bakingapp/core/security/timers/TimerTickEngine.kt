@@ -0,0 +1,29 @@
+package com.eslam.bakingapp.core.security.timers
+
+/**
+ * Derives countdown timers' remaining time from a monotonic clock.
+ *
+ * Callers mirror their timers into the engine with [track] and poll [tick]
+ * as often as they like; only timers whose displayed whole seconds changed
+ * come back, so polling every frame costs little more than once a second.
+ */
+interface TimerTickEngine {
+
+    /**
+     * Adds or updates a timer. A running timer is (re)anchored only when
+     * [remainingSeconds] or [running] differ from the engine's own view,
+     * so writing [tick] results back does not drift the deadline.
+     */
+    fun track(id: String, remainingSeconds: Long, running: Boolean)
+
+    /**
+     * Stops tracking every timer whose id is not in [ids]
+     */
+    fun retainAll(ids: Set<String>)
+
+    /**
+     * Returns remaining seconds for the timers that changed since the last
+     * call; 0 means the timer completed and has stopped.
+     */
+    fun tick(): Map<String, Long>
+}
@@ -0,0 +1,41 @@
+package com.eslam.bakingapp.core.security.units
+
+/**
+ * Target unit system for ingredient conversion.
+ * Ordinals match the native `UnitSystem` enum.
+ */
+enum class UnitSystem {
+    /** Keep the recipe's own units, only scale */
+    ORIGINAL,
+    METRIC,
+    IMPERIAL
+}
+
+/**
+ * Result of [IngredientScaler.scale], in input order
+ */
+class ScaledQuantities(
+    val quantities: DoubleArray,
+    val units: List<String>
+)
+
+/**
+ * Rescales ingredient quantities by servings and converts their units.
+ */
+interface IngredientScaler {
+
+    /**
+     * Multiplies every quantity by [factor] and converts mass/volume units
+     * to [system], picking the unit by magnitude (e.g. 3 tsp -> 1 tbsp).
+     * Count and unrecognized units keep their original text.
+     *
+     * @param quantities One quantity per ingredient
+     * @param units The ingredient `unit` strings, same size as [quantities]
+     */
+    fun scale(
+        quantities: DoubleArray,
+        units: List<String>,
+        factor: Double,
+        system: UnitSystem
+    ): ScaledQuantities
+}
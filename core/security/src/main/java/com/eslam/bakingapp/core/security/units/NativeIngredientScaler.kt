@@ -0,0 +1,69 @@
+package com.eslam.bakingapp.core.security.units
+
+import com.eslam.bakingapp.core.security.NativeLibrary
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * [IngredientScaler] backed by the native batch kernel.
+ *
+ * Unit strings are interned to one-byte codes (each distinct string crosses
+ * JNI once per call), then the whole recipe is scaled and converted in a
+ * single JNI call. Without the native library quantities are only scaled.
+ */
+@Singleton
+class NativeIngredientScaler @Inject constructor() : IngredientScaler {
+
+    private val unitNames = arrayOfNulls<String>(256)
+
+    // ==================== Native Method Declarations ====================
+
+    private external fun nativeInternUnits(units: Array<String>): ByteArray
+
+    private external fun nativeUnitName(code: Int): String?
+
+    private external fun nativeScale(
+        quantities: DoubleArray,
+        units: ByteArray,
+        factor: Double,
+        system: Int,
+        outQuantities: DoubleArray,
+        outUnits: ByteArray
+    ): Boolean
+
+    // ==================== Public API ====================
+
+    override fun scale(
+        quantities: DoubleArray,
+        units: List<String>,
+        factor: Double,
+        system: UnitSystem
+    ): ScaledQuantities {
+        require(quantities.size == units.size) { "quantities and units differ in size" }
+        if (quantities.isEmpty() || !NativeLibrary.ensureLoaded()) {
+            return ScaledQuantities(DoubleArray(quantities.size) { quantities[it] * factor }, units)
+        }
+
+        val distinct = units.distinct()
+        val distinctCodes = nativeInternUnits(distinct.toTypedArray())
+        val codeOf = HashMap<String, Byte>(distinct.size * 2)
+        distinct.forEachIndexed { index, unit -> codeOf[unit] = distinctCodes[index] }
+        val codes = ByteArray(units.size) { codeOf.getValue(units[it]) }
+
+        val outQuantities = DoubleArray(quantities.size)
+        val outCodes = ByteArray(quantities.size)
+        if (!nativeScale(quantities, codes, factor, system.ordinal, outQuantities, outCodes)) {
+            return ScaledQuantities(DoubleArray(quantities.size) { quantities[it] * factor }, units)
+        }
+
+        val outUnits = List(units.size) { index ->
+            if (outCodes[index] == codes[index]) units[index] else unitName(outCodes[index])
+        }
+        return ScaledQuantities(outQuantities, outUnits)
+    }
+
+    private fun unitName(code: Byte): String {
+        val index = code.toInt() and 0xFF
+        return unitNames[index] ?: (nativeUnitName(index) ?: "").also { unitNames[index] = it }
+    }
+}
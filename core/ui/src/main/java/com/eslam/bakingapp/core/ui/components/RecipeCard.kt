@@ -32,10 +32,13 @@ import androidx.compose.ui.draw.clip
 import androidx.compose.ui.graphics.Brush
 import androidx.compose.ui.graphics.Color
 import androidx.compose.ui.layout.ContentScale
+import androidx.compose.ui.platform.LocalContext
 import androidx.compose.ui.text.style.TextOverflow
 import androidx.compose.ui.tooling.preview.Preview
 import androidx.compose.ui.unit.dp
 import coil.compose.AsyncImage
+import coil.request.ImageRequest
+import com.eslam.bakingapp.core.ui.image.listThumbnail
 import com.eslam.bakingapp.core.ui.theme.BakingAppTheme
 
 /**
@@ -74,7 +77,10 @@ fun RecipeCard(
                     .height(180.dp)
             ) {
                 AsyncImage(
-                    model = imageUrl,
+                    model = ImageRequest.Builder(LocalContext.current)
+                        .data(imageUrl)
+                        .listThumbnail()
+                        .build(),
                     contentDescription = name,
                     modifier = Modifier
                         .fillMaxWidth()
@@ -0,0 +1,15 @@
+package com.eslam.bakingapp.core.ui.image
+
+import coil.request.ImageRequest
+
+/**
+ * Request parameter marking an image as a list cell thumbnail.
+ *
+ * The app's image loader serves marked requests cell-sized from the native
+ * thumbnail pipeline instead of decoding the full image on the Java heap;
+ * unmarked requests (detail screens) load as usual.
+ */
+const val LIST_THUMBNAIL_PARAMETER = "list_thumbnail"
+
+fun ImageRequest.Builder.listThumbnail(): ImageRequest.Builder =
+    setParameter(LIST_THUMBNAIL_PARAMETER, true)
@@ -44,6 +44,7 @@ dependencies {
     // Module dependencies
     implementation(project(":core:common"))
     implementation(project(":core:ui"))
+    implementation(project(":core:security"))
     
     // Android Core
     implementation(libs.androidx.core.ktx)
@@ -1,42 +1,72 @@
 package com.eslam.bakingapp.features.cookingtimer.data.datasource
 
+import com.eslam.bakingapp.core.common.dispatcher.IoDispatcher
+import com.eslam.bakingapp.core.security.sort.KeySorter
+import com.eslam.bakingapp.core.security.timers.TimerJournal
 import com.eslam.bakingapp.features.cookingtimer.domain.model.CookingTimer
 import com.eslam.bakingapp.features.cookingtimer.domain.model.PresetCategory
 import com.eslam.bakingapp.features.cookingtimer.domain.model.TimerPreset
 import com.eslam.bakingapp.features.cookingtimer.domain.model.TimerStatus
+import kotlinx.coroutines.CoroutineDispatcher
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.map
+import kotlinx.coroutines.flow.onStart
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import kotlinx.coroutines.withContext
+import java.io.ByteArrayInputStream
+import java.io.ByteArrayOutputStream
+import java.io.DataInputStream
+import java.io.DataOutputStream
 import javax.inject.Inject
 import javax.inject.Singleton
 
 /**
  * Local data source for cooking timers.
  * 
- * This is an in-memory implementation for demonstration purposes.
- * In a production app, this would interact with Room database
- * or other persistent storage.
+ * Timers are held in memory and mirrored into a [TimerJournal] that records
+ * only state transitions: creating, starting, pausing, completing and
+ * deleting a timer append a record, per-second ticks do not. The journal
+ * is replayed on the IO dispatcher the first time timers are read or
+ * changed (not during injection, which happens on the main thread), so
+ * timers survive the process being killed and running ones resume with the
+ * elapsed time already subtracted.
+ * 
+ * Lists come out newest first through a [KeySorter]. Timers are stored in
+ * creation order and keep it on every per-second update, so each emission
+ * is a list already in (reverse) order, which the native sort takes in a
+ * single pass.
  */
 @Singleton
-class LocalTimerDataSource @Inject constructor() {
+class LocalTimerDataSource @Inject constructor(
+    private val journal: TimerJournal,
+    private val sorter: KeySorter,
+    @IoDispatcher private val ioDispatcher: CoroutineDispatcher
+) {
     
     private val timersFlow = MutableStateFlow<Map<String, CookingTimer>>(emptyMap())
+    private val recovery = Mutex()
+    @Volatile private var recovered = false
     
     /**
      * Get all timers as a flow for real-time updates.
      */
     fun getAllTimers(): Flow<List<CookingTimer>> {
-        return timersFlow.map { it.values.toList().sortedByDescending { timer -> timer.createdAt } }
+        return recoveredTimers().map { timers ->
+            sorter.sortedBy(timers.values.toList(), descending = true) { it.createdAt }
+        }
     }
     
     /**
      * Get active timers (running or paused).
      */
     fun getActiveTimers(): Flow<List<CookingTimer>> {
-        return timersFlow.map { timers ->
-            timers.values
-                .filter { it.status == TimerStatus.RUNNING || it.status == TimerStatus.PAUSED }
-                .sortedByDescending { it.createdAt }
+        return recoveredTimers().map { timers ->
+            val active = timers.values.filter {
+                it.status == TimerStatus.RUNNING || it.status == TimerStatus.PAUSED
+            }
+            sorter.sortedBy(active, descending = true) { it.createdAt }
         }
     }
     
@@ -44,6 +74,7 @@ class LocalTimerDataSource @Inject constructor() {
      * Get a specific timer by ID.
      */
     suspend fun getTimerById(timerId: String): CookingTimer? {
+        ensureRecovered()
         return timersFlow.value[timerId]
     }
     
@@ -51,39 +82,73 @@ class LocalTimerDataSource @Inject constructor() {
      * Insert a new timer.
      */
     suspend fun insertTimer(timer: CookingTimer) {
+        ensureRecovered()
         timersFlow.value = timersFlow.value.toMutableMap().apply {
             put(timer.id, timer)
         }
+        journalPut(timer)
     }
     
     /**
      * Update an existing timer.
+     * A change of status or remaining time only is journaled as a transition.
      */
     suspend fun updateTimer(timer: CookingTimer) {
+        ensureRecovered()
+        val previous = timersFlow.value[timer.id]
         timersFlow.value = timersFlow.value.toMutableMap().apply {
             put(timer.id, timer)
         }
+        val sameTimer = previous?.copy(status = timer.status, remainingSeconds = timer.remainingSeconds) == timer
+        if (!sameTimer || !journalTransition(timer)) journalPut(timer)
+    }
+    
+    /**
+     * Apply remaining times for many timers with a single map copy.
+     * Timers that reach zero are marked completed; unknown IDs are ignored.
+     */
+    suspend fun updateRemainingTimes(remaining: Map<String, Long>) {
+        if (remaining.isEmpty()) return
+        ensureRecovered()
+        val completed = ArrayList<CookingTimer>()
+        timersFlow.value = timersFlow.value.toMutableMap().apply {
+            for ((timerId, seconds) in remaining) {
+                val timer = get(timerId) ?: continue
+                val updated = timer.copy(
+                    remainingSeconds = maxOf(0, seconds),
+                    status = if (seconds <= 0) TimerStatus.COMPLETED else timer.status
+                )
+                put(timerId, updated)
+                if (updated.status != timer.status) completed += updated
+            }
+        }
+        // Ticks are derived from the clocks on recovery; only completions are journaled
+        completed.forEach { journalTransition(it) }
     }
     
     /**
      * Delete a timer by ID.
      */
     suspend fun deleteTimer(timerId: String) {
+        ensureRecovered()
         timersFlow.value = timersFlow.value.toMutableMap().apply {
             remove(timerId)
         }
+        journal.remove(timerId)
     }
     
     /**
      * Clear all completed timers.
      */
     suspend fun clearCompletedTimers(): Int {
+        ensureRecovered()
         val currentTimers = timersFlow.value
         val completedIds = currentTimers.values
             .filter { it.status == TimerStatus.COMPLETED || it.status == TimerStatus.CANCELLED }
             .map { it.id }
         
         timersFlow.value = currentTimers.filterKeys { it !in completedIds }
+        completedIds.forEach { journal.remove(it) }
         
         return completedIds.size
     }
@@ -123,4 +188,73 @@ class LocalTimerDataSource @Inject constructor() {
             TimerPreset("preset_17", "Roast Rest", 15 * 60, PresetCategory.RESTING)
         )
     }
+    
+    private fun journalPut(timer: CookingTimer) {
+        journal.put(timer.id, encodeMetadata(timer), timer.status.ordinal, timer.isRunning, timer.remainingSeconds)
+    }
+    
+    private fun journalTransition(timer: CookingTimer): Boolean =
+        journal.transition(timer.id, timer.status.ordinal, timer.isRunning, timer.remainingSeconds)
+    
+    private fun recoveredTimers(): Flow<Map<String, CookingTimer>> =
+        timersFlow.onStart { ensureRecovered() }
+    
+    /**
+     * Replays the journal once, before the first read or change
+     */
+    private suspend fun ensureRecovered() {
+        if (recovered) return
+        recovery.withLock {
+            if (recovered) return
+            timersFlow.value = withContext(ioDispatcher) { recoverTimers() }
+            recovered = true
+        }
+    }
+    
+    private fun recoverTimers(): Map<String, CookingTimer> {
+        val statuses = TimerStatus.entries
+        return journal.recover().mapNotNull { entry ->
+            val status = statuses.getOrNull(entry.status) ?: return@mapNotNull null
+            runCatching { decodeTimer(entry.id, entry.metadata, status, entry.remainingSeconds) }.getOrNull()
+        }.associateBy { it.id }
+    }
+    
+    /**
+     * The fields a transition never changes, in a compact binary form
+     */
+    private fun encodeMetadata(timer: CookingTimer): ByteArray {
+        val bytes = ByteArrayOutputStream()
+        DataOutputStream(bytes).use { out ->
+            out.writeUTF(timer.name)
+            out.writeUTF(timer.description)
+            out.writeLong(timer.durationSeconds)
+            out.writeLong(timer.createdAt)
+            out.writeBoolean(timer.recipeId != null)
+            timer.recipeId?.let { out.writeUTF(it) }
+            out.writeBoolean(timer.stepNumber != null)
+            timer.stepNumber?.let { out.writeInt(it) }
+        }
+        return bytes.toByteArray()
+    }
+    
+    private fun decodeTimer(id: String, metadata: ByteArray, status: TimerStatus, remainingSeconds: Long): CookingTimer =
+        DataInputStream(ByteArrayInputStream(metadata)).use { input ->
+            val name = input.readUTF()
+            val description = input.readUTF()
+            val durationSeconds = input.readLong()
+            val createdAt = input.readLong()
+            val recipeId = if (input.readBoolean()) input.readUTF() else null
+            val stepNumber = if (input.readBoolean()) input.readInt() else null
+            CookingTimer(
+                id = id,
+                name = name,
+                description = description,
+                durationSeconds = durationSeconds,
+                remainingSeconds = remainingSeconds,
+                status = status,
+                recipeId = recipeId,
+                stepNumber = stepNumber,
+                createdAt = createdAt
+            )
+        }
 }
@@ -115,6 +115,15 @@ class TimerRepositoryImpl @Inject constructor(
         }
     }
     
+    override suspend fun updateRemainingTimes(remaining: Map<String, Long>): Result<Unit> {
+        return try {
+            localDataSource.updateRemainingTimes(remaining)
+            Result.Success(Unit)
+        } catch (e: Exception) {
+            Result.Error(e, e.message ?: "Failed to update remaining times")
+        }
+    }
+    
     override suspend fun deleteTimer(timerId: String): Result<Unit> {
         return try {
             localDataSource.deleteTimer(timerId)
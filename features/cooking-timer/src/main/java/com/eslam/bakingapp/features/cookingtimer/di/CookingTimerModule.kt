@@ -1,5 +1,8 @@
 package com.eslam.bakingapp.features.cookingtimer.di
 
+import com.eslam.bakingapp.core.common.dispatcher.IoDispatcher
+import com.eslam.bakingapp.core.security.sort.KeySorter
+import com.eslam.bakingapp.core.security.timers.TimerJournal
 import com.eslam.bakingapp.features.cookingtimer.data.datasource.LocalTimerDataSource
 import com.eslam.bakingapp.features.cookingtimer.data.repository.TimerRepositoryImpl
 import com.eslam.bakingapp.features.cookingtimer.domain.repository.TimerRepository
@@ -8,6 +11,7 @@ import dagger.Module
 import dagger.Provides
 import dagger.hilt.InstallIn
 import dagger.hilt.components.SingletonComponent
+import kotlinx.coroutines.CoroutineDispatcher
 import javax.inject.Singleton
 
 /**
@@ -52,7 +56,11 @@ object CookingTimerProviderModule {
      */
     @Provides
     @Singleton
-    fun provideLocalTimerDataSource(): LocalTimerDataSource {
-        return LocalTimerDataSource()
+    fun provideLocalTimerDataSource(
+        journal: TimerJournal,
+        sorter: KeySorter,
+        @IoDispatcher ioDispatcher: CoroutineDispatcher
+    ): LocalTimerDataSource {
+        return LocalTimerDataSource(journal, sorter, ioDispatcher)
     }
 }
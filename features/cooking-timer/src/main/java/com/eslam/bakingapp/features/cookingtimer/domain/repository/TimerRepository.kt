@@ -51,6 +51,12 @@ interface TimerRepository {
      */
     suspend fun updateRemainingTime(timerId: String, remainingSeconds: Long): Result<Unit>
     
+    /**
+     * Update remaining time for many timers at once (one tick).
+     * Timers that reach zero are marked completed.
+     */
+    suspend fun updateRemainingTimes(remaining: Map<String, Long>): Result<Unit>
+    
     /**
      * Delete a timer.
      */
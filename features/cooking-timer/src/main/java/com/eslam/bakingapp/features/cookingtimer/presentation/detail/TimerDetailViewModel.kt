@@ -5,10 +5,11 @@ import androidx.lifecycle.SavedStateHandle
 import androidx.lifecycle.ViewModel
 import androidx.lifecycle.viewModelScope
 import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.core.security.timers.TimerTickEngine
 import com.eslam.bakingapp.features.cookingtimer.domain.model.TimerStatus
 import com.eslam.bakingapp.features.cookingtimer.domain.repository.TimerRepository
 import com.eslam.bakingapp.features.cookingtimer.domain.usecase.DeleteTimerUseCase
-import com.eslam.bakingapp.features.cookingtimer.domain.usecase.GetTimerByIdUseCase
+import com.eslam.bakingapp.features.cookingtimer.domain.usecase.GetTimersUseCase
 import com.eslam.bakingapp.features.cookingtimer.domain.usecase.PauseTimerUseCase
 import com.eslam.bakingapp.features.cookingtimer.domain.usecase.ResetTimerUseCase
 import com.eslam.bakingapp.features.cookingtimer.domain.usecase.StartTimerUseCase
@@ -33,16 +34,22 @@ import javax.inject.Inject
  * - SavedStateHandle for navigation arguments
  * - Process death survival with SavedStateHandle
  * - Coroutine job management
+ * 
+ * The timer is observed through the repository, like the list does. The
+ * tick engine is shared with the list screen, which stays alive on the back
+ * stack and keeps ticking: whichever screen polls a change first writes it
+ * back, and both see it in the repository flow.
  */
 @HiltViewModel
 class TimerDetailViewModel @Inject constructor(
     savedStateHandle: SavedStateHandle,
-    private val getTimerByIdUseCase: GetTimerByIdUseCase,
+    private val getTimersUseCase: GetTimersUseCase,
     private val startTimerUseCase: StartTimerUseCase,
     private val pauseTimerUseCase: PauseTimerUseCase,
     private val resetTimerUseCase: ResetTimerUseCase,
     private val deleteTimerUseCase: DeleteTimerUseCase,
-    private val repository: TimerRepository
+    private val repository: TimerRepository,
+    private val tickEngine: TimerTickEngine
 ) : ViewModel() {
     
     companion object {
@@ -66,27 +73,43 @@ class TimerDetailViewModel @Inject constructor(
     
     init {
         Log.d(TAG, "ViewModel initialized with timerId: $timerId")
-        loadTimer()
+        observeTimer()
         startTimerTick()
     }
     
-    private fun loadTimer() {
+    private fun observeTimer() {
         viewModelScope.launch {
-            _uiState.update { it.copy(isLoading = true) }
-            
-            when (val result = getTimerByIdUseCase(timerId)) {
-                is Result.Success -> {
-                    _uiState.update { it.copy(timer = result.data, isLoading = false) }
-                }
-                is Result.Error -> {
-                    _uiState.update { 
-                        it.copy(
-                            isLoading = false, 
-                            errorMessage = result.message ?: "Timer not found"
-                        ) 
+            getTimersUseCase().collect { result ->
+                when (result) {
+                    is Result.Loading -> {
+                        _uiState.update { it.copy(isLoading = true) }
+                    }
+                    is Result.Success -> {
+                        val timer = result.data.firstOrNull { it.id == timerId }
+                        if (timer == null) {
+                            _uiState.update {
+                                it.copy(timer = null, isLoading = false, errorMessage = "Timer not found")
+                            }
+                            return@collect
+                        }
+                        // Mirrored from the repository, never from UI state:
+                        // values the engine reported itself are a no-op
+                        tickEngine.track(timer.id, timer.remainingSeconds, timer.isRunning)
+                        val previous = _uiState.value.timer
+                        _uiState.update { it.copy(timer = timer, isLoading = false, errorMessage = null) }
+                        if (previous?.status == TimerStatus.RUNNING && timer.status == TimerStatus.COMPLETED) {
+                            _events.emit(TimerDetailEvent.ShowMessage("Timer completed!"))
+                        }
+                    }
+                    is Result.Error -> {
+                        _uiState.update {
+                            it.copy(
+                                isLoading = false,
+                                errorMessage = result.message ?: "Timer not found"
+                            )
+                        }
                     }
                 }
-                is Result.Loading -> {}
             }
         }
     }
@@ -101,32 +124,21 @@ class TimerDetailViewModel @Inject constructor(
         }
     }
     
+    /**
+     * Writes back whatever the shared engine reports, including other
+     * timers', for when the list screen is not ticking (e.g. this screen
+     * was restored on its own after process death)
+     */
     private suspend fun updateTimer() {
-        val currentTimer = _uiState.value.timer ?: return
-        if (!currentTimer.isRunning) return
-        
-        val newRemainingTime = currentTimer.remainingSeconds - 1
-        
-        if (newRemainingTime <= 0) {
-            repository.updateRemainingTime(currentTimer.id, 0)
-            _events.emit(TimerDetailEvent.ShowMessage("Timer completed!"))
-        } else {
-            repository.updateRemainingTime(currentTimer.id, newRemainingTime)
-        }
-        
-        // Reload timer to get updated state
-        when (val result = getTimerByIdUseCase(timerId)) {
-            is Result.Success -> {
-                _uiState.update { it.copy(timer = result.data) }
-            }
-            else -> {}
-        }
+        if (_uiState.value.timer?.isRunning != true) return
+        val changes = tickEngine.tick()
+        if (changes.isNotEmpty()) repository.updateRemainingTimes(changes)
     }
     
     fun onStartTimer() {
         viewModelScope.launch {
             when (startTimerUseCase(timerId)) {
-                is Result.Success -> loadTimer()
+                is Result.Success -> {}
                 is Result.Error -> _events.emit(TimerDetailEvent.ShowMessage("Failed to start timer"))
                 is Result.Loading -> {}
             }
@@ -136,7 +148,7 @@ class TimerDetailViewModel @Inject constructor(
     fun onPauseTimer() {
         viewModelScope.launch {
             when (pauseTimerUseCase(timerId)) {
-                is Result.Success -> loadTimer()
+                is Result.Success -> {}
                 is Result.Error -> _events.emit(TimerDetailEvent.ShowMessage("Failed to pause timer"))
                 is Result.Loading -> {}
             }
@@ -146,10 +158,7 @@ class TimerDetailViewModel @Inject constructor(
     fun onResetTimer() {
         viewModelScope.launch {
             when (resetTimerUseCase(timerId)) {
-                is Result.Success -> {
-                    loadTimer()
-                    _events.emit(TimerDetailEvent.ShowMessage("Timer reset"))
-                }
+                is Result.Success -> _events.emit(TimerDetailEvent.ShowMessage("Timer reset"))
                 is Result.Error -> _events.emit(TimerDetailEvent.ShowMessage("Failed to reset timer"))
                 is Result.Loading -> {}
             }
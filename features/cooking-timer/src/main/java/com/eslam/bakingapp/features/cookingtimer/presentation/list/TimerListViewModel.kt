@@ -4,6 +4,7 @@ import android.util.Log
 import androidx.lifecycle.ViewModel
 import androidx.lifecycle.viewModelScope
 import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.core.security.timers.TimerTickEngine
 import com.eslam.bakingapp.features.cookingtimer.domain.model.CookingTimer
 import com.eslam.bakingapp.features.cookingtimer.domain.model.TimerStatus
 import com.eslam.bakingapp.features.cookingtimer.domain.usecase.DeleteTimerUseCase
@@ -53,12 +54,15 @@ class TimerListViewModel @Inject constructor(
     private val pauseTimerUseCase: PauseTimerUseCase,
     private val resetTimerUseCase: ResetTimerUseCase,
     private val deleteTimerUseCase: DeleteTimerUseCase,
-    private val repository: TimerRepository
+    private val repository: TimerRepository,
+    private val tickEngine: TimerTickEngine
 ) : ViewModel() {
     
     companion object {
         private const val TAG = "TimerListViewModel"
-        private const val TIMER_TICK_INTERVAL_MS = 1000L
+        // Remaining time comes from the clock, so polling faster than once a
+        // second only makes second boundaries show up sooner
+        private const val TIMER_TICK_INTERVAL_MS = 250L
     }
     
     // UI State - survives configuration changes
@@ -92,6 +96,7 @@ class TimerListViewModel @Inject constructor(
                         val activeCount = result.data.count { 
                             it.status == TimerStatus.RUNNING || it.status == TimerStatus.PAUSED 
                         }
+                        syncTickEngine(result.data)
                         _uiState.update { state ->
                             state.copy(
                                 timers = result.data,
@@ -114,9 +119,20 @@ class TimerListViewModel @Inject constructor(
         }
     }
     
+    /**
+     * Mirror timer states into the tick engine. Only timers that were
+     * started, paused, reset or deleted cause native calls.
+     */
+    private fun syncTickEngine(timers: List<CookingTimer>) {
+        tickEngine.retainAll(timers.mapTo(HashSet(timers.size * 2)) { it.id })
+        for (timer in timers) {
+            tickEngine.track(timer.id, timer.remainingSeconds, timer.isRunning)
+        }
+    }
+    
     /**
      * Start the timer tick job.
-     * Updates all running timers every second.
+     * Polls the tick engine for running timers whose remaining time changed.
      */
     private fun startTimerTick() {
         timerTickJob?.cancel()
@@ -129,22 +145,21 @@ class TimerListViewModel @Inject constructor(
     }
     
     /**
-     * Update all running timers by decrementing their remaining time.
+     * Write back every timer whose remaining time changed in one repository
+     * update, then announce the ones that completed.
      */
     private suspend fun updateRunningTimers() {
-        val runningTimers = _uiState.value.timers.filter { it.isRunning }
+        val changes = tickEngine.tick()
+        if (changes.isEmpty()) return
         
-        for (timer in runningTimers) {
-            val newRemainingTime = timer.remainingSeconds - 1
-            
-            if (newRemainingTime <= 0) {
-                // Timer completed
-                repository.updateRemainingTime(timer.id, 0)
-                _events.emit(TimerListEvent.TimerCompleted(timer))
-                _events.emit(TimerListEvent.ShowMessage("${timer.name} completed!"))
-            } else {
-                repository.updateRemainingTime(timer.id, newRemainingTime)
-            }
+        repository.updateRemainingTimes(changes)
+        
+        val completedIds = changes.filterValues { it == 0L }.keys
+        if (completedIds.isEmpty()) return
+        for (timer in _uiState.value.timers) {
+            if (timer.id !in completedIds) continue
+            _events.emit(TimerListEvent.TimerCompleted(timer))
+            _events.emit(TimerListEvent.ShowMessage("${timer.name} completed!"))
         }
     }
     
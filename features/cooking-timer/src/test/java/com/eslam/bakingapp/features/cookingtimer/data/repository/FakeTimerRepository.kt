@@ -98,6 +98,23 @@ class FakeTimerRepository : TimerRepository {
         return Result.Success(Unit)
     }
     
+    override suspend fun updateRemainingTimes(remaining: Map<String, Long>): Result<Unit> {
+        if (shouldReturnError) return createError(errorMessage)
+        timers.value = timers.value.toMutableMap().apply {
+            for ((timerId, seconds) in remaining) {
+                val timer = get(timerId) ?: continue
+                put(
+                    timerId,
+                    timer.copy(
+                        remainingSeconds = maxOf(0, seconds),
+                        status = if (seconds <= 0) TimerStatus.COMPLETED else timer.status
+                    )
+                )
+            }
+        }
+        return Result.Success(Unit)
+    }
+    
     override suspend fun deleteTimer(timerId: String): Result<Unit> {
         if (shouldReturnError) return createError(errorMessage)
         timers.value = timers.value.toMutableMap().apply { remove(timerId) }
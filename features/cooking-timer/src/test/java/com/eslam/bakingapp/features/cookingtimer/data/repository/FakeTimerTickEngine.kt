@@ -0,0 +1,40 @@
+package com.eslam.bakingapp.features.cookingtimer.data.repository
+
+import com.eslam.bakingapp.core.security.timers.TimerTickEngine
+
+/**
+ * Fake TimerTickEngine for testing.
+ * 
+ * Records what the ViewModel tracks and returns [pendingChanges]
+ * from the next tick. Like the real engine, a tick updates its own view
+ * of the timers it reports, and [reanchored] lists every track() call
+ * that disagreed with that view (which would move the deadline).
+ */
+class FakeTimerTickEngine : TimerTickEngine {
+    
+    val tracked = mutableMapOf<String, Pair<Long, Boolean>>()
+    val pendingChanges = mutableMapOf<String, Long>()
+    val reanchored = mutableListOf<Pair<String, Long>>()
+    
+    override fun track(id: String, remainingSeconds: Long, running: Boolean) {
+        val current = tracked[id]
+        if (current != null && current != (remainingSeconds to running)) {
+            reanchored += id to remainingSeconds
+        }
+        tracked[id] = remainingSeconds to running
+    }
+    
+    override fun retainAll(ids: Set<String>) {
+        tracked.keys.retainAll(ids)
+    }
+    
+    override fun tick(): Map<String, Long> {
+        val changes = pendingChanges.toMap()
+        pendingChanges.clear()
+        for ((id, seconds) in changes) {
+            val running = tracked[id]?.second ?: continue
+            tracked[id] = seconds to (running && seconds != 0L)
+        }
+        return changes
+    }
+}
@@ -0,0 +1,166 @@
+package com.eslam.bakingapp.features.cookingtimer.presentation.detail
+
+import androidx.lifecycle.SavedStateHandle
+import app.cash.turbine.test
+import com.eslam.bakingapp.features.cookingtimer.data.repository.FakeTimerRepository
+import com.eslam.bakingapp.features.cookingtimer.data.repository.FakeTimerTickEngine
+import com.eslam.bakingapp.features.cookingtimer.domain.model.CookingTimer
+import com.eslam.bakingapp.features.cookingtimer.domain.model.TimerStatus
+import com.eslam.bakingapp.features.cookingtimer.domain.usecase.DeleteTimerUseCase
+import com.eslam.bakingapp.features.cookingtimer.domain.usecase.GetTimersUseCase
+import com.eslam.bakingapp.features.cookingtimer.domain.usecase.PauseTimerUseCase
+import com.eslam.bakingapp.features.cookingtimer.domain.usecase.ResetTimerUseCase
+import com.eslam.bakingapp.features.cookingtimer.domain.usecase.StartTimerUseCase
+import com.eslam.bakingapp.features.cookingtimer.presentation.list.TimerListViewModel
+import com.google.common.truth.Truth.assertThat
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.test.StandardTestDispatcher
+import kotlinx.coroutines.test.resetMain
+import kotlinx.coroutines.test.runTest
+import kotlinx.coroutines.test.setMain
+import org.junit.After
+import org.junit.Before
+import org.junit.Test
+
+/**
+ * Unit tests for TimerDetailViewModel.
+ * 
+ * The list screen stays alive on the back stack while the detail screen is
+ * open, so both tick the same engine; these tests run the two together.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+class TimerDetailViewModelTest {
+    
+    private val testDispatcher = StandardTestDispatcher()
+    private lateinit var repository: FakeTimerRepository
+    private lateinit var tickEngine: FakeTimerTickEngine
+    
+    @Before
+    fun setup() {
+        Dispatchers.setMain(testDispatcher)
+        repository = FakeTimerRepository()
+        tickEngine = FakeTimerTickEngine()
+    }
+    
+    @After
+    fun tearDown() {
+        Dispatchers.resetMain()
+    }
+    
+    private fun createDetailViewModel(timerId: String) = TimerDetailViewModel(
+        savedStateHandle = SavedStateHandle(mapOf("timerId" to timerId)),
+        getTimersUseCase = GetTimersUseCase(repository),
+        startTimerUseCase = StartTimerUseCase(repository),
+        pauseTimerUseCase = PauseTimerUseCase(repository),
+        resetTimerUseCase = ResetTimerUseCase(repository),
+        deleteTimerUseCase = DeleteTimerUseCase(repository),
+        repository = repository,
+        tickEngine = tickEngine
+    )
+    
+    private fun createListViewModel() = TimerListViewModel(
+        getTimersUseCase = GetTimersUseCase(repository),
+        startTimerUseCase = StartTimerUseCase(repository),
+        pauseTimerUseCase = PauseTimerUseCase(repository),
+        resetTimerUseCase = ResetTimerUseCase(repository),
+        deleteTimerUseCase = DeleteTimerUseCase(repository),
+        repository = repository,
+        tickEngine = tickEngine
+    )
+    
+    @Test
+    fun `detail shows the timer from the repository`() = runTest {
+        // Given
+        repository.addTimer(createTimer("1", TimerStatus.RUNNING))
+        
+        // When
+        val viewModel = createDetailViewModel("1")
+        testDispatcher.scheduler.runCurrent()
+        
+        // Then
+        val state = viewModel.uiState.value
+        assertThat(state.timer?.remainingSeconds).isEqualTo(300L)
+        assertThat(state.isLoading).isFalse()
+        assertThat(tickEngine.tracked["1"]).isEqualTo(300L to true)
+    }
+    
+    @Test
+    fun `unknown timer sets an error`() = runTest {
+        val viewModel = createDetailViewModel("missing")
+        testDispatcher.scheduler.runCurrent()
+        
+        assertThat(viewModel.uiState.value.errorMessage).isEqualTo("Timer not found")
+    }
+    
+    @Test
+    fun `detail counts down while the list consumes the ticks`() = runTest {
+        // Given - the list stays alive under the detail screen
+        repository.addTimer(createTimer("1", TimerStatus.RUNNING))
+        createListViewModel()
+        val detail = createDetailViewModel("1")
+        testDispatcher.scheduler.runCurrent()
+        
+        // When - the list polls first (every 250 ms) and takes the change
+        tickEngine.pendingChanges["1"] = 299L
+        testDispatcher.scheduler.advanceTimeBy(300)
+        testDispatcher.scheduler.runCurrent()
+        
+        // Then - the detail sees it through the repository
+        assertThat(detail.uiState.value.timer?.remainingSeconds).isEqualTo(299L)
+        
+        // A detail tick with nothing pending must not push the deadline back
+        testDispatcher.scheduler.advanceTimeBy(1000)
+        testDispatcher.scheduler.runCurrent()
+        assertThat(tickEngine.tracked["1"]).isEqualTo(299L to true)
+        assertThat(tickEngine.reanchored).isEmpty()
+    }
+    
+    @Test
+    fun `detail announces completion consumed by the list`() = runTest {
+        // Given
+        repository.addTimer(createTimer("1", TimerStatus.RUNNING))
+        createListViewModel()
+        val detail = createDetailViewModel("1")
+        testDispatcher.scheduler.runCurrent()
+        
+        detail.events.test {
+            // When
+            tickEngine.pendingChanges["1"] = 0L
+            testDispatcher.scheduler.advanceTimeBy(300)
+            testDispatcher.scheduler.runCurrent()
+            
+            // Then
+            assertThat(awaitItem()).isEqualTo(TimerDetailEvent.ShowMessage("Timer completed!"))
+            cancelAndIgnoreRemainingEvents()
+        }
+        assertThat(detail.uiState.value.timer?.status).isEqualTo(TimerStatus.COMPLETED)
+        assertThat(tickEngine.reanchored).isEmpty()
+    }
+    
+    @Test
+    fun `detail ticks on its own when the list is gone`() = runTest {
+        // Given
+        repository.addTimer(createTimer("1", TimerStatus.RUNNING))
+        val detail = createDetailViewModel("1")
+        testDispatcher.scheduler.runCurrent()
+        
+        // When
+        tickEngine.pendingChanges["1"] = 299L
+        testDispatcher.scheduler.advanceTimeBy(1001)
+        testDispatcher.scheduler.runCurrent()
+        
+        // Then
+        assertThat(detail.uiState.value.timer?.remainingSeconds).isEqualTo(299L)
+        assertThat(tickEngine.reanchored).isEmpty()
+    }
+    
+    private fun createTimer(id: String, status: TimerStatus) = CookingTimer(
+        id = id,
+        name = "Bread",
+        description = "Test",
+        durationSeconds = 300,
+        remainingSeconds = 300,
+        status = status
+    )
+}
@@ -1,7 +1,9 @@
 package com.eslam.bakingapp.features.cookingtimer.presentation.list
 
 import app.cash.turbine.test
+import com.eslam.bakingapp.core.common.result.Result
 import com.eslam.bakingapp.features.cookingtimer.data.repository.FakeTimerRepository
+import com.eslam.bakingapp.features.cookingtimer.data.repository.FakeTimerTickEngine
 import com.eslam.bakingapp.features.cookingtimer.domain.model.CookingTimer
 import com.eslam.bakingapp.features.cookingtimer.domain.model.TimerStatus
 import com.eslam.bakingapp.features.cookingtimer.domain.usecase.DeleteTimerUseCase
@@ -33,12 +35,14 @@ class TimerListViewModelTest {
     
     private val testDispatcher = StandardTestDispatcher()
     private lateinit var repository: FakeTimerRepository
+    private lateinit var tickEngine: FakeTimerTickEngine
     private lateinit var viewModel: TimerListViewModel
     
     @Before
     fun setup() {
         Dispatchers.setMain(testDispatcher)
         repository = FakeTimerRepository()
+        tickEngine = FakeTimerTickEngine()
     }
     
     @After
@@ -53,7 +57,8 @@ class TimerListViewModelTest {
             pauseTimerUseCase = PauseTimerUseCase(repository),
             resetTimerUseCase = ResetTimerUseCase(repository),
             deleteTimerUseCase = DeleteTimerUseCase(repository),
-            repository = repository
+            repository = repository,
+            tickEngine = tickEngine
         )
     }
     
@@ -183,6 +188,56 @@ class TimerListViewModelTest {
         assertThat(state.isLoading).isFalse()
     }
     
+    @Test
+    fun `loaded timers are mirrored into the tick engine`() = runTest {
+        // Given
+        repository.addTimer(createTimer("1", "Running", TimerStatus.RUNNING))
+        repository.addTimer(createTimer("2", "Idle", TimerStatus.IDLE))
+        
+        // When
+        viewModel = createViewModel()
+        testDispatcher.scheduler.runCurrent()
+        
+        // Then
+        assertThat(tickEngine.tracked["1"]).isEqualTo(300L to true)
+        assertThat(tickEngine.tracked["2"]).isEqualTo(300L to false)
+        
+        // Deleted timers stop being tracked
+        repository.deleteTimer("2")
+        testDispatcher.scheduler.runCurrent()
+        assertThat(tickEngine.tracked.keys).containsExactly("1")
+    }
+    
+    @Test
+    fun `tick writes back changed timers and completes finished ones`() = runTest {
+        // Given
+        repository.addTimer(createTimer("1", "Bread", TimerStatus.RUNNING))
+        repository.addTimer(createTimer("2", "Eggs", TimerStatus.RUNNING))
+        viewModel = createViewModel()
+        testDispatcher.scheduler.runCurrent()
+        
+        viewModel.events.test {
+            // When
+            tickEngine.pendingChanges["1"] = 120L
+            tickEngine.pendingChanges["2"] = 0L
+            testDispatcher.scheduler.advanceTimeBy(300)
+            testDispatcher.scheduler.runCurrent()
+            
+            // Then
+            val completed = awaitItem()
+            assertThat(completed).isInstanceOf(TimerListEvent.TimerCompleted::class.java)
+            assertThat((completed as TimerListEvent.TimerCompleted).timer.id).isEqualTo("2")
+            cancelAndIgnoreRemainingEvents()
+        }
+        
+        val bread = (repository.getTimerById("1") as Result.Success).data
+        val eggs = (repository.getTimerById("2") as Result.Success).data
+        assertThat(bread.remainingSeconds).isEqualTo(120L)
+        assertThat(bread.status).isEqualTo(TimerStatus.RUNNING)
+        assertThat(eggs.remainingSeconds).isEqualTo(0L)
+        assertThat(eggs.status).isEqualTo(TimerStatus.COMPLETED)
+    }
+    
     private fun createTimer(
         id: String,
         name: String,
@@ -1,9 +1,12 @@
 package com.eslam.bakingapp.features.home.data.datasource
 
+import com.eslam.bakingapp.core.network.model.RecipeListResponse
+import com.eslam.bakingapp.features.home.data.mapper.toRecipeListResponse
 import com.eslam.bakingapp.features.home.domain.model.Difficulty
 import com.eslam.bakingapp.features.home.domain.model.Ingredient
 import com.eslam.bakingapp.features.home.domain.model.Recipe
 import com.eslam.bakingapp.features.home.domain.model.Step
+import com.squareup.moshi.Moshi
 import kotlinx.coroutines.delay
 import javax.inject.Inject
 import javax.inject.Singleton
@@ -13,7 +16,9 @@ import javax.inject.Singleton
  * Used for demonstration and testing purposes.
  */
 @Singleton
-class FakeRecipeDataSource @Inject constructor() {
+class FakeRecipeDataSource @Inject constructor(
+    private val moshi: Moshi
+) {
     
     /**
      * Simulates network delay and returns fake recipes.
@@ -23,6 +28,21 @@ class FakeRecipeDataSource @Inject constructor() {
         return fakeRecipes
     }
     
+    /**
+     * Simulates network delay and returns the fake recipes as the raw
+     * RecipeListResponse body the API would send.
+     */
+    suspend fun getFakeRecipeListBody(): ByteArray {
+        delay(1000) // Simulate network delay
+        return fakeRecipeListBody
+    }
+    
+    private val fakeRecipeListBody: ByteArray by lazy {
+        moshi.adapter(RecipeListResponse::class.java)
+            .toJson(fakeRecipes.toRecipeListResponse())
+            .toByteArray(Charsets.UTF_8)
+    }
+    
     /**
      * Get a specific recipe by ID.
      */
@@ -1,16 +1,24 @@
 package com.eslam.bakingapp.features.home.data.mapper
 
+import com.eslam.bakingapp.core.database.bulk.RecipeBatch
 import com.eslam.bakingapp.core.database.entity.IngredientEntity
 import com.eslam.bakingapp.core.database.entity.RecipeEntity
 import com.eslam.bakingapp.core.database.entity.RecipeWithDetails
 import com.eslam.bakingapp.core.database.entity.StepEntity
 import com.eslam.bakingapp.core.network.model.IngredientDto
 import com.eslam.bakingapp.core.network.model.RecipeDto
+import com.eslam.bakingapp.core.network.model.RecipeListResponse
 import com.eslam.bakingapp.core.network.model.StepDto
+import com.eslam.bakingapp.core.security.search.FacetIndex
+import com.eslam.bakingapp.core.security.search.RecipeSearchIndex
+import com.eslam.bakingapp.core.security.sync.TimestampParser
 import com.eslam.bakingapp.features.home.domain.model.Difficulty
+import com.eslam.bakingapp.features.home.domain.model.FacetCounts
 import com.eslam.bakingapp.features.home.domain.model.Ingredient
 import com.eslam.bakingapp.features.home.domain.model.Recipe
+import com.eslam.bakingapp.features.home.domain.model.RecipeFilter
 import com.eslam.bakingapp.features.home.domain.model.Step
+import com.eslam.bakingapp.features.home.domain.model.TimeRange
 
 /**
  * Mappers for converting between data layer models and domain models.
@@ -144,5 +152,167 @@ fun StepDto.toEntity(recipeId: String): StepEntity {
     )
 }
 
+// ==================== Domain to DTO ====================
 
+fun Recipe.toDto(): RecipeDto {
+    return RecipeDto(
+        id = id,
+        name = name,
+        description = description,
+        imageUrl = imageUrl,
+        servings = servings,
+        prepTimeMinutes = prepTimeMinutes,
+        cookTimeMinutes = cookTimeMinutes,
+        difficulty = difficulty.toDisplayString(),
+        category = category,
+        ingredients = ingredients.map { IngredientDto(it.id, it.name, it.quantity, it.unit) },
+        steps = steps.map { StepDto(it.id, it.order, it.description, it.videoUrl, it.thumbnailUrl) },
+        createdAt = null,
+        updatedAt = null
+    )
+}
+
+fun List<Recipe>.toRecipeListResponse(): RecipeListResponse {
+    return RecipeListResponse(
+        recipes = map { it.toDto() },
+        totalCount = size,
+        page = 1,
+        totalPages = 1
+    )
+}
+
+// ==================== To Bulk Batch ====================
+
+/**
+ * Flattens a synced page straight into batch columns, without an entity
+ * object per row
+ *
+ * @param only if set, just the recipes with these ids (a delta sync)
+ * @param timestamps created_at and updated_at of each recipe, in response
+ *   order ([TimestampParser.parseRecords]); a recipe without a valid
+ *   created_at is stamped with the time of the sync
+ */
+fun RecipeListResponse.toRecipeBatch(
+    only: Set<String>? = null,
+    timestamps: LongArray? = null
+): RecipeBatch {
+    val batch = RecipeBatch(only?.size ?: recipes.size)
+    val stamps = timestamps?.takeIf { it.size == recipes.size * 2 }
+    val now = System.currentTimeMillis()
+    for ((index, recipe) in recipes.withIndex()) {
+        if (only != null && recipe.id !in only) continue
+        var createdAt = stamps?.get(index * 2) ?: TimestampParser.INVALID
+        var updatedAt = stamps?.get(index * 2 + 1) ?: TimestampParser.INVALID
+        if (createdAt == TimestampParser.INVALID) createdAt = now
+        if (updatedAt == TimestampParser.INVALID) updatedAt = createdAt
+        batch.addRecipe(
+            id = recipe.id,
+            name = recipe.name,
+            description = recipe.description,
+            imageUrl = recipe.imageUrl,
+            servings = recipe.servings,
+            prepTimeMinutes = recipe.prepTimeMinutes,
+            cookTimeMinutes = recipe.cookTimeMinutes,
+            difficulty = recipe.difficulty,
+            category = recipe.category,
+            createdAt = createdAt,
+            updatedAt = updatedAt
+        )
+        for (ingredient in recipe.ingredients) {
+            batch.addIngredient(recipe.id, ingredient.id, ingredient.name, ingredient.quantity, ingredient.unit)
+        }
+        for (step in recipe.steps) {
+            batch.addStep(recipe.id, step.id, step.order, step.description, step.videoUrl, step.thumbnailUrl)
+        }
+    }
+    return batch
+}
+
+fun List<Recipe>.toRecipeBatch(): RecipeBatch {
+    val batch = RecipeBatch(size)
+    for (recipe in this) {
+        batch.addRecipe(
+            id = recipe.id,
+            name = recipe.name,
+            description = recipe.description,
+            imageUrl = recipe.imageUrl,
+            servings = recipe.servings,
+            prepTimeMinutes = recipe.prepTimeMinutes,
+            cookTimeMinutes = recipe.cookTimeMinutes,
+            difficulty = recipe.difficulty.toDisplayString(),
+            category = recipe.category,
+            isFavorite = recipe.isFavorite
+        )
+        for (ingredient in recipe.ingredients) {
+            batch.addIngredient(recipe.id, ingredient.id, ingredient.name, ingredient.quantity, ingredient.unit)
+        }
+        for (step in recipe.steps) {
+            batch.addStep(recipe.id, step.id, step.order, step.description, step.videoUrl, step.thumbnailUrl)
+        }
+    }
+    return batch
+}
+
+// ==================== To Search Document ====================
+
+fun RecipeWithDetails.toSearchDocument(): RecipeSearchIndex.Document {
+    return RecipeSearchIndex.Document(
+        id = recipe.id,
+        name = recipe.name,
+        description = recipe.description,
+        ingredients = ingredients.map { it.name },
+        steps = steps.sortedBy { it.order }.map { it.description }
+    )
+}
+
+fun RecipeDto.toSearchDocument(): RecipeSearchIndex.Document {
+    return RecipeSearchIndex.Document(
+        id = id,
+        name = name,
+        description = description,
+        ingredients = ingredients.map { it.name },
+        steps = steps.map { it.description }
+    )
+}
+
+// ==================== To Facet Index ====================
+
+// Difficulties are indexed by enum name, so spellings the API mixes
+// ("easy", "Easy") count as one value; time ranges by ordinal, which
+// matches FacetIndex.TIME_BUCKET_LIMITS
+
+fun RecipeEntity.toFacetEntry(): FacetIndex.Entry {
+    return FacetIndex.Entry(
+        id = id,
+        category = category,
+        difficulty = Difficulty.fromString(difficulty).name,
+        isFavorite = isFavorite,
+        prepTimeMinutes = prepTimeMinutes,
+        cookTimeMinutes = cookTimeMinutes
+    )
+}
+
+fun RecipeFilter.toFacetFilter(): FacetIndex.Filter {
+    return FacetIndex.Filter(
+        categories = categories,
+        difficulties = difficulties.mapTo(HashSet()) { it.name },
+        favorite = favorite,
+        prepTimeBuckets = prepTimes.mapTo(HashSet()) { it.ordinal },
+        cookTimeBuckets = cookTimes.mapTo(HashSet()) { it.ordinal }
+    )
+}
+
+fun FacetIndex.Counts.toDomain(): FacetCounts {
+    return FacetCounts(
+        categories = categories.filterValues { it > 0 },
+        difficulties = difficulties.filterValues { it > 0 }
+            .mapKeys { (name, _) -> Difficulty.valueOf(name) },
+        favorites = favorites.filterValues { it > 0 },
+        prepTimes = prepTimeBuckets.toTimeRangeCounts(),
+        cookTimes = cookTimeBuckets.toTimeRangeCounts()
+    )
+}
 
+private fun List<Int>.toTimeRangeCounts(): Map<TimeRange, Int> {
+    return TimeRange.entries.zip(this).filter { (_, count) -> count > 0 }.toMap()
+}
@@ -1,17 +1,37 @@
 package com.eslam.bakingapp.features.home.data.repository
 
 import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.core.database.bulk.RecipeBulkLoader
 import com.eslam.bakingapp.core.database.dao.RecipeDao
+import com.eslam.bakingapp.core.network.model.RecipeListResponse
+import com.eslam.bakingapp.core.security.search.FacetIndex
+import com.eslam.bakingapp.core.security.search.IngredientIndex
+import com.eslam.bakingapp.core.security.search.RecipeSearchIndex
+import com.eslam.bakingapp.core.security.search.SimilarRecipeIndex
+import com.eslam.bakingapp.core.security.sync.RecipeDeltaSync
+import com.eslam.bakingapp.core.security.sync.TimestampParser
 import com.eslam.bakingapp.features.home.data.datasource.FakeRecipeDataSource
 import com.eslam.bakingapp.features.home.data.mapper.toDomain
+import com.eslam.bakingapp.features.home.data.mapper.toFacetEntry
+import com.eslam.bakingapp.features.home.data.mapper.toFacetFilter
+import com.eslam.bakingapp.features.home.data.mapper.toRecipeBatch
+import com.eslam.bakingapp.features.home.data.mapper.toSearchDocument
+import com.eslam.bakingapp.features.home.domain.model.FilteredRecipes
 import com.eslam.bakingapp.features.home.domain.model.Recipe
+import com.eslam.bakingapp.features.home.domain.model.RecipeFilter
+import com.eslam.bakingapp.features.home.domain.model.SimilarRecipe
+import com.eslam.bakingapp.features.home.domain.model.rankSimilar
 import com.eslam.bakingapp.features.home.domain.repository.RecipeRepository
+import com.squareup.moshi.Moshi
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.catch
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.flow.firstOrNull
 import kotlinx.coroutines.flow.flow
 import kotlinx.coroutines.flow.map
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import java.nio.ByteBuffer
 import javax.inject.Inject
 import javax.inject.Singleton
 
@@ -22,10 +42,52 @@ import javax.inject.Singleton
 @Singleton
 class RecipeRepositoryImpl @Inject constructor(
     private val recipeDao: RecipeDao,
-    private val fakeDataSource: FakeRecipeDataSource
+    private val bulkLoader: RecipeBulkLoader,
+    private val deltaSync: RecipeDeltaSync,
+    private val searchIndex: RecipeSearchIndex,
+    private val ingredientIndex: IngredientIndex,
+    private val facetIndex: FacetIndex,
+    private val similarIndex: SimilarRecipeIndex,
+    private val timestampParser: TimestampParser,
+    private val fakeDataSource: FakeRecipeDataSource,
+    moshi: Moshi
     // In production, inject: private val recipesApi: RecipesApi
 ) : RecipeRepository {
     
+    companion object {
+        private const val SEARCH_LIMIT = 200
+        private const val INGREDIENT_MATCH_LIMIT = 200
+        private const val FILTER_LIMIT = 200
+        private const val RECIPES_KEY = "recipes"
+        private val TIMESTAMP_FIELDS = listOf("created_at", "updated_at")
+    }
+    
+    private val recipeListAdapter = moshi.adapter(RecipeListResponse::class.java)
+    
+    // The search index is built from the database on the first search and
+    // kept in step with every write after that
+    private val searchIndexLock = Mutex()
+    @Volatile
+    private var searchIndexBuilt = false
+    
+    // The ingredient index is loaded from its saved copy (or rebuilt from
+    // the database) on first use and saved again after every write
+    private val ingredientIndexLock = Mutex()
+    @Volatile
+    private var ingredientIndexReady = false
+    
+    // The facet index, like the search index, is built from the database
+    // on the first filter and kept in step with every write after that
+    private val facetIndexLock = Mutex()
+    @Volatile
+    private var facetIndexBuilt = false
+    
+    // The similar-recipe index, likewise, is built on the first lookup and
+    // its signatures updated recipe by recipe on every sync after that
+    private val similarIndexLock = Mutex()
+    @Volatile
+    private var similarIndexBuilt = false
+    
     override fun getRecipes(): Flow<Result<List<Recipe>>> = flow {
         emit(Result.Loading)
         
@@ -36,8 +98,14 @@ class RecipeRepositoryImpl @Inject constructor(
                 if (recipes.isEmpty()) {
                     // If empty, load fake data
                     val fakeRecipes = fakeDataSource.getFakeRecipes()
-                    // Save to database
-                    recipeDao.insertRecipes(fakeRecipes.map { it.toEntity() })
+                    // Save to database, ingredients and steps included; the
+                    // delta baseline no longer matches what is stored
+                    deltaSync.reset()
+                    bulkLoader.load(fakeRecipes.toRecipeBatch())
+                    searchIndexBuilt = false
+                    facetIndexBuilt = false
+                    similarIndexBuilt = false
+                    invalidateIngredientIndex()
                     emit(Result.Success(fakeRecipes))
                 } else {
                     emit(Result.Success(recipes))
@@ -68,10 +136,61 @@ class RecipeRepositoryImpl @Inject constructor(
         emit(Result.Error(e as Exception))
     }
     
+    /**
+     * Ranked by the native search index when it is available, which also
+     * matches ingredients and steps; LIKE on name and description otherwise
+     */
     override fun searchRecipes(query: String): Flow<Result<List<Recipe>>> = flow {
         emit(Result.Loading)
         
-        recipeDao.searchRecipes(query)
+        val rankedIds = searchRanked(query)
+        if (rankedIds == null) {
+            recipeDao.searchRecipes(query)
+                .map { entities -> entities.map { it.toDomain() } }
+                .collect { recipes ->
+                    emit(Result.Success(recipes))
+                }
+            return@flow
+        }
+        recipeDao.getRecipesByIds(rankedIds)
+            .map { entities ->
+                val byId = entities.associateBy { it.id }
+                rankedIds.mapNotNull { id -> byId[id]?.toDomain() }
+            }
+            .collect { recipes ->
+                emit(Result.Success(recipes))
+            }
+    }.catch { e ->
+        emit(Result.Error(e as Exception))
+    }
+    
+    /**
+     * Recipes using every ingredient in [include] and none in [exclude],
+     * from the native ingredient index when it is available; a scan of
+     * every recipe's ingredients otherwise
+     */
+    override fun findRecipesByIngredients(
+        include: List<String>,
+        exclude: List<String>
+    ): Flow<Result<List<Recipe>>> = flow {
+        emit(Result.Loading)
+        
+        val matchedIds = if (ensureIngredientIndex()) {
+            ingredientIndex.findRecipes(include, exclude, INGREDIENT_MATCH_LIMIT)
+        } else {
+            null
+        }
+        if (matchedIds == null) {
+            val recipes = recipeDao.getAllRecipesWithDetails().first()
+                .map { it.toDomain() }
+                .filter { recipe ->
+                    include.all { recipe.usesIngredient(it) } &&
+                        exclude.none { recipe.usesIngredient(it) }
+                }
+            emit(Result.Success(recipes.take(INGREDIENT_MATCH_LIMIT)))
+            return@flow
+        }
+        recipeDao.getRecipesByIds(matchedIds)
             .map { entities -> entities.map { it.toDomain() } }
             .collect { recipes ->
                 emit(Result.Success(recipes))
@@ -104,11 +223,72 @@ class RecipeRepositoryImpl @Inject constructor(
         emit(Result.Error(e as Exception))
     }
     
+    /**
+     * Evaluated by the native facet index when it is available, which
+     * counts every facet in the same pass; filtered and counted over every
+     * recipe otherwise
+     */
+    override fun filterRecipes(filter: RecipeFilter): Flow<Result<FilteredRecipes>> = flow {
+        emit(Result.Loading)
+        
+        val evaluation = evaluateFacets(filter)
+        if (evaluation == null) {
+            val recipes = recipeDao.getAllRecipes().first().map { it.toDomain() }
+            emit(Result.Success(filter.applyTo(recipes, FILTER_LIMIT)))
+            return@flow
+        }
+        val byId = recipeDao.getRecipesByIds(evaluation.ids).first().associateBy { it.id }
+        emit(
+            Result.Success(
+                FilteredRecipes(
+                    recipes = evaluation.ids.mapNotNull { id -> byId[id]?.toDomain() },
+                    total = evaluation.total.toInt(),
+                    counts = evaluation.counts.toDomain()
+                )
+            )
+        )
+    }.catch { e ->
+        emit(Result.Error(e as Exception))
+    }
+    
+    /**
+     * Ranked by the native similar-recipe index when it is available, which
+     * only scores the recipes sharing a MinHash band with this one; by exact
+     * similarity to every recipe otherwise
+     */
+    override fun getSimilarRecipes(
+        recipeId: String,
+        limit: Int
+    ): Flow<Result<List<SimilarRecipe>>> = flow {
+        emit(Result.Loading)
+        
+        val matches = findSimilar(recipeId, limit)
+        if (matches == null) {
+            val recipes = recipeDao.getAllRecipesWithDetails().first().map { it.toDomain() }
+            val recipe = recipes.find { it.id == recipeId }
+            emit(Result.Success(recipe?.rankSimilar(recipes, limit).orEmpty()))
+            return@flow
+        }
+        val byId = recipeDao.getRecipesByIds(matches.map { it.id }).first().associateBy { it.id }
+        emit(
+            Result.Success(
+                matches.mapNotNull { match ->
+                    byId[match.id]?.let { SimilarRecipe(it.toDomain(), match.similarity) }
+                }
+            )
+        )
+    }.catch { e ->
+        emit(Result.Error(e as Exception))
+    }
+    
     override suspend fun toggleFavorite(recipeId: String): Result<Unit> {
         return try {
             val entity = recipeDao.getRecipeById(recipeId).firstOrNull()
             if (entity != null) {
                 recipeDao.updateFavoriteStatus(recipeId, !entity.isFavorite)
+                facetIndexLock.withLock {
+                    if (facetIndexBuilt) facetIndex.setFavorite(recipeId, !entity.isFavorite)
+                }
                 Result.Success(Unit)
             } else {
                 Result.Error(NoSuchElementException("Recipe not found"), "Recipe not found")
@@ -118,30 +298,205 @@ class RecipeRepositoryImpl @Inject constructor(
         }
     }
     
+    /**
+     * Writes only what changed since the last refresh: recipes whose raw
+     * JSON hashes the same as last time are skipped, and when nothing
+     * changed no transaction runs, so observers are not re-notified.
+     */
     override suspend fun refreshRecipes(): Result<Unit> {
         return try {
-            // In production, fetch from API and update database
-            // For now, use fake data
-            val fakeRecipes = fakeDataSource.getFakeRecipes()
-            recipeDao.insertRecipes(fakeRecipes.map { it.toEntity() })
+            // In production, fetch the raw body from the API (one page at a
+            // time). For now, use fake data
+            val body = fakeDataSource.getFakeRecipeListBody()
+            val response = recipeListAdapter.fromJson(String(body, Charsets.UTF_8))
+                ?: return Result.Error(IllegalStateException("Empty recipe list"))
+            
+            // Every created_at/updated_at in the page, in one native pass
+            // over the body when possible
+            val timestamps = timestampParser.parseRecords(body, RECIPES_KEY, TIMESTAMP_FIELDS)
+                ?: timestampParser.parse(response.recipes.flatMap { listOf(it.createdAt, it.updatedAt) })
+            
+            val delta = deltaSync.diff(ByteBuffer.wrap(body))
+            if (delta == null) {
+                deltaSync.reset()
+                bulkLoader.load(response.toRecipeBatch(timestamps = timestamps))
+                searchIndexBuilt = false
+                facetIndexBuilt = false
+                similarIndexBuilt = false
+                invalidateIngredientIndex()
+                return Result.Success(Unit)
+            }
+            // The baseline follows the database: it moves once the rows are
+            // written, whatever happens after, and is rolled back otherwise
+            var written = delta.isEmpty
+            try {
+                if (!delta.isEmpty) {
+                    // Changed recipes are deleted first so rows their new
+                    // version dropped do not linger
+                    bulkLoader.load(
+                        response.toRecipeBatch(only = delta.upserts, timestamps = timestamps),
+                        removedRecipeIds = delta.deleted + delta.changed
+                    )
+                    written = true
+                    try {
+                        updateSearchIndex(response, delta)
+                        updateIngredientIndex(response, delta)
+                        updateFacetIndex(delta)
+                        updateSimilarIndex(response, delta)
+                    } catch (e: Exception) {
+                        // Rebuilt from the database on next use
+                        searchIndexBuilt = false
+                        facetIndexBuilt = false
+                        similarIndexBuilt = false
+                        invalidateIngredientIndex()
+                        throw e
+                    }
+                }
+            } finally {
+                if (written) deltaSync.commit() else deltaSync.abort()
+            }
             Result.Success(Unit)
         } catch (e: Exception) {
             Result.Error(e)
         }
     }
     
-    // Extension function for mapping to entity
-    private fun Recipe.toEntity() = com.eslam.bakingapp.core.database.entity.RecipeEntity(
-        id = id,
-        name = name,
-        description = description,
-        imageUrl = imageUrl,
-        servings = servings,
-        prepTimeMinutes = prepTimeMinutes,
-        cookTimeMinutes = cookTimeMinutes,
-        difficulty = difficulty.toDisplayString(),
-        category = category,
-        isFavorite = isFavorite
-    )
+    private suspend fun searchRanked(query: String): List<String>? {
+        if (!searchIndex.isAvailable()) return null
+        if (!searchIndexBuilt) {
+            searchIndexLock.withLock {
+                if (!searchIndexBuilt) {
+                    val recipes = recipeDao.getAllRecipesWithDetails().first()
+                    searchIndex.clear()
+                    searchIndex.add(recipes.map { it.toSearchDocument() })
+                    searchIndexBuilt = true
+                }
+            }
+        }
+        return searchIndex.search(query, SEARCH_LIMIT)
+    }
+    
+    private suspend fun updateSearchIndex(response: RecipeListResponse, delta: RecipeDeltaSync.Delta) {
+        searchIndexLock.withLock {
+            if (!searchIndexBuilt) return
+            searchIndex.remove(delta.deleted)
+            val upserts = delta.upserts
+            searchIndex.add(response.recipes.filter { it.id in upserts }.map { it.toSearchDocument() })
+        }
+    }
+    
+    private suspend fun evaluateFacets(filter: RecipeFilter): FacetIndex.Evaluation? {
+        if (!facetIndex.isAvailable()) return null
+        return facetIndexLock.withLock {
+            if (!facetIndexBuilt) {
+                val recipes = recipeDao.getAllRecipes().first()
+                facetIndex.clear()
+                facetIndex.update(recipes.map { it.toFacetEntry() })
+                facetIndexBuilt = true
+            }
+            facetIndex.evaluate(filter.toFacetFilter(), FILTER_LIMIT)
+        }
+    }
+    
+    /**
+     * Reads the upserted recipes back from the database rather than the
+     * response, which has no favorite status
+     */
+    private suspend fun updateFacetIndex(delta: RecipeDeltaSync.Delta) {
+        facetIndexLock.withLock {
+            if (!facetIndexBuilt) return
+            val upserts = recipeDao.getRecipesByIds(delta.upserts.toList()).first()
+            facetIndex.update(upserts.map { it.toFacetEntry() }, removedIds = delta.deleted)
+        }
+    }
+    
+    private suspend fun findSimilar(recipeId: String, limit: Int): List<SimilarRecipeIndex.Match>? {
+        if (!similarIndex.isAvailable()) return null
+        return similarIndexLock.withLock {
+            if (!similarIndexBuilt) {
+                val recipes = recipeDao.getAllRecipesWithDetails().first()
+                similarIndex.clear()
+                similarIndex.update(
+                    recipes.associate { details ->
+                        details.recipe.id to details.ingredients.map { it.name }
+                    }
+                )
+                similarIndexBuilt = true
+            }
+            similarIndex.findSimilar(recipeId, limit, SimilarRecipe.MIN_SIMILARITY)
+        }
+    }
+    
+    /**
+     * Re-signs only the recipes the sync changed
+     */
+    private suspend fun updateSimilarIndex(
+        response: RecipeListResponse,
+        delta: RecipeDeltaSync.Delta
+    ) {
+        similarIndexLock.withLock {
+            if (!similarIndexBuilt) return
+            val upserts = delta.upserts
+            similarIndex.update(
+                response.recipes
+                    .filter { it.id in upserts }
+                    .associate { recipe -> recipe.id to recipe.ingredients.map { it.name } },
+                removedIds = delta.deleted
+            )
+        }
+    }
+    
+    /**
+     * @return false if the native index is unavailable
+     */
+    private suspend fun ensureIngredientIndex(): Boolean {
+        if (!ingredientIndex.isAvailable()) return false
+        if (!ingredientIndexReady) {
+            ingredientIndexLock.withLock {
+                if (!ingredientIndexReady) {
+                    if (!ingredientIndex.load()) {
+                        val recipes = recipeDao.getAllRecipesWithDetails().first()
+                        ingredientIndex.clear()
+                        ingredientIndex.update(
+                            recipes.associate { details ->
+                                details.recipe.id to details.ingredients.map { it.name }
+                            }
+                        )
+                    }
+                    ingredientIndexReady = true
+                }
+            }
+        }
+        return true
+    }
+    
+    private suspend fun invalidateIngredientIndex() {
+        ingredientIndexLock.withLock {
+            ingredientIndex.clear()
+            ingredientIndexReady = false
+        }
+    }
+    
+    /**
+     * Applied even before the first ingredient query: the saved index has
+     * to stay in step with the database across restarts
+     */
+    private suspend fun updateIngredientIndex(
+        response: RecipeListResponse,
+        delta: RecipeDeltaSync.Delta
+    ) {
+        if (!ensureIngredientIndex()) return
+        ingredientIndexLock.withLock {
+            val upserts = delta.upserts
+            ingredientIndex.update(
+                response.recipes
+                    .filter { it.id in upserts }
+                    .associate { recipe -> recipe.id to recipe.ingredients.map { it.name } },
+                removedIds = delta.deleted
+            )
+        }
+    }
+    
+    private fun Recipe.usesIngredient(name: String): Boolean =
+        ingredients.any { it.name.contains(name, ignoreCase = true) }
 }
-
@@ -0,0 +1,87 @@
+package com.eslam.bakingapp.features.home.domain.model
+
+/**
+ * Recipe filter over category, difficulty, favorite status and time.
+ * An empty set, or a null [favorite], accepts every value; a recipe
+ * matches when every facet accepts it.
+ */
+data class RecipeFilter(
+    val categories: Set<String> = emptySet(),
+    val difficulties: Set<Difficulty> = emptySet(),
+    val favorite: Boolean? = null,
+    val prepTimes: Set<TimeRange> = emptySet(),
+    val cookTimes: Set<TimeRange> = emptySet()
+) {
+    fun matches(recipe: Recipe): Boolean {
+        return (categories.isEmpty() || recipe.category in categories) &&
+            (difficulties.isEmpty() || recipe.difficulty in difficulties) &&
+            (favorite == null || recipe.isFavorite == favorite) &&
+            (prepTimes.isEmpty() || TimeRange.of(recipe.prepTimeMinutes) in prepTimes) &&
+            (cookTimes.isEmpty() || TimeRange.of(recipe.cookTimeMinutes) in cookTimes)
+    }
+
+    /**
+     * Filters [recipes] and counts every facet value
+     */
+    fun applyTo(recipes: List<Recipe>, limit: Int = Int.MAX_VALUE): FilteredRecipes {
+        val matching = recipes.filter { matches(it) }
+        fun <K> countBy(unfiltered: RecipeFilter, key: (Recipe) -> K): Map<K, Int> =
+            recipes.filter { unfiltered.matches(it) }.groupingBy(key).eachCount()
+        
+        return FilteredRecipes(
+            recipes = matching.take(limit),
+            total = matching.size,
+            counts = FacetCounts(
+                categories = countBy(copy(categories = emptySet())) { it.category },
+                difficulties = countBy(copy(difficulties = emptySet())) { it.difficulty },
+                favorites = countBy(copy(favorite = null)) { it.isFavorite },
+                prepTimes = countBy(copy(prepTimes = emptySet())) { TimeRange.of(it.prepTimeMinutes) },
+                cookTimes = countBy(copy(cookTimes = emptySet())) { TimeRange.of(it.cookTimeMinutes) }
+            )
+        )
+    }
+}
+
+/**
+ * Prep or cook time buckets; [maxMinutes] is inclusive, null for the
+ * open-ended last one.
+ */
+enum class TimeRange(val maxMinutes: Int?) {
+    UP_TO_10(10),
+    UP_TO_20(20),
+    UP_TO_30(30),
+    UP_TO_45(45),
+    UP_TO_60(60),
+    UP_TO_90(90),
+    UP_TO_120(120),
+    OVER_120(null);
+
+    companion object {
+        fun of(minutes: Int): TimeRange {
+            return entries.first { it.maxMinutes == null || minutes <= it.maxMinutes }
+        }
+    }
+}
+
+/**
+ * Per facet value, the recipes that would match if that facet alone were
+ * not filtered: the number shown next to each choice. Values without any
+ * are left out.
+ */
+data class FacetCounts(
+    val categories: Map<String, Int>,
+    val difficulties: Map<Difficulty, Int>,
+    val favorites: Map<Boolean, Int>,
+    val prepTimes: Map<TimeRange, Int>,
+    val cookTimes: Map<TimeRange, Int>
+)
+
+/**
+ * The first page of recipes matching a [RecipeFilter], how many match in
+ * all, and the counts for every facet.
+ */
+data class FilteredRecipes(
+    val recipes: List<Recipe>,
+    val total: Int,
+    val counts: FacetCounts
+)
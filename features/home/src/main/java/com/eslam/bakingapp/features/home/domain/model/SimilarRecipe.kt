@@ -0,0 +1,51 @@
+package com.eslam.bakingapp.features.home.domain.model
+
+/**
+ * A recipe suggested for another, with the share of their ingredients
+ * they have in common: the Jaccard similarity of the two ingredient lists,
+ * from 0 (nothing shared) to 1 (the same ingredients).
+ */
+data class SimilarRecipe(
+    val recipe: Recipe,
+    val similarity: Float
+) {
+    companion object {
+        /**
+         * Below it, recipes share too little to be worth suggesting
+         */
+        const val MIN_SIMILARITY = 0.1f
+    }
+}
+
+/**
+ * Exact Jaccard similarity of the two recipes' ingredient names, compared
+ * trimmed and ignoring case; 0 when either has no ingredients
+ */
+fun Recipe.ingredientSimilarity(other: Recipe): Float {
+    val mine = ingredientKeys()
+    val theirs = other.ingredientKeys()
+    if (mine.isEmpty() || theirs.isEmpty()) return 0f
+    val shared = mine.count { it in theirs }
+    return shared.toFloat() / (mine.size + theirs.size - shared)
+}
+
+/**
+ * Up to [limit] of [candidates] at least [minSimilarity] similar to this
+ * recipe, most similar first; compares against every candidate
+ */
+fun Recipe.rankSimilar(
+    candidates: List<Recipe>,
+    limit: Int,
+    minSimilarity: Float = SimilarRecipe.MIN_SIMILARITY
+): List<SimilarRecipe> {
+    return candidates.asSequence()
+        .filter { it.id != id }
+        .map { SimilarRecipe(it, ingredientSimilarity(it)) }
+        .filter { it.similarity >= minSimilarity }
+        .sortedByDescending { it.similarity }
+        .take(limit)
+        .toList()
+}
+
+private fun Recipe.ingredientKeys(): Set<String> =
+    ingredients.mapTo(HashSet()) { it.name.trim().lowercase() }
@@ -1,7 +1,10 @@
 package com.eslam.bakingapp.features.home.domain.repository
 
 import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.features.home.domain.model.FilteredRecipes
 import com.eslam.bakingapp.features.home.domain.model.Recipe
+import com.eslam.bakingapp.features.home.domain.model.RecipeFilter
+import com.eslam.bakingapp.features.home.domain.model.SimilarRecipe
 import kotlinx.coroutines.flow.Flow
 
 /**
@@ -25,6 +28,14 @@ interface RecipeRepository {
      */
     fun searchRecipes(query: String): Flow<Result<List<Recipe>>>
     
+    /**
+     * Get recipes that use every ingredient in [include] and none in [exclude].
+     */
+    fun findRecipesByIngredients(
+        include: List<String>,
+        exclude: List<String> = emptyList()
+    ): Flow<Result<List<Recipe>>>
+    
     /**
      * Get recipes by category.
      */
@@ -35,6 +46,16 @@ interface RecipeRepository {
      */
     fun getFavoriteRecipes(): Flow<Result<List<Recipe>>>
     
+    /**
+     * Get recipes matching [filter], with the counts for every facet value.
+     */
+    fun filterRecipes(filter: RecipeFilter): Flow<Result<FilteredRecipes>>
+    
+    /**
+     * Get up to [limit] recipes sharing the most ingredients with [recipeId], most similar first.
+     */
+    fun getSimilarRecipes(recipeId: String, limit: Int = 10): Flow<Result<List<SimilarRecipe>>>
+    
     /**
      * Toggle favorite status for a recipe.
      */
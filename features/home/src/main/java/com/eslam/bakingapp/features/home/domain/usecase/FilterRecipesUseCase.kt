@@ -0,0 +1,24 @@
+package com.eslam.bakingapp.features.home.domain.usecase
+
+import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.features.home.domain.model.FilteredRecipes
+import com.eslam.bakingapp.features.home.domain.model.RecipeFilter
+import com.eslam.bakingapp.features.home.domain.repository.RecipeRepository
+import kotlinx.coroutines.flow.Flow
+import javax.inject.Inject
+
+/**
+ * Use case for filtering recipes by category, difficulty, favorite status
+ * and time, with live counts for every choice.
+ */
+class FilterRecipesUseCase @Inject constructor(
+    private val recipeRepository: RecipeRepository
+) {
+    /**
+     * Filter recipes and count every facet value. Blank categories are ignored.
+     */
+    operator fun invoke(filter: RecipeFilter = RecipeFilter()): Flow<Result<FilteredRecipes>> {
+        val categories = filter.categories.map { it.trim() }.filterTo(HashSet()) { it.isNotEmpty() }
+        return recipeRepository.filterRecipes(filter.copy(categories = categories))
+    }
+}
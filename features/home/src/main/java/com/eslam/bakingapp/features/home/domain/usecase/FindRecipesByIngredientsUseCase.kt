@@ -0,0 +1,28 @@
+package com.eslam.bakingapp.features.home.domain.usecase
+
+import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.features.home.domain.model.Recipe
+import com.eslam.bakingapp.features.home.domain.repository.RecipeRepository
+import kotlinx.coroutines.flow.Flow
+import javax.inject.Inject
+
+/**
+ * Use case for finding what can be cooked with the ingredients at hand.
+ */
+class FindRecipesByIngredientsUseCase @Inject constructor(
+    private val recipeRepository: RecipeRepository
+) {
+    /**
+     * Find recipes using every ingredient in [include] and none in [exclude].
+     * Blank entries are ignored.
+     */
+    operator fun invoke(
+        include: List<String>,
+        exclude: List<String> = emptyList()
+    ): Flow<Result<List<Recipe>>> {
+        return recipeRepository.findRecipesByIngredients(
+            include.map { it.trim() }.filter { it.isNotEmpty() },
+            exclude.map { it.trim() }.filter { it.isNotEmpty() }
+        )
+    }
+}
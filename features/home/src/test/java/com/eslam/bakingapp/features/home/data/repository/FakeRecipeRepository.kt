@@ -2,8 +2,12 @@ package com.eslam.bakingapp.features.home.data.repository
 
 import com.eslam.bakingapp.core.common.result.Result
 import com.eslam.bakingapp.features.home.domain.model.Difficulty
+import com.eslam.bakingapp.features.home.domain.model.FilteredRecipes
 import com.eslam.bakingapp.features.home.domain.model.Ingredient
 import com.eslam.bakingapp.features.home.domain.model.Recipe
+import com.eslam.bakingapp.features.home.domain.model.RecipeFilter
+import com.eslam.bakingapp.features.home.domain.model.SimilarRecipe
+import com.eslam.bakingapp.features.home.domain.model.rankSimilar
 import com.eslam.bakingapp.features.home.domain.model.Step
 import com.eslam.bakingapp.features.home.domain.repository.RecipeRepository
 import kotlinx.coroutines.flow.Flow
@@ -59,6 +63,21 @@ class FakeRecipeRepository : RecipeRepository {
         }
     }
     
+    override fun findRecipesByIngredients(
+        include: List<String>,
+        exclude: List<String>
+    ): Flow<Result<List<Recipe>>> = flow {
+        emit(Result.Loading)
+        if (shouldReturnError) {
+            emit(Result.Error(Exception(errorMessage), errorMessage))
+        } else {
+            val filtered = recipes.filter { recipe ->
+                include.all { recipe.usesIngredient(it) } && exclude.none { recipe.usesIngredient(it) }
+            }
+            emit(Result.Success(filtered))
+        }
+    }
+    
     override fun getRecipesByCategory(category: String): Flow<Result<List<Recipe>>> = flow {
         emit(Result.Loading)
         if (shouldReturnError) {
@@ -79,6 +98,28 @@ class FakeRecipeRepository : RecipeRepository {
         }
     }
     
+    override fun filterRecipes(filter: RecipeFilter): Flow<Result<FilteredRecipes>> = flow {
+        emit(Result.Loading)
+        if (shouldReturnError) {
+            emit(Result.Error(Exception(errorMessage), errorMessage))
+        } else {
+            emit(Result.Success(filter.applyTo(recipes.toList())))
+        }
+    }
+    
+    override fun getSimilarRecipes(
+        recipeId: String,
+        limit: Int
+    ): Flow<Result<List<SimilarRecipe>>> = flow {
+        emit(Result.Loading)
+        if (shouldReturnError) {
+            emit(Result.Error(Exception(errorMessage), errorMessage))
+        } else {
+            val recipe = recipes.find { it.id == recipeId }
+            emit(Result.Success(recipe?.rankSimilar(recipes.toList(), limit).orEmpty()))
+        }
+    }
+    
     override suspend fun toggleFavorite(recipeId: String): Result<Unit> {
         if (shouldReturnError) {
             return Result.Error(Exception(errorMessage), errorMessage)
@@ -99,6 +140,9 @@ class FakeRecipeRepository : RecipeRepository {
         return Result.Success(Unit)
     }
     
+    private fun Recipe.usesIngredient(name: String): Boolean =
+        ingredients.any { it.name.contains(name, ignoreCase = true) }
+    
     // Helper methods for testing
     fun addRecipe(recipe: Recipe) {
         recipes.add(recipe)
@@ -0,0 +1,44 @@
+package com.eslam.bakingapp.features.home.domain.model
+
+import com.eslam.bakingapp.features.home.data.repository.FakeRecipeRepository
+import com.google.common.truth.Truth.assertThat
+import org.junit.Test
+
+class SimilarRecipeTest {
+    
+    private fun recipe(id: String, vararg ingredients: String): Recipe =
+        FakeRecipeRepository.createFakeRecipe(id, "Recipe $id", "Test").copy(
+            ingredients = ingredients.mapIndexed { i, name -> Ingredient("$i", name, 1.0, "cup") }
+        )
+    
+    @Test
+    fun `ingredientSimilarity is shared over distinct ingredients`() {
+        val sponge = recipe("1", "Flour", "Sugar", "Butter", "Eggs")
+        val shortbread = recipe("2", "flour ", "SUGAR", "Butter")
+        val pizza = recipe("3", "Flour", "Yeast", "Water", "Salt", "Tomato")
+        
+        assertThat(sponge.ingredientSimilarity(shortbread)).isEqualTo(0.75f)
+        assertThat(sponge.ingredientSimilarity(pizza)).isEqualTo(1f / 8)
+        assertThat(sponge.ingredientSimilarity(recipe("4"))).isEqualTo(0f)
+    }
+    
+    @Test
+    fun `rankSimilar orders by similarity and leaves out the recipe itself`() {
+        val sponge = recipe("1", "Flour", "Sugar", "Butter", "Eggs")
+        val candidates = listOf(
+            sponge,
+            recipe("2", "Flour", "Yeast", "Water", "Salt", "Tomato"),
+            recipe("3", "Flour", "Sugar", "Butter"),
+            recipe("4", "Flour", "Sugar", "Butter", "Eggs", "Milk"),
+            recipe("5", "Rice", "Water")
+        )
+        
+        val ranked = sponge.rankSimilar(candidates, limit = 10)
+        assertThat(ranked.map { it.recipe.id }).containsExactly("4", "3", "2").inOrder()
+        assertThat(ranked.first().similarity).isEqualTo(0.8f)
+        assertThat(sponge.rankSimilar(candidates, limit = 1).map { it.recipe.id })
+            .containsExactly("4")
+        assertThat(sponge.rankSimilar(candidates, limit = 10, minSimilarity = 0.5f))
+            .hasSize(2)
+    }
+}
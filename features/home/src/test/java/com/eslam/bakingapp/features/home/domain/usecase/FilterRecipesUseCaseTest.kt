@@ -0,0 +1,83 @@
+package com.eslam.bakingapp.features.home.domain.usecase
+
+import app.cash.turbine.test
+import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.features.home.data.repository.FakeRecipeRepository
+import com.eslam.bakingapp.features.home.domain.model.Difficulty
+import com.eslam.bakingapp.features.home.domain.model.RecipeFilter
+import com.eslam.bakingapp.features.home.domain.model.TimeRange
+import com.google.common.truth.Truth.assertThat
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.test.runTest
+import org.junit.Before
+import org.junit.Test
+
+@OptIn(ExperimentalCoroutinesApi::class)
+class FilterRecipesUseCaseTest {
+    
+    private lateinit var filterRecipesUseCase: FilterRecipesUseCase
+    private lateinit var fakeRepository: FakeRecipeRepository
+    
+    @Before
+    fun setup() {
+        fakeRepository = FakeRecipeRepository()
+        fakeRepository.addRecipe(
+            FakeRecipeRepository.createFakeRecipe("4", "Shortbread", "Cookies", isFavorite = true)
+                .copy(difficulty = Difficulty.EASY, prepTimeMinutes = 10)
+        )
+        filterRecipesUseCase = FilterRecipesUseCase(fakeRepository)
+    }
+    
+    @Test
+    fun `no filter matches every recipe and counts each value`() = runTest {
+        filterRecipesUseCase().test {
+            assertThat(awaitItem()).isEqualTo(Result.Loading)
+            
+            val success = awaitItem()
+            assertThat(success).isInstanceOf(Result.Success::class.java)
+            val filtered = (success as Result.Success).data
+            assertThat(filtered.total).isEqualTo(4)
+            assertThat(filtered.counts.categories)
+                .containsExactly("Cookies", 2, "Cupcakes", 1, "Bread", 1)
+            assertThat(filtered.counts.favorites).containsExactly(false, 3, true, 1)
+            assertThat(filtered.counts.prepTimes)
+                .containsExactly(TimeRange.UP_TO_10, 1, TimeRange.UP_TO_20, 3)
+            
+            awaitComplete()
+        }
+    }
+    
+    @Test
+    fun `each facet is counted against the other facets only`() = runTest {
+        val filter = RecipeFilter(categories = setOf(" Cookies "), favorite = true)
+        filterRecipesUseCase(filter).test {
+            assertThat(awaitItem()).isEqualTo(Result.Loading)
+            
+            val success = awaitItem()
+            assertThat(success).isInstanceOf(Result.Success::class.java)
+            val filtered = (success as Result.Success).data
+            assertThat(filtered.recipes.map { it.id }).containsExactly("4")
+            assertThat(filtered.counts.categories).containsExactly("Cookies", 1)
+            assertThat(filtered.counts.favorites).containsExactly(false, 1, true, 1)
+            assertThat(filtered.counts.difficulties).containsExactly(Difficulty.EASY, 1)
+            
+            awaitComplete()
+        }
+    }
+    
+    @Test
+    fun `filter returns error when repository fails`() = runTest {
+        fakeRepository.shouldReturnError = true
+        fakeRepository.errorMessage = "Filter failed"
+        
+        filterRecipesUseCase(RecipeFilter(difficulties = setOf(Difficulty.HARD))).test {
+            assertThat(awaitItem()).isEqualTo(Result.Loading)
+            
+            val error = awaitItem()
+            assertThat(error).isInstanceOf(Result.Error::class.java)
+            assertThat((error as Result.Error).message).isEqualTo("Filter failed")
+            
+            awaitComplete()
+        }
+    }
+}
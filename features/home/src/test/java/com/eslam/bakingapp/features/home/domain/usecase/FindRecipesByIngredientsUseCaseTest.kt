@@ -0,0 +1,88 @@
+package com.eslam.bakingapp.features.home.domain.usecase
+
+import app.cash.turbine.test
+import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.features.home.data.repository.FakeRecipeRepository
+import com.eslam.bakingapp.features.home.domain.model.Ingredient
+import com.google.common.truth.Truth.assertThat
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.test.runTest
+import org.junit.Before
+import org.junit.Test
+
+@OptIn(ExperimentalCoroutinesApi::class)
+class FindRecipesByIngredientsUseCaseTest {
+    
+    private lateinit var findRecipesByIngredientsUseCase: FindRecipesByIngredientsUseCase
+    private lateinit var fakeRepository: FakeRecipeRepository
+    
+    @Before
+    fun setup() {
+        fakeRepository = FakeRecipeRepository()
+        fakeRepository.addRecipe(
+            FakeRecipeRepository.createFakeRecipe("4", "Shortbread", "Cookies").copy(
+                ingredients = listOf(
+                    Ingredient("1", "Flour", 2.0, "cups"),
+                    Ingredient("2", "Unsalted Butter", 1.0, "cup")
+                )
+            )
+        )
+        findRecipesByIngredientsUseCase = FindRecipesByIngredientsUseCase(fakeRepository)
+    }
+    
+    @Test
+    fun `recipes using every ingredient are returned`() = runTest {
+        findRecipesByIngredientsUseCase(listOf("flour", "butter")).test {
+            assertThat(awaitItem()).isEqualTo(Result.Loading)
+            
+            val success = awaitItem()
+            assertThat(success).isInstanceOf(Result.Success::class.java)
+            val recipes = (success as Result.Success).data
+            assertThat(recipes.map { it.id }).containsExactly("4")
+            
+            awaitComplete()
+        }
+    }
+    
+    @Test
+    fun `excluded ingredients filter recipes out`() = runTest {
+        findRecipesByIngredientsUseCase(listOf("flour"), exclude = listOf("sugar")).test {
+            assertThat(awaitItem()).isEqualTo(Result.Loading)
+            
+            val success = awaitItem()
+            assertThat(success).isInstanceOf(Result.Success::class.java)
+            assertThat((success as Result.Success).data.map { it.id }).containsExactly("4")
+            
+            awaitComplete()
+        }
+    }
+    
+    @Test
+    fun `blank ingredients are ignored`() = runTest {
+        findRecipesByIngredientsUseCase(listOf("  Sugar ", " ")).test {
+            assertThat(awaitItem()).isEqualTo(Result.Loading)
+            
+            val success = awaitItem()
+            assertThat(success).isInstanceOf(Result.Success::class.java)
+            assertThat((success as Result.Success).data).hasSize(3)
+            
+            awaitComplete()
+        }
+    }
+    
+    @Test
+    fun `find returns error when repository fails`() = runTest {
+        fakeRepository.shouldReturnError = true
+        fakeRepository.errorMessage = "Lookup failed"
+        
+        findRecipesByIngredientsUseCase(listOf("flour")).test {
+            assertThat(awaitItem()).isEqualTo(Result.Loading)
+            
+            val error = awaitItem()
+            assertThat(error).isInstanceOf(Result.Error::class.java)
+            assertThat((error as Result.Error).message).isEqualTo("Lookup failed")
+            
+            awaitComplete()
+        }
+    }
+}
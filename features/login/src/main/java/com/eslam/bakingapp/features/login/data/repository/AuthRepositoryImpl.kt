@@ -37,14 +37,11 @@ class AuthRepositoryImpl @Inject constructor(
                     expiresIn = 3600L // 1 hour
                 )
                 
-                // Save tokens securely
-                tokenManager.saveTokens(
+                // Save tokens and user info securely, in one write
+                tokenManager.saveSession(
                     accessToken = result.accessToken,
                     refreshToken = result.refreshToken,
-                    expiresIn = result.expiresIn
-                )
-                
-                tokenManager.saveUserInfo(
+                    expiresIn = result.expiresIn,
                     userId = result.userId,
                     email = result.email,
                     name = result.name
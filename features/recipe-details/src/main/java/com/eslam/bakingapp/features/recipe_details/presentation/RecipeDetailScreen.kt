@@ -14,17 +14,22 @@ import androidx.compose.foundation.layout.height
 import androidx.compose.foundation.layout.padding
 import androidx.compose.foundation.layout.size
 import androidx.compose.foundation.layout.width
+import androidx.compose.foundation.clickable
 import androidx.compose.foundation.lazy.LazyColumn
+import androidx.compose.foundation.lazy.LazyRow
+import androidx.compose.foundation.lazy.items
 import androidx.compose.foundation.lazy.itemsIndexed
 import androidx.compose.foundation.shape.CircleShape
 import androidx.compose.foundation.shape.RoundedCornerShape
 import androidx.compose.material.icons.Icons
 import androidx.compose.material.icons.automirrored.filled.ArrowBack
 import androidx.compose.material.icons.filled.AccessTime
+import androidx.compose.material.icons.filled.Add
 import androidx.compose.material.icons.filled.Favorite
 import androidx.compose.material.icons.filled.FavoriteBorder
 import androidx.compose.material.icons.filled.People
 import androidx.compose.material.icons.filled.PlayArrow
+import androidx.compose.material.icons.filled.Remove
 import androidx.compose.material.icons.filled.Timer
 import androidx.compose.material3.Button
 import androidx.compose.material3.ButtonDefaults
@@ -33,6 +38,7 @@ import androidx.compose.material3.ExtendedFloatingActionButton
 import androidx.compose.material3.Card
 import androidx.compose.material3.CardDefaults
 import androidx.compose.material3.ExperimentalMaterial3Api
+import androidx.compose.material3.FilterChip
 import androidx.compose.material3.Icon
 import androidx.compose.material3.IconButton
 import androidx.compose.material3.MaterialTheme
@@ -57,6 +63,7 @@ import androidx.compose.ui.unit.dp
 import androidx.hilt.navigation.compose.hiltViewModel
 import androidx.lifecycle.compose.collectAsStateWithLifecycle
 import coil.compose.AsyncImage
+import com.eslam.bakingapp.core.security.units.UnitSystem
 import com.eslam.bakingapp.core.ui.components.ErrorView
 import com.eslam.bakingapp.core.ui.components.ErrorType
 import com.eslam.bakingapp.core.ui.components.FullScreenLoading
@@ -64,6 +71,7 @@ import com.eslam.bakingapp.core.ui.theme.BakingAppTheme
 import com.eslam.bakingapp.features.home.domain.model.Difficulty
 import com.eslam.bakingapp.features.home.domain.model.Ingredient
 import com.eslam.bakingapp.features.home.domain.model.Recipe
+import com.eslam.bakingapp.features.home.domain.model.SimilarRecipe
 import com.eslam.bakingapp.features.home.domain.model.Step
 
 /**
@@ -73,6 +81,7 @@ import com.eslam.bakingapp.features.home.domain.model.Step
 fun RecipeDetailScreen(
     onNavigateBack: () -> Unit,
     onStartTimer: (recipeName: String, cookingTime: Int) -> Unit = { _, _ -> },
+    onRecipeClick: (recipeId: String) -> Unit = {},
     viewModel: RecipeDetailViewModel = hiltViewModel()
 ) {
     val uiState by viewModel.uiState.collectAsStateWithLifecycle()
@@ -83,7 +92,10 @@ fun RecipeDetailScreen(
         onTabSelected = viewModel::onTabSelected,
         onFavoriteClick = viewModel::onFavoriteClick,
         onRetry = viewModel::loadRecipeDetails,
-        onStartTimer = onStartTimer
+        onStartTimer = onStartTimer,
+        onServingsChanged = viewModel::onServingsChanged,
+        onUnitSystemSelected = viewModel::onUnitSystemSelected,
+        onRecipeClick = onRecipeClick
     )
 }
 
@@ -95,7 +107,10 @@ private fun RecipeDetailContent(
     onTabSelected: (Int) -> Unit,
     onFavoriteClick: () -> Unit,
     onRetry: () -> Unit,
-    onStartTimer: (recipeName: String, cookingTime: Int) -> Unit = { _, _ -> }
+    onStartTimer: (recipeName: String, cookingTime: Int) -> Unit = { _, _ -> },
+    onServingsChanged: (Int) -> Unit = {},
+    onUnitSystemSelected: (UnitSystem) -> Unit = {},
+    onRecipeClick: (recipeId: String) -> Unit = {}
 ) {
     Scaffold(
         topBar = {
@@ -203,9 +218,16 @@ private fun RecipeDetailContent(
                 uiState.recipe != null -> {
                     RecipeDetailBody(
                         recipe = uiState.recipe,
+                        ingredients = uiState.ingredients,
+                        similarRecipes = uiState.similarRecipes,
+                        servings = uiState.servings,
+                        unitSystem = uiState.unitSystem,
                         selectedTabIndex = uiState.selectedTabIndex,
                         onTabSelected = onTabSelected,
-                        onStartTimer = onStartTimer
+                        onStartTimer = onStartTimer,
+                        onServingsChanged = onServingsChanged,
+                        onUnitSystemSelected = onUnitSystemSelected,
+                        onRecipeClick = onRecipeClick
                     )
                 }
             }
@@ -216,9 +238,16 @@ private fun RecipeDetailContent(
 @Composable
 private fun RecipeDetailBody(
     recipe: Recipe,
+    ingredients: List<Ingredient>,
+    similarRecipes: List<SimilarRecipe>,
+    servings: Int,
+    unitSystem: UnitSystem,
     selectedTabIndex: Int,
     onTabSelected: (Int) -> Unit,
-    onStartTimer: (recipeName: String, cookingTime: Int) -> Unit = { _, _ -> }
+    onStartTimer: (recipeName: String, cookingTime: Int) -> Unit = { _, _ -> },
+    onServingsChanged: (Int) -> Unit = {},
+    onUnitSystemSelected: (UnitSystem) -> Unit = {},
+    onRecipeClick: (recipeId: String) -> Unit = {}
 ) {
     LazyColumn(
         modifier = Modifier.fillMaxSize()
@@ -320,8 +349,22 @@ private fun RecipeDetailBody(
         // Tab content
         when (selectedTabIndex) {
             0 -> {
+                // Servings and unit controls
+                item {
+                    ServingsControls(
+                        servings = servings,
+                        unitSystem = unitSystem,
+                        onServingsChanged = onServingsChanged,
+                        onUnitSystemSelected = onUnitSystemSelected,
+                        modifier = Modifier.padding(
+                            horizontal = 16.dp,
+                            vertical = 8.dp
+                        )
+                    )
+                }
+                
                 // Ingredients
-                itemsIndexed(recipe.ingredients) { index, ingredient ->
+                itemsIndexed(ingredients) { index, ingredient ->
                     IngredientItem(
                         ingredient = ingredient,
                         modifier = Modifier.padding(
@@ -350,6 +393,37 @@ private fun RecipeDetailBody(
             }
         }
         
+        // Similar recipes
+        if (similarRecipes.isNotEmpty()) {
+            item {
+                Text(
+                    text = "You Might Also Like",
+                    style = MaterialTheme.typography.titleMedium,
+                    fontWeight = FontWeight.Bold,
+                    color = MaterialTheme.colorScheme.onSurface,
+                    modifier = Modifier.padding(
+                        start = 16.dp,
+                        end = 16.dp,
+                        top = 24.dp,
+                        bottom = 8.dp
+                    )
+                )
+            }
+            item {
+                LazyRow(
+                    contentPadding = PaddingValues(horizontal = 16.dp),
+                    horizontalArrangement = Arrangement.spacedBy(12.dp)
+                ) {
+                    items(similarRecipes, key = { it.recipe.id }) { similar ->
+                        SimilarRecipeCard(
+                            similar = similar,
+                            onClick = { onRecipeClick(similar.recipe.id) }
+                        )
+                    }
+                }
+            }
+        }
+        
         // Bottom spacing
         item {
             Spacer(modifier = Modifier.height(32.dp))
@@ -414,6 +488,68 @@ private fun DifficultyBadge(
     }
 }
 
+@Composable
+private fun ServingsControls(
+    servings: Int,
+    unitSystem: UnitSystem,
+    onServingsChanged: (Int) -> Unit,
+    onUnitSystemSelected: (UnitSystem) -> Unit,
+    modifier: Modifier = Modifier
+) {
+    Column(modifier = modifier.fillMaxWidth()) {
+        Row(
+            modifier = Modifier.fillMaxWidth(),
+            verticalAlignment = Alignment.CenterVertically
+        ) {
+            Text(
+                text = "Servings",
+                style = MaterialTheme.typography.titleSmall,
+                color = MaterialTheme.colorScheme.onSurface,
+                modifier = Modifier.weight(1f)
+            )
+            IconButton(
+                onClick = { onServingsChanged(servings - 1) },
+                enabled = servings > RecipeDetailViewModel.MIN_SERVINGS
+            ) {
+                Icon(
+                    imageVector = Icons.Default.Remove,
+                    contentDescription = "Fewer servings"
+                )
+            }
+            Text(
+                text = servings.toString(),
+                style = MaterialTheme.typography.titleMedium,
+                fontWeight = FontWeight.Bold
+            )
+            IconButton(
+                onClick = { onServingsChanged(servings + 1) },
+                enabled = servings < RecipeDetailViewModel.MAX_SERVINGS
+            ) {
+                Icon(
+                    imageVector = Icons.Default.Add,
+                    contentDescription = "More servings"
+                )
+            }
+        }
+        
+        Row(horizontalArrangement = Arrangement.spacedBy(8.dp)) {
+            UnitSystem.entries.forEach { system ->
+                FilterChip(
+                    selected = system == unitSystem,
+                    onClick = { onUnitSystemSelected(system) },
+                    label = { Text(system.toDisplayString()) }
+                )
+            }
+        }
+    }
+}
+
+private fun UnitSystem.toDisplayString(): String = when (this) {
+    UnitSystem.ORIGINAL -> "Original"
+    UnitSystem.METRIC -> "Metric"
+    UnitSystem.IMPERIAL -> "Imperial"
+}
+
 @Composable
 private fun IngredientItem(
     ingredient: Ingredient,
@@ -451,6 +587,47 @@ private fun IngredientItem(
     }
 }
 
+@Composable
+private fun SimilarRecipeCard(
+    similar: SimilarRecipe,
+    onClick: () -> Unit,
+    modifier: Modifier = Modifier
+) {
+    Card(
+        modifier = modifier
+            .width(160.dp)
+            .clickable(onClick = onClick),
+        colors = CardDefaults.cardColors(
+            containerColor = MaterialTheme.colorScheme.surface
+        ),
+        elevation = CardDefaults.cardElevation(defaultElevation = 2.dp)
+    ) {
+        AsyncImage(
+            model = similar.recipe.imageUrl,
+            contentDescription = similar.recipe.name,
+            modifier = Modifier
+                .fillMaxWidth()
+                .height(96.dp),
+            contentScale = ContentScale.Crop
+        )
+        Column(modifier = Modifier.padding(8.dp)) {
+            Text(
+                text = similar.recipe.name,
+                style = MaterialTheme.typography.titleSmall,
+                color = MaterialTheme.colorScheme.onSurface,
+                maxLines = 2,
+                overflow = TextOverflow.Ellipsis
+            )
+            Spacer(modifier = Modifier.height(4.dp))
+            Text(
+                text = "${(similar.similarity * 100).toInt()}% same ingredients",
+                style = MaterialTheme.typography.bodySmall,
+                color = MaterialTheme.colorScheme.onSurfaceVariant
+            )
+        }
+    }
+}
+
 @Composable
 private fun StepItem(
     stepNumber: Int,
@@ -533,6 +710,10 @@ private fun StepItem(
 @Composable
 private fun RecipeDetailPreview() {
     BakingAppTheme {
+        val ingredients = listOf(
+            Ingredient("1", "Flour", 2.0, "cups"),
+            Ingredient("2", "Sugar", 1.0, "cup")
+        )
         RecipeDetailContent(
             uiState = RecipeDetailUiState(
                 recipe = Recipe(
@@ -545,15 +726,14 @@ private fun RecipeDetailPreview() {
                     cookTimeMinutes = 12,
                     difficulty = Difficulty.EASY,
                     category = "Cookies",
-                    ingredients = listOf(
-                        Ingredient("1", "Flour", 2.0, "cups"),
-                        Ingredient("2", "Sugar", 1.0, "cup")
-                    ),
+                    ingredients = ingredients,
                     steps = listOf(
                         Step("1", 1, "Preheat oven to 350°F", null, null),
                         Step("2", 2, "Bake for 12 minutes until golden", null, null)
                     )
-                )
+                ),
+                servings = 24,
+                ingredients = ingredients
             ),
             onNavigateBack = {},
             onTabSelected = {},
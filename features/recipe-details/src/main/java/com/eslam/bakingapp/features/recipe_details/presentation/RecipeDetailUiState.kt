@@ -1,15 +1,26 @@
 package com.eslam.bakingapp.features.recipe_details.presentation
 
+import com.eslam.bakingapp.core.security.units.UnitSystem
+import com.eslam.bakingapp.features.home.domain.model.Ingredient
 import com.eslam.bakingapp.features.home.domain.model.Recipe
+import com.eslam.bakingapp.features.home.domain.model.SimilarRecipe
 
 /**
  * UI State for the Recipe Detail screen.
+ *
+ * [ingredients] are the recipe's ingredients rescaled to [servings] and
+ * converted to [unitSystem]. [similarRecipes] share the most ingredients
+ * with it, most similar first.
  */
 data class RecipeDetailUiState(
     val recipe: Recipe? = null,
     val isLoading: Boolean = false,
     val errorMessage: String? = null,
-    val selectedTabIndex: Int = 0
+    val selectedTabIndex: Int = 0,
+    val servings: Int = 0,
+    val unitSystem: UnitSystem = UnitSystem.ORIGINAL,
+    val ingredients: List<Ingredient> = emptyList(),
+    val similarRecipes: List<SimilarRecipe> = emptyList()
 ) {
     val hasError: Boolean
         get() = errorMessage != null && !isLoading
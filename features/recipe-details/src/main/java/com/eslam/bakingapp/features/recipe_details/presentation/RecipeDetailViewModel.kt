@@ -4,6 +4,10 @@ import androidx.lifecycle.SavedStateHandle
 import androidx.lifecycle.ViewModel
 import androidx.lifecycle.viewModelScope
 import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.core.security.units.IngredientScaler
+import com.eslam.bakingapp.core.security.units.UnitSystem
+import com.eslam.bakingapp.features.home.domain.model.Ingredient
+import com.eslam.bakingapp.features.home.domain.model.Recipe
 import com.eslam.bakingapp.features.home.domain.repository.RecipeRepository
 import dagger.hilt.android.lifecycle.HiltViewModel
 import kotlinx.coroutines.flow.MutableStateFlow
@@ -12,6 +16,7 @@ import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.flow.update
 import kotlinx.coroutines.launch
 import javax.inject.Inject
+import kotlin.math.roundToLong
 
 /**
  * ViewModel for the Recipe Detail screen.
@@ -19,9 +24,16 @@ import javax.inject.Inject
 @HiltViewModel
 class RecipeDetailViewModel @Inject constructor(
     private val recipeRepository: RecipeRepository,
+    private val ingredientScaler: IngredientScaler,
     savedStateHandle: SavedStateHandle
 ) : ViewModel() {
     
+    companion object {
+        const val MIN_SERVINGS = 1
+        const val MAX_SERVINGS = 99
+        const val SIMILAR_RECIPES = 10
+    }
+    
     private val recipeId: String = checkNotNull(savedStateHandle["recipeId"])
     
     private val _uiState = MutableStateFlow(RecipeDetailUiState())
@@ -29,6 +41,7 @@ class RecipeDetailViewModel @Inject constructor(
     
     init {
         loadRecipeDetails()
+        loadSimilarRecipes()
     }
     
     /**
@@ -43,10 +56,14 @@ class RecipeDetailViewModel @Inject constructor(
                     }
                     is Result.Success -> {
                         _uiState.update { state ->
+                            // Keep the user's servings across reloads
+                            val servings = if (state.servings > 0) state.servings else result.data.servings
                             state.copy(
                                 recipe = result.data,
                                 isLoading = false,
-                                errorMessage = null
+                                errorMessage = null,
+                                servings = servings,
+                                ingredients = scaleIngredients(result.data, servings, state.unitSystem)
                             )
                         }
                     }
@@ -63,6 +80,20 @@ class RecipeDetailViewModel @Inject constructor(
         }
     }
     
+    /**
+     * Load the recipes sharing the most ingredients with this one. They are
+     * only suggestions: on failure the section is left out.
+     */
+    private fun loadSimilarRecipes() {
+        viewModelScope.launch {
+            recipeRepository.getSimilarRecipes(recipeId, SIMILAR_RECIPES).collect { result ->
+                if (result is Result.Success) {
+                    _uiState.update { it.copy(similarRecipes = result.data) }
+                }
+            }
+        }
+    }
+    
     /**
      * Select a tab.
      */
@@ -70,6 +101,56 @@ class RecipeDetailViewModel @Inject constructor(
         _uiState.update { it.copy(selectedTabIndex = index) }
     }
     
+    /**
+     * Change the number of servings the ingredients are shown for.
+     */
+    fun onServingsChanged(servings: Int) {
+        val clamped = servings.coerceIn(MIN_SERVINGS, MAX_SERVINGS)
+        _uiState.update { state ->
+            state.copy(
+                servings = clamped,
+                ingredients = state.recipe?.let { scaleIngredients(it, clamped, state.unitSystem) }
+                    ?: state.ingredients
+            )
+        }
+    }
+    
+    /**
+     * Switch the unit system ingredients are shown in.
+     */
+    fun onUnitSystemSelected(unitSystem: UnitSystem) {
+        _uiState.update { state ->
+            state.copy(
+                unitSystem = unitSystem,
+                ingredients = state.recipe?.let { scaleIngredients(it, state.servings, unitSystem) }
+                    ?: state.ingredients
+            )
+        }
+    }
+    
+    /**
+     * Scales all ingredients in one batch and rounds for display.
+     */
+    private fun scaleIngredients(recipe: Recipe, servings: Int, unitSystem: UnitSystem): List<Ingredient> {
+        val ingredients = recipe.ingredients
+        if (ingredients.isEmpty()) return ingredients
+        if (servings == recipe.servings && unitSystem == UnitSystem.ORIGINAL) return ingredients
+        
+        val factor = if (recipe.servings > 0) servings.toDouble() / recipe.servings else 1.0
+        val scaled = ingredientScaler.scale(
+            quantities = DoubleArray(ingredients.size) { ingredients[it].quantity },
+            units = ingredients.map { it.unit },
+            factor = factor,
+            system = unitSystem
+        )
+        return ingredients.mapIndexed { index, ingredient ->
+            ingredient.copy(
+                quantity = (scaled.quantities[index] * 100).roundToLong() / 100.0,
+                unit = scaled.units[index]
+            )
+        }
+    }
+    
     /**
      * Toggle favorite status.
      */
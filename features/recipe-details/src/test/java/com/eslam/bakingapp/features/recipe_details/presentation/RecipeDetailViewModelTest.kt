@@ -3,14 +3,19 @@ package com.eslam.bakingapp.features.recipe_details.presentation
 import androidx.lifecycle.SavedStateHandle
 import com.eslam.bakingapp.core.common.testing.MainDispatcherRule
 import com.eslam.bakingapp.core.common.result.Result
+import com.eslam.bakingapp.core.security.units.IngredientScaler
+import com.eslam.bakingapp.core.security.units.ScaledQuantities
+import com.eslam.bakingapp.core.security.units.UnitSystem
 import com.eslam.bakingapp.features.home.domain.model.Difficulty
 import com.eslam.bakingapp.features.home.domain.model.Ingredient
 import com.eslam.bakingapp.features.home.domain.model.Recipe
+import com.eslam.bakingapp.features.home.domain.model.SimilarRecipe
 import com.eslam.bakingapp.features.home.domain.model.Step
 import com.eslam.bakingapp.features.home.domain.repository.RecipeRepository
 import com.google.common.truth.Truth.assertThat
 import kotlinx.coroutines.ExperimentalCoroutinesApi
 import kotlinx.coroutines.flow.flow
+import kotlinx.coroutines.flow.flowOf
 import kotlinx.coroutines.test.advanceUntilIdle
 import kotlinx.coroutines.test.runTest
 import org.junit.Before
@@ -30,6 +35,16 @@ class RecipeDetailViewModelTest {
     private lateinit var recipeRepository: RecipeRepository
     private lateinit var savedStateHandle: SavedStateHandle
     
+    /** Scales quantities and keeps units as written; conversion is covered natively. */
+    private val ingredientScaler = object : IngredientScaler {
+        override fun scale(
+            quantities: DoubleArray,
+            units: List<String>,
+            factor: Double,
+            system: UnitSystem
+        ) = ScaledQuantities(DoubleArray(quantities.size) { quantities[it] * factor }, units)
+    }
+    
     private val testRecipe = Recipe(
         id = "test-recipe-1",
         name = "Test Recipe",
@@ -55,6 +70,9 @@ class RecipeDetailViewModelTest {
     @Before
     fun setup() {
         recipeRepository = mock()
+        whenever(recipeRepository.getSimilarRecipes(any(), any())).thenReturn(
+            flowOf(Result.Success(emptyList()))
+        )
         savedStateHandle = SavedStateHandle(mapOf("recipeId" to "test-recipe-1"))
     }
     
@@ -67,7 +85,7 @@ class RecipeDetailViewModelTest {
             }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         val state = viewModel.uiState.value
@@ -84,7 +102,7 @@ class RecipeDetailViewModelTest {
             }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         
         // During loading
         assertThat(viewModel.uiState.value.isLoading).isTrue()
@@ -99,7 +117,7 @@ class RecipeDetailViewModelTest {
             }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         val state = viewModel.uiState.value
@@ -119,7 +137,7 @@ class RecipeDetailViewModelTest {
             }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         val state = viewModel.uiState.value
@@ -134,7 +152,7 @@ class RecipeDetailViewModelTest {
             flow { emit(Result.Success(testRecipe)) }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         assertThat(viewModel.uiState.value.selectedTabIndex).isEqualTo(0)
@@ -150,7 +168,7 @@ class RecipeDetailViewModelTest {
             flow { emit(Result.Success(testRecipe)) }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         viewModel.onTabSelected(0)
@@ -165,7 +183,7 @@ class RecipeDetailViewModelTest {
         )
         whenever(recipeRepository.toggleFavorite(any())).thenReturn(Result.Success(Unit))
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         assertThat(viewModel.uiState.value.recipe?.isFavorite).isFalse()
@@ -183,7 +201,7 @@ class RecipeDetailViewModelTest {
         )
         whenever(recipeRepository.toggleFavorite(any())).thenReturn(Result.Success(Unit))
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         assertThat(viewModel.uiState.value.recipe?.isFavorite).isTrue()
@@ -202,7 +220,7 @@ class RecipeDetailViewModelTest {
             }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         assertThat(viewModel.uiState.value.hasError).isTrue()
@@ -214,7 +232,7 @@ class RecipeDetailViewModelTest {
             flow { emit(Result.Loading) }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         
         // While loading, hasError should be false even with no data
         assertThat(viewModel.uiState.value.hasError).isFalse()
@@ -226,11 +244,84 @@ class RecipeDetailViewModelTest {
             flow { emit(Result.Success(testRecipe)) }
         )
         
-        viewModel = RecipeDetailViewModel(recipeRepository, savedStateHandle)
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
         advanceUntilIdle()
         
         assertThat(viewModel.uiState.value.recipe?.totalTimeMinutes).isEqualTo(45)
     }
+    
+    @Test
+    fun `onServingsChanged scales ingredient quantities`() = runTest {
+        whenever(recipeRepository.getRecipeById(any())).thenReturn(
+            flow { emit(Result.Success(testRecipe)) }
+        )
+        
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
+        advanceUntilIdle()
+        
+        assertThat(viewModel.uiState.value.servings).isEqualTo(4)
+        assertThat(viewModel.uiState.value.ingredients.map { it.quantity })
+            .containsExactly(2.0, 1.0).inOrder()
+        
+        viewModel.onServingsChanged(6)
+        
+        val state = viewModel.uiState.value
+        assertThat(state.servings).isEqualTo(6)
+        assertThat(state.ingredients.map { it.quantity }).containsExactly(3.0, 1.5).inOrder()
+        assertThat(state.ingredients.map { it.unit }).containsExactly("cups", "cup").inOrder()
+    }
+    
+    @Test
+    fun `onServingsChanged clamps to supported range`() = runTest {
+        whenever(recipeRepository.getRecipeById(any())).thenReturn(
+            flow { emit(Result.Success(testRecipe)) }
+        )
+        
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
+        advanceUntilIdle()
+        
+        viewModel.onServingsChanged(0)
+        assertThat(viewModel.uiState.value.servings).isEqualTo(RecipeDetailViewModel.MIN_SERVINGS)
+        
+        viewModel.onServingsChanged(1000)
+        assertThat(viewModel.uiState.value.servings).isEqualTo(RecipeDetailViewModel.MAX_SERVINGS)
+    }
+    
+    @Test
+    fun `similar recipes are loaded alongside the recipe`() = runTest {
+        val similar = SimilarRecipe(testRecipe.copy(id = "test-recipe-2", name = "Twin"), 0.8f)
+        whenever(recipeRepository.getRecipeById(any())).thenReturn(
+            flow { emit(Result.Success(testRecipe)) }
+        )
+        whenever(recipeRepository.getSimilarRecipes(any(), any())).thenReturn(
+            flow {
+                emit(Result.Loading)
+                emit(Result.Success(listOf(similar)))
+            }
+        )
+        
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
+        advanceUntilIdle()
+        
+        assertThat(viewModel.uiState.value.similarRecipes).containsExactly(similar)
+        assertThat(viewModel.uiState.value.recipe?.name).isEqualTo("Test Recipe")
+    }
+    
+    @Test
+    fun `similar recipes failure leaves the recipe shown`() = runTest {
+        whenever(recipeRepository.getRecipeById(any())).thenReturn(
+            flow { emit(Result.Success(testRecipe)) }
+        )
+        whenever(recipeRepository.getSimilarRecipes(any(), any())).thenReturn(
+            flowOf(Result.Error(Exception("Index unavailable")))
+        )
+        
+        viewModel = RecipeDetailViewModel(recipeRepository, ingredientScaler, savedStateHandle)
+        advanceUntilIdle()
+        
+        val state = viewModel.uiState.value
+        assertThat(state.similarRecipes).isEmpty()
+        assertThat(state.hasError).isFalse()
+        assertThat(state.recipe).isNotNull()
+    }
 }
-
-